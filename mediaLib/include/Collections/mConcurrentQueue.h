@@ -0,0 +1,679 @@
+#ifndef mConcurrentQueue_h__
+#define mConcurrentQueue_h__
+
+#include "mediaLib.h"
+#include "mSemaphore.h"
+
+#include <atomic>
+#include <thread>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "HwTCpgxgwhzW/DDmcLQU3I3b0v6Lf/HgPJfpTM858gJUrCiCopoDc0PRpsuwmFnU5S+fkWoF1KvxImVi"
+#endif
+
+// Bounded lock-free ring buffers to hand items from one thread to another without locking a mutex.
+// `mSpscQueue` may only be pushed to by a single producer thread and popped from by a single consumer thread. All operations are wait-free.
+// `mMpmcQueue` can be used by any number of producers and consumers. (Dmitry Vyukov's bounded MPMC queue)
+// The capacity is rounded up to the next power of two.
+// `TryPush` / `TryPop` never block. `Push` / `Pop` spin for a bit and then sleep on a semaphore until they succeed or `timeoutMs` has passed (`mR_Timeout`).
+
+constexpr size_t mConcurrentQueue_CacheLineSize = 64;
+constexpr size_t mConcurrentQueue_IdleSpinCount = 64;
+
+template <typename T>
+struct mSpscQueue
+{
+  T *pItems;
+  size_t capacityMask;
+  mAllocator *pAllocator;
+  mSemaphore *pSemaphore;
+  std::atomic<size_t> waitingCount; // number of threads sleeping in `Push` / `Pop`.
+  uint8_t _headerPadding[mConcurrentQueue_CacheLineSize - sizeof(T *) - sizeof(size_t) - sizeof(mAllocator *) - sizeof(mSemaphore *) - sizeof(std::atomic<size_t>)];
+
+  // Only written by the producer.
+  std::atomic<size_t> writeIndex;
+  size_t cachedReadIndex; // the last `readIndex` the producer has seen, so that it doesn't have to access the consumer's cache line for every push.
+  uint8_t _writePadding[mConcurrentQueue_CacheLineSize - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+  // Only written by the consumer.
+  std::atomic<size_t> readIndex;
+  size_t cachedWriteIndex;
+  uint8_t _readPadding[mConcurrentQueue_CacheLineSize - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+};
+
+template <typename T>
+mFUNCTION(mSpscQueue_Create, OUT mPtr<mSpscQueue<T>> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t capacity);
+
+template <typename T>
+mFUNCTION(mSpscQueue_Destroy, IN_OUT mPtr<mSpscQueue<T>> *pQueue);
+
+template <typename T>
+mFUNCTION(mSpscQueue_TryPush, mPtr<mSpscQueue<T>> &queue, IN const T &item, OUT bool *pPushed);
+
+template <typename T>
+mFUNCTION(mSpscQueue_TryPushBatch, mPtr<mSpscQueue<T>> &queue, IN const T *pItems, const size_t count, OUT size_t *pPushedCount);
+
+template <typename T>
+mFUNCTION(mSpscQueue_TryPop, mPtr<mSpscQueue<T>> &queue, OUT T *pItem, OUT bool *pPopped);
+
+template <typename T>
+mFUNCTION(mSpscQueue_TryPopBatch, mPtr<mSpscQueue<T>> &queue, OUT T *pItems, const size_t maxCount, OUT size_t *pPoppedCount);
+
+template <typename T>
+mFUNCTION(mSpscQueue_Push, mPtr<mSpscQueue<T>> &queue, IN const T &item, const size_t timeoutMs = mSemaphore_SleepTime::mS_ST_Infinite);
+
+template <typename T>
+mFUNCTION(mSpscQueue_Pop, mPtr<mSpscQueue<T>> &queue, OUT T *pItem, const size_t timeoutMs = mSemaphore_SleepTime::mS_ST_Infinite);
+
+// Only a snapshot if the queue is being used concurrently.
+template <typename T>
+mFUNCTION(mSpscQueue_GetCount, const mPtr<mSpscQueue<T>> &queue, OUT size_t *pCount);
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct mMpmcQueue_Cell
+{
+  std::atomic<size_t> sequence;
+  T item;
+};
+
+template <typename T>
+struct mMpmcQueue
+{
+  mMpmcQueue_Cell<T> *pCells;
+  size_t capacityMask;
+  mAllocator *pAllocator;
+  mSemaphore *pSemaphore;
+  std::atomic<size_t> waitingCount; // number of threads sleeping in `Push` / `Pop`.
+  uint8_t _headerPadding[mConcurrentQueue_CacheLineSize - sizeof(mMpmcQueue_Cell<T> *) - sizeof(size_t) - sizeof(mAllocator *) - sizeof(mSemaphore *) - sizeof(std::atomic<size_t>)];
+
+  std::atomic<size_t> enqueueIndex;
+  uint8_t _enqueuePadding[mConcurrentQueue_CacheLineSize - sizeof(std::atomic<size_t>)];
+
+  std::atomic<size_t> dequeueIndex;
+  uint8_t _dequeuePadding[mConcurrentQueue_CacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+template <typename T>
+mFUNCTION(mMpmcQueue_Create, OUT mPtr<mMpmcQueue<T>> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t capacity);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_Destroy, IN_OUT mPtr<mMpmcQueue<T>> *pQueue);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_TryPush, mPtr<mMpmcQueue<T>> &queue, IN const T &item, OUT bool *pPushed);
+
+// Items are claimed one by one, so batches of concurrent producers may be interleaved.
+template <typename T>
+mFUNCTION(mMpmcQueue_TryPushBatch, mPtr<mMpmcQueue<T>> &queue, IN const T *pItems, const size_t count, OUT size_t *pPushedCount);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_TryPop, mPtr<mMpmcQueue<T>> &queue, OUT T *pItem, OUT bool *pPopped);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_TryPopBatch, mPtr<mMpmcQueue<T>> &queue, OUT T *pItems, const size_t maxCount, OUT size_t *pPoppedCount);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_Push, mPtr<mMpmcQueue<T>> &queue, IN const T &item, const size_t timeoutMs = mSemaphore_SleepTime::mS_ST_Infinite);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_Pop, mPtr<mMpmcQueue<T>> &queue, OUT T *pItem, const size_t timeoutMs = mSemaphore_SleepTime::mS_ST_Infinite);
+
+// Only a snapshot if the queue is being used concurrently.
+template <typename T>
+mFUNCTION(mMpmcQueue_GetCount, const mPtr<mMpmcQueue<T>> &queue, OUT size_t *pCount);
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+mFUNCTION(mSpscQueue_Destroy_Internal, IN mSpscQueue<T> *pQueue);
+
+template <typename T>
+mFUNCTION(mMpmcQueue_Destroy_Internal, IN mMpmcQueue<T> *pQueue);
+
+inline size_t mConcurrentQueue_GetCapacity_Internal(const size_t capacity)
+{
+  size_t powerOfTwo = 2;
+
+  while (powerOfTwo < capacity)
+    powerOfTwo <<= 1;
+
+  return powerOfTwo;
+}
+
+inline mFUNCTION(mConcurrentQueue_Wake_Internal, IN mSemaphore *pSemaphore, const std::atomic<size_t> &waitingCount)
+{
+  mFUNCTION_SETUP();
+
+  if (waitingCount.load() > 0)
+    mERROR_CHECK(mSemaphore_WakeAll(pSemaphore));
+
+  mRETURN_SUCCESS();
+}
+
+// `tryFunction` is retried until it succeeds, the semaphore is only used to not busy wait.
+template <typename TFunction>
+inline mFUNCTION(mConcurrentQueue_Wait_Internal, IN mSemaphore *pSemaphore, std::atomic<size_t> &waitingCount, const size_t timeoutMs, const TFunction &tryFunction)
+{
+  mFUNCTION_SETUP();
+
+  const int64_t start = mGetCurrentTimeMs();
+  size_t idleIterations = 0;
+
+  while (true)
+  {
+    bool succeeded = false;
+    mERROR_CHECK(tryFunction(&succeeded));
+
+    if (succeeded)
+      break;
+
+    mERROR_IF(timeoutMs != mSemaphore_SleepTime::mS_ST_Infinite && (size_t)(mGetCurrentTimeMs() - start) >= timeoutMs, mR_Timeout);
+
+    if (idleIterations < mConcurrentQueue_IdleSpinCount)
+    {
+      ++idleIterations;
+      std::this_thread::yield();
+      continue;
+    }
+
+    ++waitingCount;
+    const mResult result = mSILENCE_ERROR(mSemaphore_Sleep(pSemaphore, 1));
+    --waitingCount;
+
+    mERROR_IF(mFAILED(result) && result != mR_Timeout, result);
+  }
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_Create, OUT mPtr<mSpscQueue<T>> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t capacity)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+  mERROR_IF(capacity == 0 || capacity > ((size_t)1 << (sizeof(size_t) * CHAR_BIT - 2)), mR_ArgumentOutOfBounds);
+
+  if (*pQueue != nullptr)
+  {
+    mERROR_CHECK(mSharedPointer_Destroy(pQueue));
+    *pQueue = nullptr;
+  }
+
+  mSpscQueue<T> *pQueueRaw = nullptr;
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pQueueRaw));
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pQueueRaw, 1));
+
+  const size_t actualCapacity = mConcurrentQueue_GetCapacity_Internal(capacity);
+
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pQueueRaw->pItems));
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pQueueRaw->pItems, actualCapacity));
+
+  mDEFER_ON_ERROR(mSemaphore_Destroy(&pQueueRaw->pSemaphore));
+  mERROR_CHECK(mSemaphore_Create(&pQueueRaw->pSemaphore, pAllocator));
+
+  pQueueRaw->capacityMask = actualCapacity - 1;
+  pQueueRaw->pAllocator = pAllocator;
+
+  new (&pQueueRaw->waitingCount) std::atomic<size_t>(0);
+  new (&pQueueRaw->writeIndex) std::atomic<size_t>(0);
+  new (&pQueueRaw->readIndex) std::atomic<size_t>(0);
+
+  mDEFER_CALL_ON_ERROR(pQueue, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Create(pQueue, pQueueRaw, (std::function<void(mSpscQueue<T> *)>)[](mSpscQueue<T> *pData) { mSpscQueue_Destroy_Internal<T>(pData); }, pAllocator));
+  pQueueRaw = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_Destroy, IN_OUT mPtr<mSpscQueue<T>> *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pQueue));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_TryPush, mPtr<mSpscQueue<T>> &queue, IN const T &item, OUT bool *pPushed)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPushed == nullptr, mR_ArgumentNull);
+
+  size_t pushedCount = 0;
+  mERROR_CHECK(mSpscQueue_TryPushBatch(queue, &item, 1, &pushedCount));
+
+  *pPushed = (pushedCount == 1);
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_TryPushBatch, mPtr<mSpscQueue<T>> &queue, IN const T *pItems, const size_t count, OUT size_t *pPushedCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItems == nullptr || pPushedCount == nullptr, mR_ArgumentNull);
+
+  mSpscQueue<T> *pQueue = queue.GetPointer();
+
+  const size_t writeIndex = pQueue->writeIndex.load(std::memory_order_relaxed);
+  const size_t capacity = pQueue->capacityMask + 1;
+
+  // Only look at the actual read index if the cached one suggests that the queue is too full.
+  if (capacity - (writeIndex - pQueue->cachedReadIndex) < count)
+    pQueue->cachedReadIndex = pQueue->readIndex.load(std::memory_order_acquire);
+
+  const size_t pushedCount = mMin(count, capacity - (writeIndex - pQueue->cachedReadIndex));
+
+  for (size_t i = 0; i < pushedCount; i++)
+    new (&pQueue->pItems[(writeIndex + i) & pQueue->capacityMask]) T(pItems[i]);
+
+  *pPushedCount = pushedCount;
+
+  if (pushedCount > 0)
+  {
+    pQueue->writeIndex.store(writeIndex + pushedCount, std::memory_order_release);
+    mERROR_CHECK(mConcurrentQueue_Wake_Internal(pQueue->pSemaphore, pQueue->waitingCount));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_TryPop, mPtr<mSpscQueue<T>> &queue, OUT T *pItem, OUT bool *pPopped)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPopped == nullptr, mR_ArgumentNull);
+
+  size_t poppedCount = 0;
+  mERROR_CHECK(mSpscQueue_TryPopBatch(queue, pItem, 1, &poppedCount));
+
+  *pPopped = (poppedCount == 1);
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_TryPopBatch, mPtr<mSpscQueue<T>> &queue, OUT T *pItems, const size_t maxCount, OUT size_t *pPoppedCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItems == nullptr || pPoppedCount == nullptr, mR_ArgumentNull);
+
+  mSpscQueue<T> *pQueue = queue.GetPointer();
+
+  const size_t readIndex = pQueue->readIndex.load(std::memory_order_relaxed);
+
+  // Only look at the actual write index if the cached one suggests that there aren't enough items.
+  if (pQueue->cachedWriteIndex - readIndex < maxCount)
+    pQueue->cachedWriteIndex = pQueue->writeIndex.load(std::memory_order_acquire);
+
+  const size_t poppedCount = mMin(maxCount, pQueue->cachedWriteIndex - readIndex);
+
+  for (size_t i = 0; i < poppedCount; i++)
+  {
+    T *pItem = &pQueue->pItems[(readIndex + i) & pQueue->capacityMask];
+
+    pItems[i] = std::move(*pItem);
+    pItem->~T();
+  }
+
+  *pPoppedCount = poppedCount;
+
+  if (poppedCount > 0)
+  {
+    pQueue->readIndex.store(readIndex + poppedCount, std::memory_order_release);
+    mERROR_CHECK(mConcurrentQueue_Wake_Internal(pQueue->pSemaphore, pQueue->waitingCount));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_Push, mPtr<mSpscQueue<T>> &queue, IN const T &item, const size_t timeoutMs /* = mSemaphore_SleepTime::mS_ST_Infinite */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mConcurrentQueue_Wait_Internal(queue->pSemaphore, queue->waitingCount, timeoutMs, [&](bool *pSucceeded) { return mSpscQueue_TryPush(queue, item, pSucceeded); }));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_Pop, mPtr<mSpscQueue<T>> &queue, OUT T *pItem, const size_t timeoutMs /* = mSemaphore_SleepTime::mS_ST_Infinite */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItem == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mConcurrentQueue_Wait_Internal(queue->pSemaphore, queue->waitingCount, timeoutMs, [&](bool *pSucceeded) { return mSpscQueue_TryPop(queue, pItem, pSucceeded); }));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_GetCount, const mPtr<mSpscQueue<T>> &queue, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pCount == nullptr, mR_ArgumentNull);
+
+  const size_t readIndex = queue->readIndex.load(std::memory_order_acquire);
+  const size_t writeIndex = queue->writeIndex.load(std::memory_order_acquire);
+
+  *pCount = writeIndex - readIndex;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mSpscQueue_Destroy_Internal, IN mSpscQueue<T> *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+
+  if (pQueue->pItems != nullptr)
+  {
+    const size_t writeIndex = pQueue->writeIndex.load();
+
+    for (size_t i = pQueue->readIndex.load(); i != writeIndex; i++)
+      pQueue->pItems[i & pQueue->capacityMask].~T();
+
+    mERROR_CHECK(mAllocator_FreePtr(pQueue->pAllocator, &pQueue->pItems));
+  }
+
+  if (pQueue->pSemaphore != nullptr)
+    mERROR_CHECK(mSemaphore_Destroy(&pQueue->pSemaphore));
+
+  pQueue->waitingCount.~atomic();
+  pQueue->writeIndex.~atomic();
+  pQueue->readIndex.~atomic();
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_Create, OUT mPtr<mMpmcQueue<T>> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t capacity)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+  mERROR_IF(capacity == 0 || capacity > ((size_t)1 << (sizeof(size_t) * CHAR_BIT - 2)), mR_ArgumentOutOfBounds);
+
+  if (*pQueue != nullptr)
+  {
+    mERROR_CHECK(mSharedPointer_Destroy(pQueue));
+    *pQueue = nullptr;
+  }
+
+  mMpmcQueue<T> *pQueueRaw = nullptr;
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pQueueRaw));
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pQueueRaw, 1));
+
+  const size_t actualCapacity = mConcurrentQueue_GetCapacity_Internal(capacity);
+
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pQueueRaw->pCells));
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pQueueRaw->pCells, actualCapacity));
+
+  // The sequence of a cell is equal to the index that can be pushed into it next, and one more than that index once it's been pushed to.
+  for (size_t i = 0; i < actualCapacity; i++)
+    new (&pQueueRaw->pCells[i].sequence) std::atomic<size_t>(i);
+
+  mDEFER_ON_ERROR(mSemaphore_Destroy(&pQueueRaw->pSemaphore));
+  mERROR_CHECK(mSemaphore_Create(&pQueueRaw->pSemaphore, pAllocator));
+
+  pQueueRaw->capacityMask = actualCapacity - 1;
+  pQueueRaw->pAllocator = pAllocator;
+
+  new (&pQueueRaw->waitingCount) std::atomic<size_t>(0);
+  new (&pQueueRaw->enqueueIndex) std::atomic<size_t>(0);
+  new (&pQueueRaw->dequeueIndex) std::atomic<size_t>(0);
+
+  mDEFER_CALL_ON_ERROR(pQueue, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Create(pQueue, pQueueRaw, (std::function<void(mMpmcQueue<T> *)>)[](mMpmcQueue<T> *pData) { mMpmcQueue_Destroy_Internal<T>(pData); }, pAllocator));
+  pQueueRaw = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_Destroy, IN_OUT mPtr<mMpmcQueue<T>> *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pQueue));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_TryPush, mPtr<mMpmcQueue<T>> &queue, IN const T &item, OUT bool *pPushed)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pPushed == nullptr, mR_ArgumentNull);
+
+  mMpmcQueue<T> *pQueue = queue.GetPointer();
+  mMpmcQueue_Cell<T> *pCell = nullptr;
+  size_t index = pQueue->enqueueIndex.load(std::memory_order_relaxed);
+
+  *pPushed = false;
+
+  while (true)
+  {
+    pCell = &pQueue->pCells[index & pQueue->capacityMask];
+
+    const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+    const ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)index;
+
+    if (difference == 0)
+    {
+      if (pQueue->enqueueIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+    {
+      mRETURN_SUCCESS(); // The queue is full.
+    }
+    else
+    {
+      index = pQueue->enqueueIndex.load(std::memory_order_relaxed);
+    }
+  }
+
+  new (&pCell->item) T(item);
+  pCell->sequence.store(index + 1, std::memory_order_release);
+
+  *pPushed = true;
+
+  mERROR_CHECK(mConcurrentQueue_Wake_Internal(pQueue->pSemaphore, pQueue->waitingCount));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_TryPushBatch, mPtr<mMpmcQueue<T>> &queue, IN const T *pItems, const size_t count, OUT size_t *pPushedCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItems == nullptr || pPushedCount == nullptr, mR_ArgumentNull);
+
+  size_t pushedCount = 0;
+
+  for (; pushedCount < count; pushedCount++)
+  {
+    bool pushed = false;
+    mERROR_CHECK(mMpmcQueue_TryPush(queue, pItems[pushedCount], &pushed));
+
+    if (!pushed)
+      break;
+  }
+
+  *pPushedCount = pushedCount;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_TryPop, mPtr<mMpmcQueue<T>> &queue, OUT T *pItem, OUT bool *pPopped)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItem == nullptr || pPopped == nullptr, mR_ArgumentNull);
+
+  mMpmcQueue<T> *pQueue = queue.GetPointer();
+  mMpmcQueue_Cell<T> *pCell = nullptr;
+  size_t index = pQueue->dequeueIndex.load(std::memory_order_relaxed);
+
+  *pPopped = false;
+
+  while (true)
+  {
+    pCell = &pQueue->pCells[index & pQueue->capacityMask];
+
+    const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+    const ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)(index + 1);
+
+    if (difference == 0)
+    {
+      if (pQueue->dequeueIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+    {
+      mRETURN_SUCCESS(); // The queue is empty.
+    }
+    else
+    {
+      index = pQueue->dequeueIndex.load(std::memory_order_relaxed);
+    }
+  }
+
+  *pItem = std::move(pCell->item);
+  pCell->item.~T();
+
+  // The cell can be pushed to again once the enqueue index has wrapped around.
+  pCell->sequence.store(index + pQueue->capacityMask + 1, std::memory_order_release);
+
+  *pPopped = true;
+
+  mERROR_CHECK(mConcurrentQueue_Wake_Internal(pQueue->pSemaphore, pQueue->waitingCount));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_TryPopBatch, mPtr<mMpmcQueue<T>> &queue, OUT T *pItems, const size_t maxCount, OUT size_t *pPoppedCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItems == nullptr || pPoppedCount == nullptr, mR_ArgumentNull);
+
+  size_t poppedCount = 0;
+
+  for (; poppedCount < maxCount; poppedCount++)
+  {
+    bool popped = false;
+    mERROR_CHECK(mMpmcQueue_TryPop(queue, &pItems[poppedCount], &popped));
+
+    if (!popped)
+      break;
+  }
+
+  *pPoppedCount = poppedCount;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_Push, mPtr<mMpmcQueue<T>> &queue, IN const T &item, const size_t timeoutMs /* = mSemaphore_SleepTime::mS_ST_Infinite */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mConcurrentQueue_Wait_Internal(queue->pSemaphore, queue->waitingCount, timeoutMs, [&](bool *pSucceeded) { return mMpmcQueue_TryPush(queue, item, pSucceeded); }));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_Pop, mPtr<mMpmcQueue<T>> &queue, OUT T *pItem, const size_t timeoutMs /* = mSemaphore_SleepTime::mS_ST_Infinite */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pItem == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mConcurrentQueue_Wait_Internal(queue->pSemaphore, queue->waitingCount, timeoutMs, [&](bool *pSucceeded) { return mMpmcQueue_TryPop(queue, pItem, pSucceeded); }));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_GetCount, const mPtr<mMpmcQueue<T>> &queue, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pCount == nullptr, mR_ArgumentNull);
+
+  const size_t dequeueIndex = queue->dequeueIndex.load(std::memory_order_acquire);
+  const size_t enqueueIndex = queue->enqueueIndex.load(std::memory_order_acquire);
+
+  // Both indices may have moved in between the loads.
+  *pCount = enqueueIndex > dequeueIndex ? mMin(enqueueIndex - dequeueIndex, queue->capacityMask + 1) : 0;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mMpmcQueue_Destroy_Internal, IN mMpmcQueue<T> *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+
+  if (pQueue->pCells != nullptr)
+  {
+    const size_t enqueueIndex = pQueue->enqueueIndex.load();
+
+    for (size_t i = pQueue->dequeueIndex.load(); i != enqueueIndex; i++)
+      pQueue->pCells[i & pQueue->capacityMask].item.~T();
+
+    for (size_t i = 0; i <= pQueue->capacityMask; i++)
+      pQueue->pCells[i].sequence.~atomic();
+
+    mERROR_CHECK(mAllocator_FreePtr(pQueue->pAllocator, &pQueue->pCells));
+  }
+
+  if (pQueue->pSemaphore != nullptr)
+    mERROR_CHECK(mSemaphore_Destroy(&pQueue->pSemaphore));
+
+  pQueue->waitingCount.~atomic();
+  pQueue->enqueueIndex.~atomic();
+  pQueue->dequeueIndex.~atomic();
+
+  mRETURN_SUCCESS();
+}
+
+#endif // mConcurrentQueue_h__
@@ -0,0 +1,100 @@
+#ifndef mFlatHashMap_h__
+#define mFlatHashMap_h__
+
+#include "mediaLib.h"
+#include "mKeyValuePair.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "7+3W5hx22feiZIswduoRMuZnhQWUsINunjx8ZOZBTu89+lEGQOyWeX3xqBnZr4fWXPmQ9jZsHqkOUxbl"
+#endif
+
+// Open addressing hash map using robin hood hashing.
+// Entries are stored in a single flat array, removals shift the following entries back, so no tombstones are ever left behind.
+// Pointers to values are only valid until the next call to `mFlatHashMap_Add`, `mFlatHashMap_Remove` or `mFlatHashMap_Reserve`.
+
+constexpr float_t mFlatHashMap_DefaultMaxLoadFactor = 0.8f;
+constexpr size_t mFlatHashMap_MinCapacity = 16;
+
+template <typename TKey, typename TValue>
+struct mFlatHashMapIterator
+{
+  mKeyValuePair<TKey, TValue> *pEntries;
+  const uint8_t *pProbeLengths;
+  size_t index, capacity;
+
+  mFlatHashMapIterator(mKeyValuePair<TKey, TValue> *pEntries, const uint8_t *pProbeLengths, const size_t index, const size_t capacity);
+  mKeyValuePair<TKey, TValue> & operator *();
+  const mKeyValuePair<TKey, TValue> & operator *() const;
+  bool operator != (const mFlatHashMapIterator<TKey, TValue> &iterator) const;
+  mFlatHashMapIterator<TKey, TValue> & operator++();
+};
+
+template <typename TKey, typename TValue>
+struct mFlatHashMap
+{
+  mAllocator *pAllocator;
+  mKeyValuePair<TKey, TValue> *pEntries;
+  uint8_t *pProbeLengths; // `0` for empty slots, otherwise the distance to the ideal slot + 1.
+  size_t capacity; // Always zero or a power of two.
+  size_t count;
+  size_t growThreshold;
+  float_t maxLoadFactor;
+
+  mFlatHashMapIterator<TKey, TValue> begin()
+  {
+    return mFlatHashMapIterator<TKey, TValue>(pEntries, pProbeLengths, 0, capacity);
+  }
+
+  mFlatHashMapIterator<TKey, TValue> end()
+  {
+    return mFlatHashMapIterator<TKey, TValue>(pEntries, pProbeLengths, capacity, capacity);
+  }
+};
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Create, OUT mPtr<mFlatHashMap<TKey, TValue>> *pHashMap, IN mAllocator *pAllocator, const size_t initialCount = 0);
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Destroy, IN_OUT mPtr<mFlatHashMap<TKey, TValue>> *pHashMap);
+
+// Grows the hash map so that `count` entries can be stored without rehashing.
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Reserve, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const size_t count);
+
+// `maxLoadFactor` has to be in (0, 1). Only applies to subsequent growth of the hash map.
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_SetMaxLoadFactor, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const float_t maxLoadFactor);
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_GetCount, const mPtr<mFlatHashMap<TKey, TValue>> &hashMap, OUT size_t *pCount);
+
+// Returns `mR_ResourceAlreadyExists` if the key is already contained in the hash map.
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Add, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, TKey key, IN TValue *pValue);
+
+// Adds the key or replaces the value of the existing entry.
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Set, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, TKey key, IN TValue *pValue);
+
+// `TLookupKey` can be any type that hashes identical to `TKey` and is comparable with it (e.g. `const char *` or `mInplaceString` for `mString` keys).
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Contains, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT bool *pContains);
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_ContainsGetPointer, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT bool *pContains, OUT TValue **ppValueIfExistent);
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Get, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT TValue *pValue);
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Remove, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT TValue *pValue);
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Clear, mPtr<mFlatHashMap<TKey, TValue>> &hashMap);
+
+#include "mFlatHashMap.inl"
+
+#endif // mFlatHashMap_h__
@@ -0,0 +1,503 @@
+#include "mFlatHashMap.h"
+#include "mHash.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "cmHbcwnx9+lYk1QEyrKLZlSJ2ZrOx/UpLz2JFtgbZUz/DusUVpGT0p9v2euPE6MxLal64dSDi81igGq3"
+#endif
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Destroy_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap);
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Rehash_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, const size_t capacity);
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Insert_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, IN_OUT mKeyValuePair<TKey, TValue> &entry);
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Find_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, const TLookupKey &key, OUT size_t *pIndex, OUT bool *pFound);
+
+template <typename TKey, typename TValue>
+size_t mFlatHashMap_GetRequiredCapacity_Internal(IN const mFlatHashMap<TKey, TValue> *pHashMap, const size_t count);
+
+template <typename T, typename std::enable_if<mIsTriviallyMemoryMovable<T>::value>::type* = nullptr>
+mFUNCTION(mFlatHashMap_DestructMovedFrom_Internal, IN T *pMovedFrom);
+
+template <typename T, typename std::enable_if<!mIsTriviallyMemoryMovable<T>::value>::type* = nullptr>
+mFUNCTION(mFlatHashMap_DestructMovedFrom_Internal, IN T *pMovedFrom);
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename TLookupKey>
+inline mFUNCTION(mFlatHashMap_Hash_Internal, const TLookupKey &key, OUT uint64_t *pHash)
+{
+  return mHash(&key, pHash);
+}
+
+// Hashes identical to `mString` with the same contents.
+inline mFUNCTION(mFlatHashMap_Hash_Internal, IN const char *key, OUT uint64_t *pHash)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(key == nullptr, mR_ArgumentNull);
+  mERROR_CHECK(mHash(key, pHash, strlen(key) + 1));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TLookupKey>
+inline bool mFlatHashMap_KeyEquals_Internal(const TKey &key, const TLookupKey &lookupKey)
+{
+  return key == lookupKey;
+}
+
+inline bool mFlatHashMap_KeyEquals_Internal(const mString &key, IN const char *lookupKey)
+{
+  const size_t bytes = strlen(lookupKey) + 1;
+
+  return key.bytes == bytes && !key.hasFailed && memcmp(key.c_str(), lookupKey, bytes) == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename TKey, typename TValue>
+inline mFlatHashMapIterator<TKey, TValue>::mFlatHashMapIterator(mKeyValuePair<TKey, TValue> *pEntries, const uint8_t *pProbeLengths, const size_t index, const size_t capacity) :
+  pEntries(pEntries),
+  pProbeLengths(pProbeLengths),
+  index(index),
+  capacity(capacity)
+{
+  while (this->index < capacity && pProbeLengths[this->index] == 0)
+    ++this->index;
+}
+
+template <typename TKey, typename TValue>
+inline mKeyValuePair<TKey, TValue> & mFlatHashMapIterator<TKey, TValue>::operator *()
+{
+  return pEntries[index];
+}
+
+template <typename TKey, typename TValue>
+inline const mKeyValuePair<TKey, TValue> & mFlatHashMapIterator<TKey, TValue>::operator *() const
+{
+  return pEntries[index];
+}
+
+template <typename TKey, typename TValue>
+inline bool mFlatHashMapIterator<TKey, TValue>::operator != (const mFlatHashMapIterator<TKey, TValue> &iterator) const
+{
+  return index != iterator.index;
+}
+
+template <typename TKey, typename TValue>
+inline mFlatHashMapIterator<TKey, TValue> & mFlatHashMapIterator<TKey, TValue>::operator++()
+{
+  ++index;
+
+  while (index < capacity && pProbeLengths[index] == 0)
+    ++index;
+
+  return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Create, OUT mPtr<mFlatHashMap<TKey, TValue>> *pHashMap, IN mAllocator *pAllocator, const size_t initialCount /* = 0 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pHashMap == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Allocate(pHashMap, pAllocator, (std::function<void(mFlatHashMap<TKey, TValue> *)>)[](mFlatHashMap<TKey, TValue> *pData) { mFlatHashMap_Destroy_Internal(pData); }, 1));
+
+  (*pHashMap)->pAllocator = pAllocator;
+  (*pHashMap)->maxLoadFactor = mFlatHashMap_DefaultMaxLoadFactor;
+
+  if (initialCount > 0)
+    mERROR_CHECK(mFlatHashMap_Reserve(*pHashMap, initialCount));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Destroy, IN_OUT mPtr<mFlatHashMap<TKey, TValue>> *pHashMap)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pHashMap == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pHashMap));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Reserve, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const size_t count)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr, mR_ArgumentNull);
+
+  const size_t capacity = mFlatHashMap_GetRequiredCapacity_Internal(hashMap.GetPointer(), count);
+
+  if (capacity > hashMap->capacity)
+    mERROR_CHECK(mFlatHashMap_Rehash_Internal(hashMap.GetPointer(), capacity));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_SetMaxLoadFactor, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const float_t maxLoadFactor)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr, mR_ArgumentNull);
+  mERROR_IF(!(maxLoadFactor > 0.f && maxLoadFactor < 1.f), mR_ArgumentOutOfBounds);
+
+  hashMap->maxLoadFactor = maxLoadFactor;
+  hashMap->growThreshold = mMin(hashMap->capacity - 1, (size_t)(hashMap->capacity * maxLoadFactor));
+
+  if (hashMap->count > hashMap->growThreshold)
+    mERROR_CHECK(mFlatHashMap_Reserve(hashMap, hashMap->count));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_GetCount, const mPtr<mFlatHashMap<TKey, TValue>> &hashMap, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pCount == nullptr, mR_ArgumentNull);
+
+  *pCount = hashMap->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Add, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, TKey key, IN TValue *pValue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pValue == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  bool found = false;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, &found));
+  mERROR_IF(found, mR_ResourceAlreadyExists);
+
+  if (hashMap->count + 1 > hashMap->growThreshold)
+    mERROR_CHECK(mFlatHashMap_Rehash_Internal(hashMap.GetPointer(), mMax(mFlatHashMap_MinCapacity, hashMap->capacity * 2)));
+
+  mKeyValuePair<TKey, TValue> kvpair;
+  mERROR_CHECK(mKeyValuePair_Create(&kvpair, std::move(key), *pValue));
+
+  mERROR_CHECK(mFlatHashMap_Insert_Internal(hashMap.GetPointer(), kvpair));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Set, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, TKey key, IN TValue *pValue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pValue == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  bool found = false;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, &found));
+
+  if (found)
+  {
+    mERROR_CHECK(mDestruct(&hashMap->pEntries[index].value));
+    new (&hashMap->pEntries[index].value) TValue(*pValue);
+
+    mRETURN_SUCCESS();
+  }
+
+  mERROR_CHECK(mFlatHashMap_Add(hashMap, std::move(key), pValue));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Contains, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT bool *pContains)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pContains == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, pContains));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_ContainsGetPointer, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT bool *pContains, OUT TValue **ppValueIfExistent)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pContains == nullptr || ppValueIfExistent == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, pContains));
+
+  if (*pContains)
+    *ppValueIfExistent = &hashMap->pEntries[index].value;
+  else
+    *ppValueIfExistent = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Get, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT TValue *pValue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pValue == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  bool found = false;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, &found));
+  mERROR_IF(!found, mR_ResourceNotFound);
+
+  *pValue = hashMap->pEntries[index].value;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue, typename TLookupKey>
+mFUNCTION(mFlatHashMap_Remove, mPtr<mFlatHashMap<TKey, TValue>> &hashMap, const TLookupKey &key, OUT TValue *pValue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr || pValue == nullptr, mR_ArgumentNull);
+
+  size_t index;
+  bool found = false;
+  mERROR_CHECK(mFlatHashMap_Find_Internal(hashMap.GetPointer(), key, &index, &found));
+  mERROR_IF(!found, mR_ResourceNotFound);
+
+  *pValue = std::move(hashMap->pEntries[index].value);
+  mERROR_CHECK(mFlatHashMap_DestructMovedFrom_Internal(&hashMap->pEntries[index].value));
+  mERROR_CHECK(mDestruct(&hashMap->pEntries[index].key));
+
+  // Backward shift deletion: Move all following entries that aren't in their ideal slot one slot closer to it.
+  const size_t mask = hashMap->capacity - 1;
+  size_t next = (index + 1) & mask;
+
+  while (hashMap->pProbeLengths[next] > 1)
+  {
+    new (&hashMap->pEntries[index]) mKeyValuePair<TKey, TValue>(std::move(hashMap->pEntries[next]));
+    mERROR_CHECK(mFlatHashMap_DestructMovedFrom_Internal(&hashMap->pEntries[next]));
+    hashMap->pProbeLengths[index] = hashMap->pProbeLengths[next] - 1;
+
+    index = next;
+    next = (next + 1) & mask;
+  }
+
+  hashMap->pProbeLengths[index] = 0;
+  --hashMap->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+mFUNCTION(mFlatHashMap_Clear, mPtr<mFlatHashMap<TKey, TValue>> &hashMap)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(hashMap == nullptr, mR_ArgumentNull);
+
+  for (size_t i = 0; i < hashMap->capacity; i++)
+  {
+    if (hashMap->pProbeLengths[i] != 0)
+    {
+      mERROR_CHECK(mDestruct(&hashMap->pEntries[i]));
+      hashMap->pProbeLengths[i] = 0;
+    }
+  }
+
+  hashMap->count = 0;
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename TKey, typename TValue>
+inline mFUNCTION(mFlatHashMap_Destroy_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pHashMap == nullptr, mR_ArgumentNull);
+
+  for (size_t i = 0; i < pHashMap->capacity; i++)
+    if (pHashMap->pProbeLengths[i] != 0)
+      mERROR_CHECK(mDestruct(&pHashMap->pEntries[i]));
+
+  mERROR_CHECK(mAllocator_FreePtr(pHashMap->pAllocator, &pHashMap->pEntries));
+  mERROR_CHECK(mAllocator_FreePtr(pHashMap->pAllocator, &pHashMap->pProbeLengths));
+
+  pHashMap->capacity = 0;
+  pHashMap->count = 0;
+  pHashMap->growThreshold = 0;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+inline size_t mFlatHashMap_GetRequiredCapacity_Internal(IN const mFlatHashMap<TKey, TValue> *pHashMap, const size_t count)
+{
+  size_t capacity = mFlatHashMap_MinCapacity;
+
+  while (mMin(capacity - 1, (size_t)(capacity * pHashMap->maxLoadFactor)) < count)
+    capacity *= 2;
+
+  return capacity;
+}
+
+template <typename TKey, typename TValue>
+inline mFUNCTION(mFlatHashMap_Rehash_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, const size_t capacity)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pHashMap == nullptr, mR_ArgumentNull);
+  mERROR_IF(capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity <= pHashMap->count, mR_InvalidParameter);
+
+  mKeyValuePair<TKey, TValue> *pEntries = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pHashMap->pAllocator, &pEntries);
+  mERROR_CHECK(mAllocator_Allocate(pHashMap->pAllocator, &pEntries, capacity));
+
+  uint8_t *pProbeLengths = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pHashMap->pAllocator, &pProbeLengths);
+  mERROR_CHECK(mAllocator_AllocateZero(pHashMap->pAllocator, &pProbeLengths, capacity));
+
+  const size_t previousCapacity = pHashMap->capacity;
+
+  std::swap(pHashMap->pEntries, pEntries);
+  std::swap(pHashMap->pProbeLengths, pProbeLengths);
+
+  pHashMap->capacity = capacity;
+  pHashMap->count = 0;
+  pHashMap->growThreshold = mMin(capacity - 1, (size_t)(capacity * pHashMap->maxLoadFactor));
+
+  // `pEntries` and `pProbeLengths` now contain the previous entries and will be freed when leaving the scope.
+  for (size_t i = 0; i < previousCapacity; i++)
+  {
+    if (pProbeLengths[i] != 0)
+    {
+      mERROR_CHECK(mFlatHashMap_Insert_Internal(pHashMap, pEntries[i]));
+      mERROR_CHECK(mFlatHashMap_DestructMovedFrom_Internal(&pEntries[i]));
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+// Trivially memory movable types have been relocated by moving them, so there's nothing left to destruct.
+template <typename T, typename std::enable_if<mIsTriviallyMemoryMovable<T>::value>::type* /* = nullptr */>
+inline mFUNCTION(mFlatHashMap_DestructMovedFrom_Internal, IN T * /* pMovedFrom */)
+{
+  mFUNCTION_SETUP();
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T, typename std::enable_if<!mIsTriviallyMemoryMovable<T>::value>::type* /* = nullptr */>
+inline mFUNCTION(mFlatHashMap_DestructMovedFrom_Internal, IN T *pMovedFrom)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mDestruct(pMovedFrom));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename TKey, typename TValue>
+inline mFUNCTION(mFlatHashMap_Insert_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, IN_OUT mKeyValuePair<TKey, TValue> &entry)
+{
+  mFUNCTION_SETUP();
+
+  while (true)
+  {
+    uint64_t hash = 0;
+    mERROR_CHECK(mFlatHashMap_Hash_Internal(entry.key, &hash));
+
+    const size_t mask = pHashMap->capacity - 1;
+    size_t index = (size_t)hash & mask;
+    uint8_t probeLength = 1;
+
+    while (true)
+    {
+      uint8_t &slotProbeLength = pHashMap->pProbeLengths[index];
+
+      if (slotProbeLength == 0)
+      {
+        new (&pHashMap->pEntries[index]) mKeyValuePair<TKey, TValue>(std::move(entry));
+        slotProbeLength = probeLength;
+        ++pHashMap->count;
+
+        mRETURN_SUCCESS();
+      }
+
+      // Take from the rich: the entry that is closer to its ideal slot has to move on.
+      if (slotProbeLength < probeLength)
+      {
+        std::swap(pHashMap->pEntries[index], entry);
+        std::swap(slotProbeLength, probeLength);
+      }
+
+      if (probeLength == mMaxValue<uint8_t>())
+        break;
+
+      ++probeLength;
+      index = (index + 1) & mask;
+    }
+
+    // The probe length doesn't fit into the metadata anymore. This should only ever happen with terrible hashes.
+    // The entry we're currently holding has been displaced and will be inserted after growing.
+    mERROR_CHECK(mFlatHashMap_Rehash_Internal(pHashMap, pHashMap->capacity * 2));
+  }
+}
+
+template <typename TKey, typename TValue, typename TLookupKey>
+inline mFUNCTION(mFlatHashMap_Find_Internal, IN mFlatHashMap<TKey, TValue> *pHashMap, const TLookupKey &key, OUT size_t *pIndex, OUT bool *pFound)
+{
+  mFUNCTION_SETUP();
+
+  *pFound = false;
+
+  if (pHashMap->count == 0)
+    mRETURN_SUCCESS();
+
+  uint64_t hash = 0;
+  mERROR_CHECK(mFlatHashMap_Hash_Internal(key, &hash));
+
+  const size_t mask = pHashMap->capacity - 1;
+  size_t index = (size_t)hash & mask;
+
+  // Robin hood invariant: once we've traveled further than the entry in the current slot, the key can't be contained.
+  for (size_t probeLength = 1; probeLength <= pHashMap->pProbeLengths[index]; probeLength++)
+  {
+    if (mFlatHashMap_KeyEquals_Internal(pHashMap->pEntries[index].key, key))
+    {
+      *pIndex = index;
+      *pFound = true;
+
+      mRETURN_SUCCESS();
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  mRETURN_SUCCESS();
+}
@@ -66,9 +66,11 @@ mFUNCTION(mHashMap_Contains, mPtr<mHashMap<TKey, TValue>> &hashMap, TKey key, OU
   size_t index = 0;
   mERROR_CHECK(mHashMap_Hash_Internal(hashMap, &key, &index));
 
-  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> chunkedArray;
-  mDEFER_CALL(&chunkedArray, mChunkedArray_Destroy);
-  mERROR_CHECK(mQueue_PeekAt(hashMap->data, index, &chunkedArray));
+  // Borrow the bucket instead of copying the `mPtr` to not touch its reference count on every lookup.
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> *pChunkedArray = nullptr;
+  mERROR_CHECK(mQueue_PointerAt(hashMap->data, index, &pChunkedArray));
+
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> &chunkedArray = *pChunkedArray;
 
   size_t count = 0;
   mERROR_CHECK(mChunkedArray_GetCount(chunkedArray, &count));
@@ -101,9 +103,10 @@ mFUNCTION(mHashMap_ContainsGetPointer, mPtr<mHashMap<TKey, TValue>> &hashMap, TK
   size_t index = 0;
   mERROR_CHECK(mHashMap_Hash_Internal(hashMap, &key, &index));
 
-  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> chunkedArray;
-  mDEFER_CALL(&chunkedArray, mChunkedArray_Destroy);
-  mERROR_CHECK(mQueue_PeekAt(hashMap->data, index, &chunkedArray));
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> *pChunkedArray = nullptr;
+  mERROR_CHECK(mQueue_PointerAt(hashMap->data, index, &pChunkedArray));
+
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> &chunkedArray = *pChunkedArray;
 
   size_t count = 0;
   mERROR_CHECK(mChunkedArray_GetCount(chunkedArray, &count));
@@ -137,9 +140,10 @@ mFUNCTION(mHashMap_Add, mPtr<mHashMap<TKey, TValue>> &hashMap, TKey key, IN TVal
   size_t index = 0;
   mERROR_CHECK(mHashMap_Hash_Internal(hashMap, &key, &index));
 
-  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> chunkedArray;
-  mDEFER_CALL(&chunkedArray, mChunkedArray_Destroy);
-  mERROR_CHECK(mQueue_PeekAt(hashMap->data, index, &chunkedArray));
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> *pChunkedArray = nullptr;
+  mERROR_CHECK(mQueue_PointerAt(hashMap->data, index, &pChunkedArray));
+
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> &chunkedArray = *pChunkedArray;
 
   mKeyValuePair<TKey, TValue> kvpair;
   mERROR_CHECK(mKeyValuePair_Create(&kvpair, key, *pValue));
@@ -175,9 +179,10 @@ mFUNCTION(mHashMap_Remove, mPtr<mHashMap<TKey, TValue>> &hashMap, TKey key, OUT
   size_t index = 0;
   mERROR_CHECK(mHashMap_Hash_Internal(hashMap, &key, &index));
 
-  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> chunkedArray;
-  mDEFER_CALL(&chunkedArray, mChunkedArray_Destroy);
-  mERROR_CHECK(mQueue_PeekAt(hashMap->data, index, &chunkedArray));
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> *pChunkedArray = nullptr;
+  mERROR_CHECK(mQueue_PointerAt(hashMap->data, index, &pChunkedArray));
+
+  mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> &chunkedArray = *pChunkedArray;
 
   size_t count = 0;
   mERROR_CHECK(mChunkedArray_GetCount(chunkedArray, &count));
@@ -207,12 +212,11 @@ mFUNCTION(mHashMap_SetKeyValuePairDestructionFunction, mPtr<mHashMap<TKey, TValu
 
   mERROR_IF(hashMap == nullptr, mR_ArgumentNull);
 
-  for (size_t i = 0; i < hashMapSize; ++i)
+  for (size_t i = 0; i < hashMap->hashMapSize; ++i)
   {
-    mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> chunkedArray;
-    mDEFER_CALL(chunkedArray, mChunkedArray_Destroy);
-    mERROR_CHECK(mQueue_PeekAt(hashMap->data, i, &chunkedArray));
-    mERROR_CHECK(mChunkedArray_SetDestructionFunction(chunkedArray, destructionFunction));
+    mPtr<mChunkedArray<mKeyValuePair<TKey, TValue>>> *pChunkedArray = nullptr;
+    mERROR_CHECK(mQueue_PointerAt(hashMap->data, i, &pChunkedArray));
+    mERROR_CHECK(mChunkedArray_SetDestructionFunction(*pChunkedArray, destructionFunction));
   }
 
   mRETURN_SUCCESS();
@@ -0,0 +1,84 @@
+#ifndef mPagedArray_h__
+#define mPagedArray_h__
+
+#include "mediaLib.h"
+#include "mThreadPool.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "8dRrPH/Zo806IJnyX6spDN+JnIVYPplDWRhOdNtH8zdrrGa2tj6Ti2/1afNo04gqVABPkKmibUzNfO7T"
+#endif
+
+// Like `mChunkedArray`, but all blocks have the same power-of-two size and are always densely filled, so finding an item is a shift and a mask into the block directory instead of a search through the blocks.
+// Blocks are never moved or released while the array grows, so pointers to items stay valid until the item is removed or the array is cleared.
+// Items are only ever removed by moving the last item into their place (`mPagedArray_SwapRemoveAt`) or from the back.
+
+template <typename T>
+struct mPagedArray
+{
+  T **ppBlocks; // The block directory.
+  size_t blockCount, blockCapacity;
+  size_t blockShift, blockMask;
+  size_t count;
+  mAllocator *pAllocator;
+
+  inline T & operator[](const size_t index)
+  {
+    return ppBlocks[index >> blockShift][index & blockMask];
+  }
+
+  inline const T & operator[](const size_t index) const
+  {
+    return ppBlocks[index >> blockShift][index & blockMask];
+  }
+};
+
+// `blockSize` has to be a power of two.
+template <typename T>
+mFUNCTION(mPagedArray_Create, OUT mPtr<mPagedArray<T>> *pPagedArray, IN mAllocator *pAllocator, const size_t blockSize = 64);
+
+template <typename T>
+mFUNCTION(mPagedArray_Destroy, IN_OUT mPtr<mPagedArray<T>> *pPagedArray);
+
+template <typename T>
+mFUNCTION(mPagedArray_PushBack, mPtr<mPagedArray<T>> &pagedArray, IN const T *pItem);
+
+template <typename T>
+mFUNCTION(mPagedArray_PushBack, mPtr<mPagedArray<T>> &pagedArray, IN T &&item);
+
+template <typename T>
+mFUNCTION(mPagedArray_GetCount, const mPtr<mPagedArray<T>> &pagedArray, OUT size_t *pCount);
+
+template <typename T>
+mFUNCTION(mPagedArray_PeekAt, const mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T *pItem);
+
+template <typename T>
+mFUNCTION(mPagedArray_PointerAt, mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T **ppItem);
+
+template <typename T>
+mFUNCTION(mPagedArray_PointerAt, const mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT const T **ppItem);
+
+template <typename T>
+mFUNCTION(mPagedArray_PopBack, mPtr<mPagedArray<T>> &pagedArray, OUT T *pItem);
+
+// Moves the last item into `index`, so only pointers to the last item are invalidated.
+template <typename T>
+mFUNCTION(mPagedArray_SwapRemoveAt, mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T *pItem);
+
+// Destructs all items but keeps the blocks for reuse.
+template <typename T>
+mFUNCTION(mPagedArray_Clear, mPtr<mPagedArray<T>> &pagedArray);
+
+// `function` can return `mR_Break` to stop iterating.
+template <typename T>
+mFUNCTION(mPagedArray_ForEach, mPtr<mPagedArray<T>> &pagedArray, const std::function<mResult(T *, size_t)> &function);
+
+// Calls `function` for every item, handing whole blocks to the worker threads of `threadPool`. Items must not be added or removed while this is in progress.
+template <typename T>
+mFUNCTION(mPagedArray_ForEachParallel, mPtr<mPagedArray<T>> &pagedArray, mPtr<mThreadPool> &threadPool, const std::function<mResult(T *, size_t)> &function);
+
+#include "mPagedArray.inl"
+
+#endif // mPagedArray_h__
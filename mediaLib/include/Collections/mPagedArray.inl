@@ -0,0 +1,314 @@
+#include "mPagedArray.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "6FnYuI3T9g5TFrbloxi5onfHVmqdEiiKLX9KTSltoEWNmuOJ/JoeMirGw9y0yZnMQTU9FFFqg1FC5Wcz"
+#endif
+
+template <typename T>
+mFUNCTION(mPagedArray_Destroy_Internal, IN mPagedArray<T> *pPagedArray);
+
+template <typename T>
+mFUNCTION(mPagedArray_Grow_Internal, mPtr<mPagedArray<T>> &pagedArray);
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+mFUNCTION(mPagedArray_Create, OUT mPtr<mPagedArray<T>> *pPagedArray, IN mAllocator *pAllocator, const size_t blockSize /* = 64 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPagedArray == nullptr, mR_ArgumentNull);
+  mERROR_IF(blockSize == 0 || (blockSize & (blockSize - 1)) != 0, mR_ArgumentOutOfBounds);
+
+  mERROR_CHECK(mSharedPointer_Allocate(pPagedArray, pAllocator, (std::function<void(mPagedArray<T> *)>) [](mPagedArray<T> *pData) { mPagedArray_Destroy_Internal(pData); }, 1));
+
+  size_t blockShift = 0;
+
+  while (((size_t)1 << blockShift) < blockSize)
+    ++blockShift;
+
+  (*pPagedArray)->pAllocator = pAllocator;
+  (*pPagedArray)->blockShift = blockShift;
+  (*pPagedArray)->blockMask = blockSize - 1;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_Destroy, IN_OUT mPtr<mPagedArray<T>> *pPagedArray)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPagedArray == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pPagedArray));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PushBack, mPtr<mPagedArray<T>> &pagedArray, IN const T *pItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || pItem == nullptr, mR_ArgumentNull);
+
+  if ((pagedArray->count >> pagedArray->blockShift) >= pagedArray->blockCount)
+    mERROR_CHECK(mPagedArray_Grow_Internal(pagedArray));
+
+  new (&(*pagedArray)[pagedArray->count]) T(*pItem);
+  ++pagedArray->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PushBack, mPtr<mPagedArray<T>> &pagedArray, IN T &&item)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr, mR_ArgumentNull);
+
+  if ((pagedArray->count >> pagedArray->blockShift) >= pagedArray->blockCount)
+    mERROR_CHECK(mPagedArray_Grow_Internal(pagedArray));
+
+  new (&(*pagedArray)[pagedArray->count]) T(std::move(item));
+  ++pagedArray->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_GetCount, const mPtr<mPagedArray<T>> &pagedArray, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || pCount == nullptr, mR_ArgumentNull);
+
+  *pCount = pagedArray->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PeekAt, const mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T *pItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || pItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(pagedArray->count <= index, mR_IndexOutOfBounds);
+
+  *pItem = (*pagedArray)[index];
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PointerAt, mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T **ppItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || ppItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(pagedArray->count <= index, mR_IndexOutOfBounds);
+
+  *ppItem = &(*pagedArray)[index];
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PointerAt, const mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT const T **ppItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || ppItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(pagedArray->count <= index, mR_IndexOutOfBounds);
+
+  *ppItem = &(*pagedArray)[index];
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_PopBack, mPtr<mPagedArray<T>> &pagedArray, OUT T *pItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || pItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(pagedArray->count == 0, mR_IndexOutOfBounds);
+
+  T *pLast = &(*pagedArray)[pagedArray->count - 1];
+
+  *pItem = std::move(*pLast);
+  mERROR_CHECK(mDestruct(pLast));
+
+  --pagedArray->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_SwapRemoveAt, mPtr<mPagedArray<T>> &pagedArray, const size_t index, OUT T *pItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || pItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(pagedArray->count <= index, mR_IndexOutOfBounds);
+
+  T *pRemoved = &(*pagedArray)[index];
+  T *pLast = &(*pagedArray)[pagedArray->count - 1];
+
+  *pItem = std::move(*pRemoved);
+
+  if (pRemoved != pLast)
+    *pRemoved = std::move(*pLast);
+
+  mERROR_CHECK(mDestruct(pLast));
+
+  --pagedArray->count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_Clear, mPtr<mPagedArray<T>> &pagedArray)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr, mR_ArgumentNull);
+
+  for (size_t i = 0; i < pagedArray->count; ++i)
+    mERROR_CHECK(mDestruct(&(*pagedArray)[i]));
+
+  pagedArray->count = 0;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_ForEach, mPtr<mPagedArray<T>> &pagedArray, const std::function<mResult(T *, size_t)> &function)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || function == nullptr, mR_ArgumentNull);
+
+  const size_t blockSize = pagedArray->blockMask + 1;
+
+  for (size_t blockIndex = 0; blockIndex * blockSize < pagedArray->count; ++blockIndex)
+  {
+    T *pBlock = pagedArray->ppBlocks[blockIndex];
+    const size_t blockStart = blockIndex * blockSize;
+    const size_t itemsInBlock = mMin(blockSize, pagedArray->count - blockStart);
+
+    for (size_t i = 0; i < itemsInBlock; ++i)
+    {
+      const mResult result = function(pBlock + i, blockStart + i);
+
+      if (mFAILED(result))
+      {
+        if (result == mR_Break)
+          mRETURN_SUCCESS();
+        else
+          mRETURN_RESULT(result);
+      }
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPagedArray_ForEachParallel, mPtr<mPagedArray<T>> &pagedArray, mPtr<mThreadPool> &threadPool, const std::function<mResult(T *, size_t)> &function)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pagedArray == nullptr || threadPool == nullptr || function == nullptr, mR_ArgumentNull);
+
+  const size_t blockSize = pagedArray->blockMask + 1;
+  const size_t count = pagedArray->count;
+  const size_t usedBlocks = (count + blockSize - 1) >> pagedArray->blockShift;
+  T **ppBlocks = pagedArray->ppBlocks;
+
+  // Like `mPagedArray_ForEach`, `mR_Break` isn't an error, but blocks that haven't been started yet are skipped.
+  std::atomic<bool> hasBroken(false);
+
+  // Blocks are the unit of work, so no two threads ever touch the same block.
+  mERROR_CHECK(mThreadPool_ParallelFor(threadPool, 0, usedBlocks, 0, [&](const size_t blockStartIndex, const size_t blockEndIndex)
+  {
+    for (size_t blockIndex = blockStartIndex; blockIndex < blockEndIndex && !hasBroken.load(std::memory_order_relaxed); ++blockIndex)
+    {
+      T *pBlock = ppBlocks[blockIndex];
+      const size_t blockStart = blockIndex * blockSize;
+      const size_t itemsInBlock = mMin(blockSize, count - blockStart);
+
+      for (size_t i = 0; i < itemsInBlock; ++i)
+      {
+        const mResult result = function(pBlock + i, blockStart + i);
+
+        if (mFAILED(result))
+        {
+          if (result != mR_Break)
+            return result;
+
+          hasBroken.store(true, std::memory_order_relaxed);
+
+          return mR_Success;
+        }
+      }
+    }
+
+    return mR_Success;
+  }));
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline mFUNCTION(mPagedArray_Destroy_Internal, IN mPagedArray<T> *pPagedArray)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPagedArray == nullptr, mR_ArgumentNull);
+
+  for (size_t i = 0; i < pPagedArray->count; ++i)
+    mERROR_CHECK(mDestruct(&(*pPagedArray)[i]));
+
+  pPagedArray->count = 0;
+
+  for (size_t i = 0; i < pPagedArray->blockCount; ++i)
+    mERROR_CHECK(mAllocator_FreePtr(pPagedArray->pAllocator, &pPagedArray->ppBlocks[i]));
+
+  pPagedArray->blockCount = 0;
+
+  mERROR_CHECK(mAllocator_FreePtr(pPagedArray->pAllocator, &pPagedArray->ppBlocks));
+  pPagedArray->blockCapacity = 0;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mPagedArray_Grow_Internal, mPtr<mPagedArray<T>> &pagedArray)
+{
+  mFUNCTION_SETUP();
+
+  // Only the directory is reallocated, the blocks themselves stay where they are.
+  if (pagedArray->blockCount == pagedArray->blockCapacity)
+  {
+    const size_t newBlockCapacity = pagedArray->blockCapacity == 0 ? 4 : pagedArray->blockCapacity * 2;
+    mERROR_CHECK(mAllocator_Reallocate(pagedArray->pAllocator, &pagedArray->ppBlocks, newBlockCapacity));
+    pagedArray->blockCapacity = newBlockCapacity;
+  }
+
+  T *pBlock = nullptr;
+  mERROR_CHECK(mAllocator_Allocate(pagedArray->pAllocator, &pBlock, pagedArray->blockMask + 1));
+
+  pagedArray->ppBlocks[pagedArray->blockCount] = pBlock;
+  ++pagedArray->blockCount;
+
+  mRETURN_SUCCESS();
+}
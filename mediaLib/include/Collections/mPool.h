@@ -36,7 +36,7 @@ struct mPoolIterator
   typename mPoolIterator<T>& operator++();
 
 private:
-  size_t index, blockIndex, flag, globalIndex;
+  size_t blockIndex, remainingFlags, globalIndex;
   T *pData;
   mPool<T> *pPool;
 };
@@ -61,18 +61,28 @@ struct mConstPoolIterator
   typename mConstPoolIterator<T>& operator++();
 
 private:
-  size_t index, blockIndex, flag, globalIndex;
+  size_t blockIndex, remainingFlags, globalIndex;
   const T *pData;
   const mPool<T> *pPool;
 };
 
+// Identifies an item like its index, but can't be used anymore once the item has been removed, even if the index has been reused since.
+struct mPoolHandle
+{
+  size_t index;
+  uint32_t generation;
+};
+
 template <typename T>
 struct mPool
 {
   size_t count;
-  size_t size;
+  size_t size; // in blocks of `mBITS_OF(size_t)` indexes.
   size_t allocatedSize;
-  size_t *pIndexes;
+  size_t *pIndexes; // bit is set if the index is occupied.
+  size_t *pAvailableBlocks; // bit is set if the corresponding block in `pIndexes` has a free index. Only covers the first `size` blocks.
+  size_t firstAvailableBlocksWord; // all words of `pAvailableBlocks` before this one are zero, so searching for a free index can start here.
+  uint32_t *pGenerations; // incremented whenever an index is freed.
   mPtr<mChunkedArray<T>> data;
   mAllocator *pAllocator;
 
@@ -123,9 +133,28 @@ mFUNCTION(mPool_PointerAt, mPtr<mPool<T>> &pool, const size_t index, OUT T **ppI
 template <typename T>
 mFUNCTION(mPool_PointerAt, const mPtr<mPool<T>> &pool, const size_t index, OUT T * const *ppItem);
 
+template <typename T>
+mFUNCTION(mPool_GetHandle, const mPtr<mPool<T>> &pool, const size_t index, OUT mPoolHandle *pHandle);
+
+// Returns `mR_ResourceNotFound` if the item referred to by the handle has been removed.
+template <typename T>
+mFUNCTION(mPool_PointerAt, mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT T **ppItem);
+
+// Returns `mR_ResourceNotFound` if the item referred to by the handle has been removed.
+template <typename T>
+mFUNCTION(mPool_RemoveAt, mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT T *pItem);
+
+template <typename T>
+mFUNCTION(mPool_ContainsHandle, const mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT bool *pContained);
+
 template <typename T>
 mFUNCTION(mPool_ForEach, mPtr<mPool<T>> &pool, const std::function<mResult (T *, size_t)> &function);
 
+// Moves the items with the highest indexes into the free indexes below them, until all items are stored in the first `count` indexes.
+// Indexes and handles of moved items are invalidated. `onMoved` is called for every moved item.
+template <typename T>
+mFUNCTION(mPool_Compact, mPtr<mPool<T>> &pool, const std::function<mResult (const size_t previousIndex, const size_t newIndex)> &onMoved = nullptr);
+
 template <typename T>
 mFUNCTION(mPool_ContainsIndex, const mPtr<mPool<T>> &pool, const size_t index, OUT bool *pContained);
 
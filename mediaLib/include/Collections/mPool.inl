@@ -1,5 +1,9 @@
 #include "mPool.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
     #undef __M_FILE__
@@ -10,6 +14,27 @@
 template <typename T>
 mFUNCTION(mPool_Destroy_Internal, IN mPool<T> *pPool);
 
+template <typename T>
+mFUNCTION(mPool_Grow_Internal, IN mPool<T> *pPool);
+
+template <typename T>
+mFUNCTION(mPool_AcquireIndex_Internal, IN mPool<T> *pPool, OUT size_t *pIndex);
+
+template <typename T>
+void mPool_OccupyIndex_Internal(IN mPool<T> *pPool, const size_t index);
+
+template <typename T>
+void mPool_ReleaseIndex_Internal(IN mPool<T> *pPool, const size_t index);
+
+template <typename T>
+bool mPool_IsOccupied_Internal(IN const mPool<T> *pPool, const size_t index);
+
+template <typename T>
+bool mPool_NextOccupied_Internal(IN const mPool<T> *pPool, IN_OUT size_t *pBlockIndex, IN_OUT size_t *pRemainingFlags, OUT size_t *pIndex);
+
+inline size_t mPool_LowestSetBit_Internal(const size_t value);
+inline size_t mPool_HighestSetBit_Internal(const size_t value);
+
 //////////////////////////////////////////////////////////////////////////
 
 template <typename T>
@@ -21,6 +46,8 @@ mFUNCTION(mPool_Create, OUT mPtr<mPool<T>> *pPool, IN mAllocator *pAllocator)
 
   mERROR_CHECK(mSharedPointer_Allocate(pPool, pAllocator, (std::function<void(mPool<T> *)>) [](mPool<T> *pData) { mPool_Destroy_Internal(pData); }, 1));
 
+  (*pPool)->pAllocator = pAllocator;
+
   mERROR_CHECK(mChunkedArray_Create(&(*pPool)->data, pAllocator));
 
   mRETURN_SUCCESS();
@@ -45,58 +72,26 @@ mFUNCTION(mPool_Add, mPtr<mPool<T>> &pool, IN T *pItem, OUT size_t *pIndex)
 
   mERROR_IF(pool == nullptr || pItem == nullptr || pIndex == nullptr, mR_ArgumentNull);
 
-  // Grow if necessary
-  if (pool->count == pool->size * mBITS_OF(*pool->pIndexes))
-  {
-    if (pool->allocatedSize == pool->size)
-    {
-      const size_t newAllocatedSize = pool->allocatedSize * 2 + 1;
-      mERROR_CHECK(mAllocator_Reallocate(pool->pAllocator, &pool->pIndexes, newAllocatedSize));
-      pool->allocatedSize = newAllocatedSize;
-    }
+  size_t index = 0;
+  mERROR_CHECK(mPool_AcquireIndex_Internal(pool.GetPointer(), &index));
+  mDEFER_ON_ERROR(mPool_ReleaseIndex_Internal(pool.GetPointer(), index));
 
-    pool->pIndexes[pool->size] = 0;
-    ++pool->size;
-  }
+  size_t dataCount = 0;
+  mERROR_CHECK(mChunkedArray_GetCount(pool->data, &dataCount));
 
-  for (size_t i = 0; i < pool->size; ++i)
+  if (index == dataCount)
   {
-    std::remove_reference<decltype(*pool->pIndexes)>::type flags = pool->pIndexes[i];
-
-    if (flags == (size_t)-1)
-      continue;
-
-    for (size_t indexOffset = 0; indexOffset < mBITS_OF(flags); ++indexOffset)
-    {
-      if ((flags & 1) == 0)
-      {
-        *pIndex = indexOffset + i * mBITS_OF(flags);
-        size_t dataCount = 0;
-        mERROR_CHECK(mChunkedArray_GetCount(pool->data, &dataCount));
-
-        if (*pIndex == dataCount)
-        {
-          mERROR_CHECK(mChunkedArray_PushBack(pool->data, pItem));
-        }
-        else
-        {
-          T *pInItem;
-          mERROR_CHECK(mChunkedArray_PointerAt(pool->data, *pIndex, &pInItem));
-
-          new (pInItem) T(*pItem);
-        }
-
-        pool->pIndexes[i] |= ((size_t)1 << indexOffset);
-        ++pool->count;
-
-        goto break_all_loops;
-      }
+    mERROR_CHECK(mChunkedArray_PushBack(pool->data, pItem));
+  }
+  else
+  {
+    T *pInItem;
+    mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, &pInItem));
 
-      flags >>= 1;
-    }
+    new (pInItem) T(*pItem);
   }
 
-break_all_loops:
+  *pIndex = index;
 
   mRETURN_SUCCESS();
 }
@@ -108,58 +103,26 @@ mFUNCTION(mPool_Add, mPtr<mPool<T>> &pool, IN T &&item, OUT size_t *pIndex)
 
   mERROR_IF(pool == nullptr || pIndex == nullptr, mR_ArgumentNull);
 
-  // Grow if necessary
-  if (pool->count == pool->size * mBITS_OF(*pool->pIndexes))
-  {
-    if (pool->allocatedSize == pool->size)
-    {
-      const size_t newAllocatedSize = pool->allocatedSize * 2 + 1;
-      mERROR_CHECK(mAllocator_Reallocate(pool->pAllocator, &pool->pIndexes, newAllocatedSize));
-      pool->allocatedSize = newAllocatedSize;
-    }
+  size_t index = 0;
+  mERROR_CHECK(mPool_AcquireIndex_Internal(pool.GetPointer(), &index));
+  mDEFER_ON_ERROR(mPool_ReleaseIndex_Internal(pool.GetPointer(), index));
 
-    pool->pIndexes[pool->size] = 0;
-    ++pool->size;
-  }
+  size_t dataCount = 0;
+  mERROR_CHECK(mChunkedArray_GetCount(pool->data, &dataCount));
 
-  for (size_t i = 0; i < pool->size; ++i)
+  if (index == dataCount)
   {
-    std::remove_reference<decltype(*pool->pIndexes)>::type flags = pool->pIndexes[i];
-
-    if (flags == (size_t)-1)
-      continue;
-
-    for (size_t indexOffset = 0; indexOffset < mBITS_OF(flags); ++indexOffset)
-    {
-      if ((flags & 1) == 0)
-      {
-        *pIndex = indexOffset + i * mBITS_OF(flags);
-        size_t dataCount = 0;
-        mERROR_CHECK(mChunkedArray_GetCount(pool->data, &dataCount));
-
-        if (*pIndex == dataCount)
-        {
-          mERROR_CHECK(mChunkedArray_PushBack(pool->data, std::forward<T>(item)));
-        }
-        else
-        {
-          T *pInItem;
-          mERROR_CHECK(mChunkedArray_PointerAt(pool->data, *pIndex, &pInItem));
-
-          new (pInItem) T(std::move(item));
-        }
-
-        pool->pIndexes[i] |= ((size_t)1 << indexOffset);
-        ++pool->count;
-
-        goto break_all_loops;
-      }
+    mERROR_CHECK(mChunkedArray_PushBack(pool->data, std::forward<T>(item)));
+  }
+  else
+  {
+    T *pInItem;
+    mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, &pInItem));
 
-      flags >>= 1;
-    }
+    new (pInItem) T(std::move(item));
   }
 
-break_all_loops:
+  *pIndex = index;
 
   mRETURN_SUCCESS();
 }
@@ -170,31 +133,15 @@ mFUNCTION(mPool_RemoveAt, mPtr<mPool<T>> &pool, const size_t index, OUT T *pItem
   mFUNCTION_SETUP();
 
   mERROR_IF(pool == nullptr || pItem == nullptr, mR_ArgumentNull);
-  mERROR_IF(index >= pool->size * mBITS_OF(pool->pIndexes[0]), mR_IndexOutOfBounds);
-
-  const size_t lutIndex = index / mBITS_OF(pool->pIndexes[0]);
-  const size_t lutSubIndex = index - lutIndex * mBITS_OF(pool->pIndexes[0]);
-
-  mERROR_IF((pool->pIndexes[lutIndex] & ((size_t)1 << lutSubIndex)) == 0, mR_IndexOutOfBounds);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), index), mR_IndexOutOfBounds);
 
   T *pOutItem = nullptr;
   mERROR_CHECK(mPool_PointerAt(pool, index, &pOutItem));
 
   *pItem = std::move(*pOutItem);
   mERROR_CHECK(mMemset(pOutItem, 1));
-  --pool->count;
-  pool->pIndexes[lutIndex] &= ~((size_t)1 << lutSubIndex);
 
-  if (lutIndex == pool->size - 1)
-  {
-    for (int64_t lutFilledIndex = pool->size - 1; lutFilledIndex >= 0; --lutFilledIndex)
-    {
-      if (pool->pIndexes[lutFilledIndex] == 0)
-        --pool->size;
-      else
-        break;
-    }
-  }
+  mPool_ReleaseIndex_Internal(pool.GetPointer(), index);
 
   mRETURN_SUCCESS();
 }
@@ -247,12 +194,20 @@ mFUNCTION(mPool_PointerAt, mPtr<mPool<T>> &pool, const size_t index, OUT T **ppI
   mFUNCTION_SETUP();
 
   mERROR_IF(pool == nullptr || ppItem == nullptr, mR_ArgumentNull);
-  mERROR_IF(index >= pool->size * mBITS_OF(pool->pIndexes[0]), mR_IndexOutOfBounds);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), index), mR_IndexOutOfBounds);
+
+  mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, ppItem));
 
-  const size_t lutIndex = index / mBITS_OF(pool->pIndexes[0]);
-  const size_t lutSubIndex = index - lutIndex * mBITS_OF(pool->pIndexes[0]);
+  mRETURN_SUCCESS();
+}
 
-  mERROR_IF((pool->pIndexes[lutIndex] & ((size_t)1 << lutSubIndex)) == 0, mR_IndexOutOfBounds);
+template <typename T>
+mFUNCTION(mPool_PointerAt, const mPtr<mPool<T>> &pool, const size_t index, OUT const T **ppItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pool == nullptr || ppItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), index), mR_IndexOutOfBounds);
 
   mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, ppItem));
 
@@ -260,19 +215,53 @@ mFUNCTION(mPool_PointerAt, mPtr<mPool<T>> &pool, const size_t index, OUT T **ppI
 }
 
 template <typename T>
-mFUNCTION(mPool_PointerAt, const mPtr<mPool<T>> &pool, const size_t index, OUT const T **ppItem)
+mFUNCTION(mPool_GetHandle, const mPtr<mPool<T>> &pool, const size_t index, OUT mPoolHandle *pHandle)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pool == nullptr || pHandle == nullptr, mR_ArgumentNull);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), index), mR_IndexOutOfBounds);
+
+  pHandle->index = index;
+  pHandle->generation = pool->pGenerations[index];
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPool_PointerAt, mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT T **ppItem)
 {
   mFUNCTION_SETUP();
 
   mERROR_IF(pool == nullptr || ppItem == nullptr, mR_ArgumentNull);
-  mERROR_IF(index >= pool->size * mBITS_OF(pool->pIndexes[0]), mR_IndexOutOfBounds);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), handle.index) || pool->pGenerations[handle.index] != handle.generation, mR_ResourceNotFound);
 
-  const size_t lutIndex = index / mBITS_OF(pool->pIndexes[0]);
-  const size_t lutSubIndex = index - lutIndex * mBITS_OF(pool->pIndexes[0]);
+  mERROR_CHECK(mChunkedArray_PointerAt(pool->data, handle.index, ppItem));
 
-  mERROR_IF((pool->pIndexes[lutIndex] & ((size_t)1 << lutSubIndex)) == 0, mR_IndexOutOfBounds);
+  mRETURN_SUCCESS();
+}
 
-  mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, ppItem));
+template <typename T>
+mFUNCTION(mPool_RemoveAt, mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT T *pItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pool == nullptr || pItem == nullptr, mR_ArgumentNull);
+  mERROR_IF(!mPool_IsOccupied_Internal(pool.GetPointer(), handle.index) || pool->pGenerations[handle.index] != handle.generation, mR_ResourceNotFound);
+
+  mERROR_CHECK(mPool_RemoveAt(pool, handle.index, pItem));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPool_ContainsHandle, const mPtr<mPool<T>> &pool, const mPoolHandle handle, OUT bool *pContained)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pool == nullptr || pContained == nullptr, mR_ArgumentNull);
+
+  *pContained = mPool_IsOccupied_Internal(pool.GetPointer(), handle.index) && pool->pGenerations[handle.index] == handle.generation;
 
   mRETURN_SUCCESS();
 }
@@ -284,31 +273,22 @@ inline mFUNCTION(mPool_ForEach, mPtr<mPool<T>> &pool, const std::function<mResul
 
   mERROR_IF(pool == nullptr || function == nullptr, mR_ArgumentNull);
 
-  size_t index = 0;
-  
-  for (size_t i = 0; i < pool->size; ++i)
+  size_t blockIndex = 0;
+  size_t remainingFlags = 0;
+  size_t index;
+
+  while (mPool_NextOccupied_Internal(pool.GetPointer(), &blockIndex, &remainingFlags, &index))
   {
-    size_t flag = 1;
+    T *pItem = nullptr;
+    mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, &pItem));
+    const mResult result = function(pItem, index);
 
-    for (size_t j = 0; j < mBITS_OF(pool->pIndexes[0]); ++j)
+    if (mFAILED(result))
     {
-      if (pool->pIndexes[i] & flag)
-      {
-        T *pItem = nullptr;
-        mERROR_CHECK(mChunkedArray_PointerAt(pool->data, index, &pItem));
-        const mResult result = function(pItem, index);
-
-        if (mFAILED(result))
-        {
-          if (result == mR_Break)
-            break;
-          else
-            mRETURN_RESULT(result);
-        }
-      }
-
-      flag <<= 1;
-      ++index;
+      if (result == mR_Break)
+        break;
+      else
+        mRETURN_RESULT(result);
     }
   }
 
@@ -316,28 +296,62 @@ inline mFUNCTION(mPool_ForEach, mPtr<mPool<T>> &pool, const std::function<mResul
 }
 
 template <typename T>
-mFUNCTION(mPool_ContainsIndex, const mPtr<mPool<T>> &pool, const size_t index, OUT bool *pContained)
+mFUNCTION(mPool_Compact, mPtr<mPool<T>> &pool, const std::function<mResult (const size_t previousIndex, const size_t newIndex)> &onMoved /* = nullptr */)
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF(pool == nullptr || pContained == nullptr, mR_ArgumentNull);
-  
-  if (index >= pool->size * mBITS_OF(pool->pIndexes[0]))
-  {
-    *pContained = false;
-    mRETURN_SUCCESS(); 
-  }
+  mERROR_IF(pool == nullptr, mR_ArgumentNull);
 
-  const size_t lutIndex = index / mBITS_OF(pool->pIndexes[0]);
-  const size_t lutSubIndex = index - lutIndex * mBITS_OF(pool->pIndexes[0]);
+  // Both cursors only move towards each other, so this touches every block at most once.
+  size_t freeBlockIndex = 0;
+  size_t usedBlockIndex = pool->size;
 
-  if ((pool->pIndexes[lutIndex] & ((size_t)1 << lutSubIndex)) == 0)
+  while (true)
   {
-    *pContained = false;
-    mRETURN_SUCCESS();
+    while (freeBlockIndex < pool->size && pool->pIndexes[freeBlockIndex] == (size_t)-1)
+      ++freeBlockIndex;
+
+    usedBlockIndex = mMin(usedBlockIndex, pool->size); // Releasing indexes might have shrunk the pool.
+
+    while (usedBlockIndex > 0 && pool->pIndexes[usedBlockIndex - 1] == 0)
+      --usedBlockIndex;
+
+    if (freeBlockIndex >= usedBlockIndex)
+      break;
+
+    const size_t freeIndex = freeBlockIndex * mBITS_OF(size_t) + mPool_LowestSetBit_Internal(~pool->pIndexes[freeBlockIndex]);
+    const size_t usedIndex = (usedBlockIndex - 1) * mBITS_OF(size_t) + mPool_HighestSetBit_Internal(pool->pIndexes[usedBlockIndex - 1]);
+
+    if (freeIndex > usedIndex) // Only possible if both are in the same block.
+      break;
+
+    T *pSource = nullptr;
+    mERROR_CHECK(mChunkedArray_PointerAt(pool->data, usedIndex, &pSource));
+
+    T *pTarget = nullptr;
+    mERROR_CHECK(mChunkedArray_PointerAt(pool->data, freeIndex, &pTarget));
+
+    new (pTarget) T(std::move(*pSource));
+    mERROR_CHECK(mMemset(pSource, 1));
+
+    mPool_OccupyIndex_Internal(pool.GetPointer(), freeIndex);
+    mPool_ReleaseIndex_Internal(pool.GetPointer(), usedIndex);
+
+    if (onMoved)
+      mERROR_CHECK(onMoved(usedIndex, freeIndex));
   }
 
-  *pContained = true;
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+mFUNCTION(mPool_ContainsIndex, const mPtr<mPool<T>> &pool, const size_t index, OUT bool *pContained)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pool == nullptr || pContained == nullptr, mR_ArgumentNull);
+
+  *pContained = mPool_IsOccupied_Internal(pool.GetPointer(), index);
 
   mRETURN_SUCCESS();
 }
@@ -349,9 +363,23 @@ mFUNCTION(mPool_Clear, mPtr<mPool<T>> &pool)
 
   mERROR_IF(pool == nullptr, mR_ArgumentNull);
 
+  size_t blockIndex = 0;
+  size_t remainingFlags = 0;
+  size_t index;
+
+  // Invalidate the handles of all removed items.
+  while (mPool_NextOccupied_Internal(pool.GetPointer(), &blockIndex, &remainingFlags, &index))
+    ++pool->pGenerations[index];
+
   for (size_t i = 0; i < pool->size; i++)
     pool->pIndexes[i] = 0;
 
+  for (size_t i = 0; i < (pool->size + mBITS_OF(size_t) - 1) / mBITS_OF(size_t); i++)
+    pool->pAvailableBlocks[i] = 0;
+
+  pool->firstAvailableBlocksWord = 0;
+
+  pool->size = 0;
   pool->count = 0;
 
   mERROR_CHECK(mChunkedArray_Clear(pool->data));
@@ -495,19 +523,172 @@ inline mFUNCTION(mPool_Destroy_Internal, IN mPool<T> *pPool)
   mERROR_CHECK(mChunkedArray_Destroy(&pPool->data));
 
   if (pPool->allocatedSize > 0)
+  {
     mERROR_CHECK(mAllocator_FreePtr(pPool->pAllocator, &pPool->pIndexes));
+    mERROR_CHECK(mAllocator_FreePtr(pPool->pAllocator, &pPool->pAvailableBlocks));
+    mERROR_CHECK(mAllocator_FreePtr(pPool->pAllocator, &pPool->pGenerations));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mPool_Grow_Internal, IN mPool<T> *pPool)
+{
+  mFUNCTION_SETUP();
+
+  if (pPool->allocatedSize == pPool->size)
+  {
+    const size_t newAllocatedSize = pPool->allocatedSize * 2 + 1;
+    const size_t availableBlocksCount = (pPool->allocatedSize + mBITS_OF(size_t) - 1) / mBITS_OF(size_t);
+    const size_t newAvailableBlocksCount = (newAllocatedSize + mBITS_OF(size_t) - 1) / mBITS_OF(size_t);
+
+    mERROR_CHECK(mAllocator_Reallocate(pPool->pAllocator, &pPool->pIndexes, newAllocatedSize));
+    mERROR_CHECK(mAllocator_Reallocate(pPool->pAllocator, &pPool->pAvailableBlocks, newAvailableBlocksCount));
+    mERROR_CHECK(mAllocator_Reallocate(pPool->pAllocator, &pPool->pGenerations, newAllocatedSize * mBITS_OF(size_t)));
+
+    mERROR_CHECK(mZeroMemory(pPool->pAvailableBlocks + availableBlocksCount, newAvailableBlocksCount - availableBlocksCount));
+    mERROR_CHECK(mZeroMemory(pPool->pGenerations + pPool->allocatedSize * mBITS_OF(size_t), (newAllocatedSize - pPool->allocatedSize) * mBITS_OF(size_t)));
+
+    pPool->allocatedSize = newAllocatedSize;
+  }
+
+  // Blocks that have been in use before keep their generations, so old handles stay invalid.
+  pPool->pIndexes[pPool->size] = 0;
+  pPool->pAvailableBlocks[pPool->size / mBITS_OF(size_t)] |= ((size_t)1 << (pPool->size % mBITS_OF(size_t)));
+  pPool->firstAvailableBlocksWord = mMin(pPool->firstAvailableBlocksWord, pPool->size / mBITS_OF(size_t));
+  ++pPool->size;
 
   mRETURN_SUCCESS();
 }
 
+template <typename T>
+inline mFUNCTION(mPool_AcquireIndex_Internal, IN mPool<T> *pPool, OUT size_t *pIndex)
+{
+  mFUNCTION_SETUP();
+
+  const size_t availableBlocksCount = (pPool->size + mBITS_OF(size_t) - 1) / mBITS_OF(size_t);
+  size_t blockIndex = (size_t)-1;
+
+  size_t wordIndex = pPool->firstAvailableBlocksWord;
+
+  for (; wordIndex < availableBlocksCount; wordIndex++)
+  {
+    if (pPool->pAvailableBlocks[wordIndex] != 0)
+    {
+      blockIndex = wordIndex * mBITS_OF(size_t) + mPool_LowestSetBit_Internal(pPool->pAvailableBlocks[wordIndex]);
+      break;
+    }
+  }
+
+  // The words that have just been skipped are all zero, so the next search doesn't have to look at them again.
+  pPool->firstAvailableBlocksWord = wordIndex;
+
+  if (blockIndex == (size_t)-1)
+  {
+    blockIndex = pPool->size;
+    mERROR_CHECK(mPool_Grow_Internal(pPool));
+  }
+
+  *pIndex = blockIndex * mBITS_OF(size_t) + mPool_LowestSetBit_Internal(~pPool->pIndexes[blockIndex]);
+
+  mPool_OccupyIndex_Internal(pPool, *pIndex);
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline void mPool_OccupyIndex_Internal(IN mPool<T> *pPool, const size_t index)
+{
+  const size_t blockIndex = index / mBITS_OF(size_t);
+
+  pPool->pIndexes[blockIndex] |= ((size_t)1 << (index % mBITS_OF(size_t)));
+  ++pPool->count;
+
+  if (pPool->pIndexes[blockIndex] == (size_t)-1)
+    pPool->pAvailableBlocks[blockIndex / mBITS_OF(size_t)] &= ~((size_t)1 << (blockIndex % mBITS_OF(size_t)));
+}
+
+template <typename T>
+inline void mPool_ReleaseIndex_Internal(IN mPool<T> *pPool, const size_t index)
+{
+  const size_t blockIndex = index / mBITS_OF(size_t);
+
+  pPool->pIndexes[blockIndex] &= ~((size_t)1 << (index % mBITS_OF(size_t)));
+  pPool->pAvailableBlocks[blockIndex / mBITS_OF(size_t)] |= ((size_t)1 << (blockIndex % mBITS_OF(size_t)));
+  pPool->firstAvailableBlocksWord = mMin(pPool->firstAvailableBlocksWord, blockIndex / mBITS_OF(size_t));
+  ++pPool->pGenerations[index];
+  --pPool->count;
+
+  // Shrink to the last occupied block. Blocks past `size` aren't considered available.
+  while (pPool->size > 0 && pPool->pIndexes[pPool->size - 1] == 0)
+  {
+    --pPool->size;
+    pPool->pAvailableBlocks[pPool->size / mBITS_OF(size_t)] &= ~((size_t)1 << (pPool->size % mBITS_OF(size_t)));
+  }
+}
+
+template <typename T>
+inline bool mPool_IsOccupied_Internal(IN const mPool<T> *pPool, const size_t index)
+{
+  if (index >= pPool->size * mBITS_OF(size_t))
+    return false;
+
+  return (pPool->pIndexes[index / mBITS_OF(size_t)] & ((size_t)1 << (index % mBITS_OF(size_t)))) != 0;
+}
+
+// `*pBlockIndex` is the next block to look at and `*pRemainingFlags` contains the occupied indexes of the previous block that haven't been visited yet.
+template <typename T>
+inline bool mPool_NextOccupied_Internal(IN const mPool<T> *pPool, IN_OUT size_t *pBlockIndex, IN_OUT size_t *pRemainingFlags, OUT size_t *pIndex)
+{
+  // Items might have been removed since the flags were retrieved.
+  if (*pRemainingFlags != 0)
+    *pRemainingFlags &= (*pBlockIndex - 1 < pPool->size) ? pPool->pIndexes[*pBlockIndex - 1] : 0;
+
+  while (*pRemainingFlags == 0) // Skip empty blocks.
+  {
+    if (*pBlockIndex >= pPool->size)
+      return false;
+
+    *pRemainingFlags = pPool->pIndexes[*pBlockIndex];
+    ++*pBlockIndex;
+  }
+
+  *pIndex = (*pBlockIndex - 1) * mBITS_OF(size_t) + mPool_LowestSetBit_Internal(*pRemainingFlags);
+  *pRemainingFlags &= *pRemainingFlags - 1;
+
+  return true;
+}
+
+inline size_t mPool_LowestSetBit_Internal(const size_t value)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return index;
+#else
+  return (size_t)__builtin_ctzll(value);
+#endif
+}
+
+inline size_t mPool_HighestSetBit_Internal(const size_t value)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return index;
+#else
+  return (size_t)(63 - __builtin_clzll(value));
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 template<typename T>
 inline mPoolIterator<T>::mPoolIterator(mPool<T> *pPool) :
-  index(0),
-  globalIndex(0),
   blockIndex(0),
-  flag(1),
+  remainingFlags(0),
+  globalIndex(0),
   pData(nullptr),
   pPool(pPool)
 { }
@@ -527,36 +708,22 @@ inline const typename mPoolIterator<T>::IteratorValue mPoolIterator<T>::operator
 template<typename T>
 inline bool mPoolIterator<T>::operator != (const typename mPoolIterator<T> &)
 {
-  for (blockIndex; blockIndex < pPool->size; ++blockIndex)
-  {
-    for (; index < mBITS_OF(pPool->pIndexes[0]); ++index)
-    {
-      if (pPool->pIndexes[blockIndex] & flag)
-      {
-        const mResult result = mChunkedArray_PointerAt(pPool->data, globalIndex, &pData);
-
-        if (mFAILED(result))
-        {
-          mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
-          return false;
-        }
-
-        flag <<= 1;
-        ++globalIndex;
-        ++index;
+  size_t index;
 
-        return true;
-      }
+  if (!mPool_NextOccupied_Internal(pPool, &blockIndex, &remainingFlags, &index))
+    return false;
 
-      flag <<= 1;
-      ++globalIndex;
-    }
+  const mResult result = mChunkedArray_PointerAt(pPool->data, index, &pData);
 
-    index = 0;
-    flag = 1;
+  if (mFAILED(result))
+  {
+    mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
+    return false;
   }
 
-  return false;
+  globalIndex = index + 1;
+
+  return true;
 }
 
 template<typename T>
@@ -587,10 +754,9 @@ inline const T& mPoolIterator<T>::IteratorValue::operator*() const
 
 template<typename T>
 inline mConstPoolIterator<T>::mConstPoolIterator(const mPool<T> *pPool) :
-  index(0),
-  globalIndex(0),
   blockIndex(0),
-  flag(1),
+  remainingFlags(0),
+  globalIndex(0),
   pData(nullptr),
   pPool(pPool)
 { }
@@ -604,36 +770,22 @@ inline const typename mConstPoolIterator<T>::IteratorValue mConstPoolIterator<T>
 template<typename T>
 inline bool mConstPoolIterator<T>::operator != (const typename mConstPoolIterator<T> &)
 {
-  for (blockIndex; blockIndex < pPool->size; ++blockIndex)
-  {
-    for (; index < mBITS_OF(pPool->pIndexes[0]); ++index)
-    {
-      if (pPool->pIndexes[blockIndex] & flag)
-      {
-        const mResult result = mChunkedArray_PointerAt(pPool->data, globalIndex, &pData);
-
-        if (mFAILED(result))
-        {
-          mFAIL_DEBUG(mFormat("mChunkedArray_ConstPointerAt failed in mConstPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
-          return false;
-        }
-
-        flag <<= 1;
-        ++globalIndex;
-        ++index;
+  size_t index;
 
-        return true;
-      }
+  if (!mPool_NextOccupied_Internal(pPool, &blockIndex, &remainingFlags, &index))
+    return false;
 
-      flag <<= 1;
-      ++globalIndex;
-    }
+  const mResult result = mChunkedArray_PointerAt(pPool->data, index, &pData);
 
-    index = 0;
-    flag = 1;
+  if (mFAILED(result))
+  {
+    mFAIL_DEBUG(mFormat("mChunkedArray_ConstPointerAt failed in mConstPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
+    return false;
   }
 
-  return false;
+  globalIndex = index + 1;
+
+  return true;
 }
 
 template<typename T>
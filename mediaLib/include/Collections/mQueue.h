@@ -2,6 +2,7 @@
 #define mQueue_h__
 
 #include "mediaLib.h"
+#include "mSort.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -198,9 +199,18 @@ mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue, const std::function<mCompariso
 template <typename T, typename TLessFunc = std::less<T>, typename TGreaterFunc = std::greater<T>>
 mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue);
 
+// Uses a stable radix sort if `U` is an integer or floating point type.
 template <typename T, typename U>
 mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue, const std::function<U (const T &v)> &valueFunc);
 
+// `lessFunc(a, b)` returns `true` if `a` should be ordered before `b`. Unlike the `std::function` overloads the comparison can be inlined.
+template <typename T, typename TLessFunc = std::less<T>>
+mFUNCTION(mQueue_OrderByLess, mPtr<mQueue<T>> &queue, TLessFunc lessFunc = TLessFunc());
+
+// Sorts large queues on the worker threads of `threadPool`. See `mSort_Parallel`.
+template <typename T, typename TLessFunc = std::less<T>>
+mFUNCTION(mQueue_OrderByParallel, mPtr<mQueue<T>> &queue, mPtr<mThreadPool> &threadPool, TLessFunc lessFunc = TLessFunc());
+
 template <typename T>
 mFUNCTION(mQueue_Select, const mPtr<mQueue<T>> &source, OUT mPtr<mQueue<T>> *pTarget, IN mAllocator *pAllocator, const std::function<bool(const T &a)> &selectFunc);
 
@@ -263,6 +273,16 @@ mFUNCTION(mQueue_Grow_Internal, mPtr<mQueue<T>> &queue);
 template <typename T>
 mFUNCTION(mQueue_PopAt_Internal, mPtr<mQueue<T>> &queue, const size_t index, OUT T *pItem);
 
+// Moves all items into a single contiguous range starting at `queue->pData + queue->startIndex`.
+template <typename T>
+mFUNCTION(mQueue_Linearize_Internal, mPtr<mQueue<T>> &queue);
+
+template <typename T, typename U, typename std::enable_if<mSort_IsRadixSortable<U>::value>::type* = nullptr>
+mFUNCTION(mQueue_OrderByValue_Internal, mPtr<mQueue<T>> &queue, const std::function<U(const T &v)> &valueFunc);
+
+template <typename T, typename U, typename std::enable_if<!mSort_IsRadixSortable<U>::value>::type* = nullptr>
+mFUNCTION(mQueue_OrderByValue_Internal, mPtr<mQueue<T>> &queue, const std::function<U(const T &v)> &valueFunc);
+
 //////////////////////////////////////////////////////////////////////////
 
 template<typename T>
@@ -728,82 +748,9 @@ inline mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue, const std::function<mCo
 
   mERROR_IF(queue == nullptr || orderByFunc == nullptr, mR_ArgumentNull);
 
-  struct
-  {
-    mQueue<T> *pQueue;
-
-    void DualPivotQuickSort_Partition(int64_t low, int64_t high, int64_t *pRightPivot, int64_t *pLeftPivot, const std::function<mComparisonResult(const T &a, const T &b)> &orderByFunc)
-    {
-      if (mCR_Greater == orderByFunc((*pQueue)[low], (*pQueue)[high]))
-        std::swap((*pQueue)[low], (*pQueue)[high]);
-
-      int64_t j = low + 1;
-      int64_t g = high - 1;
-      int64_t k = low + 1;
-
-      T *pQ = &(*pQueue)[low];
-      T *pP = &(*pQueue)[high];
-
-      while (k <= g)
-      {
-        if (mCR_Less == orderByFunc((*pQueue)[k], *pQ))
-        {
-          std::swap((*pQueue)[k], (*pQueue)[j]);
-          j++;
-        }
-
-        else if (mCR_Less != orderByFunc((*pQueue)[k], *pP))
-        {
-          while (mCR_Greater == orderByFunc((*pQueue)[g], *pP) && k < g)
-            g--;
+  mERROR_CHECK(mQueue_Linearize_Internal(queue));
 
-          std::swap((*pQueue)[k], (*pQueue)[g]);
-          g--;
-
-          if (mCR_Less == orderByFunc((*pQueue)[k], *pQ))
-          {
-            std::swap((*pQueue)[k], (*pQueue)[j]);
-            j++;
-          }
-        }
-
-        k++;
-      }
-
-      j--;
-      g++;
-
-      std::swap((*pQueue)[low], (*pQueue)[j]);
-      std::swap((*pQueue)[high], (*pQueue)[g]);
-
-      *pLeftPivot = j;
-      *pRightPivot = g;
-    }
-
-    void QuickSort(const int64_t start, const int64_t end, const std::function<mComparisonResult(const T &a, const T &b)> &orderByFunc)
-    {
-      if (start < end)
-      {
-        int64_t leftPivot, rightPivot;
-
-        DualPivotQuickSort_Partition(start, end, &rightPivot, &leftPivot, orderByFunc);
-
-        QuickSort(start, leftPivot - 1, orderByFunc);
-        QuickSort(leftPivot + 1, rightPivot - 1, orderByFunc);
-        QuickSort(rightPivot + 1, end, orderByFunc);
-      }
-    }
-
-    void OrderBy(const std::function<mComparisonResult(const T &a, const T &b)> &orderByFunc)
-    {
-      QuickSort(0, (int64_t)pQueue->count - 1, orderByFunc);
-    }
-
-  } _internal;
-  
-  _internal.pQueue = queue.GetPointer();
-
-  _internal.OrderBy(orderByFunc);
+  mSort(queue->pData + queue->startIndex, queue->count, [&](const T &a, const T &b) { return mCR_Less == orderByFunc(a, b); });
 
   mRETURN_SUCCESS();
 }
@@ -815,85 +762,9 @@ inline mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue)
 
   mERROR_IF(queue == nullptr, mR_ArgumentNull);
 
-  struct
-  {
-    mQueue<T> *pQueue;
-
-    void DualPivotQuickSort_Partition(const int64_t low, const int64_t high, int64_t *pRightPivot, int64_t *pLeftPivot)
-    {
-      TLessFunc _less = TLessFunc();
-      TGreaterFunc _greater = TGreaterFunc();
-
-      if (_greater((*pQueue)[low], (*pQueue)[high]))
-        std::swap((*pQueue)[low], (*pQueue)[high]);
-
-      int64_t j = low + 1;
-      int64_t g = high - 1;
-      int64_t k = low + 1;
-
-      T *pP = &(*pQueue)[low];
-      T *pQ = &(*pQueue)[high];
-
-      while (k <= g)
-      {
-        if (_less((*pQueue)[k], *pP))
-        {
-          std::swap((*pQueue)[k], (*pQueue)[j]);
-          j++;
-        }
-
-        else if (!_less((*pQueue)[k], *pQ))
-        {
-          while (_greater((*pQueue)[g], *pQ) && k < g)
-            g--;
-
-          std::swap((*pQueue)[k], (*pQueue)[g]);
-          g--;
-
-          if (_less((*pQueue)[k], *pP))
-          {
-            std::swap((*pQueue)[k], (*pQueue)[j]);
-            j++;
-          }
-        }
-
-        k++;
-      }
+  mERROR_CHECK(mQueue_Linearize_Internal(queue));
 
-      j--;
-      g++;
-
-      std::swap((*pQueue)[low], (*pQueue)[j]);
-      std::swap((*pQueue)[high], (*pQueue)[g]);
-
-      *pLeftPivot = j;
-      *pRightPivot = g;
-    }
-
-    void QuickSort(const int64_t start, const int64_t end)
-    {
-      if (start < end)
-      {
-        int64_t leftPivot, rightPivot;
-
-        DualPivotQuickSort_Partition(start, end, &rightPivot, &leftPivot);
-
-        QuickSort(start, leftPivot - 1);
-        QuickSort(leftPivot + 1, rightPivot - 1);
-        QuickSort(rightPivot + 1, end);
-      }
-    }
-
-    void OrderBy()
-    {
-      QuickSort(0, (int64_t)pQueue->count - 1);
-    }
-
-  } _internal;
-
-  _internal.pQueue = queue.GetPointer();
-
-  _internal.OrderBy();
+  mSort(queue->pData + queue->startIndex, queue->count, TLessFunc());
 
   mRETURN_SUCCESS();
 }
@@ -903,84 +774,39 @@ mFUNCTION(mQueue_OrderBy, mPtr<mQueue<T>> &queue, const std::function<U(const T
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF(queue == nullptr, mR_ArgumentNull);
-
-  struct
-  {
-    mQueue<T> *pQueue;
-
-    void DualPivotQuickSort_Partition(const int64_t low, const int64_t high, int64_t *pRightPivot, int64_t *pLeftPivot, const std::function<U(const T &v)> &valueFunc)
-    {
-      if (valueFunc((*pQueue)[low]) > valueFunc((*pQueue)[high]))
-        std::swap((*pQueue)[low], (*pQueue)[high]);
-
-      int64_t j = low + 1;
-      int64_t g = high - 1;
-      int64_t k = low + 1;
-
-      T *pP = &(*pQueue)[low];
-      T *pQ = &(*pQueue)[high];
-
-      while (k <= g)
-      {
-        if (valueFunc((*pQueue)[k]) < valueFunc(*pP))
-        {
-          std::swap((*pQueue)[k], (*pQueue)[j]);
-          j++;
-        }
-
-        else if (!(valueFunc((*pQueue)[k]) < valueFunc(*pQ)))
-        {
-          while (valueFunc((*pQueue)[g]) > valueFunc(*pQ) && k < g)
-            g--;
+  mERROR_IF(queue == nullptr || valueFunc == nullptr, mR_ArgumentNull);
 
-          std::swap((*pQueue)[k], (*pQueue)[g]);
-          g--;
+  mERROR_CHECK(mQueue_Linearize_Internal(queue));
 
-          if (valueFunc((*pQueue)[k]) < valueFunc(*pP))
-          {
-            std::swap((*pQueue)[k], (*pQueue)[j]);
-            j++;
-          }
-        }
+  mERROR_CHECK(mQueue_OrderByValue_Internal(queue, valueFunc));
 
-        k++;
-      }
-
-      j--;
-      g++;
+  mRETURN_SUCCESS();
+}
 
-      std::swap((*pQueue)[low], (*pQueue)[j]);
-      std::swap((*pQueue)[high], (*pQueue)[g]);
+template <typename T, typename TLessFunc>
+inline mFUNCTION(mQueue_OrderByLess, mPtr<mQueue<T>> &queue, TLessFunc lessFunc)
+{
+  mFUNCTION_SETUP();
 
-      *pLeftPivot = j;
-      *pRightPivot = g;
-    }
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
 
-    void QuickSort(const int64_t start, const int64_t end, const std::function<U(const T &v)> &valueFunc)
-    {
-      if (start < end)
-      {
-        int64_t leftPivot, rightPivot;
+  mERROR_CHECK(mQueue_Linearize_Internal(queue));
 
-        DualPivotQuickSort_Partition(start, end, &rightPivot, &leftPivot, valueFunc);
+  mSort(queue->pData + queue->startIndex, queue->count, lessFunc);
 
-        QuickSort(start, leftPivot - 1, valueFunc);
-        QuickSort(leftPivot + 1, rightPivot - 1, valueFunc);
-        QuickSort(rightPivot + 1, end, valueFunc);
-      }
-    }
+  mRETURN_SUCCESS();
+}
 
-    void OrderBy(const std::function<U(const T &v)> &valueFunc)
-    {
-      QuickSort(0, (int64_t)pQueue->count - 1, valueFunc);
-    }
+template <typename T, typename TLessFunc>
+inline mFUNCTION(mQueue_OrderByParallel, mPtr<mQueue<T>> &queue, mPtr<mThreadPool> &threadPool, TLessFunc lessFunc)
+{
+  mFUNCTION_SETUP();
 
-  } _internal;
+  mERROR_IF(queue == nullptr || threadPool == nullptr, mR_ArgumentNull);
 
-  _internal.pQueue = queue.GetPointer();
+  mERROR_CHECK(mQueue_Linearize_Internal(queue));
 
-  _internal.OrderBy(valueFunc);
+  mERROR_CHECK(mSort_Parallel(threadPool, queue->pData + queue->startIndex, queue->count, queue->pAllocator, lessFunc));
 
   mRETURN_SUCCESS();
 }
@@ -1412,6 +1238,49 @@ inline mFUNCTION(mQueue_PopAt_Internal, mPtr<mQueue<T>> &queue, const size_t ind
   mRETURN_SUCCESS();
 }
 
+template <typename T>
+inline mFUNCTION(mQueue_Linearize_Internal, mPtr<mQueue<T>> &queue)
+{
+  mFUNCTION_SETUP();
+
+  if (queue->startIndex + queue->count <= queue->size)
+    mRETURN_SUCCESS();
+
+  T *pNewData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, queue->pAllocator, &pNewData);
+  mERROR_CHECK(mAllocator_Allocate(queue->pAllocator, &pNewData, queue->size));
+
+  const size_t firstCount = queue->size - queue->startIndex;
+
+  mERROR_CHECK(mMove(pNewData, &queue->pData[queue->startIndex], firstCount));
+  mERROR_CHECK(mMove(&pNewData[firstCount], queue->pData, queue->count - firstCount));
+
+  std::swap(queue->pData, pNewData);
+  queue->startIndex = 0;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T, typename U, typename std::enable_if<mSort_IsRadixSortable<U>::value>::type* /* = nullptr */>
+inline mFUNCTION(mQueue_OrderByValue_Internal, mPtr<mQueue<T>> &queue, const std::function<U(const T &v)> &valueFunc)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mSort_Radix(queue->pData + queue->startIndex, queue->count, queue->pAllocator, valueFunc));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T, typename U, typename std::enable_if<!mSort_IsRadixSortable<U>::value>::type* /* = nullptr */>
+inline mFUNCTION(mQueue_OrderByValue_Internal, mPtr<mQueue<T>> &queue, const std::function<U(const T &v)> &valueFunc)
+{
+  mFUNCTION_SETUP();
+
+  mSort(queue->pData + queue->startIndex, queue->count, [&](const T &a, const T &b) { return valueFunc(a) < valueFunc(b); });
+
+  mRETURN_SUCCESS();
+}
+
 template <typename T, typename equals_func /* = mEquals<T> */, typename element_valid_func /* = mTrue */>
 bool mQueue_Equals(const mPtr<mQueue<T>> &a, const mPtr<mQueue<T>> &b)
 {
@@ -41,7 +41,7 @@ struct mRefPoolIterator
   typename mRefPoolIterator<T>& operator++();
 
 private:
-  size_t index, blockIndex, flag, globalIndex;
+  size_t blockIndex, remainingFlags, globalIndex;
   mRefPool_SharedPointerContainer_Internal<T> *pData;
   mPool<mRefPool_SharedPointerContainer_Internal<T>> *pPool;
 };
@@ -66,7 +66,7 @@ struct mRefPoolConstIterator
   typename mRefPoolConstIterator<T>& operator++();
 
 private:
-  size_t index, blockIndex, flag, globalIndex;
+  size_t blockIndex, remainingFlags, globalIndex;
   const mRefPool_SharedPointerContainer_Internal<T> *pData;
   const mPool<mRefPool_SharedPointerContainer_Internal<T>> *pPool;
 };
@@ -129,6 +129,10 @@ mFUNCTION(mRefPool_KeepIfTrue, mPtr<mRefPool<T>> &refPool, const std::function<m
 template <typename T>
 mFUNCTION(mRefPool_PeekAt, mPtr<mRefPool<T>> &refPool, const size_t index, OUT mPtr<T> *pIndex);
 
+// Retrieves the item without acquiring a reference. The pointer is only valid for as long as a reference to the item is held somewhere else (e.g. by the pool itself if `keepEntriesForever` is true).
+template <typename T>
+mFUNCTION(mRefPool_PointerAt, mPtr<mRefPool<T>> &refPool, const size_t index, OUT T **ppItem);
+
 template <typename T>
 mFUNCTION(mRefPool_GetCount, const mPtr<mRefPool<T>> &refPool, OUT size_t *pCount);
 
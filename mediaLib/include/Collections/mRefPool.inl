@@ -256,10 +256,28 @@ inline mFUNCTION(mRefPool_PeekAt, mPtr<mRefPool<T>> &refPool, const size_t index
   mERROR_CHECK(mRecursiveMutex_Lock(refPool->pMutex));
   mDEFER_CALL(refPool->pMutex, mRecursiveMutex_Unlock);
 
-  mRefPool_SharedPointerContainer_Internal<T> refPoolPointer;
-  mERROR_CHECK(mPool_PeekAt(refPool->ptrs, index, &refPoolPointer));
+  mRefPool_SharedPointerContainer_Internal<T> *pRefPoolPointer = nullptr;
+  mERROR_CHECK(mPool_PointerAt(refPool->ptrs, index, &pRefPoolPointer));
 
-  *pIndex = refPoolPointer.ptr;
+  *pIndex = pRefPoolPointer->ptr;
+
+  mRETURN_SUCCESS();
+}
+
+template<typename T>
+inline mFUNCTION(mRefPool_PointerAt, mPtr<mRefPool<T>> &refPool, const size_t index, OUT T **ppItem)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(refPool == nullptr || ppItem == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mRecursiveMutex_Lock(refPool->pMutex));
+  mDEFER_CALL(refPool->pMutex, mRecursiveMutex_Unlock);
+
+  mRefPool_SharedPointerContainer_Internal<T> *pRefPoolPointer = nullptr;
+  mERROR_CHECK(mPool_PointerAt(refPool->ptrs, index, &pRefPoolPointer));
+
+  *ppItem = pRefPoolPointer->ptr.GetPointer();
 
   mRETURN_SUCCESS();
 }
@@ -476,10 +494,9 @@ inline mFUNCTION(mRefPool_Destroy_Internal, IN mRefPool<T> *pRefPool)
 
 template<typename T>
 inline mRefPoolIterator<T>::mRefPoolIterator(typename mPool<mRefPool_SharedPointerContainer_Internal<T>> *pPool) :
-  index(0),
-  globalIndex(0),
   blockIndex(0),
-  flag(1),
+  remainingFlags(0),
+  globalIndex(0),
   pData(nullptr),
   pPool(pPool)
 { }
@@ -499,36 +516,22 @@ inline const typename mRefPoolIterator<T>::IteratorValue mRefPoolIterator<T>::op
 template<typename T>
 inline bool mRefPoolIterator<T>::operator != (const typename mRefPoolIterator<T> &)
 {
-  for (blockIndex; blockIndex < pPool->size; ++blockIndex)
-  {
-    for (; index < mBITS_OF(pPool->pIndexes[0]); ++index)
-    {
-      if (pPool->pIndexes[blockIndex] & flag)
-      {
-        const mResult result = mChunkedArray_PointerAt(pPool->data, globalIndex, &pData);
-
-        if (mFAILED(result))
-        {
-          mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mRefPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
-          return false;
-        }
-
-        flag <<= 1;
-        ++globalIndex;
-        ++index;
+  size_t index;
 
-        return true;
-      }
+  if (!mPool_NextOccupied_Internal(pPool, &blockIndex, &remainingFlags, &index))
+    return false;
 
-      flag <<= 1;
-      ++globalIndex;
-    }
+  const mResult result = mChunkedArray_PointerAt(pPool->data, index, &pData);
 
-    index = 0;
-    flag = 1;
+  if (mFAILED(result))
+  {
+    mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mRefPoolIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
+    return false;
   }
 
-  return false;
+  globalIndex = index + 1;
+
+  return true;
 }
 
 template<typename T>
@@ -559,10 +562,9 @@ inline const T& mRefPoolIterator<T>::IteratorValue::operator*() const
 
 template<typename T>
 inline mRefPoolConstIterator<T>::mRefPoolConstIterator(const typename mPool<mRefPool_SharedPointerContainer_Internal<T>> *pPool) :
-  index(0),
-  globalIndex(0),
   blockIndex(0),
-  flag(1),
+  remainingFlags(0),
+  globalIndex(0),
   pData(nullptr),
   pPool(pPool)
 { }
@@ -576,36 +578,22 @@ inline const typename mRefPoolConstIterator<T>::IteratorValue mRefPoolConstItera
 template<typename T>
 inline bool mRefPoolConstIterator<T>::operator != (const typename mRefPoolConstIterator<T> &)
 {
-  for (blockIndex; blockIndex < pPool->size; ++blockIndex)
-  {
-    for (; index < mBITS_OF(pPool->pIndexes[0]); ++index)
-    {
-      if (pPool->pIndexes[blockIndex] & flag)
-      {
-        const mResult result = mChunkedArray_PointerAt(pPool->data, globalIndex, &pData);
-
-        if (mFAILED(result))
-        {
-          mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mRefPoolConstIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
-          return false;
-        }
-
-        flag <<= 1;
-        ++globalIndex;
-        ++index;
+  size_t index;
 
-        return true;
-      }
+  if (!mPool_NextOccupied_Internal(pPool, &blockIndex, &remainingFlags, &index))
+    return false;
 
-      flag <<= 1;
-      ++globalIndex;
-    }
+  const mResult result = mChunkedArray_PointerAt(pPool->data, index, &pData);
 
-    index = 0;
-    flag = 1;
+  if (mFAILED(result))
+  {
+    mFAIL_DEBUG(mFormat("mChunkedArray_PointerAt failed in mRefPoolConstIterator::operator != with errorcode 0x", mFUInt<mFHex>(result), "."));
+    return false;
   }
 
-  return false;
+  globalIndex = index + 1;
+
+  return true;
 }
 
 template<typename T>
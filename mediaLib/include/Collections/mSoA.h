@@ -0,0 +1,176 @@
+#ifndef mSoA_h__
+#define mSoA_h__
+
+#include "mediaLib.h"
+
+#include <tuple>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "JmqMm31/mQUQTXaHGYTa9SNd8Qa5wkU7bRT/6XJPrbu5HveNVNH+QRXLh1AYJ5vUN5DWCmjtr5jfZ7UU"
+#endif
+
+// `mSoA` stores every field in a separate array (structure of arrays), so loops that only touch some of the fields don't drag the others through the cache and can be vectorized trivially.
+// All field arrays live in a single allocation and every one of them starts at a `mSoA_FieldAlignment` byte boundary.
+
+constexpr size_t mSoA_FieldAlignment = 32;
+
+//////////////////////////////////////////////////////////////////////////
+
+// Keeps the field types of values passed to `mSoA` functions from being deduced, so they're only deduced from the `mSoA` itself and values are converted to the field types.
+template <typename T>
+struct mSoA_Value_Internal
+{
+  typedef T type;
+};
+
+template <typename ...Fields>
+struct mSoAIterator
+{
+  std::tuple<Fields *...> fields;
+  size_t index;
+
+  mSoAIterator(const std::tuple<Fields *...> &fields, const size_t index);
+  std::tuple<Fields &...> operator *() const;
+  bool operator != (const size_t endIndex) const;
+  void operator++();
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename ...Fields>
+struct mSoA
+{
+  static_assert(sizeof...(Fields) > 0, "mSoA requires at least one field.");
+
+  template <size_t Index>
+  using FieldType = typename std::tuple_element<Index, std::tuple<Fields...>>::type;
+
+  mAllocator *pAllocator = nullptr;
+  uint8_t *pAllocation = nullptr;
+  std::tuple<Fields *...> fields;
+  size_t count = 0, capacity = 0;
+
+  // Returns the array of the field at `Index`. Valid until the next operation that changes the capacity.
+  template <size_t Index>
+  inline FieldType<Index> * Field()
+  {
+    return std::get<Index>(fields);
+  }
+
+  template <size_t Index>
+  inline const FieldType<Index> * Field() const
+  {
+    return std::get<Index>(fields);
+  }
+
+  // Iterates all fields at once. Dereferencing yields a `std::tuple` of references, so structured bindings can be used: `for (auto [position, velocity] : soa)`.
+  mSoAIterator<Fields...> begin()
+  {
+    return mSoAIterator<Fields...>(fields, 0);
+  }
+
+  size_t end() const
+  {
+    return count;
+  }
+
+  mSoAIterator<const Fields...> begin() const
+  {
+    return mSoAIterator<const Fields...>(fields, 0);
+  }
+
+  struct mSoAIteratorWrapper
+  {
+    mSoA<Fields...> *pSoA;
+
+    mSoAIterator<Fields...> begin() { return mSoAIterator<Fields...>(pSoA->fields, 0); }
+    size_t end() { return pSoA->count; }
+
+  };
+
+  mSoAIteratorWrapper Iterate() { return { this }; };
+
+  struct mSoAConstIteratorWrapper
+  {
+    const mSoA<Fields...> *pSoA;
+
+    mSoAIterator<const Fields...> begin() const { return mSoAIterator<const Fields...>(pSoA->fields, 0); }
+    size_t end() const { return pSoA->count; }
+
+  };
+
+  mSoAConstIteratorWrapper Iterate() const { return { this }; };
+
+public:
+  mSoA() = default;
+
+  // The fields live in `pAllocation`, so copies would free it twice.
+  mSoA(const mSoA<Fields...> &) = delete;
+  mSoA<Fields...> & operator = (const mSoA<Fields...> &) = delete;
+
+  mSoA(mSoA<Fields...> &&move);
+  mSoA<Fields...> & operator = (mSoA<Fields...> &&move);
+
+  ~mSoA();
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Create, OUT mSoA<Fields...> *pSoA, IN OPTIONAL mAllocator *pAllocator);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Create, OUT mPtr<mSoA<Fields...>> *pSoA, IN OPTIONAL mAllocator *pAllocator);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Destroy, IN_OUT mPtr<mSoA<Fields...>> *pSoA);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Destroy, IN_OUT mSoA<Fields...> *pSoA);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Clear, mSoA<Fields...> &soa);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_GetCount, const mSoA<Fields...> &soa, OUT size_t *pCount);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Reserve, mSoA<Fields...> &soa, const size_t count);
+
+// Shrinks `soa` to `count` elements or appends copies of `values` until it contains `count` elements.
+template <typename ...Fields>
+mFUNCTION(mSoA_ResizeWith, mSoA<Fields...> &soa, const size_t count, const typename mSoA_Value_Internal<Fields>::type &...values);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_PushBack, mSoA<Fields...> &soa, const typename mSoA_Value_Internal<Fields>::type &...values);
+
+// Retrieves copies of the fields at `index`. Pass `nullptr` for fields that aren't needed.
+template <typename ...Fields>
+mFUNCTION(mSoA_PeekAt, const mSoA<Fields...> &soa, const size_t index, OUT OPTIONAL typename mSoA_Value_Internal<Fields>::type *...pValues);
+
+// Removes the element at `index` and moves all following elements down by one, preserving their order.
+template <typename ...Fields>
+mFUNCTION(mSoA_RemoveAt, mSoA<Fields...> &soa, const size_t index);
+
+// Removes the element at `index` by moving the last element into its place. Doesn't preserve the order, but only touches two elements per field.
+template <typename ...Fields>
+mFUNCTION(mSoA_SwapRemoveAt, mSoA<Fields...> &soa, const size_t index);
+
+template <typename ...Fields>
+mFUNCTION(mSoA_Swap, mSoA<Fields...> &soa, const size_t indexA, const size_t indexB);
+
+// Retrieves the array of the field at `Index`. Valid until the next operation that changes the capacity.
+template <size_t Index, typename ...Fields>
+mFUNCTION(mSoA_GetField, mSoA<Fields...> &soa, OUT typename mSoA<Fields...>::template FieldType<Index> **ppField);
+
+template <size_t Index, typename ...Fields>
+mFUNCTION(mSoA_GetField, const mSoA<Fields...> &soa, OUT const typename mSoA<Fields...>::template FieldType<Index> **ppField);
+
+//////////////////////////////////////////////////////////////////////////
+
+#include "mSoA.inl"
+
+#endif // mSoA_h__
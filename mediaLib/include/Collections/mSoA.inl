@@ -0,0 +1,442 @@
+#include "mSoA.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename TFunc, size_t ...Indices>
+inline void mSoA_ForEachFieldIndex_Internal(TFunc &&func, std::index_sequence<Indices...>)
+{
+  // Expands to one call per field in order, without requiring C++17 fold expressions.
+  const int expansion[] = { 0, (func(std::integral_constant<size_t, Indices>()), 0)... };
+  mUnused(expansion);
+}
+
+template <bool ...Values>
+struct mSoA_BoolPack_Internal { };
+
+// `true` if all `Values` are `true`.
+template <bool ...Values>
+using mSoA_AllOf_Internal = std::is_same<mSoA_BoolPack_Internal<true, Values...>, mSoA_BoolPack_Internal<Values..., true>>;
+
+template <typename ...Fields, typename TFunc>
+inline void mSoA_ForEachField_Internal(TFunc &&func)
+{
+  mSoA_ForEachFieldIndex_Internal(std::forward<TFunc>(func), std::index_sequence_for<Fields...>());
+}
+
+inline constexpr size_t mSoA_AlignSize_Internal(const size_t size)
+{
+  return (size + mSoA_FieldAlignment - 1) & ~(mSoA_FieldAlignment - 1);
+}
+
+template <typename ...Fields>
+inline size_t mSoA_GetAllocationSize_Internal(const size_t capacity)
+{
+  const size_t fieldSizes[] = { sizeof(Fields)... };
+
+  // Every field array is padded to the alignment, so the following one starts aligned as well. The extra alignment is used to align the start of the allocation.
+  size_t size = mSoA_FieldAlignment;
+
+  for (const size_t fieldSize : fieldSizes)
+    size += mSoA_AlignSize_Internal(fieldSize * capacity);
+
+  return size;
+}
+
+template <typename ...Fields>
+inline std::tuple<Fields *...> mSoA_GetFields_Internal(uint8_t *pAllocation, const size_t capacity)
+{
+  std::tuple<Fields *...> fields;
+
+  uint8_t *pField = reinterpret_cast<uint8_t *>(mSoA_AlignSize_Internal(reinterpret_cast<size_t>(pAllocation)));
+
+  mSoA_ForEachField_Internal<Fields...>([&](auto index)
+  {
+    typedef typename std::tuple_element<decltype(index)::value, std::tuple<Fields...>>::type T;
+
+    std::get<decltype(index)::value>(fields) = reinterpret_cast<T *>(pField);
+    pField += mSoA_AlignSize_Internal(sizeof(T) * capacity);
+  });
+
+  return fields;
+}
+
+template <typename ...Fields>
+inline void mSoA_DestructRange_Internal(mSoA<Fields...> &soa, const size_t startIndex, const size_t endIndex)
+{
+  mSoA_ForEachField_Internal<Fields...>([&](auto index)
+  {
+    auto *pField = std::get<decltype(index)::value>(soa.fields);
+
+    for (size_t i = startIndex; i < endIndex; i++)
+      mDestruct(pField + i);
+  });
+}
+
+template <typename ...Fields>
+inline void mSoA_Destroy_Internal(mSoA<Fields...> *pSoA)
+{
+  if (pSoA == nullptr)
+    return;
+
+  mSoA_Clear(*pSoA);
+
+  mAllocator_FreePtr(pSoA->pAllocator, &pSoA->pAllocation);
+  pSoA->fields = std::tuple<Fields *...>();
+  pSoA->capacity = 0;
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Grow_Internal, mSoA<Fields...> &soa)
+{
+  mFUNCTION_SETUP();
+
+  // Start with a few elements, so the padding of the field arrays isn't larger than the fields themselves.
+  mERROR_CHECK(mSoA_Reserve(soa, soa.capacity == 0 ? 16 : soa.capacity * 2));
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename ...Fields>
+inline mSoA<Fields...>::mSoA(mSoA<Fields...> &&move) :
+  pAllocator(move.pAllocator),
+  pAllocation(move.pAllocation),
+  fields(move.fields),
+  count(move.count),
+  capacity(move.capacity)
+{
+  move.pAllocation = nullptr;
+  move.fields = std::tuple<Fields *...>();
+  move.count = 0;
+  move.capacity = 0;
+}
+
+template <typename ...Fields>
+inline mSoA<Fields...> & mSoA<Fields...>::operator = (mSoA<Fields...> &&move)
+{
+  if (this == &move)
+    return *this;
+
+  mSoA_Destroy_Internal(this);
+
+  pAllocator = move.pAllocator;
+  pAllocation = move.pAllocation;
+  fields = move.fields;
+  count = move.count;
+  capacity = move.capacity;
+
+  move.pAllocation = nullptr;
+  move.fields = std::tuple<Fields *...>();
+  move.count = 0;
+  move.capacity = 0;
+
+  return *this;
+}
+
+template <typename ...Fields>
+inline mSoA<Fields...>::~mSoA()
+{
+  mSoA_Destroy_Internal(this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename ...Fields>
+inline mSoAIterator<Fields...>::mSoAIterator(const std::tuple<Fields *...> &fields, const size_t index) :
+  fields(fields),
+  index(index)
+{ }
+
+template <typename ...Fields, size_t ...Indices>
+inline std::tuple<Fields &...> mSoAIterator_Dereference_Internal(const std::tuple<Fields *...> &fields, const size_t index, std::index_sequence<Indices...>)
+{
+  return std::tuple<Fields &...>(std::get<Indices>(fields)[index]...);
+}
+
+template <typename ...Fields>
+inline std::tuple<Fields &...> mSoAIterator<Fields...>::operator*() const
+{
+  return mSoAIterator_Dereference_Internal<Fields...>(fields, index, std::index_sequence_for<Fields...>());
+}
+
+template <typename ...Fields>
+inline bool mSoAIterator<Fields...>::operator!=(const size_t endIndex) const
+{
+  return index != endIndex;
+}
+
+template <typename ...Fields>
+inline void mSoAIterator<Fields...>::operator++()
+{
+  ++index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Create, OUT mSoA<Fields...> *pSoA, IN OPTIONAL mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pSoA == nullptr, mR_ArgumentNull);
+
+  mSoA_Destroy_Internal(pSoA);
+
+  pSoA->pAllocator = pAllocator;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Create, OUT mPtr<mSoA<Fields...>> *pSoA, IN OPTIONAL mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pSoA == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Allocate(pSoA, pAllocator, mSoA_Destroy_Internal<Fields...>, 1));
+
+  (*pSoA)->pAllocator = pAllocator;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Destroy, IN_OUT mPtr<mSoA<Fields...>> *pSoA)
+{
+  return mSharedPointer_Destroy(pSoA);
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Destroy, IN_OUT mSoA<Fields...> *pSoA)
+{
+  mSoA_Destroy_Internal(pSoA);
+
+  return mR_Success;
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Clear, mSoA<Fields...> &soa)
+{
+  mFUNCTION_SETUP();
+
+  if (soa.pAllocation != nullptr)
+  {
+    mSoA_DestructRange_Internal(soa, 0, soa.count);
+    soa.count = 0;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_GetCount, const mSoA<Fields...> &soa, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pCount == nullptr, mR_ArgumentNull);
+
+  *pCount = soa.count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Reserve, mSoA<Fields...> &soa, const size_t count)
+{
+  mFUNCTION_SETUP();
+
+  mSTATIC_ASSERT(mSoA_AllOf_Internal<mIsTriviallyMemoryMovable<Fields>::value...>::value, "All fields have to be trivially memory movable.");
+
+  if (count <= soa.capacity)
+    mRETURN_SUCCESS();
+
+  // The field arrays are at different offsets for every capacity, so this can't just reallocate.
+  uint8_t *pAllocation = nullptr;
+  mERROR_CHECK(mAllocator_Allocate(soa.pAllocator, &pAllocation, mSoA_GetAllocationSize_Internal<Fields...>(count)));
+
+  const std::tuple<Fields *...> fields = mSoA_GetFields_Internal<Fields...>(pAllocation, count);
+
+  if (soa.count > 0)
+  {
+    mSoA_ForEachField_Internal<Fields...>([&](auto index)
+    {
+      memcpy(std::get<decltype(index)::value>(fields), std::get<decltype(index)::value>(soa.fields), sizeof(*std::get<decltype(index)::value>(fields)) * soa.count);
+    });
+  }
+
+  mERROR_CHECK(mAllocator_FreePtr(soa.pAllocator, &soa.pAllocation));
+
+  soa.pAllocation = pAllocation;
+  soa.fields = fields;
+  soa.capacity = count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_ResizeWith, mSoA<Fields...> &soa, const size_t count, const typename mSoA_Value_Internal<Fields>::type &...values)
+{
+  mFUNCTION_SETUP();
+
+  if (count <= soa.count)
+  {
+    mSoA_DestructRange_Internal(soa, count, soa.count);
+    soa.count = count;
+
+    mRETURN_SUCCESS();
+  }
+
+  // `values` may reference elements of `soa`, which are freed when it grows.
+  const std::tuple<Fields...> fieldValues(values...);
+
+  mERROR_CHECK(mSoA_Reserve(soa, count));
+
+  mSoA_ForEachField_Internal<Fields...>([&](auto index)
+  {
+    typedef typename std::tuple_element<decltype(index)::value, std::tuple<Fields...>>::type T;
+
+    T *pField = std::get<decltype(index)::value>(soa.fields);
+
+    for (size_t i = soa.count; i < count; i++)
+      new (pField + i) T(std::get<decltype(index)::value>(fieldValues));
+  });
+
+  soa.count = count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_PushBack, mSoA<Fields...> &soa, const typename mSoA_Value_Internal<Fields>::type &...values)
+{
+  mFUNCTION_SETUP();
+
+  // `values` may reference elements of `soa`, which are freed when it grows.
+  std::tuple<Fields...> fieldValues(values...);
+
+  if (soa.count == soa.capacity)
+    mERROR_CHECK(mSoA_Grow_Internal(soa));
+
+  mSoA_ForEachField_Internal<Fields...>([&](auto index)
+  {
+    typedef typename std::tuple_element<decltype(index)::value, std::tuple<Fields...>>::type T;
+
+    new (std::get<decltype(index)::value>(soa.fields) + soa.count) T(std::move(std::get<decltype(index)::value>(fieldValues)));
+  });
+
+  ++soa.count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_PeekAt, const mSoA<Fields...> &soa, const size_t index, OUT OPTIONAL typename mSoA_Value_Internal<Fields>::type *...pValues)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(index >= soa.count, mR_IndexOutOfBounds);
+
+  const std::tuple<Fields *...> values(pValues...);
+
+  mSoA_ForEachField_Internal<Fields...>([&](auto fieldIndex)
+  {
+    auto *pValue = std::get<decltype(fieldIndex)::value>(values);
+
+    if (pValue != nullptr)
+      *pValue = std::get<decltype(fieldIndex)::value>(soa.fields)[index];
+  });
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_RemoveAt, mSoA<Fields...> &soa, const size_t index)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(index >= soa.count, mR_IndexOutOfBounds);
+
+  mSoA_DestructRange_Internal(soa, index, index + 1);
+
+  const size_t moveCount = soa.count - index - 1;
+
+  if (moveCount > 0)
+  {
+    mSoA_ForEachField_Internal<Fields...>([&](auto fieldIndex)
+    {
+      auto *pField = std::get<decltype(fieldIndex)::value>(soa.fields);
+      memmove(pField + index, pField + index + 1, sizeof(*pField) * moveCount);
+    });
+  }
+
+  --soa.count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_SwapRemoveAt, mSoA<Fields...> &soa, const size_t index)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(index >= soa.count, mR_IndexOutOfBounds);
+
+  mSoA_DestructRange_Internal(soa, index, index + 1);
+
+  const size_t lastIndex = soa.count - 1;
+
+  if (index != lastIndex)
+  {
+    mSoA_ForEachField_Internal<Fields...>([&](auto fieldIndex)
+    {
+      auto *pField = std::get<decltype(fieldIndex)::value>(soa.fields);
+      memcpy(pField + index, pField + lastIndex, sizeof(*pField));
+    });
+  }
+
+  --soa.count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Fields>
+inline mFUNCTION(mSoA_Swap, mSoA<Fields...> &soa, const size_t indexA, const size_t indexB)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(indexA >= soa.count || indexB >= soa.count, mR_IndexOutOfBounds);
+
+  mSoA_ForEachField_Internal<Fields...>([&](auto fieldIndex)
+  {
+    auto *pField = std::get<decltype(fieldIndex)::value>(soa.fields);
+    std::swap(pField[indexA], pField[indexB]);
+  });
+
+  mRETURN_SUCCESS();
+}
+
+template <size_t Index, typename ...Fields>
+inline mFUNCTION(mSoA_GetField, mSoA<Fields...> &soa, OUT typename mSoA<Fields...>::template FieldType<Index> **ppField)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(ppField == nullptr, mR_ArgumentNull);
+
+  *ppField = std::get<Index>(soa.fields);
+
+  mRETURN_SUCCESS();
+}
+
+template <size_t Index, typename ...Fields>
+inline mFUNCTION(mSoA_GetField, const mSoA<Fields...> &soa, OUT const typename mSoA<Fields...>::template FieldType<Index> **ppField)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(ppField == nullptr, mR_ArgumentNull);
+
+  *ppField = std::get<Index>(soa.fields);
+
+  mRETURN_SUCCESS();
+}
@@ -0,0 +1,444 @@
+#ifndef mSort_h__
+#define mSort_h__
+
+#include "mediaLib.h"
+#include "mThreadPool.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "J41GY0SsV5TwCCDapim/GxG/sOk5kNc7m5hxXYxCfELQT0osZuo9ZqNX0mogwbOYryZYaRT+jmOE4/UE"
+#endif
+
+// Sort engine for contiguous memory. The comparison functions are template parameters, so they can be inlined.
+// `lessFunc(a, b)` has to return `true` if `a` should be ordered before `b`.
+
+// Introsort: Quicksort with median of three pivots, falls back to heapsort if the recursion gets too deep (guaranteed O(n log n)) and insertion sort for small ranges. Not stable.
+template <typename T, typename TLessFunc>
+void mSort(IN_OUT T *pData, const size_t count, TLessFunc lessFunc);
+
+template <typename T>
+void mSort(IN_OUT T *pData, const size_t count);
+
+// Stable LSD radix sort by the integer or floating point value returned by `valueFunc`. Requires `count * 2` key/index pairs of scratch memory.
+template <typename T, typename TValueFunc>
+mFUNCTION(mSort_Radix, IN_OUT T *pData, const size_t count, IN OPTIONAL mAllocator *pAllocator, TValueFunc valueFunc);
+
+// Whether `mSort_Radix` supports values of type `U`.
+template <typename U>
+struct mSort_IsRadixSortable : std::integral_constant<bool, (std::is_integral<U>::value && sizeof(U) <= sizeof(uint64_t)) || (std::is_floating_point<U>::value && (sizeof(U) == sizeof(uint32_t) || sizeof(U) == sizeof(uint64_t)))> {};
+
+// Sorts chunks on the worker threads of `threadPool` and merges them pairwise in parallel. Stable if `count` is small enough to be sorted by a single chunk, otherwise equal elements may be reordered.
+// Requires `count` elements of scratch memory.
+template <typename T, typename TLessFunc>
+mFUNCTION(mSort_Parallel, mPtr<mThreadPool> &threadPool, IN_OUT T *pData, const size_t count, IN OPTIONAL mAllocator *pAllocator, TLessFunc lessFunc);
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr size_t mSort_InsertionSortThreshold = 24;
+constexpr size_t mSort_RadixSortThreshold = 256;
+constexpr size_t mSort_ParallelChunkMinSize = 8 * 1024;
+
+template <typename T, typename TLessFunc>
+inline void mSort_InsertionSort_Internal(IN_OUT T *pData, const size_t count, TLessFunc &lessFunc)
+{
+  for (size_t i = 1; i < count; i++)
+  {
+    if (!lessFunc(pData[i], pData[i - 1]))
+      continue;
+
+    T value = std::move(pData[i]);
+    size_t j = i;
+
+    do
+    {
+      pData[j] = std::move(pData[j - 1]);
+      j--;
+    } while (j > 0 && lessFunc(value, pData[j - 1]));
+
+    pData[j] = std::move(value);
+  }
+}
+
+template <typename T, typename TLessFunc>
+inline void mSort_HeapSort_SiftDown_Internal(IN_OUT T *pData, size_t index, const size_t count, TLessFunc &lessFunc)
+{
+  while (true)
+  {
+    size_t child = index * 2 + 1;
+
+    if (child >= count)
+      return;
+
+    if (child + 1 < count && lessFunc(pData[child], pData[child + 1]))
+      child++;
+
+    if (!lessFunc(pData[index], pData[child]))
+      return;
+
+    std::swap(pData[index], pData[child]);
+    index = child;
+  }
+}
+
+template <typename T, typename TLessFunc>
+inline void mSort_HeapSort_Internal(IN_OUT T *pData, const size_t count, TLessFunc &lessFunc)
+{
+  for (size_t i = count / 2; i > 0; i--)
+    mSort_HeapSort_SiftDown_Internal(pData, i - 1, count, lessFunc);
+
+  for (size_t i = count - 1; i > 0; i--)
+  {
+    std::swap(pData[0], pData[i]);
+    mSort_HeapSort_SiftDown_Internal(pData, 0, i, lessFunc);
+  }
+}
+
+template <typename T, typename TLessFunc>
+inline void mSort_SortThree_Internal(IN_OUT T *pData, const size_t a, const size_t b, const size_t c, TLessFunc &lessFunc)
+{
+  if (lessFunc(pData[b], pData[a]))
+    std::swap(pData[a], pData[b]);
+
+  if (lessFunc(pData[c], pData[b]))
+  {
+    std::swap(pData[b], pData[c]);
+
+    if (lessFunc(pData[b], pData[a]))
+      std::swap(pData[a], pData[b]);
+  }
+}
+
+template <typename T, typename TLessFunc>
+inline void mSort_IntroSort_Internal(IN_OUT T *pData, size_t count, size_t depthLimit, TLessFunc &lessFunc)
+{
+  while (count > mSort_InsertionSortThreshold)
+  {
+    if (depthLimit == 0)
+    {
+      mSort_HeapSort_Internal(pData, count, lessFunc);
+      return;
+    }
+
+    depthLimit--;
+
+    const size_t middle = count / 2;
+
+    // Afterwards `pData[count - 1]` is a sentinel for the left scan.
+    mSort_SortThree_Internal(pData, 0, middle, count - 1, lessFunc);
+    std::swap(pData[0], pData[middle]);
+
+    size_t i = 0;
+    size_t j = count;
+
+    // Hoare partition around `pData[0]`. Elements equal to the pivot stop both scans, so ranges with many duplicates are still split evenly.
+    while (true)
+    {
+      do { i++; } while (lessFunc(pData[i], pData[0]));
+      do { j--; } while (lessFunc(pData[0], pData[j]));
+
+      if (i >= j)
+        break;
+
+      std::swap(pData[i], pData[j]);
+    }
+
+    std::swap(pData[0], pData[j]);
+
+    const size_t leftCount = j;
+    const size_t rightCount = count - j - 1;
+
+    // Recurse into the smaller partition to limit the stack depth to O(log n).
+    if (leftCount < rightCount)
+    {
+      mSort_IntroSort_Internal(pData, leftCount, depthLimit, lessFunc);
+      pData += j + 1;
+      count = rightCount;
+    }
+    else
+    {
+      mSort_IntroSort_Internal(pData + j + 1, rightCount, depthLimit, lessFunc);
+      count = leftCount;
+    }
+  }
+
+  mSort_InsertionSort_Internal(pData, count, lessFunc);
+}
+
+template <typename T, typename TLessFunc>
+inline void mSort(IN_OUT T *pData, const size_t count, TLessFunc lessFunc)
+{
+  if (count < 2)
+    return;
+
+  size_t depthLimit = 0;
+
+  for (size_t i = count; i > 1; i >>= 1)
+    depthLimit += 2;
+
+  mSort_IntroSort_Internal(pData, count, depthLimit, lessFunc);
+}
+
+template <typename T>
+inline void mSort(IN_OUT T *pData, const size_t count)
+{
+  mSort(pData, count, std::less<T>());
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+struct mSort_RadixEntry_Internal
+{
+  uint64_t key;
+  size_t index;
+};
+
+// Map `value` to an unsigned integer with the same ordering.
+template <typename U, typename std::enable_if<std::is_floating_point<U>::value && sizeof(U) == sizeof(uint32_t)>::type* = nullptr>
+inline uint64_t mSort_RadixKey_Internal(const U value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  // Negative values are ordered in reverse.
+  return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+template <typename U, typename std::enable_if<std::is_floating_point<U>::value && sizeof(U) == sizeof(uint64_t)>::type* = nullptr>
+inline uint64_t mSort_RadixKey_Internal(const U value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  return (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+}
+
+template <typename U, typename std::enable_if<std::is_integral<U>::value && std::is_signed<U>::value>::type* = nullptr>
+inline uint64_t mSort_RadixKey_Internal(const U value)
+{
+  typedef typename std::make_unsigned<U>::type unsigned_type;
+
+  // Flipping the sign bit moves negative values in front of positive ones.
+  return (uint64_t)(unsigned_type)((unsigned_type)value ^ ((unsigned_type)1 << (sizeof(U) * 8 - 1)));
+}
+
+template <typename U, typename std::enable_if<std::is_integral<U>::value && !std::is_signed<U>::value>::type* = nullptr>
+inline uint64_t mSort_RadixKey_Internal(const U value)
+{
+  return (uint64_t)value;
+}
+
+template <typename T, typename TValueFunc>
+inline mFUNCTION(mSort_Radix, IN_OUT T *pData, const size_t count, IN OPTIONAL mAllocator *pAllocator, TValueFunc valueFunc)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pData == nullptr && count > 0, mR_ArgumentNull);
+
+  typedef typename std::decay<decltype(valueFunc(*pData))>::type value_type;
+  static_assert(mSort_IsRadixSortable<value_type>::value, "Radix sort requires integer or 32/64 bit floating point values.");
+
+  if (count < mSort_RadixSortThreshold)
+  {
+    // Insertion sort is stable as well.
+    auto lessFunc = [&](const T &a, const T &b) { return valueFunc(a) < valueFunc(b); };
+    mSort_InsertionSort_Internal(pData, count, lessFunc);
+
+    mRETURN_SUCCESS();
+  }
+
+  mSort_RadixEntry_Internal *pEntries = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pEntries);
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pEntries, count * 2));
+
+  constexpr size_t passCount = sizeof(value_type);
+  size_t histogram[passCount][256];
+  mERROR_CHECK(mZeroMemory(&histogram[0][0], passCount * 256));
+
+  // Extract every key only once and count all digits in a single pass.
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint64_t key = mSort_RadixKey_Internal<value_type>(valueFunc(pData[i]));
+
+    pEntries[i].key = key;
+    pEntries[i].index = i;
+
+    for (size_t pass = 0; pass < passCount; pass++)
+      histogram[pass][(key >> (pass * 8)) & 0xFF]++;
+  }
+
+  mSort_RadixEntry_Internal *pSource = pEntries;
+  mSort_RadixEntry_Internal *pTarget = pEntries + count;
+
+  for (size_t pass = 0; pass < passCount; pass++)
+  {
+    size_t *pHistogram = histogram[pass];
+    const size_t shift = pass * 8;
+
+    // Skip digits that are the same for all keys.
+    if (pHistogram[(pSource[0].key >> shift) & 0xFF] == count)
+      continue;
+
+    size_t offset = 0;
+
+    for (size_t i = 0; i < 256; i++)
+    {
+      const size_t bucketCount = pHistogram[i];
+      pHistogram[i] = offset;
+      offset += bucketCount;
+    }
+
+    for (size_t i = 0; i < count; i++)
+      pTarget[pHistogram[(pSource[i].key >> shift) & 0xFF]++] = pSource[i];
+
+    std::swap(pSource, pTarget);
+  }
+
+  // Apply the permutation in place by following its cycles. Entries that have been placed are marked by pointing to themselves.
+  for (size_t i = 0; i < count; i++)
+  {
+    if (pSource[i].index == i)
+      continue;
+
+    T value = std::move(pData[i]);
+    size_t j = i;
+
+    while (true)
+    {
+      const size_t next = pSource[j].index;
+      pSource[j].index = j;
+
+      if (next == i)
+      {
+        pData[j] = std::move(value);
+        break;
+      }
+
+      pData[j] = std::move(pData[next]);
+      j = next;
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Merges `[pSource, pSource + leftCount)` and `[pSource + leftCount, pSource + count)` into `pTarget`. If `Construct` is set, `pTarget` is uninitialized memory.
+template <bool Construct, typename T, typename TLessFunc>
+inline void mSort_Merge_Internal(IN_OUT T *pSource, OUT T *pTarget, const size_t leftCount, const size_t count, TLessFunc &lessFunc)
+{
+  size_t left = 0;
+  size_t right = leftCount;
+  size_t target = 0;
+
+  const auto moveToTarget = [&](const size_t index)
+  {
+    mIF_CONSTEXPR (Construct)
+      new (&pTarget[target]) T(std::move(pSource[index]));
+    else
+      pTarget[target] = std::move(pSource[index]);
+
+    target++;
+  };
+
+  while (left < leftCount && right < count)
+  {
+    // Prefer the left side for equal elements.
+    if (lessFunc(pSource[right], pSource[left]))
+      moveToTarget(right++);
+    else
+      moveToTarget(left++);
+  }
+
+  while (left < leftCount)
+    moveToTarget(left++);
+
+  while (right < count)
+    moveToTarget(right++);
+}
+
+template <typename T, typename TLessFunc>
+inline mFUNCTION(mSort_Parallel, mPtr<mThreadPool> &threadPool, IN_OUT T *pData, const size_t count, IN OPTIONAL mAllocator *pAllocator, TLessFunc lessFunc)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(threadPool == nullptr || (pData == nullptr && count > 0), mR_ArgumentNull);
+
+  size_t threadCount = 0;
+  mERROR_CHECK(mThreadPool_GetThreadCount(threadPool, &threadCount));
+
+  if (threadCount <= 1 || count < mSort_ParallelChunkMinSize * 2)
+  {
+    mSort(pData, count, lessFunc);
+    mRETURN_SUCCESS();
+  }
+
+  // A power of two chunk count, so all merge rounds but the last split the work evenly.
+  size_t chunkCount = 2;
+
+  while (chunkCount < threadCount * 2 && count / (chunkCount * 2) >= mSort_ParallelChunkMinSize)
+    chunkCount *= 2;
+
+  const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+  mERROR_CHECK(mThreadPool_ParallelFor(threadPool, 0, chunkCount, 1, [&](const size_t chunkStart, const size_t chunkEnd)
+  {
+    for (size_t i = chunkStart; i < chunkEnd; i++)
+    {
+      const size_t start = i * chunkSize;
+
+      if (start < count)
+        mSort(pData + start, mMin(chunkSize, count - start), lessFunc);
+    }
+
+    return mR_Success;
+  }));
+
+  T *pScratch = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pScratch);
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pScratch, count));
+
+  T *pSource = pData;
+  T *pTarget = pScratch;
+  bool scratchConstructed = false;
+
+  mDEFER_IF(scratchConstructed, for (size_t i = 0; i < count; i++) mDestruct(&pScratch[i]));
+
+  for (size_t width = chunkSize; width < count; width *= 2)
+  {
+    const size_t pairCount = (count + width * 2 - 1) / (width * 2);
+    const bool construct = !scratchConstructed && pTarget == pScratch;
+
+    mERROR_CHECK(mThreadPool_ParallelFor(threadPool, 0, pairCount, 1, [&](const size_t pairStart, const size_t pairEnd)
+    {
+      for (size_t i = pairStart; i < pairEnd; i++)
+      {
+        const size_t start = i * width * 2;
+        const size_t pairSize = mMin(width * 2, count - start);
+        const size_t leftCount = mMin(width, pairSize);
+
+        if (construct)
+          mSort_Merge_Internal<true>(pSource + start, pTarget + start, leftCount, pairSize, lessFunc);
+        else
+          mSort_Merge_Internal<false>(pSource + start, pTarget + start, leftCount, pairSize, lessFunc);
+      }
+
+      return mR_Success;
+    }));
+
+    if (construct)
+      scratchConstructed = true;
+
+    std::swap(pSource, pTarget);
+  }
+
+  if (pSource != pData)
+    for (size_t i = 0; i < count; i++)
+      pData[i] = std::move(pSource[i]);
+
+  mRETURN_SUCCESS();
+}
+
+#endif // mSort_h__
@@ -2,6 +2,7 @@
 #define mColourLookup_h__
 
 #include "mediaLib.h"
+#include "mImageBuffer.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -10,6 +11,12 @@
   #define __M_FILE__ "K9UDn4f1ync6Hggo9VeTVsQHOW+cWIfsuaQHa/idteBoJIjUtl5S7sM8xDtiplWFNdT4qh+OtecHIeer"
 #endif
 
+enum mColourLookup_Interpolation
+{
+  mCL_I_Trilinear,
+  mCL_I_Tetrahedral, // Only blends the four corners of the tetrahedron around the colour, which is cheaper and follows the grey axis more closely than trilinear.
+};
+
 struct mColourLookup
 {
   mVec3s resolution;
@@ -24,6 +31,11 @@ mFUNCTION(mColourLookup_Destroy, IN_OUT mPtr<mColourLookup> *pColourLookup);
 mFUNCTION(mColourLookup_LoadFromFile, mPtr<mColourLookup> &colourLookup, const mString &filename);
 mFUNCTION(mColourLookup_At, mPtr<mColourLookup> &colourLookup, const mVec3f position, OUT mVec3f *pColour);
 
+// Maps the colour channels of every pixel of `imageBuffer` through the lookup table in place, alpha is left untouched.
+// Supports `mPF_R8G8B8A8`, `mPF_B8G8R8A8`, `mPF_R8G8B8`, `mPF_B8G8R8`, `mPF_Rf32Gf32Bf32` and `mPF_Rf32Gf32Bf32Af32`. Rows are processed in bands across `asyncTaskHandler`.
+mFUNCTION(mColourLookup_ApplyToImage, mPtr<mColourLookup> &colourLookup, mPtr<mImageBuffer> &imageBuffer, const mColourLookup_Interpolation interpolation = mCL_I_Tetrahedral);
+mFUNCTION(mColourLookup_ApplyToImage, mPtr<mColourLookup> &colourLookup, mPtr<mImageBuffer> &imageBuffer, mPtr<mThreadPool> &asyncTaskHandler, const mColourLookup_Interpolation interpolation = mCL_I_Tetrahedral);
+
 mFUNCTION(mColourLookup_WriteToFile, mPtr<mColourLookup> &colourLookup, const mString &filename);
 
 #endif // mColourLookup_h__
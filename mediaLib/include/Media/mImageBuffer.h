@@ -3,6 +3,8 @@
 
 #include "mediaLib.h"
 #include "mPixelFormat.h"
+#include "mAsyncFile.h"
+#include "mCachedFileReader.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -18,6 +20,24 @@ enum mImageBuffer_CopyFlags
   mIB_CF_PixelFormatChangeAllowed = 1 << 1,
 };
 
+enum mImageBuffer_ResizeFilter
+{
+  mIB_RF_Box, // Averages all covered source pixels when shrinking, nearest neighbour when enlarging.
+  mIB_RF_Bilinear,
+  mIB_RF_Bicubic, // Catmull-Rom.
+  mIB_RF_Lanczos, // Lanczos with three lobes.
+  mIB_RF_Kaiser, // Sinc with three lobes in a Kaiser window, a little softer than Lanczos. Mostly useful to build mip maps.
+};
+
+// Decodes JPEGs at reduced resolution and / or only a part of them, which is a lot cheaper than decoding everything and throwing most of it away.
+struct mImageBuffer_JpegDecodeParams
+{
+  size_t scaleDenominator = 1; // 1, 2, 4 or 8. The image is scaled down in the DCT domain while being decoded.
+  mVec2s minimumSize = mVec2s(0); // If not zero, the largest scale denominator that still decodes (the region to) at least this size is used instead of `scaleDenominator`.
+  bool decodeRegion = false;
+  mRectangle2D<size_t> region; // In pixels of the full resolution image. Rounded outwards to whole pixels of the scaled image.
+};
+
 struct mImageBuffer
 {
   uint8_t *pPixels;
@@ -32,6 +52,10 @@ struct mImageBuffer
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator);
 mFUNCTION(mImageBuffer_CreateFromFile, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, const mString &filename, const mPixelFormat pixelFormat = mPF_R8G8B8A8);
 mFUNCTION(mImageBuffer_CreateFromData, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, IN const uint8_t *pData, const size_t size, const mPixelFormat pixelFormat = mPF_R8G8B8A8);
+
+// Reads all files through `asyncFileQueue` and decodes each of them as soon as it has been read. `pImageBuffers` has to have space for `count` image buffers.
+mFUNCTION(mImageBuffer_CreateFromFiles, mPtr<mAsyncFileQueue> &asyncFileQueue, OUT mPtr<mImageBuffer> *pImageBuffers, IN OPTIONAL mAllocator *pAllocator, IN const mString *pFilenames, const size_t count, const mPixelFormat pixelFormat = mPF_R8G8B8A8);
+
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, const mVec2s &size, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, IN const void *pData, const mVec2s &size, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, IN const void *pData, const mVec2s &size, const size_t stride, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
@@ -53,6 +77,22 @@ mFUNCTION(mImageBuffer_SaveAsRaw, mPtr<mImageBuffer> &imageBuffer, const mString
 mFUNCTION(mImageBuffer_SetToFile, mPtr<mImageBuffer> &imageBuffer, const mString &filename, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
 mFUNCTION(mImageBuffer_SetToData, mPtr<mImageBuffer> &imageBuffer, IN const uint8_t *pData, const size_t size, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
 
+// Only decodes JPEGs to `mPF_B8G8R8A8`, `mPF_R8G8B8A8`, `mPF_B8G8R8`, `mPF_R8G8B8` or `mPF_Monochrome8`. Rows above the region are skipped without colour conversion, rows below it aren't decoded at all and columns are only decoded down to the enclosing MCUs.
+mFUNCTION(mImageBuffer_SetToJpegData, mPtr<mImageBuffer> &imageBuffer, IN const uint8_t *pData, const size_t size, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
+
+// Streams the file through `cachedFileReader` while decoding, so the compressed image never has to be in memory as a whole. Decoding stops reading as soon as the last row of the region has been decoded.
+mFUNCTION(mImageBuffer_SetToJpegStream, mPtr<mImageBuffer> &imageBuffer, mPtr<mCachedFileReader> &cachedFileReader, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
+mFUNCTION(mImageBuffer_SetToJpegFile, mPtr<mImageBuffer> &imageBuffer, const mString &filename, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat = mPF_B8G8R8A8);
+
 mFUNCTION(mImageBuffer_FlipY, mPtr<mImageBuffer> &imageBuffer);
 
+// Resamples `source` to the current size of `target`. Both have to have the same pixel format, planar formats are resampled plane by plane.
+// Only pixel formats with 8 bit or 32 bit floating point channels are supported.
+mFUNCTION(mImageBuffer_ResizeTo, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mImageBuffer_ResizeFilter filter = mIB_RF_Bilinear);
+mFUNCTION(mImageBuffer_ResizeTo, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler);
+
+// Replaces the pixels of `imageBuffer` with a resampled copy of the given size. The new pixels are always owned by `imageBuffer`.
+mFUNCTION(mImageBuffer_Resize, mPtr<mImageBuffer> &imageBuffer, const mVec2s &size, const mImageBuffer_ResizeFilter filter = mIB_RF_Bilinear);
+mFUNCTION(mImageBuffer_Resize, mPtr<mImageBuffer> &imageBuffer, const mVec2s &size, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler);
+
 #endif // mImageBuffer_h__
@@ -0,0 +1,53 @@
+#ifndef mImageEncoder_h__
+#define mImageEncoder_h__
+
+#include "mediaLib.h"
+#include "mImageBuffer.h"
+#include "mBinaryChunk.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "yJirpCdVKSDv3ku1Vl+TLnBjdfOFEnS+FbmbSDFFnnA96lPDthfsnWoAYHrLtGX6eK65PyiuPFK3VV2S"
+#endif
+
+enum mImageEncoder_ChromaSubsampling
+{
+  mIE_CS_444,
+  mIE_CS_422,
+  mIE_CS_420,
+  mIE_CS_440,
+  mIE_CS_411,
+  mIE_CS_Grayscale, // Drops the colour channels entirely.
+};
+
+struct mImageEncoder_Params
+{
+  size_t quality = 85; // 1 - 100.
+  mImageEncoder_ChromaSubsampling chromaSubsampling = mIE_CS_420; // Ignored for YUV and monochrome images, which are always encoded with the subsampling they already have.
+  bool fastDct = true;
+};
+
+// Encodes JPEGs with compressor contexts (and output buffers) that are kept alive across images instead of being set up for every single one.
+// Batches are encoded in parallel on the thread pool the encoder has been created with. The encoder may also be used from multiple threads at once, but only encodes as many images at a time as it has compressors (one per thread pool thread plus one for the calling thread).
+// YUV images (`mPF_YUV420` etc.) are compressed from their planes directly, without going through RGB.
+struct mImageEncoder;
+
+mFUNCTION(mImageEncoder_Create, OUT mPtr<mImageEncoder> *pImageEncoder, IN OPTIONAL mAllocator *pAllocator, const mImageEncoder_Params &params = mImageEncoder_Params());
+mFUNCTION(mImageEncoder_Create, OUT mPtr<mImageEncoder> *pImageEncoder, IN OPTIONAL mAllocator *pAllocator, const mImageEncoder_Params &params, mPtr<mThreadPool> &asyncTaskHandler);
+mFUNCTION(mImageEncoder_Destroy, IN_OUT mPtr<mImageEncoder> *pImageEncoder);
+
+// Mustn't be called while images are being encoded.
+mFUNCTION(mImageEncoder_SetParams, mPtr<mImageEncoder> &imageEncoder, const mImageEncoder_Params &params);
+
+// Appends the JPEG to `binaryChunk`, which is created with the allocator of the encoder if it's `nullptr`.
+mFUNCTION(mImageEncoder_EncodeToMemory, mPtr<mImageEncoder> &imageEncoder, mPtr<mImageBuffer> &imageBuffer, mPtr<mBinaryChunk> &binaryChunk);
+mFUNCTION(mImageEncoder_EncodeToFile, mPtr<mImageEncoder> &imageEncoder, mPtr<mImageBuffer> &imageBuffer, const mString &filename);
+
+// Encodes `count` images in parallel. Returns the first error, images that haven't been started by then are skipped.
+// The binary chunks grow on the worker threads concurrently, so their allocators have to be thread safe (like the default allocators). Chunks that are `nullptr` are created up front.
+mFUNCTION(mImageEncoder_EncodeToMemory, mPtr<mImageEncoder> &imageEncoder, IN mPtr<mImageBuffer> *pImageBuffers, IN_OUT mPtr<mBinaryChunk> *pBinaryChunks, const size_t count);
+mFUNCTION(mImageEncoder_EncodeToFiles, mPtr<mImageEncoder> &imageEncoder, IN mPtr<mImageBuffer> *pImageBuffers, IN const mString *pFilenames, const size_t count);
+
+#endif // mImageEncoder_h__
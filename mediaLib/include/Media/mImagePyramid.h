@@ -0,0 +1,41 @@
+#ifndef mImagePyramid_h__
+#define mImagePyramid_h__
+
+#include "mediaLib.h"
+#include "mImageBuffer.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "8W7zKGDq9ltSNYtugDlD1uwfaDTaWp1rl5ZdstROLFpJ6qu6gCTz7T88cBcb/iBdtlML+KB/nMIbLnhg"
+#endif
+
+// A full mip chain of an image. All levels live in a single allocation (largest first, without any padding) and can be accessed as `mImageBuffer`s that don't own their pixels.
+// Every level is half the size of the previous one (rounded down, but at least one pixel), down to 1x1.
+
+struct mImagePyramid
+{
+  uint8_t *pData;
+  size_t dataSize;
+  mPixelFormat pixelFormat;
+  mPtr<mImageBuffer> *pLevels;
+  size_t levelCount;
+  mAllocator *pAllocator;
+};
+
+// Supports `mPF_R8G8B8A8`, `mPF_B8G8R8A8` and the 32 bit floating point formats.
+// If `gammaCorrect` is set, the colour channels of 8 bit formats are treated as sRGB and filtered in linear space. Alpha and floating point formats are always filtered as they are.
+// Floating point images and 8 bit images with `gammaCorrect` filter every level from an unquantised floating point copy of the previous level, so rounding errors don't accumulate down the chain.
+// Without `gammaCorrect`, every level of an 8 bit image is filtered from the previous, already quantised, level.
+// `maxLevelCount` limits the number of levels, `0` generates all of them.
+mFUNCTION(mImagePyramid_Create, OUT mPtr<mImagePyramid> *pImagePyramid, IN OPTIONAL mAllocator *pAllocator, mPtr<mImageBuffer> &source, const mImageBuffer_ResizeFilter filter = mIB_RF_Box, const bool gammaCorrect = true, const size_t maxLevelCount = 0);
+mFUNCTION(mImagePyramid_Create, OUT mPtr<mImagePyramid> *pImagePyramid, IN OPTIONAL mAllocator *pAllocator, mPtr<mImageBuffer> &source, const mImageBuffer_ResizeFilter filter, const bool gammaCorrect, const size_t maxLevelCount, mPtr<mThreadPool> &asyncTaskHandler);
+mFUNCTION(mImagePyramid_Destroy, IN_OUT mPtr<mImagePyramid> *pImagePyramid);
+
+mFUNCTION(mImagePyramid_GetLevelCount, const mPtr<mImagePyramid> &imagePyramid, OUT size_t *pLevelCount);
+
+// The returned image buffer points into the pyramid and is only valid as long as the pyramid is.
+mFUNCTION(mImagePyramid_GetLevel, mPtr<mImagePyramid> &imagePyramid, const size_t level, OUT mPtr<mImageBuffer> *pLevel);
+
+#endif // mImagePyramid_h__
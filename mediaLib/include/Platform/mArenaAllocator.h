@@ -0,0 +1,49 @@
+#ifndef mArenaAllocator_h__
+#define mArenaAllocator_h__
+
+#include "mediaLib.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "7inC3ySK2UVUAl5MbokPTNbatvnXKxbiNhfznorlVU1ZjeIyFouLyKQOyf4uR//Eyz4VXTM5me98K6BS"
+#endif
+
+// Bump pointer allocator over large chunks that are requested from a backing allocator.
+// Memory is only ever returned to the arena as a whole by `mArenaAllocator_Reset` (or partially by `mArenaAllocator_ResetToMarker`), which is O(1) and keeps the chunks around for reuse.
+// Freeing the most recent allocation rewinds the bump pointer (unless `rewindOnFree` is `false`), all other frees are no-ops. Reallocating the most recent allocation grows it in place if possible.
+// Arena allocators are not thread safe. Allocations are aligned to `mArenaAllocator_Alignment` bytes.
+
+constexpr size_t mArenaAllocator_DefaultChunkSize = 64 * 1024;
+constexpr size_t mArenaAllocator_Alignment = 16;
+
+struct mArenaAllocator_Chunk;
+
+struct mArenaAllocator_Marker
+{
+  mArenaAllocator_Chunk *pChunk;
+  size_t offset;
+};
+
+// `pAllocator` is initialized as an arena allocator and has to be destroyed with `mAllocator_Destroy`, which releases all chunks.
+// `pBackingAllocator`: the allocator that chunks are allocated from. Must outlive the arena.
+mFUNCTION(mArenaAllocator_Create, OUT mAllocator *pAllocator, IN OPTIONAL mAllocator *pBackingAllocator, const size_t chunkSize = mArenaAllocator_DefaultChunkSize, const bool rewindOnFree = true);
+
+// Invalidates all allocations of the arena.
+mFUNCTION(mArenaAllocator_Reset, IN mAllocator *pAllocator);
+
+// Markers allow nested scopes to release their allocations without invalidating the allocations of the outer scope.
+mFUNCTION(mArenaAllocator_GetMarker, IN mAllocator *pAllocator, OUT mArenaAllocator_Marker *pMarker);
+
+// Invalidates all allocations since `marker` has been retrieved. `marker` must not have been invalidated by a previous reset.
+mFUNCTION(mArenaAllocator_ResetToMarker, IN mAllocator *pAllocator, const mArenaAllocator_Marker &marker);
+
+// Retrieves the total size of all chunks and the amount of bytes currently in use (including headers and alignment).
+mFUNCTION(mArenaAllocator_GetSize, IN mAllocator *pAllocator, OUT OPTIONAL size_t *pReservedBytes, OUT OPTIONAL size_t *pUsedBytes);
+
+// Retrieves the arena allocator of the current thread, which is created on first use and destroyed when the thread exits.
+// The frame allocator is meant for short-lived scratch memory (e.g. per request or per frame). Use markers in nested scopes and only reset it completely from the outermost scope (e.g. the end of a frame).
+mFUNCTION(mArenaAllocator_GetThreadFrameAllocator, OUT mAllocator **ppAllocator);
+
+#endif // mArenaAllocator_h__
@@ -0,0 +1,54 @@
+#ifndef mAsyncFile_h__
+#define mAsyncFile_h__
+
+#include "mediaLib.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "s6Z8uYt7nBsed8+Zip4grp12QJ5VqQIcLAVKRcjNXYdrvNnPVpPi7VtPQFWinM5ryCp1IKoHGcmuiWQ+"
+#endif
+
+// Reads are queued with `mAsyncFile_Read` and handed to the backend in batches of up to `queueDepth` requests by `mAsyncFileQueue_Submit`.
+// Completion callbacks are always executed on the thread calling `mAsyncFileQueue_Poll` or `mAsyncFileQueue_WaitForAll`, so they don't need to be thread safe.
+// An `mAsyncFileQueue` (and the files opened with it) must only be used by one thread at a time.
+
+enum mAsyncFileQueue_Backend
+{
+  mAFQ_B_Default, // `mAFQ_B_IoUring` if the kernel supports it, otherwise `mAFQ_B_ThreadPool`.
+  mAFQ_B_IoUring, // Linux only.
+  mAFQ_B_ThreadPool,
+};
+
+struct mAsyncFileQueue;
+struct mAsyncFile;
+
+typedef std::function<void (const mResult result, const size_t bytesRead)> mAsyncFile_Callback;
+
+mFUNCTION(mAsyncFileQueue_Create, OUT mPtr<mAsyncFileQueue> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t queueDepth = 64, const mAsyncFileQueue_Backend backend = mAFQ_B_Default);
+
+// Waits for all submitted requests to complete. Callbacks of requests that haven't been executed yet won't be called.
+mFUNCTION(mAsyncFileQueue_Destroy, IN_OUT mPtr<mAsyncFileQueue> *pQueue);
+
+mFUNCTION(mAsyncFileQueue_GetBackend, mPtr<mAsyncFileQueue> &queue, OUT mAsyncFileQueue_Backend *pBackend);
+
+// Hands queued requests to the backend, as long as less than `queueDepth` requests are in flight.
+// If the backend fails to accept a request, the error is returned and the request stays queued.
+mFUNCTION(mAsyncFileQueue_Submit, mPtr<mAsyncFileQueue> &queue);
+
+// Executes the callbacks of completed requests and submits queued requests without blocking.
+mFUNCTION(mAsyncFileQueue_Poll, mPtr<mAsyncFileQueue> &queue, OUT OPTIONAL size_t *pCompletedCount = nullptr);
+
+// Submits all queued requests and executes callbacks until all requests (including ones queued from callbacks) have completed.
+mFUNCTION(mAsyncFileQueue_WaitForAll, mPtr<mAsyncFileQueue> &queue);
+
+mFUNCTION(mAsyncFile_Open, OUT mPtr<mAsyncFile> *pFile, IN OPTIONAL mAllocator *pAllocator, mPtr<mAsyncFileQueue> &queue, const mString &filename);
+mFUNCTION(mAsyncFile_Destroy, IN_OUT mPtr<mAsyncFile> *pFile); // The file stays open until all of its requests have completed.
+
+mFUNCTION(mAsyncFile_GetSize, mPtr<mAsyncFile> &file, OUT size_t *pSize);
+
+// `pBuffer` has to stay valid until `callback` has been executed. `bytesRead` is smaller than `size` if the end of the file has been reached.
+mFUNCTION(mAsyncFile_Read, mPtr<mAsyncFile> &file, const size_t offset, const size_t size, OUT uint8_t *pBuffer, const mAsyncFile_Callback &callback);
+
+#endif // mAsyncFile_h__
@@ -2,6 +2,7 @@
 #define mCachedFileReader_h__
 
 #include "mediaLib.h"
+#include "mReadOnlyMappedFile.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -10,6 +11,8 @@
   #define __M_FILE__ "y1EUEpEJJ8MxruisvGAXr11ALY4KxYnr63Mnb++I1x3nbzrqqrKSuq3SGQJZS5OYWBVyjqGddyLhsNbm"
 #endif
 
+struct mCachedFileReader_PageCache;
+
 struct mCachedFileReader
 {
   int fileHandle;
@@ -21,13 +24,40 @@ struct mCachedFileReader
   uint8_t *pCache;
 
   size_t maxCacheSize;
+
+  mPtr<mReadOnlyMappedFile> mappedFile;
+  const uint8_t *pMappedData; // only set if the file reader has been created with `mCachedFileReader_CreateMapped`.
+
+  mCachedFileReader_PageCache *pPageCache; // only set if the file reader has been created with `mCachedFileReader_CreatePaged`.
+};
+
+struct mCachedFileReader_Statistics
+{
+  size_t hitCount; // page lookups that were served from the cache.
+  size_t missCount; // page lookups that had to read from the file.
+  size_t readAheadCount; // pages that have been read ahead of time.
+  size_t readAheadHitCount; // pages that have been read ahead of time and have been accessed afterwards.
+  size_t evictionCount;
 };
 
 mFUNCTION(mCachedFileReader_Create, OUT mPtr<mCachedFileReader> *pCachedFileReader, IN mAllocator *pAllocator, const mString &fileName, const size_t maxCacheSize = 1024 * 1024);
+
+// Maps the file into memory instead of reading it into a cache window. `mCachedFileReader_PointerAt` returns pointers directly into the mapping (without size limit), which must not be written to.
+mFUNCTION(mCachedFileReader_CreateMapped, OUT mPtr<mCachedFileReader> *pCachedFileReader, IN mAllocator *pAllocator, const mString &fileName, const mReadOnlyMappedFile_AccessPattern accessPattern = mROMF_AP_Normal);
+
+// Caches `pageCount` pages of `pageSize` bytes each, that are evicted in least recently used order, so interleaved accesses to separate regions of the file don't evict each other.
+// Sequential accesses are detected for up to four interleaved streams and cause the next `readAheadPageCount` pages of a stream to be read asynchronously on a separate thread.
+// Pointers retrieved from `mCachedFileReader_PointerAt` stay valid until the next call to `mCachedFileReader_ReadAt` or `mCachedFileReader_PointerAt`.
+mFUNCTION(mCachedFileReader_CreatePaged, OUT mPtr<mCachedFileReader> *pCachedFileReader, IN mAllocator *pAllocator, const mString &fileName, const size_t pageSize = 64 * 1024, const size_t pageCount = 64, const size_t readAheadPageCount = 4);
+
 mFUNCTION(mCachedFileReader_Destroy, IN_OUT mPtr<mCachedFileReader> *pCachedFileReader);
 
 mFUNCTION(mCachedFileReader_GetSize, mPtr<mCachedFileReader> &cachedFileReader, OUT size_t *pFileSize);
 mFUNCTION(mCachedFileReader_ReadAt, mPtr<mCachedFileReader> &cachedFileReader, const size_t location, const size_t size, OUT uint8_t *pBuffer);
 mFUNCTION(mCachedFileReader_PointerAt, mPtr<mCachedFileReader> &cachedFileReader, const size_t location, const size_t size, OUT uint8_t **ppBuffer);
 
+// Only available for file readers created with `mCachedFileReader_CreatePaged`, returns `mR_ResourceStateInvalid` otherwise.
+mFUNCTION(mCachedFileReader_GetStatistics, mPtr<mCachedFileReader> &cachedFileReader, OUT mCachedFileReader_Statistics *pStatistics);
+mFUNCTION(mCachedFileReader_GetPageSize, mPtr<mCachedFileReader> &cachedFileReader, OUT size_t *pPageSize);
+
 #endif // mCachedFileReader_h__
@@ -0,0 +1,339 @@
+#ifndef mIntrusivePointer_h__
+#define mIntrusivePointer_h__
+
+#include "mediaLib.h"
+
+#include <atomic>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "8poKDhP5c3wJJENU+fdzBqJWncK/L/pgv2ofX6Z5sF0YaW1b5XLGJfDqec8Ezzdqq8gvUjoq4VkN/U6+"
+#endif
+
+// Unlike `mSharedPointer`, `mIntrusivePointer` stores the reference count, allocator and cleanup function in the object itself.
+// Copying a pointer therefore only touches the object and there's no separate parameter block to allocate or keep in cache.
+// Objects have to inherit from `mRefCounted` (atomic reference count) or `mLocalRefCounted` (plain reference count, only for objects that never leave the thread that owns them) and are created using `mIntrusivePointer_Allocate`.
+// As the reference count is part of the object, a raw pointer to it can always be turned back into an owning `mIntrusivePointer`.
+
+template <typename TReferenceCount>
+struct mIntrusiveReferenceCount
+{
+  TReferenceCount referenceCount;
+  mAllocator *pAllocator;
+  void (*pDestroyFunction)(mIntrusiveReferenceCount<TReferenceCount> *pObject);
+  void (*pCleanupFunction)(); // The actual cleanup function of the allocated type. Cast back by `pDestroyFunction`.
+};
+
+typedef mIntrusiveReferenceCount<std::atomic<size_t>> mRefCounted;
+typedef mIntrusiveReferenceCount<size_t> mLocalRefCounted;
+
+template <typename T>
+class mIntrusivePointer
+{
+public:
+  mIntrusivePointer();
+  mIntrusivePointer(nullptr_t);
+
+  // Acquires an additional reference to an object that has been created with `mIntrusivePointer_Allocate`.
+  explicit mIntrusivePointer(T *pData);
+
+  mIntrusivePointer(const mIntrusivePointer<T> &copy);
+  mIntrusivePointer(mIntrusivePointer<T> &&move);
+
+  template <typename T2, typename std::enable_if<!std::is_same<T, T2>::value && (std::is_base_of<T2, T>::value || std::is_base_of<T, T2>::value)>::type* = nullptr>
+  explicit mIntrusivePointer(const mIntrusivePointer<T2> &copy);
+
+  template <typename T2, typename std::enable_if<!std::is_same<T, T2>::value && (std::is_base_of<T2, T>::value || std::is_base_of<T, T2>::value)>::type* = nullptr>
+  explicit mIntrusivePointer(mIntrusivePointer<T2> &&move);
+
+  ~mIntrusivePointer();
+
+  mIntrusivePointer<T> & operator = (const mIntrusivePointer<T> &copy);
+  mIntrusivePointer<T> & operator = (mIntrusivePointer<T> &&move);
+
+  T * operator -> ();
+  const T * operator -> () const;
+  T & operator * ();
+  const T & operator * () const;
+
+  bool operator == (const mIntrusivePointer<T> &other) const;
+  bool operator == (nullptr_t) const;
+  bool operator != (const mIntrusivePointer<T> &other) const;
+  bool operator != (nullptr_t) const;
+
+  operator bool() const;
+  bool operator !() const;
+
+  const T * GetPointer() const;
+  T * GetPointer();
+  size_t GetReferenceCount() const;
+
+  T *m_pData;
+};
+
+template <typename T>
+using mIntrusivePtr = mIntrusivePointer<T>;
+
+template <typename T>
+mFUNCTION(mIntrusivePointer_Allocate, OUT mIntrusivePointer<T> *pPointer, IN OPTIONAL mAllocator *pAllocator, OPTIONAL void (*pCleanupFunction)(T *) = nullptr);
+
+template <typename T>
+mFUNCTION(mIntrusivePointer_Destroy, IN_OUT mIntrusivePointer<T> *pPointer);
+
+//////////////////////////////////////////////////////////////////////////
+
+inline void mIntrusivePointer_AddReference_Internal(std::atomic<size_t> &referenceCount)
+{
+  // Acquiring a new reference requires an existing one, so this doesn't have to be ordered with anything.
+  referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline size_t mIntrusivePointer_RemoveReference_Internal(std::atomic<size_t> &referenceCount)
+{
+  return referenceCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+}
+
+inline void mIntrusivePointer_AddReference_Internal(size_t &referenceCount)
+{
+  ++referenceCount;
+}
+
+inline size_t mIntrusivePointer_RemoveReference_Internal(size_t &referenceCount)
+{
+  return --referenceCount;
+}
+
+template <typename T, typename TReferenceCount>
+void mIntrusivePointer_Destroy_Internal(mIntrusiveReferenceCount<TReferenceCount> *pObject)
+{
+  T *pData = static_cast<T *>(pObject);
+  mAllocator *pAllocator = pObject->pAllocator;
+
+  if (pObject->pCleanupFunction != nullptr)
+    reinterpret_cast<void (*)(T *)>(pObject->pCleanupFunction)(pData);
+
+  pObject->referenceCount.~TReferenceCount();
+
+  mAllocator_FreePtr(pAllocator, &pData);
+}
+
+template <typename T>
+inline mFUNCTION(mIntrusivePointer_Allocate, OUT mIntrusivePointer<T> *pPointer, IN OPTIONAL mAllocator *pAllocator, OPTIONAL void (*pCleanupFunction)(T *) /* = nullptr */)
+{
+  mFUNCTION_SETUP();
+
+  typedef typename std::remove_cv<decltype(T::referenceCount)>::type TReferenceCount;
+  mSTATIC_ASSERT((std::is_base_of<mIntrusiveReferenceCount<TReferenceCount>, T>::value), "Type has to inherit from `mRefCounted` or `mLocalRefCounted`.");
+
+  mERROR_IF(pPointer == nullptr, mR_ArgumentNull);
+
+  *pPointer = nullptr;
+
+  T *pData = nullptr;
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pData, 1));
+
+  mIntrusiveReferenceCount<TReferenceCount> *pObject = pData;
+
+  new (&pObject->referenceCount) TReferenceCount(1);
+  pObject->pAllocator = pAllocator;
+  pObject->pDestroyFunction = mIntrusivePointer_Destroy_Internal<T, TReferenceCount>;
+  pObject->pCleanupFunction = reinterpret_cast<void (*)()>(pCleanupFunction);
+
+  // The reference acquired above is handed over to the pointer.
+  pPointer->m_pData = pData;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+inline mFUNCTION(mIntrusivePointer_Destroy, IN_OUT mIntrusivePointer<T> *pPointer)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pPointer == nullptr, mR_ArgumentNull);
+
+  *pPointer = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline mIntrusivePointer<T>::mIntrusivePointer() :
+  m_pData(nullptr)
+{ }
+
+template <typename T>
+inline mIntrusivePointer<T>::mIntrusivePointer(nullptr_t) :
+  m_pData(nullptr)
+{ }
+
+template <typename T>
+inline mIntrusivePointer<T>::mIntrusivePointer(T *pData) :
+  m_pData(pData)
+{
+  if (m_pData != nullptr)
+    mIntrusivePointer_AddReference_Internal(m_pData->referenceCount);
+}
+
+template <typename T>
+inline mIntrusivePointer<T>::mIntrusivePointer(const mIntrusivePointer<T> &copy) :
+  m_pData(copy.m_pData)
+{
+  if (m_pData != nullptr)
+    mIntrusivePointer_AddReference_Internal(m_pData->referenceCount);
+}
+
+template <typename T>
+inline mIntrusivePointer<T>::mIntrusivePointer(mIntrusivePointer<T> &&move) :
+  m_pData(move.m_pData)
+{
+  move.m_pData = nullptr;
+}
+
+template <typename T>
+template <typename T2, typename std::enable_if<!std::is_same<T, T2>::value && (std::is_base_of<T2, T>::value || std::is_base_of<T, T2>::value)>::type*>
+inline mIntrusivePointer<T>::mIntrusivePointer(const mIntrusivePointer<T2> &copy) :
+  m_pData(static_cast<T *>(copy.m_pData))
+{
+  if (m_pData != nullptr)
+    mIntrusivePointer_AddReference_Internal(m_pData->referenceCount);
+}
+
+template <typename T>
+template <typename T2, typename std::enable_if<!std::is_same<T, T2>::value && (std::is_base_of<T2, T>::value || std::is_base_of<T, T2>::value)>::type*>
+inline mIntrusivePointer<T>::mIntrusivePointer(mIntrusivePointer<T2> &&move) :
+  m_pData(static_cast<T *>(move.m_pData))
+{
+  move.m_pData = nullptr;
+}
+
+template <typename T>
+inline mIntrusivePointer<T>::~mIntrusivePointer()
+{
+  if (m_pData == nullptr)
+    return;
+
+  T *pData = m_pData;
+  m_pData = nullptr;
+
+  // The destroy function has been set by the allocating type, so derived types are cleaned up correctly even if this is a pointer to their base.
+  if (mIntrusivePointer_RemoveReference_Internal(pData->referenceCount) == 0)
+    pData->pDestroyFunction(pData);
+}
+
+template <typename T>
+inline mIntrusivePointer<T> & mIntrusivePointer<T>::operator=(const mIntrusivePointer<T> &copy)
+{
+  if (copy.m_pData == m_pData)
+    return *this;
+
+  this->~mIntrusivePointer();
+
+  m_pData = copy.m_pData;
+
+  if (m_pData != nullptr)
+    mIntrusivePointer_AddReference_Internal(m_pData->referenceCount);
+
+  return *this;
+}
+
+template <typename T>
+inline mIntrusivePointer<T> & mIntrusivePointer<T>::operator=(mIntrusivePointer<T> &&move)
+{
+  if (&move == this)
+    return *this;
+
+  this->~mIntrusivePointer();
+
+  m_pData = move.m_pData;
+  move.m_pData = nullptr;
+
+  return *this;
+}
+
+template <typename T>
+inline T * mIntrusivePointer<T>::operator->()
+{
+  return m_pData;
+}
+
+template <typename T>
+inline const T * mIntrusivePointer<T>::operator->() const
+{
+  return m_pData;
+}
+
+template <typename T>
+inline T & mIntrusivePointer<T>::operator*()
+{
+  return *m_pData;
+}
+
+template <typename T>
+inline const T & mIntrusivePointer<T>::operator*() const
+{
+  return *m_pData;
+}
+
+template <typename T>
+inline bool mIntrusivePointer<T>::operator==(const mIntrusivePointer<T> &other) const
+{
+  return m_pData == other.m_pData;
+}
+
+template <typename T>
+inline bool mIntrusivePointer<T>::operator==(nullptr_t) const
+{
+  return m_pData == nullptr;
+}
+
+template <typename T>
+inline bool mIntrusivePointer<T>::operator!=(const mIntrusivePointer<T> &other) const
+{
+  return m_pData != other.m_pData;
+}
+
+template <typename T>
+inline bool mIntrusivePointer<T>::operator!=(nullptr_t) const
+{
+  return m_pData != nullptr;
+}
+
+template <typename T>
+inline mIntrusivePointer<T>::operator bool() const
+{
+  return m_pData != nullptr;
+}
+
+template <typename T>
+inline bool mIntrusivePointer<T>::operator!() const
+{
+  return m_pData == nullptr;
+}
+
+template <typename T>
+inline const T * mIntrusivePointer<T>::GetPointer() const
+{
+  return m_pData;
+}
+
+template <typename T>
+inline T * mIntrusivePointer<T>::GetPointer()
+{
+  return m_pData;
+}
+
+template <typename T>
+inline size_t mIntrusivePointer<T>::GetReferenceCount() const
+{
+  if (m_pData == nullptr)
+    return 0;
+
+  return (size_t)m_pData->referenceCount;
+}
+
+#endif // mIntrusivePointer_h__
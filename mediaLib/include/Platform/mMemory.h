@@ -25,6 +25,12 @@ _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CR
 _Success_(return != 0) _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_realloc(_Pre_maybenull_ _Post_invalid_ void *pBlock, _In_ const size_t size, _In_ const size_t oldSize, _In_ const size_t alignment);
 void __cdecl _m_internal_free_aligned(_Pre_maybenull_ _Post_invalid_ void *pBlock);
 
+_Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_alloc(_In_ const size_t size);
+_Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_alloc_zero(_In_ const size_t size);
+_Success_(return != 0) _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_realloc(_Pre_maybenull_ _Post_invalid_ void *pBlock, _In_ const size_t size);
+void __cdecl _m_internal_pooled_free(_Pre_maybenull_ _Post_invalid_ void *pBlock);
+size_t _m_internal_pooled_usable_size(_In_opt_ void *pBlock);
+
 template <typename T>
 void mSetToNullptr(T **ppData)
 {
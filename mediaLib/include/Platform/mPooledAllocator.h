@@ -0,0 +1,43 @@
+#ifndef mPooledAllocator_h__
+#define mPooledAllocator_h__
+
+#include "mediaLib.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "OoNW8v4BdCUgqtvqLFncPMAR/a1FhY8QWQlx04OJEclGmQuX2nIZ1d3Pp2jHPgQhj+CpqjoPko8/3qXO"
+#endif
+
+// Allocator for many small, short-lived allocations. Allocations are served from thread local caches of size classes (rpmalloc), regardless of whether or not the default allocator uses it process-wide.
+// Debug builds fall back to `malloc`. Memory has to be freed through an allocator that was created by `mPooledAllocator_Create` (or `mPooledAllocator`).
+// Statistics are tracked per allocator instance, so separate instances can be used to account for the memory of separate subsystems.
+
+constexpr size_t mPooledAllocator_SmallSizeClassCount = 64; // in 16 byte steps up to 1 KiB.
+constexpr size_t mPooledAllocator_MediumSizeClassCount = 5; // powers of two up to 32 KiB.
+constexpr size_t mPooledAllocator_SizeClassCount = mPooledAllocator_SmallSizeClassCount + mPooledAllocator_MediumSizeClassCount + 1; // the last size class contains all larger allocations.
+
+extern mAllocator mPooledAllocator; // Process-wide instance that tracks statistics.
+
+struct mPooledAllocator_Statistics
+{
+  size_t liveBytes; // usable size of all allocations that haven't been freed yet.
+  size_t highWaterMarkBytes; // only updated every 64 KiB of change per shard, so short peaks may be missed by up to 64 KiB per shard.
+  size_t liveAllocationCount;
+  size_t totalAllocationCount;
+  size_t liveAllocationCountPerSizeClass[mPooledAllocator_SizeClassCount];
+  size_t totalAllocationCountPerSizeClass[mPooledAllocator_SizeClassCount];
+};
+
+// `pAllocator` has to be destroyed with `mAllocator_Destroy` after all of its allocations have been freed.
+mFUNCTION(mPooledAllocator_Create, OUT mAllocator *pAllocator, const bool trackStatistics = true);
+
+// Returns `mR_ResourceStateInvalid` if the allocator doesn't track statistics.
+mFUNCTION(mPooledAllocator_GetStatistics, IN mAllocator *pAllocator, OUT mPooledAllocator_Statistics *pStatistics);
+mFUNCTION(mPooledAllocator_ResetHighWaterMark, IN mAllocator *pAllocator);
+
+size_t mPooledAllocator_GetSizeClass(const size_t bytes);
+size_t mPooledAllocator_GetSizeClassMaxBytes(const size_t sizeClass); // Returns `SIZE_MAX` for the last size class.
+
+#endif // mPooledAllocator_h__
@@ -10,83 +10,277 @@
   #define __M_FILE__ "Da+ha1ASTY4vXT0NRFALTtpfjqZIFX16JTNdyd7AUrqjnpxUB1x7iMePHZF3O73+RjvE6bjXJcbWxZo3"
 #endif
 
-// There can only be one global profiler which the `mProfiler_ReportEventStart` and `mProfiler_ReportEventEnd` functions report to. The Profiler cannot be freed because other processes might still be writing to it.
-// The Profiler has a fixed amount of events that can be reported until it loops around or is disabled.
+#include <atomic>
 
-#define mPROFILER_MAX_NAME_LENGHT 64
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+ #define mPROFILER_USE_RDTSC 1
+
+ #ifdef _MSC_VER
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#elif !defined(mPLATFORM_WINDOWS)
+ #include <time.h>
+#endif
+
+// There can only be one global profiler which the `mProfiler_ReportEventStart` and `mProfiler_ReportEventEnd` functions report to. The Profiler cannot be freed because other threads might still be writing to it.
+// Every thread records into its own ring buffer of a fixed amount of events that loops around. Nothing is shared between threads when reporting events, apart from reading the global state.
+// Names are interned once and cached per thread by their address, so names passed as `const char *` must not change their contents while profiling (string literals are fine). Use `mProfiler_InternName` for names that are built at runtime.
+
+typedef uint32_t mProfiler_NameId; // `0` is never a valid name id.
+
+constexpr uint32_t mProfiler_CurrentThread = (uint32_t)-1; // Uses `mProfiler_GetCurrentThreadId` of the reporting thread.
+constexpr size_t mProfiler_NameCacheSize = 64;
+constexpr size_t mProfiler_MaxAggregationDepth = 64; // Deeper nested events aren't aggregated.
+constexpr size_t mProfiler_StatisticsChunkSize = 32;
+constexpr size_t mProfiler_StatisticsChunkCount = 512; // Only the first `mProfiler_StatisticsChunkSize * mProfiler_StatisticsChunkCount` interned names can be aggregated.
+constexpr size_t mProfiler_HistogramBucketCount = 256; // 4 buckets per power of two.
+
+enum mProfiler_RecordType : uint8_t
+{
+  mP_RT_EventStart,
+  mP_RT_EventEnd,
+  mP_RT_Counter,
+  mP_RT_FlowStart,
+  mP_RT_FlowEnd,
+};
 
 struct mProfiler_Record
 {
-  char name[mPROFILER_MAX_NAME_LENGHT];
-  size_t eventTime;
+  uint64_t timestamp; // in ticks of `mProfiler_GetTimestamp`.
+  mProfiler_NameId nameId;
   uint32_t asyncOrThreadIndex;
-  bool eventStart;
+  int64_t value; // the value of `mP_RT_Counter` or the flow id of `mP_RT_FlowStart` and `mP_RT_FlowEnd`.
+  mProfiler_RecordType type;
 };
 
-struct mProfiler
+struct mProfiler_NameCacheEntry
+{
+  const char *name;
+  mProfiler_NameId nameId;
+};
+
+// Only ever written by the thread that owns the statistics, so reading them from other threads never blocks the owner.
+struct mProfiler_EventStatistics
+{
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> totalTicks;
+  std::atomic<uint64_t> minTicks;
+  std::atomic<uint64_t> maxTicks;
+  std::atomic<uint32_t> histogram[mProfiler_HistogramBucketCount];
+};
+
+struct mProfiler_AggregationStackEntry
+{
+  uint64_t timestamp;
+  mProfiler_NameId nameId;
+};
+
+struct mProfiler_ThreadBuffer
 {
-  volatile int64_t enabled; // zero if not enabled, non-zero if enabled.
   mProfiler_Record *pRecords;
-  size_t count;
-  volatile int64_t index;
+  std::atomic<uint64_t> writeIndex; // only ever written by the owning thread.
+  size_t capacityMask;
+  uint64_t generation;
+  uint32_t threadId;
+  std::atomic<bool> isOwned; // buffers of threads that have exited are reused by new threads.
+  mProfiler_ThreadBuffer *pNext;
+  mProfiler_NameCacheEntry nameCache[mProfiler_NameCacheSize];
+
+  size_t aggregationDepth;
+  mProfiler_AggregationStackEntry aggregationStack[mProfiler_MaxAggregationDepth];
+  std::atomic<mProfiler_EventStatistics *> pStatisticsChunks[mProfiler_StatisticsChunkCount]; // indexed by `nameId / mProfiler_StatisticsChunkSize`, allocated lazily.
+};
+
+struct mProfiler
+{
+  std::atomic<bool> enabled;
+  std::atomic<bool> aggregate; // Whether or not durations of events are aggregated into `mProfiler_EventStatistics`.
+  std::atomic<uint64_t> generation; // Incremented by `mProfiler_Allocate` and `mProfiler_Reset`. Thread buffers of older generations are discarded.
+  size_t count; // Events per thread.
+  double_t ticksPerNs; // Calibrated once in `mProfiler_Allocate`.
 };
 
 extern mProfiler _GlobalProfiler;
+extern thread_local mProfiler_ThreadBuffer *_mProfiler_pThreadBuffer;
 
 //////////////////////////////////////////////////////////////////////////
 
-// `eventCount`: must be a power of two.
+// `eventCount`: must be a power of two. This is the number of events that can be stored per thread.
 mFUNCTION(mProfiler_Allocate, const size_t eventCount);
 
 mFUNCTION(mProfiler_Enable);
 mFUNCTION(mProfiler_Disable);
 mFUNCTION(mProfiler_Reset);
 
+// Merges the buffers of all threads.
 mFUNCTION(mProfiler_WriteToChromiumTraceEventFile, const mString &filename);
 
+// Aggregation of event durations per name (for events reported on the current thread).
+// Aggregation happens while recording and is independent of the ring buffers, so statistics don't lose events when the buffers wrap around.
+mFUNCTION(mProfiler_EnableAggregation);
+mFUNCTION(mProfiler_DisableAggregation);
+
+// Statistics may be slightly inconsistent if events are reported concurrently.
+mFUNCTION(mProfiler_ResetStatistics);
+
+struct mProfiler_Statistics
+{
+  mProfiler_NameId nameId;
+  size_t count;
+  double_t totalNs, minNs, maxNs;
+  double_t p50Ns, p99Ns; // Estimated from histograms with 4 buckets per power of two.
+};
+
+// Returns `mR_ResourceNotFound` if no event with that name has been aggregated.
+mFUNCTION(mProfiler_GetStatistics, const mProfiler_NameId nameId, OUT mProfiler_Statistics *pStatistics);
+mFUNCTION(mProfiler_GetStatistics, IN const char *name, OUT mProfiler_Statistics *pStatistics);
+
+// Calls `callback` for every name with at least one aggregated event.
+mFUNCTION(mProfiler_ForEachStatistics, const std::function<mResult(const mProfiler_Statistics &statistics)> &callback);
+
+// Returns `0` if the name could not be interned.
+mProfiler_NameId mProfiler_InternName(const char *name);
+const char * mProfiler_GetName(const mProfiler_NameId nameId);
+
+// Returns the OS thread id of the calling thread.
+uint32_t mProfiler_GetCurrentThreadId();
+
 //////////////////////////////////////////////////////////////////////////
 
-// Maximum Name Length: mPROFILER_MAX_NAME_LENGHT
-inline void mProfiler_ReportEventStart(const char *name, const uint32_t asyncOrThreadIndex = GetCurrentThreadId())
+inline uint64_t mProfiler_GetTimestamp()
+{
+#if defined(mPROFILER_USE_RDTSC)
+  return __rdtsc(); // Assumes an invariant TSC, which every x64 cpu of the last decade has.
+#elif defined(mPLATFORM_WINDOWS)
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)counter.QuadPart;
+#else
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t)time.tv_sec * 1000000000ULL + (uint64_t)time.tv_nsec;
+#endif
+}
+
+inline double_t mProfiler_TicksToNs(const uint64_t ticks)
 {
-  if (_GlobalProfiler.enabled == 0 || _GlobalProfiler.pRecords == nullptr)
+  return ticks / _GlobalProfiler.ticksPerNs;
+}
+
+mProfiler_ThreadBuffer * mProfiler_AcquireThreadBuffer_Internal();
+mProfiler_NameId mProfiler_CacheNameId_Internal(mProfiler_ThreadBuffer *pBuffer, const char *name);
+void mProfiler_Aggregate_Internal(mProfiler_ThreadBuffer *pBuffer, const mProfiler_NameId nameId, const mProfiler_RecordType type, const uint64_t timestamp);
+
+inline mProfiler_ThreadBuffer * mProfiler_GetThreadBuffer_Internal()
+{
+  mProfiler_ThreadBuffer *pBuffer = _mProfiler_pThreadBuffer;
+
+  if (pBuffer == nullptr || pBuffer->generation != _GlobalProfiler.generation.load(std::memory_order_relaxed))
+    pBuffer = mProfiler_AcquireThreadBuffer_Internal();
+
+  return pBuffer;
+}
+
+inline void mProfiler_AddRecord_Internal(mProfiler_ThreadBuffer *pBuffer, const mProfiler_NameId nameId, const uint32_t asyncOrThreadIndex, const mProfiler_RecordType type, const int64_t value = 0)
+{
+  const uint64_t index = pBuffer->writeIndex.load(std::memory_order_relaxed);
+  mProfiler_Record &record = pBuffer->pRecords[index & pBuffer->capacityMask];
+
+  const uint64_t timestamp = mProfiler_GetTimestamp();
+
+  record.timestamp = timestamp;
+  record.nameId = nameId;
+  record.asyncOrThreadIndex = (asyncOrThreadIndex == mProfiler_CurrentThread) ? pBuffer->threadId : asyncOrThreadIndex;
+  record.value = value;
+  record.type = type;
+
+  pBuffer->writeIndex.store(index + 1, std::memory_order_release);
+
+  if (type <= mP_RT_EventEnd && asyncOrThreadIndex == mProfiler_CurrentThread && _GlobalProfiler.aggregate.load(std::memory_order_relaxed))
+    mProfiler_Aggregate_Internal(pBuffer, nameId, type, timestamp);
+}
+
+inline mProfiler_NameId mProfiler_GetCachedNameId_Internal(mProfiler_ThreadBuffer *pBuffer, const char *name)
+{
+  const mProfiler_NameCacheEntry &cacheEntry = pBuffer->nameCache[(reinterpret_cast<size_t>(name) >> 3) & (mProfiler_NameCacheSize - 1)];
+
+  return (cacheEntry.name == name) ? cacheEntry.nameId : mProfiler_CacheNameId_Internal(pBuffer, name);
+}
+
+inline void mProfiler_Report_Internal(const char *name, const uint32_t asyncOrThreadIndex, const mProfiler_RecordType type, const int64_t value = 0)
+{
+  if (!_GlobalProfiler.enabled.load(std::memory_order_relaxed))
     return;
 
-  const size_t index = (_InterlockedIncrement64(&_GlobalProfiler.index) - 1) & (_GlobalProfiler.count - 1);
+  mProfiler_ThreadBuffer *pBuffer = mProfiler_GetThreadBuffer_Internal();
+
+  if (pBuffer == nullptr)
+    return;
 
-  _GlobalProfiler.pRecords[index].eventTime = mGetCurrentTimeNs();
-  _GlobalProfiler.pRecords[index].eventStart = true;
-  _GlobalProfiler.pRecords[index].asyncOrThreadIndex = asyncOrThreadIndex;
-  
-  const size_t stringLength = strnlen(name, mPROFILER_MAX_NAME_LENGHT - 1);
+  const mProfiler_NameId nameId = mProfiler_GetCachedNameId_Internal(pBuffer, name);
+
+  if (nameId == 0)
+    return;
 
-  memcpy(_GlobalProfiler.pRecords[index].name, name, stringLength);
-  _GlobalProfiler.pRecords[index].name[stringLength] = '\0';
-  _GlobalProfiler.pRecords[index].name[mPROFILER_MAX_NAME_LENGHT - 1] = '\0';
+  mProfiler_AddRecord_Internal(pBuffer, nameId, asyncOrThreadIndex, type, value);
 }
 
-inline void mProfiler_ReportEventEnd(const char *name, const uint32_t asyncOrThreadIndex = GetCurrentThreadId())
+inline void mProfiler_Report_Internal(const mProfiler_NameId nameId, const uint32_t asyncOrThreadIndex, const mProfiler_RecordType type, const int64_t value = 0)
 {
-  if (_GlobalProfiler.enabled == 0 || _GlobalProfiler.pRecords == nullptr)
+  if (!_GlobalProfiler.enabled.load(std::memory_order_relaxed))
     return;
 
-  const size_t index = (_InterlockedIncrement64(&_GlobalProfiler.index) - 1) & (_GlobalProfiler.count - 1);
+  mProfiler_ThreadBuffer *pBuffer = mProfiler_GetThreadBuffer_Internal();
 
-  _GlobalProfiler.pRecords[index].eventTime = mGetCurrentTimeNs();
-  _GlobalProfiler.pRecords[index].eventStart = false;
-  _GlobalProfiler.pRecords[index].asyncOrThreadIndex = asyncOrThreadIndex;
+  if (pBuffer == nullptr)
+    return;
+
+  mProfiler_AddRecord_Internal(pBuffer, nameId, asyncOrThreadIndex, type, value);
+}
+
+inline void mProfiler_ReportEventStart(const char *name, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(name, asyncOrThreadIndex, mP_RT_EventStart);
+}
 
-  const size_t stringLength = strnlen(name, mPROFILER_MAX_NAME_LENGHT - 1);
+inline void mProfiler_ReportEventEnd(const char *name, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(name, asyncOrThreadIndex, mP_RT_EventEnd);
+}
+
+inline void mProfiler_ReportEventStart(const mProfiler_NameId nameId, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(nameId, asyncOrThreadIndex, mP_RT_EventStart);
+}
 
-  memcpy(_GlobalProfiler.pRecords[index].name, name, stringLength);
-  _GlobalProfiler.pRecords[index].name[stringLength] = '\0';
-  _GlobalProfiler.pRecords[index].name[mPROFILER_MAX_NAME_LENGHT - 1] = '\0';
+inline void mProfiler_ReportEventEnd(const mProfiler_NameId nameId, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(nameId, asyncOrThreadIndex, mP_RT_EventEnd);
+}
+
+// Counters are displayed as a graph per name (e.g. queue depth, bytes allocated, frames decoded).
+inline void mProfiler_ReportCounter(const char *name, const int64_t value)
+{
+  mProfiler_Report_Internal(name, mProfiler_CurrentThread, mP_RT_Counter, value);
+}
+
+// Flows connect the events that enclose the flow start and flow end with an arrow, even across threads. `flowId` has to be unique for every flow with the same name.
+inline void mProfiler_ReportFlowStart(const char *name, const uint64_t flowId, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(name, asyncOrThreadIndex, mP_RT_FlowStart, (int64_t)flowId);
+}
+
+inline void mProfiler_ReportFlowEnd(const char *name, const uint64_t flowId, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread)
+{
+  mProfiler_Report_Internal(name, asyncOrThreadIndex, mP_RT_FlowEnd, (int64_t)flowId);
 }
 
 //////////////////////////////////////////////////////////////////////////
 
-void mProfiler_ReportEventStart_NoInline(const char *name, const uint32_t asyncOrThreadIndex = GetCurrentThreadId());
-void mProfiler_ReportEventEnd_NoInline(const char *name, const uint32_t asyncOrThreadIndex = GetCurrentThreadId());
+void mProfiler_ReportEventStart_NoInline(const char *name, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread);
+void mProfiler_ReportEventEnd_NoInline(const char *name, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread);
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -97,7 +291,7 @@ private:
   uint32_t asyncOrThreadIndex;
 
 public:
-  inline mScopedProfileEvent(const char *name, const uint32_t asyncOrThreadIndex = GetCurrentThreadId()) :
+  inline mScopedProfileEvent(const char *name, const uint32_t asyncOrThreadIndex = mProfiler_CurrentThread) :
     name(name),
     asyncOrThreadIndex(asyncOrThreadIndex)
   {
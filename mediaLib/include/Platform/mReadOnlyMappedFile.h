@@ -0,0 +1,37 @@
+#ifndef mReadOnlyMappedFile_h__
+#define mReadOnlyMappedFile_h__
+
+#include "mediaLib.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "47PlTgWko8faAWIRlwyi7xeyKyZfskopZArq2ZjSRG/G+8XnAvhSfz/ZdVYJS/o12Dax+XhndIP3bxrn"
+#endif
+
+// Maps an entire file read-only into the address space. Unlike `mMappedFile` this doesn't create (named) shared memory and works on all platforms.
+// Files larger than 4 GiB are supported on 64 bit platforms.
+
+enum mReadOnlyMappedFile_AccessPattern
+{
+  mROMF_AP_Normal,
+  mROMF_AP_Sequential, // Aggressive read-ahead, pages that have been read can be dropped early.
+  mROMF_AP_Random, // No read-ahead.
+};
+
+struct mReadOnlyMappedFile;
+
+mFUNCTION(mReadOnlyMappedFile_Create, OUT mPtr<mReadOnlyMappedFile> *pMappedFile, IN OPTIONAL mAllocator *pAllocator, const mString &filename, const mReadOnlyMappedFile_AccessPattern accessPattern = mROMF_AP_Normal);
+mFUNCTION(mReadOnlyMappedFile_Destroy, IN_OUT mPtr<mReadOnlyMappedFile> *pMappedFile);
+
+// `*ppData` stays valid until the mapped file is destroyed and must not be written to. Empty files return `nullptr`.
+mFUNCTION(mReadOnlyMappedFile_GetData, mPtr<mReadOnlyMappedFile> &mappedFile, OUT const uint8_t **ppData, OUT OPTIONAL size_t *pSize);
+mFUNCTION(mReadOnlyMappedFile_GetSize, mPtr<mReadOnlyMappedFile> &mappedFile, OUT size_t *pSize);
+
+mFUNCTION(mReadOnlyMappedFile_SetAccessPattern, mPtr<mReadOnlyMappedFile> &mappedFile, const mReadOnlyMappedFile_AccessPattern accessPattern);
+
+// Asynchronously starts reading the given range into memory, so touching it later doesn't stall on page faults.
+mFUNCTION(mReadOnlyMappedFile_Prefetch, mPtr<mReadOnlyMappedFile> &mappedFile, const size_t offset, const size_t size);
+
+#endif // mReadOnlyMappedFile_h__
@@ -109,6 +109,7 @@ public:
     uint8_t freeParameters : 1;
     mAllocator *pAllocator = nullptr;
     std::function<void (T*)> cleanupFunction = nullptr;
+    void (*pCleanupFunction)(T *) = nullptr; // Used instead of `cleanupFunction` if set. Doesn't require a `std::function` to be constructed, copied or called.
     void *pUserData = nullptr;
 
     PointerParams() :
@@ -482,6 +483,19 @@ inline mFUNCTION(mSharedPointer_Create, OUT mSharedPointer<T> *pOutSharedPointer
   mRETURN_SUCCESS();
 }
 
+// Captureless lambdas, function pointers and `nullptr` end up here, rather than being wrapped in a `std::function`.
+template <typename T, typename TCleanupFunction, typename std::enable_if<std::is_convertible<TCleanupFunction, void (*)(T *)>::value>::type* = nullptr>
+inline mFUNCTION(mSharedPointer_Create, OUT mSharedPointer<T> *pOutSharedPointer, IN T *pData, TCleanupFunction cleanupFunction, IN mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mSharedPointer_Create(pOutSharedPointer, pData, std::function<void(T *pData)>(nullptr), pAllocator));
+
+  pOutSharedPointer->m_pParams->pCleanupFunction = static_cast<void (*)(T *)>(cleanupFunction);
+
+  mRETURN_SUCCESS();
+}
+
 template <typename T>
 inline mFUNCTION(mSharedPointer_Create, OUT mReferencePack<T> *, IN T *, std::function<void(T *pData)>, IN mAllocator *)
 {
@@ -566,6 +580,25 @@ inline mFUNCTION(mSharedPointer_Allocate, OUT mSharedPointer<T> *pOutSharedPoint
   mRETURN_SUCCESS();
 }
 
+template <typename T, typename TCleanupFunction, typename std::enable_if<std::is_convertible<TCleanupFunction, void (*)(T *)>::value>::type* = nullptr>
+inline mFUNCTION(mSharedPointer_Allocate, OUT mSharedPointer<T> *pOutSharedPointer, IN mAllocator *pAllocator, TCleanupFunction cleanupFunction, const size_t count)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pOutSharedPointer == nullptr, mR_ArgumentNull);
+  mERROR_IF(count == 0, mR_ArgumentOutOfBounds);
+
+  T *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pData, count));
+
+  mERROR_CHECK(mSharedPointer_Create(pOutSharedPointer, pData, static_cast<void (*)(T *)>(cleanupFunction), pAllocator));
+
+  pData = nullptr; // to not get released on destruction.
+
+  mRETURN_SUCCESS();
+}
+
 template <typename T>
 inline mFUNCTION(mSharedPointer_Allocate, OUT mReferencePack<T> *, IN mAllocator *, const std::function<void(T *)> &, const size_t )
 {
@@ -868,7 +901,9 @@ inline mSharedPointer<T>::~mSharedPointer()
     mLOG("Destroying mSharedPointer<", typeid(T).name(), ">. (0x", mFUInt<mFHex>(m_pData), ")");
 #endif
 
-    if (m_pParams->cleanupFunction)
+    if (m_pParams->pCleanupFunction != nullptr)
+      m_pParams->pCleanupFunction(m_pData);
+    else if (m_pParams->cleanupFunction)
       m_pParams->cleanupFunction(m_pData);
 
     if (m_pParams)
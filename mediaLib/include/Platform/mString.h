@@ -14,6 +14,9 @@ constexpr size_t mString_MaxUtf16CharInUtf8Chars = 3;
 
 typedef int32_t mchar_t;
 
+template <typename T>
+struct mQueue;
+
 template <size_t TCount>
 mchar_t mToChar(const char c[TCount]);
 mchar_t mToChar(IN const char *c, const size_t size);
@@ -55,9 +58,16 @@ struct mUtf8StringIterator
 template <size_t TCount>
 struct mInplaceString;
 
+// Strings with up to `mString_InlineCapacity` bytes (including the null terminator) are stored inside the `mString` and don't allocate.
+constexpr size_t mString_InlineCapacity = 24;
+
+// Every `mString_CharIndex_Stride`th character offset is stored in the character index (see `mString_CreateCharIndex`).
+constexpr size_t mString_CharIndex_Stride = 64;
+
 struct mString
 {
-  char *text;
+  // `nullptr` if the string is empty or stored in `inlineText`. Use `c_str()` or `Data()` to access the text.
+  char *pText;
   mAllocator *pAllocator = &mDefaultAllocator;
   
   // Includes null terminator.
@@ -67,6 +77,13 @@ struct mString
   size_t count;
 
   size_t capacity;
+
+  union
+  {
+    char inlineText[mString_InlineCapacity]; // Only valid if `pText == nullptr`.
+    size_t *pCharIndex; // Byte offset of every `mString_CharIndex_Stride`th character. Only valid if `pText != nullptr`.
+  };
+
   bool hasFailed;
 
   mString();
@@ -117,7 +134,13 @@ struct mString
   mUtf8StringIterator begin() const;
   mUtf8StringIterator end() const;
 
-  inline const char * c_str() const { return text; };
+  inline const char * c_str() const { return Data(); };
+
+  // Writing to the text doesn't update `count` or the character index.
+  inline char * Data() const { return pText != nullptr ? pText : (capacity > 0 ? const_cast<char *>(inlineText) : nullptr); };
+
+  // All characters are single bytes, so characters can be indexed directly.
+  inline bool IsAscii() const { return count == bytes; };
 
   bool StartsWith(const mString &s) const;
   bool EndsWith(const mString &s) const;
@@ -146,8 +169,14 @@ mFUNCTION(mString_Format, OUT mString *pString, IN OPTIONAL mAllocator *pAllocat
 
 mFUNCTION(mString_Destroy, IN_OUT mString *pString);
 
+// Discards the character index.
 mFUNCTION(mString_Reserve, mString &string, const size_t size);
 
+// Stores the byte offset of every `mString_CharIndex_Stride`th character, so that `operator []` and `mString_Substring` don't have to iterate from the start of long non-ascii strings.
+// The index is discarded whenever the string is modified through `mString` functions and doesn't account for modifications through `Data()`.
+// Strings that are ascii-only or stored inline don't need an index.
+mFUNCTION(mString_CreateCharIndex, mString &string);
+
 mFUNCTION(mString_GetByteSize, const mString &string, OUT size_t *pSize);
 mFUNCTION(mString_GetCount, const mString &string, OUT size_t *pLength);
 
@@ -183,6 +212,9 @@ mFUNCTION(mString_EndsWith, const mString &stringA, const mString &end, OUT bool
 mFUNCTION(mString_FindFirst, const mString &string, const mString &find, OUT size_t *pStartChar, OUT bool *pContained);
 mFUNCTION(mString_Contains, const mString &stringA, const mString &contained, OUT bool *pContains);
 
+// Retrieves the start chars of all non-overlapping occurrences of `find`.
+mFUNCTION(mString_FindAll, const mString &string, const mString &find, OUT mPtr<mQueue<size_t>> *pStartChars, IN mAllocator *pAllocator);
+
 mFUNCTION(mString_RemoveChar, const mString &string, const mchar_t remove, OUT mString *pResult);
 mFUNCTION(mString_RemoveString, const mString &string, const mString &remove, OUT mString *pResult);
 
@@ -266,10 +298,10 @@ inline mFUNCTION(mString_Format, OUT mString *pString, IN OPTIONAL mAllocator *p
   mDEFER_ON_ERROR(mString_Destroy(pString));
 
   mERROR_CHECK(mString_Reserve(*pString, maxCapacity));
-  mERROR_CHECK(mFormatTo(pString->text, maxCapacity, args...));
+  mERROR_CHECK(mFormatTo(pString->Data(), maxCapacity, args...));
 
   size_t count, bytes;
-  mERROR_CHECK(mInplaceString_GetCount_Internal(pString->text, maxCapacity, &count, &bytes));
+  mERROR_CHECK(mInplaceString_GetCount_Internal(pString->Data(), maxCapacity, &count, &bytes));
 
   pString->count = count;
   pString->bytes = bytes;
@@ -287,11 +319,11 @@ mFUNCTION(mString_AppendFormat, mString &text, Args && ... args)
 
   mERROR_CHECK(mString_Reserve(text, bytesWithoutNullTerminator + maxAdditionalCapacity));
 
-  mDEFER_ON_ERROR(text.text[bytesWithoutNullTerminator] = '\0');
-  mERROR_CHECK(mFormatTo(text.text + bytesWithoutNullTerminator, maxAdditionalCapacity, args...));
+  mDEFER_ON_ERROR(text.Data()[bytesWithoutNullTerminator] = '\0');
+  mERROR_CHECK(mFormatTo(text.Data() + bytesWithoutNullTerminator, maxAdditionalCapacity, args...));
 
   size_t count, bytes;
-  mERROR_CHECK(mInplaceString_GetCount_Internal(text.text + bytesWithoutNullTerminator, maxAdditionalCapacity, &count, &bytes));
+  mERROR_CHECK(mInplaceString_GetCount_Internal(text.Data() + bytesWithoutNullTerminator, maxAdditionalCapacity, &count, &bytes));
 
   text.count = mMin(text.count, text.count - 1) + count;
   text.bytes = bytesWithoutNullTerminator + bytes;
@@ -459,7 +491,7 @@ bool mInplaceString<TCount>::operator == (const mString &other) const
   if (other.bytes != bytes || other.count != this->count || other.hasFailed)
     return false;
 
-  return mInplaceString_StringsAreEqual_Internal(text, other.text, bytes, count);
+  return mInplaceString_StringsAreEqual_Internal(text, other.c_str(), bytes, count);
 }
 
 template<size_t TCount>
@@ -475,7 +507,7 @@ inline mInplaceString<TCount>::operator const mString() const
 
   constString.bytes = bytes;
   constString.count = count;
-  constString.text = const_cast<char *>(text);
+  constString.pText = const_cast<char *>(text);
   constString.capacity = TCount;
   constString.pAllocator = mSHARED_POINTER_FOREIGN_RESOURCE;
 
@@ -569,7 +601,7 @@ inline mFUNCTION(mInplaceString_Create, OUT mInplaceString<TCount> *pStackString
 
   pStackString->bytes = text.bytes;
   pStackString->count = text.count;
-  mERROR_CHECK(mMemcpy(pStackString->text, text.text, pStackString->bytes));
+  mERROR_CHECK(mMemcpy(pStackString->text, text.c_str(), pStackString->bytes));
 
   mRETURN_SUCCESS();
 }
@@ -593,12 +625,12 @@ inline mFUNCTION(mString_Append, mString &text, const mInplaceString<TCount> &ap
   s.capacity = s.bytes = appendedText.bytes;
   s.count = appendedText.count;
   s.hasFailed = false;
-  s.text = const_cast<char *>(appendedText.text);
+  s.pText = const_cast<char *>(appendedText.text);
 
-  // Prevent from attempting to free `s.text`;
+  // Prevent from attempting to free `s.pText`;
   mDEFER(
     s.capacity = s.count = s.bytes = 0;
-    s.text = nullptr;
+    s.pText = nullptr;
   );
 
   mERROR_CHECK(mString_Append(text, s));
@@ -642,13 +674,13 @@ inline bool mString::operator==(const mInplaceString<T> &s) const
     return false;
 
   mString tmp;
-  tmp.text = const_cast<char *>(s.text);
+  tmp.pText = const_cast<char *>(s.text);
   tmp.capacity = tmp.bytes = s.bytes;
   tmp.count = s.count;
 
   const bool equal = (*this) == tmp;
 
-  tmp.text = nullptr;
+  tmp.pText = nullptr;
 
   return equal;
 }
@@ -39,6 +39,14 @@ mFUNCTION(mTask_Abort, IN mTask *pTask);
 mFUNCTION(mTask_GetResult, IN mTask *pTask, OUT mResult *pResult);
 mFUNCTION(mTask_GetState, IN mTask *pTask, OUT mTask_State *pTaskState);
 
+// `name` is reported to `mProfiler` whenever the task is executed and has to outlive the task.
+mFUNCTION(mTask_SetName, IN mTask *pTask, IN const char *name);
+
+// `pTask` will only be scheduled once `pDependency` has completed. Dependencies have to be added before `pTask` is enqueued.
+// A task with pending dependencies that's passed to `mThreadPool_EnqueueTask` is enqueued to that thread pool by the last dependency to complete, so the thread pool has to outlive it.
+// If a dependency fails or is aborted, `pTask` is aborted as well (taking over the failed result) and so are all of its own continuations.
+mFUNCTION(mTask_AddDependency, IN mTask *pTask, IN mTask *pDependency);
+
 template <class TFunction, class ...Args, class = typename std::enable_if<!std::is_same<typename std::decay<TFunction>::type, std::thread>::value>::type>
 mFUNCTION(mTask_Create, OUT mTask **ppTask, TFunction &&function, Args &&...args)
 {
@@ -65,12 +73,32 @@ enum mThreadPool_ThreadCount : size_t
   mTP_TC_DefaulThreadCount = 4,
 };
 
-mFUNCTION(mThreadPool_Create, OUT mPtr<mThreadPool> *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads = mThreadPool_ThreadCount::mTP_TC_NumberOfLogicalCores);
+enum mThreadPool_Mode
+{
+  mTP_M_SharedQueue, // All tasks are stored in a single queue that's shared between all worker threads.
+  mTP_M_WorkStealing, // Every worker thread owns a lock-free deque. Tasks enqueued from a worker thread are pushed to its own deque, idle workers steal from random victims.
+};
+
+mFUNCTION(mThreadPool_Create, OUT mPtr<mThreadPool> *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads = mThreadPool_ThreadCount::mTP_TC_NumberOfLogicalCores, const mThreadPool_Mode mode = mTP_M_SharedQueue);
 mFUNCTION(mThreadPool_Destroy, IN_OUT mPtr<mThreadPool> *pThreadPool);
 mFUNCTION(mThreadPool_Clear, mPtr<mThreadPool> &asyncTaskHandler);
 mFUNCTION(mThreadPool_EnqueueTask, mPtr<mThreadPool> &asyncTaskHandler, IN mTask *pTask);
 mFUNCTION(mThreadPool_GetThreadCount, mPtr<mThreadPool> &asyncTaskHandler, OUT size_t *pThreadCount);
 
+// Recursively splits `[rangeStart, rangeEnd)` into chunks of at most `grainSize` elements and calls `function` for every chunk.
+// The calling thread participates in processing the chunks and only returns once all of them have been processed, so this can safely be nested inside tasks.
+// If `grainSize` is `0` a grain size is chosen based on the number of worker threads. Returns the first error returned by `function`; chunks that haven't started yet will be skipped after a failure.
+// If chunks are discarded by `mThreadPool_Clear` or when the thread pool is destroyed, the remaining chunks are skipped and `mR_ResourceStateInvalid` is returned.
+mFUNCTION(mThreadPool_ParallelFor, mPtr<mThreadPool> &asyncTaskHandler, const size_t rangeStart, const size_t rangeEnd, const size_t grainSize, const std::function<mResult(const size_t chunkStart, const size_t chunkEnd)> &function);
+
+// Bands of rows are sized so that the data read and written for a band fits into a core's L2 cache.
+constexpr size_t mThreadPool_RowBandSize = 256 * 1024;
+
+// Splits `[0, height)` into bands of rows and calls `function` for every band. All bands but the last one contain a multiple of `rowAlignment` rows, so e.g. subsampled planes are never split inside a row pair.
+// `bytesPerRow` should contain the bytes read and written for a single row. If `asyncTaskHandler` is `nullptr`, the bands are processed in order on the calling thread.
+// At most one task per worker thread is started, which all pull bands from a shared counter, so the number of tasks doesn't grow with the number of bands.
+mFUNCTION(mThreadPool_ForEachRowBand, mPtr<mThreadPool> &asyncTaskHandler, const size_t height, const size_t rowAlignment, const size_t bytesPerRow, const std::function<mResult(const size_t rowStart, const size_t rowEnd)> &function);
+
 //////////////////////////////////////////////////////////////////////////
 
 // This provides the same functionality and performance from htCodec's thread pool.
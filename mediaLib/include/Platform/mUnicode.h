@@ -0,0 +1,37 @@
+#ifndef mUnicode_h__
+#define mUnicode_h__
+
+#include "mediaLib.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "NdfIxbagcm9CSNgsldwq0AcA7s9r7G/IExrFYKGBh61UrLu5Tm9Q9FzlV94u98o3ZuWbzHmaBCEbY25V"
+#endif
+
+// Bulk utf-8 validation and transcoding. Uses AVX2 or SSE4.1 kernels if the cpu supports them.
+// Overlong encodings, surrogate code points and code points above U+10FFFF are treated as invalid, just like unpaired surrogates in utf-16.
+// Invalid input results in `mR_InvalidParameter`, insufficient output buffers in `mR_IndexOutOfBounds`.
+// Null characters aren't treated specially, so the null terminator is only converted if it's included in the input size.
+
+bool mUtf8_Validate(IN const char *pUtf8, const size_t bytes, OUT OPTIONAL size_t *pCodePointCount = nullptr);
+
+// Validates the utf-8 text and retrieves the number of utf-16 code units needed to represent it.
+mFUNCTION(mUtf8_GetUtf16Count, IN const char *pUtf8, const size_t bytes, OUT size_t *pCount);
+
+mFUNCTION(mUtf8_ToUtf16, IN const char *pUtf8, const size_t bytes, OUT char16_t *pUtf16, const size_t capacity, OUT size_t *pCount);
+mFUNCTION(mUtf8_ToUtf32, IN const char *pUtf8, const size_t bytes, OUT char32_t *pUtf32, const size_t capacity, OUT size_t *pCount);
+
+mFUNCTION(mUtf16_ToUtf8, IN const char16_t *pUtf16, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount = nullptr);
+mFUNCTION(mUtf32_ToUtf8, IN const char32_t *pUtf32, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount = nullptr);
+
+// `wchar_t` is utf-16 on Windows and utf-32 everywhere else.
+// Just like `WideCharToMultiByte`, `mWide_ToUtf8` replaces unpaired surrogates and invalid code points with U+FFFD instead of failing.
+mFUNCTION(mUtf8_GetWideCount, IN const char *pUtf8, const size_t bytes, OUT size_t *pCount);
+mFUNCTION(mUtf8_ToWide, IN const char *pUtf8, const size_t bytes, OUT wchar_t *pWide, const size_t capacity, OUT size_t *pCount);
+mFUNCTION(mWide_ToUtf8, IN const wchar_t *pWide, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount = nullptr);
+
+constexpr size_t mUnicode_MaxWideCharInUtf8Chars = sizeof(wchar_t) == sizeof(char16_t) ? 3 : 4;
+
+#endif // mUnicode_h__
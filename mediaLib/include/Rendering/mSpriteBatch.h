@@ -3,6 +3,7 @@
 
 #include "mRenderParams.h"
 #include "mMesh.h"
+#include "mSoA.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -62,6 +63,7 @@ struct mSpriteBatch
   mPtr<mShader> shader;
   mPtr<mShader> multisampleShader;
   mPtr<mQueue<mSpriteBatch_Internal_RenderObject<Args...>>> enqueuedRenderObjects;
+  mSoA<float_t, size_t> sortKeys; // depth & index into `enqueuedRenderObjects`.
   mSpriteBatch_ShaderParams shaderParams;
 #if defined (mRENDERER_OPENGL)
   GLuint vao, vbo;
@@ -328,51 +328,33 @@ inline mFUNCTION(mSpriteBatch_Draw, mPtr<mSpriteBatch<Args...>> &spriteBatch, mT
   mRETURN_SUCCESS();
 }
 
-template <typename ...Args>
-mFUNCTION(mSpriteBatch_QuickSortRenderObjects, mPtr<mQueue<mSpriteBatch_Internal_RenderObject<Args...>>> &queue, const size_t left, const size_t right)
+// Only the compact depths and queue indices are moved around while sorting, the render objects themselves stay where they are.
+inline mFUNCTION(mSpriteBatch_QuickSortRenderObjects, mSoA<float_t, size_t> &sortKeys, const size_t left, const size_t right)
 {
   mFUNCTION_SETUP();
 
   if (left == right)
     mRETURN_SUCCESS();
 
+  const float_t *pDepth = sortKeys.Field<0>();
+
   size_t l = left;
   size_t r = right;
   const size_t pivotIndex = (left + right) / 2;
 
-  mSpriteBatch_Internal_RenderObject<Args...> *pRenderObject;
-  mERROR_CHECK(mQueue_PointerAt(queue, pivotIndex, &pRenderObject));
-
-  const float_t pivot = pRenderObject->position.z;
+  const float_t pivot = pDepth[pivotIndex];
 
   while (l <= r) 
   {
-    mSpriteBatch_Internal_RenderObject<Args...> *pRenderObjectL = nullptr;
-    mSpriteBatch_Internal_RenderObject<Args...> *pRenderObjectR = nullptr;
-
-    while (true)
-    {
-      mERROR_CHECK(mQueue_PointerAt(queue, l, &pRenderObjectL));
-
-      if (pRenderObjectL->position.z < pivot)
-        l++;
-      else
-        break;
-    }
+    while (pDepth[l] < pivot)
+      l++;
     
-    while (true)
-    {
-      mERROR_CHECK(mQueue_PointerAt(queue, r, &pRenderObjectR));
-
-      if (pRenderObjectR->position.z > pivot)
-        r--;
-      else
-        break;
-    }
+    while (pDepth[r] > pivot)
+      r--;
 
     if (l <= r) 
     {
-      std::swap(*pRenderObjectL, *pRenderObjectR);
+      mERROR_CHECK(mSoA_Swap(sortKeys, l, r));
 
       l++;
       r--;
@@ -380,10 +362,28 @@ mFUNCTION(mSpriteBatch_QuickSortRenderObjects, mPtr<mQueue<mSpriteBatch_Internal
   };
 
   if (left < r)
-    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(queue, left, r));
+    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(sortKeys, left, r));
 
   if (l < right)
-    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(queue, l, right));
+    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(sortKeys, l, right));
+
+  mRETURN_SUCCESS();
+}
+
+template <typename ...Args>
+mFUNCTION(mSpriteBatch_Internal_DestroyRenderObjects, mSpriteBatch<Args...> *pSpriteBatch)
+{
+  mFUNCTION_SETUP();
+
+  size_t count;
+  mERROR_CHECK(mQueue_GetCount(pSpriteBatch->enqueuedRenderObjects, &count));
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    mSpriteBatch_Internal_RenderObject<Args...> renderObject;
+    mERROR_CHECK(mQueue_PopFront(pSpriteBatch->enqueuedRenderObjects, &renderObject));
+    mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Destroy(&renderObject));
+  }
 
   mRETURN_SUCCESS();
 }
@@ -412,42 +412,35 @@ inline mFUNCTION(mSpriteBatch_End, mPtr<mSpriteBatch<Args...>> &spriteBatch)
     if (count == 0)
       mRETURN_SUCCESS();
 
-    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(spriteBatch->enqueuedRenderObjects, 0, count - 1));
+    mDEFER(mSpriteBatch_Internal_DestroyRenderObjects(spriteBatch.GetPointer()));
 
-    if (spriteBatch->spriteSortMode == mSpriteBatch_SpriteSortMode::mSB_SSM_BackToFront)
-    {
-      for (size_t i = 0; i < count; ++i)
-      {
-        mSpriteBatch_Internal_RenderObject<Args...> renderObject;
-        mERROR_CHECK(mQueue_PopFront(spriteBatch->enqueuedRenderObjects, &renderObject));
-        mDEFER_CALL(&renderObject, mSpriteBatch_Internal_RenderObject_Destroy);
-        mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Render(renderObject, spriteBatch));
-      }
-    }
-    else
+    // Sort a compact copy of the depths instead of swapping the render objects in the queue.
+    mERROR_CHECK(mSoA_Clear(spriteBatch->sortKeys));
+    mERROR_CHECK(mSoA_Reserve(spriteBatch->sortKeys, count));
+
+    for (size_t i = 0; i < count; ++i)
     {
-      for (int64_t i = (int64_t)count - 1; i >= 0; i--)
-      {
-        mSpriteBatch_Internal_RenderObject<Args...> renderObject;
-        mERROR_CHECK(mQueue_PopBack(spriteBatch->enqueuedRenderObjects, &renderObject));
-        mDEFER_CALL(&renderObject, mSpriteBatch_Internal_RenderObject_Destroy);
-        mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Render(renderObject, spriteBatch));
-      }
+      mSpriteBatch_Internal_RenderObject<Args...> *pRenderObject = nullptr;
+      mERROR_CHECK(mQueue_PointerAt(spriteBatch->enqueuedRenderObjects, i, &pRenderObject));
+      mERROR_CHECK(mSoA_PushBack(spriteBatch->sortKeys, pRenderObject->position.z, i));
     }
 
-  }
-  else
-  {
-    size_t count;
-    mERROR_CHECK(mQueue_GetCount(spriteBatch->enqueuedRenderObjects, &count));
+    mERROR_CHECK(mSpriteBatch_QuickSortRenderObjects(spriteBatch->sortKeys, 0, count - 1));
+
+    const size_t *pSortedIndices = spriteBatch->sortKeys.Field<1>();
+    const bool backToFront = (spriteBatch->spriteSortMode == mSpriteBatch_SpriteSortMode::mSB_SSM_BackToFront);
 
     for (size_t i = 0; i < count; ++i)
     {
-      mSpriteBatch_Internal_RenderObject<Args...> renderObject;
-      mERROR_CHECK(mQueue_PopFront(spriteBatch->enqueuedRenderObjects, &renderObject));
-      mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Destroy(&renderObject));
+      mSpriteBatch_Internal_RenderObject<Args...> *pRenderObject = nullptr;
+      mERROR_CHECK(mQueue_PointerAt(spriteBatch->enqueuedRenderObjects, pSortedIndices[backToFront ? i : count - 1 - i], &pRenderObject));
+      mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Render(*pRenderObject, spriteBatch));
     }
   }
+  else
+  {
+    mERROR_CHECK(mSpriteBatch_Internal_DestroyRenderObjects(spriteBatch.GetPointer()));
+  }
 
   mRETURN_SUCCESS();
 }
@@ -534,6 +527,7 @@ inline mFUNCTION(mSpriteBatch_Create_Internal, IN_OUT mSpriteBatch<Args...> *pSp
   mERROR_IF(pSpriteBatch == nullptr, mR_ArgumentNull);
 
   mERROR_CHECK(mQueue_Create(&pSpriteBatch->enqueuedRenderObjects, nullptr));
+  mERROR_CHECK(mSoA_Create(&pSpriteBatch->sortKeys, nullptr));
 
   pSpriteBatch->isStarted = false;
   pSpriteBatch->alphaMode = mSpriteBatch_AlphaMode::mSB_AM_AlphaBlend;
@@ -637,17 +631,9 @@ inline mFUNCTION(mSpriteBatch_Destroy_Internal, IN_OUT mSpriteBatch<Args...> *pS
     pSpriteBatch->vao = 0;
   }
 
-  size_t queueSize = 0;
-  mERROR_CHECK(mQueue_GetCount(pSpriteBatch->enqueuedRenderObjects, &queueSize));
-
-  for (size_t i = 0; i < queueSize; ++i)
-  {
-    mSpriteBatch_Internal_RenderObject<Args...> renderObject;
-    mERROR_CHECK(mQueue_PopFront(pSpriteBatch->enqueuedRenderObjects, &renderObject));
-    mERROR_CHECK(mSpriteBatch_Internal_RenderObject_Destroy(&renderObject));
-  }
-
+  mERROR_CHECK(mSpriteBatch_Internal_DestroyRenderObjects(pSpriteBatch));
   mERROR_CHECK(mQueue_Destroy(&pSpriteBatch->enqueuedRenderObjects));
+  mERROR_CHECK(mSoA_Destroy(&pSpriteBatch->sortKeys));
   mERROR_CHECK(mSharedPointer_Destroy(&pSpriteBatch->shader));
   mERROR_CHECK(mSharedPointer_Destroy(&pSpriteBatch->multisampleShader));
 
@@ -3,6 +3,7 @@
 
 #include "mRenderParams.h"
 #include "mImageBuffer.h"
+#include "mImagePyramid.h"
 #include "mResourceManager.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
@@ -19,6 +20,7 @@ struct mTexture
   mPixelFormatMapping pixelFormat;
   mRenderParams_UploadState uploadState = mRP_US_NotInitialized;
   mPtr<mImageBuffer> imageBuffer;
+  mPtr<mImagePyramid> imagePyramid;
 
 #if defined(mRENDERER_OPENGL)
   GLuint textureId;
@@ -35,6 +37,9 @@ mFUNCTION(mTexture_Create, OUT mTexture *pTexture, mPtr<mImageBuffer> &imageBuff
 mFUNCTION(mTexture_Create, OUT mTexture *pTexture, const mString &filename, const bool upload = true, const size_t textureUnit = 0, const mTexture2DParams &textureParams = mTexture2DParams());
 mFUNCTION(mTexture_Create, OUT mTexture *pTexture, const uint8_t *pData, const mVec2s &size, const mPixelFormatMapping pixelFormat = mPF_B8G8R8A8, const bool upload = true, const size_t textureUnit = 0, const mTexture2DParams &textureParams = mTexture2DParams());
 
+// Uploads every level of `imagePyramid` as a mip level instead of letting the driver generate them.
+mFUNCTION(mTexture_Create, OUT mTexture *pTexture, mPtr<mImagePyramid> &imagePyramid, const bool upload = true, const size_t textureUnit = 0, const mTexture2DParams &textureParams = mTexture2DParams());
+
 // This binds the texture to the specified texture unit.
 mFUNCTION(mTexture_CreateFromUnownedIndex, OUT mTexture *pTexture, int textureIndex, const size_t textureUnit = 0, const size_t sampleCount = 0);
 
@@ -48,6 +53,7 @@ mFUNCTION(mTexture_Bind, mTexture &texture, const size_t textureUnit = 0);
 mFUNCTION(mTexture_SetTo, mTexture &texture, mPtr<mImageBuffer> &imageBuffer, const bool upload = true);
 mFUNCTION(mTexture_SetTo, mTexture &texture, mPtr<mImageBuffer> &imageBuffer, const mPixelFormatMapping pixelFormatMapping, const bool upload);
 mFUNCTION(mTexture_SetTo, mTexture &texture, const uint8_t *pData, const mVec2s &size, const mPixelFormatMapping pixelFormat = mPF_B8G8R8A8, const bool upload = true);
+mFUNCTION(mTexture_SetTo, mTexture &texture, mPtr<mImagePyramid> &imagePyramid, const bool upload = true);
 
 mFUNCTION(mTexture_Download, mTexture &texture, OUT mPtr<mImageBuffer> *pImageBuffer, IN mAllocator *pAllocator, const mPixelFormat pixelFormat = mPF_R8G8B8A8);
 
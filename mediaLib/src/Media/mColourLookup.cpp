@@ -1,6 +1,9 @@
 #include "mColourLookup.h"
 #include "mFile.h"
 #include "mQueue.h"
+#include "mProfiler.h"
+
+#include <intrin.h>
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -9,7 +12,25 @@
   #define __M_FILE__ "7i1fMiMlihfUmO475fdfoo8P8x+ExWgNW3dx4SdnDn0TEzWzrVfbA8E939cVxWSuz39b+0HyBiB9gcq6"
 #endif
 
+struct mColourLookup_ApplyContext
+{
+  const float_t *pTable; // The lookup table with four floats per entry, so every entry can be loaded with a single load.
+  mVec3s resolution;
+  size_t strideR, strideG, strideB; // in floats.
+  mColourLookup_Interpolation interpolation;
+
+  uint8_t *pPixels;
+  size_t lineStride; // in bytes.
+  size_t width;
+  size_t channelCount, redIndex, blueIndex;
+
+  // Grid offset and fraction for every 8 bit value per axis.
+  size_t offsets[3][0x100];
+  float_t fractions[3][0x100];
+};
+
 static mFUNCTION(mColourLookup_Destroy_Internal, IN mColourLookup *pColourLookup);
+static void mColourLookup_ApplyToRows_Internal(const mColourLookup_ApplyContext &context, const size_t rowStart, const size_t rowEnd, const bool isFloat);
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -183,6 +204,124 @@ mFUNCTION(mColourLookup_At, mPtr<mColourLookup> &colourLookup, const mVec3f posi
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mColourLookup_ApplyToImage, mPtr<mColourLookup> &colourLookup, mPtr<mImageBuffer> &imageBuffer, const mColourLookup_Interpolation interpolation /* = mCL_I_Tetrahedral */)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mThreadPool> nullThreadPool = nullptr;
+  mERROR_CHECK(mColourLookup_ApplyToImage(colourLookup, imageBuffer, nullThreadPool, interpolation));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mColourLookup_ApplyToImage, mPtr<mColourLookup> &colourLookup, mPtr<mImageBuffer> &imageBuffer, mPtr<mThreadPool> &asyncTaskHandler, const mColourLookup_Interpolation interpolation /* = mCL_I_Tetrahedral */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(colourLookup == nullptr || imageBuffer == nullptr, mR_ArgumentNull);
+  mERROR_IF(colourLookup->pData == nullptr || imageBuffer->pPixels == nullptr, mR_NotInitialized);
+  mERROR_IF(colourLookup->resolution.x < 2 || colourLookup->resolution.y < 2 || colourLookup->resolution.z < 2, mR_ResourceStateInvalid);
+
+  mPROFILE_SCOPED("mColourLookup_ApplyToImage");
+
+  bool isFloat = false;
+  size_t channelCount = 0;
+  size_t redIndex = 0;
+
+  switch (imageBuffer->pixelFormat)
+  {
+  case mPF_R8G8B8A8:
+    channelCount = 4;
+    break;
+
+  case mPF_B8G8R8A8:
+    channelCount = 4;
+    redIndex = 2;
+    break;
+
+  case mPF_R8G8B8:
+    channelCount = 3;
+    break;
+
+  case mPF_B8G8R8:
+    channelCount = 3;
+    redIndex = 2;
+    break;
+
+  case mPF_Rf32Gf32Bf32:
+    channelCount = 3;
+    isFloat = true;
+    break;
+
+  case mPF_Rf32Gf32Bf32Af32:
+    channelCount = 4;
+    isFloat = true;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_NotSupported);
+  }
+
+  const size_t entryCount = colourLookup->resolution.x * colourLookup->resolution.y * colourLookup->resolution.z;
+
+  float_t *pTable = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pTable);
+  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pTable, entryCount * 4));
+
+  for (size_t i = 0; i < entryCount; i++)
+  {
+    pTable[i * 4 + 0] = colourLookup->pData[i].x;
+    pTable[i * 4 + 1] = colourLookup->pData[i].y;
+    pTable[i * 4 + 2] = colourLookup->pData[i].z;
+    pTable[i * 4 + 3] = 0;
+  }
+
+  mColourLookup_ApplyContext *pContext = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pContext);
+  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pContext, 1));
+
+  pContext->pTable = pTable;
+  pContext->resolution = colourLookup->resolution;
+  pContext->strideR = 4;
+  pContext->strideG = pContext->strideR * colourLookup->resolution.x;
+  pContext->strideB = pContext->strideG * colourLookup->resolution.y;
+  pContext->interpolation = interpolation;
+  pContext->pPixels = imageBuffer->pPixels;
+  pContext->lineStride = imageBuffer->lineStride * channelCount * (isFloat ? sizeof(float_t) : sizeof(uint8_t));
+  pContext->width = imageBuffer->currentSize.x;
+  pContext->channelCount = channelCount;
+  pContext->redIndex = redIndex;
+  pContext->blueIndex = 2 - redIndex;
+
+  if (!isFloat)
+  {
+    const size_t strides[3] = { pContext->strideR, pContext->strideG, pContext->strideB };
+
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+      const size_t maxIndex = colourLookup->resolution.asArray[axis] - 1;
+
+      for (size_t value = 0; value < 0x100; value++)
+      {
+        const float_t position = (float_t)(value * maxIndex) / 255.f;
+        const size_t index = mMin((size_t)position, maxIndex - 1);
+
+        pContext->offsets[axis][value] = index * strides[axis];
+        pContext->fractions[axis][value] = position - (float_t)index;
+      }
+    }
+  }
+
+  mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, imageBuffer->currentSize.y, 1, pContext->lineStride, [&](const size_t rowStart, const size_t rowEnd)
+  {
+    mColourLookup_ApplyToRows_Internal(*pContext, rowStart, rowEnd, isFloat);
+
+    return mR_Success;
+  }));
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mColourLookup_WriteToFile, mPtr<mColourLookup> &colourLookup, const mString &filename)
 {
   mFUNCTION_SETUP();
@@ -230,3 +369,163 @@ static mFUNCTION(mColourLookup_Destroy_Internal, IN mColourLookup *pColourLookup
 
   mRETURN_SUCCESS();
 }
+
+static mINLINE __m128 mColourLookup_Lerp_Internal(const __m128 a, const __m128 b, const __m128 factor)
+{
+  return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), factor));
+}
+
+static mINLINE __m128 mColourLookup_Interpolate_Internal(const mColourLookup_ApplyContext &context, const float_t *pCorner, const float_t fractionR, const float_t fractionG, const float_t fractionB)
+{
+  const size_t strideR = context.strideR;
+  const size_t strideG = context.strideG;
+  const size_t strideB = context.strideB;
+
+  if (context.interpolation == mCL_I_Tetrahedral)
+  {
+    // Walk from the first to the opposite corner of the cube along the axes in order of decreasing fraction.
+    size_t offset1, offset2;
+    float_t a, b, c;
+
+    if (fractionR >= fractionG)
+    {
+      if (fractionG >= fractionB)
+      {
+        offset1 = strideR;
+        offset2 = strideR + strideG;
+        a = fractionR;
+        b = fractionG;
+        c = fractionB;
+      }
+      else if (fractionR >= fractionB)
+      {
+        offset1 = strideR;
+        offset2 = strideR + strideB;
+        a = fractionR;
+        b = fractionB;
+        c = fractionG;
+      }
+      else
+      {
+        offset1 = strideB;
+        offset2 = strideR + strideB;
+        a = fractionB;
+        b = fractionR;
+        c = fractionG;
+      }
+    }
+    else
+    {
+      if (fractionB >= fractionG)
+      {
+        offset1 = strideB;
+        offset2 = strideG + strideB;
+        a = fractionB;
+        b = fractionG;
+        c = fractionR;
+      }
+      else if (fractionB >= fractionR)
+      {
+        offset1 = strideG;
+        offset2 = strideG + strideB;
+        a = fractionG;
+        b = fractionB;
+        c = fractionR;
+      }
+      else
+      {
+        offset1 = strideG;
+        offset2 = strideR + strideG;
+        a = fractionG;
+        b = fractionR;
+        c = fractionB;
+      }
+    }
+
+    const __m128 v0 = _mm_mul_ps(_mm_loadu_ps(pCorner), _mm_set1_ps(1.f - a));
+    const __m128 v1 = _mm_mul_ps(_mm_loadu_ps(pCorner + offset1), _mm_set1_ps(a - b));
+    const __m128 v2 = _mm_mul_ps(_mm_loadu_ps(pCorner + offset2), _mm_set1_ps(b - c));
+    const __m128 v3 = _mm_mul_ps(_mm_loadu_ps(pCorner + strideR + strideG + strideB), _mm_set1_ps(c));
+
+    return _mm_add_ps(_mm_add_ps(v0, v1), _mm_add_ps(v2, v3));
+  }
+  else
+  {
+    const __m128 factorR = _mm_set1_ps(fractionR);
+
+    const __m128 c00 = mColourLookup_Lerp_Internal(_mm_loadu_ps(pCorner), _mm_loadu_ps(pCorner + strideR), factorR);
+    const __m128 c10 = mColourLookup_Lerp_Internal(_mm_loadu_ps(pCorner + strideG), _mm_loadu_ps(pCorner + strideG + strideR), factorR);
+    const __m128 c01 = mColourLookup_Lerp_Internal(_mm_loadu_ps(pCorner + strideB), _mm_loadu_ps(pCorner + strideB + strideR), factorR);
+    const __m128 c11 = mColourLookup_Lerp_Internal(_mm_loadu_ps(pCorner + strideB + strideG), _mm_loadu_ps(pCorner + strideB + strideG + strideR), factorR);
+
+    const __m128 factorG = _mm_set1_ps(fractionG);
+
+    return mColourLookup_Lerp_Internal(mColourLookup_Lerp_Internal(c00, c10, factorG), mColourLookup_Lerp_Internal(c01, c11, factorG), _mm_set1_ps(fractionB));
+  }
+}
+
+static mINLINE void mColourLookup_GetGridPosition_Internal(const float_t value, const size_t resolution, const size_t stride, IN_OUT size_t *pOffset, OUT float_t *pFraction)
+{
+  const float_t position = mClamp(value, 0.f, 1.f) * (float_t)(resolution - 1);
+  const size_t index = mMin((size_t)position, resolution - 2);
+
+  *pOffset += index * stride;
+  *pFraction = position - (float_t)index;
+}
+
+static void mColourLookup_ApplyToRows_Internal(const mColourLookup_ApplyContext &context, const size_t rowStart, const size_t rowEnd, const bool isFloat)
+{
+  const size_t channelCount = context.channelCount;
+  const size_t redIndex = context.redIndex;
+  const size_t blueIndex = context.blueIndex;
+
+  if (isFloat)
+  {
+    for (size_t y = rowStart; y < rowEnd; y++)
+    {
+      float_t *pPixel = reinterpret_cast<float_t *>(context.pPixels + y * context.lineStride);
+
+      for (size_t x = 0; x < context.width; x++, pPixel += channelCount)
+      {
+        size_t offset = 0;
+        float_t fractionR, fractionG, fractionB;
+
+        mColourLookup_GetGridPosition_Internal(pPixel[0], context.resolution.x, context.strideR, &offset, &fractionR);
+        mColourLookup_GetGridPosition_Internal(pPixel[1], context.resolution.y, context.strideG, &offset, &fractionG);
+        mColourLookup_GetGridPosition_Internal(pPixel[2], context.resolution.z, context.strideB, &offset, &fractionB);
+
+        float_t colour[4];
+        _mm_storeu_ps(colour, mColourLookup_Interpolate_Internal(context, context.pTable + offset, fractionR, fractionG, fractionB));
+
+        pPixel[0] = colour[0];
+        pPixel[1] = colour[1];
+        pPixel[2] = colour[2];
+      }
+    }
+  }
+  else
+  {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(255.f);
+
+    for (size_t y = rowStart; y < rowEnd; y++)
+    {
+      uint8_t *pPixel = context.pPixels + y * context.lineStride;
+
+      for (size_t x = 0; x < context.width; x++, pPixel += channelCount)
+      {
+        const uint8_t r = pPixel[redIndex];
+        const uint8_t g = pPixel[1];
+        const uint8_t b = pPixel[blueIndex];
+
+        const float_t *pCorner = context.pTable + context.offsets[0][r] + context.offsets[1][g] + context.offsets[2][b];
+        const __m128 colour = mColourLookup_Interpolate_Internal(context, pCorner, context.fractions[0][r], context.fractions[1][g], context.fractions[2][b]);
+        const __m128i quantised = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(colour, maxValue), zero), maxValue));
+
+        pPixel[redIndex] = (uint8_t)_mm_cvtsi128_si32(quantised);
+        pPixel[1] = (uint8_t)_mm_extract_epi16(quantised, 2);
+        pPixel[blueIndex] = (uint8_t)_mm_extract_epi16(quantised, 4);
+      }
+    }
+  }
+}
@@ -14,9 +14,18 @@
 
 #include "turbojpeg.h"
 
+#include <csetjmp>
+#include <cstdio>
+#include "jpeglib.h"
+
 #define FPNG_RAW_PTRS
 #include "fpng.h"
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4752)
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 
 #ifdef GIT_BUILD // Define __M_FILE__
@@ -47,6 +56,50 @@ struct WriteFuncData
 static mFUNCTION(mImageBuffer_Create_Iternal, mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator);
 static mFUNCTION(mImageBuffer_Destroy_Iternal, mImageBuffer *pImageBuffer);
 
+struct mImageBuffer_ResizePlane
+{
+  const uint8_t *pSource;
+  size_t sourceStride; // in bytes.
+  mVec2s sourceSize;
+  uint8_t *pTarget;
+  size_t targetStride; // in bytes.
+  mVec2s targetSize;
+  size_t channelCount;
+  bool isFloat;
+};
+
+static mFUNCTION(mImageBuffer_GetResizeChannels_Internal, const mPixelFormat pixelFormat, OUT size_t *pChannelCount, OUT bool *pIsFloat);
+static mFUNCTION(mImageBuffer_ResizePlane_Internal, const mImageBuffer_ResizePlane &plane, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler);
+
+// Compressed bytes handed to libjpeg per read when decoding from a stream.
+constexpr size_t mImageBuffer_JpegStreamChunkSize = 64 * 1024;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4324) // `jmp_buf` is overaligned.
+#endif
+
+struct mImageBuffer_JpegDecoder
+{
+  jmp_buf errorJump;
+  jpeg_decompress_struct info;
+  jpeg_error_mgr errorManager;
+  jpeg_source_mgr source;
+  bool created;
+
+  const uint8_t *pData; // only set when decoding from memory.
+  mPtr<mCachedFileReader> *pCachedFileReader; // only set when decoding from a stream.
+  size_t dataSize;
+  size_t readPosition; // of the first byte after the data that has been handed to libjpeg.
+  mResult result; // set if reading from `pCachedFileReader` failed.
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+static mFUNCTION(mImageBuffer_DecodeJpeg_Internal, mPtr<mImageBuffer> &imageBuffer, mImageBuffer_JpegDecoder *pDecoder, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat);
+
 //////////////////////////////////////////////////////////////////////////
 
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator)
@@ -83,6 +136,59 @@ mFUNCTION(mImageBuffer_CreateFromData, OUT mPtr<mImageBuffer> *pImageBuffer, IN
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mImageBuffer_CreateFromFiles, mPtr<mAsyncFileQueue> &asyncFileQueue, OUT mPtr<mImageBuffer> *pImageBuffers, IN OPTIONAL mAllocator *pAllocator, IN const mString *pFilenames, const size_t count, const mPixelFormat pixelFormat /* = mPF_R8G8B8A8 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(asyncFileQueue == nullptr || pImageBuffers == nullptr || pFilenames == nullptr, mR_ArgumentNull);
+
+  mResult result = mR_Success;
+
+  // The callbacks reference `result`, so they have to be executed before returning.
+  mDEFER(mAsyncFileQueue_WaitForAll(asyncFileQueue));
+
+  for (size_t i = 0; i < count; i++)
+  {
+    mPtr<mAsyncFile> file;
+    mDEFER_CALL(&file, mAsyncFile_Destroy);
+    mERROR_CHECK(mAsyncFile_Open(&file, pAllocator, asyncFileQueue, pFilenames[i]));
+
+    size_t size = 0;
+    mERROR_CHECK(mAsyncFile_GetSize(file, &size));
+    mERROR_IF(size == 0, mR_ResourceInvalid);
+
+    {
+      uint8_t *pData = nullptr;
+      mERROR_CHECK(mAllocator_Allocate(pAllocator, &pData, size));
+      mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pData));
+
+      mERROR_CHECK(mAsyncFile_Read(file, 0, size, pData, [=, &result](const mResult readResult, const size_t bytesRead) mutable
+      {
+        mDEFER(mAllocator_FreePtr(pAllocator, &pData));
+
+        mResult decodeResult = readResult;
+
+        if (mSUCCEEDED(decodeResult) && bytesRead != size)
+          decodeResult = mR_IOFailure;
+
+        if (mSUCCEEDED(decodeResult))
+          decodeResult = mImageBuffer_CreateFromData(&pImageBuffers[i], pAllocator, pData, size, pixelFormat);
+
+        if (mFAILED(decodeResult) && mSUCCEEDED(result))
+          result = decodeResult;
+      }));
+    }
+
+    // Decode the files that have already been read while the remaining ones are being opened.
+    mERROR_CHECK(mAsyncFileQueue_Poll(asyncFileQueue));
+  }
+
+  mERROR_CHECK(mAsyncFileQueue_WaitForAll(asyncFileQueue));
+  mERROR_CHECK(result);
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mImageBuffer_Create, OUT mPtr<mImageBuffer> *pImageBuffer, IN OPTIONAL mAllocator *pAllocator, const mVec2s &size, const mPixelFormat pixelFormat /* = mPF_B8G8R8A8 */)
 {
   mFUNCTION_SETUP();
@@ -653,7 +759,7 @@ mFUNCTION(mImageBuffer_SetToFile, mPtr<mImageBuffer> &imageBuffer, const mString
   mFUNCTION_SETUP();
 
   mERROR_IF(imageBuffer == nullptr, mR_ArgumentNull);
-  mERROR_IF(filename.hasFailed || filename.text == nullptr, mR_InvalidParameter);
+  mERROR_IF(filename.hasFailed || filename.c_str() == nullptr, mR_InvalidParameter);
 
   mPROFILE_SCOPED("mImageBuffer_SetToFile");
 
@@ -937,6 +1043,60 @@ fpng_failed:
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mImageBuffer_SetToJpegData, mPtr<mImageBuffer> &imageBuffer, IN const uint8_t *pData, const size_t size, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat /* = mPF_B8G8R8A8 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageBuffer == nullptr || pData == nullptr, mR_ArgumentNull);
+  mERROR_IF(size == 0, mR_InvalidParameter);
+  mERROR_IF(size > UINT32_MAX, mR_ResourceIncompatible); // `jpeg_mem_src` takes an `unsigned long`.
+
+  mPROFILE_SCOPED("mImageBuffer_SetToJpegData");
+
+  mImageBuffer_JpegDecoder decoder = {};
+  decoder.pData = pData;
+  decoder.dataSize = size;
+
+  mERROR_CHECK(mImageBuffer_DecodeJpeg_Internal(imageBuffer, &decoder, params, pixelFormat));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageBuffer_SetToJpegStream, mPtr<mImageBuffer> &imageBuffer, mPtr<mCachedFileReader> &cachedFileReader, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat /* = mPF_B8G8R8A8 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageBuffer == nullptr || cachedFileReader == nullptr, mR_ArgumentNull);
+
+  mPROFILE_SCOPED("mImageBuffer_SetToJpegStream");
+
+  mImageBuffer_JpegDecoder decoder = {};
+  decoder.pCachedFileReader = &cachedFileReader;
+
+  mERROR_CHECK(mCachedFileReader_GetSize(cachedFileReader, &decoder.dataSize));
+  mERROR_IF(decoder.dataSize == 0, mR_ResourceInvalid);
+
+  mERROR_CHECK(mImageBuffer_DecodeJpeg_Internal(imageBuffer, &decoder, params, pixelFormat));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageBuffer_SetToJpegFile, mPtr<mImageBuffer> &imageBuffer, const mString &filename, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat /* = mPF_B8G8R8A8 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageBuffer == nullptr, mR_ArgumentNull);
+  mERROR_IF(filename.hasFailed || filename.c_str() == nullptr, mR_InvalidParameter);
+
+  mPtr<mCachedFileReader> cachedFileReader;
+  mDEFER_CALL(&cachedFileReader, mCachedFileReader_Destroy);
+  mERROR_CHECK(mCachedFileReader_Create(&cachedFileReader, &mDefaultTempAllocator, filename, mImageBuffer_JpegStreamChunkSize * 4));
+
+  mERROR_CHECK(mImageBuffer_SetToJpegStream(imageBuffer, cachedFileReader, params, pixelFormat));
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mImageBuffer_FlipY, mPtr<mImageBuffer> &imageBuffer)
 {
   mFUNCTION_SETUP();
@@ -991,6 +1151,103 @@ mFUNCTION(mImageBuffer_FlipY, mPtr<mImageBuffer> &imageBuffer)
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mImageBuffer_ResizeTo, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mImageBuffer_ResizeFilter filter /* = mIB_RF_Bilinear */)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mThreadPool> nullThreadPool = nullptr;
+  mERROR_CHECK(mImageBuffer_ResizeTo(source, target, filter, nullThreadPool));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageBuffer_ResizeTo, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(source == nullptr || target == nullptr, mR_ArgumentNull);
+  mERROR_IF(source->pPixels == nullptr || target->pPixels == nullptr, mR_NotInitialized);
+  mERROR_IF(source->pixelFormat != target->pixelFormat || source->pPixels == target->pPixels, mR_InvalidParameter);
+  mERROR_IF(source->currentSize.x == 0 || source->currentSize.y == 0, mR_InvalidParameter);
+
+  size_t subBufferCount;
+  mERROR_CHECK(mPixelFormat_GetSubBufferCount(source->pixelFormat, &subBufferCount));
+
+  for (size_t i = 0; i < subBufferCount; i++)
+  {
+    mPixelFormat subBufferPixelFormat;
+    mERROR_CHECK(mPixelFormat_GetSubBufferPixelFormat(source->pixelFormat, i, &subBufferPixelFormat));
+
+    mImageBuffer_ResizePlane plane;
+    mERROR_CHECK(mImageBuffer_GetResizeChannels_Internal(subBufferPixelFormat, &plane.channelCount, &plane.isFloat));
+
+    size_t subBufferUnitSize;
+    mERROR_CHECK(mPixelFormat_GetUnitSize(subBufferPixelFormat, &subBufferUnitSize));
+
+    size_t sourceSubBufferOffset;
+    mERROR_CHECK(mPixelFormat_GetSubBufferOffset(source->pixelFormat, i, mVec2s(source->lineStride, source->currentSize.y), &sourceSubBufferOffset));
+
+    size_t targetSubBufferOffset;
+    mERROR_CHECK(mPixelFormat_GetSubBufferOffset(target->pixelFormat, i, mVec2s(target->lineStride, target->currentSize.y), &targetSubBufferOffset));
+
+    size_t sourceSubBufferStride;
+    mERROR_CHECK(mPixelFormat_GetSubBufferStride(source->pixelFormat, i, source->lineStride, &sourceSubBufferStride));
+
+    size_t targetSubBufferStride;
+    mERROR_CHECK(mPixelFormat_GetSubBufferStride(target->pixelFormat, i, target->lineStride, &targetSubBufferStride));
+
+    mERROR_CHECK(mPixelFormat_GetSubBufferSize(source->pixelFormat, i, source->currentSize, &plane.sourceSize));
+    mERROR_CHECK(mPixelFormat_GetSubBufferSize(target->pixelFormat, i, target->currentSize, &plane.targetSize));
+
+    // Subsampled planes of odd sized images are wider than their stride.
+    mERROR_IF(plane.sourceSize.x > sourceSubBufferStride || plane.targetSize.x > targetSubBufferStride, mR_NotSupported);
+
+    if (plane.targetSize.x == 0 || plane.targetSize.y == 0)
+      continue;
+
+    plane.pSource = source->pPixels + sourceSubBufferOffset;
+    plane.sourceStride = sourceSubBufferStride * subBufferUnitSize;
+    plane.pTarget = target->pPixels + targetSubBufferOffset;
+    plane.targetStride = targetSubBufferStride * subBufferUnitSize;
+
+    mERROR_CHECK(mImageBuffer_ResizePlane_Internal(plane, filter, asyncTaskHandler));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageBuffer_Resize, mPtr<mImageBuffer> &imageBuffer, const mVec2s &size, const mImageBuffer_ResizeFilter filter /* = mIB_RF_Bilinear */)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mThreadPool> nullThreadPool = nullptr;
+  mERROR_CHECK(mImageBuffer_Resize(imageBuffer, size, filter, nullThreadPool));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageBuffer_Resize, mPtr<mImageBuffer> &imageBuffer, const mVec2s &size, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageBuffer == nullptr, mR_ArgumentNull);
+  mERROR_IF(imageBuffer->pPixels == nullptr, mR_NotInitialized);
+
+  mPtr<mImageBuffer> resized;
+  mDEFER_CALL(&resized, mImageBuffer_Destroy);
+  mERROR_CHECK(mImageBuffer_Create(&resized, imageBuffer->pAllocator, size, imageBuffer->pixelFormat));
+  mERROR_CHECK(mImageBuffer_ResizeTo(imageBuffer, resized, filter, asyncTaskHandler));
+
+  // Hand the new pixels to `imageBuffer`, the old ones are released with `resized`.
+  std::swap(imageBuffer->pPixels, resized->pPixels);
+  std::swap(imageBuffer->allocatedSize, resized->allocatedSize);
+  std::swap(imageBuffer->ownedResource, resized->ownedResource);
+  std::swap(imageBuffer->currentSize, resized->currentSize);
+  std::swap(imageBuffer->lineStride, resized->lineStride);
+
+  mRETURN_SUCCESS();
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 static mFUNCTION(mImageBuffer_Destroy_Iternal, mImageBuffer *pImageBuffer)
@@ -1037,3 +1294,716 @@ static mFUNCTION(mImageBuffer_Create_Iternal, mPtr<mImageBuffer> *pImageBuffer,
 
   mRETURN_SUCCESS();
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+// libjpeg reports errors by calling `error_exit`, which must not return, so we `longjmp` back into the function that called into libjpeg.
+// The functions that call `setjmp` therefore only hold trivially destructible locals and everything that needs cleaning up lives outside of them.
+
+static void mImageBuffer_JpegDecoder_ErrorExit_Internal(j_common_ptr pInfo)
+{
+  longjmp(static_cast<mImageBuffer_JpegDecoder *>(pInfo->client_data)->errorJump, 1);
+}
+
+static void mImageBuffer_JpegDecoder_OutputMessage_Internal(j_common_ptr /* pInfo */)
+{
+  // Warnings (like corrupt or truncated data) aren't fatal and errors are reported through `mResult`.
+}
+
+static void mImageBuffer_JpegDecoder_InitSource_Internal(j_decompress_ptr /* pInfo */)
+{
+}
+
+static boolean mImageBuffer_JpegDecoder_FillInputBuffer_Internal(j_decompress_ptr pInfo)
+{
+  mImageBuffer_JpegDecoder *pDecoder = static_cast<mImageBuffer_JpegDecoder *>(pInfo->client_data);
+
+  if (pDecoder->readPosition >= pDecoder->dataSize)
+  {
+    // Just like libjpeg's own sources, we end truncated files with an EOI marker, so the decoder can finish with what it's got.
+    static const JOCTET endOfImage[] = { 0xFF, JPEG_EOI };
+
+    pDecoder->source.next_input_byte = endOfImage;
+    pDecoder->source.bytes_in_buffer = sizeof(endOfImage);
+
+    return TRUE;
+  }
+
+  mCachedFileReader *pCachedFileReader = pDecoder->pCachedFileReader->GetPointer();
+  size_t size = pDecoder->dataSize - pDecoder->readPosition;
+  mResult result = mR_Success;
+
+  // Mapped files can be handed over as a whole, everything else is read in chunks that leave the cache room to slide.
+  if (pCachedFileReader->pPageCache != nullptr)
+  {
+    // Chunks within a single page point directly into the page cache, instead of being copied together from multiple pages.
+    size_t pageSize = 0;
+    result = mCachedFileReader_GetPageSize(*pDecoder->pCachedFileReader, &pageSize);
+
+    if (mSUCCEEDED(result))
+      size = mMin(size, mMin(mImageBuffer_JpegStreamChunkSize, pageSize - pDecoder->readPosition % pageSize));
+  }
+  else if (pCachedFileReader->pMappedData == nullptr)
+  {
+    size = mMin(size, mMin(mImageBuffer_JpegStreamChunkSize, mMax((size_t)1, pCachedFileReader->maxCacheSize / 4)));
+  }
+
+  uint8_t *pChunk = nullptr;
+
+  if (mSUCCEEDED(result))
+    result = mCachedFileReader_PointerAt(*pDecoder->pCachedFileReader, pDecoder->readPosition, size, &pChunk);
+
+  if (mFAILED(result))
+  {
+    pDecoder->result = result;
+    pInfo->err->error_exit(reinterpret_cast<j_common_ptr>(pInfo));
+  }
+
+  pDecoder->source.next_input_byte = pChunk;
+  pDecoder->source.bytes_in_buffer = size;
+  pDecoder->readPosition += size;
+
+  return TRUE;
+}
+
+static void mImageBuffer_JpegDecoder_SkipInputData_Internal(j_decompress_ptr pInfo, long count)
+{
+  mImageBuffer_JpegDecoder *pDecoder = static_cast<mImageBuffer_JpegDecoder *>(pInfo->client_data);
+
+  if (count <= 0)
+    return;
+
+  if ((size_t)count <= pDecoder->source.bytes_in_buffer)
+  {
+    pDecoder->source.next_input_byte += count;
+    pDecoder->source.bytes_in_buffer -= (size_t)count;
+  }
+  else
+  {
+    // Skipped data that hasn't been read yet doesn't have to be read at all.
+    pDecoder->readPosition = mMin(pDecoder->dataSize, pDecoder->readPosition + ((size_t)count - pDecoder->source.bytes_in_buffer));
+    pDecoder->source.next_input_byte = nullptr;
+    pDecoder->source.bytes_in_buffer = 0;
+  }
+}
+
+static void mImageBuffer_JpegDecoder_TermSource_Internal(j_decompress_ptr /* pInfo */)
+{
+}
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4611) // `setjmp` and C++ object destruction, see above.
+#endif
+
+static bool mImageBuffer_JpegDecoder_ReadHeader_Internal(mImageBuffer_JpegDecoder *pDecoder)
+{
+  pDecoder->info.err = jpeg_std_error(&pDecoder->errorManager);
+  pDecoder->errorManager.error_exit = mImageBuffer_JpegDecoder_ErrorExit_Internal;
+  pDecoder->errorManager.output_message = mImageBuffer_JpegDecoder_OutputMessage_Internal;
+  pDecoder->info.client_data = pDecoder;
+
+  if (setjmp(pDecoder->errorJump))
+    return false;
+
+  jpeg_create_decompress(&pDecoder->info);
+  pDecoder->created = true;
+
+  if (pDecoder->pCachedFileReader == nullptr)
+  {
+    jpeg_mem_src(&pDecoder->info, pDecoder->pData, (unsigned long)pDecoder->dataSize);
+  }
+  else
+  {
+    pDecoder->source.init_source = mImageBuffer_JpegDecoder_InitSource_Internal;
+    pDecoder->source.fill_input_buffer = mImageBuffer_JpegDecoder_FillInputBuffer_Internal;
+    pDecoder->source.skip_input_data = mImageBuffer_JpegDecoder_SkipInputData_Internal;
+    pDecoder->source.resync_to_restart = jpeg_resync_to_restart;
+    pDecoder->source.term_source = mImageBuffer_JpegDecoder_TermSource_Internal;
+    pDecoder->source.next_input_byte = nullptr;
+    pDecoder->source.bytes_in_buffer = 0;
+
+    pDecoder->info.src = &pDecoder->source;
+  }
+
+  return jpeg_read_header(&pDecoder->info, TRUE) == JPEG_HEADER_OK;
+}
+
+// `region` is in pixels of the scaled image. `pRow` has to be able to hold a full scaled row if the region is narrower than the image.
+static bool mImageBuffer_JpegDecoder_Decode_Internal(mImageBuffer_JpegDecoder *pDecoder, const mRectangle2D<size_t> &region, const mVec2s &outputSize, OUT uint8_t *pPixels, const size_t stride, IN OPTIONAL uint8_t *pRow, const size_t pixelSize)
+{
+  if (setjmp(pDecoder->errorJump))
+    return false;
+
+  jpeg_start_decompress(&pDecoder->info);
+
+  if (pDecoder->info.output_width != outputSize.x || pDecoder->info.output_height != outputSize.y || (size_t)pDecoder->info.output_components != pixelSize)
+    return false;
+
+  // One more column on either side keeps chroma upsampling at the edges of the region from replicating the edge instead of using the actual neighbours, so the region is identical to the same part of a full decode.
+  JDIMENSION decodedX = (JDIMENSION)(region.x > 0 ? region.x - 1 : 0);
+  JDIMENSION decodedWidth = (JDIMENSION)(mMin(region.x + region.w + 1, outputSize.x) - decodedX);
+
+  // Aligns the decoded columns to the enclosing iMCUs.
+  if (decodedWidth != outputSize.x)
+    jpeg_crop_scanline(&pDecoder->info, &decodedX, &decodedWidth);
+
+  // Skipped rows are only entropy decoded (or not even that if there are restart markers), without IDCT, upsampling or colour conversion.
+  if (region.y > 0 && jpeg_skip_scanlines(&pDecoder->info, (JDIMENSION)region.y) != (JDIMENSION)region.y)
+    return false;
+
+  const bool decodeDirectly = (decodedX == region.x && decodedWidth == region.w);
+  const size_t rowOffset = (region.x - decodedX) * pixelSize;
+
+  for (size_t y = 0; y < region.h; y++)
+  {
+    JSAMPROW row = decodeDirectly ? pPixels + y * stride : pRow;
+
+    if (jpeg_read_scanlines(&pDecoder->info, &row, 1) != 1)
+      return false;
+
+    if (!decodeDirectly)
+      memcpy(pPixels + y * stride, pRow + rowOffset, region.w * pixelSize);
+  }
+
+  // There's no need to decode (or read) anything below the region.
+  if (pDecoder->info.output_scanline < pDecoder->info.output_height)
+    jpeg_abort_decompress(&pDecoder->info);
+  else
+    jpeg_finish_decompress(&pDecoder->info);
+
+  return true;
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+static mFUNCTION(mImageBuffer_DecodeJpeg_Internal, mPtr<mImageBuffer> &imageBuffer, mImageBuffer_JpegDecoder *pDecoder, const mImageBuffer_JpegDecodeParams &params, const mPixelFormat pixelFormat)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(params.scaleDenominator != 1 && params.scaleDenominator != 2 && params.scaleDenominator != 4 && params.scaleDenominator != 8, mR_InvalidParameter);
+  mERROR_IF(params.decodeRegion && (params.region.w == 0 || params.region.h == 0), mR_InvalidParameter);
+
+  J_COLOR_SPACE colourSpace = JCS_EXT_RGB;
+
+  switch (pixelFormat)
+  {
+  case mPF_B8G8R8:
+    colourSpace = JCS_EXT_BGR;
+    break;
+
+  case mPF_R8G8B8:
+    colourSpace = JCS_EXT_RGB;
+    break;
+
+  case mPF_B8G8R8A8:
+    colourSpace = JCS_EXT_BGRA;
+    break;
+
+  case mPF_R8G8B8A8:
+    colourSpace = JCS_EXT_RGBA;
+    break;
+
+  case mPF_Monochrome8:
+    colourSpace = JCS_GRAYSCALE;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_NotSupported);
+  }
+
+  mDEFER(
+    if (pDecoder->created)
+      jpeg_destroy_decompress(&pDecoder->info);
+  );
+
+  if (!mImageBuffer_JpegDecoder_ReadHeader_Internal(pDecoder))
+    mRETURN_RESULT(mFAILED(pDecoder->result) ? pDecoder->result : mR_ResourceInvalid);
+
+  const mVec2s imageSize((size_t)pDecoder->info.image_width, (size_t)pDecoder->info.image_height);
+  mRectangle2D<size_t> region(mVec2s(0), imageSize);
+
+  if (params.decodeRegion)
+  {
+    mERROR_IF(params.region.x >= imageSize.x || params.region.y >= imageSize.y || params.region.w > imageSize.x - params.region.x || params.region.h > imageSize.y - params.region.y, mR_ArgumentOutOfBounds);
+    region = params.region;
+  }
+
+  size_t scaleDenominator = params.scaleDenominator;
+
+  if (params.minimumSize.x != 0 || params.minimumSize.y != 0)
+  {
+    scaleDenominator = 1;
+
+    for (size_t denominator = 8; denominator > 1; denominator /= 2)
+    {
+      if ((region.w + denominator - 1) / denominator >= params.minimumSize.x && (region.h + denominator - 1) / denominator >= params.minimumSize.y)
+      {
+        scaleDenominator = denominator;
+        break;
+      }
+    }
+  }
+
+  // libjpeg rounds scaled dimensions up.
+  const mVec2s roundUp = mVec2s(scaleDenominator - 1);
+  const mVec2s outputSize = (imageSize + roundUp) / scaleDenominator;
+  const mVec2s scaledStart = region.position / scaleDenominator;
+  const mVec2s scaledEnd = (region.position + region.size + roundUp) / scaleDenominator;
+  const mRectangle2D<size_t> scaledRegion(scaledStart, scaledEnd - scaledStart);
+
+  pDecoder->info.scale_num = 1;
+  pDecoder->info.scale_denom = (uint32_t)scaleDenominator;
+  pDecoder->info.out_color_space = colourSpace;
+  pDecoder->info.dct_method = JDCT_IFAST; // Just like `TJFLAG_FASTDCT` in `mImageBuffer_SetToData`.
+
+  size_t pixelSize = 0;
+  mERROR_CHECK(mPixelFormat_GetUnitSize(pixelFormat, &pixelSize));
+  mERROR_CHECK(mImageBuffer_AllocateBuffer(imageBuffer, scaledRegion.size, pixelFormat));
+
+  uint8_t *pRow = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pRow);
+
+  if (scaledRegion.w != outputSize.x)
+    mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pRow, outputSize.x * pixelSize));
+
+  if (!mImageBuffer_JpegDecoder_Decode_Internal(pDecoder, scaledRegion, outputSize, imageBuffer->pPixels, imageBuffer->lineStride * pixelSize, pRow, pixelSize))
+    mRETURN_RESULT(mFAILED(pDecoder->result) ? pDecoder->result : mR_ResourceInvalid);
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+struct mImageBuffer_ResizeWeights
+{
+  size_t *pStart; // First source pixel per target pixel.
+  float_t *pWeights; // `tapCount` weights per target pixel.
+  size_t tapCount;
+};
+
+static float_t mImageBuffer_ResizeFilter_GetSupport_Internal(const mImageBuffer_ResizeFilter filter)
+{
+  switch (filter)
+  {
+  case mIB_RF_Box:
+    return 0.5f;
+
+  case mIB_RF_Bilinear:
+    return 1.f;
+
+  case mIB_RF_Bicubic:
+    return 2.f;
+
+  case mIB_RF_Lanczos:
+  case mIB_RF_Kaiser:
+  default:
+    return 3.f;
+  }
+}
+
+// Zeroth order modified bessel function of the first kind.
+static float_t mImageBuffer_ResizeFilter_BesselI0_Internal(const float_t x)
+{
+  const float_t quarterXSquared = x * x * 0.25f;
+
+  float_t sum = 1.f;
+  float_t term = 1.f;
+
+  for (size_t k = 1; k < 32 && term > sum * 1e-7f; k++)
+  {
+    term *= quarterXSquared / (float_t)(k * k);
+    sum += term;
+  }
+
+  return sum;
+}
+
+static float_t mImageBuffer_ResizeFilter_Evaluate_Internal(const mImageBuffer_ResizeFilter filter, const float_t x)
+{
+  const float_t absX = mAbs(x);
+
+  switch (filter)
+  {
+  case mIB_RF_Box:
+    return (x >= -0.5f && x < 0.5f) ? 1.f : 0.f;
+
+  case mIB_RF_Bilinear:
+    return absX < 1.f ? 1.f - absX : 0.f;
+
+  case mIB_RF_Bicubic:
+    if (absX < 1.f)
+      return (1.5f * absX - 2.5f) * absX * absX + 1.f;
+    else if (absX < 2.f)
+      return ((-0.5f * absX + 2.5f) * absX - 4.f) * absX + 2.f;
+    else
+      return 0.f;
+
+  case mIB_RF_Lanczos:
+  default:
+  {
+    if (absX < 1e-5f)
+      return 1.f;
+    else if (absX >= 3.f)
+      return 0.f;
+
+    const float_t piX = mPIf * x;
+
+    return 3.f * mSin(piX) * mSin(piX / 3.f) / (piX * piX);
+  }
+
+  case mIB_RF_Kaiser:
+  {
+    if (absX >= 3.f)
+      return 0.f;
+
+    constexpr float_t alpha = 4.f;
+
+    const float_t piX = mPIf * x;
+    const float_t sinc = absX < 1e-5f ? 1.f : mSin(piX) / piX;
+    const float_t windowX = x / 3.f;
+
+    return sinc * mImageBuffer_ResizeFilter_BesselI0_Internal(alpha * mSqrt(1.f - windowX * windowX)) / mImageBuffer_ResizeFilter_BesselI0_Internal(alpha);
+  }
+  }
+}
+
+static mFUNCTION(mImageBuffer_ResizeWeights_Destroy_Internal, IN_OUT mImageBuffer_ResizeWeights *pWeights)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mAllocator_FreePtr(nullptr, &pWeights->pStart));
+  mERROR_CHECK(mAllocator_FreePtr(nullptr, &pWeights->pWeights));
+  pWeights->tapCount = 0;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageBuffer_ResizeWeights_Create_Internal, OUT mImageBuffer_ResizeWeights *pWeights, const size_t sourceCount, const size_t targetCount, const mImageBuffer_ResizeFilter filter)
+{
+  mFUNCTION_SETUP();
+
+  const float_t scale = (float_t)targetCount / (float_t)sourceCount;
+  const float_t filterScale = mMax(1.f, 1.f / scale); // Widen the filter when shrinking, so that every source pixel contributes.
+  const float_t support = mImageBuffer_ResizeFilter_GetSupport_Internal(filter) * filterScale;
+
+  // Every target pixel gets the same number of taps, unused ones are weighted with zero.
+  pWeights->tapCount = mMin(sourceCount, (size_t)mCeil(support * 2.f) + 2);
+
+  mDEFER_ON_ERROR(mImageBuffer_ResizeWeights_Destroy_Internal(pWeights));
+  mERROR_CHECK(mAllocator_Allocate(nullptr, &pWeights->pStart, targetCount));
+  mERROR_CHECK(mAllocator_AllocateZero(nullptr, &pWeights->pWeights, targetCount * pWeights->tapCount));
+
+  for (size_t i = 0; i < targetCount; i++)
+  {
+    const float_t center = ((float_t)i + 0.5f) / scale;
+    const int64_t first = (int64_t)mFloor(center - support);
+    const int64_t last = (int64_t)mCeil(center + support);
+    const size_t start = (size_t)mClamp(first, (int64_t)0, (int64_t)(sourceCount - pWeights->tapCount));
+
+    float_t *pTaps = pWeights->pWeights + i * pWeights->tapCount;
+    float_t sum = 0;
+
+    for (int64_t j = first; j <= last; j++)
+    {
+      const float_t weight = mImageBuffer_ResizeFilter_Evaluate_Internal(filter, ((float_t)j + 0.5f - center) / filterScale);
+
+      if (weight == 0)
+        continue;
+
+      // Pixels outside of the image are replaced by the closest edge pixel.
+      pTaps[(size_t)mClamp(j, (int64_t)0, (int64_t)sourceCount - 1) - start] += weight;
+      sum += weight;
+    }
+
+    if (sum != 0)
+      for (size_t tap = 0; tap < pWeights->tapCount; tap++)
+        pTaps[tap] /= sum;
+    else
+      pTaps[(size_t)mClamp((int64_t)center, (int64_t)start, (int64_t)(start + pWeights->tapCount - 1)) - start] = 1.f;
+
+    pWeights->pStart[i] = start;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mINLINE __m128 mImageBuffer_Resize_Load4_Internal(const uint8_t *pValues)
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  int32_t packed;
+  memcpy(&packed, pValues, sizeof(packed)); // Pixels aren't necessarily 4 byte aligned.
+
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero));
+}
+
+static mINLINE __m128 mImageBuffer_Resize_Load4_Internal(const float_t *pValues)
+{
+  return _mm_loadu_ps(pValues);
+}
+
+static mINLINE void mImageBuffer_Resize_Store4_Internal(OUT uint8_t *pValues, const __m128 values)
+{
+  const __m128i values32 = _mm_cvtps_epi32(values);
+  const __m128i values8 = _mm_packus_epi16(_mm_packs_epi32(values32, values32), values32);
+
+  const int32_t packed = _mm_cvtsi128_si32(values8);
+  memcpy(pValues, &packed, sizeof(packed));
+}
+
+static mINLINE void mImageBuffer_Resize_Store4_Internal(OUT float_t *pValues, const __m128 values)
+{
+  _mm_storeu_ps(pValues, values);
+}
+
+static mINLINE void mImageBuffer_Resize_Store_Internal(OUT uint8_t *pValue, const float_t value)
+{
+  // Round the same way `_mm_cvtps_epi32` does.
+  *pValue = (uint8_t)mClamp(_mm_cvtss_si32(_mm_set_ss(value)), 0, 255);
+}
+
+static mINLINE void mImageBuffer_Resize_Store_Internal(OUT float_t *pValue, const float_t value)
+{
+  *pValue = value;
+}
+
+template <typename T>
+static void mImageBuffer_Resize_Horizontal_Internal(const T *pSource, OUT float_t *pTarget, const size_t targetWidth, const size_t channelCount, const mImageBuffer_ResizeWeights &weights)
+{
+  const size_t tapCount = weights.tapCount;
+
+  if (channelCount == 4)
+  {
+    for (size_t x = 0; x < targetWidth; x++)
+    {
+      const T *pPixels = pSource + weights.pStart[x] * 4;
+      const float_t *pWeights = weights.pWeights + x * tapCount;
+
+      __m128 sum = _mm_setzero_ps();
+
+      for (size_t tap = 0; tap < tapCount; tap++)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(pWeights[tap]), mImageBuffer_Resize_Load4_Internal(pPixels + tap * 4)));
+
+      _mm_storeu_ps(pTarget + x * 4, sum);
+    }
+  }
+  else if (channelCount == 1)
+  {
+    for (size_t x = 0; x < targetWidth; x++)
+    {
+      const T *pPixels = pSource + weights.pStart[x];
+      const float_t *pWeights = weights.pWeights + x * tapCount;
+
+      // Four neighbouring taps at once.
+      __m128 sum4 = _mm_setzero_ps();
+      size_t tap = 0;
+
+      if (tapCount >= 4)
+        for (; tap < tapCount - 3; tap += 4)
+          sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(pWeights + tap), mImageBuffer_Resize_Load4_Internal(pPixels + tap)));
+
+      sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+      float_t sum = _mm_cvtss_f32(_mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, _MM_SHUFFLE(1, 1, 1, 1))));
+
+      for (; tap < tapCount; tap++)
+        sum += pWeights[tap] * (float_t)pPixels[tap];
+
+      pTarget[x] = sum;
+    }
+  }
+  else
+  {
+    for (size_t x = 0; x < targetWidth; x++)
+    {
+      const T *pPixels = pSource + weights.pStart[x] * channelCount;
+      const float_t *pWeights = weights.pWeights + x * tapCount;
+
+      for (size_t channel = 0; channel < channelCount; channel++)
+      {
+        float_t sum = 0;
+
+        for (size_t tap = 0; tap < tapCount; tap++)
+          sum += pWeights[tap] * (float_t)pPixels[tap * channelCount + channel];
+
+        pTarget[x * channelCount + channel] = sum;
+      }
+    }
+  }
+}
+
+template <typename T>
+static void mImageBuffer_Resize_Vertical_AVX(size_t &index, const float_t *pSource, const size_t sourceStride, const float_t *pWeights, const size_t tapCount, OUT T *pTarget, const size_t count)
+{
+  for (; index < count - 7; index += 8)
+  {
+    __m256 sum = _mm256_setzero_ps();
+
+    for (size_t tap = 0; tap < tapCount; tap++)
+      sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(pWeights[tap]), _mm256_loadu_ps(pSource + tap * sourceStride + index)));
+
+    mImageBuffer_Resize_Store4_Internal(pTarget + index, _mm256_castps256_ps128(sum));
+    mImageBuffer_Resize_Store4_Internal(pTarget + index + 4, _mm256_extractf128_ps(sum, 1));
+  }
+}
+
+// Filters `count` values from `tapCount` intermediate rows that are `sourceStride` floats apart.
+template <typename T>
+static void mImageBuffer_Resize_Vertical_Internal(const float_t *pSource, const size_t sourceStride, const float_t *pWeights, const size_t tapCount, OUT T *pTarget, const size_t count)
+{
+  size_t index = 0;
+
+  if (count >= 8 && mCpuExtensions::avxSupported)
+  {
+    mImageBuffer_Resize_Vertical_AVX(index, pSource, sourceStride, pWeights, tapCount, pTarget, count);
+  }
+  else if (count >= 4)
+  {
+    for (; index < count - 3; index += 4)
+    {
+      __m128 sum = _mm_setzero_ps();
+
+      for (size_t tap = 0; tap < tapCount; tap++)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(pWeights[tap]), _mm_loadu_ps(pSource + tap * sourceStride + index)));
+
+      mImageBuffer_Resize_Store4_Internal(pTarget + index, sum);
+    }
+  }
+
+  for (; index < count; index++)
+  {
+    float_t sum = 0;
+
+    for (size_t tap = 0; tap < tapCount; tap++)
+      sum += pWeights[tap] * pSource[tap * sourceStride + index];
+
+    mImageBuffer_Resize_Store_Internal(pTarget + index, sum);
+  }
+}
+
+static mFUNCTION(mImageBuffer_ResizeBand_Internal, const mImageBuffer_ResizePlane &plane, const mImageBuffer_ResizeWeights &horizontal, const mImageBuffer_ResizeWeights &vertical, const size_t rowStart, const size_t rowEnd)
+{
+  mFUNCTION_SETUP();
+
+  // `vertical.pStart` never decreases, so this covers all source rows of the band.
+  const size_t sourceRowStart = vertical.pStart[rowStart];
+  const size_t sourceRowEnd = vertical.pStart[rowEnd - 1] + vertical.tapCount;
+  const size_t rowValues = plane.targetSize.x * plane.channelCount;
+
+  float_t *pIntermediate = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, nullptr, &pIntermediate);
+  mERROR_CHECK(mAllocator_Allocate(nullptr, &pIntermediate, (sourceRowEnd - sourceRowStart) * rowValues));
+
+  for (size_t y = sourceRowStart; y < sourceRowEnd; y++)
+  {
+    const uint8_t *pSourceRow = plane.pSource + y * plane.sourceStride;
+    float_t *pIntermediateRow = pIntermediate + (y - sourceRowStart) * rowValues;
+
+    if (plane.isFloat)
+      mImageBuffer_Resize_Horizontal_Internal(reinterpret_cast<const float_t *>(pSourceRow), pIntermediateRow, plane.targetSize.x, plane.channelCount, horizontal);
+    else
+      mImageBuffer_Resize_Horizontal_Internal(pSourceRow, pIntermediateRow, plane.targetSize.x, plane.channelCount, horizontal);
+  }
+
+  for (size_t y = rowStart; y < rowEnd; y++)
+  {
+    const float_t *pIntermediateRow = pIntermediate + (vertical.pStart[y] - sourceRowStart) * rowValues;
+    const float_t *pWeights = vertical.pWeights + y * vertical.tapCount;
+    uint8_t *pTargetRow = plane.pTarget + y * plane.targetStride;
+
+    if (plane.isFloat)
+      mImageBuffer_Resize_Vertical_Internal(pIntermediateRow, rowValues, pWeights, vertical.tapCount, reinterpret_cast<float_t *>(pTargetRow), rowValues);
+    else
+      mImageBuffer_Resize_Vertical_Internal(pIntermediateRow, rowValues, pWeights, vertical.tapCount, pTargetRow, rowValues);
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageBuffer_ResizePlane_Internal, const mImageBuffer_ResizePlane &plane, const mImageBuffer_ResizeFilter filter, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  mCpuExtensions::Detect();
+
+  mImageBuffer_ResizeWeights horizontal = {};
+  mDEFER_CALL(&horizontal, mImageBuffer_ResizeWeights_Destroy_Internal);
+  mERROR_CHECK(mImageBuffer_ResizeWeights_Create_Internal(&horizontal, plane.sourceSize.x, plane.targetSize.x, filter));
+
+  mImageBuffer_ResizeWeights vertical = {};
+  mDEFER_CALL(&vertical, mImageBuffer_ResizeWeights_Destroy_Internal);
+  mERROR_CHECK(mImageBuffer_ResizeWeights_Create_Internal(&vertical, plane.sourceSize.y, plane.targetSize.y, filter));
+
+  // Every band filters the source rows it needs horizontally on its own, so bands overlapping by a few source rows is cheaper than sharing them.
+  // The horizontally filtered source rows of a band are what has to stay in the cache.
+  const size_t intermediateRowSize = plane.targetSize.x * plane.channelCount * sizeof(float_t);
+  const size_t bytesPerTargetRow = mMax((size_t)1, intermediateRowSize * plane.sourceSize.y / plane.targetSize.y);
+
+  mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, plane.targetSize.y, 1, bytesPerTargetRow, [&](const size_t rowStart, const size_t rowEnd)
+  {
+    return mImageBuffer_ResizeBand_Internal(plane, horizontal, vertical, rowStart, rowEnd);
+  }));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageBuffer_GetResizeChannels_Internal, const mPixelFormat pixelFormat, OUT size_t *pChannelCount, OUT bool *pIsFloat)
+{
+  mFUNCTION_SETUP();
+
+  switch (pixelFormat)
+  {
+  case mPF_Monochrome8:
+    *pChannelCount = 1;
+    *pIsFloat = false;
+    break;
+
+  case mPF_R8G8:
+    *pChannelCount = 2;
+    *pIsFloat = false;
+    break;
+
+  case mPF_R8G8B8:
+  case mPF_B8G8R8:
+    *pChannelCount = 3;
+    *pIsFloat = false;
+    break;
+
+  case mPF_R8G8B8A8:
+  case mPF_B8G8R8A8:
+    *pChannelCount = 4;
+    *pIsFloat = false;
+    break;
+
+  case mPF_Monochromef32:
+    *pChannelCount = 1;
+    *pIsFloat = true;
+    break;
+
+  case mPF_Rf32Gf32:
+    *pChannelCount = 2;
+    *pIsFloat = true;
+    break;
+
+  case mPF_Rf32Gf32Bf32:
+    *pChannelCount = 3;
+    *pIsFloat = true;
+    break;
+
+  case mPF_Rf32Gf32Bf32Af32:
+    *pChannelCount = 4;
+    *pIsFloat = true;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_NotSupported);
+  }
+
+  mRETURN_SUCCESS();
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
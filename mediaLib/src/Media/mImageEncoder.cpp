@@ -0,0 +1,506 @@
+#include "mImageEncoder.h"
+
+#include "mFile.h"
+#include "mProfiler.h"
+
+#include "turbojpeg.h"
+
+#include <mutex>
+#include <condition_variable>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "8GpqF48GfuVEdTYmott7vX5vcsnFQO84ki8Ab8zR6apiXP3mq9kRsdLSvrhpY+et6VTZz6YWsXCwF2qx"
+#endif
+
+struct mImageEncoder_Compressor
+{
+  tjhandle handle;
+  uint8_t *pBuffer; // allocated with `tjAlloc`, large enough for the largest image this compressor has encoded so far.
+  unsigned long bufferCapacity;
+  bool inUse;
+};
+
+struct mImageEncoder
+{
+  mImageEncoder_Params params;
+  mPtr<mThreadPool> asyncTaskHandler;
+  mAllocator *pAllocator;
+
+  // Guards the compressors.
+  std::mutex mutex;
+  std::condition_variable compressorReleased;
+
+  mImageEncoder_Compressor *pCompressors;
+  size_t compressorCount;
+};
+
+static mFUNCTION(mImageEncoder_Destroy_Internal, IN mImageEncoder *pImageEncoder);
+static mFUNCTION(mImageEncoder_ValidateParams_Internal, const mImageEncoder_Params &params);
+static mFUNCTION(mImageEncoder_AcquireCompressor_Internal, mImageEncoder *pImageEncoder, OUT mImageEncoder_Compressor **ppCompressor);
+static void mImageEncoder_ReleaseCompressor_Internal(mImageEncoder *pImageEncoder, mImageEncoder_Compressor *pCompressor);
+static mFUNCTION(mImageEncoder_Compress_Internal, const mImageEncoder_Params &params, mImageEncoder_Compressor *pCompressor, mPtr<mImageBuffer> &imageBuffer, OUT size_t *pSize);
+static mFUNCTION(mImageEncoder_EncodeToMemory_Internal, mImageEncoder *pImageEncoder, mPtr<mImageBuffer> &imageBuffer, mPtr<mBinaryChunk> &binaryChunk);
+static mFUNCTION(mImageEncoder_EncodeToFile_Internal, mImageEncoder *pImageEncoder, mPtr<mImageBuffer> &imageBuffer, const mString &filename);
+static mFUNCTION(mImageEncoder_ForEach_Internal, mImageEncoder *pImageEncoder, const size_t count, const std::function<mResult(const size_t index)> &function);
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mImageEncoder_Create, OUT mPtr<mImageEncoder> *pImageEncoder, IN OPTIONAL mAllocator *pAllocator, const mImageEncoder_Params &params /* = mImageEncoder_Params() */)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mThreadPool> nullThreadPool = nullptr;
+  mERROR_CHECK(mImageEncoder_Create(pImageEncoder, pAllocator, params, nullThreadPool));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_Create, OUT mPtr<mImageEncoder> *pImageEncoder, IN OPTIONAL mAllocator *pAllocator, const mImageEncoder_Params &params, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImageEncoder == nullptr, mR_ArgumentNull);
+  mERROR_CHECK(mImageEncoder_ValidateParams_Internal(params));
+
+  size_t compressorCount = 1;
+
+  if (asyncTaskHandler != nullptr)
+  {
+    size_t threadCount = 0;
+    mERROR_CHECK(mThreadPool_GetThreadCount(asyncTaskHandler, &threadCount));
+
+    compressorCount += threadCount; // The calling thread participates in `mThreadPool_ParallelFor`.
+  }
+
+  mDEFER_CALL_ON_ERROR(pImageEncoder, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate(pImageEncoder, pAllocator, (std::function<void(mImageEncoder *)>)[](mImageEncoder *pData) {mImageEncoder_Destroy_Internal(pData);}, 1));
+
+  new (&(*pImageEncoder)->mutex) std::mutex();
+  new (&(*pImageEncoder)->compressorReleased) std::condition_variable();
+
+  (*pImageEncoder)->pAllocator = pAllocator;
+  (*pImageEncoder)->params = params;
+  (*pImageEncoder)->asyncTaskHandler = asyncTaskHandler;
+
+  // The handles and buffers are only created once a compressor is actually used.
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &(*pImageEncoder)->pCompressors, compressorCount));
+  (*pImageEncoder)->compressorCount = compressorCount;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_Destroy, IN_OUT mPtr<mImageEncoder> *pImageEncoder)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImageEncoder == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pImageEncoder));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_SetParams, mPtr<mImageEncoder> &imageEncoder, const mImageEncoder_Params &params)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageEncoder == nullptr, mR_ArgumentNull);
+  mERROR_CHECK(mImageEncoder_ValidateParams_Internal(params));
+
+  imageEncoder->params = params;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_EncodeToMemory, mPtr<mImageEncoder> &imageEncoder, mPtr<mImageBuffer> &imageBuffer, mPtr<mBinaryChunk> &binaryChunk)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageEncoder == nullptr || imageBuffer == nullptr, mR_ArgumentNull);
+
+  mPROFILE_SCOPED("mImageEncoder_EncodeToMemory");
+
+  if (binaryChunk == nullptr)
+    mERROR_CHECK(mBinaryChunk_Create(&binaryChunk, imageEncoder->pAllocator));
+
+  mERROR_CHECK(mImageEncoder_EncodeToMemory_Internal(imageEncoder.GetPointer(), imageBuffer, binaryChunk));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_EncodeToFile, mPtr<mImageEncoder> &imageEncoder, mPtr<mImageBuffer> &imageBuffer, const mString &filename)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageEncoder == nullptr || imageBuffer == nullptr, mR_ArgumentNull);
+  mERROR_IF(filename.hasFailed || filename.c_str() == nullptr, mR_InvalidParameter);
+
+  mPROFILE_SCOPED("mImageEncoder_EncodeToFile");
+
+  mERROR_CHECK(mImageEncoder_EncodeToFile_Internal(imageEncoder.GetPointer(), imageBuffer, filename));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_EncodeToMemory, mPtr<mImageEncoder> &imageEncoder, IN mPtr<mImageBuffer> *pImageBuffers, IN_OUT mPtr<mBinaryChunk> *pBinaryChunks, const size_t count)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageEncoder == nullptr || pImageBuffers == nullptr || pBinaryChunks == nullptr, mR_ArgumentNull);
+
+  mPROFILE_SCOPED("mImageEncoder_EncodeToMemory (Batch)");
+
+  for (size_t i = 0; i < count; i++)
+  {
+    mERROR_IF(pImageBuffers[i] == nullptr, mR_ArgumentNull);
+
+    // Created up front, so the encoder's allocator isn't used from multiple threads.
+    if (pBinaryChunks[i] == nullptr)
+      mERROR_CHECK(mBinaryChunk_Create(&pBinaryChunks[i], imageEncoder->pAllocator));
+  }
+
+  mImageEncoder *pImageEncoder = imageEncoder.GetPointer();
+
+  const std::function<mResult(const size_t)> &encode = [=](const size_t index)
+  {
+    return mImageEncoder_EncodeToMemory_Internal(pImageEncoder, pImageBuffers[index], pBinaryChunks[index]);
+  };
+
+  mERROR_CHECK(mImageEncoder_ForEach_Internal(pImageEncoder, count, encode));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoder_EncodeToFiles, mPtr<mImageEncoder> &imageEncoder, IN mPtr<mImageBuffer> *pImageBuffers, IN const mString *pFilenames, const size_t count)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageEncoder == nullptr || pImageBuffers == nullptr || pFilenames == nullptr, mR_ArgumentNull);
+
+  mPROFILE_SCOPED("mImageEncoder_EncodeToFiles");
+
+  for (size_t i = 0; i < count; i++)
+  {
+    mERROR_IF(pImageBuffers[i] == nullptr, mR_ArgumentNull);
+    mERROR_IF(pFilenames[i].hasFailed || pFilenames[i].c_str() == nullptr, mR_InvalidParameter);
+  }
+
+  mImageEncoder *pImageEncoder = imageEncoder.GetPointer();
+
+  const std::function<mResult(const size_t)> &encode = [=](const size_t index)
+  {
+    return mImageEncoder_EncodeToFile_Internal(pImageEncoder, pImageBuffers[index], pFilenames[index]);
+  };
+
+  mERROR_CHECK(mImageEncoder_ForEach_Internal(pImageEncoder, count, encode));
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mImageEncoder_Destroy_Internal, IN mImageEncoder *pImageEncoder)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImageEncoder == nullptr, mR_ArgumentNull);
+
+  if (pImageEncoder->pCompressors != nullptr)
+  {
+    for (size_t i = 0; i < pImageEncoder->compressorCount; i++)
+    {
+      mImageEncoder_Compressor *pCompressor = &pImageEncoder->pCompressors[i];
+
+      if (pCompressor->handle != nullptr)
+        tjDestroy(pCompressor->handle);
+
+      if (pCompressor->pBuffer != nullptr)
+        tjFree(pCompressor->pBuffer);
+    }
+
+    mERROR_CHECK(mAllocator_FreePtr(pImageEncoder->pAllocator, &pImageEncoder->pCompressors));
+  }
+
+  pImageEncoder->compressorCount = 0;
+
+  mERROR_CHECK(mThreadPool_Destroy(&pImageEncoder->asyncTaskHandler));
+
+  pImageEncoder->compressorReleased.~condition_variable();
+  pImageEncoder->mutex.~mutex();
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageEncoder_ValidateParams_Internal, const mImageEncoder_Params &params)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(params.quality < 1 || params.quality > 100, mR_InvalidParameter);
+
+  switch (params.chromaSubsampling)
+  {
+  case mIE_CS_444:
+  case mIE_CS_422:
+  case mIE_CS_420:
+  case mIE_CS_440:
+  case mIE_CS_411:
+  case mIE_CS_Grayscale:
+    break;
+
+  default:
+    mRETURN_RESULT(mR_InvalidParameter);
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageEncoder_AcquireCompressor_Internal, mImageEncoder *pImageEncoder, OUT mImageEncoder_Compressor **ppCompressor)
+{
+  mFUNCTION_SETUP();
+
+  mImageEncoder_Compressor *pCompressor = nullptr;
+
+  {
+    std::unique_lock<std::mutex> lock(pImageEncoder->mutex);
+
+    while (pCompressor == nullptr)
+    {
+      for (size_t i = 0; i < pImageEncoder->compressorCount; i++)
+      {
+        if (!pImageEncoder->pCompressors[i].inUse)
+        {
+          pCompressor = &pImageEncoder->pCompressors[i];
+          pCompressor->inUse = true;
+          break;
+        }
+      }
+
+      if (pCompressor == nullptr)
+        pImageEncoder->compressorReleased.wait(lock);
+    }
+  }
+
+  if (pCompressor->handle == nullptr)
+  {
+    pCompressor->handle = tjInitCompress();
+
+    if (pCompressor->handle == nullptr)
+    {
+      mImageEncoder_ReleaseCompressor_Internal(pImageEncoder, pCompressor);
+      mRETURN_RESULT(mR_InternalError);
+    }
+  }
+
+  *ppCompressor = pCompressor;
+
+  mRETURN_SUCCESS();
+}
+
+static void mImageEncoder_ReleaseCompressor_Internal(mImageEncoder *pImageEncoder, mImageEncoder_Compressor *pCompressor)
+{
+  {
+    std::unique_lock<std::mutex> lock(pImageEncoder->mutex);
+    pCompressor->inUse = false;
+  }
+
+  pImageEncoder->compressorReleased.notify_one();
+}
+
+static mFUNCTION(mImageEncoder_Compress_Internal, const mImageEncoder_Params &params, mImageEncoder_Compressor *pCompressor, mPtr<mImageBuffer> &imageBuffer, OUT size_t *pSize)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imageBuffer->pPixels == nullptr, mR_NotInitialized);
+  mERROR_IF(imageBuffer->currentSize.x == 0 || imageBuffer->currentSize.y == 0, mR_InvalidParameter);
+  mERROR_IF(imageBuffer->currentSize.x > INT32_MAX || imageBuffer->currentSize.y > INT32_MAX, mR_ResourceIncompatible);
+
+  int32_t tjPixelFormat = -1; // Stays negative for YUV images.
+  int32_t tjSubsampling = TJSAMP_420;
+
+  switch (imageBuffer->pixelFormat)
+  {
+  case mPF_B8G8R8:
+    tjPixelFormat = TJPF_BGR;
+    break;
+
+  case mPF_R8G8B8:
+    tjPixelFormat = TJPF_RGB;
+    break;
+
+  case mPF_B8G8R8A8:
+    tjPixelFormat = TJPF_BGRA;
+    break;
+
+  case mPF_R8G8B8A8:
+    tjPixelFormat = TJPF_RGBA;
+    break;
+
+  case mPF_Monochrome8:
+    tjPixelFormat = TJPF_GRAY;
+    tjSubsampling = TJSAMP_GRAY;
+    break;
+
+  case mPF_YUV444:
+    tjSubsampling = TJSAMP_444;
+    break;
+
+  case mPF_YUV422:
+    tjSubsampling = TJSAMP_422;
+    break;
+
+  case mPF_YUV420:
+    tjSubsampling = TJSAMP_420;
+    break;
+
+  case mPF_YUV440:
+    tjSubsampling = TJSAMP_440;
+    break;
+
+  case mPF_YUV411:
+    tjSubsampling = TJSAMP_411;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_NotSupported);
+  }
+
+  if (tjPixelFormat >= 0 && tjPixelFormat != TJPF_GRAY)
+  {
+    switch (params.chromaSubsampling)
+    {
+    case mIE_CS_444:
+      tjSubsampling = TJSAMP_444;
+      break;
+
+    case mIE_CS_422:
+      tjSubsampling = TJSAMP_422;
+      break;
+
+    case mIE_CS_420:
+      tjSubsampling = TJSAMP_420;
+      break;
+
+    case mIE_CS_440:
+      tjSubsampling = TJSAMP_440;
+      break;
+
+    case mIE_CS_411:
+      tjSubsampling = TJSAMP_411;
+      break;
+
+    case mIE_CS_Grayscale:
+      tjSubsampling = TJSAMP_GRAY;
+      break;
+    }
+  }
+
+  // The planes of YUV images have to follow each other without any padding.
+  mERROR_IF(tjPixelFormat < 0 && imageBuffer->lineStride != imageBuffer->currentSize.x, mR_InvalidParameter);
+
+  const int32_t width = (int32_t)imageBuffer->currentSize.x;
+  const int32_t height = (int32_t)imageBuffer->currentSize.y;
+
+  // Compressing into a buffer that's large enough for the worst case lets us tell turbojpeg to never reallocate it.
+  const unsigned long requiredCapacity = tjBufSize(width, height, tjSubsampling);
+  mERROR_IF(requiredCapacity == (unsigned long)-1, mR_InternalError);
+  mERROR_IF(requiredCapacity > INT32_MAX, mR_ResourceIncompatible);
+
+  if (pCompressor->bufferCapacity < requiredCapacity)
+  {
+    if (pCompressor->pBuffer != nullptr)
+      tjFree(pCompressor->pBuffer);
+
+    pCompressor->bufferCapacity = 0;
+    pCompressor->pBuffer = tjAlloc((int32_t)requiredCapacity);
+    mERROR_IF(pCompressor->pBuffer == nullptr, mR_MemoryAllocationFailure);
+
+    pCompressor->bufferCapacity = requiredCapacity;
+  }
+
+  const int32_t flags = TJFLAG_NOREALLOC | (params.fastDct ? TJFLAG_FASTDCT : 0);
+  unsigned long size = pCompressor->bufferCapacity;
+  int32_t result;
+
+  if (tjPixelFormat >= 0)
+  {
+    size_t pixelSize = 0;
+    mERROR_CHECK(mPixelFormat_GetUnitSize(imageBuffer->pixelFormat, &pixelSize));
+
+    result = tjCompress2(pCompressor->handle, imageBuffer->pPixels, width, (int32_t)(imageBuffer->lineStride * pixelSize), height, tjPixelFormat, &pCompressor->pBuffer, &size, tjSubsampling, (int32_t)params.quality, flags);
+  }
+  else
+  {
+    result = tjCompressFromYUV(pCompressor->handle, imageBuffer->pPixels, width, 1, height, tjSubsampling, &pCompressor->pBuffer, &size, (int32_t)params.quality, flags);
+  }
+
+  mERROR_IF(result != 0, mR_InternalError);
+
+  *pSize = (size_t)size;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageEncoder_EncodeToMemory_Internal, mImageEncoder *pImageEncoder, mPtr<mImageBuffer> &imageBuffer, mPtr<mBinaryChunk> &binaryChunk)
+{
+  mFUNCTION_SETUP();
+
+  mImageEncoder_Compressor *pCompressor = nullptr;
+  mERROR_CHECK(mImageEncoder_AcquireCompressor_Internal(pImageEncoder, &pCompressor));
+  mDEFER_CALL_2(mImageEncoder_ReleaseCompressor_Internal, pImageEncoder, pCompressor);
+
+  size_t size = 0;
+  mERROR_CHECK(mImageEncoder_Compress_Internal(pImageEncoder->params, pCompressor, imageBuffer, &size));
+
+  // Every binary chunk belongs to a single image, so it's written to without holding the encoder's lock.
+  mERROR_CHECK(mBinaryChunk_WriteBytes(binaryChunk, pCompressor->pBuffer, size));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageEncoder_EncodeToFile_Internal, mImageEncoder *pImageEncoder, mPtr<mImageBuffer> &imageBuffer, const mString &filename)
+{
+  mFUNCTION_SETUP();
+
+  mImageEncoder_Compressor *pCompressor = nullptr;
+  mERROR_CHECK(mImageEncoder_AcquireCompressor_Internal(pImageEncoder, &pCompressor));
+  mDEFER_CALL_2(mImageEncoder_ReleaseCompressor_Internal, pImageEncoder, pCompressor);
+
+  size_t size = 0;
+  mERROR_CHECK(mImageEncoder_Compress_Internal(pImageEncoder->params, pCompressor, imageBuffer, &size));
+  mERROR_CHECK(mFile_WriteRaw(filename, pCompressor->pBuffer, size));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImageEncoder_ForEach_Internal, mImageEncoder *pImageEncoder, const size_t count, const std::function<mResult(const size_t index)> &function)
+{
+  mFUNCTION_SETUP();
+
+  if (pImageEncoder->asyncTaskHandler == nullptr || count <= 1)
+  {
+    for (size_t i = 0; i < count; i++)
+      mERROR_CHECK(function(i));
+  }
+  else
+  {
+    const std::function<mResult(const size_t, const size_t)> &encodeRange = [&](const size_t start, const size_t end)
+    {
+      for (size_t i = start; i < end; i++)
+      {
+        const mResult result = function(i);
+
+        if (mFAILED(result))
+          return result;
+      }
+
+      return mR_Success;
+    };
+
+    mERROR_CHECK(mThreadPool_ParallelFor(pImageEncoder->asyncTaskHandler, 0, count, 1, encodeRange));
+  }
+
+  mRETURN_SUCCESS();
+}
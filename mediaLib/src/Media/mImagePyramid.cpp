@@ -0,0 +1,310 @@
+#include "mImagePyramid.h"
+
+#include "mProfiler.h"
+
+#include <intrin.h>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "sfGX0Wf/Igh38xZNu4jEjyrdlj4fzw1mElfpBk/l2EgRM9Pa7lXPwAiF5N3zkQra+6/rrJbvsp7JBQRu"
+#endif
+
+constexpr size_t mImagePyramid_LinearToSrgbTableSize = 1 << 14;
+
+struct mImagePyramid_SrgbTables
+{
+  float_t srgbToLinear[0x100];
+  uint8_t linearToSrgb[mImagePyramid_LinearToSrgbTableSize];
+
+  mImagePyramid_SrgbTables()
+  {
+    for (size_t i = 0; i < mARRAYSIZE(srgbToLinear); i++)
+    {
+      const float_t value = (float_t)i / 255.f;
+      srgbToLinear[i] = value <= 0.04045f ? value / 12.92f : mPow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    for (size_t i = 0; i < mARRAYSIZE(linearToSrgb); i++)
+    {
+      const float_t value = (float_t)i / (float_t)(mImagePyramid_LinearToSrgbTableSize - 1);
+      const float_t srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * mPow(value, 1.f / 2.4f) - 0.055f;
+      linearToSrgb[i] = (uint8_t)mClamp((int32_t)(srgb * 255.f + 0.5f), 0, 255);
+    }
+  }
+};
+
+static const mImagePyramid_SrgbTables & mImagePyramid_GetSrgbTables_Internal();
+
+static mFUNCTION(mImagePyramid_Destroy_Internal, IN mImagePyramid *pImagePyramid);
+static mFUNCTION(mImagePyramid_ToLinear_Internal, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler);
+static mFUNCTION(mImagePyramid_FromLinear_Internal, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler);
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mImagePyramid_Create, OUT mPtr<mImagePyramid> *pImagePyramid, IN OPTIONAL mAllocator *pAllocator, mPtr<mImageBuffer> &source, const mImageBuffer_ResizeFilter filter /* = mIB_RF_Box */, const bool gammaCorrect /* = true */, const size_t maxLevelCount /* = 0 */)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mThreadPool> nullThreadPool = nullptr;
+  mERROR_CHECK(mImagePyramid_Create(pImagePyramid, pAllocator, source, filter, gammaCorrect, maxLevelCount, nullThreadPool));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImagePyramid_Create, OUT mPtr<mImagePyramid> *pImagePyramid, IN OPTIONAL mAllocator *pAllocator, mPtr<mImageBuffer> &source, const mImageBuffer_ResizeFilter filter, const bool gammaCorrect, const size_t maxLevelCount, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImagePyramid == nullptr || source == nullptr, mR_ArgumentNull);
+  mERROR_IF(source->pPixels == nullptr, mR_NotInitialized);
+  mERROR_IF(source->currentSize.x == 0 || source->currentSize.y == 0, mR_InvalidParameter);
+
+  mPROFILE_SCOPED("mImagePyramid_Create");
+
+  bool isFloat;
+
+  switch (source->pixelFormat)
+  {
+  case mPF_R8G8B8A8:
+  case mPF_B8G8R8A8:
+    isFloat = false;
+    break;
+
+  case mPF_Monochromef32:
+  case mPF_Rf32Gf32:
+  case mPF_Rf32Gf32Bf32:
+  case mPF_Rf32Gf32Bf32Af32:
+    isFloat = true;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_NotSupported);
+  }
+
+  size_t unitSize;
+  mERROR_CHECK(mPixelFormat_GetUnitSize(source->pixelFormat, &unitSize));
+
+  size_t levelCount = 1;
+  size_t dataSize = source->currentSize.x * source->currentSize.y * unitSize;
+
+  for (mVec2s levelSize = source->currentSize; (levelSize.x > 1 || levelSize.y > 1) && (maxLevelCount == 0 || levelCount < maxLevelCount); levelCount++)
+  {
+    levelSize = mVec2s(mMax((size_t)1, levelSize.x / 2), mMax((size_t)1, levelSize.y / 2));
+    dataSize += levelSize.x * levelSize.y * unitSize;
+  }
+
+  mDEFER_CALL_ON_ERROR(pImagePyramid, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate(pImagePyramid, pAllocator, (std::function<void (mImagePyramid *)>)[](mImagePyramid *pData) { mImagePyramid_Destroy_Internal(pData); }, 1));
+
+  mImagePyramid *pPyramid = pImagePyramid->GetPointer();
+
+  pPyramid->pAllocator = pAllocator;
+  pPyramid->pixelFormat = source->pixelFormat;
+
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pPyramid->pData, dataSize));
+  pPyramid->dataSize = dataSize;
+
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pPyramid->pLevels, levelCount));
+  pPyramid->levelCount = levelCount;
+
+  {
+    uint8_t *pLevelData = pPyramid->pData;
+    mVec2s levelSize = source->currentSize;
+
+    for (size_t i = 0; i < levelCount; i++)
+    {
+      mERROR_CHECK(mImageBuffer_Create(&pPyramid->pLevels[i], pAllocator, pLevelData, levelSize, pPyramid->pixelFormat));
+
+      pLevelData += levelSize.x * levelSize.y * unitSize;
+      levelSize = mVec2s(mMax((size_t)1, levelSize.x / 2), mMax((size_t)1, levelSize.y / 2));
+    }
+  }
+
+  // Copy the first level.
+  {
+    const size_t rowSize = source->currentSize.x * unitSize;
+    const uint8_t *pSource = source->pPixels;
+    uint8_t *pTarget = pPyramid->pData;
+    const size_t sourceStride = source->lineStride * unitSize;
+
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, source->currentSize.y, 1, rowSize, [&](const size_t rowStart, const size_t rowEnd)
+    {
+      for (size_t y = rowStart; y < rowEnd; y++)
+      {
+        const mResult result = mMemcpy(pTarget + y * rowSize, pSource + y * sourceStride, rowSize);
+
+        if (mFAILED(result))
+          return result;
+      }
+
+      return mR_Success;
+    }));
+  }
+
+  if (levelCount == 1)
+    mRETURN_SUCCESS();
+
+  if (isFloat || !gammaCorrect)
+  {
+    for (size_t i = 1; i < levelCount; i++)
+      mERROR_CHECK(mImageBuffer_ResizeTo(pPyramid->pLevels[i - 1], pPyramid->pLevels[i], filter, asyncTaskHandler));
+  }
+  else
+  {
+    // The linear levels are kept in floating point, so each one is filtered from the unquantised previous level.
+    mPtr<mImageBuffer> linear;
+    mDEFER_CALL(&linear, mImageBuffer_Destroy);
+    mERROR_CHECK(mImageBuffer_Create(&linear, pAllocator, source->currentSize, mPF_Rf32Gf32Bf32Af32));
+    mERROR_CHECK(mImagePyramid_ToLinear_Internal(pPyramid->pLevels[0], linear, asyncTaskHandler));
+
+    mPtr<mImageBuffer> nextLinear;
+    mDEFER_CALL(&nextLinear, mImageBuffer_Destroy);
+    mERROR_CHECK(mImageBuffer_Create(&nextLinear, pAllocator, pPyramid->pLevels[1]->currentSize, mPF_Rf32Gf32Bf32Af32));
+
+    for (size_t i = 1; i < levelCount; i++)
+    {
+      // Levels only ever get smaller, so this never reallocates.
+      mERROR_CHECK(mImageBuffer_AllocateBuffer(nextLinear, pPyramid->pLevels[i]->currentSize, mPF_Rf32Gf32Bf32Af32));
+
+      mERROR_CHECK(mImageBuffer_ResizeTo(linear, nextLinear, filter, asyncTaskHandler));
+      mERROR_CHECK(mImagePyramid_FromLinear_Internal(nextLinear, pPyramid->pLevels[i], asyncTaskHandler));
+
+      std::swap(linear, nextLinear);
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImagePyramid_Destroy, IN_OUT mPtr<mImagePyramid> *pImagePyramid)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImagePyramid == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mSharedPointer_Destroy(pImagePyramid));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImagePyramid_GetLevelCount, const mPtr<mImagePyramid> &imagePyramid, OUT size_t *pLevelCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imagePyramid == nullptr || pLevelCount == nullptr, mR_ArgumentNull);
+
+  *pLevelCount = imagePyramid->levelCount;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImagePyramid_GetLevel, mPtr<mImagePyramid> &imagePyramid, const size_t level, OUT mPtr<mImageBuffer> *pLevel)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imagePyramid == nullptr || pLevel == nullptr, mR_ArgumentNull);
+  mERROR_IF(level >= imagePyramid->levelCount, mR_IndexOutOfBounds);
+
+  *pLevel = imagePyramid->pLevels[level];
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static const mImagePyramid_SrgbTables & mImagePyramid_GetSrgbTables_Internal()
+{
+  static const mImagePyramid_SrgbTables tables;
+
+  return tables;
+}
+
+static mFUNCTION(mImagePyramid_Destroy_Internal, IN mImagePyramid *pImagePyramid)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pImagePyramid == nullptr, mR_ArgumentNull);
+
+  if (pImagePyramid->pLevels != nullptr)
+  {
+    for (size_t i = 0; i < pImagePyramid->levelCount; i++)
+      mERROR_CHECK(mImageBuffer_Destroy(&pImagePyramid->pLevels[i]));
+
+    mERROR_CHECK(mAllocator_FreePtr(pImagePyramid->pAllocator, &pImagePyramid->pLevels));
+  }
+
+  pImagePyramid->levelCount = 0;
+
+  mERROR_CHECK(mAllocator_FreePtr(pImagePyramid->pAllocator, &pImagePyramid->pData));
+  pImagePyramid->dataSize = 0;
+
+  mRETURN_SUCCESS();
+}
+
+// Both formats store alpha in the last channel, so `mPF_B8G8R8A8` just stays in that channel order while it's linear.
+static mFUNCTION(mImagePyramid_ToLinear_Internal, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  const float_t *pSrgbToLinear = mImagePyramid_GetSrgbTables_Internal().srgbToLinear;
+  const size_t width = source->currentSize.x;
+
+  mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, source->currentSize.y, 1, width * 4 * (sizeof(uint8_t) + sizeof(float_t)), [&](const size_t rowStart, const size_t rowEnd)
+  {
+    for (size_t y = rowStart; y < rowEnd; y++)
+    {
+      const uint8_t *pSource = source->pPixels + y * source->lineStride * 4;
+      float_t *pTarget = reinterpret_cast<float_t *>(target->pPixels) + y * target->lineStride * 4;
+
+      for (size_t x = 0; x < width * 4; x += 4)
+      {
+        pTarget[x + 0] = pSrgbToLinear[pSource[x + 0]];
+        pTarget[x + 1] = pSrgbToLinear[pSource[x + 1]];
+        pTarget[x + 2] = pSrgbToLinear[pSource[x + 2]];
+        pTarget[x + 3] = (float_t)pSource[x + 3] * (1.f / 255.f);
+      }
+    }
+
+    return mR_Success;
+  }));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mImagePyramid_FromLinear_Internal, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
+{
+  mFUNCTION_SETUP();
+
+  const uint8_t *pLinearToSrgb = mImagePyramid_GetSrgbTables_Internal().linearToSrgb;
+  const size_t width = source->currentSize.x;
+
+  mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, source->currentSize.y, 1, width * 4 * (sizeof(uint8_t) + sizeof(float_t)), [&](const size_t rowStart, const size_t rowEnd)
+  {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 scale = _mm_set_ps(255.f, (float_t)(mImagePyramid_LinearToSrgbTableSize - 1), (float_t)(mImagePyramid_LinearToSrgbTableSize - 1), (float_t)(mImagePyramid_LinearToSrgbTableSize - 1));
+
+    for (size_t y = rowStart; y < rowEnd; y++)
+    {
+      const float_t *pSource = reinterpret_cast<const float_t *>(source->pPixels) + y * source->lineStride * 4;
+      uint8_t *pTarget = target->pPixels + y * target->lineStride * 4;
+
+      for (size_t x = 0; x < width * 4; x += 4)
+      {
+        // Colour channels become indices into the lookup table, alpha is quantised directly.
+        const __m128i indices = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(pSource + x), zero), one), scale));
+
+        pTarget[x + 0] = pLinearToSrgb[_mm_cvtsi128_si32(indices)];
+        pTarget[x + 1] = pLinearToSrgb[_mm_cvtsi128_si32(_mm_srli_si128(indices, 4))];
+        pTarget[x + 2] = pLinearToSrgb[_mm_cvtsi128_si32(_mm_srli_si128(indices, 8))];
+        pTarget[x + 3] = (uint8_t)_mm_cvtsi128_si32(_mm_srli_si128(indices, 12));
+      }
+    }
+
+    return mR_Success;
+  }));
+
+  mRETURN_SUCCESS();
+}
@@ -702,6 +702,19 @@ mFUNCTION(mPixelFormat_GetSubBufferStride, const mPixelFormat pixelFormat, const
 
 namespace mPixelFormat_Transform
 {
+  // Copies a tightly packed plane of `size.x * size.y` bytes.
+  static mFUNCTION(mPixelFormat_Transform_CopyPlane, const uint8_t *pSource, uint8_t *pTarget, const mVec2s &size, mPtr<mThreadPool> &asyncTaskHandler)
+  {
+    mFUNCTION_SETUP();
+
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, size.y, 1, size.x * 2, [&](const size_t rowStart, const size_t rowEnd)
+    {
+      return mMemcpy(pTarget + rowStart * size.x, pSource + rowStart * size.x, (rowEnd - rowStart) * size.x);
+    }));
+
+    mRETURN_SUCCESS();
+  }
+
 #ifdef SSE2
 
   /*
@@ -1081,7 +1094,7 @@ namespace mPixelFormat_Transform
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_YUV422ToBgra, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /* asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_YUV422ToBgra, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
@@ -1107,12 +1120,17 @@ namespace mPixelFormat_Transform
     size_t targetUnitSize;
     mERROR_CHECK(mPixelFormat_GetUnitSize(target->pixelFormat, &targetUnitSize));
 
-    mERROR_CHECK(mPixelFormat_Yuv422pToBgra(pBuffer0, sourceLineStride0, pBuffer1, sourceLineStride1, pBuffer2, sourceLineStride1, target->currentSize.x, target->currentSize.y, pOutPixels, target->lineStride, 0xFF));
+    const size_t targetLineStride = target->lineStride * targetUnitSize;
+
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, target->currentSize.y, 1, sourceLineStride0 + sourceLineStride1 * 2 + targetLineStride, [&](const size_t rowStart, const size_t rowEnd)
+    {
+      return mPixelFormat_Yuv422pToBgra(pBuffer0 + rowStart * sourceLineStride0, sourceLineStride0, pBuffer1 + rowStart * sourceLineStride1, sourceLineStride1, pBuffer2 + rowStart * sourceLineStride1, sourceLineStride1, target->currentSize.x, rowEnd - rowStart, pOutPixels + rowStart * targetLineStride, targetLineStride, 0xFF);
+    }));
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_YUV444ToBgra, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /* asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_YUV444ToBgra, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
@@ -1138,7 +1156,12 @@ namespace mPixelFormat_Transform
     size_t targetUnitSize;
     mERROR_CHECK(mPixelFormat_GetUnitSize(target->pixelFormat, &targetUnitSize));
 
-    mERROR_CHECK(mPixelFormat_Yuv444pToBgra(pBuffer0, sourceLineStride0, pBuffer1, sourceLineStride1, pBuffer2, sourceLineStride1, target->currentSize.x, target->currentSize.y, pOutPixels, target->lineStride, 0xFF));
+    const size_t targetLineStride = target->lineStride * targetUnitSize;
+
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, target->currentSize.y, 1, sourceLineStride0 + sourceLineStride1 * 2 + targetLineStride, [&](const size_t rowStart, const size_t rowEnd)
+    {
+      return mPixelFormat_Yuv444pToBgra(pBuffer0 + rowStart * sourceLineStride0, sourceLineStride0, pBuffer1 + rowStart * sourceLineStride1, sourceLineStride1, pBuffer2 + rowStart * sourceLineStride1, sourceLineStride1, target->currentSize.x, rowEnd - rowStart, pOutPixels + rowStart * targetLineStride, targetLineStride, 0xFF);
+    }));
 
     mRETURN_SUCCESS();
   }
@@ -1326,43 +1349,14 @@ namespace mPixelFormat_Transform
     size_t targetUnitSize;
     mERROR_CHECK(mPixelFormat_GetUnitSize(target->pixelFormat, &targetUnitSize));
 
-    if (asyncTaskHandler == nullptr)
-    {
-      mERROR_CHECK(mPixelFormat_Transform_YUV420ToBgra_Wrapper(pBuffer0, pBuffer1, pBuffer2, pOutPixels, target->currentSize.x, target->currentSize.y, target->lineStride, sourceLineStride0, sourceLineStride1, targetUnitSize));
-    }
-    else
-    {
-      mTask **ppTasks = nullptr;
-      size_t threadCount;
-      mERROR_CHECK(mThreadPool_GetThreadCount(asyncTaskHandler, &threadCount));
-
-      mAllocator *pAllocator = &mDefaultAllocator;
-      mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &ppTasks);
-      mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &ppTasks, threadCount));
-
-      const size_t subHeight = target->currentSize.y / threadCount;
-      const size_t yOffset = sourceLineStride0 * subHeight;
-      const size_t uvOffset = sourceLineStride1 * (subHeight / 2);
-      const size_t bgraOffset = target->lineStride *subHeight;
+    const size_t targetLineStride = target->lineStride;
 
-      mResult result = mR_Success;
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mTask_CreateWithLambda(&ppTasks[i], pAllocator, [=]() { return mPixelFormat_Transform_YUV420ToBgra_Wrapper(pBuffer0 + i * yOffset, pBuffer1 + i * uvOffset, pBuffer2 + i * uvOffset, pOutPixels + i * bgraOffset, target->currentSize.x, subHeight, target->lineStride, sourceLineStride0, sourceLineStride1, targetUnitSize); }), result, epilogue);
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mThreadPool_EnqueueTask(asyncTaskHandler, ppTasks[i]), result, epilogue);
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mTask_Join(ppTasks[i]), result, epilogue);
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, target->currentSize.y, 2, sourceLineStride0 + sourceLineStride1 + targetLineStride * targetUnitSize, [&](const size_t rowStart, const size_t rowEnd)
+    {
+      const size_t uvRowStart = rowStart / 2;
 
-    epilogue:
-      for (size_t i = 0; i < threadCount; ++i)
-        if (ppTasks[i] != nullptr)
-          mERROR_CHECK(mTask_Destroy(&ppTasks[i]));
-
-      mRETURN_RESULT(result);
-    }
+      return mPixelFormat_Transform_YUV420ToBgra_Wrapper(pBuffer0 + rowStart * sourceLineStride0, pBuffer1 + uvRowStart * sourceLineStride1, pBuffer2 + uvRowStart * sourceLineStride1, pOutPixels + rowStart * targetLineStride, target->currentSize.x, rowEnd - rowStart, targetLineStride, sourceLineStride0, sourceLineStride1, targetUnitSize);
+    }));
 
     mRETURN_SUCCESS();
   }
@@ -1433,43 +1427,11 @@ namespace mPixelFormat_Transform
     const size_t targetStride = target->lineStride;
     const size_t sourceStride = source->lineStride;
 
-    if (asyncTaskHandler == nullptr)
+    // Every row is converted independently, so this is also safe if `source` and `target` are the same buffer.
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, size.y, 1, (sourceStride + targetStride) * sizeof(uint32_t), [&](const size_t rowStart, const size_t rowEnd)
     {
-      mERROR_CHECK(mPixelFormat_Transform_RgbaToBgra_BgraToRgba(pSource, sourceStride, pTarget, targetStride, size));
-    }
-    else
-    {
-      mTask **ppTasks = nullptr;
-      size_t threadCount;
-      mERROR_CHECK(mThreadPool_GetThreadCount(asyncTaskHandler, &threadCount));
-
-      mAllocator *pAllocator = &mDefaultAllocator;
-      mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &ppTasks);
-      mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &ppTasks, threadCount));
-
-      const size_t subHeight = size.y / threadCount;
-      const size_t targetOffset = target->lineStride * subHeight;
-      const size_t sourceOffset = source->lineStride * subHeight;
-      const mVec2s subSize = mVec2s(size.x, subHeight);
-
-      mResult result = mR_Success;
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mTask_CreateWithLambda(&ppTasks[i], pAllocator, [=]() {return mPixelFormat_Transform_RgbaToBgra_BgraToRgba(pSource + sourceOffset, sourceStride, pTarget + targetOffset, targetStride, subSize);}), result, epilogue);
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mThreadPool_EnqueueTask(asyncTaskHandler, ppTasks[i]), result, epilogue);
-
-      for (size_t i = 0; i < threadCount; ++i)
-        mERROR_CHECK_GOTO(mTask_Join(ppTasks[i]), result, epilogue);
-
-    epilogue:
-      for (size_t i = 0; i < threadCount; ++i)
-        if (ppTasks[i] != nullptr)
-          mERROR_CHECK(mTask_Destroy(&ppTasks[i]));
-
-      mRETURN_RESULT(result);
-    }
+      return mPixelFormat_Transform_RgbaToBgra_BgraToRgba(pSource + rowStart * sourceStride, sourceStride, pTarget + rowStart * targetStride, targetStride, mVec2s(size.x, rowEnd - rowStart));
+    }));
 
     mRETURN_SUCCESS();
   }
@@ -1487,26 +1449,32 @@ namespace mPixelFormat_Transform
   {
     mFUNCTION_SETUP();
 
-    mUnused(asyncTaskHandler);
-
-    uint32_t *pTarget = (uint32_t *)target->pPixels;
-    uint8_t *pSource = (uint8_t *)source->pPixels;
+    uint32_t *pTargetPixels = (uint32_t *)target->pPixels;
+    const uint8_t *pSourcePixels = (uint8_t *)source->pPixels;
     const mVec2s size = source->currentSize;
     const size_t targetStride = target->lineStride;
     const size_t sourceStride = source->lineStride * 3;
 
-    for (size_t y = 0; y < size.y; y++)
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, size.y, 1, sourceStride + targetStride * sizeof(uint32_t), [&](const size_t rowStart, const size_t rowEnd)
     {
-      for (size_t x = 0; x < size.x; x++)
+      uint32_t *pTarget = pTargetPixels + rowStart * targetStride;
+      const uint8_t *pSource = pSourcePixels + rowStart * sourceStride;
+
+      for (size_t y = rowStart; y < rowEnd; y++)
       {
-        *pTarget = 0xFF000000 | ((uint32_t)pSource[2] << 0x10) | ((uint32_t)pSource[1] << 0x8) | (uint32_t)pSource[0];
-        pTarget++;
-        pSource += 3;
+        for (size_t x = 0; x < size.x; x++)
+        {
+          *pTarget = 0xFF000000 | ((uint32_t)pSource[2] << 0x10) | ((uint32_t)pSource[1] << 0x8) | (uint32_t)pSource[0];
+          pTarget++;
+          pSource += 3;
+        }
+
+        pTarget += targetStride - size.x;
+        pSource += sourceStride - size.x * 3;
       }
 
-      pTarget += targetStride - size.x;
-      pSource += sourceStride - size.x * 3;
-    }
+      return mR_Success;
+    }));
 
     mRETURN_SUCCESS();
   }
@@ -1520,26 +1488,32 @@ namespace mPixelFormat_Transform
   {
     mFUNCTION_SETUP();
 
-    mUnused(asyncTaskHandler);
-
-    uint32_t *pTarget = (uint32_t *)target->pPixels;
-    uint8_t *pSource = (uint8_t *)source->pPixels;
+    uint32_t *pTargetPixels = (uint32_t *)target->pPixels;
+    const uint8_t *pSourcePixels = (uint8_t *)source->pPixels;
     const mVec2s size = source->currentSize;
     const size_t targetStride = target->lineStride;
     const size_t sourceStride = source->lineStride * 3;
 
-    for (size_t y = 0; y < size.y; y++)
+    mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, size.y, 1, sourceStride + targetStride * sizeof(uint32_t), [&](const size_t rowStart, const size_t rowEnd)
     {
-      for (size_t x = 0; x < size.x; x++)
+      uint32_t *pTarget = pTargetPixels + rowStart * targetStride;
+      const uint8_t *pSource = pSourcePixels + rowStart * sourceStride;
+
+      for (size_t y = rowStart; y < rowEnd; y++)
       {
-        *pTarget = 0xFF000000 | ((uint32_t)pSource[0] << 0x10) | ((uint32_t)pSource[1] << 0x8) | (uint32_t)pSource[2];
-        pTarget++;
-        pSource += 3;
+        for (size_t x = 0; x < size.x; x++)
+        {
+          *pTarget = 0xFF000000 | ((uint32_t)pSource[0] << 0x10) | ((uint32_t)pSource[1] << 0x8) | (uint32_t)pSource[2];
+          pTarget++;
+          pSource += 3;
+        }
+
+        pTarget += targetStride - size.x;
+        pSource += sourceStride - size.x * 3;
       }
 
-      pTarget += targetStride - size.x;
-      pSource += sourceStride - size.x * 3;
-    }
+      return mR_Success;
+    }));
 
     mRETURN_SUCCESS();
   }
@@ -1563,50 +1537,62 @@ namespace mPixelFormat_Transform
     *pIndex = i;
   }
 
-  mFUNCTION(mPixelFormat_Transform_RgbToBgr, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_RgbToBgr, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
     if (source->lineStride == target->lineStride)
     {
-      const size_t size = source->currentSize.y * source->lineStride * 3;
+      const size_t lineSize = source->lineStride * 3;
+      const uint8_t *pSourcePixels = source->pPixels;
+      uint8_t *pTargetPixels = target->pPixels;
+
+      mCpuExtensions::Detect();
 
-      size_t i = 0;
-      const uint8_t *pSource = source->pPixels;
-      uint8_t *pTarget = target->pPixels;
-      
-      if (size > sizeof(__m128i))
+      // Bands start at a line boundary and never write past their last line, so this is also safe if `source` and `target` are the same buffer.
+      mERROR_CHECK(mThreadPool_ForEachRowBand(asyncTaskHandler, source->currentSize.y, 1, lineSize * 2, [&](const size_t rowStart, const size_t rowEnd)
       {
-        mCpuExtensions::Detect();
+        const size_t size = (rowEnd - rowStart) * lineSize;
 
-        if (mCpuExtensions::ssse3Supported)
+        size_t i = 0;
+        const uint8_t *pSource = pSourcePixels + rowStart * lineSize;
+        uint8_t *pTarget = pTargetPixels + rowStart * lineSize;
+
+        if (size > sizeof(__m128i))
         {
-          mPixelFormat_Transform_RgbToBgrSameStrideSSSE3(pSource, pTarget, i, &i, size);
+          if (mCpuExtensions::ssse3Supported)
+          {
+            mPixelFormat_Transform_RgbToBgrSameStrideSSSE3(pSource, pTarget, i, &i, size);
+          }
+          else
+          {
+            const __m128i maskG = _mm_set_epi8(-1, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0);
+            const __m128i maskRB = _mm_set_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0);
+            const __m128i maskBR = _mm_set_epi8(0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1);
+
+            for (; i < size - (sizeof(__m128i) - 1); i += (sizeof(__m128i) - 1))
+            {
+              const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource + i));
+              const __m128i g = _mm_and_si128(maskG, src);
+              const __m128i rb = _mm_and_si128(maskRB, _mm_slli_si128(src, 2));
+              const __m128i br = _mm_and_si128(maskBR, _mm_srli_si128(src, 2));
+
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget + i), _mm_or_si128(g, _mm_or_si128(rb, br)));
+            }
+          }
         }
-        else
-        {
-          const __m128i maskG = _mm_set_epi8(-1, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 1);
-          const __m128i maskRB = _mm_set_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0);
-          const __m128i maskBR = _mm_set_epi8(0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1);
 
-          for (; i < size - (sizeof(__m128i) - 1); i += (sizeof(__m128i) - 1))
-          {
-            const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource + i));
-            const __m128i g = _mm_and_si128(maskG, src);
-            const __m128i rb = _mm_and_si128(maskRB, _mm_slli_si128(src, 2));
-            const __m128i br = _mm_and_si128(maskBR, _mm_srli_si128(src, 2));
+        for (; i < size; i += 3)
+        {
+          const uint8_t r = pSource[i + 0];
 
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget + i), _mm_or_si128(g, _mm_or_si128(rb, br)));
-          }
+          pTarget[i + 0] = pSource[i + 2];
+          pTarget[i + 1] = pSource[i + 1];
+          pTarget[i + 2] = r;
         }
-      }
 
-      for (; i < size; i += 3)
-      {
-        pTarget[i + 0] = pSource[i + 2];
-        pTarget[i + 1] = pSource[i + 1];
-        pTarget[i + 2] = pSource[i + 0];
-      }
+        return mR_Success;
+      }));
     }
     else
     {
@@ -1625,380 +1611,432 @@ namespace mPixelFormat_Transform
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_Yuv444ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_Yuv444ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
-    const uint8_t *pSource = source->pPixels;
-    uint8_t *pTarget = target->pPixels;
+    const uint8_t *pSourcePixels = source->pPixels;
+    uint8_t *pTargetPixels = target->pPixels;
 
     const mVec2s size = source->currentSize;
 
-    if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+    if (pSourcePixels != pTargetPixels)
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSourcePixels, pTargetPixels, size, asyncTaskHandler));
 
-    pSource += size.x * size.y;
-    pTarget += size.x * size.y;
+    // Downsampling in place overwrites source rows that other bands may not have read yet, so that has to happen sequentially.
+    mPtr<mThreadPool> nullThreadPool = nullptr;
+    mPtr<mThreadPool> &threadPool = pSourcePixels == pTargetPixels ? nullThreadPool : asyncTaskHandler;
 
     const mVec2s targetSubBufferSize = size / 2;
+    const size_t sourceLineAdvance = size.x + targetSubBufferSize.x * 2;
 
     const __m128i mask00FF = _mm_set1_epi16(0x00FF);
     const __m128i two_epi16 = _mm_set1_epi16(2);
 
     for (size_t subBuffer = 0; subBuffer < 2; subBuffer++)
     {
-      for (size_t y = 0; y < targetSubBufferSize.y; y++)
-      {
-        const uint8_t *pSourceLine2 = pSource + size.x;
+      const uint8_t *pSourceSubBuffer = pSourcePixels + size.x * size.y + subBuffer * targetSubBufferSize.y * sourceLineAdvance;
+      uint8_t *pTargetSubBuffer = pTargetPixels + size.x * size.y + subBuffer * targetSubBufferSize.y * targetSubBufferSize.x;
 
-        size_t x = 0;
+      mERROR_CHECK(mThreadPool_ForEachRowBand(threadPool, targetSubBufferSize.y, 1, sourceLineAdvance + targetSubBufferSize.x, [&](const size_t rowStart, const size_t rowEnd)
+      {
+        const uint8_t *pSource = pSourceSubBuffer + rowStart * sourceLineAdvance;
+        uint8_t *pTarget = pTargetSubBuffer + rowStart * targetSubBufferSize.x;
 
-        if (targetSubBufferSize.x >= sizeof(__m128i))
+        for (size_t y = rowStart; y < rowEnd; y++)
         {
-          for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+          const uint8_t *pSourceLine2 = pSource + size.x;
+
+          size_t x = 0;
+
+          if (targetSubBufferSize.x >= sizeof(__m128i))
           {
-            // Presume pSource/pSourceLine2 are
-            // A B C D E F G H A B C D E F G H I J K L M N O P I J K L M N O P
-            // a b c d e f g h a b c d e f g h i j k l m n o p i j k l m n o p
-
-            // A B C D E F G H A B C D E F G H
-            const __m128i line00 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
-            // a b c d e f g h a b c d e f g h
-            const __m128i line10 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
-
-            // A   C   E   G   A   C   E   G
-            const __m128i line00_16a = _mm_and_si128(line00, mask00FF);
-            // B   D   F   H   B   D   F   H
-            const __m128i line00_16b = _mm_srli_epi16(line00, 8);
-            // a   c   e   g   a   c   e   g
-            const __m128i line01_16a = _mm_and_si128(line10, mask00FF);
-            // b   d   f   h   b   d   f   h
-            const __m128i line01_16b = _mm_srli_epi16(line10, 8);
-
-            // Calculate Averages & Round to the next integer.
-            // (A + B + a + b + 2) / 4, 0, (C + D + c + d + 2) / 4, 0, (E + F + e + f + 2) / 4, 0, (G + H + g + h + 2) / 4, 0, ...
-            // => avg0, 0, avg1, 0, avg2, 0, avg3, ...
-            const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(two_epi16, _mm_add_epi16(_mm_add_epi16(line00_16a, line00_16b), _mm_add_epi16(line01_16a, line01_16b))), 2);
-
-            // I J K L M N O P I J K L M N O P
-            const __m128i line01 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource) + 1);
-            // i j k l m n o p i j k l m n o p
-            const __m128i line11 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2) + 1);
-
-            // I   K   M   O   I   K   M   O
-            const __m128i line10_16a = _mm_and_si128(line01, mask00FF);
-            // J   L   N   P   J   L   N   P
-            const __m128i line10_16b = _mm_srli_epi16(line01, 8);
-            // i   k   m   o   i   k   m   o
-            const __m128i line11_16a = _mm_and_si128(line11, mask00FF);
-            // j   l   n   p   j   l   n   p
-            const __m128i line11_16b = _mm_srli_epi16(line11, 8);
-
-            // Calculate Averages & Round to the next integer.
-            // (I + J + i + j + 2) / 4, 0, (K + L + k + l + 2) / 4, 0, (M + N + m + n + 2) / 4, 0, (O + P + o + p + 2) / 4, 0, ...
-            // => avg8, 0, avg9, 0, avg10, 0, avg11, ...
-            const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(two_epi16, _mm_add_epi16(_mm_add_epi16(line10_16a, line10_16b), _mm_add_epi16(line11_16a, line11_16b))), 2);
-
-            // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
-            const __m128i added = _mm_packus_epi16(add0, add1);
-
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), added);
-
-            pTarget += sizeof(__m128i);
-            pSource += sizeof(__m128i) * 2;
-            pSourceLine2 += sizeof(__m128i) * 2;
+            for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+            {
+              // Presume pSource/pSourceLine2 are
+              // A B C D E F G H A B C D E F G H I J K L M N O P I J K L M N O P
+              // a b c d e f g h a b c d e f g h i j k l m n o p i j k l m n o p
+
+              // A B C D E F G H A B C D E F G H
+              const __m128i line00 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+              // a b c d e f g h a b c d e f g h
+              const __m128i line10 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
+
+              // A   C   E   G   A   C   E   G
+              const __m128i line00_16a = _mm_and_si128(line00, mask00FF);
+              // B   D   F   H   B   D   F   H
+              const __m128i line00_16b = _mm_srli_epi16(line00, 8);
+              // a   c   e   g   a   c   e   g
+              const __m128i line01_16a = _mm_and_si128(line10, mask00FF);
+              // b   d   f   h   b   d   f   h
+              const __m128i line01_16b = _mm_srli_epi16(line10, 8);
+
+              // Calculate Averages & Round to the next integer.
+              // (A + B + a + b + 2) / 4, 0, (C + D + c + d + 2) / 4, 0, (E + F + e + f + 2) / 4, 0, (G + H + g + h + 2) / 4, 0, ...
+              // => avg0, 0, avg1, 0, avg2, 0, avg3, ...
+              const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(two_epi16, _mm_add_epi16(_mm_add_epi16(line00_16a, line00_16b), _mm_add_epi16(line01_16a, line01_16b))), 2);
+
+              // I J K L M N O P I J K L M N O P
+              const __m128i line01 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource) + 1);
+              // i j k l m n o p i j k l m n o p
+              const __m128i line11 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2) + 1);
+
+              // I   K   M   O   I   K   M   O
+              const __m128i line10_16a = _mm_and_si128(line01, mask00FF);
+              // J   L   N   P   J   L   N   P
+              const __m128i line10_16b = _mm_srli_epi16(line01, 8);
+              // i   k   m   o   i   k   m   o
+              const __m128i line11_16a = _mm_and_si128(line11, mask00FF);
+              // j   l   n   p   j   l   n   p
+              const __m128i line11_16b = _mm_srli_epi16(line11, 8);
+
+              // Calculate Averages & Round to the next integer.
+              // (I + J + i + j + 2) / 4, 0, (K + L + k + l + 2) / 4, 0, (M + N + m + n + 2) / 4, 0, (O + P + o + p + 2) / 4, 0, ...
+              // => avg8, 0, avg9, 0, avg10, 0, avg11, ...
+              const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(two_epi16, _mm_add_epi16(_mm_add_epi16(line10_16a, line10_16b), _mm_add_epi16(line11_16a, line11_16b))), 2);
+
+              // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
+              const __m128i added = _mm_packus_epi16(add0, add1);
+
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), added);
+
+              pTarget += sizeof(__m128i);
+              pSource += sizeof(__m128i) * 2;
+              pSourceLine2 += sizeof(__m128i) * 2;
+            }
           }
-        }
 
-        for (; x < targetSubBufferSize.x; x++)
-        {
-          *pTarget = (uint8_t)(((uint16_t)pSource[0] + (uint16_t)pSource[1] + (uint16_t)pSourceLine2[0] + (uint16_t)pSourceLine2[1] + 2) >> 2);
+          for (; x < targetSubBufferSize.x; x++)
+          {
+            *pTarget = (uint8_t)(((uint16_t)pSource[0] + (uint16_t)pSource[1] + (uint16_t)pSourceLine2[0] + (uint16_t)pSourceLine2[1] + 2) >> 2);
 
-          pTarget++;
-          pSource += 2;
-          pSourceLine2 += 2;
+            pTarget++;
+            pSource += 2;
+            pSourceLine2 += 2;
+          }
+
+          pSource = pSourceLine2;
         }
 
-        pSource = pSourceLine2;
-      }
+        return mR_Success;
+      }));
     }
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_Yuv422ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_Yuv422ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
-    const uint8_t *pSource = source->pPixels;
-    uint8_t *pTarget = target->pPixels;
+    const uint8_t *pSourcePixels = source->pPixels;
+    uint8_t *pTargetPixels = target->pPixels;
 
     const mVec2s size = source->currentSize;
 
-    if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+    if (pSourcePixels != pTargetPixels)
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSourcePixels, pTargetPixels, size, asyncTaskHandler));
 
-    pSource += size.x * size.y;
-    pTarget += size.x * size.y;
+    // Downsampling in place overwrites source rows that other bands may not have read yet, so that has to happen sequentially.
+    mPtr<mThreadPool> nullThreadPool = nullptr;
+    mPtr<mThreadPool> &threadPool = pSourcePixels == pTargetPixels ? nullThreadPool : asyncTaskHandler;
 
     const mVec2s targetSubBufferSize = size / 2;
+    const size_t sourceLineAdvance = size.x / 2 + targetSubBufferSize.x;
 
     const __m128i mask00FF = _mm_set1_epi16(0x00FF);
     const __m128i one_epi16 = _mm_set1_epi16(1);
 
     for (size_t subBuffer = 0; subBuffer < 2; subBuffer++)
     {
-      for (size_t y = 0; y < targetSubBufferSize.y; y++)
-      {
-        const uint8_t *pSourceLine2 = pSource + size.x / 2;
+      const uint8_t *pSourceSubBuffer = pSourcePixels + size.x * size.y + subBuffer * targetSubBufferSize.y * sourceLineAdvance;
+      uint8_t *pTargetSubBuffer = pTargetPixels + size.x * size.y + subBuffer * targetSubBufferSize.y * targetSubBufferSize.x;
 
-        size_t x = 0;
+      mERROR_CHECK(mThreadPool_ForEachRowBand(threadPool, targetSubBufferSize.y, 1, sourceLineAdvance + targetSubBufferSize.x, [&](const size_t rowStart, const size_t rowEnd)
+      {
+        const uint8_t *pSource = pSourceSubBuffer + rowStart * sourceLineAdvance;
+        uint8_t *pTarget = pTargetSubBuffer + rowStart * targetSubBufferSize.x;
 
-        if (targetSubBufferSize.x >= sizeof(__m128i))
+        for (size_t y = rowStart; y < rowEnd; y++)
         {
-          for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+          const uint8_t *pSourceLine2 = pSource + size.x / 2;
+
+          size_t x = 0;
+
+          if (targetSubBufferSize.x >= sizeof(__m128i))
           {
-            // Presume pSource/pSourceLine2 are
-            // A B C D E F G H ...
-            // a b c d e f g h ...
-
-            // A B C D E F G H ...
-            const __m128i line0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
-            // a b c d e f g h ...
-            const __m128i line1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
-
-            // A   C   E   G   ...
-            const __m128i line0_16a = _mm_and_si128(line0, mask00FF);
-            // B   D   F   H   ...
-            const __m128i line0_16b = _mm_srli_epi16(line0, 8);
-            // a   c   e   g   ...
-            const __m128i line1_16a = _mm_and_si128(line1, mask00FF);
-            // b   d   f   h   ...
-            const __m128i line1_16b = _mm_srli_epi16(line1, 8);
-
-            // Calculate Averages & Round to the next integer.
-
-            // (A + a + 1) / 2, 0, (C + c + 1) / 2, 0, (E + e + 1) / 2, 0, (G + g + 1) / 2, 0, ...
-            // avg0, 0, avg2, 0, avg4, 0, avg6, 0, ...
-            const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16a, line1_16a)), 1);
-
-            // (B + b + 1) / 2, 0, (D + d + 1) / 2, 0, (F + f + 1) / 2, 0, (H + h + 1) / 2, 0, ...
-            // avg1, 0, avg3, 0, avg5, 0, avg7, 0, ...
-            const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16b, line1_16b)), 1);
-
-            // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, ...
-            const __m128i packed = _mm_packus_epi16(_mm_unpacklo_epi16(add0, add1), _mm_unpackhi_epi16(add0, add1));
-
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), packed);
-
-            pTarget += sizeof(__m128i);
-            pSource += sizeof(__m128i);
-            pSourceLine2 += sizeof(__m128i);
+            for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+            {
+              // Presume pSource/pSourceLine2 are
+              // A B C D E F G H ...
+              // a b c d e f g h ...
+
+              // A B C D E F G H ...
+              const __m128i line0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+              // a b c d e f g h ...
+              const __m128i line1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
+
+              // A   C   E   G   ...
+              const __m128i line0_16a = _mm_and_si128(line0, mask00FF);
+              // B   D   F   H   ...
+              const __m128i line0_16b = _mm_srli_epi16(line0, 8);
+              // a   c   e   g   ...
+              const __m128i line1_16a = _mm_and_si128(line1, mask00FF);
+              // b   d   f   h   ...
+              const __m128i line1_16b = _mm_srli_epi16(line1, 8);
+
+              // Calculate Averages & Round to the next integer.
+
+              // (A + a + 1) / 2, 0, (C + c + 1) / 2, 0, (E + e + 1) / 2, 0, (G + g + 1) / 2, 0, ...
+              // avg0, 0, avg2, 0, avg4, 0, avg6, 0, ...
+              const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16a, line1_16a)), 1);
+
+              // (B + b + 1) / 2, 0, (D + d + 1) / 2, 0, (F + f + 1) / 2, 0, (H + h + 1) / 2, 0, ...
+              // avg1, 0, avg3, 0, avg5, 0, avg7, 0, ...
+              const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16b, line1_16b)), 1);
+
+              // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, ...
+              const __m128i packed = _mm_packus_epi16(_mm_unpacklo_epi16(add0, add1), _mm_unpackhi_epi16(add0, add1));
+
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), packed);
+
+              pTarget += sizeof(__m128i);
+              pSource += sizeof(__m128i);
+              pSourceLine2 += sizeof(__m128i);
+            }
           }
-        }
 
-        for (; x < targetSubBufferSize.x; x++)
-        {
-          *pTarget = (uint8_t)(((uint16_t)*pSource + (uint16_t)*pSourceLine2 + 1) >> 1);
+          for (; x < targetSubBufferSize.x; x++)
+          {
+            *pTarget = (uint8_t)(((uint16_t)*pSource + (uint16_t)*pSourceLine2 + 1) >> 1);
 
-          pTarget++;
-          pSource++;
-          pSourceLine2++;
+            pTarget++;
+            pSource++;
+            pSourceLine2++;
+          }
+
+          pSource = pSourceLine2;
         }
 
-        pSource = pSourceLine2;
-      }
+        return mR_Success;
+      }));
     }
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_Yuv440ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_Yuv440ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
-    const uint8_t *pSource = source->pPixels;
-    uint8_t *pTarget = target->pPixels;
+    const uint8_t *pSourcePixels = source->pPixels;
+    uint8_t *pTargetPixels = target->pPixels;
 
     const mVec2s size = source->currentSize;
 
-    if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+    if (pSourcePixels != pTargetPixels)
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSourcePixels, pTargetPixels, size, asyncTaskHandler));
 
-    pSource += size.x * size.y;
-    pTarget += size.x * size.y;
+    // Downsampling in place overwrites source rows that other bands may not have read yet, so that has to happen sequentially.
+    mPtr<mThreadPool> nullThreadPool = nullptr;
+    mPtr<mThreadPool> &threadPool = pSourcePixels == pTargetPixels ? nullThreadPool : asyncTaskHandler;
 
     const mVec2s targetSubBufferSize = size / 2;
+    const size_t sourceLineAdvance = targetSubBufferSize.x * 2;
 
     const __m128i mask00FF = _mm_set1_epi16(0x00FF);
     const __m128i one_epi16 = _mm_set1_epi16(1);
 
     for (size_t subBuffer = 0; subBuffer < 2; subBuffer++)
     {
-      for (size_t y = 0; y < targetSubBufferSize.y; y++)
+      const uint8_t *pSourceSubBuffer = pSourcePixels + size.x * size.y + subBuffer * targetSubBufferSize.y * sourceLineAdvance;
+      uint8_t *pTargetSubBuffer = pTargetPixels + size.x * size.y + subBuffer * targetSubBufferSize.y * targetSubBufferSize.x;
+
+      mERROR_CHECK(mThreadPool_ForEachRowBand(threadPool, targetSubBufferSize.y, 1, sourceLineAdvance + targetSubBufferSize.x, [&](const size_t rowStart, const size_t rowEnd)
       {
-        size_t x = 0;
+        const uint8_t *pSource = pSourceSubBuffer + rowStart * sourceLineAdvance;
+        uint8_t *pTarget = pTargetSubBuffer + rowStart * targetSubBufferSize.x;
 
-        if (targetSubBufferSize.x >= sizeof(__m128i))
+        for (size_t y = rowStart; y < rowEnd; y++)
         {
-          for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+          size_t x = 0;
+
+          if (targetSubBufferSize.x >= sizeof(__m128i))
           {
-            // Presume pSource is
-            // A B C D E F G H A B C D E F G H I J K L M N O P I J K L M N O P
+            for (; x < targetSubBufferSize.x - (sizeof(__m128i) - 1); x += sizeof(__m128i))
+            {
+              // Presume pSource is
+              // A B C D E F G H A B C D E F G H I J K L M N O P I J K L M N O P
 
-            // A B C D E F G H ...
-            const __m128i values0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+              // A B C D E F G H ...
+              const __m128i values0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
 
-            // I J K L M N O P ...
-            const __m128i values1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource) + 1);
+              // I J K L M N O P ...
+              const __m128i values1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource) + 1);
 
-            // A   C   E   G   ...
-            const __m128i values0_16a = _mm_and_si128(values0, mask00FF);
-            // B   D   F   H   ...
-            const __m128i values0_16b = _mm_srli_epi16(values0, 8);
-            // I   K   M   O   ...
-            const __m128i values1_16a = _mm_and_si128(values1, mask00FF);
-            // J   L   N   P   ...
-            const __m128i values1_16b = _mm_srli_epi16(values1, 8);
+              // A   C   E   G   ...
+              const __m128i values0_16a = _mm_and_si128(values0, mask00FF);
+              // B   D   F   H   ...
+              const __m128i values0_16b = _mm_srli_epi16(values0, 8);
+              // I   K   M   O   ...
+              const __m128i values1_16a = _mm_and_si128(values1, mask00FF);
+              // J   L   N   P   ...
+              const __m128i values1_16b = _mm_srli_epi16(values1, 8);
 
-            // Calculate Averages & Round to the next integer.
+              // Calculate Averages & Round to the next integer.
 
-            // (A + B + 1) / 2, 0, (C + D + 1) / 2, 0, (E + F + 1) / 2, 0, (G + H + 1) / 2, 0
-            // avg0, 0, avg1, 0, avg2, 0, avg3, 0, ...
-            const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(values0_16a, values0_16b)), 1);
+              // (A + B + 1) / 2, 0, (C + D + 1) / 2, 0, (E + F + 1) / 2, 0, (G + H + 1) / 2, 0
+              // avg0, 0, avg1, 0, avg2, 0, avg3, 0, ...
+              const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(values0_16a, values0_16b)), 1);
 
-            // (I + J + 1) / 2, 0, (K + L + 1) / 2, 0, (M + N + 1) / 2, 0, (O + P + 1) / 2, 0
-            // avg8, 0, avg9, 0, avg10, 0, avg11, 0, ...
-            const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(values1_16a, values1_16b)), 1);
+              // (I + J + 1) / 2, 0, (K + L + 1) / 2, 0, (M + N + 1) / 2, 0, (O + P + 1) / 2, 0
+              // avg8, 0, avg9, 0, avg10, 0, avg11, 0, ...
+              const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(values1_16a, values1_16b)), 1);
 
-            // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
-            const __m128i added = _mm_packus_epi16(add0, add1);
+              // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
+              const __m128i added = _mm_packus_epi16(add0, add1);
 
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), added);
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), added);
 
-            pTarget += sizeof(__m128i);
-            pSource += sizeof(__m128i) * 2;
+              pTarget += sizeof(__m128i);
+              pSource += sizeof(__m128i) * 2;
+            }
           }
-        }
 
-        for (; x < targetSubBufferSize.x; x++)
-        {
-          *pTarget = (uint8_t)(((uint16_t)pSource[0] + (uint16_t)pSource[1] + 1) >> 1);
+          for (; x < targetSubBufferSize.x; x++)
+          {
+            *pTarget = (uint8_t)(((uint16_t)pSource[0] + (uint16_t)pSource[1] + 1) >> 1);
 
-          pTarget++;
-          pSource += 2;
+            pTarget++;
+            pSource += 2;
+          }
         }
-      }
+
+        return mR_Success;
+      }));
     }
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_Yuv411ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_Yuv411ToYuv420, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
-    const uint8_t *pSource = source->pPixels;
-    uint8_t *pTarget = target->pPixels;
+    const uint8_t *pSourcePixels = source->pPixels;
+    uint8_t *pTargetPixels = target->pPixels;
 
     const mVec2s size = source->currentSize;
 
-    if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+    if (pSourcePixels != pTargetPixels)
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSourcePixels, pTargetPixels, size, asyncTaskHandler));
 
-    pSource += size.x * size.y;
-    pTarget += size.x * size.y;
+    // Downsampling in place overwrites source rows that other bands may not have read yet, so that has to happen sequentially.
+    mPtr<mThreadPool> nullThreadPool = nullptr;
+    mPtr<mThreadPool> &threadPool = pSourcePixels == pTargetPixels ? nullThreadPool : asyncTaskHandler;
 
     const mVec2s targetSubBufferSize = size / 2;
+    const size_t sourceLineAdvance = size.x / 4 + targetSubBufferSize.x / 2;
 
     const __m128i mask00FF = _mm_set1_epi16(0x00FF);
     const __m128i one_epi16 = _mm_set1_epi16(1);
 
     for (size_t subBuffer = 0; subBuffer < 2; subBuffer++)
     {
-      for (size_t y = 0; y < targetSubBufferSize.y; y++)
-      {
-        const uint8_t *pSourceLine2 = pSource + size.x / 4;
+      const uint8_t *pSourceSubBuffer = pSourcePixels + size.x * size.y + subBuffer * targetSubBufferSize.y * sourceLineAdvance;
+      uint8_t *pTargetSubBuffer = pTargetPixels + size.x * size.y + subBuffer * targetSubBufferSize.y * targetSubBufferSize.x;
 
-        size_t x = 0;
+      mERROR_CHECK(mThreadPool_ForEachRowBand(threadPool, targetSubBufferSize.y, 1, sourceLineAdvance + targetSubBufferSize.x, [&](const size_t rowStart, const size_t rowEnd)
+      {
+        const uint8_t *pSource = pSourceSubBuffer + rowStart * sourceLineAdvance;
+        uint8_t *pTarget = pTargetSubBuffer + rowStart * targetSubBufferSize.x;
 
-        if (targetSubBufferSize.x >= sizeof(__m128i) * 2)
+        for (size_t y = rowStart; y < rowEnd; y++)
         {
-          for (; x < targetSubBufferSize.x - (sizeof(__m128i) * 2 - 1); x += sizeof(__m128i) * 2)
-          {
-            // Presume pSource/pSourceLine2 are
-            // A B C D E F G H ...
-            // a b c d e f g h ...
-
-            // A B C D E F G H ...
-            const __m128i line0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
-            // a b c d e f g h ...
-            const __m128i line1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
-
-            // A   C   E   G   ...
-            const __m128i line0_16a = _mm_and_si128(line0, mask00FF);
-            // B   D   F   H   ...
-            const __m128i line0_16b = _mm_srli_epi16(line0, 8);
-            // a   c   e   g   ...
-            const __m128i line1_16a = _mm_and_si128(line1, mask00FF);
-            // b   d   f   h   ...
-            const __m128i line1_16b = _mm_srli_epi16(line1, 8);
+          const uint8_t *pSourceLine2 = pSource + size.x / 4;
 
-            // Calculate Averages & Round to the next integer.
+          size_t x = 0;
 
-            // (A + a + 1) / 2, 0, (C + c + 1) / 2, 0, (E + e + 1) / 2, 0, (G + g + 1) / 2, 0, ...
-            // avg0, 0, avg2, 0, avg4, 0, avg6, 0, ...
-            const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16a, line1_16a)), 1);
-
-            // (B + b + 1) / 2, 0, (D + d + 1) / 2, 0, (F + f + 1) / 2, 0, (H + h + 1) / 2, 0, ...
-            // avg1, 0, avg3, 0, avg5, 0, avg7, 0, ...
-            const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16b, line1_16b)), 1);
-
-            // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
-            const __m128i packed = _mm_packus_epi16(_mm_unpacklo_epi16(add0, add1), _mm_unpackhi_epi16(add0, add1));
-
-            // avg0, avg0, avg1, avg1, avg2, avg2, avg3, avg3, avg4, avg4, avg5, avg5, avg6, avg6, avg7, avg7
-            const __m128i packed0 = _mm_unpacklo_epi8(packed, packed);
-
-            // avg8, avg8, avg9, avg9, avg10, avg10, avg11, avg11, avg12, avg12, avg13, avg13, avg14, avg14, avg15, avg15
-            const __m128i packed1 = _mm_unpackhi_epi8(packed, packed);
+          if (targetSubBufferSize.x >= sizeof(__m128i) * 2)
+          {
+            for (; x < targetSubBufferSize.x - (sizeof(__m128i) * 2 - 1); x += sizeof(__m128i) * 2)
+            {
+              // Presume pSource/pSourceLine2 are
+              // A B C D E F G H ...
+              // a b c d e f g h ...
+
+              // A B C D E F G H ...
+              const __m128i line0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+              // a b c d e f g h ...
+              const __m128i line1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSourceLine2));
+
+              // A   C   E   G   ...
+              const __m128i line0_16a = _mm_and_si128(line0, mask00FF);
+              // B   D   F   H   ...
+              const __m128i line0_16b = _mm_srli_epi16(line0, 8);
+              // a   c   e   g   ...
+              const __m128i line1_16a = _mm_and_si128(line1, mask00FF);
+              // b   d   f   h   ...
+              const __m128i line1_16b = _mm_srli_epi16(line1, 8);
+
+              // Calculate Averages & Round to the next integer.
+
+              // (A + a + 1) / 2, 0, (C + c + 1) / 2, 0, (E + e + 1) / 2, 0, (G + g + 1) / 2, 0, ...
+              // avg0, 0, avg2, 0, avg4, 0, avg6, 0, ...
+              const __m128i add0 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16a, line1_16a)), 1);
+
+              // (B + b + 1) / 2, 0, (D + d + 1) / 2, 0, (F + f + 1) / 2, 0, (H + h + 1) / 2, 0, ...
+              // avg1, 0, avg3, 0, avg5, 0, avg7, 0, ...
+              const __m128i add1 = _mm_srli_epi16(_mm_add_epi16(one_epi16, _mm_add_epi16(line0_16b, line1_16b)), 1);
+
+              // avg0, avg1, avg2, avg3, avg4, avg5, avg6, avg7, avg8, avg9, avg10, avg11, avg12, avg13, avg14, avg15
+              const __m128i packed = _mm_packus_epi16(_mm_unpacklo_epi16(add0, add1), _mm_unpackhi_epi16(add0, add1));
+
+              // avg0, avg0, avg1, avg1, avg2, avg2, avg3, avg3, avg4, avg4, avg5, avg5, avg6, avg6, avg7, avg7
+              const __m128i packed0 = _mm_unpacklo_epi8(packed, packed);
+
+              // avg8, avg8, avg9, avg9, avg10, avg10, avg11, avg11, avg12, avg12, avg13, avg13, avg14, avg14, avg15, avg15
+              const __m128i packed1 = _mm_unpackhi_epi8(packed, packed);
+
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), packed0);
+              _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget) + 1, packed1);
+
+              pTarget += sizeof(__m128i) * 2;
+              pSource += sizeof(__m128i);
+              pSourceLine2 += sizeof(__m128i);
+            }
+          }
 
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget), packed0);
-            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget) + 1, packed1);
+          for (; x < targetSubBufferSize.x - 1; x += 2)
+          {
+            pTarget[0] = pTarget[1] = (uint8_t)(((uint16_t)*pSource + (uint16_t)*pSourceLine2 + 1) >> 1);
 
-            pTarget += sizeof(__m128i) * 2;
-            pSource += sizeof(__m128i);
-            pSourceLine2 += sizeof(__m128i);
+            pTarget += 2;
+            pSource++;
+            pSourceLine2++;
           }
-        }
 
-        for (; x < targetSubBufferSize.x - 1; x += 2)
-        {
-          pTarget[0] = pTarget[1] = (uint8_t)(((uint16_t)*pSource + (uint16_t)*pSourceLine2 + 1) >> 1);
-
-          pTarget += 2;
-          pSource++;
-          pSourceLine2++;
-        }
+          if (x < targetSubBufferSize.x)
+          {
+            if (x > 0)
+              *pTarget = *(pTarget - 1);
+            else
+              *pTarget = 0x7F;
 
-        if (x < targetSubBufferSize.x)
-        {
-          if (x > 0)
-            *pTarget = *(pTarget - 1);
-          else
-            *pTarget = 0x7F;
+            pTarget++;
+          }
 
-          pTarget++;
+          pSource = pSourceLine2;
         }
 
-        pSource = pSourceLine2;
-      }
+        return mR_Success;
+      }));
     }
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_YuvXXXToMonochrome8, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_YuvXXXToMonochrome8, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
@@ -2008,12 +2046,12 @@ namespace mPixelFormat_Transform
     const mVec2s size = source->currentSize;
 
     if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSource, pTarget, size, asyncTaskHandler));
 
     mRETURN_SUCCESS();
   }
 
-  mFUNCTION(mPixelFormat_Transform_Monochrome8ToYuvXXX, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mPixelFormat targetPixelFormat, mPtr<mThreadPool> & /*asyncTaskHandler */)
+  mFUNCTION(mPixelFormat_Transform_Monochrome8ToYuvXXX, mPtr<mImageBuffer> &source, mPtr<mImageBuffer> &target, const mPixelFormat targetPixelFormat, mPtr<mThreadPool> &asyncTaskHandler)
   {
     mFUNCTION_SETUP();
 
@@ -2023,7 +2061,7 @@ namespace mPixelFormat_Transform
     const mVec2s size = source->currentSize;
 
     if (pSource != pTarget)
-      mMemcpy(pTarget, pSource, size.x * size.y);
+      mERROR_CHECK(mPixelFormat_Transform_CopyPlane(pSource, pTarget, size, asyncTaskHandler));
 
     pTarget += size.x * size.y;
 
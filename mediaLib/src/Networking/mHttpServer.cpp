@@ -3,6 +3,7 @@
 #include "mTcpSocket.h"
 #include "mThread.h"
 #include "mThreadPool.h"
+#include "mArenaAllocator.h"
 
 #include "http_parser/src/http_parser.h"
 
@@ -42,7 +43,7 @@ static mFUNCTION(mHttpServer_Destroy_Internal, IN_OUT mHttpServer *pHttpServer);
 static mFUNCTION(mHttpServer_Thread_Internal, IN mHttpServer *pServer);
 static mFUNCTION(mHttpServer_StaleTcpHandlerThread_Internal, IN mHttpServer *pServer);
 static mFUNCTION(mHttpServer_SendResponsePacket_Internal, mPtr<mTcpClient> &client, const mPtr<mHttpResponse> &response, IN mAllocator *pAllocator);
-static mFUNCTION(mHttpServer_RespondWithError_Internal, IN mHttpServer *pServer, mPtr<mTcpClient> &client, const mHttpResponseStatusCode statusCode, const mString &errorString, IN mAllocator *pAllocator);
+static mFUNCTION(mHttpServer_RespondWithError_Internal, IN mHttpServer *pServer, mPtr<mTcpClient> &client, const mHttpResponseStatusCode statusCode, const mString &errorString, IN mAllocator *pPacketAllocator);
 
 static int32_t mHttpServer_OnUrl_Internal(http_parser *, const char *at, size_t length);
 static int32_t mHttpServer_OnHeaderField_Internal(http_parser *, const char *at, size_t length);
@@ -297,13 +298,30 @@ static mFUNCTION(mHttpServer_StaleTcpHandlerThread_Internal, IN  mHttpServer *pS
 
 static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<mTcpClient> &client)
 {
-  // TODO: Use Arena Allocator.
+  // Requests and responses are handed to the request handlers, which may keep copies of their contents, so they're allocated from the allocator of the server.
+  // Response packets never leave this function, so they're allocated from the frame allocator of the worker thread and released after every request.
+  mAllocator *pAllocator = pServer->pAllocator;
+  mAllocator *pPacketAllocator = nullptr;
+  mArenaAllocator_Marker marker;
+  const bool usesFrameAllocator = mSUCCEEDED(mSILENCE_ERROR(mArenaAllocator_GetThreadFrameAllocator(&pPacketAllocator))) && mSUCCEEDED(mSILENCE_ERROR(mArenaAllocator_GetMarker(pPacketAllocator, &marker)));
+
+  if (!usesFrameAllocator)
+    pPacketAllocator = pServer->pAllocator;
+
+  mDEFER_IF(usesFrameAllocator,
+    const mResult result = mArenaAllocator_ResetToMarker(pPacketAllocator, marker);
+    mASSERT_DEBUG(mSUCCEEDED(result), "Failed to reset the frame allocator.");
+    mUnused(result));
 
   char data[8 * 1024];
   size_t bytesReceived = 0;
 
   while (mSUCCEEDED(mSILENCE_ERROR(mTcpClient_Receive(client, data, sizeof(data), &bytesReceived))))
   {
+    // All response packets of the previous request have been released by now.
+    if (usesFrameAllocator && mFAILED(mArenaAllocator_ResetToMarker(pPacketAllocator, marker)))
+      return;
+
     data[mMin(bytesReceived + 1, sizeof(data) - 1)] = '\0';
 
     http_parser parser;
@@ -312,7 +330,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
     mUniqueContainer<mHttpRequest_Parser> request;
     mUniqueContainer<mHttpRequest_Parser>::CreateWithCleanupFunction(&request, mHttpRequest_Parser_Destroy_Internal);
 
-    if (mFAILED(mHttpRequest_Parser_Init_Internal(request, pServer->pAllocator, client)))
+    if (mFAILED(mHttpRequest_Parser_Init_Internal(request, pAllocator, client)))
       return;
 
     parser.data = request.GetPointer();
@@ -321,7 +339,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
 
     if (mFAILED(request->result))
     {
-      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Failed to parse HTTP Header.", pServer->pAllocator);
+      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Failed to parse HTTP Header.", pPacketAllocator);
 
       return;
     }
@@ -330,7 +348,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
 
     if (parser.type != HTTP_REQUEST)
     {
-      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Expected HTTP Request.", pServer->pAllocator);
+      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Expected HTTP Request.", pPacketAllocator);
 
       return;
     }
@@ -339,9 +357,9 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
 
     if (request->requestMethod == mHRM_Post && request->body.bytes > 1)
     {
-      if (mFAILED(mHttpRequest_ParseArguments_Internal(request->body.c_str(), request->postParameters, pServer->pAllocator, false)))
+      if (mFAILED(mHttpRequest_ParseArguments_Internal(request->body.c_str(), request->postParameters, pAllocator, false)))
       {
-        mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Failed to parse POST parameters.", pServer->pAllocator);
+        mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_BadRequest, "Failed to parse POST parameters.", pPacketAllocator);
 
         return;
       }
@@ -350,7 +368,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
     mUniqueContainer<mHttpResponse> response;
     mUniqueContainer<mHttpResponse>::ConstructWithCleanupFunction(&response, mHttpResponse_Destroy_Internal);
 
-    if (mFAILED(mHttpResponse_Init_Internal(response, pServer->pAllocator)))
+    if (mFAILED(mHttpResponse_Init_Internal(response, pAllocator)))
       return;
 
     bool handled = false;
@@ -363,9 +381,9 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
 
       if (_handler->pHandleRequest && mSUCCEEDED(_handler->pHandleRequest(_handler, requestWrap, &handled, response)) && handled)
       {
-        if (mFAILED(mHttpServer_SendResponsePacket_Internal(client, response, pServer->pAllocator)))
+        if (mFAILED(mHttpServer_SendResponsePacket_Internal(client, response, pPacketAllocator)))
         {
-          mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_InternalServerError, "Failed to send response packet.", pServer->pAllocator);
+          mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_InternalServerError, "Failed to send response packet.", pPacketAllocator);
 
           return;
         }
@@ -376,7 +394,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
 
     if (!handled)
     {
-      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_InternalServerError, "No Response Handler found for this request.", pServer->pAllocator);
+      mHttpServer_RespondWithError_Internal(pServer, client, mHRSC_InternalServerError, "No Response Handler found for this request.", pPacketAllocator);
 
       return;
     }
@@ -401,7 +419,7 @@ static void mHttpServer_HandleTcpClient_Internal(IN mHttpServer *pServer, mPtr<m
   return;
 }
 
-static mFUNCTION(mHttpServer_RespondWithError_Internal, IN mHttpServer *pServer, mPtr<mTcpClient> &client, const mHttpResponseStatusCode statusCode, const mString &errorString, IN mAllocator *pAllocator)
+static mFUNCTION(mHttpServer_RespondWithError_Internal, IN mHttpServer *pServer, mPtr<mTcpClient> &client, const mHttpResponseStatusCode statusCode, const mString &errorString, IN mAllocator *pPacketAllocator)
 {
   mFUNCTION_SETUP();
 
@@ -412,14 +430,14 @@ static mFUNCTION(mHttpServer_RespondWithError_Internal, IN mHttpServer *pServer,
   mUniqueContainer<mHttpResponse> response;
   mUniqueContainer<mHttpResponse>::ConstructWithCleanupFunction(&response, mHttpResponse_Destroy_Internal);
 
-  mERROR_CHECK(mHttpResponse_Init_Internal(response, pAllocator));
+  mERROR_CHECK(mHttpResponse_Init_Internal(response, pServer->pAllocator));
   mERROR_CHECK(mBinaryChunk_GrowBack(response->responseStream, (errorString.bytes + 1023) & ~(uint64_t)1023));
 
   response->statusCode = statusCode;
 
   mERROR_CHECK(pServer->errorRequestHandler->pHandleRequest(pServer->errorRequestHandler, errorString, response));
 
-  mERROR_CHECK(mHttpServer_SendResponsePacket_Internal(client, response, pAllocator));
+  mERROR_CHECK(mHttpServer_SendResponsePacket_Internal(client, response, pPacketAllocator));
 
   mRETURN_SUCCESS();
 }
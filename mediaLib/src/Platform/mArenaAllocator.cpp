@@ -0,0 +1,362 @@
+#include "mArenaAllocator.h"
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "15RgNX9qljwZ3n20Domlkvd3qhkbCTuFCI90uVJbxGTFejYe5Tz3dVKfxi80PMb5zun896hmRX5ul4Ld"
+#endif
+
+struct mArenaAllocator_Chunk
+{
+  mArenaAllocator_Chunk *pNext;
+  size_t capacity; // in bytes, excluding the chunk header.
+  size_t offset;
+};
+
+// Every allocation is preceded by a header containing its size, so reallocations know how much to copy.
+constexpr size_t mArenaAllocator_ChunkHeaderSize = (sizeof(mArenaAllocator_Chunk) + mArenaAllocator_Alignment - 1) & ~(mArenaAllocator_Alignment - 1);
+constexpr size_t mArenaAllocator_AllocationHeaderSize = mArenaAllocator_Alignment;
+
+struct mArenaAllocator_State
+{
+  mAllocator *pBackingAllocator;
+  mArenaAllocator_Chunk *pFirstChunk;
+  mArenaAllocator_Chunk *pCurrentChunk;
+  uint8_t *pLastAllocation;
+  size_t chunkSize;
+  bool rewindOnFree;
+};
+
+struct mArenaAllocator_ThreadFrameAllocator
+{
+  mAllocator allocator;
+
+  ~mArenaAllocator_ThreadFrameAllocator()
+  {
+    if (allocator.initialized)
+      mAllocator_Destroy(&allocator);
+  }
+};
+
+static thread_local mArenaAllocator_ThreadFrameAllocator mArenaAllocator_CurrentThreadFrameAllocator;
+
+static mFUNCTION(mArenaAllocator_Alloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mArenaAllocator_AllocZero_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mArenaAllocator_Realloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mArenaAllocator_Free_Internal, IN uint8_t *pData, IN void *pUserData);
+static mFUNCTION(mArenaAllocator_Destroy_Internal, IN mAllocator *pAllocator, IN void *pUserData);
+static mFUNCTION(mArenaAllocator_GetState_Internal, IN mAllocator *pAllocator, OUT mArenaAllocator_State **ppState);
+static mFUNCTION(mArenaAllocator_NextChunk_Internal, IN mArenaAllocator_State *pState, const size_t requiredBytes);
+
+inline uint8_t * mArenaAllocator_GetChunkData_Internal(IN mArenaAllocator_Chunk *pChunk)
+{
+  return reinterpret_cast<uint8_t *>(pChunk) + mArenaAllocator_ChunkHeaderSize;
+}
+
+inline size_t mArenaAllocator_GetRequiredBytes_Internal(const size_t bytes)
+{
+  return ((bytes + mArenaAllocator_Alignment - 1) & ~(mArenaAllocator_Alignment - 1)) + mArenaAllocator_AllocationHeaderSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mArenaAllocator_Create, OUT mAllocator *pAllocator, IN OPTIONAL mAllocator *pBackingAllocator, const size_t chunkSize /* = mArenaAllocator_DefaultChunkSize */, const bool rewindOnFree /* = true */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pAllocator == nullptr, mR_ArgumentNull);
+  mERROR_IF(chunkSize < mArenaAllocator_AllocationHeaderSize, mR_ArgumentOutOfBounds);
+
+  mArenaAllocator_State *pState = nullptr;
+  mERROR_CHECK(mAllocator_AllocateZero(pBackingAllocator, &pState, 1));
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pBackingAllocator, &pState));
+
+  pState->pBackingAllocator = pBackingAllocator;
+  pState->chunkSize = chunkSize;
+  pState->rewindOnFree = rewindOnFree;
+
+  mERROR_CHECK(mAllocator_Create(pAllocator, &mArenaAllocator_Alloc_Internal, &mArenaAllocator_Realloc_Internal, &mArenaAllocator_Free_Internal, &mArenaAllocator_AllocZero_Internal, &mArenaAllocator_Destroy_Internal, pState));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mArenaAllocator_Reset, IN mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_State *pState = nullptr;
+  mERROR_CHECK(mArenaAllocator_GetState_Internal(pAllocator, &pState));
+
+  // Subsequent chunks are reset once the arena advances to them.
+  pState->pCurrentChunk = pState->pFirstChunk;
+  pState->pLastAllocation = nullptr;
+
+  if (pState->pCurrentChunk != nullptr)
+    pState->pCurrentChunk->offset = 0;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mArenaAllocator_GetMarker, IN mAllocator *pAllocator, OUT mArenaAllocator_Marker *pMarker)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pMarker == nullptr, mR_ArgumentNull);
+
+  mArenaAllocator_State *pState = nullptr;
+  mERROR_CHECK(mArenaAllocator_GetState_Internal(pAllocator, &pState));
+
+  pMarker->pChunk = pState->pCurrentChunk;
+  pMarker->offset = pState->pCurrentChunk == nullptr ? 0 : pState->pCurrentChunk->offset;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mArenaAllocator_ResetToMarker, IN mAllocator *pAllocator, const mArenaAllocator_Marker &marker)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_State *pState = nullptr;
+  mERROR_CHECK(mArenaAllocator_GetState_Internal(pAllocator, &pState));
+
+  if (marker.pChunk == nullptr)
+  {
+    mERROR_CHECK(mArenaAllocator_Reset(pAllocator));
+    mRETURN_SUCCESS();
+  }
+
+  mERROR_IF(marker.offset > marker.pChunk->capacity, mR_InvalidParameter);
+
+  pState->pCurrentChunk = marker.pChunk;
+  pState->pCurrentChunk->offset = marker.offset;
+  pState->pLastAllocation = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mArenaAllocator_GetSize, IN mAllocator *pAllocator, OUT OPTIONAL size_t *pReservedBytes, OUT OPTIONAL size_t *pUsedBytes)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_State *pState = nullptr;
+  mERROR_CHECK(mArenaAllocator_GetState_Internal(pAllocator, &pState));
+
+  size_t reservedBytes = 0;
+  size_t usedBytes = 0;
+  bool beforeCurrentChunk = pState->pCurrentChunk != nullptr;
+
+  for (mArenaAllocator_Chunk *pChunk = pState->pFirstChunk; pChunk != nullptr; pChunk = pChunk->pNext)
+  {
+    reservedBytes += pChunk->capacity;
+
+    if (beforeCurrentChunk)
+    {
+      usedBytes += pChunk->offset;
+      beforeCurrentChunk = (pChunk != pState->pCurrentChunk);
+    }
+  }
+
+  if (pReservedBytes != nullptr)
+    *pReservedBytes = reservedBytes;
+
+  if (pUsedBytes != nullptr)
+    *pUsedBytes = usedBytes;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mArenaAllocator_GetThreadFrameAllocator, OUT mAllocator **ppAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(ppAllocator == nullptr, mR_ArgumentNull);
+
+  mAllocator *pAllocator = &mArenaAllocator_CurrentThreadFrameAllocator.allocator;
+
+  if (!pAllocator->initialized)
+    mERROR_CHECK(mArenaAllocator_Create(pAllocator, nullptr));
+
+  *ppAllocator = pAllocator;
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mArenaAllocator_Alloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_State *pState = reinterpret_cast<mArenaAllocator_State *>(pUserData);
+
+  const size_t bytes = size * count;
+  mERROR_IF(size != 0 && bytes / size != count, mR_ArgumentOutOfBounds);
+
+  const size_t requiredBytes = mArenaAllocator_GetRequiredBytes_Internal(bytes);
+  mArenaAllocator_Chunk *pChunk = pState->pCurrentChunk;
+
+  if (pChunk == nullptr || pChunk->capacity - pChunk->offset < requiredBytes)
+  {
+    mERROR_CHECK(mArenaAllocator_NextChunk_Internal(pState, requiredBytes));
+    pChunk = pState->pCurrentChunk;
+  }
+
+  uint8_t *pHeader = mArenaAllocator_GetChunkData_Internal(pChunk) + pChunk->offset;
+  *reinterpret_cast<size_t *>(pHeader) = bytes;
+  pChunk->offset += requiredBytes;
+
+  *ppData = pHeader + mArenaAllocator_AllocationHeaderSize;
+  pState->pLastAllocation = *ppData;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_AllocZero_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mArenaAllocator_Alloc_Internal(ppData, size, count, pUserData));
+
+  // Chunks are reused after resetting the arena, so the memory has to be cleared explicitly.
+  mERROR_CHECK(mMemset(*ppData, size * count, 0));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_Realloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  if (*ppData == nullptr)
+  {
+    mERROR_CHECK(mArenaAllocator_Alloc_Internal(ppData, size, count, pUserData));
+    mRETURN_SUCCESS();
+  }
+
+  mArenaAllocator_State *pState = reinterpret_cast<mArenaAllocator_State *>(pUserData);
+
+  const size_t bytes = size * count;
+  mERROR_IF(size != 0 && bytes / size != count, mR_ArgumentOutOfBounds);
+
+  uint8_t *pHeader = *ppData - mArenaAllocator_AllocationHeaderSize;
+  const size_t previousBytes = *reinterpret_cast<size_t *>(pHeader);
+
+  // The most recent allocation can simply be resized if the current chunk has enough space left.
+  if (*ppData == pState->pLastAllocation)
+  {
+    mArenaAllocator_Chunk *pChunk = pState->pCurrentChunk;
+    const size_t offset = (size_t)(pHeader - mArenaAllocator_GetChunkData_Internal(pChunk));
+    const size_t requiredBytes = mArenaAllocator_GetRequiredBytes_Internal(bytes);
+
+    if (pChunk->capacity - offset >= requiredBytes)
+    {
+      *reinterpret_cast<size_t *>(pHeader) = bytes;
+      pChunk->offset = offset + requiredBytes;
+
+      mRETURN_SUCCESS();
+    }
+  }
+  else if (bytes <= previousBytes)
+  {
+    *reinterpret_cast<size_t *>(pHeader) = bytes;
+
+    mRETURN_SUCCESS();
+  }
+
+  uint8_t *pData = nullptr;
+  mERROR_CHECK(mArenaAllocator_Alloc_Internal(&pData, size, count, pUserData));
+
+  mERROR_CHECK(mMemcpy(pData, *ppData, mMin(bytes, previousBytes)));
+
+  *ppData = pData;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_Free_Internal, IN uint8_t *pData, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_State *pState = reinterpret_cast<mArenaAllocator_State *>(pUserData);
+
+  if (pState->rewindOnFree && pData != nullptr && pData == pState->pLastAllocation)
+  {
+    mArenaAllocator_Chunk *pChunk = pState->pCurrentChunk;
+
+    pChunk->offset = (size_t)(pData - mArenaAllocator_AllocationHeaderSize - mArenaAllocator_GetChunkData_Internal(pChunk));
+    pState->pLastAllocation = nullptr;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_Destroy_Internal, IN mAllocator * /* pAllocator */, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pUserData == nullptr, mR_ArgumentNull);
+
+  mArenaAllocator_State *pState = reinterpret_cast<mArenaAllocator_State *>(pUserData);
+  mAllocator *pBackingAllocator = pState->pBackingAllocator;
+
+  mArenaAllocator_Chunk *pChunk = pState->pFirstChunk;
+
+  while (pChunk != nullptr)
+  {
+    mArenaAllocator_Chunk *pNext = pChunk->pNext;
+    mERROR_CHECK(mAllocator_FreePtr(pBackingAllocator, &pChunk));
+    pChunk = pNext;
+  }
+
+  mERROR_CHECK(mAllocator_FreePtr(pBackingAllocator, &pState));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_GetState_Internal, IN mAllocator *pAllocator, OUT mArenaAllocator_State **ppState)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pAllocator == nullptr, mR_ArgumentNull);
+  mERROR_IF(!pAllocator->initialized || pAllocator->pAllocate != &mArenaAllocator_Alloc_Internal || pAllocator->pUserData == nullptr, mR_InvalidParameter);
+
+  *ppState = reinterpret_cast<mArenaAllocator_State *>(pAllocator->pUserData);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mArenaAllocator_NextChunk_Internal, IN mArenaAllocator_State *pState, const size_t requiredBytes)
+{
+  mFUNCTION_SETUP();
+
+  mArenaAllocator_Chunk *pNext = pState->pCurrentChunk == nullptr ? pState->pFirstChunk : pState->pCurrentChunk->pNext;
+
+  // Reuse chunks that have been released by a reset.
+  if (pNext != nullptr && pNext->capacity >= requiredBytes)
+  {
+    pNext->offset = 0;
+    pState->pCurrentChunk = pNext;
+
+    mRETURN_SUCCESS();
+  }
+
+  const size_t capacity = mMax(pState->chunkSize, requiredBytes);
+
+  uint8_t *pChunkData = nullptr;
+  mERROR_CHECK(mAllocator_Allocate(pState->pBackingAllocator, &pChunkData, mArenaAllocator_ChunkHeaderSize + capacity));
+
+  mArenaAllocator_Chunk *pChunk = reinterpret_cast<mArenaAllocator_Chunk *>(pChunkData);
+  pChunk->capacity = capacity;
+  pChunk->offset = 0;
+  pChunk->pNext = pNext; // Chunks that were too small stay in the list to be reused after the next reset.
+
+  if (pState->pCurrentChunk == nullptr)
+    pState->pFirstChunk = pChunk;
+  else
+    pState->pCurrentChunk->pNext = pChunk;
+
+  pState->pCurrentChunk = pChunk;
+
+  mRETURN_SUCCESS();
+}
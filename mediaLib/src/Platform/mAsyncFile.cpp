@@ -0,0 +1,733 @@
+#include "mAsyncFile.h"
+#include "mQueue.h"
+#include "mThreadPool.h"
+
+#include <mutex>
+#include <condition_variable>
+
+#ifndef mPLATFORM_WINDOWS
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <errno.h>
+ #include <sys/stat.h>
+#endif
+
+#if defined(mPLATFORM_LINUX) && __has_include(<linux/io_uring.h>)
+ #include <sys/mman.h>
+ #include <sys/syscall.h>
+ #include <sys/uio.h>
+ #include <linux/io_uring.h>
+
+ #define mASYNC_FILE_IO_URING 1
+#endif
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "KVLwguLxA+hOpIUkqinyKWKU4jkmYVzFLKv1+m/5SoYqCSnlsNQ2Fl6v2pnvKReW9jygxRzsIGtJ+lgf"
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+struct mAsyncFile
+{
+#ifdef mPLATFORM_WINDOWS
+  HANDLE handle;
+#else
+  int fileDescriptor;
+#endif
+  size_t size;
+  mAsyncFileQueue *pQueue;
+};
+
+struct mAsyncFile_Request
+{
+  mPtr<mAsyncFile> file; // Keeps the file open until the request has completed.
+  size_t offset;
+  size_t size;
+  uint8_t *pBuffer;
+  mAsyncFile_Callback callback;
+  mResult result;
+  size_t bytesRead;
+
+#ifdef mASYNC_FILE_IO_URING
+  iovec ioVector;
+#endif
+};
+
+#ifdef mASYNC_FILE_IO_URING
+struct mAsyncFileQueue_IoUring
+{
+  int ringFileDescriptor;
+
+  uint8_t *pSubmissionRing;
+  size_t submissionRingSize;
+  uint32_t *pSubmissionTail;
+  uint32_t *pSubmissionArray;
+  uint32_t submissionMask;
+  io_uring_sqe *pSubmissionEntries;
+  size_t submissionEntriesSize;
+
+  uint8_t *pCompletionRing; // Equals `pSubmissionRing` if the kernel maps both rings at once.
+  size_t completionRingSize;
+  uint32_t *pCompletionHead;
+  uint32_t *pCompletionTail;
+  uint32_t completionMask;
+  io_uring_cqe *pCompletionEntries;
+};
+#endif
+
+struct mAsyncFileQueue
+{
+  mAllocator *pAllocator;
+  mAsyncFileQueue_Backend backend;
+  size_t queueDepth;
+  size_t inFlightCount;
+
+  mPtr<mQueue<mAsyncFile_Request *>> pendingRequests;
+
+  // Thread pool backend.
+  mPtr<mTasklessThreadPool> threadPool;
+  std::mutex completionMutex;
+  std::condition_variable completionConditionVariable;
+  mPtr<mQueue<mAsyncFile_Request *>> completedRequests; // Has capacity for `queueDepth` requests, so worker threads never allocate.
+
+#ifdef mASYNC_FILE_IO_URING
+  mAsyncFileQueue_IoUring ioUring;
+#endif
+};
+
+static void mAsyncFileQueue_Destroy_Internal(IN_OUT mAsyncFileQueue *pQueue);
+static mFUNCTION(mAsyncFileQueue_Submit_Internal, IN mAsyncFileQueue *pQueue);
+static mFUNCTION(mAsyncFileQueue_Reap_Internal, IN mAsyncFileQueue *pQueue, const bool wait, const bool executeCallbacks, OUT size_t *pCompletedCount);
+static mFUNCTION(mAsyncFileQueue_Complete_Internal, IN mAsyncFileQueue *pQueue, IN mAsyncFile_Request *pRequest, const bool executeCallback);
+static mFUNCTION(mAsyncFile_Destroy_Internal, IN_OUT mAsyncFile *pFile);
+static mFUNCTION(mAsyncFile_DestroyRequest_Internal, IN mAllocator *pAllocator, IN_OUT mAsyncFile_Request **ppRequest);
+static void mAsyncFile_ReadBlocking_Internal(IN_OUT mAsyncFile_Request *pRequest);
+
+#ifdef mASYNC_FILE_IO_URING
+static mFUNCTION(mAsyncFileQueue_IoUring_Create_Internal, IN mAsyncFileQueue *pQueue);
+static void mAsyncFileQueue_IoUring_Destroy_Internal(IN mAsyncFileQueue *pQueue);
+static void mAsyncFileQueue_IoUring_Prepare_Internal(IN mAsyncFileQueue *pQueue, IN mAsyncFile_Request *pRequest);
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mAsyncFileQueue_Create, OUT mPtr<mAsyncFileQueue> *pQueue, IN OPTIONAL mAllocator *pAllocator, const size_t queueDepth /* = 64 */, const mAsyncFileQueue_Backend backend /* = mAFQ_B_Default */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pQueue == nullptr, mR_ArgumentNull);
+  mERROR_IF(queueDepth == 0 || queueDepth > 4096, mR_InvalidParameter);
+
+#ifndef mASYNC_FILE_IO_URING
+  mERROR_IF(backend == mAFQ_B_IoUring, mR_NotSupported);
+#endif
+
+  mDEFER_CALL_ON_ERROR(pQueue, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate<mAsyncFileQueue>(pQueue, pAllocator, mAsyncFileQueue_Destroy_Internal, 1));
+
+  new (pQueue->GetPointer()) mAsyncFileQueue();
+
+  (*pQueue)->pAllocator = pAllocator;
+  (*pQueue)->queueDepth = queueDepth;
+  (*pQueue)->backend = mAFQ_B_ThreadPool;
+
+  mERROR_CHECK(mQueue_Create(&(*pQueue)->pendingRequests, pAllocator));
+
+#ifdef mASYNC_FILE_IO_URING
+  (*pQueue)->ioUring.ringFileDescriptor = -1;
+
+  if (backend != mAFQ_B_ThreadPool)
+  {
+    const mResult result = mSILENCE_ERROR(mAsyncFileQueue_IoUring_Create_Internal(pQueue->GetPointer()));
+
+    if (mSUCCEEDED(result))
+      (*pQueue)->backend = mAFQ_B_IoUring;
+    else if (backend == mAFQ_B_IoUring)
+      mERROR_CHECK(result);
+  }
+#endif
+
+  if ((*pQueue)->backend == mAFQ_B_ThreadPool)
+  {
+    mERROR_CHECK(mQueue_Create(&(*pQueue)->completedRequests, pAllocator));
+    mERROR_CHECK(mQueue_Reserve((*pQueue)->completedRequests, queueDepth));
+    mERROR_CHECK(mTasklessThreadPool_Create(&(*pQueue)->threadPool, pAllocator, mMin(queueDepth, (size_t)16)));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFileQueue_Destroy, IN_OUT mPtr<mAsyncFileQueue> *pQueue)
+{
+  return mSharedPointer_Destroy(pQueue);
+}
+
+mFUNCTION(mAsyncFileQueue_GetBackend, mPtr<mAsyncFileQueue> &queue, OUT mAsyncFileQueue_Backend *pBackend)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr || pBackend == nullptr, mR_ArgumentNull);
+
+  *pBackend = queue->backend;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFileQueue_Submit, mPtr<mAsyncFileQueue> &queue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mAsyncFileQueue_Submit_Internal(queue.GetPointer()));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFileQueue_Poll, mPtr<mAsyncFileQueue> &queue, OUT OPTIONAL size_t *pCompletedCount /* = nullptr */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
+
+  size_t completedCount = 0;
+  mERROR_CHECK(mAsyncFileQueue_Reap_Internal(queue.GetPointer(), false, true, &completedCount));
+  mERROR_CHECK(mAsyncFileQueue_Submit_Internal(queue.GetPointer()));
+
+  if (pCompletedCount != nullptr)
+    *pCompletedCount = completedCount;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFileQueue_WaitForAll, mPtr<mAsyncFileQueue> &queue)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(queue == nullptr, mR_ArgumentNull);
+
+  while (true)
+  {
+    mERROR_CHECK(mAsyncFileQueue_Submit_Internal(queue.GetPointer()));
+
+    if (queue->inFlightCount == 0)
+      break; // Submitting only leaves requests pending if there are requests in flight.
+
+    size_t completedCount;
+    mERROR_CHECK(mAsyncFileQueue_Reap_Internal(queue.GetPointer(), true, true, &completedCount));
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFile_Open, OUT mPtr<mAsyncFile> *pFile, IN OPTIONAL mAllocator *pAllocator, mPtr<mAsyncFileQueue> &queue, const mString &filename)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pFile == nullptr || queue == nullptr, mR_ArgumentNull);
+  mERROR_IF(filename.hasFailed || filename.bytes <= 1, mR_InvalidParameter);
+
+  mDEFER_CALL_ON_ERROR(pFile, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate<mAsyncFile>(pFile, pAllocator, mAsyncFile_Destroy_Internal, 1));
+
+  (*pFile)->pQueue = queue.GetPointer();
+
+#ifdef mPLATFORM_WINDOWS
+  wchar_t wfilename[MAX_PATH + 1];
+  mERROR_CHECK(mString_ToWideString(filename, wfilename, mARRAYSIZE(wfilename)));
+
+  const HANDLE handle = CreateFileW(wfilename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    switch (GetLastError())
+    {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+      mRETURN_RESULT(mR_ResourceNotFound);
+
+    case ERROR_ACCESS_DENIED:
+      mRETURN_RESULT(mR_InsufficientPrivileges);
+
+    default:
+      mRETURN_RESULT(mR_IOFailure);
+    }
+  }
+
+  (*pFile)->handle = handle;
+
+  LARGE_INTEGER size;
+  mERROR_IF(0 == GetFileSizeEx(handle, &size), mR_IOFailure);
+
+  (*pFile)->size = (size_t)size.QuadPart;
+#else
+  (*pFile)->fileDescriptor = -1;
+
+  const int fileDescriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fileDescriptor == -1)
+  {
+    switch (errno)
+    {
+    case ENOENT:
+    case ENOTDIR:
+      mRETURN_RESULT(mR_ResourceNotFound);
+
+    case EACCES:
+    case EPERM:
+      mRETURN_RESULT(mR_InsufficientPrivileges);
+
+    default:
+      mRETURN_RESULT(mR_IOFailure);
+    }
+  }
+
+  (*pFile)->fileDescriptor = fileDescriptor;
+
+  struct stat fileStatus;
+  mERROR_IF(0 != fstat(fileDescriptor, &fileStatus), mR_IOFailure);
+
+  (*pFile)->size = (size_t)fileStatus.st_size;
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFile_Destroy, IN_OUT mPtr<mAsyncFile> *pFile)
+{
+  return mSharedPointer_Destroy(pFile);
+}
+
+mFUNCTION(mAsyncFile_GetSize, mPtr<mAsyncFile> &file, OUT size_t *pSize)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(file == nullptr || pSize == nullptr, mR_ArgumentNull);
+
+  *pSize = file->size;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mAsyncFile_Read, mPtr<mAsyncFile> &file, const size_t offset, const size_t size, OUT uint8_t *pBuffer, const mAsyncFile_Callback &callback)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(file == nullptr || (pBuffer == nullptr && size > 0), mR_ArgumentNull);
+  mERROR_IF(offset > file->size, mR_EndOfStream);
+  mERROR_IF(size > INT32_MAX, mR_ArgumentOutOfBounds); // Larger reads have to be split up.
+
+  mAllocator *pAllocator = file->pQueue->pAllocator;
+
+  mAsyncFile_Request *pRequest = nullptr;
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pRequest, 1));
+  new (pRequest) mAsyncFile_Request();
+  mDEFER_ON_ERROR(mAsyncFile_DestroyRequest_Internal(pAllocator, &pRequest));
+
+  pRequest->file = file;
+  pRequest->offset = offset;
+  pRequest->size = size;
+  pRequest->pBuffer = pBuffer;
+  pRequest->callback = callback;
+  pRequest->result = mR_Success;
+
+  mERROR_CHECK(mQueue_PushBack(file->pQueue->pendingRequests, pRequest));
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static void mAsyncFileQueue_Destroy_Internal(IN_OUT mAsyncFileQueue *pQueue)
+{
+  if (pQueue == nullptr)
+    return;
+
+  // The backend still writes to the buffers of requests that are in flight.
+  while (pQueue->inFlightCount > 0)
+  {
+    size_t completedCount;
+
+    if (mFAILED(mAsyncFileQueue_Reap_Internal(pQueue, true, false, &completedCount)))
+      break;
+  }
+
+  // Reaping may have requeued the remainder of short reads, so pending requests are only released afterwards.
+  if (pQueue->pendingRequests != nullptr)
+  {
+    mAsyncFile_Request *pRequest = nullptr;
+
+    while (mSUCCEEDED(mSILENCE_ERROR(mQueue_PopFront(pQueue->pendingRequests, &pRequest))))
+      mAsyncFile_DestroyRequest_Internal(pQueue->pAllocator, &pRequest);
+  }
+
+#ifdef mASYNC_FILE_IO_URING
+  mAsyncFileQueue_IoUring_Destroy_Internal(pQueue);
+#endif
+
+  mTasklessThreadPool_Destroy(&pQueue->threadPool);
+
+  pQueue->~mAsyncFileQueue();
+}
+
+static mFUNCTION(mAsyncFileQueue_Submit_Internal, IN mAsyncFileQueue *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  size_t submittedCount = 0;
+
+  while (pQueue->inFlightCount < pQueue->queueDepth)
+  {
+    mAsyncFile_Request *pRequest = nullptr;
+
+    if (mFAILED(mSILENCE_ERROR(mQueue_PopFront(pQueue->pendingRequests, &pRequest))))
+      break;
+
+    pQueue->inFlightCount++;
+
+    switch (pQueue->backend)
+    {
+#ifdef mASYNC_FILE_IO_URING
+    case mAFQ_B_IoUring:
+    {
+      mAsyncFileQueue_IoUring_Prepare_Internal(pQueue, pRequest);
+      submittedCount++;
+      break;
+    }
+#endif
+
+    case mAFQ_B_ThreadPool:
+    default:
+    {
+      const mResult result = mTasklessThreadPool_EnqueueTask(pQueue->threadPool, [pQueue, pRequest]()
+      {
+        mAsyncFile_ReadBlocking_Internal(pRequest);
+
+        {
+          std::unique_lock<std::mutex> lock(pQueue->completionMutex);
+          mQueue_PushBack(pQueue->completedRequests, pRequest);
+        }
+
+        pQueue->completionConditionVariable.notify_one();
+      });
+
+      // Callbacks must only be executed when polling, so the request stays queued and can be submitted again later.
+      if (mFAILED(result))
+      {
+        pQueue->inFlightCount--;
+        mERROR_CHECK(mQueue_PushFront(pQueue->pendingRequests, pRequest));
+        mRETURN_RESULT(result);
+      }
+
+      break;
+    }
+    }
+  }
+
+#ifdef mASYNC_FILE_IO_URING
+  // All prepared requests are handed to the kernel with a single system call.
+  while (submittedCount > 0)
+  {
+    const int result = (int)syscall(__NR_io_uring_enter, pQueue->ioUring.ringFileDescriptor, (uint32_t)submittedCount, 0, 0, nullptr, 0);
+
+    if (result < 0)
+    {
+      mERROR_IF(errno != EINTR && errno != EAGAIN && errno != EBUSY, mR_IOFailure);
+      continue;
+    }
+
+    submittedCount -= mMin((size_t)result, submittedCount);
+  }
+#else
+  mUnused(submittedCount);
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mAsyncFileQueue_Reap_Internal, IN mAsyncFileQueue *pQueue, const bool wait, const bool executeCallbacks, OUT size_t *pCompletedCount)
+{
+  mFUNCTION_SETUP();
+
+  *pCompletedCount = 0;
+
+  if (pQueue->inFlightCount == 0)
+    mRETURN_SUCCESS();
+
+#ifdef mASYNC_FILE_IO_URING
+  if (pQueue->backend == mAFQ_B_IoUring)
+  {
+    mAsyncFileQueue_IoUring &ring = pQueue->ioUring;
+
+    while (true)
+    {
+      uint32_t head = *ring.pCompletionHead;
+      const uint32_t tail = __atomic_load_n(ring.pCompletionTail, __ATOMIC_ACQUIRE);
+
+      if (head == tail)
+      {
+        if (!wait || *pCompletedCount > 0)
+          break;
+
+        const int result = (int)syscall(__NR_io_uring_enter, ring.ringFileDescriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        mERROR_IF(result < 0 && errno != EINTR, mR_IOFailure);
+
+        continue;
+      }
+
+      const io_uring_cqe *pEntry = &ring.pCompletionEntries[head & ring.completionMask];
+      mAsyncFile_Request *pRequest = reinterpret_cast<mAsyncFile_Request *>((uintptr_t)pEntry->user_data);
+      const int32_t bytesRead = pEntry->res;
+
+      __atomic_store_n(ring.pCompletionHead, head + 1, __ATOMIC_RELEASE);
+
+      if (bytesRead < 0)
+      {
+        pRequest->result = mR_IOFailure;
+      }
+      else
+      {
+        pRequest->bytesRead += (size_t)bytesRead;
+
+        // Short reads before the end of the file have to be continued.
+        if (bytesRead > 0 && pRequest->bytesRead < pRequest->size && pRequest->offset + pRequest->bytesRead < pRequest->file->size)
+        {
+          pQueue->inFlightCount--;
+          mERROR_CHECK(mQueue_PushFront(pQueue->pendingRequests, pRequest));
+          continue;
+        }
+      }
+
+      mERROR_CHECK(mAsyncFileQueue_Complete_Internal(pQueue, pRequest, executeCallbacks));
+      (*pCompletedCount)++;
+    }
+
+    mRETURN_SUCCESS();
+  }
+#endif
+
+  while (true)
+  {
+    mAsyncFile_Request *pRequest = nullptr;
+
+    {
+      std::unique_lock<std::mutex> lock(pQueue->completionMutex);
+
+      size_t completedCount = 0;
+      mERROR_CHECK(mQueue_GetCount(pQueue->completedRequests, &completedCount));
+
+      if (completedCount == 0)
+      {
+        if (!wait || *pCompletedCount > 0)
+          break;
+
+        pQueue->completionConditionVariable.wait(lock);
+        continue;
+      }
+
+      mERROR_CHECK(mQueue_PopFront(pQueue->completedRequests, &pRequest));
+    }
+
+    // The callback is executed without holding the lock.
+    mERROR_CHECK(mAsyncFileQueue_Complete_Internal(pQueue, pRequest, executeCallbacks));
+    (*pCompletedCount)++;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mAsyncFileQueue_Complete_Internal, IN mAsyncFileQueue *pQueue, IN mAsyncFile_Request *pRequest, const bool executeCallback)
+{
+  mFUNCTION_SETUP();
+
+  pQueue->inFlightCount--;
+
+  mDEFER(mAsyncFile_DestroyRequest_Internal(pQueue->pAllocator, &pRequest));
+
+  if (executeCallback && pRequest->callback)
+    pRequest->callback(pRequest->result, pRequest->bytesRead);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mAsyncFile_Destroy_Internal, IN_OUT mAsyncFile *pFile)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pFile == nullptr, mR_ArgumentNull);
+
+#ifdef mPLATFORM_WINDOWS
+  if (pFile->handle != nullptr && pFile->handle != INVALID_HANDLE_VALUE)
+    CloseHandle(pFile->handle);
+#else
+  if (pFile->fileDescriptor >= 0)
+    close(pFile->fileDescriptor);
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mAsyncFile_DestroyRequest_Internal, IN mAllocator *pAllocator, IN_OUT mAsyncFile_Request **ppRequest)
+{
+  mFUNCTION_SETUP();
+
+  if (*ppRequest == nullptr)
+    mRETURN_SUCCESS();
+
+  (*ppRequest)->~mAsyncFile_Request();
+
+  mERROR_CHECK(mAllocator_FreePtr(pAllocator, ppRequest));
+
+  mRETURN_SUCCESS();
+}
+
+// Executed on the worker threads of the thread pool backend.
+static void mAsyncFile_ReadBlocking_Internal(IN_OUT mAsyncFile_Request *pRequest)
+{
+  while (pRequest->bytesRead < pRequest->size)
+  {
+    const size_t offset = pRequest->offset + pRequest->bytesRead;
+
+#ifdef mPLATFORM_WINDOWS
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD bytesRead = 0;
+
+    if (FALSE == ReadFile(pRequest->file->handle, pRequest->pBuffer + pRequest->bytesRead, (DWORD)(pRequest->size - pRequest->bytesRead), &bytesRead, &overlapped))
+    {
+      if (GetLastError() != ERROR_HANDLE_EOF)
+        pRequest->result = mR_IOFailure;
+
+      return;
+    }
+#else
+    const ssize_t bytesRead = pread(pRequest->file->fileDescriptor, pRequest->pBuffer + pRequest->bytesRead, pRequest->size - pRequest->bytesRead, (off_t)offset);
+
+    if (bytesRead < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      pRequest->result = mR_IOFailure;
+      return;
+    }
+#endif
+
+    if (bytesRead == 0) // End of file.
+      return;
+
+    pRequest->bytesRead += (size_t)bytesRead;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+#ifdef mASYNC_FILE_IO_URING
+static mFUNCTION(mAsyncFileQueue_IoUring_Create_Internal, IN mAsyncFileQueue *pQueue)
+{
+  mFUNCTION_SETUP();
+
+  mAsyncFileQueue_IoUring &ring = pQueue->ioUring;
+
+  io_uring_params parameters;
+  mERROR_CHECK(mZeroMemory(&parameters, 1));
+
+  // Not available on old kernels or in restricted containers.
+  ring.ringFileDescriptor = (int)syscall(__NR_io_uring_setup, (uint32_t)pQueue->queueDepth, &parameters);
+  mERROR_IF(ring.ringFileDescriptor < 0, mR_NotSupported);
+
+  mDEFER_ON_ERROR(mAsyncFileQueue_IoUring_Destroy_Internal(pQueue));
+
+  ring.submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+  ring.completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+  const bool singleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+  if (singleMapping)
+    ring.submissionRingSize = ring.completionRingSize = mMax(ring.submissionRingSize, ring.completionRingSize);
+
+  void *pSubmissionRing = mmap(nullptr, ring.submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.ringFileDescriptor, IORING_OFF_SQ_RING);
+  mERROR_IF(pSubmissionRing == MAP_FAILED, mR_NotSupported);
+  ring.pSubmissionRing = reinterpret_cast<uint8_t *>(pSubmissionRing);
+
+  if (singleMapping)
+  {
+    ring.pCompletionRing = ring.pSubmissionRing;
+  }
+  else
+  {
+    void *pCompletionRing = mmap(nullptr, ring.completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.ringFileDescriptor, IORING_OFF_CQ_RING);
+    mERROR_IF(pCompletionRing == MAP_FAILED, mR_NotSupported);
+    ring.pCompletionRing = reinterpret_cast<uint8_t *>(pCompletionRing);
+  }
+
+  ring.submissionEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+
+  void *pSubmissionEntries = mmap(nullptr, ring.submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.ringFileDescriptor, IORING_OFF_SQES);
+  mERROR_IF(pSubmissionEntries == MAP_FAILED, mR_NotSupported);
+  ring.pSubmissionEntries = reinterpret_cast<io_uring_sqe *>(pSubmissionEntries);
+
+  ring.pSubmissionTail = reinterpret_cast<uint32_t *>(ring.pSubmissionRing + parameters.sq_off.tail);
+  ring.pSubmissionArray = reinterpret_cast<uint32_t *>(ring.pSubmissionRing + parameters.sq_off.array);
+  ring.submissionMask = *reinterpret_cast<uint32_t *>(ring.pSubmissionRing + parameters.sq_off.ring_mask);
+
+  ring.pCompletionHead = reinterpret_cast<uint32_t *>(ring.pCompletionRing + parameters.cq_off.head);
+  ring.pCompletionTail = reinterpret_cast<uint32_t *>(ring.pCompletionRing + parameters.cq_off.tail);
+  ring.completionMask = *reinterpret_cast<uint32_t *>(ring.pCompletionRing + parameters.cq_off.ring_mask);
+  ring.pCompletionEntries = reinterpret_cast<io_uring_cqe *>(ring.pCompletionRing + parameters.cq_off.cqes);
+
+  mRETURN_SUCCESS();
+}
+
+static void mAsyncFileQueue_IoUring_Destroy_Internal(IN mAsyncFileQueue *pQueue)
+{
+  mAsyncFileQueue_IoUring &ring = pQueue->ioUring;
+
+  if (ring.pSubmissionEntries != nullptr)
+    munmap(ring.pSubmissionEntries, ring.submissionEntriesSize);
+
+  if (ring.pCompletionRing != nullptr && ring.pCompletionRing != ring.pSubmissionRing)
+    munmap(ring.pCompletionRing, ring.completionRingSize);
+
+  if (ring.pSubmissionRing != nullptr)
+    munmap(ring.pSubmissionRing, ring.submissionRingSize);
+
+  if (ring.ringFileDescriptor >= 0)
+    close(ring.ringFileDescriptor);
+
+  ring = mAsyncFileQueue_IoUring();
+  ring.ringFileDescriptor = -1;
+}
+
+// Never more than `queueDepth` requests are in flight, so there's always space in the submission ring.
+static void mAsyncFileQueue_IoUring_Prepare_Internal(IN mAsyncFileQueue *pQueue, IN mAsyncFile_Request *pRequest)
+{
+  mAsyncFileQueue_IoUring &ring = pQueue->ioUring;
+
+  const uint32_t tail = *ring.pSubmissionTail;
+  const uint32_t index = tail & ring.submissionMask;
+
+  // `IORING_OP_READV` is available on all kernels that support io_uring, unlike `IORING_OP_READ`.
+  pRequest->ioVector.iov_base = pRequest->pBuffer + pRequest->bytesRead;
+  pRequest->ioVector.iov_len = pRequest->size - pRequest->bytesRead;
+
+  io_uring_sqe *pEntry = &ring.pSubmissionEntries[index];
+  memset(pEntry, 0, sizeof(io_uring_sqe));
+
+  pEntry->opcode = IORING_OP_READV;
+  pEntry->fd = pRequest->file->fileDescriptor;
+  pEntry->off = pRequest->offset + pRequest->bytesRead;
+  pEntry->addr = (uint64_t)(uintptr_t)&pRequest->ioVector;
+  pEntry->len = 1;
+  pEntry->user_data = (uint64_t)(uintptr_t)pRequest;
+
+  ring.pSubmissionArray[index] = index;
+
+  __atomic_store_n(ring.pSubmissionTail, tail + 1, __ATOMIC_RELEASE);
+}
+#endif
@@ -1,8 +1,11 @@
 #include "mCachedFileReader.h"
 #include "mFile.h"
+#include "mThread.h"
 
 #include <io.h>
 #include <fcntl.h>
+#include <mutex>
+#include <condition_variable>
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -11,8 +14,74 @@
   #define __M_FILE__ "ioOl6vLwfcHaWvhWPPRUDTqP790J4x2+bly/0oxdIqcBttnfhibZOiM0F7O5DnXLiBb8Dt5KycTNTKJP"
 #endif
 
+enum mCachedFileReader_PageState
+{
+  mCFR_PS_Empty,
+  mCFR_PS_Loading,
+  mCFR_PS_Ready,
+};
+
+struct mCachedFileReader_Page
+{
+  size_t pageIndex;
+  size_t size;
+  uint64_t lastAccess;
+  mCachedFileReader_PageState state;
+  bool isReadAhead; // has been read ahead of time and hasn't been accessed since.
+};
+
+// Number of independent sequential access streams that are tracked at the same time (e.g. reading interleaved audio and video data from a container).
+constexpr size_t mCachedFileReader_StreamCount = 4;
+
+struct mCachedFileReader_Stream
+{
+  size_t lastPageIndex;
+  size_t sequentialAccessCount;
+  uint64_t lastAccess;
+  size_t readAheadBegin;
+  size_t readAheadEnd;
+};
+
+struct mCachedFileReader_PageCache
+{
+  std::mutex mutex;
+  std::condition_variable pageLoaded;
+  std::condition_variable readAheadRequested;
+  std::mutex fileMutex; // Seeking and reading from the file handle isn't atomic.
+
+  mThread *pReadAheadThread;
+  bool stopReadAhead;
+
+  size_t pageSize;
+  size_t pageCount;
+  size_t readAheadPageCount;
+  size_t filePageCount;
+
+  mCachedFileReader_Page *pPages;
+  uint8_t *pPageData;
+  mCachedFileReader_Page *pPinnedPage; // referenced by the last pointer returned from `mCachedFileReader_PointerAt`.
+
+  uint8_t *pScratch; // for pointers spanning multiple pages.
+  size_t scratchCapacity;
+
+  uint64_t accessCounter;
+  mCachedFileReader_Stream streams[mCachedFileReader_StreamCount]; // replaced in least recently used order.
+
+  mCachedFileReader_Statistics statistics;
+};
+
 static mFUNCTION(mCachedFileReader_Destroy_Internal, mCachedFileReader *pCachedFileReader);
 static mFUNCTION(mCachedFileReader_ReadFrom_Internal, mPtr<mCachedFileReader> &cachedFileReader, const size_t location, const size_t requestedSize);
+static mFUNCTION(mCachedFileReader_PageCache_Destroy_Internal, IN_OUT mCachedFileReader_PageCache **ppPageCache, IN mAllocator *pAllocator);
+static mFUNCTION(mCachedFileReader_ReadPaged_Internal, mCachedFileReader *pCachedFileReader, const size_t location, const size_t size, OUT uint8_t *pBuffer);
+static mFUNCTION(mCachedFileReader_PointerAtPaged_Internal, mCachedFileReader *pCachedFileReader, const size_t location, const size_t size, OUT uint8_t **ppBuffer);
+static mFUNCTION(mCachedFileReader_AcquirePage_Internal, mCachedFileReader *pCachedFileReader, std::unique_lock<std::mutex> &lock, const size_t pageIndex, OUT mCachedFileReader_Page **ppPage);
+static mFUNCTION(mCachedFileReader_LoadPage_Internal, mCachedFileReader *pCachedFileReader, std::unique_lock<std::mutex> &lock, mCachedFileReader_Page *pPage, const size_t pageIndex);
+static mFUNCTION(mCachedFileReader_ReadFile_Internal, mCachedFileReader *pCachedFileReader, const size_t location, OUT uint8_t *pBuffer, const size_t size);
+static mFUNCTION(mCachedFileReader_ReadAheadThread_Internal, mCachedFileReader *pCachedFileReader);
+static void mCachedFileReader_DetectSequentialAccess_Internal(mCachedFileReader_PageCache *pPageCache, const size_t firstPageIndex, const size_t lastPageIndex);
+static mCachedFileReader_Page * mCachedFileReader_FindPage_Internal(mCachedFileReader_PageCache *pPageCache, const size_t pageIndex);
+static mCachedFileReader_Page * mCachedFileReader_FindEvictablePage_Internal(mCachedFileReader_PageCache *pPageCache);
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -53,6 +122,69 @@ mFUNCTION(mCachedFileReader_Create, OUT mPtr<mCachedFileReader> *pCachedFileRead
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mCachedFileReader_CreateMapped, OUT mPtr<mCachedFileReader> *pCachedFileReader, IN mAllocator *pAllocator, const mString &filename, const mReadOnlyMappedFile_AccessPattern accessPattern /* = mROMF_AP_Normal */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pCachedFileReader == nullptr, mR_ArgumentNull);
+
+  mDEFER_CALL_ON_ERROR(pCachedFileReader, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate(pCachedFileReader, pAllocator, (std::function<void(mCachedFileReader *)>)[](mCachedFileReader *pData) {mCachedFileReader_Destroy_Internal(pData);}, 1));
+
+  (*pCachedFileReader)->pAllocator = pAllocator;
+
+  mERROR_CHECK(mReadOnlyMappedFile_Create(&(*pCachedFileReader)->mappedFile, pAllocator, filename, accessPattern));
+  mERROR_CHECK(mReadOnlyMappedFile_GetData((*pCachedFileReader)->mappedFile, &(*pCachedFileReader)->pMappedData, &(*pCachedFileReader)->fileSize));
+
+  // The whole file is always available.
+  (*pCachedFileReader)->cachePosition = 0;
+  (*pCachedFileReader)->cacheSize = (*pCachedFileReader)->fileSize;
+  (*pCachedFileReader)->maxCacheSize = (*pCachedFileReader)->fileSize;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mCachedFileReader_CreatePaged, OUT mPtr<mCachedFileReader> *pCachedFileReader, IN mAllocator *pAllocator, const mString &filename, const size_t pageSize /* = 64 * 1024 */, const size_t pageCount /* = 64 */, const size_t readAheadPageCount /* = 4 */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pCachedFileReader == nullptr, mR_ArgumentNull);
+  mERROR_IF(pageSize == 0 || pageSize > UINT32_MAX || pageCount < 2, mR_InvalidParameter);
+  mERROR_IF(readAheadPageCount > pageCount / 2, mR_InvalidParameter); // Reading ahead shouldn't be able to evict everything else.
+
+  mDEFER_CALL_ON_ERROR(pCachedFileReader, mSharedPointer_Destroy);
+  mERROR_CHECK(mCachedFileReader_Create(pCachedFileReader, pAllocator, filename, pageSize * pageCount));
+
+  mCachedFileReader_PageCache *pPageCache = nullptr;
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pPageCache, 1));
+
+  new (&pPageCache->mutex) std::mutex();
+  new (&pPageCache->pageLoaded) std::condition_variable();
+  new (&pPageCache->readAheadRequested) std::condition_variable();
+  new (&pPageCache->fileMutex) std::mutex();
+
+  (*pCachedFileReader)->pPageCache = pPageCache; // Will be cleaned up with the file reader from now on.
+
+  pPageCache->pageSize = pageSize;
+  pPageCache->pageCount = pageCount;
+  pPageCache->readAheadPageCount = readAheadPageCount;
+  pPageCache->filePageCount = ((*pCachedFileReader)->fileSize + pageSize - 1) / pageSize;
+
+  for (size_t i = 0; i < mARRAYSIZE(pPageCache->streams); i++)
+    pPageCache->streams[i].lastPageIndex = (size_t)-1;
+
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pPageCache->pPages, pageCount));
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pPageCache->pPageData, pageSize * pageCount));
+
+  for (size_t i = 0; i < pageCount; i++)
+    pPageCache->pPages[i].pageIndex = (size_t)-1;
+
+  if (readAheadPageCount > 0)
+    mERROR_CHECK(mThread_Create(&pPageCache->pReadAheadThread, pAllocator, mCachedFileReader_ReadAheadThread_Internal, pCachedFileReader->GetPointer()));
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mCachedFileReader_Destroy, IN_OUT mPtr<mCachedFileReader> *pCachedFileReader)
 {
   mFUNCTION_SETUP();
@@ -83,6 +215,17 @@ mFUNCTION(mCachedFileReader_ReadAt, mPtr<mCachedFileReader> &cachedFileReader, c
   mERROR_IF(location >= cachedFileReader->fileSize, mR_EndOfStream);
   mERROR_IF(location + size > cachedFileReader->fileSize, mR_EndOfStream);
 
+  if (cachedFileReader->pMappedData != nullptr)
+  {
+    mERROR_CHECK(mMemcpy(pBuffer, cachedFileReader->pMappedData + location, size));
+    mRETURN_SUCCESS();
+  }
+  else if (cachedFileReader->pPageCache != nullptr)
+  {
+    mERROR_CHECK(mCachedFileReader_ReadPaged_Internal(cachedFileReader.GetPointer(), location, size, pBuffer));
+    mRETURN_SUCCESS();
+  }
+
   size_t readSize = 0;
   size_t currentLocation = location;
   uint8_t *pCurrentBufferPosition = pBuffer;
@@ -139,9 +282,22 @@ mFUNCTION(mCachedFileReader_PointerAt, mPtr<mCachedFileReader> &cachedFileReader
   mERROR_IF(cachedFileReader == nullptr || ppBuffer == nullptr, mR_ArgumentNull);
   mERROR_IF(location >= cachedFileReader->fileSize, mR_EndOfStream);
   mERROR_IF(location + size > cachedFileReader->fileSize, mR_EndOfStream);
+
+  if (cachedFileReader->pMappedData != nullptr)
+  {
+    *ppBuffer = const_cast<uint8_t *>(cachedFileReader->pMappedData + location);
+    mRETURN_SUCCESS();
+  }
+
   mERROR_IF(size > cachedFileReader->maxCacheSize, mR_ArgumentOutOfBounds);
   mERROR_IF(size == 0, mR_Success);
 
+  if (cachedFileReader->pPageCache != nullptr)
+  {
+    mERROR_CHECK(mCachedFileReader_PointerAtPaged_Internal(cachedFileReader.GetPointer(), location, size, ppBuffer));
+    mRETURN_SUCCESS();
+  }
+
    if (cachedFileReader->cachePosition <= location && (int64_t)cachedFileReader->cacheSize - (int64_t)(location - cachedFileReader->cachePosition) >= (int64_t)size)
   {
     // Serve from cache.
@@ -156,6 +312,32 @@ mFUNCTION(mCachedFileReader_PointerAt, mPtr<mCachedFileReader> &cachedFileReader
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mCachedFileReader_GetStatistics, mPtr<mCachedFileReader> &cachedFileReader, OUT mCachedFileReader_Statistics *pStatistics)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(cachedFileReader == nullptr || pStatistics == nullptr, mR_ArgumentNull);
+  mERROR_IF(cachedFileReader->pPageCache == nullptr, mR_ResourceStateInvalid);
+
+  std::unique_lock<std::mutex> lock(cachedFileReader->pPageCache->mutex);
+
+  *pStatistics = cachedFileReader->pPageCache->statistics;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mCachedFileReader_GetPageSize, mPtr<mCachedFileReader> &cachedFileReader, OUT size_t *pPageSize)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(cachedFileReader == nullptr || pPageSize == nullptr, mR_ArgumentNull);
+  mERROR_IF(cachedFileReader->pPageCache == nullptr, mR_ResourceStateInvalid);
+
+  *pPageSize = cachedFileReader->pPageCache->pageSize; // Never changes after creation.
+
+  mRETURN_SUCCESS();
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 static mFUNCTION(mCachedFileReader_Destroy_Internal, mCachedFileReader *pCachedFileReader)
@@ -164,11 +346,18 @@ static mFUNCTION(mCachedFileReader_Destroy_Internal, mCachedFileReader *pCachedF
 
   mERROR_IF(pCachedFileReader == nullptr, mR_ArgumentNull);
 
+  // Stops the read ahead thread, so it has to happen before closing the file.
+  if (pCachedFileReader->pPageCache != nullptr)
+    mERROR_CHECK(mCachedFileReader_PageCache_Destroy_Internal(&pCachedFileReader->pPageCache, pCachedFileReader->pAllocator));
+
   if (pCachedFileReader->fileHandle)
     /* errno_t errorCode = */ _close(pCachedFileReader->fileHandle);
 
   mERROR_CHECK(mAllocator_FreePtr(pCachedFileReader->pAllocator, &pCachedFileReader->pCache));
 
+  pCachedFileReader->pMappedData = nullptr;
+  mERROR_CHECK(mReadOnlyMappedFile_Destroy(&pCachedFileReader->mappedFile));
+
   mRETURN_SUCCESS();
 }
 
@@ -266,3 +455,355 @@ static mFUNCTION(mCachedFileReader_ReadFrom_Internal, mPtr<mCachedFileReader> &c
 
   mRETURN_SUCCESS();
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mCachedFileReader_PageCache_Destroy_Internal, IN_OUT mCachedFileReader_PageCache **ppPageCache, IN mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(ppPageCache == nullptr || *ppPageCache == nullptr, mR_ArgumentNull);
+
+  mCachedFileReader_PageCache *pPageCache = *ppPageCache;
+
+  if (pPageCache->pReadAheadThread != nullptr)
+  {
+    {
+      std::unique_lock<std::mutex> lock(pPageCache->mutex);
+      pPageCache->stopReadAhead = true;
+    }
+
+    pPageCache->readAheadRequested.notify_one();
+
+    mERROR_CHECK(mThread_Join(pPageCache->pReadAheadThread));
+    mERROR_CHECK(mThread_Destroy(&pPageCache->pReadAheadThread));
+  }
+
+  mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pPageCache->pPages));
+  mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pPageCache->pPageData));
+  mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pPageCache->pScratch));
+
+  pPageCache->fileMutex.~mutex();
+  pPageCache->readAheadRequested.~condition_variable();
+  pPageCache->pageLoaded.~condition_variable();
+  pPageCache->mutex.~mutex();
+
+  mERROR_CHECK(mAllocator_FreePtr(pAllocator, ppPageCache));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mCachedFileReader_ReadPaged_Internal, mCachedFileReader *pCachedFileReader, const size_t location, const size_t size, OUT uint8_t *pBuffer)
+{
+  mFUNCTION_SETUP();
+
+  mCachedFileReader_PageCache *pPageCache = pCachedFileReader->pPageCache;
+  std::unique_lock<std::mutex> lock(pPageCache->mutex);
+
+  pPageCache->pPinnedPage = nullptr; // Previously returned pointers are invalidated.
+
+  if (size == 0)
+    mRETURN_SUCCESS();
+
+  const size_t firstPageIndex = location / pPageCache->pageSize;
+  const size_t lastPageIndex = (location + size - 1) / pPageCache->pageSize;
+
+  mCachedFileReader_DetectSequentialAccess_Internal(pPageCache, firstPageIndex, lastPageIndex);
+
+  size_t offset = location - firstPageIndex * pPageCache->pageSize;
+  size_t remainingSize = size;
+
+  // Pages are only copied from while holding the lock, so they can't be evicted in the meantime.
+  for (size_t pageIndex = firstPageIndex; pageIndex <= lastPageIndex; pageIndex++)
+  {
+    mCachedFileReader_Page *pPage = nullptr;
+    mERROR_CHECK(mCachedFileReader_AcquirePage_Internal(pCachedFileReader, lock, pageIndex, &pPage));
+
+    const size_t copySize = mMin(remainingSize, pPage->size - offset);
+    mERROR_CHECK(mMemcpy(pBuffer, pPageCache->pPageData + (pPage - pPageCache->pPages) * pPageCache->pageSize + offset, copySize));
+
+    pBuffer += copySize;
+    remainingSize -= copySize;
+    offset = 0;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mCachedFileReader_PointerAtPaged_Internal, mCachedFileReader *pCachedFileReader, const size_t location, const size_t size, OUT uint8_t **ppBuffer)
+{
+  mFUNCTION_SETUP();
+
+  mCachedFileReader_PageCache *pPageCache = pCachedFileReader->pPageCache;
+
+  const size_t firstPageIndex = location / pPageCache->pageSize;
+  const size_t lastPageIndex = (location + size - 1) / pPageCache->pageSize;
+
+  if (firstPageIndex != lastPageIndex)
+  {
+    if (pPageCache->scratchCapacity < size)
+    {
+      mERROR_CHECK(mAllocator_Reallocate(pCachedFileReader->pAllocator, &pPageCache->pScratch, size));
+      pPageCache->scratchCapacity = size;
+    }
+
+    mERROR_CHECK(mCachedFileReader_ReadPaged_Internal(pCachedFileReader, location, size, pPageCache->pScratch));
+
+    *ppBuffer = pPageCache->pScratch;
+
+    mRETURN_SUCCESS();
+  }
+
+  std::unique_lock<std::mutex> lock(pPageCache->mutex);
+
+  pPageCache->pPinnedPage = nullptr;
+
+  mCachedFileReader_DetectSequentialAccess_Internal(pPageCache, firstPageIndex, lastPageIndex);
+
+  mCachedFileReader_Page *pPage = nullptr;
+  mERROR_CHECK(mCachedFileReader_AcquirePage_Internal(pCachedFileReader, lock, firstPageIndex, &pPage));
+
+  pPageCache->pPinnedPage = pPage; // Can't be evicted by the read ahead thread until the next call.
+
+  *ppBuffer = pPageCache->pPageData + (pPage - pPageCache->pPages) * pPageCache->pageSize + (location - firstPageIndex * pPageCache->pageSize);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mCachedFileReader_AcquirePage_Internal, mCachedFileReader *pCachedFileReader, std::unique_lock<std::mutex> &lock, const size_t pageIndex, OUT mCachedFileReader_Page **ppPage)
+{
+  mFUNCTION_SETUP();
+
+  mCachedFileReader_PageCache *pPageCache = pCachedFileReader->pPageCache;
+
+  while (true)
+  {
+    mCachedFileReader_Page *pPage = mCachedFileReader_FindPage_Internal(pPageCache, pageIndex);
+
+    if (pPage != nullptr && pPage->state == mCFR_PS_Loading)
+    {
+      // It's currently being read ahead.
+      pPageCache->pageLoaded.wait(lock);
+      continue;
+    }
+
+    if (pPage != nullptr)
+    {
+      pPageCache->statistics.hitCount++;
+
+      if (pPage->isReadAhead)
+      {
+        pPage->isReadAhead = false;
+        pPageCache->statistics.readAheadHitCount++;
+      }
+    }
+    else
+    {
+      pPage = mCachedFileReader_FindEvictablePage_Internal(pPageCache);
+
+      if (pPage == nullptr)
+      {
+        // All pages are currently being read ahead.
+        pPageCache->pageLoaded.wait(lock);
+        continue;
+      }
+
+      pPageCache->statistics.missCount++;
+
+      mERROR_CHECK(mCachedFileReader_LoadPage_Internal(pCachedFileReader, lock, pPage, pageIndex));
+    }
+
+    pPage->lastAccess = ++pPageCache->accessCounter;
+    *ppPage = pPage;
+
+    break;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+// Expects `lock` to be locked. It'll be unlocked while reading from the file.
+static mFUNCTION(mCachedFileReader_LoadPage_Internal, mCachedFileReader *pCachedFileReader, std::unique_lock<std::mutex> &lock, mCachedFileReader_Page *pPage, const size_t pageIndex)
+{
+  mFUNCTION_SETUP();
+
+  mCachedFileReader_PageCache *pPageCache = pCachedFileReader->pPageCache;
+
+  if (pPage->state == mCFR_PS_Ready)
+    pPageCache->statistics.evictionCount++;
+
+  const size_t location = pageIndex * pPageCache->pageSize;
+
+  pPage->pageIndex = pageIndex;
+  pPage->state = mCFR_PS_Loading;
+  pPage->isReadAhead = false;
+  pPage->size = mMin(pPageCache->pageSize, pCachedFileReader->fileSize - location);
+
+  uint8_t *pData = pPageCache->pPageData + (pPage - pPageCache->pPages) * pPageCache->pageSize;
+  const size_t size = pPage->size;
+
+  lock.unlock();
+  const mResult result = mCachedFileReader_ReadFile_Internal(pCachedFileReader, location, pData, size);
+  lock.lock();
+
+  if (mSUCCEEDED(result))
+  {
+    pPage->state = mCFR_PS_Ready;
+  }
+  else
+  {
+    pPage->state = mCFR_PS_Empty;
+    pPage->pageIndex = (size_t)-1;
+  }
+
+  pPageCache->pageLoaded.notify_all();
+
+  mERROR_IF(mFAILED(result), result);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mCachedFileReader_ReadFile_Internal, mCachedFileReader *pCachedFileReader, const size_t location, OUT uint8_t *pBuffer, const size_t size)
+{
+  mFUNCTION_SETUP();
+
+  std::unique_lock<std::mutex> lock(pCachedFileReader->pPageCache->fileMutex);
+
+  const int64_t readPosition = _lseeki64(pCachedFileReader->fileHandle, (int64_t)location, SEEK_SET);
+  mERROR_IF(readPosition < 0 || (size_t)readPosition != location, mR_IOFailure);
+
+  const int bytesRead = _read(pCachedFileReader->fileHandle, pBuffer, (uint32_t)size);
+  mERROR_IF(bytesRead < 0 || (size_t)bytesRead != size, mR_IOFailure);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mCachedFileReader_ReadAheadThread_Internal, mCachedFileReader *pCachedFileReader)
+{
+  mFUNCTION_SETUP();
+
+  mCachedFileReader_PageCache *pPageCache = pCachedFileReader->pPageCache;
+  std::unique_lock<std::mutex> lock(pPageCache->mutex);
+
+  while (!pPageCache->stopReadAhead)
+  {
+    mCachedFileReader_Stream *pStream = nullptr;
+
+    for (size_t i = 0; i < mARRAYSIZE(pPageCache->streams); i++)
+    {
+      if (pPageCache->streams[i].readAheadBegin < pPageCache->streams[i].readAheadEnd)
+      {
+        pStream = &pPageCache->streams[i];
+        break;
+      }
+    }
+
+    if (pStream == nullptr)
+    {
+      pPageCache->readAheadRequested.wait(lock);
+      continue;
+    }
+
+    const size_t pageIndex = pStream->readAheadBegin++;
+
+    if (mCachedFileReader_FindPage_Internal(pPageCache, pageIndex) != nullptr)
+      continue;
+
+    mCachedFileReader_Page *pPage = mCachedFileReader_FindEvictablePage_Internal(pPageCache);
+
+    // Reading ahead isn't worth waiting for pages to become available or retrying failed reads.
+    if (pPage == nullptr || mFAILED(mCachedFileReader_LoadPage_Internal(pCachedFileReader, lock, pPage, pageIndex)))
+    {
+      // The stream may have been replaced while the file was being read, this only cancels the rest of its request either way.
+      pStream->readAheadBegin = pStream->readAheadEnd;
+      continue;
+    }
+
+    pPage->isReadAhead = true;
+    pPage->lastAccess = ++pPageCache->accessCounter; // Don't evict it before it's been used.
+    pPageCache->statistics.readAheadCount++;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+// Expects the page cache to be locked.
+static void mCachedFileReader_DetectSequentialAccess_Internal(mCachedFileReader_PageCache *pPageCache, const size_t firstPageIndex, const size_t lastPageIndex)
+{
+  mCachedFileReader_Stream *pStream = nullptr;
+
+  for (size_t i = 0; i < mARRAYSIZE(pPageCache->streams); i++)
+  {
+    mCachedFileReader_Stream *pCandidate = &pPageCache->streams[i];
+
+    if (firstPageIndex == pCandidate->lastPageIndex || firstPageIndex == pCandidate->lastPageIndex + 1)
+    {
+      pStream = pCandidate;
+      break;
+    }
+  }
+
+  if (pStream != nullptr)
+  {
+    if (lastPageIndex != pStream->lastPageIndex)
+      pStream->sequentialAccessCount++;
+  }
+  else
+  {
+    pStream = &pPageCache->streams[0];
+
+    for (size_t i = 1; i < mARRAYSIZE(pPageCache->streams); i++)
+      if (pPageCache->streams[i].lastAccess < pStream->lastAccess)
+        pStream = &pPageCache->streams[i];
+
+    pStream->sequentialAccessCount = 0;
+    pStream->readAheadBegin = pStream->readAheadEnd = 0;
+  }
+
+  pStream->lastPageIndex = lastPageIndex;
+  pStream->lastAccess = ++pPageCache->accessCounter;
+
+  if (pStream->sequentialAccessCount < 2 || pPageCache->pReadAheadThread == nullptr)
+    return;
+
+  const size_t readAheadBegin = mMax(lastPageIndex + 1, pStream->readAheadBegin); // Don't request pages again that are already being read ahead.
+  const size_t readAheadEnd = mMin(pPageCache->filePageCount, lastPageIndex + 1 + pPageCache->readAheadPageCount);
+
+  if (readAheadBegin < readAheadEnd)
+  {
+    pStream->readAheadBegin = readAheadBegin;
+    pStream->readAheadEnd = readAheadEnd;
+    pPageCache->readAheadRequested.notify_one();
+  }
+}
+
+static mCachedFileReader_Page * mCachedFileReader_FindPage_Internal(mCachedFileReader_PageCache *pPageCache, const size_t pageIndex)
+{
+  // Page counts are small enough for this to be cheaper than maintaining a lookup table.
+  for (size_t i = 0; i < pPageCache->pageCount; i++)
+    if (pPageCache->pPages[i].pageIndex == pageIndex)
+      return &pPageCache->pPages[i];
+
+  return nullptr;
+}
+
+static mCachedFileReader_Page * mCachedFileReader_FindEvictablePage_Internal(mCachedFileReader_PageCache *pPageCache)
+{
+  mCachedFileReader_Page *pLeastRecentlyUsed = nullptr;
+
+  for (size_t i = 0; i < pPageCache->pageCount; i++)
+  {
+    mCachedFileReader_Page *pPage = &pPageCache->pPages[i];
+
+    if (pPage->state == mCFR_PS_Empty)
+      return pPage;
+
+    if (pPage->state == mCFR_PS_Loading || pPage == pPageCache->pPinnedPage)
+      continue;
+
+    if (pLeastRecentlyUsed == nullptr || pPage->lastAccess < pLeastRecentlyUsed->lastAccess)
+      pLeastRecentlyUsed = pPage;
+  }
+
+  return pLeastRecentlyUsed;
+}
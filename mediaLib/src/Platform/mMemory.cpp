@@ -1,5 +1,9 @@
 #include "mediaLib.h"
 
+#include <mutex>
+#include <atomic>
+#include <malloc.h>
+
 #ifndef _DEBUG
 extern "C"
 {
@@ -20,20 +24,68 @@ extern "C"
 extern bool mMemory_RpMallocEnabled = false;
 extern bool mMemory_HasActiveAllocations = false;
 
+#ifndef _DEBUG
+static std::atomic<bool> mMemory_RpMallocInitialized { false };
+
+struct mMemory_ThreadState
+{
+  bool initialized = false;
+
+  ~mMemory_ThreadState()
+  {
+    if (initialized)
+    {
+      initialized = false; // Allocations in later thread local destructors will reinitialize the thread (adopting the orphaned heap).
+      mMemory_OnThreadExit();
+    }
+  }
+};
+
+static thread_local mMemory_ThreadState mMemory_CurrentThreadState;
+
+// Only Windows notifies us about new threads (through the TLS callback), everywhere else (and for threads that started before rpmalloc has been initialized) threads are initialized lazily on their first allocation and finalized on exit.
+inline void mMemory_EnsureThreadInitialized_Internal()
+{
+  if (!mMemory_CurrentThreadState.initialized)
+  {
+    mMemory_CurrentThreadState.initialized = true;
+    mMemory_OnThreadStart();
+  }
+}
+
+static bool mMemory_InitializeRpMalloc_Internal()
+{
+  if (mMemory_RpMallocInitialized.load(std::memory_order_acquire))
+    return true;
+
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!mMemory_RpMallocInitialized && 0 == rpmalloc_initialize())
+    mMemory_RpMallocInitialized = true;
+
+  return mMemory_RpMallocInitialized;
+}
+#endif
+
 extern void mMemory_OnProcessStart()
 {
 #ifndef _DEBUG
   if (mMemory_HasActiveAllocations)
     return;
 
+#ifdef mPLATFORM_WINDOWS
   HMODULE moduleHandle = nullptr;
 
   if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, reinterpret_cast<LPWSTR>(const_cast<void *>(reinterpret_cast<const void *>(mMemory_OnProcessStart))), &moduleHandle) != 0)
     moduleHandle = nullptr;
 
   mMemory_RpMallocEnabled = (GetModuleHandleW(nullptr) == moduleHandle);
+#else
+  mMemory_RpMallocEnabled = true; // mediaLib is always linked statically.
+#endif
 
-  if (mMemory_RpMallocEnabled && 0 != rpmalloc_initialize())
+  if (mMemory_RpMallocEnabled && !mMemory_InitializeRpMalloc_Internal())
     mMemory_RpMallocEnabled = false;
 #endif
 }
@@ -41,7 +93,7 @@ extern void mMemory_OnProcessStart()
 extern void mMemory_OnThreadStart()
 {
 #ifndef _DEBUG
-  if (mMemory_RpMallocEnabled)
+  if (mMemory_RpMallocInitialized)
     rpmalloc_thread_initialize();
 #endif
 }
@@ -49,7 +101,7 @@ extern void mMemory_OnThreadStart()
 extern void mMemory_OnThreadExit()
 {
 #ifndef _DEBUG
-  if (mMemory_RpMallocEnabled)
+  if (mMemory_RpMallocInitialized)
     rpmalloc_thread_finalize(0);
 #endif
 }
@@ -57,20 +109,37 @@ extern void mMemory_OnThreadExit()
 extern void mMemory_OnProcessExit()
 {
 #ifndef _DEBUG
-  if (mMemory_RpMallocEnabled)
+  if (mMemory_RpMallocInitialized)
     rpmalloc_finalize();
 #endif
 }
 
+#if !defined(mPLATFORM_WINDOWS) && !defined(_DEBUG)
+// There's no TLS callback outside of Windows. The process exit isn't forwarded, because static destructors may still free memory afterwards.
+__attribute__((constructor(101))) static void mMemory_OnProcessStart_Internal()
+{
+  mMemory_OnProcessStart();
+}
+
+ #define mMEMORY_ENSURE_THREAD_INITIALIZED() mMemory_EnsureThreadInitialized_Internal()
+#else
+ #define mMEMORY_ENSURE_THREAD_INITIALIZED()
+#endif
+
 _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_alloc(_In_ const size_t size)
 {
 #ifndef _DEBUG
   mMemory_HasActiveAllocations = true;
 
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rpmalloc(size);
+  }
   else
+  {
     return malloc(size);
+  }
 #else
   return malloc(size);
 #endif
@@ -82,9 +151,14 @@ _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CR
   mMemory_HasActiveAllocations = true;
 
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rpcalloc(size, 1);
+  }
   else
+  {
     return calloc(size, 1);
+  }
 #else
   return calloc(size, 1);
 #endif
@@ -96,9 +170,14 @@ _Success_(return != 0) _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(
   mMemory_HasActiveAllocations = true;
 
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rprealloc(pBlock, size);
+  }
   else
+  {
     return realloc(pBlock, size);
+  }
 #else
   return realloc(pBlock, size);
 #endif
@@ -108,9 +187,14 @@ void __cdecl _m_internal_free(_Pre_maybenull_ _Post_invalid_ void *pBlock)
 {
 #ifndef _DEBUG
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     rpfree(pBlock);
+  }
   else
+  {
     free(pBlock);
+  }
 #else
   free(pBlock);
 #endif
@@ -122,9 +206,14 @@ _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CR
   mMemory_HasActiveAllocations = true;
 
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rpaligned_alloc(alignment, size);
+  }
   else
+  {
     return _aligned_malloc(size, alignment);
+  }
 #else
   return _aligned_malloc(size, alignment);
 #endif
@@ -137,6 +226,7 @@ _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CR
 
   if (mMemory_RpMallocEnabled)
   {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rpaligned_calloc(alignment, size, 1);
   }
   else
@@ -164,9 +254,14 @@ _Success_(return != 0) _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(
   mMemory_HasActiveAllocations = true;
 
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     return rpaligned_realloc(pBlock, alignment, size, oldSize, 0);
+  }
   else
+  {
     return _aligned_realloc(pBlock, size, alignment);
+  }
 #else
   mUnused(oldSize);
 
@@ -178,14 +273,91 @@ void __cdecl _m_internal_free_aligned(_Pre_maybenull_ _Post_invalid_ void *pBloc
 {
 #ifndef _DEBUG
   if (mMemory_RpMallocEnabled)
+  {
+    mMEMORY_ENSURE_THREAD_INITIALIZED();
     rpfree(pBlock);
+  }
   else
+  {
     _aligned_free(pBlock);
+  }
 #else
   _aligned_free(pBlock);
 #endif
 }
 
+// The pooled functions always use the thread caching size class allocator (if available), even if it isn't enabled for the default allocations.
+
+_Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_alloc(_In_ const size_t size)
+{
+#ifndef _DEBUG
+  if (mMemory_InitializeRpMalloc_Internal())
+  {
+    mMemory_EnsureThreadInitialized_Internal();
+    return rpmalloc(size);
+  }
+#endif
+
+  return malloc(size);
+}
+
+_Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_alloc_zero(_In_ const size_t size)
+{
+#ifndef _DEBUG
+  if (mMemory_InitializeRpMalloc_Internal())
+  {
+    mMemory_EnsureThreadInitialized_Internal();
+    return rpcalloc(size, 1);
+  }
+#endif
+
+  return calloc(size, 1);
+}
+
+_Success_(return != 0) _Check_return_ _Ret_maybenull_ _Post_writable_byte_size_(size) _CRTALLOCATOR _CRTRESTRICT void *_m_internal_pooled_realloc(_Pre_maybenull_ _Post_invalid_ void *pBlock, _In_ const size_t size)
+{
+#ifndef _DEBUG
+  if (mMemory_InitializeRpMalloc_Internal())
+  {
+    mMemory_EnsureThreadInitialized_Internal();
+    return rprealloc(pBlock, size);
+  }
+#endif
+
+  return realloc(pBlock, size);
+}
+
+void __cdecl _m_internal_pooled_free(_Pre_maybenull_ _Post_invalid_ void *pBlock)
+{
+#ifndef _DEBUG
+  if (mMemory_InitializeRpMalloc_Internal())
+  {
+    mMemory_EnsureThreadInitialized_Internal();
+    rpfree(pBlock);
+    return;
+  }
+#endif
+
+  free(pBlock);
+}
+
+size_t _m_internal_pooled_usable_size(_In_opt_ void *pBlock)
+{
+  if (pBlock == nullptr)
+    return 0;
+
+#ifndef _DEBUG
+  if (mMemory_InitializeRpMalloc_Internal())
+    return rpmalloc_usable_size(pBlock);
+#endif
+
+#ifdef mPLATFORM_WINDOWS
+  return _msize(pBlock);
+#else
+  return malloc_usable_size(pBlock);
+#endif
+}
+
 mFUNCTION(mStringLength, const char *text, const size_t maxCount, OUT size_t *pCount)
 {
   mFUNCTION_SETUP();
@@ -0,0 +1,290 @@
+#include "mPooledAllocator.h"
+
+#include <atomic>
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "AIU+69qWHBezB4PPEQn+BnnH/irJAzrwJV9Bf47FsY1jcVSOQaxNsCzStKhfsFxzn4IfwwRMQ53u8HTX"
+#endif
+
+// Per size class counters are split into shards, so threads don't constantly fight over the same cache lines.
+constexpr size_t mPooledAllocator_ShardCount = 16;
+
+// Live bytes are accumulated per shard and only moved to the shared counter (and compared against the high water mark) once they exceed this in either direction.
+constexpr int64_t mPooledAllocator_ShardFlushBytes = 64 * 1024;
+
+struct mPooledAllocator_Shard
+{
+  std::atomic<int64_t> pendingBytes; // can be negative if allocations are freed by another thread.
+  std::atomic<int64_t> liveCount[mPooledAllocator_SizeClassCount]; // can be negative if allocations are freed by another thread.
+  std::atomic<uint64_t> totalCount[mPooledAllocator_SizeClassCount];
+};
+
+struct mPooledAllocator_State
+{
+  std::atomic<int64_t> liveBytes; // excluding the pending bytes of the shards.
+  std::atomic<int64_t> highWaterMarkBytes;
+  bool disableStatistics;
+  uint8_t _padding[64];
+  mPooledAllocator_Shard shards[mPooledAllocator_ShardCount];
+};
+
+static std::atomic<size_t> mPooledAllocator_NextShardIndex { 0 };
+static thread_local size_t mPooledAllocator_CurrentShardIndex = mPooledAllocator_NextShardIndex++ % mPooledAllocator_ShardCount;
+
+static mPooledAllocator_State mPooledAllocator_GlobalState;
+
+static mFUNCTION(mPooledAllocator_Alloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mPooledAllocator_AllocZero_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mPooledAllocator_Realloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData);
+static mFUNCTION(mPooledAllocator_Free_Internal, IN uint8_t *pData, IN void *pUserData);
+static mFUNCTION(mPooledAllocator_Destroy_Internal, IN mAllocator *pAllocator, IN void *pUserData);
+static mFUNCTION(mPooledAllocator_GetState_Internal, IN mAllocator *pAllocator, OUT mPooledAllocator_State **ppState);
+static void mPooledAllocator_TrackAllocation_Internal(IN mPooledAllocator_State *pState, IN const void *pData);
+static void mPooledAllocator_TrackFree_Internal(IN mPooledAllocator_State *pState, const size_t bytes);
+static void mPooledAllocator_AddLiveBytes_Internal(IN mPooledAllocator_State *pState, mPooledAllocator_Shard &shard, const int64_t bytes);
+static int64_t mPooledAllocator_GetLiveBytes_Internal(IN mPooledAllocator_State *pState);
+
+mAllocator mPooledAllocator = mAllocator_StaticCreate(&mPooledAllocator_Alloc_Internal, &mPooledAllocator_Realloc_Internal, &mPooledAllocator_Free_Internal, &mPooledAllocator_AllocZero_Internal, nullptr, &mPooledAllocator_GlobalState);
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mPooledAllocator_Create, OUT mAllocator *pAllocator, const bool trackStatistics /* = true */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pAllocator == nullptr, mR_ArgumentNull);
+
+  mPooledAllocator_State *pState = nullptr;
+  mERROR_CHECK(mAllocZero(&pState, 1));
+  mDEFER_CALL_ON_ERROR(&pState, mFreePtr);
+
+  pState->disableStatistics = !trackStatistics;
+
+  mERROR_CHECK(mAllocator_Create(pAllocator, &mPooledAllocator_Alloc_Internal, &mPooledAllocator_Realloc_Internal, &mPooledAllocator_Free_Internal, &mPooledAllocator_AllocZero_Internal, &mPooledAllocator_Destroy_Internal, pState));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mPooledAllocator_GetStatistics, IN mAllocator *pAllocator, OUT mPooledAllocator_Statistics *pStatistics)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pStatistics == nullptr, mR_ArgumentNull);
+
+  mPooledAllocator_State *pState = nullptr;
+  mERROR_CHECK(mPooledAllocator_GetState_Internal(pAllocator, &pState));
+  mERROR_IF(pState->disableStatistics, mR_ResourceStateInvalid);
+
+  mERROR_CHECK(mMemset(pStatistics, 1, 0));
+
+  const int64_t liveBytes = mPooledAllocator_GetLiveBytes_Internal(pState);
+
+  pStatistics->liveBytes = (size_t)mMax((int64_t)0, liveBytes);
+  pStatistics->highWaterMarkBytes = (size_t)mMax((int64_t)0, mMax(liveBytes, pState->highWaterMarkBytes.load(std::memory_order_relaxed)));
+
+  for (size_t sizeClass = 0; sizeClass < mPooledAllocator_SizeClassCount; sizeClass++)
+  {
+    int64_t liveCount = 0;
+    uint64_t totalCount = 0;
+
+    for (size_t shard = 0; shard < mPooledAllocator_ShardCount; shard++)
+    {
+      liveCount += pState->shards[shard].liveCount[sizeClass].load(std::memory_order_relaxed);
+      totalCount += pState->shards[shard].totalCount[sizeClass].load(std::memory_order_relaxed);
+    }
+
+    pStatistics->liveAllocationCountPerSizeClass[sizeClass] = (size_t)mMax((int64_t)0, liveCount);
+    pStatistics->totalAllocationCountPerSizeClass[sizeClass] = (size_t)totalCount;
+    pStatistics->liveAllocationCount += pStatistics->liveAllocationCountPerSizeClass[sizeClass];
+    pStatistics->totalAllocationCount += pStatistics->totalAllocationCountPerSizeClass[sizeClass];
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mPooledAllocator_ResetHighWaterMark, IN mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mPooledAllocator_State *pState = nullptr;
+  mERROR_CHECK(mPooledAllocator_GetState_Internal(pAllocator, &pState));
+  mERROR_IF(pState->disableStatistics, mR_ResourceStateInvalid);
+
+  pState->highWaterMarkBytes.store(mPooledAllocator_GetLiveBytes_Internal(pState), std::memory_order_relaxed);
+
+  mRETURN_SUCCESS();
+}
+
+size_t mPooledAllocator_GetSizeClass(const size_t bytes)
+{
+  if (bytes <= mPooledAllocator_SmallSizeClassCount * 16)
+    return bytes == 0 ? 0 : (bytes - 1) / 16;
+
+  size_t sizeClass = mPooledAllocator_SmallSizeClassCount;
+  size_t maxBytes = mPooledAllocator_SmallSizeClassCount * 16 * 2;
+
+  while (bytes > maxBytes && sizeClass < mPooledAllocator_SizeClassCount - 1)
+  {
+    maxBytes <<= 1;
+    sizeClass++;
+  }
+
+  return sizeClass;
+}
+
+size_t mPooledAllocator_GetSizeClassMaxBytes(const size_t sizeClass)
+{
+  if (sizeClass < mPooledAllocator_SmallSizeClassCount)
+    return (sizeClass + 1) * 16;
+  else if (sizeClass < mPooledAllocator_SizeClassCount - 1)
+    return (mPooledAllocator_SmallSizeClassCount * 16) << (sizeClass - mPooledAllocator_SmallSizeClassCount + 1);
+  else
+    return SIZE_MAX;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mPooledAllocator_Alloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  uint8_t *pData = reinterpret_cast<uint8_t *>(_m_internal_pooled_alloc(size * count));
+  mERROR_IF(pData == nullptr, mR_MemoryAllocationFailure);
+
+  mPooledAllocator_TrackAllocation_Internal(reinterpret_cast<mPooledAllocator_State *>(pUserData), pData);
+
+  *ppData = pData;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mPooledAllocator_AllocZero_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  uint8_t *pData = reinterpret_cast<uint8_t *>(_m_internal_pooled_alloc_zero(size * count));
+  mERROR_IF(pData == nullptr, mR_MemoryAllocationFailure);
+
+  mPooledAllocator_TrackAllocation_Internal(reinterpret_cast<mPooledAllocator_State *>(pUserData), pData);
+
+  *ppData = pData;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mPooledAllocator_Realloc_Internal, OUT uint8_t **ppData, const size_t size, const size_t count, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mPooledAllocator_State *pState = reinterpret_cast<mPooledAllocator_State *>(pUserData);
+
+  const size_t previousBytes = pState->disableStatistics ? 0 : _m_internal_pooled_usable_size(*ppData);
+
+  uint8_t *pData = reinterpret_cast<uint8_t *>(_m_internal_pooled_realloc(*ppData, size * count));
+  mERROR_IF(pData == nullptr, mR_MemoryAllocationFailure); // The original allocation stays valid.
+
+  if (*ppData != nullptr)
+    mPooledAllocator_TrackFree_Internal(pState, previousBytes);
+
+  mPooledAllocator_TrackAllocation_Internal(pState, pData);
+
+  *ppData = pData;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mPooledAllocator_Free_Internal, IN uint8_t *pData, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  if (pData == nullptr)
+    mRETURN_SUCCESS();
+
+  mPooledAllocator_State *pState = reinterpret_cast<mPooledAllocator_State *>(pUserData);
+
+  if (!pState->disableStatistics)
+    mPooledAllocator_TrackFree_Internal(pState, _m_internal_pooled_usable_size(pData));
+
+  _m_internal_pooled_free(pData);
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mPooledAllocator_Destroy_Internal, IN mAllocator * /* pAllocator */, IN void *pUserData)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pUserData == nullptr, mR_ArgumentNull);
+
+  mPooledAllocator_State *pState = reinterpret_cast<mPooledAllocator_State *>(pUserData);
+  mERROR_CHECK(mFreePtr(&pState));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mPooledAllocator_GetState_Internal, IN mAllocator *pAllocator, OUT mPooledAllocator_State **ppState)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pAllocator == nullptr, mR_ArgumentNull);
+  mERROR_IF(!pAllocator->initialized || pAllocator->pAllocate != &mPooledAllocator_Alloc_Internal || pAllocator->pUserData == nullptr, mR_InvalidParameter);
+
+  *ppState = reinterpret_cast<mPooledAllocator_State *>(pAllocator->pUserData);
+
+  mRETURN_SUCCESS();
+}
+
+static void mPooledAllocator_TrackAllocation_Internal(IN mPooledAllocator_State *pState, IN const void *pData)
+{
+  if (pState->disableStatistics)
+    return;
+
+  const size_t bytes = _m_internal_pooled_usable_size(const_cast<void *>(pData));
+  const size_t sizeClass = mPooledAllocator_GetSizeClass(bytes);
+  mPooledAllocator_Shard &shard = pState->shards[mPooledAllocator_CurrentShardIndex];
+
+  shard.liveCount[sizeClass].fetch_add(1, std::memory_order_relaxed);
+  shard.totalCount[sizeClass].fetch_add(1, std::memory_order_relaxed);
+
+  mPooledAllocator_AddLiveBytes_Internal(pState, shard, (int64_t)bytes);
+}
+
+static void mPooledAllocator_TrackFree_Internal(IN mPooledAllocator_State *pState, const size_t bytes)
+{
+  if (pState->disableStatistics)
+    return;
+
+  mPooledAllocator_Shard &shard = pState->shards[mPooledAllocator_CurrentShardIndex];
+
+  shard.liveCount[mPooledAllocator_GetSizeClass(bytes)].fetch_sub(1, std::memory_order_relaxed);
+
+  mPooledAllocator_AddLiveBytes_Internal(pState, shard, -(int64_t)bytes);
+}
+
+static void mPooledAllocator_AddLiveBytes_Internal(IN mPooledAllocator_State *pState, mPooledAllocator_Shard &shard, const int64_t bytes)
+{
+  const int64_t pendingBytes = shard.pendingBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+  if (pendingBytes < mPooledAllocator_ShardFlushBytes && pendingBytes > -mPooledAllocator_ShardFlushBytes)
+    return;
+
+  const int64_t flushedBytes = shard.pendingBytes.exchange(0, std::memory_order_relaxed);
+  const int64_t liveBytes = pState->liveBytes.fetch_add(flushedBytes, std::memory_order_relaxed) + flushedBytes;
+  int64_t highWaterMarkBytes = pState->highWaterMarkBytes.load(std::memory_order_relaxed);
+
+  while (liveBytes > highWaterMarkBytes && !pState->highWaterMarkBytes.compare_exchange_weak(highWaterMarkBytes, liveBytes, std::memory_order_relaxed))
+    ;
+}
+
+static int64_t mPooledAllocator_GetLiveBytes_Internal(IN mPooledAllocator_State *pState)
+{
+  int64_t liveBytes = pState->liveBytes.load(std::memory_order_relaxed);
+
+  for (size_t shard = 0; shard < mPooledAllocator_ShardCount; shard++)
+    liveBytes += pState->shards[shard].pendingBytes.load(std::memory_order_relaxed);
+
+  return liveBytes;
+}
@@ -2,6 +2,16 @@
 
 #include "mJson.h"
 
+#include <mutex>
+#include <thread>
+
+#ifdef mPLATFORM_LINUX
+ #include <unistd.h>
+ #include <sys/syscall.h>
+#elif !defined(mPLATFORM_WINDOWS)
+ #include <unistd.h>
+#endif
+
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
     #undef __M_FILE__
@@ -10,6 +20,39 @@
 #endif
 
 mProfiler _GlobalProfiler = {};
+thread_local mProfiler_ThreadBuffer *_mProfiler_pThreadBuffer = nullptr;
+
+// Marks the buffer of a thread as reusable once the thread exits.
+struct mProfiler_ThreadBufferOwner
+{
+  mProfiler_ThreadBuffer *pBuffer = nullptr;
+
+  ~mProfiler_ThreadBufferOwner()
+  {
+    if (pBuffer != nullptr)
+      pBuffer->isOwned = false;
+  }
+};
+
+static thread_local mProfiler_ThreadBufferOwner mProfiler_CurrentThreadBufferOwner;
+static thread_local uint32_t mProfiler_CurrentThreadId = 0;
+
+static std::mutex mProfiler_ThreadBufferMutex;
+static mProfiler_ThreadBuffer *mProfiler_pFirstThreadBuffer = nullptr;
+
+// Interned names. Like the thread buffers these are never released, as other threads might still reference them.
+static std::mutex mProfiler_NameMutex;
+static char **mProfiler_ppNames = nullptr; // indexed by `nameId - 1`.
+static size_t mProfiler_NameCount = 0;
+static size_t mProfiler_NameCapacity = 0;
+static mProfiler_NameId *mProfiler_pNameTable = nullptr; // open addressing table of name ids.
+static size_t mProfiler_NameTableCapacity = 0;
+
+static void mProfiler_Calibrate_Internal();
+static uint64_t mProfiler_HashName_Internal(const char *name);
+static size_t mProfiler_GetHistogramBucket_Internal(const uint64_t ticks);
+static double_t mProfiler_GetHistogramBucketCenter_Internal(const size_t bucket);
+static bool mProfiler_CollectStatistics_Internal(const mProfiler_NameId nameId, OUT mProfiler_Statistics *pStatistics);
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -17,16 +60,19 @@ mFUNCTION(mProfiler_Allocate, const size_t eventCount)
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF((eventCount & (eventCount - 1)), mR_InvalidParameter); // Parameter is not a power of two.
+  mERROR_IF(eventCount == 0 || (eventCount & (eventCount - 1)), mR_InvalidParameter); // Parameter is not a power of two.
   mERROR_IF(_GlobalProfiler.enabled, mR_ResourceStateInvalid);
 
-  mProfiler_Record *pRecord = nullptr;
-  mERROR_CHECK(mAlloc(&pRecord, eventCount));
+  if (_GlobalProfiler.ticksPerNs == 0)
+    mProfiler_Calibrate_Internal();
 
-  _GlobalProfiler.count = eventCount;
-  _GlobalProfiler.pRecords = pRecord; // THIS IS AN INTENTIONAL MEMORY LEAK! (IN CASE ANOTHER THREAD IS STILL WRITING TO THE OLD POINTER)
+  // Thread buffers are reallocated lazily when their generation doesn't match anymore.
+  {
+    std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
 
-  MemoryBarrier();
+    _GlobalProfiler.count = eventCount;
+    ++_GlobalProfiler.generation;
+  }
 
   mRETURN_SUCCESS();
 }
@@ -37,14 +83,14 @@ mFUNCTION(mProfiler_Enable)
 
   mERROR_IF(_GlobalProfiler.count == 0, mR_NotInitialized);
 
-  _InterlockedExchange64(&_GlobalProfiler.enabled, 1);
+  _GlobalProfiler.enabled = true;
 
   mRETURN_SUCCESS();
 }
 
 mFUNCTION(mProfiler_Disable)
 {
-  _InterlockedExchange64(&_GlobalProfiler.enabled, 0);
+  _GlobalProfiler.enabled = false;
 
   return mR_Success;
 }
@@ -55,23 +101,30 @@ mFUNCTION(mProfiler_Reset)
 
   mERROR_IF(!_GlobalProfiler.enabled, mR_ResourceStateInvalid);
 
-  _InterlockedExchange64(&_GlobalProfiler.index, 0);
+  ++_GlobalProfiler.generation;
 
   mRETURN_SUCCESS();
 }
 
+struct mProfiler_MergeCursor
+{
+  mProfiler_ThreadBuffer *pBuffer;
+  uint64_t index, end;
+  size_t depth;
+};
+
 mFUNCTION(mProfiler_WriteToChromiumTraceEventFile, const mString &filename)
 {
   mFUNCTION_SETUP();
 
   mERROR_IF(filename.hasFailed || filename.bytes < 2, mR_InvalidParameter);
-  mERROR_IF(_GlobalProfiler.count == 0 || _GlobalProfiler.pRecords == nullptr, mR_NotInitialized);
+  mERROR_IF(_GlobalProfiler.count == 0, mR_NotInitialized);
 
   mPtr<mJsonWriter> jsonWriter;
   mDEFER_CALL(&jsonWriter, mJsonWriter_Destroy);
   mERROR_CHECK(mJsonWriter_Create(&jsonWriter, &mDefaultTempAllocator));
 
-  const bool wasEnabled = _GlobalProfiler.enabled != 0;
+  const bool wasEnabled = _GlobalProfiler.enabled;
 
   mDEFER(
     if (wasEnabled)
@@ -81,55 +134,132 @@ mFUNCTION(mProfiler_WriteToChromiumTraceEventFile, const mString &filename)
   if (wasEnabled)
     mERROR_CHECK(mProfiler_Disable());
 
-  const size_t max = mMin(mMax(_GlobalProfiler.index - 1, (int64_t)0), (int64_t)_GlobalProfiler.count);
+  const uint64_t generation = _GlobalProfiler.generation;
+
+  mProfiler_MergeCursor *pCursors = nullptr;
+  size_t cursorCount = 0;
+  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pCursors);
+
+  // Collect the buffers of the current generation. Buffers are never released, so they can be read after unlocking.
+  {
+    std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
+
+    size_t bufferCount = 0;
+
+    for (mProfiler_ThreadBuffer *pBuffer = mProfiler_pFirstThreadBuffer; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+      ++bufferCount;
+
+    mERROR_CHECK(mAllocator_AllocateZero(&mDefaultTempAllocator, &pCursors, mMax((size_t)1, bufferCount)));
+
+    for (mProfiler_ThreadBuffer *pBuffer = mProfiler_pFirstThreadBuffer; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+    {
+      if (pBuffer->generation != generation)
+        continue;
+
+      const uint64_t end = pBuffer->writeIndex.load(std::memory_order_acquire);
+      const uint64_t capacity = pBuffer->capacityMask + 1;
+
+      if (end == 0)
+        continue;
+
+      mProfiler_MergeCursor &cursor = pCursors[cursorCount++];
+      cursor.pBuffer = pBuffer;
+      cursor.end = end;
+      cursor.index = (end > capacity) ? end - capacity : 0;
+    }
+  }
 
   // Add Trace Events.
   {
     mERROR_CHECK(mJsonWriter_BeginArray(jsonWriter, "traceEvents"));
 
+#ifdef mPLATFORM_WINDOWS
     const double_t pid = (double_t)GetCurrentProcessId();
-    size_t firstTimePoint = (size_t)-1;
+#else
+    const double_t pid = (double_t)getpid();
+#endif
 
-    for (size_t i = 0; i < max; i++)
-      if (_GlobalProfiler.pRecords[i].eventTime < firstTimePoint)
-        firstTimePoint = _GlobalProfiler.pRecords[i].eventTime;
+    uint64_t firstTimePoint = (uint64_t)-1;
 
-    for (size_t i = 0; i < max; i++)
+    for (size_t i = 0; i < cursorCount; i++)
+      firstTimePoint = mMin(firstTimePoint, pCursors[i].pBuffer->pRecords[pCursors[i].index & pCursors[i].pBuffer->capacityMask].timestamp);
+
+    // The records of every thread are already ordered, so they just have to be merged.
+    while (true)
     {
-      bool found = false;
+      mProfiler_MergeCursor *pNext = nullptr;
+      uint64_t nextTimestamp = (uint64_t)-1;
 
-      if (!_GlobalProfiler.pRecords[i].eventStart)
+      for (size_t i = 0; i < cursorCount; i++)
       {
-        for (size_t j = 0; j < max; j++)
+        if (pCursors[i].index == pCursors[i].end)
+          continue;
+
+        const uint64_t timestamp = pCursors[i].pBuffer->pRecords[pCursors[i].index & pCursors[i].pBuffer->capacityMask].timestamp;
+
+        if (timestamp < nextTimestamp)
         {
-          if (i != j && _GlobalProfiler.pRecords[j].eventStart && _GlobalProfiler.pRecords[i].eventTime > _GlobalProfiler.pRecords[j].eventTime && strncmp(_GlobalProfiler.pRecords[i].name, _GlobalProfiler.pRecords[j].name, sizeof(mProfiler_Record::name)) == 0)
-          {
-            found = true;
-            break;
-          }
+          nextTimestamp = timestamp;
+          pNext = &pCursors[i];
         }
       }
-      else
+
+      if (pNext == nullptr)
+        break;
+
+      const mProfiler_Record &record = pNext->pBuffer->pRecords[pNext->index & pNext->pBuffer->capacityMask];
+      ++pNext->index;
+
+      // Skip end events of which the start event has already been overwritten.
+      if (record.type == mP_RT_EventEnd)
       {
-        for (size_t j = 0; j < max; j++)
-        {
-          if (i != j && !_GlobalProfiler.pRecords[j].eventStart && _GlobalProfiler.pRecords[i].eventTime < _GlobalProfiler.pRecords[j].eventTime && strncmp(_GlobalProfiler.pRecords[i].name, _GlobalProfiler.pRecords[j].name, sizeof(mProfiler_Record::name)) == 0)
-          {
-            found = true;
-            break;
-          }
-        }
+        if (pNext->depth == 0)
+          continue;
+
+        --pNext->depth;
+      }
+      else if (record.type == mP_RT_EventStart)
+      {
+        ++pNext->depth;
       }
 
-      if (!found)
+      const char *name = mProfiler_GetName(record.nameId);
+
+      if (name == nullptr)
         continue;
 
       mERROR_CHECK(mJsonWriter_BeginUnnamed(jsonWriter));
-      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "name", _GlobalProfiler.pRecords[i].name));
+      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "name", name));
       mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "pid", pid));
-      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "tid", (double_t)_GlobalProfiler.pRecords[i].asyncOrThreadIndex));
-      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ph", _GlobalProfiler.pRecords[i].eventStart ? "B" : "E"));
-      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ts", (double_t)(_GlobalProfiler.pRecords[i].eventTime - firstTimePoint) * 1e-3));
+      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "tid", (double_t)record.asyncOrThreadIndex));
+      mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ts", mProfiler_TicksToNs(record.timestamp - firstTimePoint) * 1e-3));
+
+      switch (record.type)
+      {
+      case mP_RT_EventStart:
+      case mP_RT_EventEnd:
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ph", record.type == mP_RT_EventStart ? "B" : "E"));
+        break;
+
+      case mP_RT_Counter:
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ph", "C"));
+        mERROR_CHECK(mJsonWriter_BeginNamed(jsonWriter, "args"));
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, name, (double_t)record.value));
+        mERROR_CHECK(mJsonWriter_EndNamed(jsonWriter));
+        break;
+
+      case mP_RT_FlowStart:
+      case mP_RT_FlowEnd:
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "ph", record.type == mP_RT_FlowStart ? "s" : "f"));
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "cat", "flow"));
+        mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "id", mFormat("0x", mFUInt<mFHex>((uint64_t)record.value))));
+
+        if (record.type == mP_RT_FlowEnd)
+          mERROR_CHECK(mJsonWriter_AddValue(jsonWriter, "bp", "e")); // Bind to the enclosing event instead of the next one.
+
+        break;
+      }
+
       mERROR_CHECK(mJsonWriter_EndUnnamed(jsonWriter));
     }
 
@@ -142,14 +272,493 @@ mFUNCTION(mProfiler_WriteToChromiumTraceEventFile, const mString &filename)
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mProfiler_EnableAggregation)
+{
+  _GlobalProfiler.aggregate = true;
+
+  return mR_Success;
+}
+
+mFUNCTION(mProfiler_DisableAggregation)
+{
+  _GlobalProfiler.aggregate = false;
+
+  return mR_Success;
+}
+
+mFUNCTION(mProfiler_ResetStatistics)
+{
+  mFUNCTION_SETUP();
+
+  std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
+
+  for (mProfiler_ThreadBuffer *pBuffer = mProfiler_pFirstThreadBuffer; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+  {
+    for (size_t i = 0; i < mProfiler_StatisticsChunkCount; i++)
+    {
+      mProfiler_EventStatistics *pChunk = pBuffer->pStatisticsChunks[i].load(std::memory_order_acquire);
+
+      if (pChunk == nullptr)
+        continue;
+
+      for (size_t j = 0; j < mProfiler_StatisticsChunkSize; j++)
+      {
+        pChunk[j].count.store(0, std::memory_order_relaxed);
+        pChunk[j].totalTicks.store(0, std::memory_order_relaxed);
+        pChunk[j].minTicks.store((uint64_t)-1, std::memory_order_relaxed);
+        pChunk[j].maxTicks.store(0, std::memory_order_relaxed);
+
+        for (size_t k = 0; k < mProfiler_HistogramBucketCount; k++)
+          pChunk[j].histogram[k].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mProfiler_GetStatistics, const mProfiler_NameId nameId, OUT mProfiler_Statistics *pStatistics)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pStatistics == nullptr, mR_ArgumentNull);
+  mERROR_IF(nameId == 0, mR_InvalidParameter);
+
+  std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
+
+  mERROR_IF(!mProfiler_CollectStatistics_Internal(nameId, pStatistics), mR_ResourceNotFound);
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mProfiler_GetStatistics, IN const char *name, OUT mProfiler_Statistics *pStatistics)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(name == nullptr || pStatistics == nullptr, mR_ArgumentNull);
+
+  const mProfiler_NameId nameId = mProfiler_InternName(name);
+  mERROR_IF(nameId == 0, mR_InternalError);
+
+  mERROR_CHECK(mProfiler_GetStatistics(nameId, pStatistics));
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mProfiler_ForEachStatistics, const std::function<mResult(const mProfiler_Statistics &statistics)> &callback)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(callback == nullptr, mR_ArgumentNull);
+
+  size_t nameCount = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(mProfiler_NameMutex);
+    nameCount = mProfiler_NameCount;
+  }
+
+  nameCount = mMin(nameCount, mProfiler_StatisticsChunkSize * mProfiler_StatisticsChunkCount - 1);
+
+  for (size_t i = 1; i <= nameCount; i++)
+  {
+    mProfiler_Statistics statistics;
+    bool found = false;
+
+    {
+      std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
+      found = mProfiler_CollectStatistics_Internal((mProfiler_NameId)i, &statistics);
+    }
+
+    // Don't hold the lock while calling the callback, it might report events itself.
+    if (found)
+    {
+      const mResult result = callback(statistics);
+
+      if (result == mR_Break)
+        break;
+
+      mERROR_IF(mFAILED(result), result);
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mProfiler_NameId mProfiler_InternName(const char *name)
+{
+  if (name == nullptr)
+    return 0;
+
+  const uint64_t hash = mProfiler_HashName_Internal(name);
+
+  std::lock_guard<std::mutex> lock(mProfiler_NameMutex);
+
+  if (mProfiler_NameTableCapacity != 0)
+  {
+    for (size_t i = (size_t)hash & (mProfiler_NameTableCapacity - 1); mProfiler_pNameTable[i] != 0; i = (i + 1) & (mProfiler_NameTableCapacity - 1))
+      if (strcmp(mProfiler_ppNames[mProfiler_pNameTable[i] - 1], name) == 0)
+        return mProfiler_pNameTable[i];
+  }
+
+  // Keep the table at most half full.
+  if ((mProfiler_NameCount + 1) * 2 > mProfiler_NameTableCapacity)
+  {
+    const size_t newCapacity = mMax((size_t)256, mProfiler_NameTableCapacity * 2);
+    mProfiler_NameId *pNewTable = nullptr;
+
+    if (mFAILED(mSILENCE_ERROR(mAllocZero(&pNewTable, newCapacity))))
+      return 0;
+
+    for (size_t i = 0; i < mProfiler_NameCount; i++)
+    {
+      size_t index = (size_t)mProfiler_HashName_Internal(mProfiler_ppNames[i]) & (newCapacity - 1);
+
+      while (pNewTable[index] != 0)
+        index = (index + 1) & (newCapacity - 1);
+
+      pNewTable[index] = (mProfiler_NameId)(i + 1);
+    }
+
+    mFreePtr(&mProfiler_pNameTable);
+    mProfiler_pNameTable = pNewTable;
+    mProfiler_NameTableCapacity = newCapacity;
+  }
+
+  if (mProfiler_NameCount == mProfiler_NameCapacity)
+  {
+    const size_t newCapacity = mMax((size_t)64, mProfiler_NameCapacity * 2);
+    char **ppNewNames = nullptr;
+
+    if (mFAILED(mSILENCE_ERROR(mAllocZero(&ppNewNames, newCapacity))))
+      return 0;
+
+    if (mProfiler_NameCount > 0)
+      mMemcpy(ppNewNames, mProfiler_ppNames, mProfiler_NameCount);
+
+    mFreePtr(&mProfiler_ppNames);
+    mProfiler_ppNames = ppNewNames;
+    mProfiler_NameCapacity = newCapacity;
+  }
+
+  const size_t length = strlen(name);
+  char *nameCopy = nullptr;
+
+  if (mFAILED(mSILENCE_ERROR(mAlloc(&nameCopy, length + 1))))
+    return 0;
+
+  mMemcpy(nameCopy, name, length + 1);
+
+  mProfiler_ppNames[mProfiler_NameCount] = nameCopy;
+  const mProfiler_NameId nameId = (mProfiler_NameId)++mProfiler_NameCount;
+
+  size_t index = (size_t)hash & (mProfiler_NameTableCapacity - 1);
+
+  while (mProfiler_pNameTable[index] != 0)
+    index = (index + 1) & (mProfiler_NameTableCapacity - 1);
+
+  mProfiler_pNameTable[index] = nameId;
+
+  return nameId;
+}
+
+const char * mProfiler_GetName(const mProfiler_NameId nameId)
+{
+  std::lock_guard<std::mutex> lock(mProfiler_NameMutex);
+
+  if (nameId == 0 || nameId > mProfiler_NameCount)
+    return nullptr;
+
+  return mProfiler_ppNames[nameId - 1];
+}
+
+uint32_t mProfiler_GetCurrentThreadId()
+{
+  if (mProfiler_CurrentThreadId == 0)
+  {
+#ifdef mPLATFORM_WINDOWS
+    mProfiler_CurrentThreadId = (uint32_t)GetCurrentThreadId();
+#elif defined(mPLATFORM_LINUX)
+    mProfiler_CurrentThreadId = (uint32_t)syscall(SYS_gettid);
+#else
+    mProfiler_CurrentThreadId = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+  }
+
+  return mProfiler_CurrentThreadId;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
-void mProfiler_ReportEventStart_NoInline(const char *name, const uint32_t asyncOrThreadIndex /* = GetCurrentThreadId() */)
+mProfiler_ThreadBuffer * mProfiler_AcquireThreadBuffer_Internal()
+{
+  std::lock_guard<std::mutex> lock(mProfiler_ThreadBufferMutex);
+
+  const uint64_t generation = _GlobalProfiler.generation;
+  const size_t capacity = _GlobalProfiler.count;
+
+  if (capacity == 0)
+    return nullptr;
+
+  mProfiler_ThreadBuffer *pBuffer = _mProfiler_pThreadBuffer;
+
+  if (pBuffer == nullptr)
+  {
+    // Reuse the buffer of a thread that has exited.
+    for (mProfiler_ThreadBuffer *pCandidate = mProfiler_pFirstThreadBuffer; pCandidate != nullptr; pCandidate = pCandidate->pNext)
+    {
+      if (!pCandidate->isOwned)
+      {
+        pBuffer = pCandidate;
+        break;
+      }
+    }
+
+    if (pBuffer == nullptr)
+    {
+      if (mFAILED(mSILENCE_ERROR(mAllocZero(&pBuffer, 1))))
+        return nullptr;
+
+      new (&pBuffer->writeIndex) std::atomic<uint64_t>(0);
+      new (&pBuffer->isOwned) std::atomic<bool>(false);
+
+      pBuffer->pNext = mProfiler_pFirstThreadBuffer;
+      mProfiler_pFirstThreadBuffer = pBuffer;
+    }
+
+    pBuffer->isOwned = true;
+    pBuffer->threadId = mProfiler_GetCurrentThreadId();
+    pBuffer->aggregationDepth = 0; // Events of a previous owner that never ended.
+
+    mProfiler_CurrentThreadBufferOwner.pBuffer = pBuffer;
+    _mProfiler_pThreadBuffer = pBuffer;
+  }
+
+  if (pBuffer->generation != generation)
+  {
+    if (pBuffer->pRecords == nullptr || pBuffer->capacityMask + 1 != capacity)
+    {
+      mProfiler_Record *pRecords = nullptr;
+
+      if (mFAILED(mSILENCE_ERROR(mAlloc(&pRecords, capacity))))
+        return nullptr;
+
+      pBuffer->pRecords = pRecords; // THIS IS AN INTENTIONAL MEMORY LEAK! (IN CASE THE OLD RECORDS ARE STILL BEING READ)
+      pBuffer->capacityMask = capacity - 1;
+    }
+
+    pBuffer->writeIndex.store(0, std::memory_order_release);
+    pBuffer->generation = generation;
+  }
+
+  return pBuffer;
+}
+
+mProfiler_NameId mProfiler_CacheNameId_Internal(mProfiler_ThreadBuffer *pBuffer, const char *name)
+{
+  const mProfiler_NameId nameId = mProfiler_InternName(name);
+
+  if (nameId != 0)
+  {
+    mProfiler_NameCacheEntry &cacheEntry = pBuffer->nameCache[(reinterpret_cast<size_t>(name) >> 3) & (mProfiler_NameCacheSize - 1)];
+    cacheEntry.name = name;
+    cacheEntry.nameId = nameId;
+  }
+
+  return nameId;
+}
+
+void mProfiler_Aggregate_Internal(mProfiler_ThreadBuffer *pBuffer, const mProfiler_NameId nameId, const mProfiler_RecordType type, const uint64_t timestamp)
+{
+  if (type == mP_RT_EventStart)
+  {
+    if (pBuffer->aggregationDepth < mProfiler_MaxAggregationDepth)
+    {
+      pBuffer->aggregationStack[pBuffer->aggregationDepth].nameId = nameId;
+      pBuffer->aggregationStack[pBuffer->aggregationDepth].timestamp = timestamp;
+    }
+
+    ++pBuffer->aggregationDepth;
+
+    return;
+  }
+
+  if (pBuffer->aggregationDepth == 0) // Aggregation has been enabled after the start event.
+    return;
+
+  --pBuffer->aggregationDepth;
+
+  if (pBuffer->aggregationDepth >= mProfiler_MaxAggregationDepth)
+    return;
+
+  const mProfiler_AggregationStackEntry &entry = pBuffer->aggregationStack[pBuffer->aggregationDepth];
+
+  if (entry.nameId != nameId || nameId >= mProfiler_StatisticsChunkSize * mProfiler_StatisticsChunkCount)
+    return;
+
+  std::atomic<mProfiler_EventStatistics *> &chunk = pBuffer->pStatisticsChunks[nameId / mProfiler_StatisticsChunkSize];
+  mProfiler_EventStatistics *pChunk = chunk.load(std::memory_order_relaxed);
+
+  if (pChunk == nullptr)
+  {
+    if (mFAILED(mSILENCE_ERROR(mAllocZero(&pChunk, mProfiler_StatisticsChunkSize))))
+      return;
+
+    for (size_t i = 0; i < mProfiler_StatisticsChunkSize; i++)
+      pChunk[i].minTicks.store((uint64_t)-1, std::memory_order_relaxed);
+
+    chunk.store(pChunk, std::memory_order_release);
+  }
+
+  mProfiler_EventStatistics &statistics = pChunk[nameId % mProfiler_StatisticsChunkSize];
+  const uint64_t duration = timestamp - entry.timestamp;
+
+  // This thread is the only one writing to the statistics, so no read-modify-write operations are required.
+  statistics.count.store(statistics.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  statistics.totalTicks.store(statistics.totalTicks.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+
+  if (duration < statistics.minTicks.load(std::memory_order_relaxed))
+    statistics.minTicks.store(duration, std::memory_order_relaxed);
+
+  if (duration > statistics.maxTicks.load(std::memory_order_relaxed))
+    statistics.maxTicks.store(duration, std::memory_order_relaxed);
+
+  std::atomic<uint32_t> &bucket = statistics.histogram[mProfiler_GetHistogramBucket_Internal(duration)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void mProfiler_ReportEventStart_NoInline(const char *name, const uint32_t asyncOrThreadIndex /* = mProfiler_CurrentThread */)
 {
   mProfiler_ReportEventStart(name, asyncOrThreadIndex);
 }
 
-void mProfiler_ReportEventEnd_NoInline(const char *name, const uint32_t asyncOrThreadIndex /* = GetCurrentThreadId() */)
+void mProfiler_ReportEventEnd_NoInline(const char *name, const uint32_t asyncOrThreadIndex /* = mProfiler_CurrentThread */)
 {
   mProfiler_ReportEventEnd(name, asyncOrThreadIndex);
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+static void mProfiler_Calibrate_Internal()
+{
+  const uint64_t startTicks = mProfiler_GetTimestamp();
+  const auto startTime = std::chrono::steady_clock::now();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  const uint64_t endTicks = mProfiler_GetTimestamp();
+  const int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+  _GlobalProfiler.ticksPerNs = (double_t)(endTicks - startTicks) / (double_t)mMax((int64_t)1, elapsedNs);
+
+  if (_GlobalProfiler.ticksPerNs <= 0)
+    _GlobalProfiler.ticksPerNs = 1;
+}
+
+static uint64_t mProfiler_HashName_Internal(const char *name)
+{
+  // FNV-1a
+  uint64_t hash = 0xCBF29CE484222325ULL;
+
+  for (; *name != '\0'; name++)
+    hash = (hash ^ (uint8_t)*name) * 0x100000001B3ULL;
+
+  return hash;
+}
+
+static size_t mProfiler_GetHistogramBucket_Internal(const uint64_t ticks)
+{
+  if (ticks < 4)
+    return (size_t)ticks;
+
+#ifdef _MSC_VER
+  unsigned long highestBit;
+  _BitScanReverse64(&highestBit, ticks);
+#else
+  const size_t highestBit = 63 - __builtin_clzll(ticks);
+#endif
+
+  // The two bits following the highest bit select the sub bucket.
+  return (size_t)(highestBit - 1) * 4 + (size_t)((ticks >> (highestBit - 2)) & 3);
+}
+
+static double_t mProfiler_GetHistogramBucketCenter_Internal(const size_t bucket)
+{
+  if (bucket < 4)
+    return (double_t)bucket;
+
+  const size_t highestBit = bucket / 4 + 1;
+  const double_t bucketSize = (double_t)(1ULL << (highestBit - 2));
+  const double_t lowerBound = (double_t)(4 + bucket % 4) * bucketSize;
+
+  return lowerBound + bucketSize * 0.5;
+}
+
+// `mProfiler_ThreadBufferMutex` has to be locked.
+static bool mProfiler_CollectStatistics_Internal(const mProfiler_NameId nameId, OUT mProfiler_Statistics *pStatistics)
+{
+  if (nameId >= mProfiler_StatisticsChunkSize * mProfiler_StatisticsChunkCount)
+    return false;
+
+  uint64_t count = 0;
+  uint64_t totalTicks = 0;
+  uint64_t minTicks = (uint64_t)-1;
+  uint64_t maxTicks = 0;
+  uint64_t histogram[mProfiler_HistogramBucketCount] = {};
+
+  for (mProfiler_ThreadBuffer *pBuffer = mProfiler_pFirstThreadBuffer; pBuffer != nullptr; pBuffer = pBuffer->pNext)
+  {
+    mProfiler_EventStatistics *pChunk = pBuffer->pStatisticsChunks[nameId / mProfiler_StatisticsChunkSize].load(std::memory_order_acquire);
+
+    if (pChunk == nullptr)
+      continue;
+
+    const mProfiler_EventStatistics &statistics = pChunk[nameId % mProfiler_StatisticsChunkSize];
+
+    count += statistics.count.load(std::memory_order_relaxed);
+    totalTicks += statistics.totalTicks.load(std::memory_order_relaxed);
+    minTicks = mMin(minTicks, statistics.minTicks.load(std::memory_order_relaxed));
+    maxTicks = mMax(maxTicks, statistics.maxTicks.load(std::memory_order_relaxed));
+
+    for (size_t i = 0; i < mProfiler_HistogramBucketCount; i++)
+      histogram[i] += statistics.histogram[i].load(std::memory_order_relaxed);
+  }
+
+  if (count == 0)
+    return false;
+
+  pStatistics->nameId = nameId;
+  pStatistics->count = (size_t)count;
+  pStatistics->totalNs = mProfiler_TicksToNs(totalTicks);
+  pStatistics->minNs = mProfiler_TicksToNs(minTicks);
+  pStatistics->maxNs = mProfiler_TicksToNs(maxTicks);
+
+  const uint64_t p50Rank = (count + 1) / 2;
+  const uint64_t p99Rank = mMax((uint64_t)1, (uint64_t)ceil(count * 0.99));
+
+  uint64_t cumulativeCount = 0;
+  bool p50Found = false;
+
+  for (size_t i = 0; i < mProfiler_HistogramBucketCount; i++)
+  {
+    cumulativeCount += histogram[i];
+
+    if (!p50Found && cumulativeCount >= p50Rank)
+    {
+      p50Found = true;
+      pStatistics->p50Ns = mProfiler_TicksToNs((uint64_t)mProfiler_GetHistogramBucketCenter_Internal(i));
+    }
+
+    if (cumulativeCount >= p99Rank)
+    {
+      pStatistics->p99Ns = mProfiler_TicksToNs((uint64_t)mProfiler_GetHistogramBucketCenter_Internal(i));
+      break;
+    }
+  }
+
+  // The bucket centers can be slightly off, but the estimates should never be outside of the observed range.
+  pStatistics->p50Ns = mClamp(pStatistics->p50Ns, pStatistics->minNs, pStatistics->maxNs);
+  pStatistics->p99Ns = mClamp(pStatistics->p99Ns, pStatistics->minNs, pStatistics->maxNs);
+
+  return true;
+}
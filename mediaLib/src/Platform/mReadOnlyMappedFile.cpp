@@ -0,0 +1,262 @@
+#include "mReadOnlyMappedFile.h"
+
+#ifndef mPLATFORM_WINDOWS
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <errno.h>
+#endif
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "IOllUOnQPEn7MSrkmY2BwNV/ddF/nT5mhkA36goZIvrF5O06iffTTPWwqBSryZItzd+l54pLPtn0yTrX"
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+struct mReadOnlyMappedFile
+{
+#ifdef mPLATFORM_WINDOWS
+  HANDLE file, mapping;
+#else
+  int fileDescriptor;
+#endif
+  const uint8_t *pData;
+  size_t size;
+};
+
+static mFUNCTION(mReadOnlyMappedFile_Destroy_Internal, mReadOnlyMappedFile *pMappedFile);
+
+//////////////////////////////////////////////////////////////////////////
+
+mFUNCTION(mReadOnlyMappedFile_Create, OUT mPtr<mReadOnlyMappedFile> *pMappedFile, IN OPTIONAL mAllocator *pAllocator, const mString &filename, const mReadOnlyMappedFile_AccessPattern accessPattern /* = mROMF_AP_Normal */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pMappedFile == nullptr, mR_ArgumentNull);
+  mERROR_IF(filename.hasFailed || filename.bytes <= 1, mR_InvalidParameter);
+
+  mDEFER_CALL_ON_ERROR(pMappedFile, mSharedPointer_Destroy);
+  mERROR_CHECK(mSharedPointer_Allocate<mReadOnlyMappedFile>(pMappedFile, pAllocator, mReadOnlyMappedFile_Destroy_Internal, 1));
+
+#ifdef mPLATFORM_WINDOWS
+  wchar_t wfilename[MAX_PATH + 1];
+  mERROR_CHECK(mString_ToWideString(filename, wfilename, mARRAYSIZE(wfilename)));
+
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+
+  // Windows only takes access pattern hints when opening the file.
+  if (accessPattern == mROMF_AP_Sequential)
+    flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  else if (accessPattern == mROMF_AP_Random)
+    flags |= FILE_FLAG_RANDOM_ACCESS;
+
+  HANDLE file = CreateFileW(wfilename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    switch (GetLastError())
+    {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+      mRETURN_RESULT(mR_ResourceNotFound);
+
+    case ERROR_ACCESS_DENIED:
+      mRETURN_RESULT(mR_InsufficientPrivileges);
+
+    default:
+      mRETURN_RESULT(mR_IOFailure);
+    }
+  }
+
+  (*pMappedFile)->file = file;
+
+  LARGE_INTEGER size;
+  mERROR_IF(0 == GetFileSizeEx(file, &size), mR_IOFailure);
+  mERROR_IF((uint64_t)size.QuadPart > SIZE_MAX, mR_NotSupported);
+
+  (*pMappedFile)->size = (size_t)size.QuadPart;
+
+  if ((*pMappedFile)->size == 0) // Empty files can't be mapped.
+    mRETURN_SUCCESS();
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  mERROR_IF(mapping == nullptr, mR_InternalError);
+
+  (*pMappedFile)->mapping = mapping;
+
+  (*pMappedFile)->pData = reinterpret_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  mERROR_IF((*pMappedFile)->pData == nullptr, mR_MemoryAllocationFailure);
+#else
+  (*pMappedFile)->fileDescriptor = -1;
+
+  const int fileDescriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fileDescriptor == -1)
+  {
+    switch (errno)
+    {
+    case ENOENT:
+    case ENOTDIR:
+      mRETURN_RESULT(mR_ResourceNotFound);
+
+    case EACCES:
+    case EPERM:
+      mRETURN_RESULT(mR_InsufficientPrivileges);
+
+    default:
+      mRETURN_RESULT(mR_IOFailure);
+    }
+  }
+
+  (*pMappedFile)->fileDescriptor = fileDescriptor;
+
+  struct stat fileStatus;
+  mERROR_IF(0 != fstat(fileDescriptor, &fileStatus), mR_IOFailure);
+  mERROR_IF(!S_ISREG(fileStatus.st_mode), mR_ResourceIncompatible);
+  mERROR_IF((uint64_t)fileStatus.st_size > SIZE_MAX, mR_NotSupported);
+
+  (*pMappedFile)->size = (size_t)fileStatus.st_size;
+
+  if ((*pMappedFile)->size == 0) // Empty files can't be mapped.
+    mRETURN_SUCCESS();
+
+  void *pData = mmap(nullptr, (*pMappedFile)->size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  mERROR_IF(pData == MAP_FAILED, mR_MemoryAllocationFailure);
+
+  (*pMappedFile)->pData = reinterpret_cast<const uint8_t *>(pData);
+
+  mERROR_CHECK(mReadOnlyMappedFile_SetAccessPattern(*pMappedFile, accessPattern));
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mReadOnlyMappedFile_Destroy, IN_OUT mPtr<mReadOnlyMappedFile> *pMappedFile)
+{
+  return mSharedPointer_Destroy(pMappedFile);
+}
+
+mFUNCTION(mReadOnlyMappedFile_GetData, mPtr<mReadOnlyMappedFile> &mappedFile, OUT const uint8_t **ppData, OUT OPTIONAL size_t *pSize)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(mappedFile == nullptr || ppData == nullptr, mR_ArgumentNull);
+
+  *ppData = mappedFile->pData;
+
+  if (pSize != nullptr)
+    *pSize = mappedFile->size;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mReadOnlyMappedFile_GetSize, mPtr<mReadOnlyMappedFile> &mappedFile, OUT size_t *pSize)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(mappedFile == nullptr || pSize == nullptr, mR_ArgumentNull);
+
+  *pSize = mappedFile->size;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mReadOnlyMappedFile_SetAccessPattern, mPtr<mReadOnlyMappedFile> &mappedFile, const mReadOnlyMappedFile_AccessPattern accessPattern)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(mappedFile == nullptr, mR_ArgumentNull);
+
+  if (mappedFile->pData == nullptr)
+    mRETURN_SUCCESS();
+
+#ifdef mPLATFORM_WINDOWS
+  mUnused(accessPattern); // Has to be specified when creating the mapped file.
+#else
+  int advice = MADV_NORMAL;
+
+  switch (accessPattern)
+  {
+  case mROMF_AP_Normal:
+    advice = MADV_NORMAL;
+    break;
+
+  case mROMF_AP_Sequential:
+    advice = MADV_SEQUENTIAL;
+    break;
+
+  case mROMF_AP_Random:
+    advice = MADV_RANDOM;
+    break;
+
+  default:
+    mRETURN_RESULT(mR_InvalidParameter);
+  }
+
+  // This is only a hint, so failing isn't fatal.
+  /* int result = */ madvise(const_cast<uint8_t *>(mappedFile->pData), mappedFile->size, advice);
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mReadOnlyMappedFile_Prefetch, mPtr<mReadOnlyMappedFile> &mappedFile, const size_t offset, const size_t size)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(mappedFile == nullptr, mR_ArgumentNull);
+  mERROR_IF(offset > mappedFile->size || size > mappedFile->size - offset, mR_ArgumentOutOfBounds);
+
+  if (size == 0)
+    mRETURN_SUCCESS();
+
+#ifdef mPLATFORM_WINDOWS
+#if _WIN32_WINNT >= 0x0602 // _WIN32_WINNT_WIN8
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = const_cast<uint8_t *>(mappedFile->pData + offset);
+  range.NumberOfBytes = size;
+
+  /* BOOL result = */ PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+#else
+  // `madvise` requires the address to be page aligned.
+  const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t alignedOffset = offset - (offset % pageSize);
+
+  /* int result = */ madvise(const_cast<uint8_t *>(mappedFile->pData + alignedOffset), size + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mReadOnlyMappedFile_Destroy_Internal, mReadOnlyMappedFile *pMappedFile)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pMappedFile == nullptr, mR_ArgumentNull);
+
+#ifdef mPLATFORM_WINDOWS
+  if (pMappedFile->pData != nullptr)
+    UnmapViewOfFile(pMappedFile->pData);
+
+  if (pMappedFile->mapping != nullptr)
+    CloseHandle(pMappedFile->mapping);
+
+  if (pMappedFile->file != nullptr)
+    CloseHandle(pMappedFile->file);
+#else
+  if (pMappedFile->pData != nullptr)
+    munmap(const_cast<uint8_t *>(pMappedFile->pData), pMappedFile->size);
+
+  if (pMappedFile->fileDescriptor >= 0)
+    close(pMappedFile->fileDescriptor);
+#endif
+
+  mRETURN_SUCCESS();
+}
@@ -1,7 +1,15 @@
 #include "mediaLib.h"
+#include "mUnicode.h"
+#include "mQueue.h"
 
 #include "utf8proc.h"
 
+#ifdef _MSC_VER
+ #include <intrin.h>
+#else
+ #include <x86intrin.h>
+#endif
+
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
     #undef __M_FILE__
@@ -39,21 +47,29 @@ bool mString_IsValidChar(const char *c, const size_t size, OUT OPTIONAL mchar_t
 
 //////////////////////////////////////////////////////////////////////////
 
+static void mString_DestroyCharIndex_Internal(mString &string);
+static mFUNCTION(mString_FreeText_Internal, mString &string);
+static size_t mString_GetByteOffset_Internal(const mString &string, const size_t character, const size_t startCharacter = 0, const size_t startOffset = 0);
+
+//////////////////////////////////////////////////////////////////////////
+
 mString::mString() :
-  text(nullptr),
+  pText(nullptr),
   pAllocator(nullptr),
   bytes(0),
   count(0),
   capacity(0),
+  pCharIndex(nullptr),
   hasFailed(false)
 { }
 
 mString::mString(IN const char *text, const size_t size, IN OPTIONAL mAllocator *pAllocator) :
-  text(nullptr),
+  pText(nullptr),
   pAllocator(nullptr),
   bytes(0),
   count(0),
   capacity(0),
+  pCharIndex(nullptr),
   hasFailed(false)
 {
   mResult result = mR_Success;
@@ -84,10 +100,8 @@ mString::mString(const wchar_t *text, IN OPTIONAL mAllocator *pAllocator /* = nu
 
 mString::~mString()
 {
-  if (text != nullptr && pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE)
-    mAllocator_FreePtr(pAllocator, &text);
+  mString_FreeText_Internal(*this);
 
-  text = nullptr;
   pAllocator = nullptr;
   bytes = 0;
   count = 0;
@@ -96,11 +110,12 @@ mString::~mString()
 }
 
 mString::mString(const mString &copy) :
-  text(nullptr),
+  pText(nullptr),
   pAllocator(nullptr),
   bytes(0),
   count(0),
   capacity(0),
+  pCharIndex(nullptr),
   hasFailed(false)
 {
   if (copy.hasFailed)
@@ -113,11 +128,11 @@ mString::mString(const mString &copy) :
 
   pAllocator = copy.pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE ? copy.pAllocator : nullptr;
 
-  mERROR_CHECK_GOTO(mAllocator_AllocateZero(pAllocator, &text, copy.bytes), result, epilogue);
-  capacity = bytes = copy.bytes;
+  mERROR_CHECK_GOTO(mString_Reserve(*this, copy.bytes), result, epilogue);
+  bytes = copy.bytes;
   count = copy.count;
 
-  mMemcpy(text, copy.text, bytes);
+  mMemcpy(Data(), copy.c_str(), bytes);
 
   return;
 
@@ -127,14 +142,17 @@ epilogue:
 }
 
 mString::mString(mString &&move) :
-  text(move.text),
+  pText(move.pText),
   pAllocator(move.pAllocator),
   bytes(move.bytes),
   count(move.count),
   capacity(move.capacity),
   hasFailed(move.hasFailed)
 {
-  move.text = nullptr;
+  // Moves either the inline text or the character index.
+  mMemcpy(inlineText, move.inlineText, mARRAYSIZE(inlineText));
+
+  move.pText = nullptr;
   move.count = 0;
   move.bytes = 0;
   move.pAllocator = nullptr;
@@ -148,16 +166,10 @@ mString & mString::operator=(const mString &copy)
 
   this->hasFailed = false;
 
-  if (this->capacity < copy.bytes)
-  {
-    mERROR_CHECK_GOTO(mAllocator_Reallocate(pAllocator, &text, copy.bytes), result, epilogue);
-    this->capacity = copy.bytes;
-    mMemcpy(text, copy.text, copy.bytes);
-  }
-  else if(copy.bytes > 0)
-  {
-    mMemcpy(text, copy.text, copy.bytes);
-  }
+  mERROR_CHECK_GOTO(mString_Reserve(*this, copy.bytes), result, epilogue);
+
+  if (copy.bytes > 0)
+    mMemcpy(Data(), copy.c_str(), copy.bytes);
 
   this->bytes = copy.bytes;
   this->count = copy.count;
@@ -171,14 +183,16 @@ epilogue:
 
 mString & mString::operator=(mString &&move)
 {
-  if (move.text == nullptr)
+  if (move.Data() == nullptr)
   {
+    mString_DestroyCharIndex_Internal(*this);
+
     this->bytes = 0;
     this->count = 0;
     this->hasFailed = move.hasFailed;
 
-    if (this->text != nullptr)
-      this->text[0] = '\0';
+    if (this->Data() != nullptr)
+      this->Data()[0] = '\0';
   }
   else
   {
@@ -206,20 +220,15 @@ mchar_t mString::operator[](const size_t index) const
   if (index >= count)
     return codePoint;
 
-  size_t offset = 0;
-
-  for (size_t i = 0; i <= index; ++i)
-  {
-    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(this->text) + offset, this->bytes - offset, &codePoint);
+  if (IsAscii())
+    return (mchar_t)c_str()[index];
 
-    if (characterSize < 0 || codePoint < 0)
-      return codePoint;
+  const size_t offset = mString_GetByteOffset_Internal(*this, index);
 
-    offset += (size_t)characterSize;
+  if (offset >= bytes)
+    return codePoint;
 
-    if (characterSize == 0)
-      break;
-  }
+  utf8proc_iterate(reinterpret_cast<const uint8_t *>(c_str()) + offset, bytes - offset, &codePoint);
 
   return codePoint;
 }
@@ -234,13 +243,13 @@ mString mString::operator+(const mString &s) const
   mString ret;
   mResult result = mR_Success;
 
-  mERROR_CHECK_GOTO(mAllocator_AllocateZero(this->pAllocator, &ret.text, this->bytes + s.bytes - 1), result, epilogue);
-  ret.capacity = this->bytes + s.bytes - 1;
-  mMemcpy(ret.text, this->text, this->bytes - 1);
-  mMemcpy(ret.text + this->bytes - 1, s.text, s.bytes);
-  ret.bytes = ret.capacity;
+  ret.pAllocator = pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE ? pAllocator : nullptr;
+
+  mERROR_CHECK_GOTO(mString_Reserve(ret, this->bytes + s.bytes - 1), result, epilogue);
+  mMemcpy(ret.Data(), this->c_str(), this->bytes - 1);
+  mMemcpy(ret.Data() + this->bytes - 1, s.c_str(), s.bytes);
+  ret.bytes = this->bytes + s.bytes - 1;
   ret.count = s.count + count - 1;
-  ret.pAllocator = pAllocator;
 
   return ret;
 
@@ -282,7 +291,7 @@ bool mString::operator!=(const mString &s) const
 
 mUtf8StringIterator mString::begin() const
 {
-  return mUtf8StringIterator(text, bytes);
+  return mUtf8StringIterator(Data(), bytes);
 }
 
 mUtf8StringIterator mString::end() const
@@ -330,23 +339,24 @@ mFUNCTION(mString_Create, OUT mString *pString, IN const char *text, IN OPTIONAL
   if (pAllocator == mSHARED_POINTER_FOREIGN_RESOURCE)
     pAllocator = &mDefaultAllocator;
 
+  mString_DestroyCharIndex_Internal(*pString);
+
   if (text == nullptr)
   {
     pString->hasFailed = false;
 
     if (pString->pAllocator != pAllocator)
     {
-      mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pString->text));
-      pString->capacity = 0;
+      mERROR_CHECK(mString_FreeText_Internal(*pString));
       pString->count = 0;
       pString->bytes = 0;
     }
 
     pString->pAllocator = pAllocator;
 
-    if (pString->text != nullptr)
+    if (pString->Data() != nullptr)
     {
-      pString->text[0] = '\0';
+      pString->Data()[0] = '\0';
       pString->count = 1;
       pString->bytes = 1;
     }
@@ -372,23 +382,24 @@ mFUNCTION(mString_Create, OUT mString *pString, IN const char *text, size_t size
   if (pAllocator == mSHARED_POINTER_FOREIGN_RESOURCE)
     pAllocator = &mDefaultAllocator;
 
+  mString_DestroyCharIndex_Internal(*pString);
+
   if (text == nullptr)
   {
     pString->hasFailed = false;
 
     if (pString->pAllocator != pAllocator)
     {
-      mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pString->text));
-      pString->capacity = 0;
+      mERROR_CHECK(mString_FreeText_Internal(*pString));
       pString->count = 0;
       pString->bytes = 0;
     }
 
     pString->pAllocator = pAllocator;
 
-    if (pString->text != nullptr)
+    if (pString->Data() != nullptr)
     {
-      pString->text[0] = '\0';
+      pString->Data()[0] = '\0';
       pString->count = 1;
       pString->bytes = 1;
     }
@@ -399,46 +410,21 @@ mFUNCTION(mString_Create, OUT mString *pString, IN const char *text, size_t size
   mERROR_CHECK(mStringLength(text, size, &size));
   size++;
 
-  if (pString->pAllocator == pAllocator)
-  {
-    if (pString->capacity < size)
-    {
-      mERROR_CHECK(mAllocator_Reallocate(pString->pAllocator, &pString->text, size));
-      pString->capacity = pString->bytes = size;
-    }
-
-    pString->text[0] = '\0';
-    pString->bytes = size;
-  }
-  else
+  if (pString->pAllocator != pAllocator)
   {
     pString->~mString();
     *pString = mString();
 
     pString->pAllocator = pAllocator;
-
-    mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pString->text, size));
-    pString->capacity = pString->bytes = size;
   }
 
-  mMemcpy(pString->text, text, pString->bytes - 1);
-  pString->text[pString->bytes - 1] = '\0';
+  mERROR_CHECK(mString_Reserve(*pString, size));
+  pString->bytes = size;
 
-  size_t offset = 0;
-  pString->count = 0;
+  mMemcpy(pString->Data(), text, pString->bytes - 1);
+  pString->Data()[pString->bytes - 1] = '\0';
 
-  while (offset < pString->bytes)
-  {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->text) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    offset += (size_t)characterSize;
-    pString->count++;
-
-    if (characterSize == 0)
-      break;
-  }
+  mERROR_IF(!mUtf8_Validate(pString->Data(), pString->bytes, &pString->count), mR_InternalError);
 
   mRETURN_SUCCESS();
 }
@@ -456,23 +442,24 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, IN OPTIONAL
   if (pAllocator == mSHARED_POINTER_FOREIGN_RESOURCE)
     pAllocator = &mDefaultAllocator;
 
+  mString_DestroyCharIndex_Internal(*pString);
+
   if (text == nullptr)
   {
     pString->hasFailed = false;
 
     if (pString->pAllocator != pAllocator)
     {
-      mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pString->text));
-      pString->capacity = 0;
+      mERROR_CHECK(mString_FreeText_Internal(*pString));
       pString->count = 0;
       pString->bytes = 0;
     }
 
     pString->pAllocator = pAllocator;
 
-    if (pString->text != nullptr)
+    if (pString->Data() != nullptr)
     {
-      pString->text[0] = '\0';
+      pString->Data()[0] = '\0';
       pString->count = 1;
       pString->bytes = 1;
     }
@@ -486,12 +473,6 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, IN OPTIONAL
   {
     *pString = mString();
     pString->pAllocator = pAllocator;
-
-    if (pString->capacity < size * mString_MaxUtf16CharInUtf8Chars)
-    {
-      mERROR_CHECK(mAllocator_Reallocate(pString->pAllocator, &pString->text, size * mString_MaxUtf16CharInUtf8Chars));
-      pString->capacity = size * mString_MaxUtf16CharInUtf8Chars;
-    }
   }
   else
   {
@@ -499,34 +480,10 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, IN OPTIONAL
     *pString = mString();
 
     pString->pAllocator = pAllocator;
-
-    mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pString->text, size * mString_MaxUtf16CharInUtf8Chars));
-    pString->capacity = size * mString_MaxUtf16CharInUtf8Chars;
   }
 
-  if (0 == (pString->bytes = WideCharToMultiByte(CP_UTF8, 0, text, (int32_t)size, pString->text, (int32_t)pString->capacity, nullptr, false)))
-  {
-    DWORD error = GetLastError();
-    mUnused(error);
-
-    mRETURN_RESULT(mR_InvalidParameter);
-  }
-
-  size_t offset = 0;
-  pString->count = 0;
-
-  while (offset < pString->bytes)
-  {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->text) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    offset += (size_t)characterSize;
-    pString->count++;
-
-    if (characterSize == 0)
-      break;
-  }
+  mERROR_CHECK(mString_Reserve(*pString, size * mUnicode_MaxWideCharInUtf8Chars));
+  mERROR_CHECK(mWide_ToUtf8(text, size, pString->Data(), pString->capacity, &pString->bytes, &pString->count));
 
   mRETURN_SUCCESS();
 }
@@ -544,23 +501,24 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, const size_
   if (pAllocator == mSHARED_POINTER_FOREIGN_RESOURCE)
     pAllocator = &mDefaultAllocator;
 
+  mString_DestroyCharIndex_Internal(*pString);
+
   if (text == nullptr)
   {
     pString->hasFailed = false;
 
     if (pString->pAllocator != pAllocator)
     {
-      mERROR_CHECK(mAllocator_FreePtr(pAllocator, &pString->text));
-      pString->capacity = 0;
+      mERROR_CHECK(mString_FreeText_Internal(*pString));
       pString->count = 0;
       pString->bytes = 0;
     }
 
     pString->pAllocator = pAllocator;
 
-    if (pString->text != nullptr)
+    if (pString->Data() != nullptr)
     {
-      pString->text[0] = '\0';
+      pString->Data()[0] = '\0';
       pString->count = 1;
       pString->bytes = 1;
     }
@@ -574,12 +532,6 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, const size_
   {
     *pString = mString();
     pString->pAllocator = pAllocator;
-
-    if (pString->capacity < size * mString_MaxUtf16CharInUtf8Chars)
-    {
-      mERROR_CHECK(mAllocator_Reallocate(pString->pAllocator, &pString->text, size * mString_MaxUtf16CharInUtf8Chars));
-      pString->capacity = size * mString_MaxUtf16CharInUtf8Chars;
-    }
   }
   else
   {
@@ -587,37 +539,14 @@ mFUNCTION(mString_Create, OUT mString *pString, const wchar_t *text, const size_
     *pString = mString();
 
     pString->pAllocator = pAllocator;
-
-    mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pString->text, size * mString_MaxUtf16CharInUtf8Chars));
-    pString->capacity = size * mString_MaxUtf16CharInUtf8Chars;
   }
 
-  if (0 == (pString->bytes = WideCharToMultiByte(CP_UTF8, 0, text, (int32_t)(size - 1), pString->text, (int32_t)pString->capacity, nullptr, false)))
-  {
-    DWORD error = GetLastError();
-    mUnused(error);
-
-    mRETURN_RESULT(mR_InvalidParameter);
-  }
+  mERROR_CHECK(mString_Reserve(*pString, size * mUnicode_MaxWideCharInUtf8Chars));
+  mERROR_CHECK(mWide_ToUtf8(text, size - 1, pString->Data(), pString->capacity, &pString->bytes, &pString->count));
 
-  pString->text[pString->bytes] = '\0';
+  pString->Data()[pString->bytes] = '\0';
   pString->bytes++;
-
-  size_t offset = 0;
-  pString->count = 0;
-
-  while (offset < pString->bytes)
-  {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->text) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    offset += (size_t)characterSize;
-    pString->count++;
-
-    if (characterSize == 0)
-      break;
-  }
+  pString->count++;
 
   mRETURN_SUCCESS();
 }
@@ -635,13 +564,15 @@ mFUNCTION(mString_Create, OUT mString *pString, const mString &from, IN OPTIONAL
   if (pAllocator == mSHARED_POINTER_FOREIGN_RESOURCE)
     pAllocator = &mDefaultAllocator;
 
+  mString_DestroyCharIndex_Internal(*pString);
+
   if (from.bytes <= 1)
   {
     if (pString->bytes > 1)
     {
       pString->bytes = 1;
       pString->count = 1;
-      pString->text[0] = '\0';
+      pString->Data()[0] = '\0';
     }
 
     mRETURN_SUCCESS();
@@ -651,16 +582,6 @@ mFUNCTION(mString_Create, OUT mString *pString, const mString &from, IN OPTIONAL
   {
     *pString = mString();
     pString->pAllocator = pAllocator;
-
-    if (pString->capacity < from.bytes)
-    {
-      mERROR_CHECK(mAllocator_Reallocate(pString->pAllocator, &pString->text, from.bytes));
-      pString->capacity = pString->bytes = from.bytes;
-    }
-    else
-    {
-      pString->bytes = from.bytes;
-    }
   }
   else
   {
@@ -668,12 +589,12 @@ mFUNCTION(mString_Create, OUT mString *pString, const mString &from, IN OPTIONAL
     *pString = mString();
 
     pString->pAllocator = pAllocator;
-
-    mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &pString->text, from.bytes));
-    pString->capacity = pString->bytes = from.bytes;
   }
 
-  mMemcpy(pString->text, from.text, pString->bytes);
+  mERROR_CHECK(mString_Reserve(*pString, from.bytes));
+  pString->bytes = from.bytes;
+
+  mMemcpy(pString->Data(), from.c_str(), pString->bytes);
 
   pString->count = from.count;
 
@@ -686,10 +607,8 @@ mFUNCTION(mString_Destroy, IN_OUT mString *pString)
 
   mERROR_IF(pString == nullptr, mR_ArgumentNull);
 
-  if (pString->text != nullptr)
-    mERROR_CHECK(mAllocator_FreePtr(pString->pAllocator, &pString->text));
+  mERROR_CHECK(mString_FreeText_Internal(*pString));
 
-  pString->capacity = 0;
   pString->bytes = 0;
   pString->count = 0;
   pString->hasFailed = false;
@@ -702,11 +621,73 @@ mFUNCTION(mString_Reserve, mString &string, const size_t size)
 {
   mFUNCTION_SETUP();
 
-  if (string.capacity < size)
+  mString_DestroyCharIndex_Internal(string);
+
+  if (string.capacity >= size)
+    mRETURN_SUCCESS();
+
+  if (string.pText != nullptr)
   {
-    mERROR_CHECK(mAllocator_Reallocate(string.pAllocator, &string.text, size));
+    mERROR_CHECK(mAllocator_Reallocate(string.pAllocator, &string.pText, size));
     string.capacity = size;
   }
+  else if (size <= mString_InlineCapacity)
+  {
+    if (string.capacity == 0)
+      mZeroMemory(string.inlineText, mARRAYSIZE(string.inlineText));
+
+    string.capacity = mString_InlineCapacity;
+  }
+  else
+  {
+    char *pText = nullptr;
+    mERROR_CHECK(mAllocator_AllocateZero(string.pAllocator, &pText, size));
+
+    if (string.capacity > 0)
+      mMemcpy(pText, string.inlineText, mMin(string.bytes, string.capacity));
+
+    string.pText = pText;
+    string.pCharIndex = nullptr;
+    string.capacity = size;
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mString_CreateCharIndex, mString &string)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(string.hasFailed, mR_ResourceInvalid);
+
+  mString_DestroyCharIndex_Internal(string);
+
+  // Inline strings are short enough to iterate, ascii strings are indexed by their byte offset.
+  if (string.pText == nullptr || string.IsAscii() || string.count <= mString_CharIndex_Stride)
+    mRETURN_SUCCESS();
+
+  mAllocator *pAllocator = string.pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE ? string.pAllocator : nullptr;
+  const size_t offsetCount = (string.count - 1) / mString_CharIndex_Stride + 1;
+
+  size_t *pOffsets = nullptr;
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, &pOffsets));
+  mERROR_CHECK(mAllocator_Allocate(pAllocator, &pOffsets, offsetCount));
+
+  size_t offset = 0;
+
+  for (size_t i = 0; i < string.count; i++)
+  {
+    if (i % mString_CharIndex_Stride == 0)
+      pOffsets[i / mString_CharIndex_Stride] = offset;
+
+    utf8proc_int32_t codePoint;
+    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.pText) + offset, string.bytes - offset, &codePoint);
+    mERROR_IF(characterSize <= 0 || codePoint < 0, mR_ResourceInvalid);
+
+    offset += (size_t)characterSize;
+  }
+
+  string.pCharIndex = pOffsets;
 
   mRETURN_SUCCESS();
 }
@@ -747,7 +728,7 @@ mFUNCTION(mString_ToWideString, const mString &string, OUT wchar_t *pWideString,
   mERROR_IF(pWideString == nullptr || pWideStringCount == nullptr, mR_ArgumentNull);
   mERROR_IF(string.hasFailed, mR_ResourceInvalid);
 
-  if (string.text == nullptr)
+  if (string.Data() == nullptr)
   {
     mERROR_IF(bufferCount == 0, mR_ArgumentOutOfBounds);
     
@@ -756,28 +737,7 @@ mFUNCTION(mString_ToWideString, const mString &string, OUT wchar_t *pWideString,
   }
   else
   {
-    int32_t length = 0;
-
-    if (0 >= (length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, string.text, (int32_t)string.bytes, pWideString, (int32_t)bufferCount)))
-    {
-      const DWORD error = GetLastError();
-
-      switch (error)
-      {
-      case ERROR_INSUFFICIENT_BUFFER:
-        mRETURN_RESULT(mR_IndexOutOfBounds);
-
-      case ERROR_NO_UNICODE_TRANSLATION:
-        mRETURN_RESULT(mR_InvalidParameter);
-
-      case ERROR_INVALID_FLAGS:
-      case ERROR_INVALID_PARAMETER:
-      default:
-        mRETURN_RESULT(mR_InternalError);
-      }
-    }
-
-    *pWideStringCount = length;
+    mERROR_CHECK(mUtf8_ToWide(string.Data(), string.bytes, pWideString, bufferCount, pWideStringCount));
   }
 
   mRETURN_SUCCESS();
@@ -801,28 +761,9 @@ mFUNCTION(mString_ToWideStringRaw, const char *string, OUT wchar_t *pWideString,
   else
   {
     const size_t stringLength = (strlen(string) + 1);
-    mERROR_IF(stringLength > INT32_MAX, mR_ArgumentOutOfBounds);
-
-    int32_t length = 0;
 
-    if (0 >= (length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, string, (int32_t)stringLength, pWideString, (int32_t)bufferCount)))
-    {
-      const DWORD error = GetLastError();
-
-      switch (error)
-      {
-      case ERROR_INSUFFICIENT_BUFFER:
-        mRETURN_RESULT(mR_IndexOutOfBounds);
-
-      case ERROR_NO_UNICODE_TRANSLATION:
-        mRETURN_RESULT(mR_InvalidParameter);
-
-      case ERROR_INVALID_FLAGS:
-      case ERROR_INVALID_PARAMETER:
-      default:
-        mRETURN_RESULT(mR_InternalError);
-      }
-    }
+    size_t length = 0;
+    mERROR_CHECK(mUtf8_ToWide(string, stringLength, pWideString, bufferCount, &length));
 
     if (pWideStringCount != nullptr)
       *pWideStringCount = length;
@@ -838,34 +779,13 @@ mFUNCTION(mString_GetRequiredWideStringCount, const mString &string, OUT size_t
   mERROR_IF(pWideStringCount == nullptr, mR_ArgumentNull);
   mERROR_IF(string.hasFailed, mR_ResourceInvalid);
 
-  if (string.text == nullptr)
+  if (string.Data() == nullptr)
   {
     *pWideStringCount = 1;
   }
   else
   {
-    int32_t length = 0;
-
-    if (0 >= (length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, string.text, (int32_t)string.bytes, nullptr, 0)))
-    {
-      const DWORD error = GetLastError();
-
-      switch (error)
-      {
-      case ERROR_INSUFFICIENT_BUFFER:
-        mRETURN_RESULT(mR_IndexOutOfBounds);
-
-      case ERROR_NO_UNICODE_TRANSLATION:
-        mRETURN_RESULT(mR_InvalidParameter);
-
-      case ERROR_INVALID_FLAGS:
-      case ERROR_INVALID_PARAMETER:
-      default:
-        mRETURN_RESULT(mR_InternalError);
-      }
-    }
-
-    *pWideStringCount = length;
+    mERROR_CHECK(mUtf8_GetWideCount(string.Data(), string.bytes, pWideStringCount));
   }
 
   mRETURN_SUCCESS();
@@ -889,47 +809,18 @@ mFUNCTION(mString_Substring, const mString &text, OUT mString *pSubstring, const
 
   mERROR_IF(pSubstring == nullptr, mR_ArgumentNull);
   mERROR_IF(startCharacter >= text.count || startCharacter + length >= text.count, mR_IndexOutOfBounds);
-  
-  size_t byteOffset = 0;
-  size_t character = 0;
 
-  while (character < startCharacter)
+  if (length == 0)
   {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(text.text) + byteOffset, text.bytes - byteOffset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    byteOffset += (size_t)characterSize;
-    character++;
+    *pSubstring = mString();
+    mRETURN_SUCCESS();
   }
 
-  *pSubstring = mString();
-  char utf8char[4];
+  const size_t startOffset = mString_GetByteOffset_Internal(text, startCharacter);
+  const size_t endOffset = mString_GetByteOffset_Internal(text, startCharacter + length, startCharacter, startOffset);
+  mERROR_IF(startOffset >= text.bytes || endOffset >= text.bytes, mR_InternalError);
 
-  while (character - startCharacter < length)
-  {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(text.text) + byteOffset, text.bytes - byteOffset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    character++;
-
-    switch (characterSize)
-    {
-    case 4:
-      utf8char[3] = *((char *)text.text + byteOffset + 3);
-    case 3:
-      utf8char[2] = *((char *)text.text + byteOffset + 2);
-    case 2:
-      utf8char[1] = *((char *)text.text + byteOffset + 1);
-    case 1:
-      utf8char[0] = *((char *)text.text + byteOffset + 0);
-      break;
-    }
-
-    byteOffset += (size_t)characterSize;
-    mERROR_CHECK(mString_Append(*pSubstring, utf8char, characterSize));
-  }
+  mERROR_CHECK(mString_Create(pSubstring, text.c_str() + startOffset, endOffset - startOffset, pSubstring->pAllocator));
 
   mRETURN_SUCCESS();
 }
@@ -938,6 +829,8 @@ mFUNCTION(mString_Append, mString &text, const mString &appendedText)
 {
   mFUNCTION_SETUP();
 
+  mString_DestroyCharIndex_Internal(text);
+
   if (text.bytes > 0 && appendedText.bytes > 0)
   {
     if (text.capacity < text.bytes + appendedText.bytes - 1)
@@ -949,11 +842,10 @@ mFUNCTION(mString_Append, mString &text, const mString &appendedText)
       else
         newCapacity = text.bytes + appendedText.bytes - 1;
 
-      mERROR_CHECK(mAllocator_Reallocate(text.pAllocator, &text.text, newCapacity));
-      text.capacity = newCapacity;
+      mERROR_CHECK(mString_Reserve(text, newCapacity));
     }
 
-    mMemcpy(text.text + text.bytes - 1, appendedText.text, appendedText.bytes);
+    mMemcpy(text.Data() + text.bytes - 1, appendedText.Data(), appendedText.bytes);
 
     text.count += appendedText.count - 1;
     text.bytes += appendedText.bytes - 1;
@@ -968,16 +860,8 @@ mFUNCTION(mString_Append, mString &text, const mString &appendedText)
     {
       text.hasFailed = false;
 
-      if (text.capacity < appendedText.bytes)
-      {
-        mERROR_CHECK(mAllocator_Reallocate(text.pAllocator, &text.text, appendedText.bytes));
-        text.capacity = appendedText.bytes;
-        mMemcpy(text.text, appendedText.text, appendedText.bytes);
-      }
-      else if (appendedText.bytes > 0)
-      {
-        mMemcpy(text.text, appendedText.text, appendedText.bytes);
-      }
+      mERROR_CHECK(mString_Reserve(text, appendedText.bytes));
+      mMemcpy(text.Data(), appendedText.c_str(), appendedText.bytes);
 
       text.bytes = appendedText.bytes;
       text.count = appendedText.count;
@@ -1011,6 +895,8 @@ mFUNCTION(mString_Append, mString &text, const char *appendedText, const size_t
 
   const bool appendedTextNotTerminated = *(appendedText + bytes - 1) != '\0';
 
+  mString_DestroyCharIndex_Internal(text);
+
   if (text.bytes > 0 && bytes > 0)
   {
     if (text.capacity < text.bytes + bytes - 1 + appendedTextNotTerminated)
@@ -1022,11 +908,10 @@ mFUNCTION(mString_Append, mString &text, const char *appendedText, const size_t
       else
         newCapacity = text.bytes + bytes - 1 + appendedTextNotTerminated;
 
-      mERROR_CHECK(mAllocator_Reallocate(text.pAllocator, &text.text, newCapacity));
-      text.capacity = newCapacity;
+      mERROR_CHECK(mString_Reserve(text, newCapacity));
     }
 
-    mMemcpy(text.text + text.bytes - 1, appendedText, bytes);
+    mMemcpy(text.Data() + text.bytes - 1, appendedText, bytes);
 
     if (!appendedTextNotTerminated)
     {
@@ -1035,7 +920,7 @@ mFUNCTION(mString_Append, mString &text, const char *appendedText, const size_t
     }
     else
     {
-      text.text[text.bytes - 1 + bytes] = '\0';
+      text.Data()[text.bytes - 1 + bytes] = '\0';
 
       text.count += count;
       text.bytes += bytes;
@@ -1051,17 +936,8 @@ mFUNCTION(mString_Append, mString &text, const char *appendedText, const size_t
     {
       text.hasFailed = false;
 
-      if (text.capacity < bytes + appendedTextNotTerminated)
-      {
-        mERROR_CHECK(mAllocator_Reallocate(text.pAllocator, &text.text, bytes + appendedTextNotTerminated));
-        text.capacity = bytes + appendedTextNotTerminated;
-        
-        mMemcpy(text.text, appendedText, bytes);
-      }
-      else if (bytes > 0)
-      {
-        mMemcpy(text.text, appendedText, bytes);
-      }
+      mERROR_CHECK(mString_Reserve(text, bytes + appendedTextNotTerminated));
+      mMemcpy(text.Data(), appendedText, bytes);
 
       if (!appendedTextNotTerminated)
       {
@@ -1070,7 +946,7 @@ mFUNCTION(mString_Append, mString &text, const char *appendedText, const size_t
       }
       else
       {
-        text.text[bytes] = '\0';
+        text.Data()[bytes] = '\0';
 
         text.bytes = bytes + 1;
         text.count = count + 1;
@@ -1134,7 +1010,7 @@ mFUNCTION(mString_ToDirectoryPath, OUT mString *pString, const mString &text)
 
   mERROR_IF(pString == nullptr, mR_ArgumentNull);
 
-  if (text.text == nullptr || text.bytes <= 1 || text.count <= 1)
+  if (text.Data() == nullptr || text.bytes <= 1 || text.count <= 1)
   {
     *pString = "";
     mRETURN_SUCCESS();
@@ -1142,7 +1018,7 @@ mFUNCTION(mString_ToDirectoryPath, OUT mString *pString, const mString &text)
 
   if (pString->pAllocator != text.pAllocator && pString->capacity > 0)
   {
-    mERROR_CHECK(mAllocator_FreePtr(pString->pAllocator, &pString->text));
+    mERROR_CHECK(mString_FreeText_Internal(*pString));
     pString->bytes = 0;
     pString->capacity = 0;
     pString->count = 0;
@@ -1161,29 +1037,29 @@ mFUNCTION(mString_ToDirectoryPath, OUT mString *pString, const mString &text)
   {
     utf8proc_int32_t codePoint;
     ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->text) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
+    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->Data()) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
     mERROR_IF(codePoint < 0, mR_InternalError);
 
     if (characterSize == 1)
     {
-      if (lastWasSlash && (pString->text[offset] == '/' || pString->text[offset] == '\\') && i != 1)
+      if (lastWasSlash && (pString->Data()[offset] == '/' || pString->Data()[offset] == '\\') && i != 1)
       {
         pString->bytes -= characterSize;
-        mERROR_CHECK(mMemmove(&pString->text[offset], &pString->text[offset + characterSize], pString->bytes - offset));
+        mERROR_CHECK(mMemmove(&pString->Data()[offset], &pString->Data()[offset + characterSize], pString->bytes - offset));
         --pString->count;
         --i;
         continue;
       }
-      else if (pString->text[offset] == '/')
+      else if (pString->Data()[offset] == '/')
       {
-        pString->text[offset] = '\\';
+        pString->Data()[offset] = '\\';
         lastWasSlash = true;
       }
-      else if (pString->text[offset] == '\\')
+      else if (pString->Data()[offset] == '\\')
       {
         lastWasSlash = true;
       }
-      else if (pString->text[offset] == '\0')
+      else if (pString->Data()[offset] == '\0')
       {
         ; // don't change `lastWasSlash`.
       }
@@ -1205,8 +1081,8 @@ mFUNCTION(mString_ToDirectoryPath, OUT mString *pString, const mString &text)
 
   if (!lastWasSlash)
   {
-    pString->text[offset - 1] = '\\';
-    pString->text[offset] = '\0';
+    pString->Data()[offset - 1] = '\\';
+    pString->Data()[offset] = '\0';
     ++pString->bytes;
     ++pString->count;
   }
@@ -1220,7 +1096,7 @@ mFUNCTION(mString_ToFilePath, OUT mString *pString, const mString &text)
 
   mERROR_IF(pString == nullptr, mR_ArgumentNull);
 
-  if (text.text == nullptr || text.bytes <= 1 || text.count <= 1)
+  if (text.Data() == nullptr || text.bytes <= 1 || text.count <= 1)
   {
     *pString = "";
     mRETURN_SUCCESS();
@@ -1236,24 +1112,24 @@ mFUNCTION(mString_ToFilePath, OUT mString *pString, const mString &text)
   {
     utf8proc_int32_t codePoint;
     ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->text) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
+    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(pString->Data()) + offset, pString->bytes - offset, &codePoint)) < 0, mR_InternalError);
     mERROR_IF(codePoint < 0, mR_InternalError);
 
     if (characterSize == 1)
     {
-      if (lastWasSlash && (pString->text[offset] == '/' || pString->text[offset] == '\\') && i != 1)
+      if (lastWasSlash && (pString->Data()[offset] == '/' || pString->Data()[offset] == '\\') && i != 1)
       {
         pString->bytes -= characterSize;
-        mERROR_CHECK(mMemmove(&pString->text[offset], &pString->text[offset + characterSize], pString->bytes - offset));
+        mERROR_CHECK(mMemmove(&pString->Data()[offset], &pString->Data()[offset + characterSize], pString->bytes - offset));
         --pString->count;
         continue;
       }
-      else if (pString->text[offset] == '/')
+      else if (pString->Data()[offset] == '/')
       {
-        pString->text[offset] = '\\';
+        pString->Data()[offset] = '\\';
         lastWasSlash = true;
       }
-      else if (pString->text[offset] == '\\')
+      else if (pString->Data()[offset] == '\\')
       {
         lastWasSlash = true;
       }
@@ -1299,10 +1175,10 @@ mFUNCTION(mString_Equals, const mString &stringA, const mString &stringB, bool *
   for (size_t i = 0; i < stringA.count; ++i)
   {
     utf8proc_int32_t codePointA;
-    ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.text) + offset, stringA.bytes - offset, &codePointA);
+    ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.Data()) + offset, stringA.bytes - offset, &codePointA);
 
     utf8proc_int32_t codePointB;
-    utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringB.text) + offset, stringA.bytes - offset, &codePointB);
+    utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringB.Data()) + offset, stringA.bytes - offset, &codePointB);
 
     if (codePointA != codePointB)
     {
@@ -1334,13 +1210,23 @@ mFUNCTION(mString_ForEachChar, const mString &string, const std::function<mResul
   {
     utf8proc_int32_t codePoint;
     ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + offset, string.bytes - offset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
 
-    if (characterSize == 0)
-      break;
+    // Ascii characters don't need to be decoded.
+    if ((uint8_t)string.Data()[offset] < 0x80)
+    {
+      codePoint = (utf8proc_int32_t)string.Data()[offset];
+      characterSize = 1;
+    }
+    else
+    {
+      mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.Data()) + offset, string.bytes - offset, &codePoint)) < 0, mR_InternalError);
+      mERROR_IF(codePoint < 0, mR_InternalError);
 
-    const mResult result = function((mchar_t)codePoint, string.text + offset, (size_t)characterSize);
+      if (characterSize == 0)
+        break;
+    }
+
+    const mResult result = function((mchar_t)codePoint, string.Data() + offset, (size_t)characterSize);
     
     if (mFAILED(result))
     {
@@ -1379,10 +1265,10 @@ mFUNCTION(mString_StartsWith, const mString &stringA, const mString &start, OUT
   for (size_t i = 0; i < start.count - 1; ++i) // Exclude null char.
   {
     utf8proc_int32_t codePointA;
-    ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.text) + offset, stringA.bytes - offset, &codePointA);
+    ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.Data()) + offset, stringA.bytes - offset, &codePointA);
 
     utf8proc_int32_t codePointB;
-    utf8proc_iterate(reinterpret_cast<const uint8_t *>(start.text) + offset, stringA.bytes - offset, &codePointB);
+    utf8proc_iterate(reinterpret_cast<const uint8_t *>(start.Data()) + offset, stringA.bytes - offset, &codePointB);
 
     mERROR_IF(codePointA != codePointB, mR_Success); // pStartsWith is already false.
 
@@ -1420,7 +1306,7 @@ mFUNCTION(mString_EndsWith, const mString &stringA, const mString &end, OUT bool
   for (size_t i = 0; i < stringA.count - end.count; ++i) // Exclude null char.
   {
     utf8proc_int32_t codePoint;
-    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.text) + stringOffset, stringA.bytes - stringOffset, &codePoint);
+    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.Data()) + stringOffset, stringA.bytes - stringOffset, &codePoint);
     stringOffset += characterSize;
 
     if (characterSize == 0)
@@ -1432,10 +1318,10 @@ mFUNCTION(mString_EndsWith, const mString &stringA, const mString &end, OUT bool
   for (size_t i = 0; i < end.count - 1; ++i) // Exclude null char.
   {
     utf8proc_int32_t codePointA;
-    const ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.text) + stringOffset, stringA.bytes - stringOffset, &codePointA);
+    const ptrdiff_t characterSizeA = utf8proc_iterate(reinterpret_cast<const uint8_t *>(stringA.Data()) + stringOffset, stringA.bytes - stringOffset, &codePointA);
 
     utf8proc_int32_t codePointB;
-    utf8proc_iterate(reinterpret_cast<const uint8_t *>(end.text) + endOffset, stringA.bytes - endOffset, &codePointB);
+    utf8proc_iterate(reinterpret_cast<const uint8_t *>(end.Data()) + endOffset, stringA.bytes - endOffset, &codePointB);
 
     mERROR_IF(codePointA != codePointB, mR_Success); // pEndsWith is already false.
 
@@ -1462,7 +1348,7 @@ void mString_GetKmp(const mString &string, IN_OUT mchar_t *pString, IN_OUT size_
   for (size_t i = 0; i < length; i++)
   {
     utf8proc_int32_t codePoint;
-    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + offset, string.bytes - offset, &codePoint);
+    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.Data()) + offset, string.bytes - offset, &codePoint);
     offset += characterSize;
 
     pString[i] = codePoint;
@@ -1483,38 +1369,166 @@ void mString_GetKmp(const mString &string, IN_OUT mchar_t *pString, IN_OUT size_
   }
 }
 
- void mString_FindNextWithKMP(const mString &string, const size_t offsetChar, const size_t offsetBytes, IN const mchar_t *pFind, const size_t findCountWithoutNull, IN const size_t *pKmp, OUT size_t *pStartChar, OUT size_t *pOffset, OUT bool *pContained)
+static mINLINE uint32_t mString_CountTrailingZeros_Internal(const uint32_t mask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return (uint32_t)index;
+#else
+  return (uint32_t)__builtin_ctz(mask);
+#endif
+}
+
+struct mString_CpuSupport
+{
+  bool avx2;
+  bool sse41;
+};
+
+// The supported instruction sets can't change while running, so they're only detected for the first search.
+static const mString_CpuSupport & mString_GetCpuSupport_Internal()
+{
+  static const mString_CpuSupport cpuSupport = []()
+  {
+    mCpuExtensions::Detect();
+
+    mString_CpuSupport support;
+    support.avx2 = mCpuExtensions::avx2Supported;
+    support.sse41 = mCpuExtensions::sse41Supported;
+
+    return support;
+  }();
+
+  return cpuSupport;
+}
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4752)
+#endif
+
+// Compares the first and last byte of `pFind` against every position and only verifies the positions where both match.
+#ifndef _MSC_VER
+__attribute__((target("sse4.1")))
+#endif
+static size_t mString_FindBytes_SSE41(IN const char *pText, const size_t textBytes, IN const char *pFind, const size_t findBytes, IN_OUT size_t &offset)
+{
+  const __m128i first = _mm_set1_epi8(pFind[0]);
+  const __m128i last = _mm_set1_epi8(pFind[findBytes - 1]);
+
+  for (; offset + findBytes - 1 + sizeof(__m128i) <= textBytes; offset += sizeof(__m128i))
+  {
+    const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + offset));
+    const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + offset + findBytes - 1));
+
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast)));
+
+    while (mask != 0)
+    {
+      const size_t position = offset + mString_CountTrailingZeros_Internal(mask);
+
+      if (memcmp(pText + position + 1, pFind + 1, findBytes - 2) == 0)
+        return position;
+
+      mask &= mask - 1;
+    }
+  }
+
+  return textBytes;
+}
+
+#ifndef _MSC_VER
+__attribute__((target("avx2")))
+#endif
+static size_t mString_FindBytes_AVX2(IN const char *pText, const size_t textBytes, IN const char *pFind, const size_t findBytes, IN_OUT size_t &offset)
 {
-   *pContained = false;
+  const __m256i first = _mm256_set1_epi8(pFind[0]);
+  const __m256i last = _mm256_set1_epi8(pFind[findBytes - 1]);
 
-   const size_t chars = string.count - offsetChar - 1;
+  for (; offset + findBytes - 1 + sizeof(__m256i) <= textBytes; offset += sizeof(__m256i))
+  {
+    const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pText + offset));
+    const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pText + offset + findBytes - 1));
 
-   if (findCountWithoutNull == 0 || findCountWithoutNull > chars)
-     return;
-   
-   size_t offset = offsetBytes;
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast)));
 
-   for (size_t i = 0, k = 0; i < chars; i++)
-   {
-     utf8proc_int32_t codePoint;
-     const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + offset, string.bytes - offset, &codePoint);
-     offset += characterSize;
+    while (mask != 0)
+    {
+      const size_t position = offset + mString_CountTrailingZeros_Internal(mask);
+
+      if (memcmp(pText + position + 1, pFind + 1, findBytes - 2) == 0)
+        return position;
+
+      mask &= mask - 1;
+    }
+  }
 
-     while (k > 0 && pFind[k] != codePoint)
-       k = pKmp[k - 1];
-     
-     if (pFind[k] == codePoint)
-       ++k;
-     
-     if (k == findCountWithoutNull)
-     {
-       *pStartChar = offsetChar + i - k + 1;
-       *pOffset = offset;
-       *pContained = true;
+  return textBytes;
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+// Returns the byte offset of the first occurrence of `pFind` in `pText` or `textBytes` if there is none.
+// As both are valid utf-8, byte matches always start and end at character boundaries.
+static size_t mString_FindBytes_Internal(IN const char *pText, const size_t textBytes, IN const char *pFind, const size_t findBytes)
+{
+  if (findBytes == 0 || findBytes > textBytes)
+    return textBytes;
+
+  if (findBytes == 1)
+  {
+    const char *pMatch = reinterpret_cast<const char *>(memchr(pText, pFind[0], textBytes));
+    return pMatch == nullptr ? textBytes : (size_t)(pMatch - pText);
+  }
+
+  size_t offset = 0;
+
+  const mString_CpuSupport &cpuSupport = mString_GetCpuSupport_Internal();
+
+  if (cpuSupport.avx2)
+  {
+    const size_t position = mString_FindBytes_AVX2(pText, textBytes, pFind, findBytes, offset);
+
+    if (position != textBytes)
+      return position;
+  }
+  else if (cpuSupport.sse41)
+  {
+    const size_t position = mString_FindBytes_SSE41(pText, textBytes, pFind, findBytes, offset);
+
+    if (position != textBytes)
+      return position;
+  }
+
+  const size_t lastPosition = textBytes - findBytes;
+
+  while (offset <= lastPosition)
+  {
+    const char *pCandidate = reinterpret_cast<const char *>(memchr(pText + offset, pFind[0], lastPosition - offset + 1));
+
+    if (pCandidate == nullptr)
+      break;
+
+    if (memcmp(pCandidate + 1, pFind + 1, findBytes - 1) == 0)
+      return (size_t)(pCandidate - pText);
+
+    offset = (size_t)(pCandidate - pText) + 1;
+  }
 
-       return;
-     }
-   }
+  return textBytes;
+}
+
+static size_t mString_CountChars_Internal(IN const char *pText, const size_t bytes)
+{
+  size_t count = 0;
+
+  for (size_t i = 0; i < bytes; i++)
+    count += (((uint8_t)pText[i] & 0xC0) != 0x80);
+
+  return count;
 }
 
 mFUNCTION(mString_FindFirst, const mString &string, const mString &find, OUT size_t *pStartChar, OUT bool *pContained)
@@ -1535,20 +1549,13 @@ mFUNCTION(mString_FindFirst, const mString &string, const mString &find, OUT siz
     mRETURN_SUCCESS();
   }
 
-  // TODO: Add a brute force variant for small strings.
+  const size_t offset = mString_FindBytes_Internal(string.Data(), string.bytes - 1, find.Data(), find.bytes - 1);
 
-  size_t *pKmp = nullptr;
-  mchar_t *pChars = nullptr;
-
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pKmp);
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pChars);
-  mERROR_CHECK(mAllocator_AllocateZero(&mDefaultTempAllocator, &pKmp, find.count - 1));
-  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pChars, find.count - 1));
-
-  mString_GetKmp(find, pChars, pKmp);
-
-  size_t _unusedOffset;
-  mString_FindNextWithKMP(string, 0, 0, pChars, find.count - 1, pKmp, pStartChar, &_unusedOffset, pContained);
+  if (offset != string.bytes - 1)
+  {
+    *pStartChar = string.IsAscii() ? offset : mString_CountChars_Internal(string.Data(), offset);
+    *pContained = true;
+  }
 
   mRETURN_SUCCESS();
 }
@@ -1569,20 +1576,47 @@ mFUNCTION(mString_Contains, const mString &string, const mString &contained, OUT
     mRETURN_SUCCESS();
   }
 
-  // TODO: Add a brute force variant for small strings.
+  *pContains = mString_FindBytes_Internal(string.Data(), string.bytes - 1, contained.Data(), contained.bytes - 1) != string.bytes - 1;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mString_FindAll, const mString &string, const mString &find, OUT mPtr<mQueue<size_t>> *pStartChars, IN mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pStartChars == nullptr, mR_ArgumentNull);
+  mERROR_IF(string.hasFailed || find.hasFailed, mR_InvalidParameter);
+
+  if (*pStartChars == nullptr)
+    mERROR_CHECK(mQueue_Create(pStartChars, pAllocator));
+  else
+    mERROR_CHECK(mQueue_Clear(*pStartChars));
+
+  if (string.count <= 1 || find.count <= 1)
+    mRETURN_SUCCESS();
+
+  const char *pText = string.Data();
+  const size_t textBytes = string.bytes - 1;
+  const size_t findBytes = find.bytes - 1;
+  const bool isAscii = string.IsAscii();
 
-  size_t *pKmp = nullptr;
-  mchar_t *pChars = nullptr;
+  size_t byteOffset = 0;
+  size_t charOffset = 0;
 
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pKmp);
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pChars);
-  mERROR_CHECK(mAllocator_AllocateZero(&mDefaultTempAllocator, &pKmp, contained.count - 1));
-  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pChars, contained.count - 1));
+  while (true)
+  {
+    const size_t match = byteOffset + mString_FindBytes_Internal(pText + byteOffset, textBytes - byteOffset, find.Data(), findBytes);
 
-  mString_GetKmp(contained, pChars, pKmp);
+    if (match == textBytes)
+      break;
+
+    charOffset += isAscii ? match - byteOffset : mString_CountChars_Internal(pText + byteOffset, match - byteOffset);
+    mERROR_CHECK(mQueue_PushBack(*pStartChars, charOffset));
 
-  size_t _unusedStartChar, _unusedOffset;
-  mString_FindNextWithKMP(string, 0, 0, pChars, contained.count - 1, pKmp, &_unusedStartChar, &_unusedOffset, pContains);
+    byteOffset = match + findBytes;
+    charOffset += find.count - 1;
+  }
 
   mRETURN_SUCCESS();
 }
@@ -1600,7 +1634,7 @@ mFUNCTION(mString_TrimStart, const mString &string, const mchar_t trimmedChar, O
   for (; charOffset < string.count - 1; charOffset++)
   {
     utf8proc_int32_t codePoint;
-    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + byteOffset, string.bytes - byteOffset, &codePoint);
+    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.Data()) + byteOffset, string.bytes - byteOffset, &codePoint);
     
     if (codePoint != trimmedChar || characterSize == 0)
       break;
@@ -1610,13 +1644,13 @@ mFUNCTION(mString_TrimStart, const mString &string, const mchar_t trimmedChar, O
 
   mERROR_CHECK(mString_Create(pTrimmedString, "", pTrimmedString->pAllocator));
   mERROR_CHECK(mString_Reserve(*pTrimmedString, string.bytes - byteOffset));
-  pTrimmedString->text[0] = '\0';
+  pTrimmedString->Data()[0] = '\0';
 
   if (charOffset < string.count - 1)
   {
     pTrimmedString->bytes = string.bytes - byteOffset;
     pTrimmedString->count = string.count - charOffset;
-    mERROR_CHECK(mMemcpy(pTrimmedString->text, string.text + byteOffset, string.bytes - byteOffset));
+    mERROR_CHECK(mMemcpy(pTrimmedString->Data(), string.Data() + byteOffset, string.bytes - byteOffset));
   }
 
   mRETURN_SUCCESS();
@@ -1637,7 +1671,7 @@ mFUNCTION(mString_TrimEnd, const mString &string, const mchar_t trimmedChar, OUT
   for (size_t charOffset = 0; charOffset < string.count - 1; charOffset++)
   {
     utf8proc_int32_t codePoint;
-    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + byteOffset, string.bytes - byteOffset, &codePoint);
+    const ptrdiff_t characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.Data()) + byteOffset, string.bytes - byteOffset, &codePoint);
     byteOffset += characterSize;
 
     if (codePoint != trimmedChar)
@@ -1652,14 +1686,14 @@ mFUNCTION(mString_TrimEnd, const mString &string, const mchar_t trimmedChar, OUT
 
   mERROR_CHECK(mString_Create(pTrimmedString, "", pTrimmedString->pAllocator));
   mERROR_CHECK(mString_Reserve(*pTrimmedString, firstMatchingByte + 1));
-  pTrimmedString->text[0] = '\0';
+  pTrimmedString->Data()[0] = '\0';
 
   if (firstMatchingByte > 0)
   {
     pTrimmedString->bytes = firstMatchingByte + 1;
     pTrimmedString->count = firstMatchingChar + 1;
-    mERROR_CHECK(mMemcpy(pTrimmedString->text, string.text, firstMatchingByte));
-    pTrimmedString->text[firstMatchingByte] = '\0';
+    mERROR_CHECK(mMemcpy(pTrimmedString->Data(), string.Data(), firstMatchingByte));
+    pTrimmedString->Data()[firstMatchingByte] = '\0';
   }
 
   mRETURN_SUCCESS();
@@ -1674,7 +1708,7 @@ mFUNCTION(mString_RemoveChar, const mString &string, const mchar_t remove, OUT m
 
   mERROR_CHECK(mString_Create(pResult, "", pResult->pAllocator));
   mERROR_CHECK(mString_Reserve(*pResult, string.bytes));
-  pResult->text[0] = '\0';
+  pResult->Data()[0] = '\0';
 
   bool lastWasMatch = false;
   size_t firstNoMatchByte = 0;
@@ -1687,7 +1721,7 @@ mFUNCTION(mString_RemoveChar, const mString &string, const mchar_t remove, OUT m
   for (size_t charOffset = 0; charOffset < string.count - 1; charOffset++)
   {
     utf8proc_int32_t codePoint;
-    characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.text) + sourceOffset, string.bytes - sourceOffset, &codePoint);
+    characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(string.Data()) + sourceOffset, string.bytes - sourceOffset, &codePoint);
     sourceOffset += characterSize;
 
     if (characterSize == 0)
@@ -1699,7 +1733,7 @@ mFUNCTION(mString_RemoveChar, const mString &string, const mchar_t remove, OUT m
 
       if (!lastWasMatch && size > 0)
       {
-        mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + firstNoMatchByte, size));
+        mERROR_CHECK(mMemcpy(pResult->Data() + destinationOffset, string.Data() + firstNoMatchByte, size));
         destinationOffset += size;
       }
       
@@ -1717,174 +1751,124 @@ mFUNCTION(mString_RemoveChar, const mString &string, const mchar_t remove, OUT m
   if (!lastWasMatch)
   {
     const size_t size = sourceOffset - firstNoMatchByte;
-    mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + firstNoMatchByte, size));
+    mERROR_CHECK(mMemcpy(pResult->Data() + destinationOffset, string.Data() + firstNoMatchByte, size));
     destinationOffset += size;
   }
 
-  pResult->text[destinationOffset] = '\0';
+  pResult->Data()[destinationOffset] = '\0';
   pResult->count = destinationCharCount + 1;
   pResult->bytes = destinationCharSize + 1;
 
   mRETURN_SUCCESS();
 }
 
-mFUNCTION(mString_RemoveString, const mString &string, const mString &remove, OUT mString *pResult)
+// Finds all non-overlapping occurrences of `replace` first, so the result can be allocated with its final size.
+static mFUNCTION(mString_Replace_Internal, const mString &string, const mString &replace, IN const char *with, const size_t withBytes, const size_t withCount, OUT mString *pResult)
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF(pResult == nullptr, mR_ArgumentNull);
-  mERROR_IF(string.hasFailed || remove.hasFailed, mR_InvalidParameter);
+  const char *pText = string.Data();
+  const size_t textBytes = string.bytes - 1;
+  const size_t replaceBytes = replace.bytes - 1;
 
-  if (remove.bytes <= 1 || string.bytes <= 1 || remove.count > string.count)
+  size_t *pMatches = nullptr;
+  size_t matchCapacity = 0;
+  size_t matchCount = 0;
+
+  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pMatches);
+
+  for (size_t offset = 0; offset < textBytes; )
+  {
+    const size_t match = offset + mString_FindBytes_Internal(pText + offset, textBytes - offset, replace.Data(), replaceBytes);
+
+    if (match == textBytes)
+      break;
+
+    if (matchCount == matchCapacity)
+    {
+      const size_t newCapacity = mMax((size_t)16, matchCapacity * 2);
+      mERROR_CHECK(mAllocator_Reallocate(&mDefaultTempAllocator, &pMatches, newCapacity));
+      matchCapacity = newCapacity;
+    }
+
+    pMatches[matchCount++] = match;
+    offset = match + replaceBytes;
+  }
+
+  if (matchCount == 0)
   {
     mERROR_CHECK(mString_Create(pResult, string, pResult->pAllocator));
     mRETURN_SUCCESS();
   }
 
-  mERROR_CHECK(mString_Create(pResult, "", pResult->pAllocator));
-  mERROR_CHECK(mString_Reserve(*pResult, string.bytes));
-
-  size_t *pKmp = nullptr;
-  mchar_t *pChars = nullptr;
+  const size_t resultBytes = string.bytes - matchCount * replaceBytes + matchCount * withBytes;
+  const size_t resultCount = string.count - matchCount * (replace.count - 1) + matchCount * withCount;
 
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pKmp);
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pChars);
-  mERROR_CHECK(mAllocator_AllocateZero(&mDefaultTempAllocator, &pKmp, remove.count - 1));
-  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pChars, remove.count - 1));
-
-  mString_GetKmp(remove, pChars, pKmp);
+  mERROR_CHECK(mString_Create(pResult, "", pResult->pAllocator));
+  mERROR_CHECK(mString_Reserve(*pResult, resultBytes));
 
-  size_t charOffsetAfter, byteOffsetAfter;
-  size_t charOffset = 0;
-  size_t byteOffset = 0;
+  char *pDestination = pResult->Data();
+  size_t sourceOffset = 0;
   size_t destinationOffset = 0;
-  size_t destinationNotBytes = 0;
-  size_t destinationNotCount = 0;
-  bool contained = false;
 
-  while (charOffset < string.count - 1)
+  for (size_t i = 0; i < matchCount; i++)
   {
-    mString_FindNextWithKMP(string, charOffset, byteOffset, pChars, remove.count - 1, pKmp, &charOffsetAfter, &byteOffsetAfter, &contained);
+    const size_t size = pMatches[i] - sourceOffset;
 
-    if (!contained)
-    {
-      const size_t size = string.bytes - 1 - byteOffset;
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + byteOffset, size));
-      destinationOffset += size;
-
-      break;
-    }
-    else if (byteOffsetAfter - (remove.bytes - 1) != byteOffset)
-    {
-      const size_t size = byteOffsetAfter - (remove.bytes - 1) - byteOffset;
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + byteOffset, size));
-      destinationOffset += size;
-    }
+    mERROR_CHECK(mMemcpy(pDestination + destinationOffset, pText + sourceOffset, size));
+    destinationOffset += size;
 
-    charOffset = charOffsetAfter;
-    byteOffset = byteOffsetAfter;
+    mERROR_CHECK(mMemcpy(pDestination + destinationOffset, with, withBytes));
+    destinationOffset += withBytes;
 
-    destinationNotBytes += remove.bytes - 1;
-    destinationNotCount += remove.count - 1;
+    sourceOffset = pMatches[i] + replaceBytes;
   }
 
-  pResult->text[destinationOffset] = '\0';
-  pResult->bytes = string.bytes - destinationNotBytes;
-  pResult->count = string.count - destinationNotCount;
+  mERROR_CHECK(mMemcpy(pDestination + destinationOffset, pText + sourceOffset, textBytes - sourceOffset));
+  destinationOffset += textBytes - sourceOffset;
+
+  pDestination[destinationOffset] = '\0';
+  pResult->bytes = resultBytes;
+  pResult->count = resultCount;
 
   mRETURN_SUCCESS();
 }
 
-mFUNCTION(mString_Replace, const mString &string, const mString &replace, const mString &with, OUT mString *pResult)
+mFUNCTION(mString_RemoveString, const mString &string, const mString &remove, OUT mString *pResult)
 {
   mFUNCTION_SETUP();
 
   mERROR_IF(pResult == nullptr, mR_ArgumentNull);
-  mERROR_IF(string.hasFailed || replace.hasFailed || with.hasFailed, mR_InvalidParameter);
+  mERROR_IF(string.hasFailed || remove.hasFailed, mR_InvalidParameter);
 
-  if (replace.bytes <= 1 || string.bytes <= 1 || replace.count > string.count)
+  if (remove.bytes <= 1 || string.bytes <= 1 || remove.count > string.count)
   {
     mERROR_CHECK(mString_Create(pResult, string, pResult->pAllocator));
     mRETURN_SUCCESS();
   }
 
-  mERROR_CHECK(mString_Create(pResult, "", pResult->pAllocator));
-  mERROR_CHECK(mString_Reserve(*pResult, string.bytes));
-
-  size_t *pKmp = nullptr;
-  mchar_t *pChars = nullptr;
+  mERROR_CHECK(mString_Replace_Internal(string, remove, "", 0, 0, pResult));
 
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pKmp);
-  mDEFER_CALL_2(mAllocator_FreePtr, &mDefaultTempAllocator, &pChars);
-  mERROR_CHECK(mAllocator_AllocateZero(&mDefaultTempAllocator, &pKmp, replace.count - 1));
-  mERROR_CHECK(mAllocator_Allocate(&mDefaultTempAllocator, &pChars, replace.count - 1));
+  mRETURN_SUCCESS();
+}
 
-  mString_GetKmp(replace, pChars, pKmp);
+mFUNCTION(mString_Replace, const mString &string, const mString &replace, const mString &with, OUT mString *pResult)
+{
+  mFUNCTION_SETUP();
 
-  size_t charOffsetAfter, byteOffsetAfter;
-  size_t charOffset = 0;
-  size_t byteOffset = 0;
-  size_t destinationOffset = 0;
-  size_t destinationNotBytes = 0;
-  size_t destinationNotCount = 0;
-  size_t destinationAddedBytes = 0;
-  size_t destinationAddedCount = 0;
-  bool contained = false;
+  mERROR_IF(pResult == nullptr, mR_ArgumentNull);
+  mERROR_IF(string.hasFailed || replace.hasFailed || with.hasFailed, mR_InvalidParameter);
 
-  while (charOffset < string.count - 1)
+  if (replace.bytes <= 1 || string.bytes <= 1 || replace.count > string.count)
   {
-    mString_FindNextWithKMP(string, charOffset, byteOffset, pChars, replace.count - 1, pKmp, &charOffsetAfter, &byteOffsetAfter, &contained);
-
-    if (!contained)
-    {
-      const size_t size = string.bytes - 1 - byteOffset;
-
-      if (destinationOffset + size >= pResult->capacity)
-        mERROR_CHECK(mString_Reserve(*pResult, mMax(pResult->capacity * 2, pResult->capacity + destinationOffset + size)));
-
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + byteOffset, size));
-      destinationOffset += size;
-
-      break;
-    }
-    else if (byteOffsetAfter - (replace.bytes - 1) != byteOffset)
-    {
-      const size_t size = byteOffsetAfter - (replace.bytes - 1) - byteOffset;
-
-      if (destinationOffset + size + with.bytes >= pResult->capacity)
-        mERROR_CHECK(mString_Reserve(*pResult, mMax(pResult->capacity * 2, pResult->capacity + destinationOffset + size + with.bytes)));
-
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, string.text + byteOffset, size));
-      destinationOffset += size;
-
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, with.text, with.bytes - 1));
-      destinationOffset += with.bytes - 1;
-
-      destinationAddedBytes += with.bytes - 1;
-      destinationAddedCount += with.count - 1;
-    }
-    else
-    {
-      if (destinationOffset + with.bytes >= pResult->capacity)
-        mERROR_CHECK(mString_Reserve(*pResult, mMax(pResult->capacity * 2, pResult->capacity + destinationOffset + with.bytes)));
-
-      mERROR_CHECK(mMemcpy(pResult->text + destinationOffset, with.text, with.bytes - 1));
-      destinationOffset += with.bytes - 1;
-
-      destinationAddedBytes += with.bytes - 1;
-      destinationAddedCount += with.count - 1;
-    }
-
-    charOffset = charOffsetAfter;
-    byteOffset = byteOffsetAfter;
-
-    destinationNotBytes += replace.bytes - 1;
-    destinationNotCount += replace.count - 1;
+    mERROR_CHECK(mString_Create(pResult, string, pResult->pAllocator));
+    mRETURN_SUCCESS();
   }
 
-  pResult->text[destinationOffset] = '\0';
-  pResult->bytes = string.bytes - destinationNotBytes + destinationAddedBytes;
-  pResult->count = string.count - destinationNotCount + destinationAddedCount;
+  if (with.bytes <= 1)
+    mERROR_CHECK(mString_Replace_Internal(string, replace, "", 0, 0, pResult));
+  else
+    mERROR_CHECK(mString_Replace_Internal(string, replace, with.Data(), with.bytes - 1, with.count - 1, pResult));
 
   mRETURN_SUCCESS();
 }
@@ -1895,28 +1879,17 @@ mFUNCTION(mInplaceString_GetCount_Internal, IN const char *text, const size_t ma
 {
   mFUNCTION_SETUP();
 
-  size_t offset = 0;
-  size_t count = 0;
+  size_t length = 0;
+  mERROR_CHECK(mStringLength(text, maxSize, &length));
 
-  while (offset < maxSize)
-  {
-    utf8proc_int32_t codePoint;
-    ptrdiff_t characterSize;
-    mERROR_IF((characterSize = utf8proc_iterate(reinterpret_cast<const uint8_t *>(text) + offset, maxSize - offset, &codePoint)) < 0, mR_InternalError);
-    mERROR_IF(codePoint < 0, mR_InternalError);
-    offset += (size_t)characterSize;
-    count++;
+  // Include the null terminator if there is one.
+  const size_t bytes = mMin(length + 1, maxSize);
 
-    if (characterSize == 0 || codePoint == 0)
-    {
-      *pCount = count;
-      *pSize = offset;
-      break;
-    }
-  }
+  size_t count = 0;
+  mERROR_IF(!mUtf8_Validate(text, bytes, &count), mR_InternalError);
 
   *pCount = count;
-  *pSize = offset;
+  *pSize = bytes;
 
   mRETURN_SUCCESS();
 }
@@ -2000,3 +1973,57 @@ mIteratedString::mIteratedString(char *character, const mchar_t codePoint, const
   index(index),
   offset(offset)
 { }
+
+//////////////////////////////////////////////////////////////////////////
+
+static void mString_DestroyCharIndex_Internal(mString &string)
+{
+  if (string.pText != nullptr && string.pCharIndex != nullptr)
+    mAllocator_FreePtr(string.pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE ? string.pAllocator : nullptr, &string.pCharIndex);
+}
+
+static mFUNCTION(mString_FreeText_Internal, mString &string)
+{
+  mFUNCTION_SETUP();
+
+  mString_DestroyCharIndex_Internal(string);
+
+  if (string.pText != nullptr && string.pAllocator != mSHARED_POINTER_FOREIGN_RESOURCE)
+    mERROR_CHECK(mAllocator_FreePtr(string.pAllocator, &string.pText));
+
+  string.pText = nullptr;
+  string.capacity = 0;
+
+  mRETURN_SUCCESS();
+}
+
+// Returns `string.bytes` if the string contains invalid characters. `character` has to be less than `string.count` and not less than `startCharacter`.
+static size_t mString_GetByteOffset_Internal(const mString &string, const size_t character, const size_t startCharacter /* = 0 */, const size_t startOffset /* = 0 */)
+{
+  if (string.IsAscii())
+    return character;
+
+  size_t index = startCharacter;
+  size_t offset = startOffset;
+
+  if (string.pText != nullptr && string.pCharIndex != nullptr && character - startCharacter >= mString_CharIndex_Stride)
+  {
+    index = character - (character % mString_CharIndex_Stride);
+    offset = string.pCharIndex[character / mString_CharIndex_Stride];
+  }
+
+  const uint8_t *pText = reinterpret_cast<const uint8_t *>(string.c_str());
+
+  for (; index < character; index++)
+  {
+    utf8proc_int32_t codePoint;
+    const ptrdiff_t characterSize = utf8proc_iterate(pText + offset, string.bytes - offset, &codePoint);
+
+    if (characterSize <= 0 || codePoint < 0)
+      return string.bytes;
+
+    offset += (size_t)characterSize;
+  }
+
+  return offset;
+}
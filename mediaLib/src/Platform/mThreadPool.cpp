@@ -1,5 +1,6 @@
 #include "mThreadPool.h"
 #include "mQueue.h"
+#include "mProfiler.h"
 
 #ifdef GIT_BUILD // Define __M_FILE__
   #ifdef __M_FILE__
@@ -8,6 +9,8 @@
   #define __M_FILE__ "GpZR7lIVJraLZVrxePJ4x2f1wEbA2DaftVdVLhE6iuhe3LxcRDUIHEU0pvcIc9PAswU9VtmNONizhgPO"
 #endif
 
+struct mThreadPool_ParallelForState;
+
 struct mTask
 {
   std::function<mResult(void)> function;
@@ -17,22 +20,38 @@ struct mTask
   mResult result;
   mAllocator *pAllocator = nullptr;
   bool isAllocated = false;
+  const char *name;
+
+  // Task Graph:
+  std::atomic<size_t> pendingDependencyCount; // includes one for the task not having been enqueued yet.
+  std::atomic<bool> hasBeenEnqueued;
+  mThreadPool *pThreadPool; // the thread pool to enqueue the task to once all dependencies have completed.
+  std::atomic<bool> continuationLock;
+  bool continuationsReleased;
+  mTask **ppContinuations;
+  size_t continuationCount, continuationCapacity;
+
+  // Chunks of `mThreadPool_ParallelFor` have to be accounted for even if they are discarded without being executed.
+  mThreadPool_ParallelForState *pParallelForState;
+  size_t parallelForChunkSize;
 };
 
 static mFUNCTION(mTask_Destroy_Internal, IN mTask *pTask);
+static mFUNCTION(mTask_CreateWithLambda_Internal, OUT mTask **ppTask, IN OPTIONAL mAllocator *pAllocator, const std::function<mResult(void)> &function, const bool createSemaphore);
+static mFUNCTION(mTask_CreateInplace_Internal, IN mTask *pTask, const std::function<mResult(void)> &function, const bool createSemaphore);
+static mFUNCTION(mTask_Abort_Internal, IN mTask *pTask, const mResult dependencyResult);
+static mFUNCTION(mTask_ReleaseContinuations_Internal, IN mTask *pTask);
+static void mTask_DiscardParallelForChunk_Internal(IN mTask *pTask);
+static void mTask_LockContinuations_Internal(IN mTask *pTask);
+static void mTask_UnlockContinuations_Internal(IN mTask *pTask);
+
+static mFUNCTION(mThreadPool_EnqueueTask_Internal, mThreadPool *pThreadPool, IN mTask *pTask);
 
 mFUNCTION(mTask_CreateWithLambda, OUT mTask **ppTask, IN OPTIONAL mAllocator *pAllocator, const std::function<mResult(void)> &function)
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF(ppTask == nullptr, mR_ArgumentNull);
-
-  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, ppTask, 1));
-  (*ppTask)->isAllocated = true;
-  (*ppTask)->pAllocator = pAllocator;
-
-  mDEFER_CALL_ON_ERROR(ppTask, mTask_Destroy);
-  mERROR_CHECK(mTask_CreateInplace(*ppTask, function));
+  mERROR_CHECK(mTask_CreateWithLambda_Internal(ppTask, pAllocator, function, true));
 
   mRETURN_SUCCESS();
 }
@@ -41,14 +60,7 @@ mFUNCTION(mTask_CreateInplace, IN mTask *pTask, const std::function<mResult(void
 {
   mFUNCTION_SETUP();
 
-  mERROR_IF(pTask == nullptr, mR_ArgumentNull);
-
-  pTask->result = mR_Success;
-  new (&pTask->function) std::function<mResult(void)>(function);
-  new (&pTask->state) std::atomic<mTask_State>(mT_S_Initialized);
-  new (&pTask->referenceCount) std::atomic<size_t>(1);
-
-  mERROR_CHECK(mSemaphore_Create(&pTask->pSemaphore, pTask->pAllocator));
+  mERROR_CHECK(mTask_CreateInplace_Internal(pTask, function, true));
 
   mRETURN_SUCCESS();
 }
@@ -168,9 +180,15 @@ mFUNCTION(mTask_Execute, IN mTask *pTask)
 
     mERROR_IF_GOTO(pTask->function == nullptr, mR_NotInitialized, result, epilogue);
 
+    if (pTask->name != nullptr)
+      mProfiler_ReportEventStart(pTask->name);
+
     pTask->result = pTask->function();
     hasBeenExecuted = true;
 
+    if (pTask->name != nullptr)
+      mProfiler_ReportEventEnd(pTask->name);
+
   epilogue:
     if (!hasBeenExecuted || (mSUCCEEDED(pTask->result) && mFAILED(result)))
       pTask->result = result;
@@ -178,7 +196,10 @@ mFUNCTION(mTask_Execute, IN mTask *pTask)
     pTask->state = mTask_State::mT_S_Complete;
   }
 
-  result = mSemaphore_WakeAll(pTask->pSemaphore);
+  if (pTask->pSemaphore != nullptr)
+    result = mSemaphore_WakeAll(pTask->pSemaphore);
+
+  mERROR_CHECK(mTask_ReleaseContinuations_Internal(pTask));
 
   mRETURN_SUCCESS();
 }
@@ -189,20 +210,7 @@ mFUNCTION(mTask_Abort, IN mTask *pTask)
 
   mERROR_IF(pTask == nullptr, mR_ArgumentNull);
 
-  if (pTask->state < mTask_State::mT_S_Running && pTask->state != mTask_State::mT_S_NotInitialized)
-  {
-    if (pTask->pSemaphore != nullptr)
-      mERROR_CHECK(mSemaphore_Lock(pTask->pSemaphore));
-
-    if (pTask->state < mTask_State::mT_S_Running)
-      pTask->state = mTask_State::mT_S_Aborted;
-
-    if (pTask->pSemaphore != nullptr)
-    {
-      mERROR_CHECK(mSemaphore_Unlock(pTask->pSemaphore));
-      mERROR_CHECK(mSemaphore_WakeAll(pTask->pSemaphore));
-    }
-  }
+  mERROR_CHECK(mTask_Abort_Internal(pTask, mR_Success));
 
   mRETURN_SUCCESS();
 }
@@ -229,15 +237,129 @@ mFUNCTION(mTask_GetState, IN mTask *pTask, OUT mTask_State *pTaskState)
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mTask_SetName, IN mTask *pTask, IN const char *name)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pTask == nullptr, mR_ArgumentNull);
+
+  pTask->name = name;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mTask_AddDependency, IN mTask *pTask, IN mTask *pDependency)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pTask == nullptr || pDependency == nullptr, mR_ArgumentNull);
+  mERROR_IF(pTask == pDependency, mR_InvalidParameter);
+  mERROR_IF(pTask->hasBeenEnqueued || pTask->state >= mTask_State::mT_S_Running, mR_ResourceStateInvalid);
+
+  bool dependencyHasFinished = false;
+
+  {
+    mTask_LockContinuations_Internal(pDependency);
+    mDEFER(mTask_UnlockContinuations_Internal(pDependency));
+
+    if (pDependency->continuationsReleased)
+    {
+      dependencyHasFinished = true;
+    }
+    else
+    {
+      if (pDependency->continuationCount == pDependency->continuationCapacity)
+      {
+        const size_t newCapacity = mMax((size_t)4, pDependency->continuationCapacity * 2);
+        mERROR_CHECK(mAllocator_Reallocate(pDependency->pAllocator, &pDependency->ppContinuations, newCapacity));
+        pDependency->continuationCapacity = newCapacity;
+      }
+
+      mERROR_CHECK(mTask_AddReference(pTask));
+
+      ++pTask->pendingDependencyCount;
+      pDependency->ppContinuations[pDependency->continuationCount++] = pTask;
+    }
+  }
+
+  // The dependency has already completed or been aborted.
+  if (dependencyHasFinished && (pDependency->state != mTask_State::mT_S_Complete || mFAILED(pDependency->result)))
+    mERROR_CHECK(mTask_Abort_Internal(pTask, pDependency->result));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mTask_CreateWithLambda_Internal, OUT mTask **ppTask, IN OPTIONAL mAllocator *pAllocator, const std::function<mResult(void)> &function, const bool createSemaphore)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(ppTask == nullptr, mR_ArgumentNull);
+
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, ppTask, 1));
+  (*ppTask)->isAllocated = true;
+  (*ppTask)->pAllocator = pAllocator;
+
+  mDEFER_CALL_ON_ERROR(ppTask, mTask_Destroy);
+  mERROR_CHECK(mTask_CreateInplace_Internal(*ppTask, function, createSemaphore));
+
+  mRETURN_SUCCESS();
+}
+
+// Tasks without semaphore can't be joined efficiently but are a lot cheaper to create. Used for tasks that are only ever tracked by their creator.
+static mFUNCTION(mTask_CreateInplace_Internal, IN mTask *pTask, const std::function<mResult(void)> &function, const bool createSemaphore)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pTask == nullptr, mR_ArgumentNull);
+
+  pTask->result = mR_Success;
+  pTask->name = nullptr;
+  new (&pTask->function) std::function<mResult(void)>(function);
+  new (&pTask->state) std::atomic<mTask_State>(mT_S_Initialized);
+  new (&pTask->referenceCount) std::atomic<size_t>(1);
+
+  new (&pTask->pendingDependencyCount) std::atomic<size_t>(1);
+  new (&pTask->hasBeenEnqueued) std::atomic<bool>(false);
+  new (&pTask->continuationLock) std::atomic<bool>(false);
+  pTask->pThreadPool = nullptr;
+  pTask->continuationsReleased = false;
+  pTask->ppContinuations = nullptr;
+  pTask->continuationCount = 0;
+  pTask->continuationCapacity = 0;
+  pTask->pParallelForState = nullptr;
+  pTask->parallelForChunkSize = 0;
+
+  if (createSemaphore)
+    mERROR_CHECK(mSemaphore_Create(&pTask->pSemaphore, pTask->pAllocator));
+
+  mRETURN_SUCCESS();
+}
+
 static mFUNCTION(mTask_Destroy_Internal, IN mTask *pTask)
 {
   mFUNCTION_SETUP();
 
   mERROR_IF(pTask == nullptr, mR_ArgumentNull);
 
+  // Continuations of a task that will never be executed can never be scheduled.
+  if (!pTask->continuationsReleased && pTask->continuationCount > 0)
+  {
+    pTask->state = mTask_State::mT_S_Aborted;
+    mERROR_CHECK(mTask_ReleaseContinuations_Internal(pTask));
+  }
+
+  // Otherwise the caller of `mThreadPool_ParallelFor` would wait for the chunk forever.
+  if (pTask->pParallelForState != nullptr && pTask->state < mTask_State::mT_S_Running)
+    mTask_DiscardParallelForChunk_Internal(pTask);
+
   if(pTask->pSemaphore)
     mERROR_CHECK(mSemaphore_Destroy(&pTask->pSemaphore));
 
+  mERROR_CHECK(mAllocator_FreePtr(pTask->pAllocator, &pTask->ppContinuations));
+
+  pTask->pendingDependencyCount.~atomic();
+  pTask->hasBeenEnqueued.~atomic();
+  pTask->continuationLock.~atomic();
   pTask->referenceCount.~atomic();
   pTask->state.~atomic();
   pTask->function.~function();
@@ -248,8 +370,128 @@ static mFUNCTION(mTask_Destroy_Internal, IN mTask *pTask)
   mRETURN_SUCCESS();
 }
 
+static mFUNCTION(mTask_Abort_Internal, IN mTask *pTask, const mResult dependencyResult)
+{
+  mFUNCTION_SETUP();
+
+  bool hasBeenAborted = false;
+
+  if (pTask->state < mTask_State::mT_S_Running && pTask->state != mTask_State::mT_S_NotInitialized)
+  {
+    if (pTask->pSemaphore != nullptr)
+      mERROR_CHECK(mSemaphore_Lock(pTask->pSemaphore));
+
+    if (pTask->state < mTask_State::mT_S_Running)
+    {
+      pTask->state = mTask_State::mT_S_Aborted;
+      hasBeenAborted = true;
+
+      if (mFAILED(dependencyResult))
+        pTask->result = dependencyResult;
+    }
+
+    if (pTask->pSemaphore != nullptr)
+    {
+      mERROR_CHECK(mSemaphore_Unlock(pTask->pSemaphore));
+      mERROR_CHECK(mSemaphore_WakeAll(pTask->pSemaphore));
+    }
+  }
+
+  if (hasBeenAborted)
+    mERROR_CHECK(mTask_ReleaseContinuations_Internal(pTask));
+
+  mRETURN_SUCCESS();
+}
+
+// Schedules or aborts all continuations of a task that has completed or been aborted. Only the first call has any effect.
+static mFUNCTION(mTask_ReleaseContinuations_Internal, IN mTask *pTask)
+{
+  mFUNCTION_SETUP();
+
+  mTask **ppContinuations = nullptr;
+  size_t continuationCount = 0;
+
+  {
+    mTask_LockContinuations_Internal(pTask);
+    mDEFER(mTask_UnlockContinuations_Internal(pTask));
+
+    if (pTask->continuationsReleased)
+      mRETURN_SUCCESS();
+
+    pTask->continuationsReleased = true;
+
+    ppContinuations = pTask->ppContinuations;
+    continuationCount = pTask->continuationCount;
+
+    pTask->ppContinuations = nullptr;
+    pTask->continuationCount = 0;
+    pTask->continuationCapacity = 0;
+  }
+
+  mDEFER_CALL_2(mAllocator_FreePtr, pTask->pAllocator, &ppContinuations);
+
+  const bool succeeded = (pTask->state == mTask_State::mT_S_Complete && mSUCCEEDED(pTask->result));
+  mResult result = mR_Success;
+
+  // Every continuation has to be released, even if some of them fail.
+  for (size_t i = 0; i < continuationCount; i++)
+  {
+    mTask *pContinuation = ppContinuations[i];
+    mResult continuationResult = mR_Success;
+
+    if (!succeeded)
+      continuationResult = mTask_Abort_Internal(pContinuation, pTask->result);
+    else if (--pContinuation->pendingDependencyCount == 0)
+      continuationResult = mThreadPool_EnqueueTask_Internal(pContinuation->pThreadPool, pContinuation);
+
+    if (mFAILED(continuationResult) && mSUCCEEDED(result))
+      result = continuationResult;
+
+    continuationResult = mTask_Destroy(&pContinuation);
+
+    if (mFAILED(continuationResult) && mSUCCEEDED(result))
+      result = continuationResult;
+  }
+
+  mERROR_IF(mFAILED(result), result);
+
+  mRETURN_SUCCESS();
+}
+
+static void mTask_LockContinuations_Internal(IN mTask *pTask)
+{
+  while (pTask->continuationLock.exchange(true, std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+static void mTask_UnlockContinuations_Internal(IN mTask *pTask)
+{
+  pTask->continuationLock.store(false, std::memory_order_release);
+}
+
 //////////////////////////////////////////////////////////////////////////
 
+struct mThreadPool_TaskDequeBuffer
+{
+  std::atomic<mTask *> *pTasks;
+  size_t capacityMask; // capacity is always a power of two.
+  mThreadPool_TaskDequeBuffer *pPrevious; // Retired buffers may still be read by concurrent thieves, so they're only released when the deque is destroyed.
+};
+
+// Chase-Lev work stealing deque. Only the owning worker thread pushes and takes from the bottom, any thread can steal from the top.
+struct mThreadPool_TaskDeque
+{
+  std::atomic<int64_t> top;
+  uint8_t _topPadding[64 - sizeof(std::atomic<int64_t>)]; // to not share a cache line with `bottom`.
+  std::atomic<int64_t> bottom;
+  std::atomic<mThreadPool_TaskDequeBuffer *> pBuffer;
+  mAllocator *pAllocator;
+  uint8_t _bottomPadding[64 - sizeof(std::atomic<int64_t>) - sizeof(std::atomic<mThreadPool_TaskDequeBuffer *>) - sizeof(mAllocator *)];
+};
+
+constexpr size_t mThreadPool_TaskDeque_InitialCapacity = 256;
+constexpr size_t mThreadPool_IdleSpinCount = 64;
+
 struct mThreadPool
 {
   volatile bool isRunning;
@@ -258,10 +500,40 @@ struct mThreadPool
   mSemaphore *pSemaphore;
   mAllocator *pAllocator;
   mPtr<mQueue<mTask *>> queue;
+  mThreadPool_Mode mode;
+  mThreadPool_TaskDeque *pDeques; // only used in `mTP_M_WorkStealing`.
+  std::atomic<size_t> queuedTaskCount; // number of tasks in `queue`, so that workers don't have to lock the semaphore to find out that the queue is empty.
+  std::atomic<size_t> idleThreadCount;
+};
+
+static thread_local mThreadPool *mThreadPool_pCurrentThreadPool = nullptr;
+static thread_local size_t mThreadPool_CurrentWorkerIndex = 0;
+static thread_local uint64_t mThreadPool_RandomState = 0;
+
+struct mThreadPool_ParallelForState
+{
+  mThreadPool *pThreadPool;
+  const std::function<mResult(const size_t chunkStart, const size_t chunkEnd)> *pFunction;
+  size_t grainSize;
+  std::atomic<size_t> remainingCount;
+  std::atomic<mResult> result;
 };
 
-static mFUNCTION(mThreadPool_Create_Internal, mThreadPool *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads);
+static mFUNCTION(mThreadPool_Create_Internal, mThreadPool *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads, const mThreadPool_Mode mode);
 static mFUNCTION(mThreadPool_Destroy_Internal, mThreadPool *pThreadPool);
+static mFUNCTION(mThreadPool_EnqueueTask_Internal, mThreadPool *pThreadPool, IN mTask *pTask);
+static mFUNCTION(mThreadPool_ClearDeques_Internal, mThreadPool *pThreadPool);
+static mTask * mThreadPool_PopSharedQueue_Internal(mThreadPool *pThreadPool);
+static mTask * mThreadPool_Steal_Internal(mThreadPool *pThreadPool);
+static bool mThreadPool_TryExecuteTask_Internal(mThreadPool *pThreadPool);
+static void mThreadPool_ParallelFor_Internal(mThreadPool_ParallelForState *pState, size_t chunkStart, size_t chunkEnd);
+
+static mFUNCTION(mThreadPool_TaskDeque_Create_Internal, IN mThreadPool_TaskDeque *pDeque, IN OPTIONAL mAllocator *pAllocator);
+static mFUNCTION(mThreadPool_TaskDeque_Destroy_Internal, IN mThreadPool_TaskDeque *pDeque);
+static mFUNCTION(mThreadPool_TaskDeque_Push_Internal, IN mThreadPool_TaskDeque *pDeque, IN mTask *pTask);
+static mTask * mThreadPool_TaskDeque_Take_Internal(IN mThreadPool_TaskDeque *pDeque);
+static mTask * mThreadPool_TaskDeque_Steal_Internal(IN mThreadPool_TaskDeque *pDeque);
+static mFUNCTION(mThreadPool_TaskDequeBuffer_Create_Internal, OUT mThreadPool_TaskDequeBuffer **ppBuffer, IN OPTIONAL mAllocator *pAllocator, const size_t capacity);
 
 void mThreadPool_WorkerThread(mThreadPool *pThreadPool)
 {
@@ -279,7 +551,10 @@ void mThreadPool_WorkerThread(mThreadPool *pThreadPool)
       mASSERT(mSUCCEEDED(mQueue_GetCount(pThreadPool->queue, &count)), "Error in " __FUNCTION__ ": Could not get task queue length.");
 
       if (count > 0)
+      {
         mASSERT(mSUCCEEDED(mQueue_PopFront(pThreadPool->queue, &pTask)), "Error in " __FUNCTION__ ": Could not dequeue task.");
+        --pThreadPool->queuedTaskCount;
+      }
     }
 
     if (pTask != nullptr)
@@ -297,11 +572,48 @@ void mThreadPool_WorkerThread(mThreadPool *pThreadPool)
   }
 }
 
-mFUNCTION(mThreadPool_Create, OUT mPtr<mThreadPool> *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads /* = mThreadPool_ThreadCount::mTP_TC_NumberOfLogicalCores */)
+void mThreadPool_WorkStealingWorkerThread(mThreadPool *pThreadPool, const size_t workerIndex)
+{
+  mASSERT(pThreadPool != nullptr, "ThreadPool cannot be nullptr.");
+
+  mThreadPool_pCurrentThreadPool = pThreadPool;
+  mThreadPool_CurrentWorkerIndex = workerIndex;
+
+  size_t idleIterations = 0;
+
+  while (pThreadPool->isRunning)
+  {
+    if (mThreadPool_TryExecuteTask_Internal(pThreadPool))
+    {
+      idleIterations = 0;
+      continue;
+    }
+
+    // Spin for a bit before going to sleep, other workers are likely to spawn more tasks soon.
+    if (idleIterations < mThreadPool_IdleSpinCount)
+    {
+      ++idleIterations;
+      std::this_thread::yield();
+      continue;
+    }
+
+    ++pThreadPool->idleThreadCount;
+    const mResult result = mSILENCE_ERROR(mSemaphore_Sleep(pThreadPool->pSemaphore, 1));
+    --pThreadPool->idleThreadCount;
+
+    if (result != mR_Timeout)
+      mASSERT(mSUCCEEDED(result), "Error in " __FUNCTION__ ": Semaphore error.");
+  }
+
+  mThreadPool_pCurrentThreadPool = nullptr;
+}
+
+mFUNCTION(mThreadPool_Create, OUT mPtr<mThreadPool> *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads /* = mThreadPool_ThreadCount::mTP_TC_NumberOfLogicalCores */, const mThreadPool_Mode mode /* = mTP_M_SharedQueue */)
 {
   mFUNCTION_SETUP();
 
   mERROR_IF(pThreadPool == nullptr, mR_ArgumentNull);
+  mERROR_IF(mode != mTP_M_SharedQueue && mode != mTP_M_WorkStealing, mR_InvalidParameter);
 
   if (*pThreadPool != nullptr)
   {
@@ -317,7 +629,7 @@ mFUNCTION(mThreadPool_Create, OUT mPtr<mThreadPool> *pThreadPool, IN OPTIONAL mA
   mERROR_CHECK(mSharedPointer_Create<mThreadPool>(pThreadPool, pObject, [](mThreadPool *pData) { mThreadPool_Destroy_Internal(pData); }, pAllocator));
   pObject = nullptr; // to not be destroyed on error.
 
-  mERROR_CHECK(mThreadPool_Create_Internal(pThreadPool->GetPointer(), pAllocator, threads));
+  mERROR_CHECK(mThreadPool_Create_Internal(pThreadPool->GetPointer(), pAllocator, threads, mode));
 
   mRETURN_SUCCESS();
 }
@@ -352,10 +664,14 @@ mFUNCTION(mThreadPool_Clear, mPtr<mThreadPool> &asyncTaskHandler)
       mTask *pTask = nullptr;
 
       mERROR_CHECK(mQueue_PopFront(asyncTaskHandler->queue, &pTask));
+      --asyncTaskHandler->queuedTaskCount;
+
       mERROR_CHECK(mTask_Destroy(&pTask));
     }
   }
 
+  mERROR_CHECK(mThreadPool_ClearDeques_Internal(asyncTaskHandler.GetPointer()));
+
   mRETURN_SUCCESS();
 }
 
@@ -365,18 +681,7 @@ mFUNCTION(mThreadPool_EnqueueTask, mPtr<mThreadPool> &asyncTaskHandler, IN mTask
 
   mERROR_IF(asyncTaskHandler == nullptr || pTask == nullptr, mR_ArgumentNull);
 
-  // Enqueue task.
-  {
-    mERROR_CHECK(mSemaphore_Lock(asyncTaskHandler->pSemaphore));
-    mDEFER_CALL(asyncTaskHandler->pSemaphore, mSemaphore_Unlock);
-    
-    ++pTask->referenceCount;
-    mDEFER_ON_ERROR(--pTask->referenceCount);
-
-    mERROR_CHECK(mQueue_PushBack(asyncTaskHandler->queue, pTask));
-  }
-
-  mERROR_CHECK(mSemaphore_WakeOne(asyncTaskHandler->pSemaphore));
+  mERROR_CHECK(mThreadPool_EnqueueTask_Internal(asyncTaskHandler.GetPointer(), pTask));
 
   mRETURN_SUCCESS();
 }
@@ -392,12 +697,103 @@ mFUNCTION(mThreadPool_GetThreadCount, mPtr<mThreadPool> &asyncTaskHandler, OUT s
   mRETURN_SUCCESS();
 }
 
-static mFUNCTION(mThreadPool_Create_Internal, mThreadPool *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads)
+mFUNCTION(mThreadPool_ParallelFor, mPtr<mThreadPool> &asyncTaskHandler, const size_t rangeStart, const size_t rangeEnd, const size_t grainSize, const std::function<mResult(const size_t chunkStart, const size_t chunkEnd)> &function)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(asyncTaskHandler == nullptr, mR_ArgumentNull);
+  mERROR_IF(function == nullptr, mR_InvalidParameter);
+  mERROR_IF(rangeStart > rangeEnd, mR_InvalidParameter);
+
+  if (rangeStart == rangeEnd)
+    mRETURN_SUCCESS();
+
+  mThreadPool_ParallelForState state;
+  state.pThreadPool = asyncTaskHandler.GetPointer();
+  state.pFunction = &function;
+  state.remainingCount = rangeEnd - rangeStart;
+  state.result = mR_Success;
+
+  if (grainSize != 0)
+    state.grainSize = grainSize;
+  else
+    state.grainSize = mMax((size_t)1, (rangeEnd - rangeStart) / (asyncTaskHandler->threadCount * 8));
+
+  mThreadPool_ParallelFor_Internal(&state, rangeStart, rangeEnd);
+
+  // Help processing the remaining tasks instead of blocking, so that nested calls from worker threads can't starve the pool.
+  while (state.remainingCount.load() != 0)
+    if (!mThreadPool_TryExecuteTask_Internal(asyncTaskHandler.GetPointer()))
+      std::this_thread::yield();
+
+  const mResult result = state.result.load();
+  mERROR_IF(mFAILED(result), result);
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mThreadPool_ForEachRowBand, mPtr<mThreadPool> &asyncTaskHandler, const size_t height, const size_t rowAlignment, const size_t bytesPerRow, const std::function<mResult(const size_t rowStart, const size_t rowEnd)> &function)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(function == nullptr || rowAlignment == 0, mR_InvalidParameter);
+
+  if (height == 0)
+    mRETURN_SUCCESS();
+
+  size_t bandHeight = mThreadPool_RowBandSize / mMax((size_t)1, bytesPerRow);
+  bandHeight = mMax(rowAlignment, bandHeight - bandHeight % rowAlignment);
+
+  const size_t bandCount = (height + bandHeight - 1) / bandHeight;
+
+  if (asyncTaskHandler == nullptr || bandCount == 1)
+  {
+    for (size_t band = 0; band < bandCount; band++)
+      mERROR_CHECK(function(band * bandHeight, mMin(height, (band + 1) * bandHeight)));
+
+    mRETURN_SUCCESS();
+  }
+  const size_t workerCount = mMin(bandCount, asyncTaskHandler->threadCount + 1); // The calling thread participates as well.
+
+  std::atomic<size_t> nextBand(0);
+  std::atomic<bool> hasFailed(false);
+
+  mERROR_CHECK(mThreadPool_ParallelFor(asyncTaskHandler, 0, workerCount, 1, [&](const size_t, const size_t)
+  {
+    while (!hasFailed.load(std::memory_order_relaxed))
+    {
+      const size_t band = nextBand++;
+
+      if (band >= bandCount)
+        break;
+
+      const mResult result = function(band * bandHeight, mMin(height, (band + 1) * bandHeight));
+
+      if (mFAILED(result))
+      {
+        hasFailed = true;
+        return result;
+      }
+    }
+
+    return mR_Success;
+  }));
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mThreadPool_Create_Internal, mThreadPool *pThreadPool, IN OPTIONAL mAllocator *pAllocator, const size_t threads, const mThreadPool_Mode mode)
 {
   mFUNCTION_SETUP();
 
   pThreadPool->pAllocator = pAllocator;
   pThreadPool->isRunning = true;
+  pThreadPool->mode = mode;
+
+  new (&pThreadPool->queuedTaskCount) std::atomic<size_t>(0);
+  new (&pThreadPool->idleThreadCount) std::atomic<size_t>(0);
 
   mDEFER_CALL_ON_ERROR(&pThreadPool->queue, mQueue_Destroy);
   mERROR_CHECK(mQueue_Create(&pThreadPool->queue, pThreadPool->pAllocator));
@@ -424,10 +820,24 @@ static mFUNCTION(mThreadPool_Create_Internal, mThreadPool *pThreadPool, IN OPTIO
 
   mERROR_IF(pThreadPool->threadCount == 0, mR_InvalidParameter);
 
+  if (mode == mTP_M_WorkStealing)
+  {
+    // The deques have to exist before any worker thread is started, as workers steal from each other.
+    mERROR_CHECK(mAllocator_AllocateZero(pThreadPool->pAllocator, &pThreadPool->pDeques, pThreadPool->threadCount));
+
+    for (size_t i = 0; i < pThreadPool->threadCount; ++i)
+      mERROR_CHECK(mThreadPool_TaskDeque_Create_Internal(&pThreadPool->pDeques[i], pThreadPool->pAllocator));
+  }
+
   mERROR_CHECK(mAllocator_AllocateZero(pThreadPool->pAllocator, &pThreadPool->ppThreads, pThreadPool->threadCount));
 
   for (size_t i = 0; i < pThreadPool->threadCount; ++i)
-    mERROR_CHECK(mThread_Create(&pThreadPool->ppThreads[i], pThreadPool->pAllocator, mThreadPool_WorkerThread, pThreadPool));
+  {
+    if (mode == mTP_M_WorkStealing)
+      mERROR_CHECK(mThread_Create(&pThreadPool->ppThreads[i], pThreadPool->pAllocator, mThreadPool_WorkStealingWorkerThread, pThreadPool, i));
+    else
+      mERROR_CHECK(mThread_Create(&pThreadPool->ppThreads[i], pThreadPool->pAllocator, mThreadPool_WorkerThread, pThreadPool));
+  }
 
   mRETURN_SUCCESS();
 }
@@ -441,6 +851,7 @@ static mFUNCTION(mThreadPool_Destroy_Internal, mThreadPool *pThreadPool)
   pThreadPool->isRunning = false;
 
   // Remove all tasks.
+  if (pThreadPool->pSemaphore != nullptr && pThreadPool->queue != nullptr)
   {
     mERROR_CHECK(mSemaphore_Lock(pThreadPool->pSemaphore));
     mDEFER_CALL(pThreadPool->pSemaphore, mSemaphore_Unlock);
@@ -455,6 +866,8 @@ static mFUNCTION(mThreadPool_Destroy_Internal, mThreadPool *pThreadPool)
       mERROR_CHECK(mQueue_PopFront(pThreadPool->queue, &pTask));
       mERROR_CHECK(mTask_Destroy(&pTask));
     }
+
+    pThreadPool->queuedTaskCount = 0;
   }
 
   if (pThreadPool->ppThreads != nullptr)
@@ -471,6 +884,17 @@ static mFUNCTION(mThreadPool_Destroy_Internal, mThreadPool *pThreadPool)
     mERROR_CHECK(mAllocator_FreePtr(pThreadPool->pAllocator, &pThreadPool->ppThreads));
   }
 
+  // All workers have been stopped, so the deques can't be accessed concurrently anymore.
+  if (pThreadPool->pDeques != nullptr)
+  {
+    mERROR_CHECK(mThreadPool_ClearDeques_Internal(pThreadPool));
+
+    for (size_t i = 0; i < pThreadPool->threadCount; ++i)
+      mERROR_CHECK(mThreadPool_TaskDeque_Destroy_Internal(&pThreadPool->pDeques[i]));
+
+    mERROR_CHECK(mAllocator_FreePtr(pThreadPool->pAllocator, &pThreadPool->pDeques));
+  }
+
   pThreadPool->threadCount = 0;
 
   if(pThreadPool->pSemaphore != nullptr)
@@ -479,6 +903,345 @@ static mFUNCTION(mThreadPool_Destroy_Internal, mThreadPool *pThreadPool)
   if (pThreadPool->queue != nullptr)
     mERROR_CHECK(mQueue_Destroy(&pThreadPool->queue));
 
+  pThreadPool->queuedTaskCount.~atomic();
+  pThreadPool->idleThreadCount.~atomic();
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mThreadPool_EnqueueTask_Internal, mThreadPool *pThreadPool, IN mTask *pTask)
+{
+  mFUNCTION_SETUP();
+
+  // The first time a task is enqueued it might still be waiting for dependencies. The last dependency to complete will enqueue it again.
+  if (!pTask->hasBeenEnqueued.exchange(true))
+  {
+    pTask->pThreadPool = pThreadPool;
+
+    if (--pTask->pendingDependencyCount != 0)
+      mRETURN_SUCCESS();
+  }
+
+  // Tasks spawned by a worker thread of this pool are pushed to the worker's own deque.
+  if (pThreadPool->mode == mTP_M_WorkStealing && mThreadPool_pCurrentThreadPool == pThreadPool)
+  {
+    ++pTask->referenceCount;
+    mDEFER_ON_ERROR(--pTask->referenceCount);
+
+    mERROR_CHECK(mThreadPool_TaskDeque_Push_Internal(&pThreadPool->pDeques[mThreadPool_CurrentWorkerIndex], pTask));
+
+    if (pThreadPool->idleThreadCount.load(std::memory_order_relaxed) > 0)
+      mERROR_CHECK(mSemaphore_WakeOne(pThreadPool->pSemaphore));
+
+    mRETURN_SUCCESS();
+  }
+
+  // Enqueue task.
+  {
+    mERROR_CHECK(mSemaphore_Lock(pThreadPool->pSemaphore));
+    mDEFER_CALL(pThreadPool->pSemaphore, mSemaphore_Unlock);
+
+    ++pTask->referenceCount;
+    mDEFER_ON_ERROR(--pTask->referenceCount);
+
+    mERROR_CHECK(mQueue_PushBack(pThreadPool->queue, pTask));
+    ++pThreadPool->queuedTaskCount;
+  }
+
+  mERROR_CHECK(mSemaphore_WakeOne(pThreadPool->pSemaphore));
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mThreadPool_ClearDeques_Internal, mThreadPool *pThreadPool)
+{
+  mFUNCTION_SETUP();
+
+  if (pThreadPool->pDeques == nullptr)
+    mRETURN_SUCCESS();
+
+  for (size_t i = 0; i < pThreadPool->threadCount; ++i)
+  {
+    mThreadPool_TaskDeque *pDeque = &pThreadPool->pDeques[i];
+
+    if (pDeque->pBuffer.load() == nullptr)
+      continue;
+
+    // Stealing is safe from any thread. A failed steal can only be caused by a concurrent take or steal, so retry until the deque is empty.
+    while (pDeque->top.load() < pDeque->bottom.load())
+    {
+      mTask *pTask = mThreadPool_TaskDeque_Steal_Internal(pDeque);
+
+      if (pTask != nullptr)
+        mERROR_CHECK(mTask_Destroy(&pTask));
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+static mTask * mThreadPool_PopSharedQueue_Internal(mThreadPool *pThreadPool)
+{
+  if (pThreadPool->queuedTaskCount.load(std::memory_order_relaxed) == 0)
+    return nullptr;
+
+  mTask *pTask = nullptr;
+
+  mASSERT(mSUCCEEDED(mSemaphore_Lock(pThreadPool->pSemaphore)), "Error in " __FUNCTION__ ": Semaphore error.");
+  mDEFER_CALL(pThreadPool->pSemaphore, mSemaphore_Unlock);
+
+  size_t count = 0;
+  mASSERT(mSUCCEEDED(mQueue_GetCount(pThreadPool->queue, &count)), "Error in " __FUNCTION__ ": Could not get task queue length.");
+
+  if (count > 0)
+  {
+    mASSERT(mSUCCEEDED(mQueue_PopFront(pThreadPool->queue, &pTask)), "Error in " __FUNCTION__ ": Could not dequeue task.");
+    --pThreadPool->queuedTaskCount;
+  }
+
+  return pTask;
+}
+
+static mTask * mThreadPool_Steal_Internal(mThreadPool *pThreadPool)
+{
+  if (mThreadPool_RandomState == 0)
+    mThreadPool_RandomState = mRnd() | 1;
+
+  // xorshift64 is plenty random for picking victims.
+  mThreadPool_RandomState ^= mThreadPool_RandomState << 13;
+  mThreadPool_RandomState ^= mThreadPool_RandomState >> 7;
+  mThreadPool_RandomState ^= mThreadPool_RandomState << 17;
+
+  const size_t firstVictim = (size_t)(mThreadPool_RandomState % pThreadPool->threadCount);
+  const bool isWorker = (mThreadPool_pCurrentThreadPool == pThreadPool);
+
+  for (size_t i = 0; i < pThreadPool->threadCount; ++i)
+  {
+    const size_t victim = (firstVictim + i) % pThreadPool->threadCount;
+
+    if (isWorker && victim == mThreadPool_CurrentWorkerIndex)
+      continue;
+
+    mTask *pTask = mThreadPool_TaskDeque_Steal_Internal(&pThreadPool->pDeques[victim]);
+
+    if (pTask != nullptr)
+      return pTask;
+  }
+
+  return nullptr;
+}
+
+static bool mThreadPool_TryExecuteTask_Internal(mThreadPool *pThreadPool)
+{
+  mTask *pTask = nullptr;
+
+  const bool isWorkStealing = (pThreadPool->mode == mTP_M_WorkStealing);
+
+  if (isWorkStealing && mThreadPool_pCurrentThreadPool == pThreadPool)
+    pTask = mThreadPool_TaskDeque_Take_Internal(&pThreadPool->pDeques[mThreadPool_CurrentWorkerIndex]);
+
+  if (pTask == nullptr)
+    pTask = mThreadPool_PopSharedQueue_Internal(pThreadPool);
+
+  if (pTask == nullptr && isWorkStealing)
+    pTask = mThreadPool_Steal_Internal(pThreadPool);
+
+  if (pTask == nullptr)
+    return false;
+
+  mASSERT(mSUCCEEDED(mTask_Execute(pTask)), "Error in " __FUNCTION__ ": Failed to execute task.");
+  mASSERT(mSUCCEEDED(mTask_Destroy(&pTask)), "Error in " __FUNCTION__ ": Failed to destroy task.");
+
+  return true;
+}
+
+static void mThreadPool_ParallelFor_Internal(mThreadPool_ParallelForState *pState, size_t chunkStart, size_t chunkEnd)
+{
+  // Split off the upper half until the chunk is small enough, so that idle workers steal large ranges first.
+  while (chunkEnd - chunkStart > pState->grainSize && pState->result.load(std::memory_order_relaxed) == mR_Success)
+  {
+    const size_t chunkMiddle = chunkStart + (chunkEnd - chunkStart) / 2;
+    const size_t splitEnd = chunkEnd;
+
+    mTask *pTask = nullptr;
+
+    if (mFAILED(mSILENCE_ERROR(mTask_CreateWithLambda_Internal(&pTask, pState->pThreadPool->pAllocator, [pState, chunkMiddle, splitEnd]() { mThreadPool_ParallelFor_Internal(pState, chunkMiddle, splitEnd); return mR_Success; }, false))))
+      break; // Just process the remaining range on this thread.
+
+    pTask->pParallelForState = pState;
+    pTask->parallelForChunkSize = splitEnd - chunkMiddle;
+
+    const mResult result = mSILENCE_ERROR(mThreadPool_EnqueueTask_Internal(pState->pThreadPool, pTask));
+
+    // The task hasn't been enqueued, so the range will be processed on this thread.
+    if (mFAILED(result))
+      pTask->pParallelForState = nullptr;
+
+    mTask_Destroy(&pTask);
+
+    if (mFAILED(result))
+      break;
+
+    chunkEnd = chunkMiddle;
+  }
+
+  if (pState->result.load(std::memory_order_relaxed) == mR_Success)
+  {
+    const mResult result = (*pState->pFunction)(chunkStart, chunkEnd);
+
+    if (mFAILED(result))
+    {
+      mResult expected = mR_Success;
+      pState->result.compare_exchange_strong(expected, result);
+    }
+  }
+
+  // This has to be the last access to `pState`, as the caller of `mThreadPool_ParallelFor` returns once all chunks are done.
+  pState->remainingCount -= (chunkEnd - chunkStart);
+}
+
+static void mTask_DiscardParallelForChunk_Internal(IN mTask *pTask)
+{
+  mThreadPool_ParallelForState *pState = pTask->pParallelForState;
+  pTask->pParallelForState = nullptr;
+
+  mResult expected = mR_Success;
+  pState->result.compare_exchange_strong(expected, mR_ResourceStateInvalid);
+
+  // This has to be the last access to `pState`, as the caller of `mThreadPool_ParallelFor` returns once all chunks are done.
+  pState->remainingCount -= pTask->parallelForChunkSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mFUNCTION(mThreadPool_TaskDeque_Create_Internal, IN mThreadPool_TaskDeque *pDeque, IN OPTIONAL mAllocator *pAllocator)
+{
+  mFUNCTION_SETUP();
+
+  pDeque->pAllocator = pAllocator;
+
+  new (&pDeque->top) std::atomic<int64_t>(0);
+  new (&pDeque->bottom) std::atomic<int64_t>(0);
+  new (&pDeque->pBuffer) std::atomic<mThreadPool_TaskDequeBuffer *>(nullptr);
+
+  mThreadPool_TaskDequeBuffer *pBuffer = nullptr;
+  mERROR_CHECK(mThreadPool_TaskDequeBuffer_Create_Internal(&pBuffer, pAllocator, mThreadPool_TaskDeque_InitialCapacity));
+
+  pDeque->pBuffer = pBuffer;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mThreadPool_TaskDeque_Destroy_Internal, IN mThreadPool_TaskDeque *pDeque)
+{
+  mFUNCTION_SETUP();
+
+  mThreadPool_TaskDequeBuffer *pBuffer = pDeque->pBuffer.load();
+
+  while (pBuffer != nullptr)
+  {
+    mThreadPool_TaskDequeBuffer *pPrevious = pBuffer->pPrevious;
+
+    mERROR_CHECK(mAllocator_FreePtr(pDeque->pAllocator, &pBuffer->pTasks));
+    mERROR_CHECK(mAllocator_FreePtr(pDeque->pAllocator, &pBuffer));
+
+    pBuffer = pPrevious;
+  }
+
+  pDeque->pBuffer = nullptr;
+
+  mRETURN_SUCCESS();
+}
+
+static mFUNCTION(mThreadPool_TaskDeque_Push_Internal, IN mThreadPool_TaskDeque *pDeque, IN mTask *pTask)
+{
+  mFUNCTION_SETUP();
+
+  const int64_t bottom = pDeque->bottom.load(std::memory_order_relaxed);
+  const int64_t top = pDeque->top.load(std::memory_order_acquire);
+  mThreadPool_TaskDequeBuffer *pBuffer = pDeque->pBuffer.load(std::memory_order_relaxed);
+
+  if (bottom - top > (int64_t)pBuffer->capacityMask)
+  {
+    mThreadPool_TaskDequeBuffer *pGrownBuffer = nullptr;
+    mERROR_CHECK(mThreadPool_TaskDequeBuffer_Create_Internal(&pGrownBuffer, pDeque->pAllocator, (pBuffer->capacityMask + 1) * 2));
+
+    for (int64_t i = top; i < bottom; i++)
+      pGrownBuffer->pTasks[(size_t)i & pGrownBuffer->capacityMask].store(pBuffer->pTasks[(size_t)i & pBuffer->capacityMask].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    pGrownBuffer->pPrevious = pBuffer;
+    pDeque->pBuffer.store(pGrownBuffer, std::memory_order_release);
+    pBuffer = pGrownBuffer;
+  }
+
+  pBuffer->pTasks[(size_t)bottom & pBuffer->capacityMask].store(pTask, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  pDeque->bottom.store(bottom + 1, std::memory_order_relaxed);
+
+  mRETURN_SUCCESS();
+}
+
+static mTask * mThreadPool_TaskDeque_Take_Internal(IN mThreadPool_TaskDeque *pDeque)
+{
+  const int64_t bottom = pDeque->bottom.load(std::memory_order_relaxed) - 1;
+  mThreadPool_TaskDequeBuffer *pBuffer = pDeque->pBuffer.load(std::memory_order_relaxed);
+  pDeque->bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = pDeque->top.load(std::memory_order_relaxed);
+
+  if (top > bottom)
+  {
+    pDeque->bottom.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  mTask *pTask = pBuffer->pTasks[(size_t)bottom & pBuffer->capacityMask].load(std::memory_order_relaxed);
+
+  // Last remaining task: race against thieves.
+  if (top == bottom)
+  {
+    if (!pDeque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      pTask = nullptr;
+
+    pDeque->bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  return pTask;
+}
+
+static mTask * mThreadPool_TaskDeque_Steal_Internal(IN mThreadPool_TaskDeque *pDeque)
+{
+  int64_t top = pDeque->top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = pDeque->bottom.load(std::memory_order_acquire);
+
+  if (top >= bottom)
+    return nullptr;
+
+  mThreadPool_TaskDequeBuffer *pBuffer = pDeque->pBuffer.load(std::memory_order_acquire);
+  mTask *pTask = pBuffer->pTasks[(size_t)top & pBuffer->capacityMask].load(std::memory_order_relaxed);
+
+  if (!pDeque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    return nullptr; // Lost the race against the owner or another thief.
+
+  return pTask;
+}
+
+static mFUNCTION(mThreadPool_TaskDequeBuffer_Create_Internal, OUT mThreadPool_TaskDequeBuffer **ppBuffer, IN OPTIONAL mAllocator *pAllocator, const size_t capacity)
+{
+  mFUNCTION_SETUP();
+
+  mDEFER_CALL_ON_ERROR(ppBuffer, mSetToNullptr);
+  mDEFER_ON_ERROR(mAllocator_FreePtr(pAllocator, ppBuffer));
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, ppBuffer, 1));
+
+  mERROR_CHECK(mAllocator_AllocateZero(pAllocator, &(*ppBuffer)->pTasks, capacity));
+
+  for (size_t i = 0; i < capacity; i++)
+    new (&(*ppBuffer)->pTasks[i]) std::atomic<mTask *>(nullptr);
+
+  (*ppBuffer)->capacityMask = capacity - 1;
+
   mRETURN_SUCCESS();
 }
 
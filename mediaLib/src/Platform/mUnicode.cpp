@@ -0,0 +1,777 @@
+#include "mUnicode.h"
+
+#ifdef _MSC_VER
+ #include <intrin.h>
+#else
+ #include <x86intrin.h>
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4752)
+#endif
+
+#ifdef GIT_BUILD // Define __M_FILE__
+  #ifdef __M_FILE__
+    #undef __M_FILE__
+  #endif
+  #define __M_FILE__ "L5AUrx9S530E/z/yjVEPw9BuMBiYjOCsExKpt4Cp7DF2zLSDTQw6Iou7CgwLM8lY/bvcSLS6Xk66RR4D"
+#endif
+
+constexpr uint32_t mUnicode_ReplacementCharacter = 0xFFFD;
+
+struct mUnicode_CpuSupport
+{
+  bool avx2;
+  bool sse41;
+};
+
+// The supported instruction sets can't change while running, so they're only detected for the first conversion.
+static const mUnicode_CpuSupport & mUnicode_GetCpuSupport_Internal()
+{
+  static const mUnicode_CpuSupport cpuSupport = []()
+  {
+    mCpuExtensions::Detect();
+
+    mUnicode_CpuSupport support;
+    support.avx2 = mCpuExtensions::avx2Supported;
+    support.sse41 = mCpuExtensions::sse41Supported;
+
+    return support;
+  }();
+
+  return cpuSupport;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static mINLINE bool mUtf8_Decode_Internal(IN const uint8_t *pText, const size_t bytes, IN_OUT size_t &offset, OUT uint32_t *pCodePoint)
+{
+  const uint8_t lead = pText[offset];
+
+  if (lead < 0x80)
+  {
+    *pCodePoint = lead;
+    offset++;
+    return true;
+  }
+
+  size_t length;
+  uint32_t codePoint;
+  uint32_t minimum;
+
+  if ((lead & 0xE0) == 0xC0)
+  {
+    length = 2;
+    codePoint = lead & 0x1F;
+    minimum = 0x80;
+  }
+  else if ((lead & 0xF0) == 0xE0)
+  {
+    length = 3;
+    codePoint = lead & 0x0F;
+    minimum = 0x800;
+  }
+  else if ((lead & 0xF8) == 0xF0)
+  {
+    length = 4;
+    codePoint = lead & 0x07;
+    minimum = 0x10000;
+  }
+  else
+  {
+    return false;
+  }
+
+  if (bytes - offset < length)
+    return false;
+
+  for (size_t i = 1; i < length; i++)
+  {
+    const uint8_t continuation = pText[offset + i];
+
+    if ((continuation & 0xC0) != 0x80)
+      return false;
+
+    codePoint = (codePoint << 6) | (continuation & 0x3F);
+  }
+
+  if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+    return false;
+
+  *pCodePoint = codePoint;
+  offset += length;
+
+  return true;
+}
+
+// Returns the number of bytes written or zero if `capacity` is insufficient.
+static mINLINE size_t mUtf8_Encode_Internal(const uint32_t codePoint, OUT uint8_t *pUtf8, const size_t capacity)
+{
+  if (codePoint < 0x80)
+  {
+    if (capacity < 1)
+      return 0;
+
+    pUtf8[0] = (uint8_t)codePoint;
+
+    return 1;
+  }
+  else if (codePoint < 0x800)
+  {
+    if (capacity < 2)
+      return 0;
+
+    pUtf8[0] = (uint8_t)(0xC0 | (codePoint >> 6));
+    pUtf8[1] = (uint8_t)(0x80 | (codePoint & 0x3F));
+
+    return 2;
+  }
+  else if (codePoint < 0x10000)
+  {
+    if (capacity < 3)
+      return 0;
+
+    pUtf8[0] = (uint8_t)(0xE0 | (codePoint >> 12));
+    pUtf8[1] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+    pUtf8[2] = (uint8_t)(0x80 | (codePoint & 0x3F));
+
+    return 3;
+  }
+  else
+  {
+    if (capacity < 4)
+      return 0;
+
+    pUtf8[0] = (uint8_t)(0xF0 | (codePoint >> 18));
+    pUtf8[1] = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+    pUtf8[2] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+    pUtf8[3] = (uint8_t)(0x80 | (codePoint & 0x3F));
+
+    return 4;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// The vectorised validation classifies every pair of adjacent bytes by the high nibble of the first byte, the low nibble of the first byte and the high nibble of the second byte.
+// Each table lookup yields the set of errors the pair could be part of, so a pair is invalid if all three lookups share an error bit.
+// See "Validating UTF-8 In Less Than One Instruction Per Byte" (Keiser, Lemire).
+
+constexpr uint8_t mUtf8_TooShort = 1 << 0; // A lead byte isn't followed by a continuation byte.
+constexpr uint8_t mUtf8_TooLong = 1 << 1; // An ascii character is followed by a continuation byte.
+constexpr uint8_t mUtf8_Overlong3 = 1 << 2;
+constexpr uint8_t mUtf8_TooLarge = 1 << 3;
+constexpr uint8_t mUtf8_Surrogate = 1 << 4;
+constexpr uint8_t mUtf8_Overlong2 = 1 << 5;
+constexpr uint8_t mUtf8_TooLarge1000 = 1 << 6;
+constexpr uint8_t mUtf8_Overlong4 = 1 << 6;
+constexpr uint8_t mUtf8_TwoContinuations = 1 << 7; // Only valid in the third and fourth byte of a character.
+constexpr uint8_t mUtf8_Carry = mUtf8_TooShort | mUtf8_TooLong | mUtf8_TwoContinuations;
+
+alignas(16) static const uint8_t mUtf8_Byte1HighTable[16] =
+{
+  mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, mUtf8_TooLong, // 0___
+  mUtf8_TwoContinuations, mUtf8_TwoContinuations, mUtf8_TwoContinuations, mUtf8_TwoContinuations, // 10__
+  mUtf8_TooShort | mUtf8_Overlong2, // 1100
+  mUtf8_TooShort, // 1101
+  mUtf8_TooShort | mUtf8_Overlong3 | mUtf8_Surrogate, // 1110
+  mUtf8_TooShort | mUtf8_TooLarge | mUtf8_TooLarge1000 | mUtf8_Overlong4, // 1111
+};
+
+alignas(16) static const uint8_t mUtf8_Byte1LowTable[16] =
+{
+  mUtf8_Carry | mUtf8_Overlong3 | mUtf8_Overlong2 | mUtf8_Overlong4, // 0000
+  mUtf8_Carry | mUtf8_Overlong2, // 0001
+  mUtf8_Carry, // 0010
+  mUtf8_Carry, // 0011
+  mUtf8_Carry | mUtf8_TooLarge, // 0100
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 0101
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 0110
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 0111
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1000
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1001
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1010
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1011
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1100
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000 | mUtf8_Surrogate, // 1101
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1110
+  mUtf8_Carry | mUtf8_TooLarge | mUtf8_TooLarge1000, // 1111
+};
+
+alignas(16) static const uint8_t mUtf8_Byte2HighTable[16] =
+{
+  mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, // 0___
+  mUtf8_TooLong | mUtf8_Overlong2 | mUtf8_TwoContinuations | mUtf8_Overlong3 | mUtf8_TooLarge1000 | mUtf8_Overlong4, // 1000
+  mUtf8_TooLong | mUtf8_Overlong2 | mUtf8_TwoContinuations | mUtf8_Overlong3 | mUtf8_TooLarge, // 1001
+  mUtf8_TooLong | mUtf8_Overlong2 | mUtf8_TwoContinuations | mUtf8_Surrogate | mUtf8_TooLarge, // 1010
+  mUtf8_TooLong | mUtf8_Overlong2 | mUtf8_TwoContinuations | mUtf8_Surrogate | mUtf8_TooLarge, // 1011
+  mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, mUtf8_TooShort, // 11__
+};
+
+// The last three bytes of a block mustn't start a character that's longer than the remaining bytes.
+alignas(32) static const uint8_t mUtf8_IncompleteMax[32] =
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+#ifndef _MSC_VER
+__attribute__((target("sse4.1")))
+#endif
+static bool mUtf8_Validate_SSE41(IN const uint8_t *pText, const size_t bytes, IN_OUT size_t &offset, IN_OUT size_t &codePointCount, IN_OUT size_t &fourByteCount)
+{
+  const __m128i byte1HighTable = _mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte1HighTable));
+  const __m128i byte1LowTable = _mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte1LowTable));
+  const __m128i byte2HighTable = _mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte2HighTable));
+  const __m128i incompleteMax = _mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_IncompleteMax + 16));
+  const __m128i lowNibbleMask = _mm_set1_epi8(0x0F);
+  const __m128i thirdByteThreshold = _mm_set1_epi8((char)(0xE0 - 0x80));
+  const __m128i fourthByteThreshold = _mm_set1_epi8((char)(0xF0 - 0x80));
+  const __m128i highBit = _mm_set1_epi8((char)0x80);
+  const __m128i maxContinuation = _mm_set1_epi8((char)0xBF);
+  const __m128i minFourByteLead = _mm_set1_epi8((char)0xF0);
+
+  __m128i error = _mm_setzero_si128();
+  __m128i previousInput = _mm_setzero_si128();
+  __m128i previousIncomplete = _mm_setzero_si128();
+
+  // Per-byte counters, which are summed up before they can overflow.
+  __m128i codePointCounter = _mm_setzero_si128();
+  __m128i fourByteCounter = _mm_setzero_si128();
+  size_t counterIterations = 0;
+
+  for (; offset + sizeof(__m128i) <= bytes; offset += sizeof(__m128i))
+  {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + offset));
+
+    if (_mm_movemask_epi8(input) == 0)
+    {
+      error = _mm_or_si128(error, previousIncomplete);
+      previousIncomplete = _mm_setzero_si128();
+    }
+    else
+    {
+      const __m128i previous1 = _mm_alignr_epi8(input, previousInput, 16 - 1);
+      const __m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(previous1, 4), lowNibbleMask));
+      const __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(previous1, lowNibbleMask));
+      const __m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibbleMask));
+      const __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+      const __m128i previous2 = _mm_alignr_epi8(input, previousInput, 16 - 2);
+      const __m128i previous3 = _mm_alignr_epi8(input, previousInput, 16 - 3);
+      const __m128i isThirdByte = _mm_subs_epu8(previous2, thirdByteThreshold);
+      const __m128i isFourthByte = _mm_subs_epu8(previous3, fourthByteThreshold);
+      const __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), highBit);
+
+      error = _mm_or_si128(error, _mm_xor_si128(mustBeContinuation, specialCases));
+      previousIncomplete = _mm_subs_epu8(input, incompleteMax);
+    }
+
+    previousInput = input;
+
+    // Every byte that isn't a continuation byte starts a code point.
+    codePointCounter = _mm_sub_epi8(codePointCounter, _mm_cmpgt_epi8(input, maxContinuation));
+    fourByteCounter = _mm_sub_epi8(fourByteCounter, _mm_cmpeq_epi8(_mm_max_epu8(input, minFourByteLead), input));
+
+    if (++counterIterations == UINT8_MAX)
+    {
+      const __m128i codePointSum = _mm_sad_epu8(codePointCounter, _mm_setzero_si128());
+      const __m128i fourByteSum = _mm_sad_epu8(fourByteCounter, _mm_setzero_si128());
+
+      codePointCount += (size_t)(_mm_cvtsi128_si64(codePointSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(codePointSum, codePointSum)));
+      fourByteCount += (size_t)(_mm_cvtsi128_si64(fourByteSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(fourByteSum, fourByteSum)));
+
+      codePointCounter = _mm_setzero_si128();
+      fourByteCounter = _mm_setzero_si128();
+      counterIterations = 0;
+    }
+  }
+
+  const __m128i codePointSum = _mm_sad_epu8(codePointCounter, _mm_setzero_si128());
+  const __m128i fourByteSum = _mm_sad_epu8(fourByteCounter, _mm_setzero_si128());
+
+  codePointCount += (size_t)(_mm_cvtsi128_si64(codePointSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(codePointSum, codePointSum)));
+  fourByteCount += (size_t)(_mm_cvtsi128_si64(fourByteSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(fourByteSum, fourByteSum)));
+
+  // `previousIncomplete` of the last block is checked by the caller.
+  return _mm_testz_si128(error, error) != 0;
+}
+
+#ifndef _MSC_VER
+__attribute__((target("avx2")))
+#endif
+static bool mUtf8_Validate_AVX2(IN const uint8_t *pText, const size_t bytes, IN_OUT size_t &offset, IN_OUT size_t &codePointCount, IN_OUT size_t &fourByteCount)
+{
+  const __m256i byte1HighTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte1HighTable)));
+  const __m256i byte1LowTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte1LowTable)));
+  const __m256i byte2HighTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(mUtf8_Byte2HighTable)));
+  const __m256i incompleteMax = _mm256_load_si256(reinterpret_cast<const __m256i *>(mUtf8_IncompleteMax));
+  const __m256i lowNibbleMask = _mm256_set1_epi8(0x0F);
+  const __m256i thirdByteThreshold = _mm256_set1_epi8((char)(0xE0 - 0x80));
+  const __m256i fourthByteThreshold = _mm256_set1_epi8((char)(0xF0 - 0x80));
+  const __m256i highBit = _mm256_set1_epi8((char)0x80);
+  const __m256i maxContinuation = _mm256_set1_epi8((char)0xBF);
+  const __m256i minFourByteLead = _mm256_set1_epi8((char)0xF0);
+
+  __m256i error = _mm256_setzero_si256();
+  __m256i previousInput = _mm256_setzero_si256();
+  __m256i previousIncomplete = _mm256_setzero_si256();
+
+  // Per-byte counters, which are summed up before they can overflow.
+  __m256i codePointCounter = _mm256_setzero_si256();
+  __m256i fourByteCounter = _mm256_setzero_si256();
+  size_t counterIterations = 0;
+
+  for (; offset + sizeof(__m256i) <= bytes; offset += sizeof(__m256i))
+  {
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pText + offset));
+
+    if (_mm256_movemask_epi8(input) == 0)
+    {
+      error = _mm256_or_si256(error, previousIncomplete);
+      previousIncomplete = _mm256_setzero_si256();
+    }
+    else
+    {
+      // `_mm256_alignr_epi8` works on 128 bit lanes, so the lane before the current one has to be assembled first.
+      const __m256i previousLanes = _mm256_permute2x128_si256(previousInput, input, 0x21);
+
+      const __m256i previous1 = _mm256_alignr_epi8(input, previousLanes, 16 - 1);
+      const __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), lowNibbleMask));
+      const __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(previous1, lowNibbleMask));
+      const __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibbleMask));
+      const __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+      const __m256i previous2 = _mm256_alignr_epi8(input, previousLanes, 16 - 2);
+      const __m256i previous3 = _mm256_alignr_epi8(input, previousLanes, 16 - 3);
+      const __m256i isThirdByte = _mm256_subs_epu8(previous2, thirdByteThreshold);
+      const __m256i isFourthByte = _mm256_subs_epu8(previous3, fourthByteThreshold);
+      const __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte), highBit);
+
+      error = _mm256_or_si256(error, _mm256_xor_si256(mustBeContinuation, specialCases));
+      previousIncomplete = _mm256_subs_epu8(input, incompleteMax);
+    }
+
+    previousInput = input;
+
+    // Every byte that isn't a continuation byte starts a code point.
+    codePointCounter = _mm256_sub_epi8(codePointCounter, _mm256_cmpgt_epi8(input, maxContinuation));
+    fourByteCounter = _mm256_sub_epi8(fourByteCounter, _mm256_cmpeq_epi8(_mm256_max_epu8(input, minFourByteLead), input));
+
+    if (++counterIterations == UINT8_MAX || offset + 2 * sizeof(__m256i) > bytes)
+    {
+      const __m256i codePointSum256 = _mm256_sad_epu8(codePointCounter, _mm256_setzero_si256());
+      const __m256i fourByteSum256 = _mm256_sad_epu8(fourByteCounter, _mm256_setzero_si256());
+      const __m128i codePointSum = _mm_add_epi64(_mm256_castsi256_si128(codePointSum256), _mm256_extracti128_si256(codePointSum256, 1));
+      const __m128i fourByteSum = _mm_add_epi64(_mm256_castsi256_si128(fourByteSum256), _mm256_extracti128_si256(fourByteSum256, 1));
+
+      codePointCount += (size_t)(_mm_cvtsi128_si64(codePointSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(codePointSum, codePointSum)));
+      fourByteCount += (size_t)(_mm_cvtsi128_si64(fourByteSum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(fourByteSum, fourByteSum)));
+
+      codePointCounter = _mm256_setzero_si256();
+      fourByteCounter = _mm256_setzero_si256();
+      counterIterations = 0;
+    }
+  }
+
+  // `previousIncomplete` of the last block is checked by the caller.
+  return _mm256_testz_si256(error, error) != 0;
+}
+
+static bool mUtf8_Validate_Internal(IN const uint8_t *pText, const size_t bytes, OUT size_t *pCodePointCount, OUT size_t *pFourByteCount)
+{
+  size_t offset = 0;
+  size_t codePointCount = 0;
+  size_t fourByteCount = 0;
+
+  const mUnicode_CpuSupport &cpuSupport = mUnicode_GetCpuSupport_Internal();
+
+  if (cpuSupport.avx2)
+  {
+    if (!mUtf8_Validate_AVX2(pText, bytes, offset, codePointCount, fourByteCount))
+      return false;
+  }
+  else if (cpuSupport.sse41)
+  {
+    if (!mUtf8_Validate_SSE41(pText, bytes, offset, codePointCount, fourByteCount))
+      return false;
+  }
+
+  // The last character of the vectorised blocks may continue past them, so the remaining bytes are validated starting at its lead byte.
+  // Characters that start before `offset` have already been counted.
+  size_t characterStart = offset;
+
+  for (size_t i = 1; i <= 3 && i <= offset; i++)
+  {
+    const uint8_t byte = pText[offset - i];
+
+    if (byte < 0x80)
+      break;
+
+    if (byte >= 0xC0)
+    {
+      characterStart = offset - i;
+      break;
+    }
+  }
+
+  while (characterStart < bytes)
+  {
+    const size_t start = characterStart;
+    uint32_t codePoint;
+
+    if (!mUtf8_Decode_Internal(pText, bytes, characterStart, &codePoint))
+      return false;
+
+    if (start >= offset)
+    {
+      codePointCount++;
+      fourByteCount += (characterStart - start == 4);
+    }
+  }
+
+  *pCodePointCount = codePointCount;
+  *pFourByteCount = fourByteCount;
+
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+#ifndef _MSC_VER
+__attribute__((target("sse4.1")))
+#endif
+static void mUtf8_WidenAscii_SSE41(IN const uint8_t *pText, const size_t bytes, IN_OUT size_t &offset, OUT T *pOut, const size_t capacity, IN_OUT size_t &count)
+{
+  while (offset + sizeof(__m128i) <= bytes && count + sizeof(__m128i) <= capacity)
+  {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pText + offset));
+
+    if (_mm_movemask_epi8(input) != 0)
+      break;
+
+    __m128i *pTarget = reinterpret_cast<__m128i *>(pOut + count);
+
+    mIF_CONSTEXPR (sizeof(T) == sizeof(uint16_t))
+    {
+      _mm_storeu_si128(pTarget, _mm_cvtepu8_epi16(input));
+      _mm_storeu_si128(pTarget + 1, _mm_cvtepu8_epi16(_mm_srli_si128(input, 8)));
+    }
+    else
+    {
+      _mm_storeu_si128(pTarget, _mm_cvtepu8_epi32(input));
+      _mm_storeu_si128(pTarget + 1, _mm_cvtepu8_epi32(_mm_srli_si128(input, 4)));
+      _mm_storeu_si128(pTarget + 2, _mm_cvtepu8_epi32(_mm_srli_si128(input, 8)));
+      _mm_storeu_si128(pTarget + 3, _mm_cvtepu8_epi32(_mm_srli_si128(input, 12)));
+    }
+
+    offset += sizeof(__m128i);
+    count += sizeof(__m128i);
+  }
+}
+
+template <typename T>
+#ifndef _MSC_VER
+__attribute__((target("avx2")))
+#endif
+static void mUtf8_WidenAscii_AVX2(IN const uint8_t *pText, const size_t bytes, IN_OUT size_t &offset, OUT T *pOut, const size_t capacity, IN_OUT size_t &count)
+{
+  while (offset + sizeof(__m256i) <= bytes && count + sizeof(__m256i) <= capacity)
+  {
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pText + offset));
+
+    if (_mm256_movemask_epi8(input) != 0)
+      break;
+
+    const __m128i low = _mm256_castsi256_si128(input);
+    const __m128i high = _mm256_extracti128_si256(input, 1);
+    __m256i *pTarget = reinterpret_cast<__m256i *>(pOut + count);
+
+    mIF_CONSTEXPR (sizeof(T) == sizeof(uint16_t))
+    {
+      _mm256_storeu_si256(pTarget, _mm256_cvtepu8_epi16(low));
+      _mm256_storeu_si256(pTarget + 1, _mm256_cvtepu8_epi16(high));
+    }
+    else
+    {
+      _mm256_storeu_si256(pTarget, _mm256_cvtepu8_epi32(low));
+      _mm256_storeu_si256(pTarget + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+      _mm256_storeu_si256(pTarget + 2, _mm256_cvtepu8_epi32(high));
+      _mm256_storeu_si256(pTarget + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+    }
+
+    offset += sizeof(__m256i);
+    count += sizeof(__m256i);
+  }
+}
+
+template <typename T>
+#ifndef _MSC_VER
+__attribute__((target("sse4.1")))
+#endif
+static void mUtf8_NarrowAscii_SSE41(IN const T *pText, const size_t count, IN_OUT size_t &index, OUT uint8_t *pUtf8, const size_t capacity, IN_OUT size_t &bytes)
+{
+  constexpr size_t blockSize = sizeof(__m128i);
+
+  while (index + blockSize <= count && bytes + blockSize <= capacity)
+  {
+    const __m128i *pSource = reinterpret_cast<const __m128i *>(pText + index);
+    __m128i packed;
+
+    mIF_CONSTEXPR (sizeof(T) == sizeof(uint16_t))
+    {
+      const __m128i a = _mm_loadu_si128(pSource);
+      const __m128i b = _mm_loadu_si128(pSource + 1);
+
+      if (!_mm_testz_si128(_mm_or_si128(a, b), _mm_set1_epi16((int16_t)0xFF80)))
+        break;
+
+      packed = _mm_packus_epi16(a, b);
+    }
+    else
+    {
+      const __m128i a = _mm_loadu_si128(pSource);
+      const __m128i b = _mm_loadu_si128(pSource + 1);
+      const __m128i c = _mm_loadu_si128(pSource + 2);
+      const __m128i d = _mm_loadu_si128(pSource + 3);
+
+      if (!_mm_testz_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32((int32_t)0xFFFFFF80)))
+        break;
+
+      packed = _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pUtf8 + bytes), packed);
+
+    index += blockSize;
+    bytes += blockSize;
+  }
+}
+
+template <typename T>
+static mFUNCTION(mUtf8_ToUtfN_Internal, IN const char *pUtf8, const size_t bytes, OUT T *pOut, const size_t capacity, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF((pUtf8 == nullptr && bytes > 0) || pOut == nullptr || pCount == nullptr, mR_ArgumentNull);
+
+  const uint8_t *pText = reinterpret_cast<const uint8_t *>(pUtf8);
+  size_t offset = 0;
+  size_t count = 0;
+
+  const bool avx2 = mUnicode_GetCpuSupport_Internal().avx2;
+  const bool sse41 = mUnicode_GetCpuSupport_Internal().sse41;
+
+  while (offset < bytes)
+  {
+    // Runs of ascii characters are widened without decoding them.
+    if (pText[offset] < 0x80)
+    {
+      if (avx2)
+        mUtf8_WidenAscii_AVX2(pText, bytes, offset, pOut, capacity, count);
+      else if (sse41)
+        mUtf8_WidenAscii_SSE41(pText, bytes, offset, pOut, capacity, count);
+
+      if (offset == bytes)
+        break;
+    }
+
+    uint32_t codePoint;
+    mERROR_IF(!mUtf8_Decode_Internal(pText, bytes, offset, &codePoint), mR_InvalidParameter);
+
+    mIF_CONSTEXPR (sizeof(T) == sizeof(uint16_t))
+    {
+      if (codePoint < 0x10000)
+      {
+        mERROR_IF(count >= capacity, mR_IndexOutOfBounds);
+        pOut[count++] = (T)codePoint;
+      }
+      else
+      {
+        mERROR_IF(count + 2 > capacity, mR_IndexOutOfBounds);
+
+        const uint32_t offsetCodePoint = codePoint - 0x10000;
+        pOut[count++] = (T)(0xD800 | (offsetCodePoint >> 10));
+        pOut[count++] = (T)(0xDC00 | (offsetCodePoint & 0x3FF));
+      }
+    }
+    else
+    {
+      mERROR_IF(count >= capacity, mR_IndexOutOfBounds);
+      pOut[count++] = (T)codePoint;
+    }
+  }
+
+  *pCount = count;
+
+  mRETURN_SUCCESS();
+}
+
+template <typename T>
+static mFUNCTION(mUtfN_ToUtf8_Internal, IN const T *pText, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount, const bool replaceInvalid)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF((pText == nullptr && count > 0) || pUtf8 == nullptr || pBytes == nullptr, mR_ArgumentNull);
+
+  uint8_t *pOut = reinterpret_cast<uint8_t *>(pUtf8);
+  size_t index = 0;
+  size_t bytes = 0;
+  size_t codePointCount = 0;
+
+  const bool sse41 = mUnicode_GetCpuSupport_Internal().sse41;
+
+  while (index < count)
+  {
+    uint32_t codePoint = (uint32_t)pText[index];
+
+    // Runs of ascii characters are narrowed without encoding them.
+    if (codePoint < 0x80 && sse41)
+    {
+      const size_t previousIndex = index;
+      mUtf8_NarrowAscii_SSE41(pText, count, index, pOut, capacity, bytes);
+      codePointCount += index - previousIndex;
+
+      if (index == count)
+        break;
+
+      codePoint = (uint32_t)pText[index];
+    }
+
+    mIF_CONSTEXPR (sizeof(T) == sizeof(uint16_t))
+    {
+      if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+      {
+        const uint32_t lowSurrogate = (codePoint <= 0xDBFF && index + 1 < count) ? (uint32_t)pText[index + 1] : 0;
+
+        if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF)
+        {
+          codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+          index++;
+        }
+        else
+        {
+          mERROR_IF(!replaceInvalid, mR_InvalidParameter);
+          codePoint = mUnicode_ReplacementCharacter;
+        }
+      }
+    }
+    else
+    {
+      if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+      {
+        mERROR_IF(!replaceInvalid, mR_InvalidParameter);
+        codePoint = mUnicode_ReplacementCharacter;
+      }
+    }
+
+    const size_t characterSize = mUtf8_Encode_Internal(codePoint, pOut + bytes, capacity - bytes);
+    mERROR_IF(characterSize == 0, mR_IndexOutOfBounds);
+
+    bytes += characterSize;
+    index++;
+    codePointCount++;
+  }
+
+  *pBytes = bytes;
+
+  if (pCodePointCount != nullptr)
+    *pCodePointCount = codePointCount;
+
+  mRETURN_SUCCESS();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool mUtf8_Validate(IN const char *pUtf8, const size_t bytes, OUT OPTIONAL size_t *pCodePointCount /* = nullptr */)
+{
+  if (pUtf8 == nullptr)
+    return bytes == 0;
+
+  size_t codePointCount, fourByteCount;
+
+  if (!mUtf8_Validate_Internal(reinterpret_cast<const uint8_t *>(pUtf8), bytes, &codePointCount, &fourByteCount))
+    return false;
+
+  if (pCodePointCount != nullptr)
+    *pCodePointCount = codePointCount;
+
+  return true;
+}
+
+mFUNCTION(mUtf8_GetUtf16Count, IN const char *pUtf8, const size_t bytes, OUT size_t *pCount)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF((pUtf8 == nullptr && bytes > 0) || pCount == nullptr, mR_ArgumentNull);
+
+  size_t codePointCount = 0;
+  size_t fourByteCount = 0;
+
+  if (bytes > 0)
+    mERROR_IF(!mUtf8_Validate_Internal(reinterpret_cast<const uint8_t *>(pUtf8), bytes, &codePointCount, &fourByteCount), mR_InvalidParameter);
+
+  // Code points that take four bytes in utf-8 take a surrogate pair in utf-16.
+  *pCount = codePointCount + fourByteCount;
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mUtf8_ToUtf16, IN const char *pUtf8, const size_t bytes, OUT char16_t *pUtf16, const size_t capacity, OUT size_t *pCount)
+{
+  return mUtf8_ToUtfN_Internal(pUtf8, bytes, pUtf16, capacity, pCount);
+}
+
+mFUNCTION(mUtf8_ToUtf32, IN const char *pUtf8, const size_t bytes, OUT char32_t *pUtf32, const size_t capacity, OUT size_t *pCount)
+{
+  return mUtf8_ToUtfN_Internal(pUtf8, bytes, pUtf32, capacity, pCount);
+}
+
+mFUNCTION(mUtf16_ToUtf8, IN const char16_t *pUtf16, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount /* = nullptr */)
+{
+  return mUtfN_ToUtf8_Internal(pUtf16, count, pUtf8, capacity, pBytes, pCodePointCount, false);
+}
+
+mFUNCTION(mUtf32_ToUtf8, IN const char32_t *pUtf32, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount /* = nullptr */)
+{
+  return mUtfN_ToUtf8_Internal(pUtf32, count, pUtf8, capacity, pBytes, pCodePointCount, false);
+}
+
+mFUNCTION(mUtf8_GetWideCount, IN const char *pUtf8, const size_t bytes, OUT size_t *pCount)
+{
+  mIF_CONSTEXPR (sizeof(wchar_t) == sizeof(char16_t))
+  {
+    return mUtf8_GetUtf16Count(pUtf8, bytes, pCount);
+  }
+  else
+  {
+    mFUNCTION_SETUP();
+
+    mERROR_IF((pUtf8 == nullptr && bytes > 0) || pCount == nullptr, mR_ArgumentNull);
+    mERROR_IF(!mUtf8_Validate(pUtf8, bytes, pCount), mR_InvalidParameter);
+
+    mRETURN_SUCCESS();
+  }
+}
+
+mFUNCTION(mUtf8_ToWide, IN const char *pUtf8, const size_t bytes, OUT wchar_t *pWide, const size_t capacity, OUT size_t *pCount)
+{
+  mIF_CONSTEXPR (sizeof(wchar_t) == sizeof(char16_t))
+    return mUtf8_ToUtfN_Internal(pUtf8, bytes, reinterpret_cast<char16_t *>(pWide), capacity, pCount);
+  else
+    return mUtf8_ToUtfN_Internal(pUtf8, bytes, reinterpret_cast<char32_t *>(pWide), capacity, pCount);
+}
+
+mFUNCTION(mWide_ToUtf8, IN const wchar_t *pWide, const size_t count, OUT char *pUtf8, const size_t capacity, OUT size_t *pBytes, OUT OPTIONAL size_t *pCodePointCount /* = nullptr */)
+{
+  mIF_CONSTEXPR (sizeof(wchar_t) == sizeof(char16_t))
+    return mUtfN_ToUtf8_Internal(reinterpret_cast<const char16_t *>(pWide), count, pUtf8, capacity, pBytes, pCodePointCount, true);
+  else
+    return mUtfN_ToUtf8_Internal(reinterpret_cast<const char32_t *>(pWide), count, pUtf8, capacity, pBytes, pCodePointCount, true);
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
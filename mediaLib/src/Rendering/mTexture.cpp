@@ -10,6 +10,10 @@
   #define __M_FILE__ "sCCZHpYtbeA7/BRwiLFUKpvYDoIRwlST01JVXGbKsRYc0GVHhCxSXpPO5CjBdZ5Fc933OCVeG39gHCKI"
 #endif
 
+static mFUNCTION(mTexture_UploadImagePyramid_Internal, mTexture &texture);
+
+//////////////////////////////////////////////////////////////////////////
+
 mFUNCTION(mTexture_Create, OUT mTexture *pTexture, mPtr<mImageBuffer> &imageBuffer, const bool upload /* = true */, const size_t textureUnit /* = 0 */, const mTexture2DParams &textureParams /* = mTexture2DParams() */)
 {
   mFUNCTION_SETUP();
@@ -126,6 +130,23 @@ mFUNCTION(mTexture_Create, OUT mTexture *pTexture, const uint8_t *pData, const m
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mTexture_Create, OUT mTexture *pTexture, mPtr<mImagePyramid> &imagePyramid, const bool upload /* = true */, const size_t textureUnit /* = 0 */, const mTexture2DParams &textureParams /* = mTexture2DParams() */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(pTexture == nullptr || imagePyramid == nullptr, mR_ArgumentNull);
+  mERROR_IF(imagePyramid->levelCount == 0, mR_NotInitialized);
+
+  mERROR_CHECK(mTexture_Create(pTexture, imagePyramid->pLevels[0], false, textureUnit, textureParams));
+
+  pTexture->imagePyramid = imagePyramid;
+
+  if (upload)
+    mERROR_CHECK(mTexture_Upload(*pTexture));
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mTexture_CreateFromUnownedIndex, OUT mTexture *pTexture, int textureIndex, const size_t textureUnit /* = 0 */, const size_t sampleCount /* = 0 */)
 {
   mFUNCTION_SETUP();
@@ -247,6 +268,9 @@ mFUNCTION(mTexture_Destroy, IN_OUT mTexture *pTexture)
   if (pTexture->imageBuffer != nullptr)
     mERROR_CHECK(mImageBuffer_Destroy(&pTexture->imageBuffer));
 
+  if (pTexture->imagePyramid != nullptr)
+    mERROR_CHECK(mImagePyramid_Destroy(&pTexture->imagePyramid));
+
   mGL_DEBUG_ERROR_CHECK();
 
   pTexture->uploadState = mRP_US_NotInitialized;
@@ -275,6 +299,12 @@ mFUNCTION(mTexture_Upload, mTexture &texture)
   if (texture.uploadState == mRP_US_Ready)
     mRETURN_SUCCESS();
 
+  if (texture.imagePyramid != nullptr)
+  {
+    mERROR_CHECK(mTexture_UploadImagePyramid_Internal(texture));
+    mRETURN_SUCCESS();
+  }
+
   mERROR_IF(texture.imageBuffer == nullptr, mR_NotInitialized);
   mERROR_IF(texture.pixelFormat.basePixelFormat != texture.imageBuffer->pixelFormat, mR_ResourceStateInvalid);
 
@@ -385,6 +415,10 @@ mFUNCTION(mTexture_SetTo, mTexture &texture, mPtr<mImageBuffer> &imageBuffer, co
 #endif
 #endif
 
+  // An image pyramid that hasn't been uploaded yet would otherwise take precedence.
+  if (texture.imagePyramid != nullptr)
+    mERROR_CHECK(mImagePyramid_Destroy(&texture.imagePyramid));
+
   texture.uploadState = mRP_US_NotInitialized;
   texture.resolution = imageBuffer->currentSize;
   texture.resolutionF = (mVec2f)texture.resolution;
@@ -489,6 +523,23 @@ mFUNCTION(mTexture_SetTo, mTexture &texture, const uint8_t *pData, const mVec2s
   mRETURN_SUCCESS();
 }
 
+mFUNCTION(mTexture_SetTo, mTexture &texture, mPtr<mImagePyramid> &imagePyramid, const bool upload /* = true */)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(imagePyramid == nullptr, mR_ArgumentNull);
+  mERROR_IF(imagePyramid->levelCount == 0, mR_NotInitialized);
+
+  mERROR_CHECK(mTexture_SetTo(texture, imagePyramid->pLevels[0], false));
+
+  texture.imagePyramid = imagePyramid;
+
+  if (upload)
+    mERROR_CHECK(mTexture_Upload(texture));
+
+  mRETURN_SUCCESS();
+}
+
 mFUNCTION(mTexture_Download, mTexture &texture, OUT mPtr<mImageBuffer> *pImageBuffer, IN mAllocator *pAllocator, const mPixelFormat pixelFormat /* = mPF_R8G8B8A8 */)
 {
   mFUNCTION_SETUP();
@@ -608,6 +659,87 @@ mFUNCTION(mDestruct, IN_OUT mTexture *pTexture)
   mRETURN_SUCCESS();
 }
 
+static mFUNCTION(mTexture_UploadImagePyramid_Internal, mTexture &texture)
+{
+  mFUNCTION_SETUP();
+
+  mPROFILE_SCOPED("mTexture_UploadImagePyramid_Internal");
+
+  mImagePyramid *pImagePyramid = texture.imagePyramid.GetPointer();
+
+  mERROR_IF(texture.pixelFormat.basePixelFormat != pImagePyramid->pixelFormat, mR_ResourceStateInvalid);
+
+#if defined (mRENDERER_OPENGL)
+  mERROR_IF(texture.sampleCount > 0, mR_NotSupported);
+
+  mGL_DEBUG_ERROR_CHECK();
+
+  texture.uploadState = mRP_US_Uploading;
+  mDEFER_ON_ERROR(texture.uploadState = mRP_US_NotUploaded);
+
+  glBindTexture(GL_TEXTURE_2D, texture.textureId);
+
+  mGL_DEBUG_ERROR_CHECK();
+
+  mERROR_CHECK(mTexture2DParams_ApplyToBoundTexture(texture.textureParams, false));
+
+  // Textures that aren't sampled with mip maps only get the first level, otherwise the chain has to be declared complete at the last level we have.
+  const size_t levelCount = texture.isMipMapTexture ? pImagePyramid->levelCount : 1;
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)(levelCount - 1));
+
+  if (pImagePyramid->pixelFormat == mPF_B8G8R8A8)
+  {
+    mPtr<mImageBuffer> imageBuffer;
+    mDEFER_CALL(&imageBuffer, mImageBuffer_Destroy);
+    mERROR_CHECK(mImageBuffer_Create(&imageBuffer, &mDefaultTempAllocator, pImagePyramid->pLevels[0]->currentSize, mPF_R8G8B8A8));
+
+    for (size_t i = 0; i < levelCount; i++)
+    {
+      mPtr<mImageBuffer> &level = pImagePyramid->pLevels[i];
+
+      mERROR_CHECK(mImageBuffer_AllocateBuffer(imageBuffer, level->currentSize, mPF_R8G8B8A8));
+      mERROR_CHECK(mPixelFormat_TransformBuffer(level, imageBuffer));
+
+      glTexImage2D(GL_TEXTURE_2D, (GLint)i, GL_RGBA, (GLsizei)level->currentSize.x, (GLsizei)level->currentSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageBuffer->pPixels);
+    }
+  }
+  else
+  {
+    GLenum glPixelFormat = GL_RGBA;
+    mERROR_CHECK(mRenderParams_PixelFormatToGLenumChannels(pImagePyramid->pixelFormat, &glPixelFormat));
+
+    GLenum glType = GL_UNSIGNED_BYTE;
+    mERROR_CHECK(mRenderParams_PixelFormatToGLenumDataType(pImagePyramid->pixelFormat, &glType));
+
+    for (size_t i = 0; i < levelCount; i++)
+    {
+      mPtr<mImageBuffer> &level = pImagePyramid->pLevels[i];
+
+      glTexImage2D(GL_TEXTURE_2D, (GLint)i, glPixelFormat, (GLsizei)level->currentSize.x, (GLsizei)level->currentSize.y, 0, glPixelFormat, glType, level->pPixels);
+    }
+  }
+
+  texture.resolution = pImagePyramid->pLevels[0]->currentSize;
+  texture.resolutionF = (mVec2f)texture.resolution;
+
+  mGL_DEBUG_ERROR_CHECK();
+#else
+  mRETURN_RESULT(mR_NotImplemented);
+#endif
+
+  texture.uploadState = mRP_US_Ready;
+
+  // The image buffer is just a view into the pyramid.
+  if (texture.imageBuffer != nullptr)
+    mERROR_CHECK(mImageBuffer_Destroy(&texture.imageBuffer));
+
+  mERROR_CHECK(mImagePyramid_Destroy(&texture.imagePyramid));
+
+  mRETURN_SUCCESS();
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 mFUNCTION(mTexture3D_Create, OUT mTexture3D *pTexture, const uint8_t *pData, const mVec3s &size, const mPixelFormat pixelFormat /* = mPF_B8G8R8A8 */, const size_t textureUnit /* = 0 */, const mTexture3DParams &textureParams /* = mTexture3DParams() */)
@@ -269,10 +269,10 @@ mFUNCTION(mBase64_Encode, IN const uint8_t *pData, const size_t bytes, OUT mStri
 
   mERROR_CHECK(mString_Reserve(*pEncoded, requiredLength + 1));
 
-  mDEFER_ON_ERROR(pEncoded->text[0] = '\0');
-  pEncoded->text[requiredLength] = '\0';
+  mDEFER_ON_ERROR(pEncoded->Data()[0] = '\0');
+  pEncoded->Data()[requiredLength] = '\0';
 
-  char *next = pEncoded->text;
+  char *next = pEncoded->Data();
 
   // Encode To Base64 into `next`.
   {
@@ -153,7 +153,7 @@ mFUNCTION(mXmlReader_StepInto, mPtr<mXmlReader> &xmlReader, const mString &tag)
   mFUNCTION_SETUP();
 
   mERROR_IF(xmlReader == nullptr, mR_ArgumentNull);
-  mERROR_IF(tag.hasFailed || tag.bytes <= 1 || tag.text == nullptr, mR_InvalidParameter);
+  mERROR_IF(tag.hasFailed || tag.bytes <= 1 || tag.c_str() == nullptr, mR_InvalidParameter);
 
   mXmlNodePosition lastNode;
   mERROR_CHECK(mQueue_PeekBack(xmlReader->currentNodeStack, &lastNode));
@@ -270,7 +270,7 @@ mFUNCTION(mXmlReader_GetAttributeProperty, mPtr<mXmlReader> &xmlReader, const mS
   mFUNCTION_SETUP();
 
   mERROR_IF(xmlReader == nullptr || pValue == nullptr, mR_ArgumentNull);
-  mERROR_IF(attributeKey.hasFailed || attributeKey.bytes < 1 || attributeKey.text == nullptr, mR_InvalidParameter);
+  mERROR_IF(attributeKey.hasFailed || attributeKey.bytes < 1 || attributeKey.c_str() == nullptr, mR_InvalidParameter);
 
   size_t count = 0;
   mERROR_CHECK(mQueue_GetCount(xmlReader->currentNodeStack, &count));
@@ -472,7 +472,7 @@ mFUNCTION(mXmlWriter_AppendEscapedString_Internal, IN_OUT mString &string, const
 
 inline bool mXmlWriter_IsValidString(const mString &tag)
 {
-  return !(tag.hasFailed || tag.bytes <= 1 || tag.text == nullptr);
+  return !(tag.hasFailed || tag.bytes <= 1 || tag.c_str() == nullptr);
 }
 
 inline bool mXmlWriter_StringNeedsEscaping(const mString &string)
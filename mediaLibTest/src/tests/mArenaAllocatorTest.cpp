@@ -0,0 +1,256 @@
+#include "mTestLib.h"
+#include "mArenaAllocator.h"
+#include "mQueue.h"
+
+#include <thread>
+
+mTEST(mArenaAllocator, TestAllocate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator arena;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Create(&arena, pAllocator, 1024));
+  mDEFER_CALL(&arena, mAllocator_Destroy);
+
+  size_t *ppAllocations[64];
+
+  for (size_t i = 0; i < mARRAYSIZE(ppAllocations); i++)
+  {
+    ppAllocations[i] = nullptr;
+    mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &ppAllocations[i], i + 1));
+    mTEST_ASSERT_EQUAL((size_t)0, reinterpret_cast<size_t>(ppAllocations[i]) % mArenaAllocator_Alignment);
+
+    for (size_t j = 0; j <= i; j++)
+      ppAllocations[i][j] = i;
+  }
+
+  // Allocations spanning multiple chunks and allocations larger than a chunk must not overlap.
+  for (size_t i = 0; i < mARRAYSIZE(ppAllocations); i++)
+    for (size_t j = 0; j <= i; j++)
+      mTEST_ASSERT_EQUAL(ppAllocations[i][j], i);
+
+  uint8_t *pZero = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(&arena, &pZero, 100));
+
+  for (size_t i = 0; i < 100; i++)
+    mTEST_ASSERT_EQUAL(pZero[i], (uint8_t)0);
+
+  mTEST_ASSERT_SUCCESS(mAllocator_FreePtr(&arena, &pZero));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mArenaAllocator, TestReallocate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator arena;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Create(&arena, pAllocator, 1024));
+  mDEFER_CALL(&arena, mAllocator_Destroy);
+
+  size_t *pData = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 4));
+
+  for (size_t i = 0; i < 4; i++)
+    pData[i] = i;
+
+  // The most recent allocation grows in place.
+  size_t *pPrevious = pData;
+  mTEST_ASSERT_SUCCESS(mAllocator_Reallocate(&arena, &pData, 8));
+  mTEST_ASSERT_EQUAL(pPrevious, pData);
+
+  size_t *pOther = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pOther, 1));
+
+  // Now it has to be moved.
+  mTEST_ASSERT_SUCCESS(mAllocator_Reallocate(&arena, &pData, 1024));
+  mTEST_ASSERT_NOT_EQUAL(pPrevious, pData);
+
+  for (size_t i = 0; i < 4; i++)
+    mTEST_ASSERT_EQUAL(pData[i], i);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mArenaAllocator, TestResetAndMarkers)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator arena;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Create(&arena, pAllocator, 1024));
+  mDEFER_CALL(&arena, mAllocator_Destroy);
+
+  uint8_t *pFirst = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pFirst, 100));
+
+  mArenaAllocator_Marker marker;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetMarker(&arena, &marker));
+
+  uint8_t *pScoped = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pScoped, 100));
+
+  for (size_t i = 0; i < 32; i++)
+  {
+    uint8_t *pData = nullptr;
+    mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 500));
+  }
+
+  size_t reservedBytes = 0;
+  size_t usedBytes = 0;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetSize(&arena, &reservedBytes, &usedBytes));
+  mTEST_ASSERT_TRUE(usedBytes >= 100 * 2 + 500 * 32);
+  mTEST_ASSERT_TRUE(reservedBytes >= usedBytes);
+
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_ResetToMarker(&arena, marker));
+
+  uint8_t *pData = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 100));
+  mTEST_ASSERT_EQUAL(pScoped, pData);
+
+  // Freeing the most recent allocation rewinds the arena.
+  mTEST_ASSERT_SUCCESS(mAllocator_FreePtr(&arena, &pData));
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 100));
+  mTEST_ASSERT_EQUAL(pScoped, pData);
+
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Reset(&arena));
+
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 100));
+  mTEST_ASSERT_EQUAL(pFirst, pData);
+
+  // Chunks are reused after resetting.
+  for (size_t i = 0; i < 32; i++)
+    mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&arena, &pData, 500));
+
+  size_t reservedBytesAfterReset = 0;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetSize(&arena, &reservedBytesAfterReset, nullptr));
+  mTEST_ASSERT_EQUAL(reservedBytes, reservedBytesAfterReset);
+
+  mAllocator defaultAllocator = mDefaultAllocator;
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mArenaAllocator_Reset(&defaultAllocator));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mArenaAllocator, TestQueue)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator arena;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Create(&arena, pAllocator));
+  mDEFER_CALL(&arena, mAllocator_Destroy);
+
+  for (size_t iteration = 0; iteration < 4; iteration++)
+  {
+    mPtr<mQueue<size_t>> queue;
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, &arena));
+
+    for (size_t i = 0; i < 10000; i++)
+      mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, i));
+
+    for (size_t i = 0; i < 10000; i++)
+    {
+      size_t value;
+      mTEST_ASSERT_SUCCESS(mQueue_PopFront(queue, &value));
+      mTEST_ASSERT_EQUAL(i, value);
+    }
+
+    mTEST_ASSERT_SUCCESS(mQueue_Destroy(&queue));
+    mTEST_ASSERT_SUCCESS(mArenaAllocator_Reset(&arena));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mArenaAllocator, TestThreadFrameAllocator)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator *pFrameAllocator = nullptr;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetThreadFrameAllocator(&pFrameAllocator));
+
+  mAllocator *pFrameAllocator2 = nullptr;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetThreadFrameAllocator(&pFrameAllocator2));
+  mTEST_ASSERT_EQUAL(pFrameAllocator, pFrameAllocator2);
+
+  mAllocator *pOtherThreadFrameAllocator = nullptr;
+  mResult otherThreadResult = mR_Success;
+
+  std::thread thread([&]()
+  {
+    otherThreadResult = mArenaAllocator_GetThreadFrameAllocator(&pOtherThreadFrameAllocator);
+
+    uint8_t *pData = nullptr;
+
+    if (mSUCCEEDED(otherThreadResult))
+      otherThreadResult = mAllocator_Allocate(pOtherThreadFrameAllocator, &pData, 1024);
+  });
+
+  thread.join();
+
+  mTEST_ASSERT_SUCCESS(otherThreadResult);
+  mTEST_ASSERT_NOT_EQUAL(pFrameAllocator, pOtherThreadFrameAllocator);
+
+  mArenaAllocator_Marker marker;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_GetMarker(pFrameAllocator, &marker));
+  mDEFER(mArenaAllocator_ResetToMarker(pFrameAllocator, marker));
+
+  uint8_t *pData = nullptr;
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pFrameAllocator, &pData, 1024));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mArenaAllocator, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t frameCount = 2000;
+  const size_t allocationsPerFrame = 1000;
+
+  mAllocator arena;
+  mTEST_ASSERT_SUCCESS(mArenaAllocator_Create(&arena, nullptr));
+  mDEFER_CALL(&arena, mAllocator_Destroy);
+
+  uint8_t **ppAllocations = nullptr;
+  mDEFER_CALL(&ppAllocations, mFreePtr);
+  mTEST_ASSERT_SUCCESS(mAlloc(&ppAllocations, allocationsPerFrame));
+
+  int64_t times[2];
+
+  for (size_t useArena = 0; useArena < 2; useArena++)
+  {
+    mAllocator *pFrameAllocator = useArena ? &arena : nullptr;
+    size_t sizeState = 0;
+
+    const int64_t start = mGetCurrentTimeNs();
+
+    for (size_t frame = 0; frame < frameCount; frame++)
+    {
+      // Many small short-lived allocations of varying size, similar to parsing a request.
+      for (size_t i = 0; i < allocationsPerFrame; i++)
+      {
+        sizeState = sizeState * 6364136223846793005ULL + 1442695040888963407ULL;
+        mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pFrameAllocator, &ppAllocations[i], 16 + (sizeState >> 56)));
+        ppAllocations[i][0] = (uint8_t)i;
+      }
+
+      if (useArena)
+      {
+        mTEST_ASSERT_SUCCESS(mArenaAllocator_Reset(&arena));
+      }
+      else
+      {
+        for (size_t i = 0; i < allocationsPerFrame; i++)
+          mTEST_ASSERT_SUCCESS(mAllocator_FreePtr(pFrameAllocator, &ppAllocations[i]));
+      }
+    }
+
+    times[useArena] = mGetCurrentTimeNs() - start;
+  }
+
+  mTEST_ASSERT_TRUE(times[0] / (double_t)times[1] > 1.0); // Please don't make this perform terribly. Bump allocations have to be cheaper than going through the heap.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
@@ -0,0 +1,163 @@
+#include "mTestLib.h"
+#include "mFile.h"
+#include "mAsyncFile.h"
+
+mTEST(mAsyncFile, TestRead)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 1024 * 64 + 3;
+  const size_t blockSize = 1000;
+  const mString filename = "mAsyncFileTest.bin";
+
+  uint8_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = (uint8_t)(i * 31);
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pReadData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pReadData);
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pAllocator, &pReadData, fileSize));
+
+  const mAsyncFileQueue_Backend backends[] = { mAFQ_B_Default, mAFQ_B_ThreadPool };
+
+  for (const mAsyncFileQueue_Backend backend : backends)
+  {
+    mTEST_ASSERT_SUCCESS(mZeroMemory(pReadData, fileSize));
+
+    // Less than the number of requests, so they have to be submitted in multiple batches.
+    const size_t queueDepth = 8;
+
+    mPtr<mAsyncFileQueue> queue;
+    mDEFER_CALL(&queue, mAsyncFileQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mAsyncFileQueue_Create(&queue, pAllocator, queueDepth, backend));
+
+    mAsyncFileQueue_Backend actualBackend;
+    mTEST_ASSERT_SUCCESS(mAsyncFileQueue_GetBackend(queue, &actualBackend));
+    mTEST_ASSERT_TRUE(actualBackend != mAFQ_B_Default);
+
+    if (backend == mAFQ_B_ThreadPool)
+      mTEST_ASSERT_EQUAL(mAFQ_B_ThreadPool, actualBackend);
+
+    mPtr<mAsyncFile> file;
+    mDEFER_CALL(&file, mAsyncFile_Destroy);
+    mTEST_ASSERT_SUCCESS(mAsyncFile_Open(&file, pAllocator, queue, filename));
+
+    size_t size = 0;
+    mTEST_ASSERT_SUCCESS(mAsyncFile_GetSize(file, &size));
+    mTEST_ASSERT_EQUAL(fileSize, size);
+
+    size_t completedCount = 0;
+    size_t totalBytesRead = 0;
+    mResult result = mR_Success;
+
+    for (size_t offset = 0; offset < fileSize; offset += blockSize)
+    {
+      mTEST_ASSERT_SUCCESS(mAsyncFile_Read(file, offset, blockSize, pReadData + offset, [&, offset](const mResult readResult, const size_t bytesRead)
+      {
+        if (mFAILED(readResult))
+          result = readResult;
+        else if (bytesRead != mMin(blockSize, fileSize - offset)) // The last request reads past the end of the file.
+          result = mR_Failure;
+
+        completedCount++;
+        totalBytesRead += bytesRead;
+      }));
+    }
+
+    // The file stays open until all requests have completed.
+    mTEST_ASSERT_SUCCESS(mAsyncFile_Destroy(&file));
+
+    mTEST_ASSERT_SUCCESS(mAsyncFileQueue_WaitForAll(queue));
+    mTEST_ASSERT_SUCCESS(result);
+    mTEST_ASSERT_EQUAL((fileSize + blockSize - 1) / blockSize, completedCount);
+    mTEST_ASSERT_EQUAL(fileSize, totalBytesRead);
+
+    for (size_t i = 0; i < fileSize; i++)
+      mTEST_ASSERT_EQUAL(pData[i], pReadData[i]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mAsyncFile, TestReadFromCallback)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 4096 * 3;
+  const size_t blockSize = 4096;
+  const mString filename = "mAsyncFileTestCallback.bin";
+
+  uint8_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = (uint8_t)(i ^ (i >> 8));
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pReadData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pReadData);
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pReadData, fileSize));
+
+  mPtr<mAsyncFileQueue> queue;
+  mDEFER_CALL(&queue, mAsyncFileQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mAsyncFileQueue_Create(&queue, pAllocator, 2));
+
+  mPtr<mAsyncFile> file;
+  mDEFER_CALL(&file, mAsyncFile_Destroy);
+  mTEST_ASSERT_SUCCESS(mAsyncFile_Open(&file, pAllocator, queue, filename));
+
+  mResult result = mR_Success;
+  mAsyncFile_Callback callback;
+
+  // Every completed block queues the next one.
+  callback = [&](const mResult readResult, const size_t bytesRead)
+  {
+    if (mFAILED(readResult) || bytesRead != blockSize)
+    {
+      result = mFAILED(readResult) ? readResult : mR_Failure;
+      return;
+    }
+
+    static_assert(fileSize % blockSize == 0, "Invalid Test Parameters");
+
+    for (size_t offset = 0; offset < fileSize; offset += blockSize)
+    {
+      if (pReadData[offset] == 0 && pData[offset] != 0)
+      {
+        result = mAsyncFile_Read(file, offset, blockSize, pReadData + offset, callback);
+        return;
+      }
+    }
+  };
+
+  mTEST_ASSERT_SUCCESS(mAsyncFile_Read(file, 0, blockSize, pReadData, callback));
+
+  mTEST_ASSERT_SUCCESS(mAsyncFileQueue_WaitForAll(queue));
+  mTEST_ASSERT_SUCCESS(result);
+
+  for (size_t i = 0; i < fileSize; i++)
+    mTEST_ASSERT_EQUAL(pData[i], pReadData[i]);
+
+  // Reading past the end of the file completes with zero bytes, starting past it fails.
+  size_t bytesReadAtEnd = (size_t)-1;
+  mTEST_ASSERT_SUCCESS(mAsyncFile_Read(file, fileSize, blockSize, pReadData, [&](const mResult, const size_t bytesRead) { bytesReadAtEnd = bytesRead; }));
+  mTEST_ASSERT_SUCCESS(mAsyncFileQueue_WaitForAll(queue));
+  mTEST_ASSERT_EQUAL((size_t)0, bytesReadAtEnd);
+
+  mTEST_ASSERT_EQUAL(mR_EndOfStream, mAsyncFile_Read(file, fileSize + 1, blockSize, pReadData, nullptr));
+
+  mPtr<mAsyncFile> missingFile;
+  mDEFER_CALL(&missingFile, mAsyncFile_Destroy);
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mAsyncFile_Open(&missingFile, pAllocator, queue, "mAsyncFileTest.missing"));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -122,3 +122,180 @@ mTEST(mCachedFileReader, TestRead)
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
+
+mTEST(mCachedFileReader, TestReadMapped)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 1024 * 12;
+  const mString filename = "mCachedFileReaderTestMapped.bin";
+
+  size_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = i;
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  mPtr<mCachedFileReader> fileReader;
+  mDEFER_CALL(&fileReader, mCachedFileReader_Destroy);
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_CreateMapped(&fileReader, pAllocator, filename, mROMF_AP_Random));
+
+  size_t actualFileSize = 0;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_GetSize(fileReader, &actualFileSize));
+  mTEST_ASSERT_EQUAL(actualFileSize, fileSize * sizeof(size_t));
+
+  for (int64_t i = fileSize - 1; i >= 0; i--)
+  {
+    size_t value;
+    mTEST_ASSERT_SUCCESS(mCachedFileReader_ReadAt(fileReader, i * sizeof(size_t), sizeof(size_t), (uint8_t *)&value));
+    mTEST_ASSERT_EQUAL((size_t)i, value);
+  }
+
+  // Pointers point directly into the mapping, so they stay valid and aren't limited in size.
+  size_t *pFirst = nullptr;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_PointerAt(fileReader, 0, sizeof(size_t) * fileSize, (uint8_t **)&pFirst));
+
+  for (size_t i = 0; i < fileSize; i++)
+  {
+    size_t *pValue = nullptr;
+    mTEST_ASSERT_SUCCESS(mCachedFileReader_PointerAt(fileReader, i * sizeof(size_t), sizeof(size_t), (uint8_t **)&pValue));
+    mTEST_ASSERT_EQUAL(i, *pValue);
+    mTEST_ASSERT_EQUAL(pFirst + i, pValue);
+  }
+
+  uint8_t *pBuffer = nullptr;
+  mTEST_ASSERT_EQUAL(mR_EndOfStream, mCachedFileReader_PointerAt(fileReader, fileSize * sizeof(size_t), 1, &pBuffer));
+  mTEST_ASSERT_EQUAL(mR_EndOfStream, mCachedFileReader_PointerAt(fileReader, 1, fileSize * sizeof(size_t), &pBuffer));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mCachedFileReader, TestReadPaged)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 1024 * 12;
+  const size_t pageSize = 1024;
+  const size_t pageCount = 8;
+  const mString filename = "mCachedFileReaderTestPaged.bin";
+
+  size_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = i;
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  mPtr<mCachedFileReader> fileReader;
+  mDEFER_CALL(&fileReader, mCachedFileReader_Destroy);
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_CreatePaged(&fileReader, pAllocator, filename, pageSize, pageCount, 2));
+
+  const size_t filePageCount = fileSize * sizeof(size_t) / pageSize;
+
+  // Interleave reading an 'index' at the end of the file with streaming from the front.
+  for (size_t i = 0; i < fileSize; i++)
+  {
+    size_t value;
+    mTEST_ASSERT_SUCCESS(mCachedFileReader_ReadAt(fileReader, i * sizeof(size_t), sizeof(size_t), (uint8_t *)&value));
+    mTEST_ASSERT_EQUAL(i, value);
+
+    mTEST_ASSERT_SUCCESS(mCachedFileReader_ReadAt(fileReader, (fileSize - 1 - (i % 16)) * sizeof(size_t), sizeof(size_t), (uint8_t *)&value));
+    mTEST_ASSERT_EQUAL(fileSize - 1 - (i % 16), value);
+  }
+
+  mCachedFileReader_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_GetStatistics(fileReader, &statistics));
+  mTEST_ASSERT_TRUE(statistics.missCount <= filePageCount + 1); // Neither access pattern evicts the other.
+  mTEST_ASSERT_EQUAL(statistics.hitCount + statistics.missCount, fileSize * 2);
+  mTEST_ASSERT_TRUE(statistics.readAheadCount > 0); // The index doesn't keep the front from being detected as sequential.
+  mTEST_ASSERT_TRUE(statistics.readAheadHitCount > 0);
+  mTEST_ASSERT_TRUE(statistics.readAheadHitCount <= statistics.readAheadCount);
+
+  // Pointers within a single page and spanning multiple pages.
+  for (int64_t i = fileSize - 2; i >= 0; i -= 7)
+  {
+    size_t *pValue = nullptr;
+    mTEST_ASSERT_SUCCESS(mCachedFileReader_PointerAt(fileReader, i * sizeof(size_t), sizeof(size_t) * 2, (uint8_t **)&pValue));
+    mTEST_ASSERT_EQUAL((size_t)i, pValue[0]);
+    mTEST_ASSERT_EQUAL((size_t)i + 1, pValue[1]);
+  }
+
+  size_t *pValues = nullptr;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_PointerAt(fileReader, 100 * sizeof(size_t), pageSize * 3, (uint8_t **)&pValues));
+
+  for (size_t i = 0; i < pageSize * 3 / sizeof(size_t); i++)
+    mTEST_ASSERT_EQUAL(i + 100, pValues[i]);
+
+  mTEST_ASSERT_SUCCESS(mMemset(pData, fileSize, 0));
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_ReadAt(fileReader, 0, sizeof(size_t) * fileSize, (uint8_t *)pData));
+
+  for (size_t i = 0; i < fileSize; i++)
+    mTEST_ASSERT_EQUAL(i, pData[i]);
+
+  uint8_t *pBuffer = nullptr;
+  mTEST_ASSERT_EQUAL(mR_EndOfStream, mCachedFileReader_PointerAt(fileReader, fileSize * sizeof(size_t), 1, &pBuffer));
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mCachedFileReader_PointerAt(fileReader, 0, pageSize * pageCount + 1, &pBuffer));
+
+  mPtr<mCachedFileReader> unpagedFileReader;
+  mDEFER_CALL(&unpagedFileReader, mCachedFileReader_Destroy);
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_Create(&unpagedFileReader, pAllocator, filename));
+  mTEST_ASSERT_EQUAL(mR_ResourceStateInvalid, mCachedFileReader_GetStatistics(unpagedFileReader, &statistics));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mCachedFileReader, TestReadPagedInterleaved)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 1024 * 12;
+  const size_t pageSize = 1024;
+  const size_t pageCount = 8;
+  const size_t streamCount = 2;
+  const size_t streamSize = fileSize / streamCount;
+  const mString filename = "mCachedFileReaderTestInterleaved.bin";
+
+  size_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = i;
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  mPtr<mCachedFileReader> fileReader;
+  mDEFER_CALL(&fileReader, mCachedFileReader_Destroy);
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_CreatePaged(&fileReader, pAllocator, filename, pageSize, pageCount, 2));
+
+  // Stream through separate regions of the file in lockstep, like demuxing interleaved tracks.
+  for (size_t i = 0; i < streamSize; i++)
+  {
+    for (size_t stream = 0; stream < streamCount; stream++)
+    {
+      const size_t index = stream * streamSize + i;
+
+      size_t value;
+      mTEST_ASSERT_SUCCESS(mCachedFileReader_ReadAt(fileReader, index * sizeof(size_t), sizeof(size_t), (uint8_t *)&value));
+      mTEST_ASSERT_EQUAL(index, value);
+    }
+  }
+
+  mCachedFileReader_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_GetStatistics(fileReader, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.hitCount + statistics.missCount, fileSize);
+  mTEST_ASSERT_TRUE(statistics.readAheadCount > 0); // Every stream is detected as sequential on its own.
+  mTEST_ASSERT_TRUE(statistics.readAheadHitCount > 0);
+  mTEST_ASSERT_TRUE(statistics.readAheadHitCount <= statistics.readAheadCount);
+  mTEST_ASSERT_TRUE(statistics.missCount < fileSize * sizeof(size_t) / pageSize);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -99,3 +99,212 @@ mTEST(mColourLookup, LoadFromFileTest)
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
+
+mTEST(mColourLookup, ApplyToImageIdentityTest)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mColourLookup> colourLookup;
+  mDEFER_CALL(&colourLookup, mColourLookup_Destroy);
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_CreateFromFile(&colourLookup, pAllocator, mColourLookupTest_CubeFileName));
+
+  const mVec3s resolution = colourLookup->resolution;
+
+  for (size_t z = 0; z < resolution.z; z++)
+    for (size_t y = 0; y < resolution.y; y++)
+      for (size_t x = 0; x < resolution.x; x++)
+        colourLookup->pData[x + (y + z * resolution.y) * resolution.x] = mVec3f((float_t)x, (float_t)y, (float_t)z) / (mVec3f(resolution) - mVec3f(1));
+
+  const mVec2s size = mVec2s(256, 17);
+  const mColourLookup_Interpolation interpolations[] = { mCL_I_Trilinear, mCL_I_Tetrahedral };
+
+  for (const mColourLookup_Interpolation interpolation : interpolations)
+  {
+    mPtr<mImageBuffer> imageBuffer;
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator, size, mPF_B8G8R8A8));
+
+    for (size_t i = 0; i < imageBuffer->allocatedSize; i++)
+      imageBuffer->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+
+    mPtr<mImageBuffer> original;
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&original, pAllocator, size, mPF_B8G8R8A8));
+    mTEST_ASSERT_SUCCESS(mMemcpy(original->pPixels, imageBuffer->pPixels, imageBuffer->allocatedSize));
+
+    mTEST_ASSERT_SUCCESS(mColourLookup_ApplyToImage(colourLookup, imageBuffer, interpolation));
+
+    for (size_t i = 0; i < imageBuffer->allocatedSize; i++)
+      mTEST_ASSERT_EQUAL(imageBuffer->pPixels[i], original->pPixels[i]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mColourLookup, ApplyToImageMatchesAtTest)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  mPtr<mColourLookup> colourLookup;
+  mDEFER_CALL(&colourLookup, mColourLookup_Destroy);
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_CreateFromFile(&colourLookup, pAllocator, mColourLookupTest_CubeFileName));
+
+  const mVec2s size = mVec2s(317, 211);
+
+  mPtr<mImageBuffer> imageBuffer;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator, size, mPF_Rf32Gf32Bf32Af32));
+
+  float_t *pPixels = reinterpret_cast<float_t *>(imageBuffer->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y * 4; i++)
+    pPixels[i] = (float_t)((i * 0x9E3779B1) & 0xFFFF) / (float_t)0xFFFF;
+
+  mPtr<mImageBuffer> original;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&original, pAllocator, size, mPF_Rf32Gf32Bf32Af32));
+  mTEST_ASSERT_SUCCESS(mMemcpy(original->pPixels, imageBuffer->pPixels, imageBuffer->allocatedSize));
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_ApplyToImage(colourLookup, imageBuffer, threadPool, mCL_I_Trilinear));
+
+  const float_t *pOriginal = reinterpret_cast<const float_t *>(original->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+  {
+    mVec3f expected;
+    mTEST_ASSERT_SUCCESS(mColourLookup_At(colourLookup, mVec3f(pOriginal[i * 4 + 0], pOriginal[i * 4 + 1], pOriginal[i * 4 + 2]), &expected));
+
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 0] - expected.x) < 1e-3f);
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 1] - expected.y) < 1e-3f);
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 2] - expected.z) < 1e-3f);
+    mTEST_ASSERT_EQUAL(pPixels[i * 4 + 3], pOriginal[i * 4 + 3]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+// Straightforward tetrahedral interpolation: walk from the lower to the upper corner of the grid cell along the axes in order of decreasing fraction.
+static mVec3f mColourLookupTest_TetrahedralReference(const mPtr<mColourLookup> &colourLookup, const mVec3f position)
+{
+  const float_t values[3] = { position.x, position.y, position.z };
+  size_t index[3];
+  float_t fraction[3];
+
+  for (size_t axis = 0; axis < 3; axis++)
+  {
+    const size_t resolution = colourLookup->resolution.asArray[axis];
+    const float_t gridPosition = mClamp(values[axis], 0.f, 1.f) * (float_t)(resolution - 1);
+
+    index[axis] = mMin((size_t)gridPosition, resolution - 2);
+    fraction[axis] = gridPosition - (float_t)index[axis];
+  }
+
+  size_t order[3] = { 0, 1, 2 };
+
+  for (size_t i = 0; i < 3; i++)
+    for (size_t j = i + 1; j < 3; j++)
+      if (fraction[order[j]] > fraction[order[i]])
+        std::swap(order[i], order[j]);
+
+  const auto &at = [&](const size_t *pCorner)
+  {
+    return colourLookup->pData[pCorner[0] + (pCorner[1] + pCorner[2] * colourLookup->resolution.y) * colourLookup->resolution.x];
+  };
+
+  size_t corner[3] = { index[0], index[1], index[2] };
+  mVec3f result = at(corner) * (1.f - fraction[order[0]]);
+
+  for (size_t i = 0; i < 3; i++)
+  {
+    corner[order[i]]++;
+
+    const float_t weight = fraction[order[i]] - (i + 1 < 3 ? fraction[order[i + 1]] : 0.f);
+    result += at(corner) * weight;
+  }
+
+  return result;
+}
+
+mTEST(mColourLookup, ApplyToImageMatchesTetrahedralReferenceTest)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  mPtr<mColourLookup> colourLookup;
+  mDEFER_CALL(&colourLookup, mColourLookup_Destroy);
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_CreateFromFile(&colourLookup, pAllocator, mColourLookupTest_CubeFileName));
+
+  const mVec2s size = mVec2s(317, 211);
+
+  mPtr<mImageBuffer> imageBuffer;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator, size, mPF_Rf32Gf32Bf32Af32));
+
+  float_t *pPixels = reinterpret_cast<float_t *>(imageBuffer->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y * 4; i++)
+    pPixels[i] = (float_t)((i * 0x9E3779B1) & 0xFFFF) / (float_t)0xFFFF;
+
+  mPtr<mImageBuffer> original;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&original, pAllocator, size, mPF_Rf32Gf32Bf32Af32));
+  mTEST_ASSERT_SUCCESS(mMemcpy(original->pPixels, imageBuffer->pPixels, imageBuffer->allocatedSize));
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_ApplyToImage(colourLookup, imageBuffer, threadPool, mCL_I_Tetrahedral));
+
+  const float_t *pOriginal = reinterpret_cast<const float_t *>(original->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+  {
+    const mVec3f expected = mColourLookupTest_TetrahedralReference(colourLookup, mVec3f(pOriginal[i * 4 + 0], pOriginal[i * 4 + 1], pOriginal[i * 4 + 2]));
+
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 0] - expected.x) < 1e-3f);
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 1] - expected.y) < 1e-3f);
+    mTEST_ASSERT_TRUE(mAbs(pPixels[i * 4 + 2] - expected.z) < 1e-3f);
+    mTEST_ASSERT_EQUAL(pPixels[i * 4 + 3], pOriginal[i * 4 + 3]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mColourLookup, ApplyToImageThreadedTest)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  mPtr<mColourLookup> colourLookup;
+  mDEFER_CALL(&colourLookup, mColourLookup_Destroy);
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_CreateFromFile(&colourLookup, pAllocator, mColourLookupTest_CubeFileName));
+
+  const mVec2s size = mVec2s(1920, 1080);
+
+  mPtr<mImageBuffer> serialImage;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&serialImage, pAllocator, size, mPF_R8G8B8));
+
+  for (size_t i = 0; i < serialImage->allocatedSize; i++)
+    serialImage->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+
+  mPtr<mImageBuffer> threadedImage;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&threadedImage, pAllocator, size, mPF_R8G8B8));
+  mTEST_ASSERT_SUCCESS(mMemcpy(threadedImage->pPixels, serialImage->pPixels, serialImage->allocatedSize));
+
+  mTEST_ASSERT_SUCCESS(mColourLookup_ApplyToImage(colourLookup, serialImage));
+  mTEST_ASSERT_SUCCESS(mColourLookup_ApplyToImage(colourLookup, threadedImage, threadPool));
+
+  for (size_t i = 0; i < serialImage->allocatedSize; i++)
+    mTEST_ASSERT_EQUAL(serialImage->pPixels[i], threadedImage->pPixels[i]);
+
+  mPtr<mImageBuffer> unsupported;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&unsupported, pAllocator, size, mPF_YUV420));
+  mTEST_ASSERT_EQUAL(mR_NotSupported, mColourLookup_ApplyToImage(colourLookup, unsupported, threadPool));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
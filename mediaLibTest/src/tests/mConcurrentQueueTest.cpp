@@ -0,0 +1,330 @@
+#include "mTestLib.h"
+#include "mConcurrentQueue.h"
+#include "mQueue.h"
+#include "mMutex.h"
+
+#include <thread>
+
+mTEST(mConcurrentQueue, TestSpscQueue)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mSpscQueue<size_t>> queue;
+  mDEFER_CALL(&queue, mSpscQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mSpscQueue_Create(&queue, pAllocator, 5));
+
+  // The capacity has been rounded up to 8.
+  size_t items[16];
+
+  for (size_t i = 0; i < mARRAYSIZE(items); i++)
+    items[i] = i;
+
+  size_t pushedCount = 0;
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPushBatch(queue, items, mARRAYSIZE(items), &pushedCount));
+  mTEST_ASSERT_EQUAL((size_t)8, pushedCount);
+
+  bool pushed = true;
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPush(queue, (size_t)100, &pushed));
+  mTEST_ASSERT_FALSE(pushed);
+
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mSpscQueue_GetCount(queue, &count));
+  mTEST_ASSERT_EQUAL((size_t)8, count);
+
+  size_t popped[16];
+  size_t poppedCount = 0;
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPopBatch(queue, popped, 3, &poppedCount));
+  mTEST_ASSERT_EQUAL((size_t)3, poppedCount);
+
+  for (size_t i = 0; i < poppedCount; i++)
+    mTEST_ASSERT_EQUAL(i, popped[i]);
+
+  // Wraps around the end of the buffer.
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPushBatch(queue, items + 8, 8, &pushedCount));
+  mTEST_ASSERT_EQUAL((size_t)3, pushedCount);
+
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPopBatch(queue, popped, mARRAYSIZE(popped), &poppedCount));
+  mTEST_ASSERT_EQUAL((size_t)8, poppedCount);
+
+  for (size_t i = 0; i < poppedCount; i++)
+    mTEST_ASSERT_EQUAL(i + 3, popped[i]);
+
+  bool wasPopped = true;
+  size_t item = 0;
+  mTEST_ASSERT_SUCCESS(mSpscQueue_TryPop(queue, &item, &wasPopped));
+  mTEST_ASSERT_FALSE(wasPopped);
+
+  mTEST_ASSERT_EQUAL(mR_Timeout, mSpscQueue_Pop(queue, &item, 5));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mConcurrentQueue, TestSpscQueueThreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t itemCount = 1024 * 256;
+
+  mPtr<mSpscQueue<size_t>> queue;
+  mDEFER_CALL(&queue, mSpscQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mSpscQueue_Create(&queue, pAllocator, 64));
+
+  mResult producerResult = mR_Success;
+
+  std::thread producer([&]()
+  {
+    for (size_t i = 0; i < itemCount && mSUCCEEDED(producerResult); i++)
+      producerResult = mSpscQueue_Push(queue, i);
+  });
+
+  mResult consumerResult = mR_Success;
+  size_t expected = 0;
+
+  // Items have to arrive in order.
+  while (expected < itemCount && mSUCCEEDED(consumerResult))
+  {
+    size_t items[32];
+    size_t poppedCount = 0;
+    consumerResult = mSpscQueue_TryPopBatch(queue, items, mARRAYSIZE(items), &poppedCount);
+
+    for (size_t i = 0; i < poppedCount; i++, expected++)
+      if (items[i] != expected)
+        consumerResult = mR_Failure;
+
+    if (poppedCount == 0 && mSUCCEEDED(consumerResult))
+    {
+      size_t item = 0;
+      consumerResult = mSpscQueue_Pop(queue, &item, 1000);
+
+      if (mSUCCEEDED(consumerResult) && item != expected++)
+        consumerResult = mR_Failure;
+    }
+  }
+
+  producer.join();
+
+  mTEST_ASSERT_SUCCESS(producerResult);
+  mTEST_ASSERT_SUCCESS(consumerResult);
+  mTEST_ASSERT_EQUAL(itemCount, expected);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mConcurrentQueue, TestMpmcQueueThreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t threadCount = 4;
+  const size_t itemsPerProducer = 1024 * 64;
+
+  mPtr<mMpmcQueue<size_t>> queue;
+  mDEFER_CALL(&queue, mMpmcQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_Create(&queue, pAllocator, 128));
+
+  std::thread producers[threadCount];
+  std::thread consumers[threadCount];
+  mResult results[threadCount * 2];
+  std::atomic<size_t> sum(0);
+  std::atomic<size_t> poppedCount(0);
+
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    results[i] = mR_Success;
+    results[threadCount + i] = mR_Success;
+
+    producers[i] = std::thread([&, i]()
+    {
+      for (size_t j = 0; j < itemsPerProducer && mSUCCEEDED(results[i]); j += 4)
+      {
+        const size_t items[] = { j + 1, j + 2, j + 3, j + 4 };
+        size_t pushedCount = 0;
+
+        results[i] = mMpmcQueue_TryPushBatch(queue, items, mARRAYSIZE(items), &pushedCount);
+
+        for (size_t k = pushedCount; k < mARRAYSIZE(items) && mSUCCEEDED(results[i]); k++)
+          results[i] = mMpmcQueue_Push(queue, items[k]);
+      }
+    });
+
+    consumers[i] = std::thread([&, i]()
+    {
+      while (poppedCount < threadCount * itemsPerProducer && mSUCCEEDED(results[threadCount + i]))
+      {
+        size_t item = 0;
+        const mResult result = mSILENCE_ERROR(mMpmcQueue_Pop(queue, &item, 10));
+
+        if (result == mR_Timeout)
+          continue;
+
+        results[threadCount + i] = result;
+
+        if (mSUCCEEDED(result))
+        {
+          sum += item;
+          ++poppedCount;
+        }
+      }
+    });
+  }
+
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    producers[i].join();
+    consumers[i].join();
+  }
+
+  for (size_t i = 0; i < mARRAYSIZE(results); i++)
+    mTEST_ASSERT_SUCCESS(results[i]);
+
+  mTEST_ASSERT_EQUAL(threadCount * itemsPerProducer, poppedCount.load());
+  mTEST_ASSERT_EQUAL(threadCount * (itemsPerProducer * (itemsPerProducer + 1) / 2), sum.load());
+
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_GetCount(queue, &count));
+  mTEST_ASSERT_EQUAL((size_t)0, count);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mConcurrentQueue, TestDestroyNonEmpty)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mMpmcQueue<mString>> mpmcQueue;
+  mDEFER_CALL(&mpmcQueue, mMpmcQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_Create(&mpmcQueue, pAllocator, 4));
+
+  mPtr<mSpscQueue<mString>> spscQueue;
+  mDEFER_CALL(&spscQueue, mSpscQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mSpscQueue_Create(&spscQueue, pAllocator, 4));
+
+  mString string;
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, "A string that is too long to be stored inline.", pAllocator));
+
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_Push(mpmcQueue, string));
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_Push(mpmcQueue, string));
+  mTEST_ASSERT_SUCCESS(mSpscQueue_Push(spscQueue, string));
+
+  mString popped;
+  mTEST_ASSERT_SUCCESS(mMpmcQueue_Pop(mpmcQueue, &popped));
+  mTEST_ASSERT_EQUAL(string, popped);
+
+  // The remaining strings are destroyed together with the queues.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mConcurrentQueue, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t threadCount = 4;
+  const size_t itemsPerProducer = 1024 * 256;
+
+  // mutex + mQueue
+  int64_t mutexTime;
+
+  {
+    mPtr<mQueue<size_t>> queue;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+    mTEST_ASSERT_SUCCESS(mQueue_Reserve(queue, 1024));
+
+    mMutex *pMutex = nullptr;
+    mDEFER_CALL(&pMutex, mMutex_Destroy);
+    mTEST_ASSERT_SUCCESS(mMutex_Create(&pMutex, pAllocator));
+
+    std::thread threads[threadCount * 2];
+    std::atomic<size_t> poppedCount(0);
+
+    const int64_t start = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+      threads[i] = std::thread([&]()
+      {
+        for (size_t j = 0; j < itemsPerProducer; j++)
+        {
+          mMutex_Lock(pMutex);
+          mQueue_PushBack(queue, j);
+          mMutex_Unlock(pMutex);
+        }
+      });
+
+      threads[threadCount + i] = std::thread([&]()
+      {
+        while (poppedCount < threadCount * itemsPerProducer)
+        {
+          size_t item;
+          bool popped = false;
+
+          mMutex_Lock(pMutex);
+
+          if (queue->count > 0)
+            popped = mSUCCEEDED(mQueue_PopFront(queue, &item));
+
+          mMutex_Unlock(pMutex);
+
+          if (popped)
+            ++poppedCount;
+          else
+            std::this_thread::yield();
+        }
+      });
+    }
+
+    for (size_t i = 0; i < mARRAYSIZE(threads); i++)
+      threads[i].join();
+
+    mutexTime = mGetCurrentTimeNs() - start;
+  }
+
+  // mMpmcQueue
+  int64_t lockFreeTime;
+
+  {
+    mPtr<mMpmcQueue<size_t>> queue;
+    mDEFER_CALL(&queue, mMpmcQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mMpmcQueue_Create(&queue, pAllocator, 1024));
+
+    std::thread threads[threadCount * 2];
+    std::atomic<size_t> poppedCount(0);
+
+    const int64_t start = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+      threads[i] = std::thread([&]()
+      {
+        for (size_t j = 0; j < itemsPerProducer; j++)
+          mMpmcQueue_Push(queue, j);
+      });
+
+      threads[threadCount + i] = std::thread([&]()
+      {
+        while (poppedCount < threadCount * itemsPerProducer)
+        {
+          size_t item;
+          bool popped = false;
+          mMpmcQueue_TryPop(queue, &item, &popped);
+
+          if (popped)
+            ++poppedCount;
+          else
+            std::this_thread::yield();
+        }
+      });
+    }
+
+    for (size_t i = 0; i < mARRAYSIZE(threads); i++)
+      threads[i].join();
+
+    lockFreeTime = mGetCurrentTimeNs() - start;
+  }
+
+  mTEST_ASSERT_TRUE(mutexTime / (double_t)lockFreeTime > 1.0); // Please don't make this perform terribly.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
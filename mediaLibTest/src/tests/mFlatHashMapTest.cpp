@@ -0,0 +1,388 @@
+#include "mTestLib.h"
+#include "mFlatHashMap.h"
+#include "mHashMap.h"
+
+mTEST(mFlatHashMap, TestCreate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<size_t, mDummyDestructible>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_EQUAL(mR_ArgumentNull, mFlatHashMap_Create((mPtr<mFlatHashMap<size_t, size_t>> *)nullptr, pAllocator));
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator, 1024));
+  mTEST_ASSERT_TRUE(hashMap->growThreshold >= 1024);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mFlatHashMap, TestCleanup)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<size_t, mDummyDestructible>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+
+  for (size_t i = 0; i < 1024 * 8; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mDummyDestructible_Create(&dummy, pAllocator));
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, i, &dummy));
+  }
+
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_GetCount(hashMap, &count));
+  mTEST_ASSERT_EQUAL(count, 1024 * 8);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mFlatHashMap, TestGetValues)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<size_t, mDummyDestructible>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+
+  const size_t maxCount = 512;
+
+  for (size_t i = 0; i < maxCount; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mDummyDestructible_Create(&dummy, pAllocator));
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, i, &dummy));
+
+    bool contains = false;
+    mDummyDestructible *pDummy = nullptr;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_ContainsGetPointer(hashMap, i, &contains, &pDummy));
+    mTEST_ASSERT_TRUE(contains);
+    mTEST_ASSERT_EQUAL(pDummy->index, i);
+
+    mDummyDestructible duplicate;
+    mTEST_ASSERT_EQUAL(mR_ResourceAlreadyExists, mFlatHashMap_Add(hashMap, i, &duplicate));
+  }
+
+  for (size_t i = 0; i < maxCount; i++)
+  {
+    bool contains = false;
+    mDummyDestructible *pDummy = nullptr;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_ContainsGetPointer(hashMap, i, &contains, &pDummy));
+    mTEST_ASSERT_TRUE(contains);
+    mTEST_ASSERT_EQUAL(pDummy->index, i);
+
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_ContainsGetPointer(hashMap, i + maxCount, &contains, &pDummy));
+    mTEST_ASSERT_FALSE(contains);
+    mTEST_ASSERT_EQUAL(pDummy, nullptr);
+  }
+
+  for (size_t i = 0; i < maxCount; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Remove(hashMap, i, &dummy));
+    mTEST_ASSERT_EQUAL(dummy.index, i);
+    mTEST_ASSERT_SUCCESS(mDestruct(&dummy));
+
+    mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mFlatHashMap_Remove(hashMap, i, &dummy));
+
+    for (size_t j = 0; j < maxCount; j++)
+    {
+      bool contains = false;
+      mTEST_ASSERT_SUCCESS(mFlatHashMap_Contains(hashMap, j, &contains));
+      mTEST_ASSERT_EQUAL(contains, j > i);
+    }
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mFlatHashMap, TestReserve)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<size_t, size_t>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Reserve(hashMap, 10000));
+
+  const size_t capacity = hashMap->capacity;
+  mTEST_ASSERT_TRUE(hashMap->growThreshold >= 10000);
+
+  for (size_t i = 0; i < 10000; i++)
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, i, &i));
+
+  mTEST_ASSERT_EQUAL(capacity, hashMap->capacity);
+
+  for (size_t i = 0; i < 10000; i++)
+  {
+    size_t value = 0;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, i, &value));
+    mTEST_ASSERT_EQUAL(value, i);
+  }
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_SetMaxLoadFactor(hashMap, 0.5f));
+  mTEST_ASSERT_TRUE(hashMap->capacity > capacity);
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mFlatHashMap_SetMaxLoadFactor(hashMap, 1.f));
+
+  for (size_t i = 0; i < 10000; i++)
+  {
+    size_t value = 0;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, i, &value));
+    mTEST_ASSERT_EQUAL(value, i);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mFlatHashMap, TestAddRemoveDoesNotGrow)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<size_t, size_t>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator, 64));
+
+  const size_t capacity = hashMap->capacity;
+
+  for (size_t i = 0; i < 1024 * 64; i++)
+  {
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, i, &i));
+
+    if (i >= 32)
+    {
+      size_t value = 0;
+      mTEST_ASSERT_SUCCESS(mFlatHashMap_Remove(hashMap, i - 32, &value));
+      mTEST_ASSERT_EQUAL(value, i - 32);
+    }
+  }
+
+  mTEST_ASSERT_EQUAL(capacity, hashMap->capacity);
+  mTEST_ASSERT_EQUAL(hashMap->count, 32);
+
+  size_t iteratedCount = 0;
+  size_t sum = 0;
+
+  for (const auto &_item : *hashMap)
+  {
+    mTEST_ASSERT_EQUAL(_item.key, _item.value);
+    sum += _item.value;
+    iteratedCount++;
+  }
+
+  mTEST_ASSERT_EQUAL(iteratedCount, 32);
+  mTEST_ASSERT_EQUAL(sum, 32 * (1024 * 64 - 32) + (32 * 31) / 2);
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Clear(hashMap));
+  mTEST_ASSERT_EQUAL(hashMap->count, 0);
+
+  for (const auto &_item : *hashMap)
+  {
+    mUnused(_item);
+    mTEST_FAIL();
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mFlatHashMap, TestStringKeys)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<mString, size_t>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+
+  for (size_t i = 0; i < 1024; i++)
+  {
+    mString key;
+    mTEST_ASSERT_SUCCESS(mString_Format(&key, pAllocator, "key #", i));
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, key, &i));
+  }
+
+  for (size_t i = 0; i < 1024; i++)
+  {
+    char key[64];
+    mTEST_ASSERT_SUCCESS(mFormatTo(key, mARRAYSIZE(key), "key #", i));
+
+    size_t value = 0;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, (const char *)key, &value));
+    mTEST_ASSERT_EQUAL(value, i);
+
+    mInplaceString<64> inplaceKey;
+    mTEST_ASSERT_SUCCESS(mInplaceString_CreateRaw(&inplaceKey, key));
+
+    value = 0;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, inplaceKey, &value));
+    mTEST_ASSERT_EQUAL(value, i);
+  }
+
+  bool contains = true;
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Contains(hashMap, "key #1024", &contains));
+  mTEST_ASSERT_FALSE(contains);
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Contains(hashMap, "key #1023", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  size_t value = 0;
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Remove(hashMap, "key #12", &value));
+  mTEST_ASSERT_EQUAL(value, 12);
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Contains(hashMap, "key #12", &contains));
+  mTEST_ASSERT_FALSE(contains);
+
+  value = 1;
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Set(hashMap, mString("key #13", pAllocator), &value));
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, "key #13", &value));
+  mTEST_ASSERT_EQUAL(value, 1);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+// Owns an allocation and has no move constructor, so every move is a copy that leaves an allocation behind in the moved-from value.
+struct mFlatHashMapTest_CopyOnlyValue
+{
+  mAllocator *pAllocator = nullptr;
+  size_t *pData = nullptr;
+
+  mFlatHashMapTest_CopyOnlyValue() = default;
+
+  mFlatHashMapTest_CopyOnlyValue(mAllocator *pAllocator, const size_t value) :
+    pAllocator(pAllocator)
+  {
+    if (mSUCCEEDED(mAllocator_Allocate(pAllocator, &pData, 1)))
+      *pData = value;
+  }
+
+  mFlatHashMapTest_CopyOnlyValue(const mFlatHashMapTest_CopyOnlyValue &copy) :
+    mFlatHashMapTest_CopyOnlyValue(copy.pAllocator, copy.pData == nullptr ? 0 : *copy.pData)
+  { }
+
+  mFlatHashMapTest_CopyOnlyValue & operator = (const mFlatHashMapTest_CopyOnlyValue &copy)
+  {
+    if (this != &copy)
+    {
+      this->~mFlatHashMapTest_CopyOnlyValue();
+      new (this) mFlatHashMapTest_CopyOnlyValue(copy);
+    }
+
+    return *this;
+  }
+
+  ~mFlatHashMapTest_CopyOnlyValue()
+  {
+    if (pData != nullptr)
+      mAllocator_FreePtr(pAllocator, &pData);
+  }
+};
+
+mTEST(mFlatHashMap, TestNonTrivialValues)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mFlatHashMap<mString, mFlatHashMapTest_CopyOnlyValue>> hashMap;
+  mDEFER_CALL(&hashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&hashMap, pAllocator));
+
+  const size_t count = 1024;
+
+  // Grows the hash map multiple times.
+  for (size_t i = 0; i < count; i++)
+  {
+    mString key;
+    mTEST_ASSERT_SUCCESS(mString_Format(&key, pAllocator, "a somewhat longer key that doesn't fit inline #", i));
+
+    mFlatHashMapTest_CopyOnlyValue value(pAllocator, i);
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(hashMap, key, &value));
+  }
+
+  // Removes every other entry, which shifts back the entries following them.
+  for (size_t i = 0; i < count; i += 2)
+  {
+    mString key;
+    mTEST_ASSERT_SUCCESS(mString_Format(&key, pAllocator, "a somewhat longer key that doesn't fit inline #", i));
+
+    mFlatHashMapTest_CopyOnlyValue value;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Remove(hashMap, key, &value));
+    mTEST_ASSERT_EQUAL(*value.pData, i);
+  }
+
+  size_t remainingCount = 0;
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_GetCount(hashMap, &remainingCount));
+  mTEST_ASSERT_EQUAL(remainingCount, count / 2);
+
+  for (size_t i = 1; i < count; i += 2)
+  {
+    mString key;
+    mTEST_ASSERT_SUCCESS(mString_Format(&key, pAllocator, "a somewhat longer key that doesn't fit inline #", i));
+
+    mFlatHashMapTest_CopyOnlyValue value;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Get(hashMap, key, &value));
+    mTEST_ASSERT_EQUAL(*value.pData, i);
+  }
+
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Reserve(hashMap, count * 4));
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Clear(hashMap));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mFlatHashMap, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t count = 1024 * 256;
+
+  mPtr<mHashMap<size_t, size_t>> hashMap;
+  mDEFER_CALL(&hashMap, mHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mHashMap_Create(&hashMap, pAllocator, 1024));
+
+  mPtr<mFlatHashMap<size_t, size_t>> flatHashMap;
+  mDEFER_CALL(&flatHashMap, mFlatHashMap_Destroy);
+  mTEST_ASSERT_SUCCESS(mFlatHashMap_Create(&flatHashMap, pAllocator));
+
+  const int64_t startOld = mGetCurrentTimeNs();
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mHashMap_Add(hashMap, i, &i));
+
+  size_t sumOld = 0;
+
+  for (size_t i = 0; i < count * 2; i++)
+  {
+    bool contains = false;
+    size_t *pValue = nullptr;
+    mTEST_ASSERT_SUCCESS(mHashMap_ContainsGetPointer(hashMap, i, &contains, &pValue));
+
+    if (contains)
+      sumOld += *pValue;
+  }
+
+  const int64_t endOld = mGetCurrentTimeNs();
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_Add(flatHashMap, i, &i));
+
+  size_t sumNew = 0;
+
+  for (size_t i = 0; i < count * 2; i++)
+  {
+    bool contains = false;
+    size_t *pValue = nullptr;
+    mTEST_ASSERT_SUCCESS(mFlatHashMap_ContainsGetPointer(flatHashMap, i, &contains, &pValue));
+
+    if (contains)
+      sumNew += *pValue;
+  }
+
+  const int64_t endNew = mGetCurrentTimeNs();
+
+  mTEST_ASSERT_EQUAL(sumOld, sumNew);
+
+  mTEST_ASSERT_TRUE((endOld - startOld) / (double_t)(endNew - endOld) > 2.0); // Please don't make this perform terribly. The fixed bucket count of `mHashMap` degrades quickly with this many keys.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
@@ -42,8 +42,8 @@ mTEST(mFormat, TestStrings)
   {
     // Let's craft an invalid mString!
     mString a = "abcdefgh";
-    a.text[3] = '\xFF';
-    a.text[4] = '\xFF';
+    a.Data()[3] = '\xFF';
+    a.Data()[4] = '\xFF';
 
     mTEST_FORMAT("abc", mFormat(mFString(a, mFMaxChars<5>(), mFNoEllipsis())));
     mTEST_FORMAT("ab...", mFormat(mFString(a, mFMaxChars<5>(), mFEllipsis())));
@@ -0,0 +1,559 @@
+#include "mTestLib.h"
+#include "mImageBuffer.h"
+#include "mFile.h"
+
+mTEST(mImageBuffer, TestResizeConstant)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(67, 41);
+  const mImageBuffer_ResizeFilter filters[] = { mIB_RF_Box, mIB_RF_Bilinear, mIB_RF_Bicubic, mIB_RF_Lanczos };
+  const mVec2s targetSizes[] = { mVec2s(13, 7), mVec2s(67, 41), mVec2s(200, 99), mVec2s(1, 1) };
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_B8G8R8A8));
+
+  uint32_t *pSource = reinterpret_cast<uint32_t *>(source->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    pSource[i] = 0x80FF4010;
+
+  for (const mImageBuffer_ResizeFilter filter : filters)
+  {
+    for (const mVec2s &targetSize : targetSizes)
+    {
+      mPtr<mImageBuffer> target;
+      mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&target, pAllocator, targetSize, mPF_B8G8R8A8));
+      mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(source, target, filter));
+
+      const uint32_t *pTarget = reinterpret_cast<const uint32_t *>(target->pPixels);
+
+      // The filter weights are normalised, so neither ringing nor the edges may change a flat image.
+      for (size_t i = 0; i < targetSize.x * targetSize.y; i++)
+        mTEST_ASSERT_EQUAL(pTarget[i], (uint32_t)0x80FF4010);
+    }
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestResizeBoxHalf)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(64, 32);
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_Monochrome8));
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    source->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 9);
+
+  mPtr<mImageBuffer> target;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&target, pAllocator, size / 2, mPF_Monochrome8));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(source, target, mIB_RF_Box));
+
+  for (size_t y = 0; y < size.y / 2; y++)
+  {
+    for (size_t x = 0; x < size.x / 2; x++)
+    {
+      const uint8_t *pQuad = source->pPixels + y * 2 * size.x + x * 2;
+      const size_t sum = pQuad[0] + pQuad[1] + pQuad[size.x] + pQuad[size.x + 1];
+      const int64_t result = target->pPixels[y * (size.x / 2) + x];
+
+      // Halves round to even.
+      mTEST_ASSERT_TRUE(mAbs(result * 4 - (int64_t)sum) <= 2);
+    }
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestResizeThreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const mVec2s size = mVec2s(1003, 601);
+  const mVec2s targetSizes[] = { mVec2s(1920, 1080), mVec2s(251, 77) };
+  const mPixelFormat pixelFormats[] = { mPF_B8G8R8A8, mPF_R8G8B8, mPF_Rf32Gf32Bf32Af32 };
+
+  for (const mPixelFormat pixelFormat : pixelFormats)
+  {
+    mPtr<mImageBuffer> source;
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, pixelFormat));
+
+    if (pixelFormat == mPF_Rf32Gf32Bf32Af32)
+    {
+      float_t *pSource = reinterpret_cast<float_t *>(source->pPixels);
+
+      for (size_t i = 0; i < source->allocatedSize / sizeof(float_t); i++)
+        pSource[i] = (float_t)((i * 0x9E3779B1) & 0xFFFF) / (float_t)0xFFFF;
+    }
+    else
+    {
+      for (size_t i = 0; i < source->allocatedSize; i++)
+        source->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+    }
+
+    for (const mVec2s &targetSize : targetSizes)
+    {
+      mPtr<mImageBuffer> serialTarget;
+      mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&serialTarget, pAllocator, targetSize, pixelFormat));
+      mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(source, serialTarget, mIB_RF_Lanczos));
+
+      mPtr<mImageBuffer> threadedTarget;
+      mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&threadedTarget, pAllocator, targetSize, pixelFormat));
+      mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(source, threadedTarget, mIB_RF_Lanczos, threadPool));
+
+      mTEST_ASSERT_EQUAL(serialTarget->allocatedSize, threadedTarget->allocatedSize);
+
+      for (size_t i = 0; i < serialTarget->allocatedSize; i++)
+        mTEST_ASSERT_EQUAL(serialTarget->pPixels[i], threadedTarget->pPixels[i]);
+    }
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestResizeYuv420)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(320, 180);
+  const mVec2s targetSize = mVec2s(128, 72);
+  const uint8_t planeValues[] = { 200, 60, 140 };
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_YUV420));
+
+  size_t subBufferCount;
+  mTEST_ASSERT_SUCCESS(mPixelFormat_GetSubBufferCount(mPF_YUV420, &subBufferCount));
+  mTEST_ASSERT_EQUAL(3, subBufferCount);
+
+  for (size_t i = 0; i < subBufferCount; i++)
+  {
+    size_t offset;
+    mVec2s subBufferSize;
+    mTEST_ASSERT_SUCCESS(mPixelFormat_GetSubBufferOffset(mPF_YUV420, i, size, &offset));
+    mTEST_ASSERT_SUCCESS(mPixelFormat_GetSubBufferSize(mPF_YUV420, i, size, &subBufferSize));
+
+    mTEST_ASSERT_SUCCESS(mMemset(source->pPixels + offset, subBufferSize.x * subBufferSize.y, planeValues[i]));
+  }
+
+  mPtr<mImageBuffer> target;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&target, pAllocator, targetSize, mPF_YUV420));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(source, target, mIB_RF_Bicubic));
+
+  // Every plane is resampled on its own, so the chroma planes mustn't bleed into each other.
+  for (size_t i = 0; i < subBufferCount; i++)
+  {
+    size_t offset;
+    mVec2s subBufferSize;
+    mTEST_ASSERT_SUCCESS(mPixelFormat_GetSubBufferOffset(mPF_YUV420, i, targetSize, &offset));
+    mTEST_ASSERT_SUCCESS(mPixelFormat_GetSubBufferSize(mPF_YUV420, i, targetSize, &subBufferSize));
+
+    for (size_t j = 0; j < subBufferSize.x * subBufferSize.y; j++)
+      mTEST_ASSERT_EQUAL(target->pPixels[offset + j], planeValues[i]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestResizeInplace)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mImageBuffer> imageBuffer;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator, mVec2s(100, 50), mPF_R8G8B8A8));
+
+  uint32_t *pPixels = reinterpret_cast<uint32_t *>(imageBuffer->pPixels);
+
+  for (size_t i = 0; i < 100 * 50; i++)
+    pPixels[i] = 0xFF00FF00;
+
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Resize(imageBuffer, mVec2s(31, 170), mIB_RF_Bicubic));
+  mTEST_ASSERT_EQUAL(imageBuffer->currentSize, mVec2s(31, 170));
+  mTEST_ASSERT_EQUAL(imageBuffer->lineStride, (size_t)31);
+  mTEST_ASSERT_EQUAL(imageBuffer->pixelFormat, mPF_R8G8B8A8);
+
+  pPixels = reinterpret_cast<uint32_t *>(imageBuffer->pPixels);
+
+  for (size_t i = 0; i < 31 * 170; i++)
+    mTEST_ASSERT_EQUAL(pPixels[i], (uint32_t)0xFF00FF00);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestResizeUnsupported)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, mVec2s(16, 16), mPF_R16G16B16A16));
+
+  mPtr<mImageBuffer> target;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&target, pAllocator, mVec2s(8, 8), mPF_R16G16B16A16));
+
+  mTEST_ASSERT_EQUAL(mR_NotSupported, mImageBuffer_ResizeTo(source, target));
+
+  mPtr<mImageBuffer> mismatchedTarget;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&mismatchedTarget, pAllocator, mVec2s(8, 8), mPF_B8G8R8A8));
+
+  mPtr<mImageBuffer> bgraSource;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&bgraSource, pAllocator, mVec2s(16, 16), mPF_R8G8B8A8));
+
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageBuffer_ResizeTo(bgraSource, mismatchedTarget));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mFUNCTION(mImageBufferTest_WriteJpeg, IN mAllocator *pAllocator, const mString &filename, const mVec2s &size)
+{
+  mFUNCTION_SETUP();
+
+  mPtr<mImageBuffer> imageBuffer;
+  mDEFER_CALL(&imageBuffer, mImageBuffer_Destroy);
+  mERROR_CHECK(mImageBuffer_Create(&imageBuffer, pAllocator, size, mPF_R8G8B8A8));
+
+  // Smooth gradients with a few hard edges, so downscaling in the DCT domain and filtering afterwards have something to agree on.
+  for (size_t y = 0; y < size.y; y++)
+  {
+    for (size_t x = 0; x < size.x; x++)
+    {
+      uint8_t *pPixel = imageBuffer->pPixels + (y * size.x + x) * 4;
+
+      pPixel[0] = (uint8_t)((x * 255) / size.x);
+      pPixel[1] = (uint8_t)((y * 255) / size.y);
+      pPixel[2] = (((x / 64) ^ (y / 64)) & 1) ? 200 : 40;
+      pPixel[3] = 0xFF;
+    }
+  }
+
+  mERROR_CHECK(mImageBuffer_SaveAsJpeg(imageBuffer, filename));
+
+  mRETURN_SUCCESS();
+}
+
+mTEST(mImageBuffer, TestJpegDecodeScaled)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mImageBufferTestScaled.jpg";
+  const mVec2s size = mVec2s(1001, 667);
+
+  mTEST_ASSERT_SUCCESS(mImageBufferTest_WriteJpeg(pAllocator, filename, size));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pData = nullptr;
+  size_t dataSize = 0;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mFile_ReadRaw(filename, &pData, pAllocator, &dataSize));
+
+  mPtr<mImageBuffer> fullImage;
+  mDEFER_CALL(&fullImage, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_CreateFromData(&fullImage, pAllocator, pData, dataSize, mPF_R8G8B8A8));
+  mTEST_ASSERT_EQUAL(fullImage->currentSize, size);
+
+  const size_t scaleDenominators[] = { 1, 2, 4, 8 };
+
+  for (const size_t scaleDenominator : scaleDenominators)
+  {
+    mImageBuffer_JpegDecodeParams params;
+    params.scaleDenominator = scaleDenominator;
+
+    mPtr<mImageBuffer> scaledImage;
+    mDEFER_CALL(&scaledImage, mImageBuffer_Destroy);
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&scaledImage, pAllocator));
+    mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(scaledImage, pData, dataSize, params, mPF_R8G8B8A8));
+
+    const mVec2s scaledSize = (size + mVec2s(scaleDenominator - 1)) / scaleDenominator;
+    mTEST_ASSERT_EQUAL(scaledImage->currentSize, scaledSize);
+    mTEST_ASSERT_EQUAL(scaledImage->pixelFormat, mPF_R8G8B8A8);
+
+    mPtr<mImageBuffer> resizedImage;
+    mDEFER_CALL(&resizedImage, mImageBuffer_Destroy);
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&resizedImage, pAllocator, scaledSize, mPF_R8G8B8A8));
+    mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(fullImage, resizedImage, mIB_RF_Box));
+
+    // Both ways of getting to the smaller image have to look alike, apart from the hard edges.
+    size_t difference = 0;
+
+    for (size_t i = 0; i < scaledSize.x * scaledSize.y * 4; i++)
+      difference += (size_t)mAbs((int64_t)scaledImage->pPixels[i] - (int64_t)resizedImage->pPixels[i]);
+
+    mTEST_ASSERT_TRUE(difference < scaledSize.x * scaledSize.y * 4 * 4);
+  }
+
+  mImageBuffer_JpegDecodeParams params;
+  params.scaleDenominator = 3;
+
+  mPtr<mImageBuffer> imageBuffer;
+  mDEFER_CALL(&imageBuffer, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator));
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageBuffer_SetToJpegData(imageBuffer, pData, dataSize, params));
+
+  // Picks the smallest image that's still large enough.
+  params.scaleDenominator = 1;
+  params.minimumSize = mVec2s(200, 100);
+
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(imageBuffer, pData, dataSize, params));
+  mTEST_ASSERT_EQUAL(imageBuffer->currentSize, mVec2s(251, 167));
+
+  params.minimumSize = mVec2s(600, 1);
+
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(imageBuffer, pData, dataSize, params));
+  mTEST_ASSERT_EQUAL(imageBuffer->currentSize, size);
+
+  const uint8_t garbage[64] = { 0xFF, 0xD8, 0xFF };
+  mTEST_ASSERT_EQUAL(mR_ResourceInvalid, mImageBuffer_SetToJpegData(imageBuffer, garbage, sizeof(garbage), mImageBuffer_JpegDecodeParams()));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestJpegDecodeRegion)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mImageBufferTestRegion.jpg";
+  const mVec2s size = mVec2s(1001, 667);
+
+  mTEST_ASSERT_SUCCESS(mImageBufferTest_WriteJpeg(pAllocator, filename, size));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pData = nullptr;
+  size_t dataSize = 0;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mFile_ReadRaw(filename, &pData, pAllocator, &dataSize));
+
+  const mRectangle2D<size_t> regions[] = { mRectangle2D<size_t>(123, 77, 301, 200), mRectangle2D<size_t>(0, 0, 64, 64), mRectangle2D<size_t>(900, 600, 101, 67), mRectangle2D<size_t>(5, 300, 991, 1) };
+  const size_t scaleDenominators[] = { 1, 2 };
+
+  for (const size_t scaleDenominator : scaleDenominators)
+  {
+    mImageBuffer_JpegDecodeParams params;
+    params.scaleDenominator = scaleDenominator;
+
+    mPtr<mImageBuffer> fullImage;
+    mDEFER_CALL(&fullImage, mImageBuffer_Destroy);
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&fullImage, pAllocator));
+    mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(fullImage, pData, dataSize, params, mPF_B8G8R8));
+
+    for (const mRectangle2D<size_t> &region : regions)
+    {
+      params.decodeRegion = true;
+      params.region = region;
+
+      mPtr<mImageBuffer> regionImage;
+      mDEFER_CALL(&regionImage, mImageBuffer_Destroy);
+      mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&regionImage, pAllocator));
+      mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(regionImage, pData, dataSize, params, mPF_B8G8R8));
+
+      const mVec2s start = region.position / scaleDenominator;
+      const mVec2s end = (region.position + region.size + mVec2s(scaleDenominator - 1)) / scaleDenominator;
+      mTEST_ASSERT_EQUAL(regionImage->currentSize, end - start);
+
+      // The region has to be exactly what a full decode would have produced there.
+      for (size_t y = 0; y < end.y - start.y; y++)
+        for (size_t x = 0; x < (end.x - start.x) * 3; x++)
+          mTEST_ASSERT_EQUAL(regionImage->pPixels[y * (end.x - start.x) * 3 + x], fullImage->pPixels[((y + start.y) * fullImage->currentSize.x + start.x) * 3 + x]);
+    }
+  }
+
+  mImageBuffer_JpegDecodeParams params;
+  params.decodeRegion = true;
+
+  mPtr<mImageBuffer> imageBuffer;
+  mDEFER_CALL(&imageBuffer, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&imageBuffer, pAllocator));
+
+  params.region = mRectangle2D<size_t>(1000, 0, 2, 1);
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mImageBuffer_SetToJpegData(imageBuffer, pData, dataSize, params));
+
+  params.region = mRectangle2D<size_t>(0, 0, 0, 1);
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageBuffer_SetToJpegData(imageBuffer, pData, dataSize, params));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestJpegDecodeStream)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mImageBufferTestStream.jpg";
+  const mVec2s size = mVec2s(1920, 1080);
+
+  mTEST_ASSERT_SUCCESS(mImageBufferTest_WriteJpeg(pAllocator, filename, size));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pData = nullptr;
+  size_t dataSize = 0;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mFile_ReadRaw(filename, &pData, pAllocator, &dataSize));
+
+  mImageBuffer_JpegDecodeParams params;
+  params.scaleDenominator = 4;
+
+  mPtr<mImageBuffer> expected;
+  mDEFER_CALL(&expected, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&expected, pAllocator));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(expected, pData, dataSize, params, mPF_B8G8R8A8));
+
+  mPtr<mImageBuffer> fromFile;
+  mDEFER_CALL(&fromFile, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&fromFile, pAllocator));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegFile(fromFile, filename, params, mPF_B8G8R8A8));
+
+  mTEST_ASSERT_EQUAL(fromFile->currentSize, expected->currentSize);
+
+  for (size_t i = 0; i < expected->currentSize.x * expected->currentSize.y * 4; i++)
+    mTEST_ASSERT_EQUAL(fromFile->pPixels[i], expected->pPixels[i]);
+
+  // Small pages, so decoding a strip at the top doesn't end up reading the whole file.
+  mPtr<mCachedFileReader> fileReader;
+  mDEFER_CALL(&fileReader, mCachedFileReader_Destroy);
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_CreatePaged(&fileReader, pAllocator, filename, 4 * 1024, 16, 0));
+
+  params.decodeRegion = true;
+  params.region = mRectangle2D<size_t>(0, 0, size.x, 64);
+
+  mPtr<mImageBuffer> fromStream;
+  mDEFER_CALL(&fromStream, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&fromStream, pAllocator));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegStream(fromStream, fileReader, params, mPF_B8G8R8A8));
+
+  mTEST_ASSERT_EQUAL(fromStream->currentSize, mVec2s(size.x / 4, 16));
+
+  for (size_t i = 0; i < fromStream->currentSize.x * fromStream->currentSize.y * 4; i++)
+    mTEST_ASSERT_EQUAL(fromStream->pPixels[i], expected->pPixels[i]);
+
+  mCachedFileReader_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mCachedFileReader_GetStatistics(fileReader, &statistics));
+  mTEST_ASSERT_TRUE(statistics.missCount * 4 * 1024 < dataSize);
+
+  mTEST_ASSERT_EQUAL(mR_NotSupported, mImageBuffer_SetToJpegFile(fromStream, filename, mImageBuffer_JpegDecodeParams(), mPF_YUV420));
+
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mImageBuffer_SetToJpegFile(fromStream, "mImageBufferTestDoesNotExist.jpg", params));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageBuffer, TestCreateFromFiles)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s sizes[] = { mVec2s(320, 240), mVec2s(97, 211), mVec2s(640, 64) };
+  mString filenames[mARRAYSIZE(sizes)];
+
+  for (size_t i = 0; i < mARRAYSIZE(sizes); i++)
+  {
+    mTEST_ASSERT_SUCCESS(mString_Format(&filenames[i], pAllocator, "mImageBufferTestFiles", i, ".jpg"));
+    mTEST_ASSERT_SUCCESS(mImageBufferTest_WriteJpeg(pAllocator, filenames[i], sizes[i]));
+  }
+
+  mDEFER(
+    for (size_t i = 0; i < mARRAYSIZE(filenames); i++)
+      mFile_Delete(filenames[i]);
+  );
+
+  mPtr<mAsyncFileQueue> asyncFileQueue;
+  mDEFER_CALL(&asyncFileQueue, mAsyncFileQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mAsyncFileQueue_Create(&asyncFileQueue, pAllocator, 2));
+
+  mPtr<mImageBuffer> imageBuffers[mARRAYSIZE(sizes)];
+
+  mDEFER(
+    for (size_t i = 0; i < mARRAYSIZE(imageBuffers); i++)
+      mImageBuffer_Destroy(&imageBuffers[i]);
+  );
+
+  mTEST_ASSERT_SUCCESS(mImageBuffer_CreateFromFiles(asyncFileQueue, imageBuffers, pAllocator, filenames, mARRAYSIZE(filenames)));
+
+  for (size_t i = 0; i < mARRAYSIZE(sizes); i++)
+  {
+    mPtr<mImageBuffer> expected;
+    mDEFER_CALL(&expected, mImageBuffer_Destroy);
+    mTEST_ASSERT_SUCCESS(mImageBuffer_CreateFromFile(&expected, pAllocator, filenames[i], mPF_R8G8B8A8));
+
+    mTEST_ASSERT_TRUE(imageBuffers[i] != nullptr);
+    mTEST_ASSERT_EQUAL(imageBuffers[i]->currentSize, sizes[i]);
+    mTEST_ASSERT_EQUAL(imageBuffers[i]->pixelFormat, expected->pixelFormat);
+    mTEST_ASSERT_EQUAL(imageBuffers[i]->currentSize, expected->currentSize);
+
+    for (size_t j = 0; j < sizes[i].x * sizes[i].y * 4; j++)
+      mTEST_ASSERT_EQUAL(imageBuffers[i]->pPixels[j], expected->pPixels[j]);
+  }
+
+  // A missing file fails, after all pending reads have completed.
+  mString missingFilenames[] = { filenames[0], "mImageBufferTestFilesMissing.jpg" };
+  mPtr<mImageBuffer> missingImageBuffers[mARRAYSIZE(missingFilenames)];
+
+  mDEFER(
+    for (size_t i = 0; i < mARRAYSIZE(missingImageBuffers); i++)
+      mImageBuffer_Destroy(&missingImageBuffers[i]);
+  );
+
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mImageBuffer_CreateFromFiles(asyncFileQueue, missingImageBuffers, pAllocator, missingFilenames, mARRAYSIZE(missingFilenames)));
+  mTEST_ASSERT_TRUE(missingImageBuffers[1] == nullptr);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mImageBuffer, TestJpegDecodeScaledBenchmark)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mImageBufferTestBenchmark.jpg";
+  const mVec2s size = mVec2s(4000, 3000);
+  const mVec2s thumbnailSize = size / 8;
+  const size_t iterations = 4;
+
+  mTEST_ASSERT_SUCCESS(mImageBufferTest_WriteJpeg(pAllocator, filename, size));
+  mDEFER(mFile_Delete(filename));
+
+  uint8_t *pData = nullptr;
+  size_t dataSize = 0;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mFile_ReadRaw(filename, &pData, pAllocator, &dataSize));
+
+  mPtr<mImageBuffer> fullImage;
+  mDEFER_CALL(&fullImage, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&fullImage, pAllocator));
+
+  mPtr<mImageBuffer> thumbnail;
+  mDEFER_CALL(&thumbnail, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&thumbnail, pAllocator, thumbnailSize, mPF_B8G8R8A8));
+
+  int64_t fullDecodeTime = 0;
+
+  for (size_t i = 0; i < iterations; i++)
+  {
+    const int64_t start = mGetCurrentTimeNs();
+    mTEST_ASSERT_SUCCESS(mImageBuffer_SetToData(fullImage, pData, dataSize, mPF_B8G8R8A8));
+    mTEST_ASSERT_SUCCESS(mImageBuffer_ResizeTo(fullImage, thumbnail, mIB_RF_Box));
+    fullDecodeTime += mGetCurrentTimeNs() - start;
+  }
+
+  mImageBuffer_JpegDecodeParams params;
+  params.minimumSize = thumbnailSize;
+
+  int64_t scaledDecodeTime = 0;
+
+  for (size_t i = 0; i < iterations; i++)
+  {
+    const int64_t start = mGetCurrentTimeNs();
+    mTEST_ASSERT_SUCCESS(mImageBuffer_SetToJpegData(thumbnail, pData, dataSize, params, mPF_B8G8R8A8));
+    scaledDecodeTime += mGetCurrentTimeNs() - start;
+  }
+
+  mTEST_ASSERT_EQUAL(thumbnail->currentSize, thumbnailSize);
+
+  mTEST_ASSERT_TRUE(fullDecodeTime / (double_t)scaledDecodeTime > 2.0); // Please don't make this perform terribly. Scaled decoding skips most of the IDCT work and the resize.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
@@ -0,0 +1,304 @@
+#include "mTestLib.h"
+#include "mImageEncoder.h"
+#include "mFile.h"
+
+mFUNCTION(mImageEncoderTest_CreateImage, OUT mPtr<mImageBuffer> *pImageBuffer, IN mAllocator *pAllocator, const mVec2s &size, const size_t seed)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_CHECK(mImageBuffer_Create(pImageBuffer, pAllocator, size, mPF_R8G8B8A8));
+
+  for (size_t y = 0; y < size.y; y++)
+  {
+    for (size_t x = 0; x < size.x; x++)
+    {
+      uint8_t *pPixel = (*pImageBuffer)->pPixels + (y * size.x + x) * 4;
+
+      pPixel[0] = (uint8_t)((x * 255) / size.x + seed);
+      pPixel[1] = (uint8_t)((y * 255) / size.y);
+      pPixel[2] = (((x / 32) ^ (y / 32) ^ seed) & 1) ? 200 : 40;
+      pPixel[3] = 0xFF;
+    }
+  }
+
+  mRETURN_SUCCESS();
+}
+
+mFUNCTION(mImageEncoderTest_GetDifference, mPtr<mImageBuffer> &a, mPtr<mImageBuffer> &b, OUT size_t *pDifference)
+{
+  mFUNCTION_SETUP();
+
+  mERROR_IF(a->currentSize != b->currentSize || a->pixelFormat != mPF_R8G8B8A8 || b->pixelFormat != mPF_R8G8B8A8, mR_ResourceIncompatible);
+
+  size_t difference = 0;
+
+  for (size_t i = 0; i < a->currentSize.x * a->currentSize.y * 4; i++)
+    difference += (size_t)mAbs((int64_t)a->pPixels[i] - (int64_t)b->pPixels[i]);
+
+  *pDifference = difference;
+
+  mRETURN_SUCCESS();
+}
+
+mTEST(mImageEncoder, TestEncodeToMemory)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(321, 123);
+
+  mPtr<mImageBuffer> source;
+  mDEFER_CALL(&source, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoderTest_CreateImage(&source, pAllocator, size, 0));
+
+  mTEST_ASSERT_EQUAL(mR_ArgumentNull, mImageEncoder_Create(nullptr, pAllocator));
+
+  mImageEncoder_Params invalidParams;
+  invalidParams.quality = 0;
+
+  mPtr<mImageEncoder> imageEncoder;
+  mDEFER_CALL(&imageEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageEncoder_Create(&imageEncoder, pAllocator, invalidParams));
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&imageEncoder, pAllocator));
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageEncoder_SetParams(imageEncoder, invalidParams));
+
+  mPtr<mImageBuffer> decoded;
+  mDEFER_CALL(&decoded, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&decoded, pAllocator));
+
+  size_t previousSize = 0;
+  size_t previousDifference = 0;
+
+  for (const size_t quality : { 30, 60, 95 })
+  {
+    mImageEncoder_Params params;
+    params.quality = quality;
+    params.chromaSubsampling = mIE_CS_444;
+
+    mTEST_ASSERT_SUCCESS(mImageEncoder_SetParams(imageEncoder, params));
+
+    mPtr<mBinaryChunk> jpeg;
+    mDEFER_CALL(&jpeg, mBinaryChunk_Destroy);
+    mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(imageEncoder, source, jpeg));
+    mTEST_ASSERT_NOT_EQUAL(jpeg, nullptr);
+
+    mTEST_ASSERT_SUCCESS(mImageBuffer_SetToData(decoded, jpeg->pData, jpeg->writeBytes, mPF_R8G8B8A8));
+    mTEST_ASSERT_EQUAL(decoded->currentSize, size);
+
+    size_t difference = 0;
+    mTEST_ASSERT_SUCCESS(mImageEncoderTest_GetDifference(source, decoded, &difference));
+    mTEST_ASSERT_TRUE(difference < size.x * size.y * 4 * 8);
+
+    // Higher quality has to cost space and buy accuracy.
+    if (previousSize != 0)
+    {
+      mTEST_ASSERT_TRUE(jpeg->writeBytes > previousSize);
+      mTEST_ASSERT_TRUE(difference < previousDifference);
+    }
+
+    previousSize = jpeg->writeBytes;
+    previousDifference = difference;
+
+    // Encoding again appends a second, identical JPEG.
+    mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(imageEncoder, source, jpeg));
+    mTEST_ASSERT_EQUAL(jpeg->writeBytes, previousSize * 2);
+
+    for (size_t i = 0; i < previousSize; i++)
+      mTEST_ASSERT_EQUAL(jpeg->pData[i], jpeg->pData[i + previousSize]);
+  }
+
+  mPtr<mImageBuffer> unsupported;
+  mDEFER_CALL(&unsupported, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&unsupported, pAllocator, size, mPF_Rf32Gf32Bf32));
+
+  mPtr<mBinaryChunk> jpeg;
+  mDEFER_CALL(&jpeg, mBinaryChunk_Destroy);
+  mTEST_ASSERT_EQUAL(mR_NotSupported, mImageEncoder_EncodeToMemory(imageEncoder, unsupported, jpeg));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageEncoder, TestEncodeYuv)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(64, 48);
+
+  // A flat colour, stored as YUV420 planes (BT.601 full range, as used by JPEG).
+  const uint8_t y = 120;
+  const uint8_t u = 90;
+  const uint8_t v = 180;
+
+  mPtr<mImageBuffer> source;
+  mDEFER_CALL(&source, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_YUV420));
+
+  mTEST_ASSERT_SUCCESS(mMemset(source->pPixels, size.x * size.y, y));
+  mTEST_ASSERT_SUCCESS(mMemset(source->pPixels + size.x * size.y, size.x * size.y / 4, u));
+  mTEST_ASSERT_SUCCESS(mMemset(source->pPixels + size.x * size.y * 5 / 4, size.x * size.y / 4, v));
+
+  mPtr<mImageEncoder> imageEncoder;
+  mDEFER_CALL(&imageEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&imageEncoder, pAllocator));
+
+  mPtr<mBinaryChunk> jpeg;
+  mDEFER_CALL(&jpeg, mBinaryChunk_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(imageEncoder, source, jpeg));
+
+  mPtr<mImageBuffer> decoded;
+  mDEFER_CALL(&decoded, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&decoded, pAllocator));
+  mTEST_ASSERT_SUCCESS(mImageBuffer_SetToData(decoded, jpeg->pData, jpeg->writeBytes, mPF_R8G8B8A8));
+  mTEST_ASSERT_EQUAL(decoded->currentSize, size);
+
+  const float_t expected[3] =
+  {
+    y + 1.402f * (v - 128),
+    y - 0.344136f * (u - 128) - 0.714136f * (v - 128),
+    y + 1.772f * (u - 128),
+  };
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    for (size_t channel = 0; channel < 3; channel++)
+      mTEST_ASSERT_TRUE(mAbs((float_t)decoded->pPixels[i * 4 + channel] - mClamp(expected[channel], 0.f, 255.f)) <= 3.f);
+
+  // The planes can't be padded.
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_YUV420));
+  source->currentSize = mVec2s(size.x - 16, size.y);
+
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mImageEncoder_EncodeToMemory(imageEncoder, source, jpeg));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageEncoder, TestBatch)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const size_t count = 24;
+
+  mPtr<mImageBuffer> images[count];
+  mPtr<mBinaryChunk> serialJpegs[count];
+  mPtr<mBinaryChunk> threadedJpegs[count];
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mImageEncoderTest_CreateImage(&images[i], pAllocator, mVec2s(100 + i * 7, 80 + i * 3), i));
+
+  mPtr<mImageEncoder> serialEncoder;
+  mDEFER_CALL(&serialEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&serialEncoder, pAllocator));
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(serialEncoder, images, serialJpegs, count));
+
+  mPtr<mImageEncoder> threadedEncoder;
+  mDEFER_CALL(&threadedEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&threadedEncoder, pAllocator, mImageEncoder_Params(), threadPool));
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(threadedEncoder, images, threadedJpegs, count));
+
+  // Compressors are reused for images of different sizes, which mustn't change the output.
+  for (size_t i = 0; i < count; i++)
+  {
+    mTEST_ASSERT_NOT_EQUAL(threadedJpegs[i], nullptr);
+    mTEST_ASSERT_EQUAL(serialJpegs[i]->writeBytes, threadedJpegs[i]->writeBytes);
+
+    for (size_t j = 0; j < serialJpegs[i]->writeBytes; j++)
+      mTEST_ASSERT_EQUAL(serialJpegs[i]->pData[j], threadedJpegs[i]->pData[j]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImageEncoder, TestEncodeToFiles)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const size_t count = 4;
+  const mString filenames[count] = { "mImageEncoderTest0.jpg", "mImageEncoderTest1.jpg", "mImageEncoderTest2.jpg", "mImageEncoderTest3.jpg" };
+
+  mPtr<mImageBuffer> images[count];
+
+  mDEFER(
+    for (size_t i = 0; i < count; i++)
+      mFile_Delete(filenames[i]);
+  );
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mImageEncoderTest_CreateImage(&images[i], pAllocator, mVec2s(200, 100 + i), i));
+
+  mPtr<mImageEncoder> imageEncoder;
+  mDEFER_CALL(&imageEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&imageEncoder, pAllocator, mImageEncoder_Params(), threadPool));
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToFiles(imageEncoder, images, filenames, count));
+
+  mPtr<mImageBuffer> decoded;
+  mDEFER_CALL(&decoded, mImageBuffer_Destroy);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    mTEST_ASSERT_SUCCESS(mImageBuffer_CreateFromFile(&decoded, pAllocator, filenames[i], mPF_R8G8B8A8));
+    mTEST_ASSERT_EQUAL(decoded->currentSize, images[i]->currentSize);
+
+    size_t difference = 0;
+    mTEST_ASSERT_SUCCESS(mImageEncoderTest_GetDifference(images[i], decoded, &difference));
+    mTEST_ASSERT_TRUE(difference < decoded->currentSize.x * decoded->currentSize.y * 4 * 8);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mImageEncoder, TestBatchBenchmark)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const size_t count = 64;
+  const mVec2s size = mVec2s(640, 360);
+
+  mPtr<mImageBuffer> image;
+  mDEFER_CALL(&image, mImageBuffer_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoderTest_CreateImage(&image, pAllocator, size, 0));
+
+  mPtr<mImageBuffer> images[count];
+  mPtr<mBinaryChunk> jpegs[count];
+
+  for (size_t i = 0; i < count; i++)
+    images[i] = image;
+
+  mPtr<mImageEncoder> serialEncoder;
+  mDEFER_CALL(&serialEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&serialEncoder, pAllocator));
+
+  const int64_t serialStart = mGetCurrentTimeNs();
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(serialEncoder, images, jpegs, count));
+  const int64_t serialTime = mGetCurrentTimeNs() - serialStart;
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mBinaryChunk_Destroy(&jpegs[i]));
+
+  mPtr<mImageEncoder> threadedEncoder;
+  mDEFER_CALL(&threadedEncoder, mImageEncoder_Destroy);
+  mTEST_ASSERT_SUCCESS(mImageEncoder_Create(&threadedEncoder, pAllocator, mImageEncoder_Params(), threadPool));
+
+  const int64_t threadedStart = mGetCurrentTimeNs();
+  mTEST_ASSERT_SUCCESS(mImageEncoder_EncodeToMemory(threadedEncoder, images, jpegs, count));
+  const int64_t threadedTime = mGetCurrentTimeNs() - threadedStart;
+
+  size_t threadCount = 0;
+  mTEST_ASSERT_SUCCESS(mThreadPool_GetThreadCount(threadPool, &threadCount));
+
+  if (threadCount >= 4)
+    mTEST_ASSERT_TRUE(serialTime / (double_t)threadedTime > 2.0); // Please don't make this scale terribly.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
@@ -0,0 +1,177 @@
+#include "mTestLib.h"
+#include "mImagePyramid.h"
+
+mTEST(mImagePyramid, TestCreate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(37, 10);
+  const mVec2s levelSizes[] = { mVec2s(37, 10), mVec2s(18, 5), mVec2s(9, 2), mVec2s(4, 1), mVec2s(2, 1), mVec2s(1, 1) };
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_R8G8B8A8));
+
+  for (size_t i = 0; i < source->allocatedSize; i++)
+    source->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+
+  mTEST_ASSERT_EQUAL(mR_ArgumentNull, mImagePyramid_Create(nullptr, pAllocator, source));
+
+  mPtr<mImagePyramid> imagePyramid;
+  mDEFER_CALL(&imagePyramid, mImagePyramid_Destroy);
+  mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&imagePyramid, pAllocator, source));
+
+  size_t levelCount = 0;
+  mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevelCount(imagePyramid, &levelCount));
+  mTEST_ASSERT_EQUAL(levelCount, mARRAYSIZE(levelSizes));
+
+  // All levels are tightly packed into a single allocation.
+  const uint8_t *pExpectedPixels = imagePyramid->pData;
+
+  for (size_t i = 0; i < levelCount; i++)
+  {
+    mPtr<mImageBuffer> level;
+    mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevel(imagePyramid, i, &level));
+
+    mTEST_ASSERT_EQUAL(level->currentSize, levelSizes[i]);
+    mTEST_ASSERT_EQUAL(level->pixelFormat, mPF_R8G8B8A8);
+    mTEST_ASSERT_EQUAL(level->pPixels, pExpectedPixels);
+    mTEST_ASSERT_FALSE(level->ownedResource);
+
+    pExpectedPixels += levelSizes[i].x * levelSizes[i].y * 4;
+  }
+
+  mTEST_ASSERT_EQUAL(pExpectedPixels, imagePyramid->pData + imagePyramid->dataSize);
+
+  mPtr<mImageBuffer> level;
+  mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mImagePyramid_GetLevel(imagePyramid, levelCount, &level));
+
+  // The first level is an exact copy.
+  mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevel(imagePyramid, 0, &level));
+
+  for (size_t i = 0; i < source->allocatedSize; i++)
+    mTEST_ASSERT_EQUAL(level->pPixels[i], source->pPixels[i]);
+
+  mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&imagePyramid, pAllocator, source, mIB_RF_Kaiser, true, 3));
+  mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevelCount(imagePyramid, &levelCount));
+  mTEST_ASSERT_EQUAL(levelCount, (size_t)3);
+
+  mPtr<mImageBuffer> unsupported;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&unsupported, pAllocator, size, mPF_YUV420));
+  mTEST_ASSERT_EQUAL(mR_NotSupported, mImagePyramid_Create(&imagePyramid, pAllocator, unsupported));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImagePyramid, TestConstant)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mVec2s size = mVec2s(123, 45);
+  const mImageBuffer_ResizeFilter filters[] = { mIB_RF_Box, mIB_RF_Kaiser };
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_B8G8R8A8));
+
+  uint32_t *pSource = reinterpret_cast<uint32_t *>(source->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    pSource[i] = 0x7F20C0E0;
+
+  for (const mImageBuffer_ResizeFilter filter : filters)
+  {
+    for (size_t gammaCorrect = 0; gammaCorrect < 2; gammaCorrect++)
+    {
+      mPtr<mImagePyramid> imagePyramid;
+      mDEFER_CALL(&imagePyramid, mImagePyramid_Destroy);
+      mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&imagePyramid, pAllocator, source, filter, gammaCorrect != 0));
+
+      // sRGB values survive the way through linear space unchanged, so a flat image has to stay flat on every level.
+      const uint32_t *pPixels = reinterpret_cast<const uint32_t *>(imagePyramid->pData);
+
+      for (size_t i = 0; i < imagePyramid->dataSize / sizeof(uint32_t); i++)
+        mTEST_ASSERT_EQUAL(pPixels[i], (uint32_t)0x7F20C0E0);
+    }
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImagePyramid, TestGammaCorrect)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  // Two black and two white pixels with opaque alpha.
+  const uint32_t pixels[] = { 0xFF000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFF000000 };
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, pixels, mVec2s(2, 2), mPF_R8G8B8A8));
+
+  mPtr<mImagePyramid> imagePyramid;
+  mDEFER_CALL(&imagePyramid, mImagePyramid_Destroy);
+  mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&imagePyramid, pAllocator, source));
+
+  mPtr<mImageBuffer> level;
+  mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevel(imagePyramid, 1, &level));
+  mTEST_ASSERT_EQUAL(level->currentSize, mVec2s(1, 1));
+
+  // Half the light is sRGB 188, not 128.
+  for (size_t channel = 0; channel < 3; channel++)
+    mTEST_ASSERT_TRUE(mAbs((int64_t)level->pPixels[channel] - 188) <= 1);
+
+  mTEST_ASSERT_EQUAL(level->pPixels[3], (uint8_t)0xFF);
+
+  mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&imagePyramid, pAllocator, source, mIB_RF_Box, false));
+  mTEST_ASSERT_SUCCESS(mImagePyramid_GetLevel(imagePyramid, 1, &level));
+
+  for (size_t channel = 0; channel < 3; channel++)
+    mTEST_ASSERT_TRUE(mAbs((int64_t)level->pPixels[channel] - 128) <= 1);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mImagePyramid, TestThreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const mVec2s size = mVec2s(1000, 701);
+  const mPixelFormat pixelFormats[] = { mPF_R8G8B8A8, mPF_Rf32Gf32Bf32 };
+
+  for (const mPixelFormat pixelFormat : pixelFormats)
+  {
+    mPtr<mImageBuffer> source;
+    mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, pixelFormat));
+
+    if (pixelFormat == mPF_Rf32Gf32Bf32)
+    {
+      float_t *pSource = reinterpret_cast<float_t *>(source->pPixels);
+
+      for (size_t i = 0; i < source->allocatedSize / sizeof(float_t); i++)
+        pSource[i] = (float_t)((i * 0x9E3779B1) & 0xFFFF) / (float_t)0xFFFF;
+    }
+    else
+    {
+      for (size_t i = 0; i < source->allocatedSize; i++)
+        source->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+    }
+
+    mPtr<mImagePyramid> serialPyramid;
+    mDEFER_CALL(&serialPyramid, mImagePyramid_Destroy);
+    mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&serialPyramid, pAllocator, source, mIB_RF_Kaiser));
+
+    mPtr<mImagePyramid> threadedPyramid;
+    mDEFER_CALL(&threadedPyramid, mImagePyramid_Destroy);
+    mTEST_ASSERT_SUCCESS(mImagePyramid_Create(&threadedPyramid, pAllocator, source, mIB_RF_Kaiser, true, 0, threadPool));
+
+    mTEST_ASSERT_EQUAL(serialPyramid->levelCount, threadedPyramid->levelCount);
+    mTEST_ASSERT_EQUAL(serialPyramid->dataSize, threadedPyramid->dataSize);
+
+    for (size_t i = 0; i < serialPyramid->dataSize; i++)
+      mTEST_ASSERT_EQUAL(serialPyramid->pData[i], threadedPyramid->pData[i]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -0,0 +1,188 @@
+#include "mTestLib.h"
+#include "mPagedArray.h"
+
+mTEST(mPagedArray, TestCreate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mTEST_ASSERT_EQUAL(mR_ArgumentNull, mPagedArray_Create((mPtr<mPagedArray<size_t>> *)nullptr, pAllocator));
+
+  mPtr<mPagedArray<mDummyDestructible>> pagedArray;
+  mDEFER_CALL(&pagedArray, mPagedArray_Destroy);
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mPagedArray_Create(&pagedArray, pAllocator, 0));
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mPagedArray_Create(&pagedArray, pAllocator, 48));
+  mTEST_ASSERT_SUCCESS(mPagedArray_Create(&pagedArray, pAllocator));
+
+  for (size_t i = 0; i < 1024; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mDummyDestructible_Create(&dummy, pAllocator));
+    mTEST_ASSERT_SUCCESS(mPagedArray_PushBack(pagedArray, &dummy));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPagedArray, TestPushRemove)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mPagedArray<size_t>> pagedArray;
+  mDEFER_CALL(&pagedArray, mPagedArray_Destroy);
+  mTEST_ASSERT_SUCCESS(mPagedArray_Create(&pagedArray, pAllocator, 8));
+
+  std::vector<size_t> comparisonVector;
+  size_t seed = 0;
+  size_t value;
+
+  for (size_t i = 0; i < 2000; i++)
+  {
+    seed += i + seed * 0xDEADF00D;
+
+    const size_t count = comparisonVector.size();
+
+    switch (seed % 4)
+    {
+    case 0:
+    case 1:
+      mTEST_ASSERT_SUCCESS(mPagedArray_PushBack(pagedArray, &seed));
+      comparisonVector.push_back(seed);
+      break;
+
+    case 2:
+      if (count > 0)
+      {
+        const size_t index = (seed + 0xDEADF00D) % count;
+
+        mTEST_ASSERT_SUCCESS(mPagedArray_SwapRemoveAt(pagedArray, index, &value));
+        mTEST_ASSERT_EQUAL(value, comparisonVector[index]);
+
+        comparisonVector[index] = comparisonVector.back();
+        comparisonVector.pop_back();
+      }
+      else
+      {
+        mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mPagedArray_SwapRemoveAt(pagedArray, 0, &value));
+      }
+
+      break;
+
+    case 3:
+      if (count > 0)
+      {
+        mTEST_ASSERT_SUCCESS(mPagedArray_PopBack(pagedArray, &value));
+        mTEST_ASSERT_EQUAL(value, comparisonVector.back());
+
+        comparisonVector.pop_back();
+      }
+      else
+      {
+        mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mPagedArray_PopBack(pagedArray, &value));
+      }
+
+      break;
+    }
+
+    size_t pagedArrayCount = (size_t)-1;
+    mTEST_ASSERT_SUCCESS(mPagedArray_GetCount(pagedArray, &pagedArrayCount));
+    mTEST_ASSERT_EQUAL(pagedArrayCount, comparisonVector.size());
+  }
+
+  for (size_t i = 0; i < comparisonVector.size(); i++)
+  {
+    mTEST_ASSERT_SUCCESS(mPagedArray_PeekAt(pagedArray, i, &value));
+    mTEST_ASSERT_EQUAL(value, comparisonVector[i]);
+  }
+
+  mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mPagedArray_PeekAt(pagedArray, comparisonVector.size(), &value));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPagedArray, TestPointerStability)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mPagedArray<size_t>> pagedArray;
+  mDEFER_CALL(&pagedArray, mPagedArray_Destroy);
+  mTEST_ASSERT_SUCCESS(mPagedArray_Create(&pagedArray, pAllocator, 4));
+
+  const size_t count = 1000;
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mPagedArray_PushBack(pagedArray, &i));
+
+  size_t *pItems[count];
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mPagedArray_PointerAt(pagedArray, i, &pItems[i]));
+
+  // Growing the array mustn't move existing items.
+  for (size_t i = count; i < count * 10; i++)
+    mTEST_ASSERT_SUCCESS(mPagedArray_PushBack(pagedArray, &i));
+
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t *pItem = nullptr;
+    mTEST_ASSERT_SUCCESS(mPagedArray_PointerAt(pagedArray, i, &pItem));
+    mTEST_ASSERT_EQUAL(pItem, pItems[i]);
+    mTEST_ASSERT_EQUAL(*pItem, i);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPagedArray, TestForEachParallel)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  mPtr<mPagedArray<size_t>> pagedArray;
+  mDEFER_CALL(&pagedArray, mPagedArray_Destroy);
+  mTEST_ASSERT_SUCCESS(mPagedArray_Create(&pagedArray, pAllocator, 16));
+
+  const size_t count = 10000 + 7;
+
+  for (size_t i = 0; i < count; i++)
+    mTEST_ASSERT_SUCCESS(mPagedArray_PushBack(pagedArray, &i));
+
+  mTEST_ASSERT_SUCCESS(mPagedArray_ForEachParallel(pagedArray, threadPool, (std::function<mResult(size_t *, size_t)>)[](size_t *pItem, size_t index)
+  {
+    if (*pItem != index)
+      return mR_Failure;
+
+    *pItem *= 2;
+
+    return mR_Success;
+  }));
+
+  size_t visited = 0;
+
+  mTEST_ASSERT_SUCCESS(mPagedArray_ForEach(pagedArray, (std::function<mResult(size_t *, size_t)>)[&](size_t *pItem, size_t index)
+  {
+    if (*pItem != index * 2)
+      return mR_Failure;
+
+    visited++;
+
+    return mR_Success;
+  }));
+
+  mTEST_ASSERT_EQUAL(visited, count);
+
+  mTEST_ASSERT_EQUAL(mR_InternalError, mPagedArray_ForEachParallel(pagedArray, threadPool, (std::function<mResult(size_t *, size_t)>)[](size_t *, size_t index)
+  {
+    return index == 1234 ? mR_InternalError : mR_Success;
+  }));
+
+  // `mR_Break` stops early without failing, just like in `mPagedArray_ForEach`.
+  mTEST_ASSERT_SUCCESS(mPagedArray_ForEachParallel(pagedArray, threadPool, (std::function<mResult(size_t *, size_t)>)[](size_t *, size_t index)
+  {
+    return index == 1234 ? mR_Break : mR_Success;
+  }));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -422,3 +422,71 @@ mTEST(mPixelFormat, TestConvertYuv411ToYuv420)
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
+
+mTEST(mPixelFormat, TestConvertRgbaToBgraThreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  // Odd height, so that the last band isn't full.
+  const mVec2s size = mVec2s(1001, 603);
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_R8G8B8A8));
+
+  uint32_t *pSource = reinterpret_cast<uint32_t *>(source->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    pSource[i] = (uint32_t)(i * 0x9E3779B1);
+
+  mPtr<mImageBuffer> target;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&target, pAllocator, size, mPF_B8G8R8A8));
+  mTEST_ASSERT_SUCCESS(mPixelFormat_TransformBuffer(source, target, threadPool));
+
+  const uint32_t *pTarget = reinterpret_cast<const uint32_t *>(target->pPixels);
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    mTEST_ASSERT_EQUAL(pTarget[i], (pSource[i] & 0xFF00FF00) | ((pSource[i] & 0x00FF0000) >> 0x10) | ((pSource[i] & 0x000000FF) << 0x10));
+
+  mTEST_ASSERT_SUCCESS(mPixelFormat_InplaceTransformBuffer(target, mPF_R8G8B8A8, threadPool));
+
+  for (size_t i = 0; i < size.x * size.y; i++)
+    mTEST_ASSERT_EQUAL(pTarget[i], pSource[i]);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPixelFormat, TestConvertYuv444ToYuv420Threaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr));
+
+  const mVec2s size = mVec2s(1920, 1082);
+
+  mPtr<mImageBuffer> source;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&source, pAllocator, size, mPF_YUV444));
+
+  for (size_t i = 0; i < source->allocatedSize; i++)
+    source->pPixels[i] = (uint8_t)((i * 0x9E3779B1) >> 7);
+
+  mPtr<mImageBuffer> serialTarget;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&serialTarget, pAllocator, size, mPF_YUV420));
+  mTEST_ASSERT_SUCCESS(mPixelFormat_TransformBuffer(source, serialTarget));
+
+  mPtr<mImageBuffer> threadedTarget;
+  mTEST_ASSERT_SUCCESS(mImageBuffer_Create(&threadedTarget, pAllocator, size, mPF_YUV420));
+  mTEST_ASSERT_SUCCESS(mPixelFormat_TransformBuffer(source, threadedTarget, threadPool));
+
+  mTEST_ASSERT_EQUAL(serialTarget->allocatedSize, threadedTarget->allocatedSize);
+
+  for (size_t i = 0; i < serialTarget->allocatedSize; i++)
+    mTEST_ASSERT_EQUAL(serialTarget->pPixels[i], threadedTarget->pPixels[i]);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -105,6 +105,48 @@ mTEST(mPool, TestAddRemove)
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
 
+mTEST(mPool, TestReuseFreedIndexes)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mPool<size_t>> pool;
+  mDEFER_CALL(&pool, mPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mPool_Create(&pool, pAllocator));
+
+  // Enough indexes for multiple words of available blocks.
+  const size_t count = mBITS_OF(size_t) * mBITS_OF(size_t) * 3;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t index;
+    mTEST_ASSERT_SUCCESS(mPool_Add(pool, &i, &index));
+    mTEST_ASSERT_EQUAL(i, index);
+  }
+
+  const size_t lowIndex = 5;
+  const size_t highIndex = mBITS_OF(size_t) * mBITS_OF(size_t) * 2 + 7;
+
+  size_t value;
+  mTEST_ASSERT_SUCCESS(mPool_RemoveAt(pool, highIndex, &value));
+  mTEST_ASSERT_SUCCESS(mPool_RemoveAt(pool, lowIndex, &value));
+
+  // Freed indexes are reused lowest first, before the pool grows.
+  const size_t expectedIndexes[] = { lowIndex, highIndex, count };
+
+  for (size_t expectedIndex : expectedIndexes)
+  {
+    size_t index;
+    mTEST_ASSERT_SUCCESS(mPool_Add(pool, &expectedIndex, &index));
+    mTEST_ASSERT_EQUAL(expectedIndex, index);
+  }
+
+  size_t poolCount = 0;
+  mTEST_ASSERT_SUCCESS(mPool_GetCount(pool, &poolCount));
+  mTEST_ASSERT_EQUAL(count + 1, poolCount);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
 mTEST(mPool, TestIterate)
 {
   mTEST_ALLOCATOR_SETUP();
@@ -287,6 +329,121 @@ mTEST(mPool, TestContainsIndex)
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
 
+mTEST(mPool, TestHandles)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mPool<size_t>> pool;
+  mDEFER_CALL(&pool, mPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mPool_Create(&pool, pAllocator));
+
+  size_t value = 10;
+  size_t index;
+  mTEST_ASSERT_SUCCESS(mPool_Add(pool, &value, &index));
+
+  mPoolHandle handle;
+  mTEST_ASSERT_SUCCESS(mPool_GetHandle(pool, index, &handle));
+  mTEST_ASSERT_EQUAL(index, handle.index);
+
+  size_t *pValue = nullptr;
+  mTEST_ASSERT_SUCCESS(mPool_PointerAt(pool, handle, &pValue));
+  mTEST_ASSERT_EQUAL((size_t)10, *pValue);
+
+  mTEST_ASSERT_SUCCESS(mPool_RemoveAt(pool, handle, &value));
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mPool_RemoveAt(pool, handle, &value));
+
+  // The index is reused, but the old handle must not refer to the new item.
+  value = 20;
+  size_t newIndex;
+  mTEST_ASSERT_SUCCESS(mPool_Add(pool, &value, &newIndex));
+  mTEST_ASSERT_EQUAL(index, newIndex);
+
+  bool contained = true;
+  mTEST_ASSERT_SUCCESS(mPool_ContainsHandle(pool, handle, &contained));
+  mTEST_ASSERT_FALSE(contained);
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mPool_PointerAt(pool, handle, &pValue));
+
+  mPoolHandle newHandle;
+  mTEST_ASSERT_SUCCESS(mPool_GetHandle(pool, newIndex, &newHandle));
+  mTEST_ASSERT_SUCCESS(mPool_ContainsHandle(pool, newHandle, &contained));
+  mTEST_ASSERT_TRUE(contained);
+
+  mTEST_ASSERT_SUCCESS(mPool_Clear(pool));
+  mTEST_ASSERT_SUCCESS(mPool_ContainsHandle(pool, newHandle, &contained));
+  mTEST_ASSERT_FALSE(contained);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPool, TestCompact)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mPool<size_t>> pool;
+  mDEFER_CALL(&pool, mPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mPool_Create(&pool, pAllocator));
+
+  const size_t testSize = 1000;
+
+  for (size_t i = 0; i < testSize; i++)
+  {
+    size_t index;
+    mTEST_ASSERT_SUCCESS(mPool_Add(pool, &i, &index));
+  }
+
+  // Keep every seventh item.
+  for (size_t i = 0; i < testSize; i++)
+  {
+    if (i % 7 != 0)
+    {
+      size_t value;
+      mTEST_ASSERT_SUCCESS(mPool_RemoveAt(pool, i, &value));
+    }
+  }
+
+  mPoolHandle movedHandle;
+  mTEST_ASSERT_SUCCESS(mPool_GetHandle(pool, 994, &movedHandle));
+
+  size_t movedCount = 0;
+
+  mTEST_ASSERT_SUCCESS(mPool_Compact(pool, [&](const size_t previousIndex, const size_t newIndex)
+  {
+    if (previousIndex <= newIndex)
+      return mR_Failure;
+
+    movedCount++;
+
+    return mR_Success;
+  }));
+
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mPool_GetCount(pool, &count));
+  mTEST_ASSERT_EQUAL((testSize + 6) / 7, count);
+  mTEST_ASSERT_NOT_EQUAL((size_t)0, movedCount);
+
+  // All items are stored at the beginning of the pool.
+  size_t sum = 0;
+  size_t expectedIndex = 0;
+
+  for (const auto &_item : pool->Iterate())
+  {
+    mTEST_ASSERT_EQUAL(expectedIndex, _item.index);
+    mTEST_ASSERT_EQUAL((size_t)0, *_item % 7);
+
+    sum += *_item;
+    expectedIndex++;
+  }
+
+  mTEST_ASSERT_EQUAL(count, expectedIndex);
+  mTEST_ASSERT_EQUAL((size_t)(7 * (count - 1) * count / 2), sum);
+
+  bool contained = true;
+  mTEST_ASSERT_SUCCESS(mPool_ContainsHandle(pool, movedHandle, &contained));
+  mTEST_ASSERT_FALSE(contained);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
 mTEST(mPool, TestClear)
 {
   mTEST_ALLOCATOR_SETUP();
@@ -0,0 +1,162 @@
+#include "mTestLib.h"
+#include "mPooledAllocator.h"
+
+#include <thread>
+
+mTEST(mPooledAllocator, TestSizeClasses)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mTEST_ASSERT_EQUAL((size_t)0, mPooledAllocator_GetSizeClass(1));
+  mTEST_ASSERT_EQUAL((size_t)0, mPooledAllocator_GetSizeClass(16));
+  mTEST_ASSERT_EQUAL((size_t)1, mPooledAllocator_GetSizeClass(17));
+  mTEST_ASSERT_EQUAL(mPooledAllocator_SmallSizeClassCount - 1, mPooledAllocator_GetSizeClass(1024));
+  mTEST_ASSERT_EQUAL(mPooledAllocator_SmallSizeClassCount, mPooledAllocator_GetSizeClass(1025));
+  mTEST_ASSERT_EQUAL(mPooledAllocator_SizeClassCount - 2, mPooledAllocator_GetSizeClass(32 * 1024));
+  mTEST_ASSERT_EQUAL(mPooledAllocator_SizeClassCount - 1, mPooledAllocator_GetSizeClass(32 * 1024 + 1));
+  mTEST_ASSERT_EQUAL(mPooledAllocator_SizeClassCount - 1, mPooledAllocator_GetSizeClass(1024 * 1024 * 1024));
+
+  for (size_t i = 0; i < mPooledAllocator_SizeClassCount - 1; i++)
+  {
+    mTEST_ASSERT_EQUAL(i, mPooledAllocator_GetSizeClass(mPooledAllocator_GetSizeClassMaxBytes(i)));
+    mTEST_ASSERT_EQUAL(i + 1, mPooledAllocator_GetSizeClass(mPooledAllocator_GetSizeClassMaxBytes(i) + 1));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPooledAllocator, TestStatistics)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mAllocator pooledAllocator;
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_Create(&pooledAllocator));
+  mDEFER_CALL(&pooledAllocator, mAllocator_Destroy);
+
+  mPooledAllocator_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveBytes, (size_t)0);
+  mTEST_ASSERT_EQUAL(statistics.totalAllocationCount, (size_t)0);
+
+  uint8_t *pSmall[100];
+  uint8_t *pLarge = nullptr;
+
+  for (size_t i = 0; i < mARRAYSIZE(pSmall); i++)
+  {
+    pSmall[i] = nullptr;
+    mTEST_ASSERT_SUCCESS(mAllocator_Allocate(&pooledAllocator, &pSmall[i], 24));
+  }
+
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(&pooledAllocator, &pLarge, 1024 * 1024));
+
+  for (size_t i = 0; i < 1024 * 1024; i += 4096)
+    mTEST_ASSERT_EQUAL(pLarge[i], (uint8_t)0);
+
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCount, (size_t)mARRAYSIZE(pSmall) + 1);
+  mTEST_ASSERT_EQUAL(statistics.totalAllocationCount, (size_t)mARRAYSIZE(pSmall) + 1);
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCountPerSizeClass[mPooledAllocator_SizeClassCount - 1], (size_t)1);
+  mTEST_ASSERT_TRUE(statistics.liveBytes >= mARRAYSIZE(pSmall) * 24 + 1024 * 1024);
+  mTEST_ASSERT_EQUAL(statistics.liveBytes, statistics.highWaterMarkBytes);
+
+  const size_t highWaterMarkBytes = statistics.highWaterMarkBytes;
+
+  mTEST_ASSERT_SUCCESS(mAllocator_FreePtr(&pooledAllocator, &pLarge));
+
+  // Reallocations keep their contents and move between size classes.
+  pSmall[0][0] = 0xAB;
+  mTEST_ASSERT_SUCCESS(mAllocator_Reallocate(&pooledAllocator, &pSmall[0], 4096));
+  mTEST_ASSERT_EQUAL(pSmall[0][0], (uint8_t)0xAB);
+
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCount, (size_t)mARRAYSIZE(pSmall));
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCountPerSizeClass[mPooledAllocator_SizeClassCount - 1], (size_t)0);
+  mTEST_ASSERT_EQUAL(statistics.highWaterMarkBytes, highWaterMarkBytes);
+  mTEST_ASSERT_TRUE(statistics.liveBytes < highWaterMarkBytes);
+
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_ResetHighWaterMark(&pooledAllocator));
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveBytes, statistics.highWaterMarkBytes);
+
+  for (size_t i = 0; i < mARRAYSIZE(pSmall); i++)
+    mTEST_ASSERT_SUCCESS(mAllocator_FreePtr(&pooledAllocator, &pSmall[i]));
+
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveBytes, (size_t)0);
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCount, (size_t)0);
+
+  mAllocator untrackedAllocator;
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_Create(&untrackedAllocator, false));
+  mDEFER_CALL(&untrackedAllocator, mAllocator_Destroy);
+
+  mTEST_ASSERT_EQUAL(mR_ResourceStateInvalid, mPooledAllocator_GetStatistics(&untrackedAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mPooledAllocator_GetStatistics(pAllocator, &statistics));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mPooledAllocator, TestMultithreaded)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t threadCount = 8;
+  const size_t allocationCount = 10000;
+
+  mAllocator pooledAllocator;
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_Create(&pooledAllocator));
+  mDEFER_CALL(&pooledAllocator, mAllocator_Destroy);
+
+  uint8_t **ppAllocations = nullptr;
+  mDEFER_CALL(&ppAllocations, mFreePtr);
+  mTEST_ASSERT_SUCCESS(mAllocZero(&ppAllocations, threadCount * allocationCount));
+
+  std::thread threads[threadCount];
+  mResult results[threadCount];
+
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    results[i] = mR_Success;
+
+    threads[i] = std::thread([&, i]()
+    {
+      for (size_t j = 0; j < allocationCount && mSUCCEEDED(results[i]); j++)
+        results[i] = mAllocator_Allocate(&pooledAllocator, &ppAllocations[i * allocationCount + j], 1 + (j % 256));
+    });
+  }
+
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    threads[i].join();
+    mTEST_ASSERT_SUCCESS(results[i]);
+  }
+
+  mPooledAllocator_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCount, threadCount * allocationCount);
+  mTEST_ASSERT_EQUAL(statistics.totalAllocationCount, threadCount * allocationCount);
+
+  // Free everything from other threads than the ones that allocated it.
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    threads[i] = std::thread([&, i]()
+    {
+      const size_t allocatingThread = (i + 1) % threadCount;
+
+      for (size_t j = 0; j < allocationCount && mSUCCEEDED(results[i]); j++)
+        results[i] = mAllocator_FreePtr(&pooledAllocator, &ppAllocations[allocatingThread * allocationCount + j]);
+    });
+  }
+
+  for (size_t i = 0; i < threadCount; i++)
+  {
+    threads[i].join();
+    mTEST_ASSERT_SUCCESS(results[i]);
+  }
+
+  mTEST_ASSERT_SUCCESS(mPooledAllocator_GetStatistics(&pooledAllocator, &statistics));
+  mTEST_ASSERT_EQUAL(statistics.liveAllocationCount, (size_t)0);
+  mTEST_ASSERT_EQUAL(statistics.liveBytes, (size_t)0);
+  mTEST_ASSERT_TRUE(statistics.highWaterMarkBytes >= threadCount * allocationCount);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
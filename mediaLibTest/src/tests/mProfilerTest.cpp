@@ -0,0 +1,201 @@
+#include "mTestLib.h"
+#include "mProfiler.h"
+#include "mFile.h"
+
+#include <thread>
+
+mTEST(mProfiler, TestInternName)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  char name[] = "mProfilerTest_TestInternName";
+
+  const mProfiler_NameId nameId = mProfiler_InternName(name);
+  mTEST_ASSERT_NOT_EQUAL(nameId, (mProfiler_NameId)0);
+
+  // Same contents, different address.
+  mTEST_ASSERT_EQUAL(nameId, mProfiler_InternName("mProfilerTest_TestInternName"));
+  mTEST_ASSERT_NOT_EQUAL(nameId, mProfiler_InternName("mProfilerTest_TestInternName2"));
+
+  mTEST_ASSERT_EQUAL(0, strcmp(mProfiler_GetName(nameId), name));
+  mTEST_ASSERT_EQUAL(nullptr, mProfiler_GetName(0));
+  mTEST_ASSERT_EQUAL((mProfiler_NameId)0, mProfiler_InternName(nullptr));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mProfiler, TestWriteToChromiumTraceEventFile)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mProfilerTest.json";
+
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mProfiler_Allocate(1000));
+  mTEST_ASSERT_SUCCESS(mProfiler_Allocate(1024));
+  mTEST_ASSERT_SUCCESS(mProfiler_Enable());
+  mDEFER(mProfiler_Disable());
+
+  mTEST_ASSERT_SUCCESS(mProfiler_Reset());
+
+  {
+    mPROFILE_SCOPED("mProfilerTest Main Thread");
+
+    std::thread thread([]()
+    {
+      mPROFILE_SCOPED("mProfilerTest Other Thread");
+    });
+
+    thread.join();
+  }
+
+  mTEST_ASSERT_SUCCESS(mProfiler_WriteToChromiumTraceEventFile(filename));
+  mDEFER(mFile_Delete(filename));
+
+  mString contents;
+  mTEST_ASSERT_SUCCESS(mFile_ReadAllText(filename, pAllocator, &contents));
+
+  bool contains = false;
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "mProfilerTest Main Thread", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "mProfilerTest Other Thread", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mProfiler, TestCountersAndFlows)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mProfilerTest_CountersAndFlows.json";
+
+  mTEST_ASSERT_SUCCESS(mProfiler_Allocate(1024));
+  mTEST_ASSERT_SUCCESS(mProfiler_Enable());
+  mDEFER(mProfiler_Disable());
+
+  mTEST_ASSERT_SUCCESS(mProfiler_Reset());
+
+  {
+    mPROFILE_SCOPED("mProfilerTest Producer");
+    mProfiler_ReportCounter("mProfilerTest Queue Length", 1234);
+    mProfiler_ReportFlowStart("mProfilerTest Flow", 0xBEEF);
+  }
+
+  std::thread thread([]()
+  {
+    mPROFILE_SCOPED("mProfilerTest Consumer");
+    mProfiler_ReportFlowEnd("mProfilerTest Flow", 0xBEEF);
+  });
+
+  thread.join();
+
+  mTEST_ASSERT_SUCCESS(mProfiler_WriteToChromiumTraceEventFile(filename));
+  mDEFER(mFile_Delete(filename));
+
+  mString contents;
+  mTEST_ASSERT_SUCCESS(mFile_ReadAllText(filename, pAllocator, &contents));
+
+  bool contains = false;
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "mProfilerTest Queue Length", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "1234", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "mProfilerTest Flow", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ASSERT_SUCCESS(mString_Contains(contents, "0xBEEF", &contains));
+  mTEST_ASSERT_TRUE(contains);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mProfiler, TestStatistics)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t count = 1000;
+
+  mTEST_ASSERT_SUCCESS(mProfiler_Allocate(1024));
+  mTEST_ASSERT_SUCCESS(mProfiler_Enable());
+  mDEFER(mProfiler_Disable());
+
+  mTEST_ASSERT_SUCCESS(mProfiler_EnableAggregation());
+  mDEFER(mProfiler_DisableAggregation());
+
+  mTEST_ASSERT_SUCCESS(mProfiler_ResetStatistics());
+
+  volatile size_t sum = 0;
+
+  // More events than fit into the ring buffer.
+  for (size_t i = 0; i < count; i++)
+  {
+    mProfiler_ReportEventStart("mProfilerTest_TestStatistics");
+
+    for (size_t j = 0; j < i; j++)
+      sum = sum + j;
+
+    mProfiler_ReportEventEnd("mProfilerTest_TestStatistics");
+  }
+
+  mProfiler_Statistics statistics;
+  mTEST_ASSERT_SUCCESS(mProfiler_GetStatistics("mProfilerTest_TestStatistics", &statistics));
+
+  mTEST_ASSERT_EQUAL(statistics.count, count);
+  mTEST_ASSERT_EQUAL(statistics.nameId, mProfiler_InternName("mProfilerTest_TestStatistics"));
+  mTEST_ASSERT_TRUE(statistics.minNs <= statistics.p50Ns);
+  mTEST_ASSERT_TRUE(statistics.p50Ns <= statistics.p99Ns);
+  mTEST_ASSERT_TRUE(statistics.p99Ns <= statistics.maxNs);
+  mTEST_ASSERT_TRUE(statistics.totalNs >= statistics.maxNs);
+
+  bool found = false;
+
+  mTEST_ASSERT_SUCCESS(mProfiler_ForEachStatistics([&](const mProfiler_Statistics &s)
+  {
+    if (s.nameId == statistics.nameId)
+    {
+      found = true;
+      return mR_Break;
+    }
+
+    return mR_Success;
+  }));
+
+  mTEST_ASSERT_TRUE(found);
+
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mProfiler_GetStatistics("mProfilerTest_TestStatistics_NeverReported", &statistics));
+
+  mTEST_ASSERT_SUCCESS(mProfiler_ResetStatistics());
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mProfiler_GetStatistics("mProfilerTest_TestStatistics", &statistics));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mProfiler, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t count = 1024 * 1024 * 4;
+
+  mTEST_ASSERT_SUCCESS(mProfiler_Allocate(1024 * 64));
+  mTEST_ASSERT_SUCCESS(mProfiler_Enable());
+  mDEFER(mProfiler_Disable());
+
+  const int64_t start = mGetCurrentTimeNs();
+
+  for (size_t i = 0; i < count; i++)
+  {
+    mProfiler_ReportEventStart("mProfilerTest_TestPerformance");
+    mProfiler_ReportEventEnd("mProfilerTest_TestPerformance");
+  }
+
+  const int64_t end = mGetCurrentTimeNs();
+
+  mTEST_ASSERT_TRUE((end - start) / (double_t)(count * 2) < 50.0); // Please don't make this perform terribly. Reporting an event should only take a couple of nanoseconds.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
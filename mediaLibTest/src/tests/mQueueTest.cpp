@@ -1630,6 +1630,182 @@ mTEST(mQueue, TestOrderBy)
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
 
+mTEST(mQueue, TestOrderByLess)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mQueue<int64_t>> numberQueue = nullptr;
+  mDEFER_CALL(&numberQueue, mQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mQueue_Create(&numberQueue, pAllocator));
+
+  // Wraps around the end of the ring buffer.
+  for (int64_t i = 0; i < 5000; i++)
+  {
+    if (i % 3 == 0)
+      mTEST_ASSERT_SUCCESS(mQueue_PushFront(numberQueue, (i * 7919) % 1000));
+    else
+      mTEST_ASSERT_SUCCESS(mQueue_PushBack(numberQueue, -((i * 104729) % 1013)));
+  }
+
+  mTEST_ASSERT_SUCCESS(mQueue_OrderByLess(numberQueue, [](const int64_t &a, const int64_t &b) { return a > b; }));
+  mTEST_ASSERT_EQUAL((size_t)5000, numberQueue->count);
+
+  for (size_t i = 1; i < numberQueue->count; i++)
+    mTEST_ASSERT_TRUE((*numberQueue)[i - 1] >= (*numberQueue)[i]);
+
+  // Already sorted and only equal values.
+  mTEST_ASSERT_SUCCESS(mQueue_OrderByLess(numberQueue));
+  mTEST_ASSERT_SUCCESS(mQueue_OrderByLess(numberQueue));
+
+  for (size_t i = 1; i < numberQueue->count; i++)
+    mTEST_ASSERT_TRUE((*numberQueue)[i - 1] <= (*numberQueue)[i]);
+
+  mTEST_ASSERT_SUCCESS(mQueue_Clear(numberQueue));
+
+  for (size_t i = 0; i < 3000; i++)
+    mTEST_ASSERT_SUCCESS(mQueue_PushBack(numberQueue, (int64_t)4));
+
+  mTEST_ASSERT_SUCCESS(mQueue_OrderByLess(numberQueue));
+
+  for (size_t i = 0; i < numberQueue->count; i++)
+    mTEST_ASSERT_EQUAL((int64_t)4, (*numberQueue)[i]);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mQueue, TestOrderByRadix)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  {
+    mPtr<mQueue<mKeyValuePair<int32_t, size_t>>> queue = nullptr;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+
+    for (size_t i = 0; i < 10000; i++)
+      mTEST_ASSERT_SUCCESS(mQueue_PushFront(queue, mKeyValuePair<int32_t, size_t>((int32_t)((i * 7919) % 2001) - 1000, i)));
+
+    mTEST_ASSERT_SUCCESS(mQueue_OrderBy(queue, (std::function<int32_t (const mKeyValuePair<int32_t, size_t> &)>)[](const mKeyValuePair<int32_t, size_t> &a) { return a.key; }));
+    mTEST_ASSERT_EQUAL((size_t)10000, queue->count);
+
+    // Radix sort is stable: `PushFront` inserted the values in descending order.
+    for (size_t i = 1; i < queue->count; i++)
+    {
+      mTEST_ASSERT_TRUE((*queue)[i - 1].key <= (*queue)[i].key);
+
+      if ((*queue)[i - 1].key == (*queue)[i].key)
+        mTEST_ASSERT_TRUE((*queue)[i - 1].value > (*queue)[i].value);
+    }
+  }
+
+  {
+    mPtr<mQueue<float_t>> queue = nullptr;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+
+    for (size_t i = 0; i < 5000; i++)
+      mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, (float_t)((int64_t)((i * 7919) % 5003) - 2500) * 0.25f));
+
+    mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, -0.0f));
+    mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, -1e30f));
+    mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, 1e30f));
+
+    mTEST_ASSERT_SUCCESS(mQueue_OrderBy(queue, (std::function<float_t (const float_t &)>)[](const float_t &a) { return a; }));
+
+    mTEST_ASSERT_EQUAL(-1e30f, (*queue)[0]);
+    mTEST_ASSERT_EQUAL(1e30f, (*queue)[queue->count - 1]);
+
+    for (size_t i = 1; i < queue->count; i++)
+      mTEST_ASSERT_TRUE((*queue)[i - 1] <= (*queue)[i]);
+  }
+
+  {
+    mPtr<mQueue<uint16_t>> queue = nullptr;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+
+    for (size_t i = 0; i < 5000; i++)
+      mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, (uint16_t)((i * 7919) % 65521)));
+
+    // Keys without an integer representation fall back to comparisons.
+    mTEST_ASSERT_SUCCESS(mQueue_OrderBy(queue, (std::function<std::pair<uint16_t, uint16_t> (const uint16_t &)>)[](const uint16_t &a) { return std::make_pair((uint16_t)(a % 10), a); }));
+
+    for (size_t i = 1; i < queue->count; i++)
+      mTEST_ASSERT_TRUE(std::make_pair((*queue)[i - 1] % 10, (*queue)[i - 1]) <= std::make_pair((*queue)[i] % 10, (*queue)[i]));
+
+    mTEST_ASSERT_SUCCESS(mQueue_OrderBy(queue, (std::function<int16_t (const uint16_t &)>)[](const uint16_t &a) { return (int16_t)a; }));
+
+    for (size_t i = 1; i < queue->count; i++)
+      mTEST_ASSERT_TRUE((int16_t)(*queue)[i - 1] <= (int16_t)(*queue)[i]);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mQueue, TestOrderByParallel)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool = nullptr;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 4));
+
+  const size_t counts[] = { 10, mSort_ParallelChunkMinSize * 2 - 1, 250000 };
+
+  for (const size_t count : counts)
+  {
+    mPtr<mQueue<uint64_t>> queue = nullptr;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      const uint64_t value = (i * 2654435761ULL) % 100003;
+      sum += value;
+
+      mTEST_ASSERT_SUCCESS(mQueue_PushFront(queue, value));
+    }
+
+    mTEST_ASSERT_SUCCESS(mQueue_OrderByParallel(queue, threadPool));
+    mTEST_ASSERT_EQUAL(count, queue->count);
+
+    uint64_t sortedSum = (*queue)[0];
+
+    for (size_t i = 1; i < queue->count; i++)
+    {
+      mTEST_ASSERT_TRUE((*queue)[i - 1] <= (*queue)[i]);
+      sortedSum += (*queue)[i];
+    }
+
+    mTEST_ASSERT_EQUAL(sum, sortedSum);
+  }
+
+  // Non-trivial types are moved between the scratch buffer and the queue.
+  {
+    mPtr<mQueue<mString>> queue = nullptr;
+    mDEFER_CALL(&queue, mQueue_Destroy);
+    mTEST_ASSERT_SUCCESS(mQueue_Create(&queue, pAllocator));
+
+    const size_t count = mSort_ParallelChunkMinSize * 5;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      mString value;
+      mTEST_ASSERT_SUCCESS(mString_Create(&value, mFormat(mFUInt<mFMinDigits<6>, mFFillZeroes>((i * 7919) % count)), pAllocator));
+      mTEST_ASSERT_SUCCESS(mQueue_PushBack(queue, std::move(value)));
+    }
+
+    mTEST_ASSERT_SUCCESS(mQueue_OrderByParallel(queue, threadPool, [](const mString &a, const mString &b) { return strcmp(a.c_str(), b.c_str()) < 0; }));
+
+    for (size_t i = 1; i < queue->count; i++)
+      mTEST_ASSERT_TRUE(strcmp((*queue)[i - 1].c_str(), (*queue)[i].c_str()) < 0);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
 mTEST(mQueue, TestEquals)
 {
   mTEST_ALLOCATOR_SETUP();
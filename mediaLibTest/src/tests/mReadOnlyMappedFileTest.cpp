@@ -0,0 +1,67 @@
+#include "mTestLib.h"
+#include "mFile.h"
+#include "mReadOnlyMappedFile.h"
+
+mTEST(mReadOnlyMappedFile, TestMapFile)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const size_t fileSize = 1024 * 64 + 3;
+  const mString filename = "mReadOnlyMappedFileTest.bin";
+
+  uint8_t *pData = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pData);
+  mTEST_ASSERT_SUCCESS(mAllocator_Allocate(pAllocator, &pData, fileSize));
+
+  for (size_t i = 0; i < fileSize; i++)
+    pData[i] = (uint8_t)(i * 31);
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, pData, fileSize));
+  mDEFER(mFile_Delete(filename));
+
+  mPtr<mReadOnlyMappedFile> mappedFile;
+  mDEFER_CALL(&mappedFile, mReadOnlyMappedFile_Destroy);
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_Create(&mappedFile, pAllocator, filename, mROMF_AP_Sequential));
+
+  const uint8_t *pMapping = nullptr;
+  size_t size = 0;
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_GetData(mappedFile, &pMapping, &size));
+  mTEST_ASSERT_EQUAL(fileSize, size);
+  mTEST_ASSERT_TRUE(pMapping != nullptr);
+
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_Prefetch(mappedFile, 4097, fileSize - 4097));
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_SetAccessPattern(mappedFile, mROMF_AP_Random));
+
+  for (size_t i = 0; i < fileSize; i++)
+    mTEST_ASSERT_EQUAL(pData[i], pMapping[i]);
+
+  mTEST_ASSERT_EQUAL(mR_ArgumentOutOfBounds, mReadOnlyMappedFile_Prefetch(mappedFile, fileSize - 1, 2));
+
+  mPtr<mReadOnlyMappedFile> missingFile;
+  mDEFER_CALL(&missingFile, mReadOnlyMappedFile_Destroy);
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mReadOnlyMappedFile_Create(&missingFile, pAllocator, "mReadOnlyMappedFileTest.missing"));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mReadOnlyMappedFile, TestEmptyFile)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mString filename = "mReadOnlyMappedFileTestEmpty.bin";
+
+  mTEST_ASSERT_SUCCESS(mFile_WriteRaw(filename, (uint8_t *)nullptr, 0));
+  mDEFER(mFile_Delete(filename));
+
+  mPtr<mReadOnlyMappedFile> mappedFile;
+  mDEFER_CALL(&mappedFile, mReadOnlyMappedFile_Destroy);
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_Create(&mappedFile, pAllocator, filename));
+
+  const uint8_t *pMapping = nullptr;
+  size_t size = 1;
+  mTEST_ASSERT_SUCCESS(mReadOnlyMappedFile_GetData(mappedFile, &pMapping, &size));
+  mTEST_ASSERT_EQUAL((size_t)0, size);
+  mTEST_ASSERT_EQUAL(nullptr, pMapping);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
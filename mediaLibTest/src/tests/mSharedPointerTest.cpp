@@ -1,4 +1,5 @@
 #include "mTestLib.h"
+#include "mIntrusivePointer.h"
 
 mTEST(mSharedPointer, TestCastDerived)
 {
@@ -347,3 +348,127 @@ mTEST(mSharedPointer, TestSelfAssign)
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
+
+mTEST(mSharedPointer, TestCleanupFunctionPointer)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  struct _internal
+  {
+    static void Cleanup(size_t **ppValue)
+    {
+      ++**ppValue;
+    }
+  };
+
+  size_t cleanupCount = 0;
+
+  {
+    mPtr<size_t *> value;
+    mTEST_ASSERT_SUCCESS(mSharedPointer_Allocate<size_t *>(&value, pAllocator, [](size_t **ppValue) { ++**ppValue; }, 1));
+    mTEST_ASSERT_TRUE(value.m_pParams->pCleanupFunction != nullptr);
+    mTEST_ASSERT_FALSE((bool)value.m_pParams->cleanupFunction);
+
+    *value = &cleanupCount;
+
+    mPtr<size_t *> copy = value;
+    mTEST_ASSERT_SUCCESS(mSharedPointer_Destroy(&value));
+    mTEST_ASSERT_EQUAL((size_t)0, cleanupCount);
+  }
+
+  mTEST_ASSERT_EQUAL((size_t)1, cleanupCount);
+
+  {
+    size_t **ppValue = nullptr;
+    mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &ppValue, 1));
+    *ppValue = &cleanupCount;
+
+    mPtr<size_t *> value;
+    mTEST_ASSERT_SUCCESS(mSharedPointer_Create<size_t *>(&value, ppValue, _internal::Cleanup, pAllocator));
+  }
+
+  mTEST_ASSERT_EQUAL((size_t)2, cleanupCount);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mIntrusivePointer, TestCreateCleanup)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  struct Base : mRefCounted
+  {
+    size_t *pCleanupCount;
+  };
+
+  struct Derived : Base
+  {
+    size_t *pDerivedCleanupCount;
+  };
+
+  size_t cleanupCount = 0;
+  size_t derivedCleanupCount = 0;
+
+  {
+    mIntrusivePtr<Base> base;
+
+    {
+      mIntrusivePtr<Derived> derived;
+      mTEST_ASSERT_SUCCESS(mIntrusivePointer_Allocate<Derived>(&derived, pAllocator, [](Derived *pData) { ++*pData->pCleanupCount; ++*pData->pDerivedCleanupCount; }));
+      mTEST_ASSERT_EQUAL((size_t)1, derived.GetReferenceCount());
+
+      derived->pCleanupCount = &cleanupCount;
+      derived->pDerivedCleanupCount = &derivedCleanupCount;
+
+      base = (mIntrusivePtr<Base>)derived;
+      mTEST_ASSERT_EQUAL((size_t)2, base.GetReferenceCount());
+
+      // The reference count lives in the object, so a raw pointer can be turned back into a reference.
+      mIntrusivePtr<Derived> fromRaw(derived.GetPointer());
+      mTEST_ASSERT_EQUAL((size_t)3, derived.GetReferenceCount());
+      mTEST_ASSERT_TRUE(fromRaw == derived);
+    }
+
+    mTEST_ASSERT_EQUAL((size_t)1, base.GetReferenceCount());
+    mTEST_ASSERT_EQUAL((size_t)0, cleanupCount);
+  }
+
+  // Cleaned up as `Derived` even though the last reference was a `Base`.
+  mTEST_ASSERT_EQUAL((size_t)1, cleanupCount);
+  mTEST_ASSERT_EQUAL((size_t)1, derivedCleanupCount);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mIntrusivePointer, TestLocalRefCounted)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  struct Local : mLocalRefCounted
+  {
+    size_t value;
+  };
+
+  mIntrusivePtr<Local> a;
+  mDEFER_CALL(&a, mIntrusivePointer_Destroy);
+  mTEST_ASSERT_SUCCESS(mIntrusivePointer_Allocate(&a, pAllocator));
+
+  a->value = 10;
+
+  mIntrusivePtr<Local> b = a;
+  mTEST_ASSERT_EQUAL((size_t)2, a.GetReferenceCount());
+  mTEST_ASSERT_EQUAL((size_t)10, b->value);
+
+  mIntrusivePtr<Local> c = std::move(b);
+  mTEST_ASSERT_TRUE(b == nullptr);
+  mTEST_ASSERT_EQUAL((size_t)2, c.GetReferenceCount());
+
+  c = a;
+  mTEST_ASSERT_EQUAL((size_t)2, a.GetReferenceCount());
+
+  mTEST_ASSERT_SUCCESS(mIntrusivePointer_Destroy(&c));
+  mTEST_ASSERT_EQUAL((size_t)1, a.GetReferenceCount());
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
@@ -0,0 +1,249 @@
+#include "mTestLib.h"
+#include "mSoA.h"
+
+mTEST(mSoA, TestCreate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mTEST_ASSERT_EQUAL(mR_ArgumentNull, mSoA_Create((mSoA<size_t, float_t> *)nullptr, pAllocator));
+
+  mSoA<size_t, float_t> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  mTEST_ASSERT_NOT_EQUAL(soa.pAllocator, nullptr);
+
+  mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, (size_t)1, 2.f));
+
+  // Destroys the old one.
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+  mTEST_ASSERT_EQUAL(soa.count, (size_t)0);
+
+  mPtr<mSoA<size_t, float_t>> soaPtr;
+  mDEFER_CALL(&soaPtr, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soaPtr, pAllocator));
+  mTEST_ASSERT_SUCCESS(mSoA_PushBack(*soaPtr, (size_t)1, 2.f));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestPushRemove)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  std::vector<std::tuple<size_t, float_t, uint8_t>> comparisonVector;
+  mSoA<size_t, float_t, uint8_t> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  size_t seed = 0;
+
+  for (size_t i = 0; i < 1000; i++)
+  {
+    seed += i + seed * 0xDEADF00D;
+
+    const size_t count = comparisonVector.size();
+
+    switch (seed % 4)
+    {
+    case 0:
+    case 1:
+      mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, seed, (float_t)(seed & 0xFFFF), (uint8_t)seed));
+      comparisonVector.emplace_back(seed, (float_t)(seed & 0xFFFF), (uint8_t)seed);
+      break;
+
+    case 2:
+      if (count > 0)
+      {
+        const size_t index = (seed + 0xDEADF00D) % count;
+
+        mTEST_ASSERT_SUCCESS(mSoA_RemoveAt(soa, index));
+        comparisonVector.erase(comparisonVector.begin() + index);
+      }
+      else
+      {
+        mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mSoA_RemoveAt(soa, 0));
+      }
+
+      break;
+
+    case 3:
+      if (count > 0)
+      {
+        const size_t index = (seed + 0xDEADF00D) % count;
+
+        mTEST_ASSERT_SUCCESS(mSoA_SwapRemoveAt(soa, index));
+        comparisonVector[index] = comparisonVector.back();
+        comparisonVector.pop_back();
+      }
+      else
+      {
+        mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mSoA_SwapRemoveAt(soa, 0));
+      }
+
+      break;
+    }
+
+    size_t soaCount = (size_t)-1;
+    mTEST_ASSERT_SUCCESS(mSoA_GetCount(soa, &soaCount));
+    mTEST_ASSERT_EQUAL(soaCount, comparisonVector.size());
+  }
+
+  for (size_t i = 0; i < soa.count; i++)
+  {
+    size_t value0;
+    uint8_t value2;
+    mTEST_ASSERT_SUCCESS(mSoA_PeekAt(soa, i, &value0, nullptr, &value2));
+
+    mTEST_ASSERT_EQUAL(value0, std::get<0>(comparisonVector[i]));
+    mTEST_ASSERT_EQUAL(soa.Field<1>()[i], std::get<1>(comparisonVector[i]));
+    mTEST_ASSERT_EQUAL(value2, std::get<2>(comparisonVector[i]));
+  }
+
+  mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mSoA_PeekAt(soa, soa.count, (size_t *)nullptr, (float_t *)nullptr, (uint8_t *)nullptr));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestFieldAlignment)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mSoA<uint8_t, mVec3f, double_t> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  for (size_t i = 0; i < 100; i++)
+  {
+    mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, (uint8_t)i, mVec3f((float_t)i), (double_t)i));
+
+    mTEST_ASSERT_EQUAL(reinterpret_cast<size_t>(soa.Field<0>()) % mSoA_FieldAlignment, (size_t)0);
+    mTEST_ASSERT_EQUAL(reinterpret_cast<size_t>(soa.Field<1>()) % mSoA_FieldAlignment, (size_t)0);
+    mTEST_ASSERT_EQUAL(reinterpret_cast<size_t>(soa.Field<2>()) % mSoA_FieldAlignment, (size_t)0);
+  }
+
+  const double_t *pValues = nullptr;
+  mTEST_ASSERT_SUCCESS(mSoA_GetField<2>(soa, &pValues));
+  mTEST_ASSERT_EQUAL(pValues, soa.Field<2>());
+
+  for (size_t i = 0; i < soa.count; i++)
+    mTEST_ASSERT_EQUAL(pValues[i], (double_t)i);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestIterate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mSoA<mVec2f, mVec2f> particles;
+  mDEFER_CALL(&particles, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&particles, pAllocator));
+
+  mTEST_ASSERT_SUCCESS(mSoA_ResizeWith(particles, 1024, mVec2f(0), mVec2f(1, 2)));
+
+  for (auto [position, velocity] : particles)
+    position += velocity;
+
+  size_t count = 0;
+
+  for (const auto [position, velocity] : particles.Iterate())
+  {
+    mTEST_ASSERT_EQUAL(position, velocity);
+    count++;
+  }
+
+  mTEST_ASSERT_EQUAL(count, particles.count);
+
+  mTEST_ASSERT_SUCCESS(mSoA_ResizeWith(particles, 10, mVec2f(0), mVec2f(0)));
+  mTEST_ASSERT_EQUAL(particles.count, (size_t)10);
+  mTEST_ASSERT_EQUAL(particles.Field<0>()[9], mVec2f(1, 2));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestClear)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mSoA<mDummyDestructible, size_t> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  for (size_t i = 0; i < 1024; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mDummyDestructible_Create(&dummy, pAllocator));
+    mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, dummy, i));
+  }
+
+  mTEST_ASSERT_SUCCESS(mSoA_RemoveAt(soa, 10));
+  mTEST_ASSERT_SUCCESS(mSoA_SwapRemoveAt(soa, 10));
+  mTEST_ASSERT_SUCCESS(mSoA_Clear(soa));
+  mTEST_ASSERT_EQUAL(soa.count, (size_t)0);
+
+  for (size_t i = 0; i < 1024; i++)
+  {
+    mDummyDestructible dummy;
+    mTEST_ASSERT_SUCCESS(mDummyDestructible_Create(&dummy, pAllocator));
+    mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, dummy, i));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestPushBackOwnElement)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mSoA<size_t, mVec2f> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, (size_t)1, mVec2f(2, 3)));
+
+  // Pushing references to the first element has to work even when the soa has to grow and frees the old field arrays.
+  for (size_t i = 0; i < 1024; i++)
+    mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, soa.Field<0>()[0], soa.Field<1>()[0]));
+
+  mTEST_ASSERT_SUCCESS(mSoA_ResizeWith(soa, 4096, soa.Field<0>()[0], soa.Field<1>()[0]));
+
+  for (size_t i = 0; i < soa.count; i++)
+  {
+    mTEST_ASSERT_EQUAL(soa.Field<0>()[i], (size_t)1);
+    mTEST_ASSERT_EQUAL(soa.Field<1>()[i], mVec2f(2, 3));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mSoA, TestMove)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mSoA<size_t, float_t> soa;
+  mDEFER_CALL(&soa, mSoA_Destroy);
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&soa, pAllocator));
+
+  for (size_t i = 0; i < 100; i++)
+    mTEST_ASSERT_SUCCESS(mSoA_PushBack(soa, i, (float_t)i));
+
+  mSoA<size_t, float_t> moved = std::move(soa);
+  mTEST_ASSERT_EQUAL(soa.pAllocation, nullptr);
+  mTEST_ASSERT_EQUAL(soa.count, (size_t)0);
+  mTEST_ASSERT_EQUAL(moved.count, (size_t)100);
+
+  mSoA<size_t, float_t> assigned;
+  mTEST_ASSERT_SUCCESS(mSoA_Create(&assigned, pAllocator));
+  mTEST_ASSERT_SUCCESS(mSoA_PushBack(assigned, (size_t)1, 1.f));
+
+  // Releases the previous allocation of `assigned`.
+  assigned = std::move(moved);
+  mTEST_ASSERT_EQUAL(moved.pAllocation, nullptr);
+  mTEST_ASSERT_EQUAL(assigned.count, (size_t)100);
+
+  for (size_t i = 0; i < assigned.count; i++)
+    mTEST_ASSERT_EQUAL(assigned.Field<0>()[i], i);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
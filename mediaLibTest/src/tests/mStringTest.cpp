@@ -1,5 +1,6 @@
 #include "mTestLib.h"
 #include "mString.h"
+#include "mQueue.h"
 
 mTEST(mString, TestCreateEmpty)
 {
@@ -351,14 +352,14 @@ mTEST(mString, TestCreateFromString)
 
   mTEST_ASSERT_EQUAL(stringA.bytes, stringB.bytes);
   mTEST_ASSERT_EQUAL(stringA.count, stringB.count);
-  mTEST_ASSERT_NOT_EQUAL((void *)stringA.text, (void *)stringB.text);
+  mTEST_ASSERT_NOT_EQUAL((void *)stringA.c_str(), (void *)stringB.c_str());
   mTEST_ASSERT_TRUE(stringA == stringB);
 
   mTEST_ASSERT_SUCCESS(mString_Create(&stringA, stringB));
 
   mTEST_ASSERT_EQUAL(stringA.bytes, stringB.bytes);
   mTEST_ASSERT_EQUAL(stringA.count, stringB.count);
-  mTEST_ASSERT_NOT_EQUAL((void *)stringA.text, (void *)stringB.text);
+  mTEST_ASSERT_NOT_EQUAL((void *)stringA.c_str(), (void *)stringB.c_str());
   mTEST_ASSERT_TRUE(stringA == stringB);
 
   mTEST_ALLOCATOR_ZERO_CHECK();
@@ -896,7 +897,7 @@ mTEST(mString, TestIterate)
   for (auto &&_char : string.begin())
   {
     if (count == 0)
-      mTEST_ASSERT_EQUAL(*(uint32_t *)string.text, *(uint32_t *)_char.character);
+      mTEST_ASSERT_EQUAL(*(uint32_t *)string.c_str(), *(uint32_t *)_char.character);
 
     mTEST_ASSERT_EQUAL(_char.index, count);
     mTEST_ASSERT_EQUAL(_char.characterSize, charSize[count]);
@@ -921,7 +922,7 @@ mTEST(mString, TestCreateFromEmpty)
 
   mTEST_ASSERT_EQUAL(string.bytes, 0);
   mTEST_ASSERT_EQUAL(string.count, 0);
-  mTEST_ASSERT_EQUAL(string.text, nullptr);
+  mTEST_ASSERT_EQUAL(string.c_str(), nullptr);
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
@@ -941,7 +942,7 @@ mTEST(mString, TestCreateFromNowEmpty)
 
   mTEST_ASSERT_EQUAL(string.bytes, 0);
   mTEST_ASSERT_EQUAL(string.count, 0);
-  mTEST_ASSERT_EQUAL(string.text, nullptr);
+  mTEST_ASSERT_EQUAL(string.c_str(), nullptr);
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
@@ -1041,6 +1042,27 @@ mTEST(mString, TestWstringLargerBufferSizeCreate)
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
 
+mTEST(mString, TestWstringUnpairedSurrogateCreate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  // Unpaired surrogates are replaced with U+FFFD, just like `WideCharToMultiByte` does.
+  const wchar_t unpairedHighSurrogate[] = { L'a', (wchar_t)0xD800, L'b', L'\0' };
+  const wchar_t unpairedLowSurrogate[] = { L'a', (wchar_t)0xDC00, (wchar_t)0xD800, L'\0' };
+
+  mString string;
+  mDEFER_CALL(&string, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, unpairedHighSurrogate, pAllocator));
+  mTEST_ASSERT_EQUAL(string, "a\xEF\xBF\xBD" "b");
+  mTEST_ASSERT_EQUAL((size_t)4, string.Count());
+
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, unpairedLowSurrogate, mARRAYSIZE(unpairedLowSurrogate), pAllocator));
+  mTEST_ASSERT_EQUAL(string, "a\xEF\xBF\xBD\xEF\xBF\xBD");
+  mTEST_ASSERT_EQUAL((size_t)4, string.Count());
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
 mTEST(mString, TestStartsWith)
 {
   mTEST_ALLOCATOR_SETUP();
@@ -1584,7 +1606,7 @@ mTEST(mString, TestRemoveString)
   mTEST_ASSERT_SUCCESS(mString_RemoveString(string, string, &result));
   mTEST_ASSERT_EQUAL(result.count, 1);
   mTEST_ASSERT_EQUAL(result.bytes, 1);
-  mTEST_ASSERT_EQUAL(result.text[0], '\0');
+  mTEST_ASSERT_EQUAL(result.c_str()[0], '\0');
 
   mTEST_ASSERT_SUCCESS(mString_Create(&replace, "\xE1\x80\xA9\xE1\x8C\xAC", pAllocator));
   mTEST_ASSERT_SUCCESS(mString_RemoveString(string, replace, &result));
@@ -1619,7 +1641,7 @@ mTEST(mString, TestReplaceString)
   mTEST_ASSERT_SUCCESS(mString_RemoveString(string, string, &result));
   mTEST_ASSERT_EQUAL(result.count, 1);
   mTEST_ASSERT_EQUAL(result.bytes, 1);
-  mTEST_ASSERT_EQUAL(result.text[0], '\0');
+  mTEST_ASSERT_EQUAL(result.c_str()[0], '\0');
 
   mTEST_ASSERT_SUCCESS(mString_Create(&replace, "\xE1\x80\xA9\xE1\x8C\xAC", pAllocator));
   mTEST_ASSERT_SUCCESS(mString_Create(&with, "\xE1\x8F\xAA\xE1\x8F\xAB\xF0\x90\x8C\x86\xF0\x94\x93\x98\xF0\x90\x8C\x86\xF0\x94\x93\x98\xF0\x90\x8C\x86\xE1\x80\xA9\xE1\x8C\xAC\xE1\x8F\xAA\xE1\x8F\xAB\xF0\x90\x8C\x86\xF0\x94\x93\x98\xF0\x90\x8C\x86\xF0\x94\x93\x98\xF0\x90\x8C\x86", pAllocator));
@@ -1642,6 +1664,66 @@ mTEST(mString, TestReplaceString)
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
 
+mTEST(mString, TestFindAll)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  // Long enough for the vectorised search, with matches crossing block boundaries.
+  mString string;
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, "abc\xE1\x80\xA9\xF0\x90\x8C\x86xyzabc\xE1\x80\xA9\xF0\x90\x8C\x86xyzabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcab\xE1\x80\xA9\xF0\x90\x8C\x86xyzabcabc\xE1\x80\xA9\xF0\x90\x8C\x86xy", pAllocator));
+
+  mString find;
+  mTEST_ASSERT_SUCCESS(mString_Create(&find, "\xE1\x80\xA9\xF0\x90\x8C\x86xy", pAllocator));
+
+  mPtr<mQueue<size_t>> startChars;
+  mDEFER_CALL(&startChars, mQueue_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_FindAll(string, find, &startChars, pAllocator));
+
+  const size_t expectedStartChars[] = { 3, 11, 63, 74 };
+
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mQueue_GetCount(startChars, &count));
+  mTEST_ASSERT_EQUAL(mARRAYSIZE(expectedStartChars), count);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    size_t startChar;
+    mTEST_ASSERT_SUCCESS(mQueue_PeekAt(startChars, i, &startChar));
+    mTEST_ASSERT_EQUAL(expectedStartChars[i], startChar);
+  }
+
+  size_t firstChar = 0;
+  bool contained = false;
+  mTEST_ASSERT_SUCCESS(mString_FindFirst(string, find, &firstChar, &contained));
+  mTEST_ASSERT_TRUE(contained);
+  mTEST_ASSERT_EQUAL(expectedStartChars[0], firstChar);
+
+  // Matches don't overlap.
+  mString overlapping;
+  mTEST_ASSERT_SUCCESS(mString_Create(&overlapping, "aaaaa", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_Create(&find, "aa", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_FindAll(overlapping, find, &startChars, pAllocator));
+  mTEST_ASSERT_SUCCESS(mQueue_GetCount(startChars, &count));
+  mTEST_ASSERT_EQUAL((size_t)2, count);
+
+  mString result;
+  mTEST_ASSERT_SUCCESS(mString_Create(&find, "abc", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_Replace(string, find, overlapping, &result));
+  mTEST_ASSERT_EQUAL(string.count + 19 * 2, result.count);
+
+  mTEST_ASSERT_SUCCESS(mString_Create(&find, "b", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_FindAll(string, find, &startChars, pAllocator));
+  mTEST_ASSERT_SUCCESS(mQueue_GetCount(startChars, &count));
+  mTEST_ASSERT_EQUAL((size_t)20, count);
+
+  mTEST_ASSERT_SUCCESS(mString_Create(&find, "", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_FindAll(string, find, &startChars, pAllocator));
+  mTEST_ASSERT_SUCCESS(mQueue_GetCount(startChars, &count));
+  mTEST_ASSERT_EQUAL((size_t)0, count);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
 mTEST(mString, TestFormatInteraction)
 {
   mTEST_ALLOCATOR_SETUP();
@@ -1687,3 +1769,209 @@ mTEST(mString, TestFormatInteraction)
 
   mTEST_ALLOCATOR_ZERO_CHECK();
 }
+
+mTEST(mString, TestInlineString)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  size_t allocationCount = (size_t)-1;
+
+  mString string;
+  mDEFER_CALL(&string, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, "short string", pAllocator));
+
+  mTEST_ASSERT_SUCCESS(mTestAllocator_GetCount(pAllocator, &allocationCount));
+  mTEST_ASSERT_EQUAL((size_t)0, allocationCount);
+  mTEST_ASSERT_TRUE(string.IsAscii());
+  mTEST_ASSERT_EQUAL(string, "short string");
+
+  mTEST_ASSERT_SUCCESS(mString_Append(string, "🌵🦎"));
+
+  mTEST_ASSERT_SUCCESS(mTestAllocator_GetCount(pAllocator, &allocationCount));
+  mTEST_ASSERT_EQUAL((size_t)0, allocationCount);
+  mTEST_ASSERT_FALSE(string.IsAscii());
+  mTEST_ASSERT_EQUAL(string, "short string🌵🦎");
+  mTEST_ASSERT_EQUAL(mToChar<4>("🦎"), string[13]);
+
+  // Moving and copying inline strings has to keep the text with the string.
+  mString moved = std::move(string);
+  mTEST_ASSERT_EQUAL(moved, "short string🌵🦎");
+  mTEST_ASSERT_EQUAL(string.c_str(), nullptr);
+
+  mString copy;
+  mDEFER_CALL(&copy, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Create(&copy, moved, pAllocator));
+  mTEST_ASSERT_NOT_EQUAL((void *)copy.c_str(), (void *)moved.c_str());
+  mTEST_ASSERT_EQUAL(copy, moved);
+
+  // Exceeding the inline capacity moves the text to the heap.
+  mTEST_ASSERT_SUCCESS(mString_Append(copy, " that is now too long to be stored inline"));
+
+  mTEST_ASSERT_SUCCESS(mTestAllocator_GetCount(pAllocator, &allocationCount));
+  mTEST_ASSERT_EQUAL((size_t)1, allocationCount);
+  mTEST_ASSERT_EQUAL(copy, "short string🌵🦎 that is now too long to be stored inline");
+
+  mString substring;
+  mDEFER_CALL(&substring, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Substring(copy, &substring, 12, 2));
+  mTEST_ASSERT_EQUAL(substring, "🌵🦎");
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mString, TestCharIndex)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const char *characters[] = { "a", "ö", "ⴲ", "🌵" };
+  const size_t characterCount = 1000;
+
+  mString string;
+  mDEFER_CALL(&string, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, "", pAllocator));
+
+  for (size_t i = 0; i < characterCount; i++)
+    mTEST_ASSERT_SUCCESS(mString_Append(string, characters[i % mARRAYSIZE(characters)]));
+
+  mTEST_ASSERT_EQUAL(characterCount + 1, string.Count());
+
+  mchar_t expected[characterCount];
+
+  for (size_t i = 0; i < characterCount; i++)
+    expected[i] = string[i];
+
+  mTEST_ASSERT_SUCCESS(mString_CreateCharIndex(string));
+  mTEST_ASSERT_TRUE(string.pCharIndex != nullptr);
+
+  for (size_t i = 0; i < characterCount; i++)
+  {
+    mTEST_ASSERT_EQUAL(expected[i], string[i]);
+    mTEST_ASSERT_EQUAL(mToChar(characters[i % mARRAYSIZE(characters)], strlen(characters[i % mARRAYSIZE(characters)])), string[i]);
+  }
+
+  mString substring;
+  mDEFER_CALL(&substring, mString_Destroy);
+  mTEST_ASSERT_SUCCESS(mString_Substring(string, &substring, 801, 3));
+  mTEST_ASSERT_EQUAL(substring, "öⴲ🌵");
+
+  // Modifying the string discards the index.
+  mTEST_ASSERT_SUCCESS(mString_Append(string, "a"));
+  mTEST_ASSERT_TRUE(string.pCharIndex == nullptr);
+  mTEST_ASSERT_EQUAL(mToChar<2>("a"), string[characterCount]);
+
+  // Ascii strings don't need an index.
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, "This is a long ascii string that would need an index if it wasn't ascii, because it is longer than the index stride.", pAllocator));
+  mTEST_ASSERT_SUCCESS(mString_CreateCharIndex(string));
+  mTEST_ASSERT_TRUE(string.pCharIndex == nullptr);
+  mTEST_ASSERT_EQUAL(mToChar<2>("i"), string[81]);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mString, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  // Before strings were stored inline, every string was stored on the heap, which reserving more than `mString_InlineCapacity` bytes reproduces.
+  {
+    size_t countOld = 0;
+    const int64_t startOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < 1024 * 256; i++)
+    {
+      mString string;
+      mTEST_ASSERT_SUCCESS(mString_Create(&string, "short string", nullptr));
+      mTEST_ASSERT_SUCCESS(mString_Reserve(string, mString_InlineCapacity + 1));
+      countOld += string.bytes;
+      mTEST_ASSERT_SUCCESS(mString_Destroy(&string));
+    }
+
+    size_t countNew = 0;
+    const int64_t endOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < 1024 * 256; i++)
+    {
+      mString string;
+      mTEST_ASSERT_SUCCESS(mString_Create(&string, "short string", nullptr));
+      countNew += string.bytes;
+      mTEST_ASSERT_SUCCESS(mString_Destroy(&string));
+    }
+
+    const int64_t endNew = mGetCurrentTimeNs();
+
+    mTEST_ASSERT_EQUAL(countOld, countNew);
+    mTEST_ASSERT_TRUE((endOld - startOld) / (double_t)(endNew - endOld) > 2.0); // Please don't make this perform terribly. Short strings shouldn't allocate.
+  }
+
+  {
+    size_t countOld = 0;
+    const int64_t startOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < 1024 * 256; i++)
+    {
+      mString string;
+      mTEST_ASSERT_SUCCESS(mString_Create(&string, "", nullptr));
+      mTEST_ASSERT_SUCCESS(mString_Reserve(string, mString_InlineCapacity + 1));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, "key"));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, " = "));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, "väl"));
+      countOld += string.bytes;
+      mTEST_ASSERT_SUCCESS(mString_Destroy(&string));
+    }
+
+    size_t countNew = 0;
+    const int64_t endOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < 1024 * 256; i++)
+    {
+      mString string;
+      mTEST_ASSERT_SUCCESS(mString_Create(&string, "", nullptr));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, "key"));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, " = "));
+      mTEST_ASSERT_SUCCESS(mString_Append(string, "väl"));
+      countNew += string.bytes;
+      mTEST_ASSERT_SUCCESS(mString_Destroy(&string));
+    }
+
+    const int64_t endNew = mGetCurrentTimeNs();
+
+    mTEST_ASSERT_EQUAL(countOld, countNew);
+    mTEST_ASSERT_TRUE((endOld - startOld) / (double_t)(endNew - endOld) > 1.5); // Please don't make this perform terribly. Appending to short strings shouldn't allocate.
+  }
+
+  // Without a character index, every access to a non-ascii string has to iterate from the start of the string.
+  {
+    const char *characters[] = { "a", "ö", "ⴲ", "🌵" };
+    const size_t characterCount = 1024 * 4;
+
+    mString string;
+    mDEFER_CALL(&string, mString_Destroy);
+    mTEST_ASSERT_SUCCESS(mString_Create(&string, "", pAllocator));
+
+    for (size_t i = 0; i < characterCount; i++)
+      mTEST_ASSERT_SUCCESS(mString_Append(string, characters[i % mARRAYSIZE(characters)]));
+
+    mchar_t sumOld = 0;
+    const int64_t startOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < characterCount; i++)
+      sumOld += string[i];
+
+    mTEST_ASSERT_SUCCESS(mString_CreateCharIndex(string));
+
+    mchar_t sumNew = 0;
+    const int64_t endOld = mGetCurrentTimeNs();
+
+    for (size_t i = 0; i < characterCount; i++)
+      sumNew += string[i];
+
+    const int64_t endNew = mGetCurrentTimeNs();
+
+    mTEST_ASSERT_EQUAL(sumOld, sumNew);
+    mTEST_ASSERT_TRUE((endOld - startOld) / (double_t)(endNew - endOld) > 4.0); // Please don't make this perform terribly. Indexed access should only have to iterate up to `mString_CharIndex_Stride` characters.
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
@@ -0,0 +1,340 @@
+#include "mTestLib.h"
+#include "mThreadPool.h"
+
+// The thread pools in here use the default allocator, as the test allocator isn't thread safe.
+
+mTEST(mThreadPool, TestEnqueueTasks)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mThreadPool_Mode modes[] = { mTP_M_SharedQueue, mTP_M_WorkStealing };
+
+  for (const mThreadPool_Mode mode : modes)
+  {
+    mPtr<mThreadPool> threadPool;
+    mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+    mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 4, mode));
+
+    std::atomic<size_t> counter(0);
+    mTask *tasks[64];
+
+    for (size_t i = 0; i < mARRAYSIZE(tasks); i++)
+    {
+      mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&tasks[i], nullptr, [&counter, i]() { counter += i; return mR_Success; }));
+      mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, tasks[i]));
+    }
+
+    for (size_t i = 0; i < mARRAYSIZE(tasks); i++)
+    {
+      mTEST_ASSERT_SUCCESS(mTask_Join(tasks[i]));
+
+      mTask_State state;
+      mTEST_ASSERT_SUCCESS(mTask_GetState(tasks[i], &state));
+      mTEST_ASSERT_EQUAL(state, mT_S_Complete);
+
+      mTEST_ASSERT_SUCCESS(mTask_Destroy(&tasks[i]));
+    }
+
+    mTEST_ASSERT_EQUAL(counter.load(), mARRAYSIZE(tasks) * (mARRAYSIZE(tasks) - 1) / 2);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mThreadPool, TestParallelFor)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const mThreadPool_Mode modes[] = { mTP_M_SharedQueue, mTP_M_WorkStealing };
+
+  for (const mThreadPool_Mode mode : modes)
+  {
+    mPtr<mThreadPool> threadPool;
+    mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+    mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, mThreadPool_ThreadCount::mTP_TC_NumberOfLogicalCores, mode));
+
+    const size_t count = 100000;
+    uint8_t *pVisited = nullptr;
+    mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pVisited);
+    mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pVisited, count));
+
+    const size_t grainSizes[] = { 0, 1, 17, 1000, count * 2 };
+
+    for (const size_t grainSize : grainSizes)
+    {
+      mTEST_ASSERT_SUCCESS(mMemset(pVisited, count, 0));
+
+      mTEST_ASSERT_SUCCESS(mThreadPool_ParallelFor(threadPool, 0, count, grainSize, [&](const size_t start, const size_t end)
+      {
+        if (start >= end || end > count)
+          return mR_IndexOutOfBounds;
+
+        if (grainSize != 0 && end - start > grainSize)
+          return mR_InvalidParameter;
+
+        for (size_t i = start; i < end; i++)
+          pVisited[i]++;
+
+        return mR_Success;
+      }));
+
+      for (size_t i = 0; i < count; i++)
+        mTEST_ASSERT_EQUAL(pVisited[i], 1);
+    }
+
+    size_t calls = 0;
+    mTEST_ASSERT_SUCCESS(mThreadPool_ParallelFor(threadPool, 10, 10, 1, [&](const size_t, const size_t) { calls++; return mR_Success; }));
+    mTEST_ASSERT_EQUAL(calls, 0);
+
+    mTEST_ASSERT_EQUAL(mR_InvalidParameter, mThreadPool_ParallelFor(threadPool, 10, 9, 1, [&](const size_t, const size_t) { return mR_Success; }));
+    mTEST_ASSERT_EQUAL(mR_InvalidParameter, mThreadPool_ParallelFor(threadPool, 0, 10, 1, nullptr));
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mThreadPool, TestParallelForError)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 4, mTP_M_WorkStealing));
+
+  mTEST_ASSERT_EQUAL(mR_ResourceNotFound, mThreadPool_ParallelFor(threadPool, 0, 1024, 8, [](const size_t start, const size_t end)
+  {
+    if (start <= 512 && end > 512)
+      return mR_ResourceNotFound;
+
+    return mR_Success;
+  }));
+
+  // The pool must still be usable afterwards.
+  std::atomic<size_t> sum(0);
+  mTEST_ASSERT_SUCCESS(mThreadPool_ParallelFor(threadPool, 0, 1024, 8, [&](const size_t start, const size_t end) { sum += end - start; return mR_Success; }));
+  mTEST_ASSERT_EQUAL(sum.load(), 1024);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mThreadPool, TestNestedParallelFor)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 2, mTP_M_WorkStealing));
+
+  std::atomic<size_t> sum(0);
+
+  // Every worker is blocked in an outer chunk, so the inner loops can only complete if waiting threads help out.
+  mTEST_ASSERT_SUCCESS(mThreadPool_ParallelFor(threadPool, 0, 64, 1, [&](const size_t, const size_t)
+  {
+    return mThreadPool_ParallelFor(threadPool, 0, 256, 4, [&](const size_t start, const size_t end) { sum += end - start; return mR_Success; });
+  }));
+
+  mTEST_ASSERT_EQUAL(sum.load(), 64 * 256);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+#ifndef _DEBUG
+mTEST(mThreadPool, TestPerformance)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  size_t maxThreadCount = 1;
+  mTEST_ASSERT_SUCCESS(mThread_GetMaximumConcurrentThreads(&maxThreadCount));
+
+  const size_t count = 1024 * 1024 * 16;
+  uint32_t *pValues = nullptr;
+  mDEFER_CALL_2(mAllocator_FreePtr, pAllocator, &pValues);
+  mTEST_ASSERT_SUCCESS(mAllocator_AllocateZero(pAllocator, &pValues, count));
+
+  const auto &function = [pValues](const size_t start, const size_t end)
+  {
+    for (size_t i = start; i < end; i++)
+    {
+      uint32_t value = (uint32_t)i;
+
+      for (size_t j = 0; j < 16; j++)
+        value = value * 1664525 + 1013904223;
+
+      pValues[i] = value;
+    }
+
+    return mR_Success;
+  };
+
+  int64_t singleThreadedTime = 0;
+  int64_t lastTime = 0;
+  int64_t lastSharedQueueTime = 0;
+
+  for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+  {
+    int64_t times[2];
+    const mThreadPool_Mode modes[] = { mTP_M_SharedQueue, mTP_M_WorkStealing };
+
+    for (size_t i = 0; i < mARRAYSIZE(modes); i++)
+    {
+      mPtr<mThreadPool> threadPool;
+      mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+      mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, threadCount, modes[i]));
+
+      const int64_t start = mGetCurrentTimeNs();
+      mTEST_ASSERT_SUCCESS(mThreadPool_ParallelFor(threadPool, 0, count, 1024 * 4, function));
+      times[i] = mGetCurrentTimeNs() - start;
+    }
+
+    if (threadCount == 1)
+      singleThreadedTime = times[1];
+
+    lastTime = times[1];
+    lastSharedQueueTime = times[0];
+  }
+
+  if (maxThreadCount >= 4)
+    mTEST_ASSERT_TRUE(singleThreadedTime / (double_t)lastTime > 2.0); // Please don't make this scale terribly.
+
+  mTEST_ASSERT_TRUE(lastSharedQueueTime / (double_t)lastTime > 0.5); // Work stealing shouldn't be much slower than the shared queue.
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+#endif
+
+mTEST(mThreadPool, TestTaskGraph)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 4, mTP_M_WorkStealing));
+
+  // decode -> (colour convert a, colour convert b) -> encode
+  std::atomic<size_t> step(0);
+  size_t decodeStep = 0, convertAStep = 0, convertBStep = 0, encodeStep = 0;
+
+  mTask *pDecode = nullptr;
+  mTask *pConvertA = nullptr;
+  mTask *pConvertB = nullptr;
+  mTask *pEncode = nullptr;
+
+  mDEFER_CALL(&pDecode, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pDecode, nullptr, [&]() { mSleep(10); decodeStep = ++step; return mR_Success; }));
+  mDEFER_CALL(&pConvertA, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pConvertA, nullptr, [&]() { convertAStep = ++step; return mR_Success; }));
+  mDEFER_CALL(&pConvertB, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pConvertB, nullptr, [&]() { mSleep(5); convertBStep = ++step; return mR_Success; }));
+  mDEFER_CALL(&pEncode, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pEncode, nullptr, [&]() { encodeStep = ++step; return mR_Success; }));
+
+  mTEST_ASSERT_SUCCESS(mTask_SetName(pDecode, "Decode"));
+  mTEST_ASSERT_SUCCESS(mTask_SetName(pEncode, "Encode"));
+
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mTask_AddDependency(pDecode, pDecode));
+
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pConvertA, pDecode));
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pConvertB, pDecode));
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pEncode, pConvertA));
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pEncode, pConvertB));
+
+  // Enqueue in reverse order, nothing may start before its dependencies have completed.
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pEncode));
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pConvertB));
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pConvertA));
+
+  mTEST_ASSERT_EQUAL(mR_ResourceStateInvalid, mTask_AddDependency(pEncode, pDecode));
+
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pDecode));
+
+  mTEST_ASSERT_SUCCESS(mTask_Join(pEncode));
+
+  mTask_State state;
+  mTEST_ASSERT_SUCCESS(mTask_GetState(pEncode, &state));
+  mTEST_ASSERT_EQUAL(state, mT_S_Complete);
+
+  mTEST_ASSERT_EQUAL(decodeStep, 1);
+  mTEST_ASSERT_TRUE(convertAStep > decodeStep && convertAStep < encodeStep);
+  mTEST_ASSERT_TRUE(convertBStep > decodeStep && convertBStep < encodeStep);
+  mTEST_ASSERT_EQUAL(encodeStep, 4);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mThreadPool, TestTaskGraphFailurePropagation)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mPtr<mThreadPool> threadPool;
+  mDEFER_CALL(&threadPool, mThreadPool_Destroy);
+  mTEST_ASSERT_SUCCESS(mThreadPool_Create(&threadPool, nullptr, 2, mTP_M_WorkStealing));
+
+  std::atomic<size_t> executedCount(0);
+
+  mTask *pFirst = nullptr;
+  mTask *pSecond = nullptr;
+  mTask *pThird = nullptr;
+
+  mDEFER_CALL(&pFirst, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pFirst, nullptr, [&]() { ++executedCount; return mR_ResourceInvalid; }));
+  mDEFER_CALL(&pSecond, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pSecond, nullptr, [&]() { ++executedCount; return mR_Success; }));
+  mDEFER_CALL(&pThird, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pThird, nullptr, [&]() { ++executedCount; return mR_Success; }));
+
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pSecond, pFirst));
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pThird, pSecond));
+
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pThird));
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pSecond));
+  mTEST_ASSERT_SUCCESS(mThreadPool_EnqueueTask(threadPool, pFirst));
+
+  mTEST_ASSERT_SUCCESS(mTask_Join(pThird));
+
+  mTask_State state;
+  mResult result;
+
+  mTEST_ASSERT_SUCCESS(mTask_GetState(pSecond, &state));
+  mTEST_ASSERT_EQUAL(state, mT_S_Aborted);
+  mTEST_ASSERT_SUCCESS(mTask_GetResult(pSecond, &result));
+  mTEST_ASSERT_EQUAL(result, mR_ResourceInvalid);
+
+  mTEST_ASSERT_SUCCESS(mTask_GetState(pThird, &state));
+  mTEST_ASSERT_EQUAL(state, mT_S_Aborted);
+  mTEST_ASSERT_SUCCESS(mTask_GetResult(pThird, &result));
+  mTEST_ASSERT_EQUAL(result, mR_ResourceInvalid);
+
+  mTEST_ASSERT_EQUAL(executedCount.load(), 1);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mThreadPool, TestTaskGraphAbort)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  mTask *pFirst = nullptr;
+  mTask *pSecond = nullptr;
+  mTask *pLate = nullptr;
+
+  mDEFER_CALL(&pFirst, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pFirst, pAllocator, []() { return mR_Success; }));
+  mDEFER_CALL(&pSecond, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pSecond, pAllocator, []() { return mR_Success; }));
+
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pSecond, pFirst));
+  mTEST_ASSERT_SUCCESS(mTask_Abort(pFirst));
+
+  mTask_State state;
+  mTEST_ASSERT_SUCCESS(mTask_GetState(pSecond, &state));
+  mTEST_ASSERT_EQUAL(state, mT_S_Aborted);
+
+  // Adding a dependency to a task that has already been aborted aborts immediately.
+  mDEFER_CALL(&pLate, mTask_Destroy);
+  mTEST_ASSERT_SUCCESS(mTask_CreateWithLambda(&pLate, pAllocator, []() { return mR_Success; }));
+  mTEST_ASSERT_SUCCESS(mTask_AddDependency(pLate, pFirst));
+  mTEST_ASSERT_SUCCESS(mTask_GetState(pLate, &state));
+  mTEST_ASSERT_EQUAL(state, mT_S_Aborted);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
@@ -0,0 +1,160 @@
+#include "mTestLib.h"
+#include "mUnicode.h"
+
+mTEST(mUnicode, TestValidate)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  size_t count = 0;
+
+  mTEST_ASSERT_TRUE(mUtf8_Validate("", 0, &count));
+  mTEST_ASSERT_EQUAL((size_t)0, count);
+
+  mTEST_ASSERT_TRUE(mUtf8_Validate("\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80" "a", 10, &count));
+  mTEST_ASSERT_EQUAL((size_t)4, count);
+
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xC0\xAF", 2)); // Overlong.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xE0\x80\xAF", 3)); // Overlong.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xF0\x80\x80\xAF", 4)); // Overlong.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xED\xA0\x80", 3)); // Surrogate.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xF4\x90\x80\x80", 4)); // Above U+10FFFF.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xF5\x80\x80\x80", 4));
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xE2\x82", 2)); // Truncated.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("a\x80", 2)); // Stray continuation byte.
+  mTEST_ASSERT_FALSE(mUtf8_Validate("\xC3\xA4\xA4", 3));
+
+  // Long enough to be validated by the vectorised kernels, with the invalid sequence at every position.
+  char text[200];
+
+  for (size_t i = 0; i < mARRAYSIZE(text); i++)
+    text[i] = (char)('a' + (i % 26));
+
+  mTEST_ASSERT_TRUE(mUtf8_Validate(text, mARRAYSIZE(text), &count));
+  mTEST_ASSERT_EQUAL(mARRAYSIZE(text), count);
+
+  const char *invalidSequences[] = { "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xE2\x82", "\x80", "\xFF" };
+
+  for (const char *invalid : invalidSequences)
+  {
+    const size_t invalidLength = strlen(invalid);
+
+    for (size_t position = 0; position + invalidLength <= mARRAYSIZE(text); position++)
+    {
+      char modified[mARRAYSIZE(text)];
+      mTEST_ASSERT_SUCCESS(mMemcpy(modified, text, mARRAYSIZE(text)));
+      mTEST_ASSERT_SUCCESS(mMemcpy(modified + position, invalid, invalidLength));
+
+      mTEST_ASSERT_FALSE(mUtf8_Validate(modified, mARRAYSIZE(modified)));
+    }
+  }
+
+  // Multi-byte characters crossing every block boundary.
+  const char valid[] = "\xF0\x9F\x98\x80";
+
+  for (size_t position = 0; position + 4 <= mARRAYSIZE(text); position++)
+  {
+    char modified[mARRAYSIZE(text)];
+    mTEST_ASSERT_SUCCESS(mMemcpy(modified, text, mARRAYSIZE(text)));
+    mTEST_ASSERT_SUCCESS(mMemcpy(modified + position, valid, 4));
+
+    mTEST_ASSERT_TRUE(mUtf8_Validate(modified, mARRAYSIZE(modified), &count));
+    mTEST_ASSERT_EQUAL(mARRAYSIZE(text) - 3, count);
+  }
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mUnicode, TestTranscode)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  // Mixes long ascii runs with characters of every length.
+  char text[1024];
+  size_t bytes = 0;
+  size_t codePoints = 0;
+
+  while (bytes + 64 < mARRAYSIZE(text))
+  {
+    for (size_t i = 0; i < 37; i++, codePoints++)
+      text[bytes++] = (char)('A' + (codePoints % 26));
+
+    mTEST_ASSERT_SUCCESS(mMemcpy(text + bytes, "\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80", 9));
+    bytes += 9;
+    codePoints += 3;
+  }
+
+  size_t utf16Count = 0;
+  mTEST_ASSERT_SUCCESS(mUtf8_GetUtf16Count(text, bytes, &utf16Count));
+
+  char16_t utf16[mARRAYSIZE(text)];
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mUtf8_ToUtf16(text, bytes, utf16, mARRAYSIZE(utf16), &count));
+  mTEST_ASSERT_EQUAL(utf16Count, count);
+  mTEST_ASSERT_EQUAL((char16_t)'A', utf16[0]);
+  mTEST_ASSERT_EQUAL((char16_t)0xE4, utf16[37]);
+  mTEST_ASSERT_EQUAL((char16_t)0x20AC, utf16[38]);
+  mTEST_ASSERT_EQUAL((char16_t)0xD83D, utf16[39]);
+  mTEST_ASSERT_EQUAL((char16_t)0xDE00, utf16[40]);
+
+  mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mUtf8_ToUtf16(text, bytes, utf16, count - 1, &count));
+
+  char utf8[mARRAYSIZE(text)];
+  size_t utf8Bytes = 0;
+  size_t utf8CodePoints = 0;
+  mTEST_ASSERT_SUCCESS(mUtf8_ToUtf16(text, bytes, utf16, mARRAYSIZE(utf16), &count));
+  mTEST_ASSERT_SUCCESS(mUtf16_ToUtf8(utf16, count, utf8, mARRAYSIZE(utf8), &utf8Bytes, &utf8CodePoints));
+  mTEST_ASSERT_EQUAL(bytes, utf8Bytes);
+  mTEST_ASSERT_EQUAL(codePoints, utf8CodePoints);
+  mTEST_ASSERT_EQUAL(0, memcmp(text, utf8, bytes));
+
+  mTEST_ASSERT_EQUAL(mR_IndexOutOfBounds, mUtf16_ToUtf8(utf16, count, utf8, bytes - 1, &utf8Bytes));
+
+  char32_t utf32[mARRAYSIZE(text)];
+  mTEST_ASSERT_SUCCESS(mUtf8_ToUtf32(text, bytes, utf32, mARRAYSIZE(utf32), &count));
+  mTEST_ASSERT_EQUAL(codePoints, count);
+  mTEST_ASSERT_EQUAL((char32_t)0x1F600, utf32[39]);
+
+  mTEST_ASSERT_SUCCESS(mUtf32_ToUtf8(utf32, count, utf8, mARRAYSIZE(utf8), &utf8Bytes));
+  mTEST_ASSERT_EQUAL(bytes, utf8Bytes);
+  mTEST_ASSERT_EQUAL(0, memcmp(text, utf8, bytes));
+
+  // Invalid input.
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mUtf8_ToUtf16("a\xED\xA0\x80", 4, utf16, mARRAYSIZE(utf16), &count));
+
+  const char16_t unpairedSurrogate[] = { 'a', 0xD83D, 'b' };
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mUtf16_ToUtf8(unpairedSurrogate, mARRAYSIZE(unpairedSurrogate), utf8, mARRAYSIZE(utf8), &utf8Bytes));
+
+  const char32_t tooLarge[] = { 'a', 0x110000 };
+  mTEST_ASSERT_EQUAL(mR_InvalidParameter, mUtf32_ToUtf8(tooLarge, mARRAYSIZE(tooLarge), utf8, mARRAYSIZE(utf8), &utf8Bytes));
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}
+
+mTEST(mUnicode, TestWide)
+{
+  mTEST_ALLOCATOR_SETUP();
+
+  const char text[] = "Wide \xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80 characters, long enough to reach the vectorised paths.";
+
+  size_t wideCount = 0;
+  mTEST_ASSERT_SUCCESS(mUtf8_GetWideCount(text, mARRAYSIZE(text), &wideCount));
+
+  wchar_t wide[mARRAYSIZE(text)];
+  size_t count = 0;
+  mTEST_ASSERT_SUCCESS(mUtf8_ToWide(text, mARRAYSIZE(text), wide, mARRAYSIZE(wide), &count));
+  mTEST_ASSERT_EQUAL(wideCount, count);
+  mTEST_ASSERT_EQUAL(L'\0', wide[count - 1]);
+
+  char utf8[mARRAYSIZE(text)];
+  size_t bytes = 0;
+  mTEST_ASSERT_SUCCESS(mWide_ToUtf8(wide, count, utf8, mARRAYSIZE(utf8), &bytes));
+  mTEST_ASSERT_EQUAL(mARRAYSIZE(text), bytes);
+  mTEST_ASSERT_EQUAL(0, memcmp(text, utf8, bytes));
+
+  mString string;
+  mTEST_ASSERT_SUCCESS(mString_Create(&string, wide, pAllocator));
+  mTEST_ASSERT_EQUAL(mARRAYSIZE(text), string.bytes);
+  mTEST_ASSERT_TRUE(string == text);
+
+  mTEST_ALLOCATOR_ZERO_CHECK();
+}